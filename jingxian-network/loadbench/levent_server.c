@@ -0,0 +1,296 @@
+/* levent_server.c :  libevent  event_base  bufferevent ʵֵĻԺ
+ * socks5 ת, Ϊ loadbench Ա jingxian Ļ׼
+ *
+ *  jingxian  echo  proxy Эһ, תֻ֧֤ socks5 CONNECT
+ *  IPv4 ַ, Ŀ֮Żظͻ.
+ *
+ *   levent_server [Զ˿] [ת˿]
+ */
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+typedef int socklen_t;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/util.h>
+
+#ifdef WIN32
+#define close_socket(s) closesocket(s)
+#define last_socket_error() WSAGetLastError()
+#define IN_PROGRESS(e) (WSAEWOULDBLOCK == (e))
+#else
+#define close_socket(s) close(s)
+#define last_socket_error() errno
+#define IN_PROGRESS(e) (EINPROGRESS == (e))
+#endif
+
+enum relay_state
+{
+    RELAY_GREETING,
+    RELAY_REQUEST,
+    RELAY_CONNECTING,
+    RELAY_RUNNING
+};
+
+struct relay
+{
+    enum relay_state state;
+    struct event_base *base;
+    struct bufferevent *client;
+    struct bufferevent *server;
+};
+
+static void set_nodelay(evutil_socket_t fd)
+{
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char *)&on, sizeof(on));
+}
+
+static evutil_socket_t listen_on(int port)
+{
+    struct sockaddr_in sin;
+    int on = 1;
+    evutil_socket_t fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on));
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    sin.sin_port = htons((unsigned short)port);
+    if (0 != bind(fd, (struct sockaddr *)&sin, sizeof(sin))
+            || 0 != listen(fd, SOMAXCONN)
+            || 0 != evutil_make_socket_nonblocking(fd))
+    {
+        close_socket(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*  */
+
+static void echo_read(struct bufferevent *bev, void *arg)
+{
+    evbuffer_add_buffer(bufferevent_get_output(bev), bufferevent_get_input(bev));
+}
+
+static void echo_error(struct bufferevent *bev, short what, void *arg)
+{
+    bufferevent_free(bev);
+}
+
+static void echo_accept(evutil_socket_t listener, short what, void *arg)
+{
+    struct event_base *base = (struct event_base *)arg;
+    for (;;)
+    {
+        struct bufferevent *bev;
+        evutil_socket_t fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            return;
+
+        evutil_make_socket_nonblocking(fd);
+        set_nodelay(fd);
+        bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+        bufferevent_setcb(bev, echo_read, NULL, echo_error, NULL);
+        bufferevent_enable(bev, EV_READ | EV_WRITE);
+    }
+}
+
+/* socks5 ת */
+
+static void relay_free(struct relay *r)
+{
+    if (NULL != r->client)
+        bufferevent_free(r->client);
+    if (NULL != r->server)
+        bufferevent_free(r->server);
+    free(r);
+}
+
+static void relay_error(struct bufferevent *bev, short what, void *arg)
+{
+    relay_free((struct relay *)arg);
+}
+
+static void relay_forward(struct bufferevent *bev, void *arg)
+{
+    struct relay *r = (struct relay *)arg;
+    struct bufferevent *peer = (bev == r->client) ? r->server : r->client;
+    evbuffer_add_buffer(bufferevent_get_output(peer), bufferevent_get_input(bev));
+}
+
+static void relay_connected(evutil_socket_t fd, short what, void *arg)
+{
+    static const unsigned char reply[10] = { 5, 0, 0, 1, 0, 0, 0, 0, 0, 0 };
+    struct relay *r = (struct relay *)arg;
+    int error = 0;
+    socklen_t len = sizeof(error);
+
+    if (0 != getsockopt(fd, SOL_SOCKET, SO_ERROR, (char *)&error, &len) || 0 != error)
+    {
+        close_socket(fd);
+        relay_free(r);
+        return;
+    }
+
+    set_nodelay(fd);
+    r->state = RELAY_RUNNING;
+    r->server = bufferevent_socket_new(r->base, fd, BEV_OPT_CLOSE_ON_FREE);
+    bufferevent_setcb(r->server, relay_forward, NULL, relay_error, r);
+    bufferevent_enable(r->server, EV_READ | EV_WRITE);
+
+    bufferevent_write(r->client, reply, sizeof(reply));
+    bufferevent_enable(r->client, EV_READ);
+
+    /* ͻ˿Ѿ */
+    if (0 != evbuffer_get_length(bufferevent_get_input(r->client)))
+        relay_forward(r->client, r);
+}
+
+static int relay_connect(struct relay *r, const unsigned char *request)
+{
+    struct sockaddr_in sin;
+    int error;
+    evutil_socket_t fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    evutil_make_socket_nonblocking(fd);
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    memcpy(&sin.sin_addr, request + 4, 4);
+    memcpy(&sin.sin_port, request + 8, 2);
+
+    if (0 != connect(fd, (struct sockaddr *)&sin, sizeof(sin)))
+    {
+        error = last_socket_error();
+        if (!IN_PROGRESS(error))
+        {
+            close_socket(fd);
+            return -1;
+        }
+    }
+
+    r->state = RELAY_CONNECTING;
+    bufferevent_disable(r->client, EV_READ);
+    return event_base_once(r->base, fd, EV_WRITE, relay_connected, r, NULL);
+}
+
+static void relay_handshake(struct bufferevent *bev, void *arg)
+{
+    static const unsigned char method[2] = { 5, 0 };
+    struct relay *r = (struct relay *)arg;
+    struct evbuffer *input = bufferevent_get_input(bev);
+    unsigned char *data;
+    size_t len;
+
+    if (RELAY_RUNNING == r->state)
+    {
+        relay_forward(bev, r);
+        return;
+    }
+
+    if (RELAY_GREETING == r->state)
+    {
+        len = evbuffer_get_length(input);
+        if (len < 2)
+            return;
+        data = evbuffer_pullup(input, 2);
+        if (5 != data[0])
+        {
+            relay_free(r);
+            return;
+        }
+        if (len < 2 + (size_t)data[1])
+            return;
+
+        evbuffer_drain(input, 2 + data[1]);
+        bufferevent_write(bev, method, sizeof(method));
+        r->state = RELAY_REQUEST;
+    }
+
+    if (RELAY_REQUEST == r->state)
+    {
+        if (evbuffer_get_length(input) < 10)
+            return;
+        data = evbuffer_pullup(input, 10);
+        if (5 != data[0] || 1 != data[1] || 1 != data[3] || 0 != relay_connect(r, data))
+        {
+            relay_free(r);
+            return;
+        }
+        evbuffer_drain(input, 10);
+    }
+}
+
+static void relay_accept(evutil_socket_t listener, short what, void *arg)
+{
+    struct event_base *base = (struct event_base *)arg;
+    for (;;)
+    {
+        struct relay *r;
+        evutil_socket_t fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            return;
+
+        evutil_make_socket_nonblocking(fd);
+        set_nodelay(fd);
+        r = (struct relay *)calloc(1, sizeof(struct relay));
+        r->state = RELAY_GREETING;
+        r->base = base;
+        r->client = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+        bufferevent_setcb(r->client, relay_handshake, NULL, relay_error, r);
+        bufferevent_enable(r->client, EV_READ | EV_WRITE);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int echo_port = (argc > 1) ? atoi(argv[1]) : 7543;
+    int relay_port = (argc > 2) ? atoi(argv[2]) : 7544;
+    struct event_base *base;
+    evutil_socket_t echo_fd;
+    evutil_socket_t relay_fd;
+    struct event *echo_ev;
+    struct event *relay_ev;
+
+#ifdef WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+
+    base = event_base_new();
+    echo_fd = listen_on(echo_port);
+    relay_fd = listen_on(relay_port);
+    if (NULL == base || echo_fd < 0 || relay_fd < 0)
+    {
+        fprintf(stderr, "ʧ, ˿ %d  %d \n", echo_port, relay_port);
+        return 1;
+    }
+
+    echo_ev = event_new(base, echo_fd, EV_READ | EV_PERSIST, echo_accept, base);
+    relay_ev = event_new(base, relay_fd, EV_READ | EV_PERSIST, relay_accept, base);
+    event_add(echo_ev, NULL);
+    event_add(relay_ev, NULL);
+
+    printf("libevent(%s) echo %d, relay %d\n", event_base_get_method(base), echo_port, relay_port);
+    fflush(stdout);
+    return event_base_dispatch(base);
+}
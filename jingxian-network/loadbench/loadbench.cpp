@@ -0,0 +1,620 @@
+// loadbench.cpp : Ա jingxian  libevent ѹԿͻ
+//
+// ÿһջ:  size ֽ, Ե size ֽںӳ, ٷ
+// һ. relay ģʽ socks5( ֤ )÷ target, ̺֮
+// echo ͬ. ȫԤȺʼʱ, ʱеһ:
+//
+//    | ģʽ |  | / | MB/ | p99 ӳ | ÿڴ | ÿ CPU
+//
+// ڴ CPU ͨ --pid ָķȡ, ֱǹ
+// , Լʱڼ̵ں˼ûʱ.
+
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <mswsock.h>
+#include <windows.h>
+#include <psapi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        const char* label;
+        const char* mode;
+        const char* host;
+        int port;
+        const char* targetHost;
+        int targetPort;
+        int connections;
+        int size;
+        int warmup;
+        int duration;
+        int threads;
+        int sources;
+        DWORD pid;
+        bool header;
+    };
+
+    /**
+     * Եӳֱͼ, λΪ΢,  1/32
+     */
+    class Histogram
+    {
+    public:
+        enum { LINEAR = 64, SUB_BUCKETS = 32, BUCKETS = LINEAR + 40 * SUB_BUCKETS };
+
+        Histogram()
+                : count_(0)
+        {
+            memset(buckets_, 0, sizeof(buckets_));
+        }
+
+        void record(unsigned __int64 us)
+        {
+            ++ buckets_[indexOf(us)];
+            ++ count_;
+        }
+
+        void merge(const Histogram& other)
+        {
+            for (size_t i = 0; i < BUCKETS; ++ i)
+                buckets_[i] += other.buckets_[i];
+            count_ += other.count_;
+        }
+
+        unsigned __int64 count() const
+        {
+            return count_;
+        }
+
+        unsigned __int64 percentile(double p) const
+        {
+            unsigned __int64 rank = (unsigned __int64)(count_ * p / 100.0);
+            unsigned __int64 seen = 0;
+            for (size_t i = 0; i < BUCKETS; ++ i)
+            {
+                seen += buckets_[i];
+                if (seen > rank)
+                    return valueOf(i);
+            }
+            return 0;
+        }
+
+    private:
+        static size_t indexOf(unsigned __int64 us)
+        {
+            if (us < LINEAR)
+                return (size_t)us;
+
+            size_t msb = 6;
+            while (msb < 45 && (us >> (msb + 1)) != 0)
+                ++ msb;
+            size_t sub = (size_t)((us >> (msb - 5)) & (SUB_BUCKETS - 1));
+            size_t index = LINEAR + (msb - 6) * SUB_BUCKETS + sub;
+            return index < BUCKETS ? index : BUCKETS - 1;
+        }
+
+        static unsigned __int64 valueOf(size_t index)
+        {
+            if (index < LINEAR)
+                return index;
+
+            size_t msb = 6 + (index - LINEAR) / SUB_BUCKETS;
+            size_t sub = (index - LINEAR) % SUB_BUCKETS;
+            return ((unsigned __int64)(SUB_BUCKETS + sub)) << (msb - 5);
+        }
+
+        unsigned __int64 buckets_[BUCKETS];
+        unsigned __int64 count_;
+    };
+
+    struct Connection
+    {
+        OVERLAPPED overlapped;
+        SOCKET socket;
+        bool sending;
+        size_t done;
+        LARGE_INTEGER start;
+        std::vector<char> request;
+        std::vector<char> response;
+    };
+
+    struct Worker
+    {
+        HANDLE thread;
+        Histogram latency;
+        unsigned __int64 requests;
+        unsigned __int64 errors;
+    };
+
+    HANDLE completionPort = NULL;
+    LARGE_INTEGER frequency;
+    volatile LONG measuring = 0;
+    volatile LONG stopping = 0;
+    volatile LONG active = 0;
+
+    unsigned __int64 elapsedMicroseconds(const LARGE_INTEGER& start)
+    {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return (unsigned __int64)((now.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart);
+    }
+
+    bool post(Connection* connection)
+    {
+        memset(&connection->overlapped, 0, sizeof(OVERLAPPED));
+
+        WSABUF buf;
+        DWORD bytes = 0;
+        DWORD flags = 0;
+        int result;
+        if (connection->sending)
+        {
+            buf.buf = &connection->request[connection->done];
+            buf.len = (u_long)(connection->request.size() - connection->done);
+            result = WSASend(connection->socket, &buf, 1, &bytes, 0, &connection->overlapped, NULL);
+        }
+        else
+        {
+            buf.buf = &connection->response[connection->done];
+            buf.len = (u_long)(connection->response.size() - connection->done);
+            result = WSARecv(connection->socket, &buf, 1, &bytes, &flags, &connection->overlapped, NULL);
+        }
+        return 0 == result || WSA_IO_PENDING == WSAGetLastError();
+    }
+
+    void startRequest(Connection* connection)
+    {
+        connection->sending = true;
+        connection->done = 0;
+        QueryPerformanceCounter(&connection->start);
+    }
+
+    void finish(Worker* worker, Connection* connection, bool failed)
+    {
+        if (failed)
+            ++ worker->errors;
+        closesocket(connection->socket);
+        connection->socket = INVALID_SOCKET;
+        InterlockedDecrement(&active);
+    }
+
+    DWORD WINAPI workerMain(LPVOID param)
+    {
+        Worker* worker = (Worker*)param;
+        for (;;)
+        {
+            DWORD bytes = 0;
+            ULONG_PTR key = 0;
+            OVERLAPPED* overlapped = NULL;
+            BOOL ok = GetQueuedCompletionStatus(completionPort, &bytes, &key, &overlapped, INFINITE);
+            if (NULL == overlapped)
+                return 0;
+
+            Connection* connection = (Connection*)overlapped;
+            if (!ok || 0 == bytes)
+            {
+                finish(worker, connection, 0 == stopping);
+                continue;
+            }
+
+            connection->done += bytes;
+            if (connection->sending)
+            {
+                if (connection->done == connection->request.size())
+                {
+                    connection->sending = false;
+                    connection->done = 0;
+                }
+            }
+            else if (connection->done == connection->response.size())
+            {
+                if (0 != measuring)
+                {
+                    worker->latency.record(elapsedMicroseconds(connection->start));
+                    ++ worker->requests;
+                }
+
+                if (0 != stopping)
+                {
+                    finish(worker, connection, false);
+                    continue;
+                }
+                startRequest(connection);
+            }
+
+            if (!post(connection))
+                finish(worker, connection, 0 == stopping);
+        }
+    }
+
+    bool readFully(SOCKET s, char* buf, int len)
+    {
+        while (0 < len)
+        {
+            int n = recv(s, buf, len, 0);
+            if (n <= 0)
+                return false;
+            buf += n;
+            len -= n;
+        }
+        return true;
+    }
+
+    /**
+     *  socks5  CONNECT ÷ӵ target
+     */
+    bool socks5Connect(SOCKET s, const Options& options)
+    {
+        const char greeting[] = { 5, 1, 0 };
+        char reply[262];
+        if (sizeof(greeting) != send(s, greeting, sizeof(greeting), 0)
+                || !readFully(s, reply, 2)
+                || 5 != reply[0] || 0 != reply[1])
+            return false;
+
+        char request[10] = { 5, 1, 0, 1 };
+        unsigned long address = inet_addr(options.targetHost);
+        unsigned short port = htons((unsigned short)options.targetPort);
+        memcpy(request + 4, &address, 4);
+        memcpy(request + 8, &port, 2);
+        if (sizeof(request) != send(s, request, sizeof(request), 0)
+                || !readFully(s, reply, 4)
+                || 5 != reply[0] || 0 != reply[1])
+            return false;
+
+        switch (reply[3])
+        {
+        case 1:
+            return readFully(s, reply, 6);
+        case 3:
+            return readFully(s, reply, 1) && readFully(s, reply + 1, (unsigned char)reply[0] + 2);
+        case 4:
+            return readFully(s, reply, 18);
+        default:
+            return false;
+        }
+    }
+
+    SOCKET open(const Options& options, int index)
+    {
+        SOCKET s = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED);
+        if (INVALID_SOCKET == s)
+            return s;
+
+        BOOL nodelay = TRUE;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+
+        // Դַʱ˿ڲ 50k ,  127.0.0.x
+        if (1 < options.sources)
+        {
+            sockaddr_in local;
+            memset(&local, 0, sizeof(local));
+            local.sin_family = AF_INET;
+            local.sin_addr.s_addr = htonl(0x7F000001 + (index % options.sources));
+            bind(s, (sockaddr*)&local, sizeof(local));
+        }
+
+        sockaddr_in remote;
+        memset(&remote, 0, sizeof(remote));
+        remote.sin_family = AF_INET;
+        remote.sin_addr.s_addr = inet_addr(options.host);
+        remote.sin_port = htons((unsigned short)options.port);
+
+        for (int retry = 0; ; ++ retry)
+        {
+            if (0 == connect(s, (sockaddr*)&remote, sizeof(remote)))
+                break;
+
+            //  backlog ʱԵ
+            if (WSAECONNREFUSED != WSAGetLastError() || 10 <= retry)
+            {
+                closesocket(s);
+                return INVALID_SOCKET;
+            }
+            Sleep(10);
+        }
+
+        if (0 == strcmp("relay", options.mode) && !socks5Connect(s, options))
+        {
+            closesocket(s);
+            return INVALID_SOCKET;
+        }
+        return s;
+    }
+
+    class ServerProcess
+    {
+    public:
+        explicit ServerProcess(DWORD pid)
+                : handle_(NULL)
+        {
+            if (0 != pid)
+                handle_ = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+        }
+
+        ~ServerProcess()
+        {
+            if (NULL != handle_)
+                CloseHandle(handle_);
+        }
+
+        bool valid() const
+        {
+            return NULL != handle_;
+        }
+
+        unsigned __int64 workingSet() const
+        {
+            PROCESS_MEMORY_COUNTERS counters;
+            if (NULL == handle_ || !GetProcessMemoryInfo(handle_, &counters, sizeof(counters)))
+                return 0;
+            return counters.WorkingSetSize;
+        }
+
+        /// ں˼ûʱ, λΪ΢
+        unsigned __int64 cpuTime() const
+        {
+            FILETIME creation, exit, kernel, user;
+            if (NULL == handle_ || !GetProcessTimes(handle_, &creation, &exit, &kernel, &user))
+                return 0;
+            return (toInt64(kernel) + toInt64(user)) / 10;
+        }
+
+    private:
+        static unsigned __int64 toInt64(const FILETIME& t)
+        {
+            return (((unsigned __int64)t.dwHighDateTime) << 32) | t.dwLowDateTime;
+        }
+
+        HANDLE handle_;
+    };
+
+    void usage(const char* name)
+    {
+        printf("%s [ѡ]\n", name);
+        printf("\t--label=name\t\tзһе\n");
+        printf("\t--mode=echo|relay\tԻԻ socks5 ת\n");
+        printf("\t--server=host:port\tַ\n");
+        printf("\t--target=host:port\trelay ģʽʱ÷ӵĻԷ\n");
+        printf("\t--connections=n\t\t\n");
+        printf("\t--size=n\t\tÿֽ\n");
+        printf("\t--warmup=n\t\tԤȵ\n");
+        printf("\t--duration=n\t\tʱ\n");
+        printf("\t--threads=n\t\t߳, Ϊ 0 ʱȡ CPU ĸ\n");
+        printf("\t--sources=n\t\tʹõ 127.0.0.x Դַ\n");
+        printf("\t--pid=n\t\t\t̵ pid, ͳڴ CPU\n");
+        printf("\t--header\t\tͷ\n");
+    }
+
+    bool parseAddress(const char* value, const char*& host, int& port)
+    {
+        static char buffers[2][64];
+        static int next = 0;
+
+        const char* colon = strrchr(value, ':');
+        if (NULL == colon || colon - value >= 64)
+            return false;
+
+        char* buf = buffers[next ++ % 2];
+        memcpy(buf, value, colon - value);
+        buf[colon - value] = 0;
+        host = buf;
+        port = atoi(colon + 1);
+        return 0 < port;
+    }
+
+    bool parse(int argc, char** argv, Options& options)
+    {
+        options.label = "server";
+        options.mode = "echo";
+        options.host = "127.0.0.1";
+        options.port = 6543;
+        options.targetHost = "127.0.0.1";
+        options.targetPort = 6543;
+        options.connections = 1000;
+        options.size = 64;
+        options.warmup = 2;
+        options.duration = 10;
+        options.threads = 0;
+        options.sources = 1;
+        options.pid = 0;
+        options.header = false;
+
+        for (int i = 1; i < argc; ++ i)
+        {
+            const char* arg = argv[i];
+            const char* value = strchr(arg, '=');
+            value = (NULL == value) ? "" : value + 1;
+
+            if (0 == strncmp(arg, "--label=", 8))
+                options.label = value;
+            else if (0 == strncmp(arg, "--mode=", 7))
+                options.mode = value;
+            else if (0 == strncmp(arg, "--server=", 9))
+            {
+                if (!parseAddress(value, options.host, options.port))
+                    return false;
+            }
+            else if (0 == strncmp(arg, "--target=", 9))
+            {
+                if (!parseAddress(value, options.targetHost, options.targetPort))
+                    return false;
+            }
+            else if (0 == strncmp(arg, "--connections=", 14))
+                options.connections = atoi(value);
+            else if (0 == strncmp(arg, "--size=", 7))
+                options.size = atoi(value);
+            else if (0 == strncmp(arg, "--warmup=", 9))
+                options.warmup = atoi(value);
+            else if (0 == strncmp(arg, "--duration=", 11))
+                options.duration = atoi(value);
+            else if (0 == strncmp(arg, "--threads=", 10))
+                options.threads = atoi(value);
+            else if (0 == strncmp(arg, "--sources=", 10))
+                options.sources = atoi(value);
+            else if (0 == strncmp(arg, "--pid=", 6))
+                options.pid = (DWORD)atoi(value);
+            else if (0 == strcmp(arg, "--header"))
+                options.header = true;
+            else
+                return false;
+        }
+
+        if (0 != strcmp("echo", options.mode) && 0 != strcmp("relay", options.mode))
+            return false;
+        return 0 < options.connections && 0 < options.size && 0 < options.duration;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    if (options.header)
+    {
+        printf("| %-10s | %-5s | %11s | %10s | %8s | %8s | %12s | %12s |\n"
+               , "server", "mode", "connections", "req/s", "MB/s", "p99 ms", "RSS/conn KB", "CPU us/req");
+        printf("|------------|-------|-------------|------------|----------|----------|--------------|--------------|\n");
+    }
+
+    WSADATA wsaData;
+    if (0 != WSAStartup(MAKEWORD(2, 2), &wsaData))
+        return -1;
+    QueryPerformanceFrequency(&frequency);
+
+    ServerProcess server(options.pid);
+    if (0 != options.pid && !server.valid())
+        fprintf(stderr, "򿪷 %lu ʧ - %lu\n", options.pid, GetLastError());
+
+    if (0 == options.threads)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        options.threads = (int)info.dwNumberOfProcessors;
+    }
+
+    completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+    if (NULL == completionPort)
+        return -1;
+
+    unsigned __int64 rssBefore = server.workingSet();
+
+    std::vector<Connection*> connections;
+    connections.reserve(options.connections);
+    for (int i = 0; i < options.connections; ++ i)
+    {
+        SOCKET s = open(options, i);
+        if (INVALID_SOCKET == s)
+        {
+            fprintf(stderr, "ֻ %d  - %d\n", i, WSAGetLastError());
+            return -1;
+        }
+
+        Connection* connection = new Connection();
+        connection->socket = s;
+        connection->request.resize(options.size, 'x');
+        connection->response.resize(options.size);
+        CreateIoCompletionPort((HANDLE)s, completionPort, 0, 0);
+        connections.push_back(connection);
+    }
+
+    std::vector<Worker> workers(options.threads);
+    for (size_t i = 0; i < workers.size(); ++ i)
+    {
+        workers[i].requests = 0;
+        workers[i].errors = 0;
+        workers[i].thread = CreateThread(NULL, 0, &workerMain, &workers[i], 0, NULL);
+    }
+
+    active = (LONG)connections.size();
+    for (size_t i = 0; i < connections.size(); ++ i)
+    {
+        startRequest(connections[i]);
+        if (!post(connections[i]))
+        {
+            closesocket(connections[i]->socket);
+            connections[i]->socket = INVALID_SOCKET;
+            InterlockedDecrement(&active);
+        }
+    }
+
+    Sleep(options.warmup * 1000);
+
+    unsigned __int64 rssAfter = server.workingSet();
+    unsigned __int64 cpuBefore = server.cpuTime();
+    LARGE_INTEGER start;
+    QueryPerformanceCounter(&start);
+    InterlockedExchange(&measuring, 1);
+
+    Sleep(options.duration * 1000);
+
+    InterlockedExchange(&measuring, 0);
+    unsigned __int64 elapsed = elapsedMicroseconds(start);
+    unsigned __int64 cpuAfter = server.cpuTime();
+
+    // ڽе, ʣµ shutdown δɵĲ, ɹ
+    // ̹߳ر
+    InterlockedExchange(&stopping, 1);
+    for (int i = 0; i < 500 && 0 < active; ++ i)
+        Sleep(10);
+    for (size_t i = 0; i < connections.size(); ++ i)
+    {
+        SOCKET s = connections[i]->socket;
+        if (INVALID_SOCKET != s)
+            shutdown(s, SD_BOTH);
+    }
+    for (int i = 0; i < 500 && 0 < active; ++ i)
+        Sleep(10);
+
+    for (size_t i = 0; i < workers.size(); ++ i)
+        PostQueuedCompletionStatus(completionPort, 0, 0, NULL);
+
+    Histogram latency;
+    unsigned __int64 requests = 0;
+    unsigned __int64 errors = 0;
+    for (size_t i = 0; i < workers.size(); ++ i)
+    {
+        WaitForSingleObject(workers[i].thread, INFINITE);
+        CloseHandle(workers[i].thread);
+        latency.merge(workers[i].latency);
+        requests += workers[i].requests;
+        errors += workers[i].errors;
+    }
+
+    double seconds = elapsed / 1000000.0;
+    double rssPerConnection = (rssAfter > rssBefore) ? (double)(rssAfter - rssBefore) / 1024.0 / connections.size() : 0.0;
+    double cpuPerRequest = (0 != requests) ? (double)(cpuAfter - cpuBefore) / requests : 0.0;
+
+    printf("| %-10s | %-5s | %11d | %10.0f | %8.2f | %8.3f | %12.2f | %12.2f |\n"
+           , options.label
+           , options.mode
+           , options.connections
+           , requests / seconds
+           , requests * options.size * 2 / seconds / (1024.0 * 1024.0)
+           , latency.percentile(99.0) / 1000.0
+           , rssPerConnection
+           , cpuPerRequest);
+
+    if (0 != errors)
+        fprintf(stderr, "%I64u ӳϿ\n", errors);
+
+    for (size_t i = 0; i < connections.size(); ++ i)
+    {
+        if (INVALID_SOCKET != connections[i]->socket)
+            closesocket(connections[i]->socket);
+        delete connections[i];
+    }
+    CloseHandle(completionPort);
+    WSACleanup();
+    return 0;
+}
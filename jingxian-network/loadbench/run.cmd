@@ -0,0 +1,46 @@
+@echo off
+rem ڱ϶Ա jingxian  libevent ĻԼ socks5 ת, Ϊһ
+rem
+rem   run.cmd [ڵĿ¼] [ÿֽ]
+rem
+rem 50000 Ҫʱ˿ڵķΧ( ҪԱȨ ):
+rem   netsh int ipv4 set dynamicport tcp start=10000 num=55535
+
+setlocal enabledelayedexpansion
+
+set BIN=%~1
+if "%BIN%"=="" set BIN=%~dp0..\Release
+set SIZE=%~2
+if "%SIZE%"=="" set SIZE=64
+set CONNECTIONS=1000 10000 50000
+set OPTIONS=--size=%SIZE% --warmup=5 --duration=20 --sources=16
+
+start "jingxian" /B "%BIN%\jingxian-network.exe" --console --config=%~dp0jingxian.conf >nul 2>&1
+start "libevent" /B "%BIN%\levent_server.exe" 7543 7544 >nul 2>&1
+ping -n 3 127.0.0.1 >nul
+
+for /f "tokens=2 delims=," %%p in ('tasklist /FI "IMAGENAME eq jingxian-network.exe" /FO CSV /NH') do set JINGXIAN_PID=%%~p
+for /f "tokens=2 delims=," %%p in ('tasklist /FI "IMAGENAME eq levent_server.exe" /FO CSV /NH') do set LIBEVENT_PID=%%~p
+
+set HEADER=--header
+for %%c in (%CONNECTIONS%) do (
+    for %%m in (echo relay) do (
+        call :run jingxian !JINGXIAN_PID! 6543 6544 %%m %%c
+        call :run libevent !LIBEVENT_PID! 7543 7544 %%m %%c
+    )
+)
+
+taskkill /PID %JINGXIAN_PID% /F >nul 2>&1
+taskkill /PID %LIBEVENT_PID% /F >nul 2>&1
+endlocal
+goto :eof
+
+rem :run <> <pid> <Զ˿> <ת˿> <ģʽ> <>
+:run
+set PORT=%3
+if "%5"=="relay" set PORT=%4
+"%BIN%\loadbench.exe" %HEADER% --label=%1 --pid=%2 --mode=%5 --connections=%6 --server=127.0.0.1:%PORT% --target=127.0.0.1:%3 %OPTIONS%
+set HEADER=
+rem һֵȫر
+ping -n 6 127.0.0.1 >nul
+goto :eof
@@ -18,11 +18,11 @@ void printRecord( int record , std::ostream& target )
 		target << ", member" << i;
 	}
 	target << " ) \\" << std::endl;
-	target << "inline bool serialize_##object(" _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, object & s1, const tchar* name=0) \\" << std::endl;
+	target << "inline bool serialize_##object(" _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
     target << "{ return writer.open( context, #object, name) \\" << std::endl;
 	for( int i = 0; i < record; i ++ )
 	{
-		target << "  && serialize(writer, context, s1.##member" << i << ", #member" << i << ") \\" << std::endl;
+		target << "  && serialize(writer, context, s1.member" << i << ", #member" << i << ") \\" << std::endl;
 	}
 	target << "  && writer.close( context); } \\" << std::endl;
 	target << "inline bool serialize(" _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
@@ -32,11 +32,34 @@ void printRecord( int record , std::ostream& target )
     target << "{ return reader.open( context, #object, name) \\" << std::endl;
 	for( int i = 0; i < record; i ++ )
 	{
-		target << "  && deserialize(reader, context, s1.##member" << i << ", #member" << i << ") \\" << std::endl;
+		target << "  && deserialize(reader, context, s1.member" << i << ", #member" << i << ") \\" << std::endl;
 	}
 	target << "  && reader.close(context); } \\" << std::endl;
-	target << "inline bool deserialize(" _namespace_ " " _reader_ "& reader, " _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
-    target << "{ return deserialize_##object(reader, context, s1, name);}" << std::endl;
+	target << "inline bool deserialize(" _namespace_ " " _reader_ "& reader, " _namespace_ " " _context_ "& context, object & s1, const tchar* name=0) \\" << std::endl;
+    target << "{ return deserialize_##object(reader, context, s1, name);} \\" << std::endl;
+
+	// Ƹʽķ뺯, Ҫֶ
+	target << "inline size_t binary_size(const object & s1) \\" << std::endl;
+	target << "{ return 0 \\" << std::endl;
+	for( int i = 0; i < record; i ++ )
+	{
+		target << "  + binary_format::size(s1.member" << i << ") \\" << std::endl;
+	}
+	target << "  ; } \\" << std::endl;
+	target << "inline char* binary_encode(char* p, const object & s1) \\" << std::endl;
+	target << "{ \\" << std::endl;
+	for( int i = 0; i < record; i ++ )
+	{
+		target << "  p = binary_format::encode(p, s1.member" << i << "); \\" << std::endl;
+	}
+	target << "  return p; } \\" << std::endl;
+	target << "inline bool binary_decode(const char*& p, const char* end, object & s1) \\" << std::endl;
+	target << "{ return true \\" << std::endl;
+	for( int i = 0; i < record; i ++ )
+	{
+		target << "  && binary_format::decode(p, end, s1.member" << i << ") \\" << std::endl;
+	}
+	target << "  ; }" << std::endl;
 
 	target << "" << std::endl;
 }
@@ -50,11 +73,11 @@ void printRecordv2( int record , std::ostream& target )
 	}
 	target << " ) \\" << std::endl;
 
-	target << "inline bool serialize_##object( " _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, object & s1, const tchar* name=0) \\" << std::endl;
+	target << "inline bool serialize_##object( " _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
     target << "{ return writer.open( context, #object, name) \\" << std::endl;
 	for( int i = 0; i < record; i ++ )
 	{
-		target << "  && serialize_##member_type" << i<< "(writer, context, s1.##member" << i << ", #member" << i << ") \\" << std::endl;
+		target << "  && serialize_##member_type" << i<< "(writer, context, s1.member" << i << ", #member" << i << ") \\" << std::endl;
 	}
 	target << "  && writer.close( context); } \\" << std::endl;
 	target << "inline bool serialize(" _namespace_ " " _writer_ "& writer, " _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
@@ -64,10 +87,10 @@ void printRecordv2( int record , std::ostream& target )
     target << "{ return reader.open( context, #object, name) \\" << std::endl;
 	for( int i = 0; i < record; i ++ )
 	{
-		target << "  && deserialize_##member_type" << i<< "(reader, context, s1.##member" << i << ", #member" << i << ") \\" << std::endl;
+		target << "  && deserialize_##member_type" << i<< "(reader, context, s1.member" << i << ", #member" << i << ") \\" << std::endl;
 	}
-	target << "  && writer.close(context); } \\" << std::endl;
-	target << "inline bool deserialize(" _namespace_ " " _reader_ "& reader," _namespace_ " " _context_ "& context, const object & s1, const tchar* name=0) \\" << std::endl;
+	target << "  && reader.close(context); } \\" << std::endl;
+	target << "inline bool deserialize(" _namespace_ " " _reader_ "& reader," _namespace_ " " _context_ "& context, object & s1, const tchar* name=0) \\" << std::endl;
     target << "{ return deserialize_##object(reader, context, s1, name);}" << std::endl;
 
 	target << "" << std::endl;
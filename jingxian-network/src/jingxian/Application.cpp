@@ -5,8 +5,12 @@
 #include "jingxian/Application.h"
 #include "jingxian/directory.h"
 #include "jingxian/networks/IOCPServer.h"
+#include "jingxian/networks/filters/FilterTransport.h"
+#include "jingxian/networks/filters/CompressionFilter.h"
 #include "jingxian/protocol/Proxy/ProxyProtocolFactory.h"
 #include "jingxian/protocol/EchoProtocolFactory.h"
+#include "jingxian/protocol/CoroutineEchoProtocol.h"
+#include "jingxian/protocol/http/HttpProtocolFactory.h"
 
 
 # include "log4cpp/PropertyConfigurator.hh"
@@ -63,6 +67,9 @@ void usage(int argc, tchar** args)
   tcout << _T("\t\t") << getFileName(args[0]) << _T(" --service")
   << _T(" [Win32Ĳ1] [Win32Ĳ2] ...") << std::endl;
 
+  tcout << _T("\tл׼:") << std::endl;
+  tcout << _T("\t\t") << getFileName(args[0]) << _T(" --benchmark[=ƹ]") << std::endl;
+
   tcout << _T("\tð:") << std::endl;
   tcout << _T("\t\t") << getFileName(args[0]) << _T(" --help") << std::endl;
 
@@ -70,6 +77,7 @@ void usage(int argc, tchar** args)
 
   tcout << _T("\t\t--config=xxx\r\rָļ") << std::endl;
   tcout << _T("\t\t--logConfig=xxx\r\rָ log ļ") << std::endl;
+  tcout << _T("\t\t--workers=n\r\rԶģʽ,  n ") << std::endl;
 }
 
 int Application::main(int argc, tchar** args)
@@ -209,7 +217,16 @@ int Application::main(int argc, tchar** args)
 }
 
 Application::Application(const tstring& name, const tstring& descr)
-    : name_(name)
+    : shards_(&core_)
+    , reactorShards_(1)
+    , reactorAffinity_(false)
+    , name_(name)
+    , workers_(0)
+    , executorThreads_(0)
+    , supervisor_(NULL)
+    , profilerEnabled_(false)
+    , profilerInterval_(10)
+    , captureEnabled_(false)
     , toString_(descr)
 {
   networking::initializeScket();
@@ -217,13 +234,6 @@ Application::Application(const tstring& name, const tstring& descr)
 
 Application::~Application()
 {
-	for(std::map<tstring, configure::callback_type*>::iterator it=callbacks_.begin()
-	  ; it != callbacks_.end(); ++it)
-  {
-	  delete (it->second);
-  }
-  callbacks_.clear();
-
   networking::shutdownSocket();
 }
 
@@ -239,6 +249,9 @@ int Application::onRun(const std::vector<tstring>& args)
 
   tstring configFile = combinePath(getApplicationDirectory(), _T("default.conf"));
   tstring logFile = combinePath(getApplicationDirectory(), _T("log4cpp.conf"));
+  int workers = -1;
+  int workerIndex = -1;
+  DWORD supervisorPid = 0;
 
   for (std::vector<tstring>::const_iterator it=args.begin()
        ; it != args.end(); ++ it)
@@ -259,6 +272,18 @@ int Application::onRun(const std::vector<tstring>& args)
           else
             logFile = combinePath(getApplicationDirectory(), tmp);
         }
+      else if (0 == string_traits<tchar>::strnicmp(_T("--workers="), it->c_str(), 10))
+        {
+          workers = string_traits<tchar>::atoi(it->c_str() + 10);
+        }
+      else if (0 == string_traits<tchar>::strnicmp(_T("--worker="), it->c_str(), 9))
+        {
+          workerIndex = string_traits<tchar>::atoi(it->c_str() + 9);
+        }
+      else if (0 == string_traits<tchar>::strnicmp(_T("--supervisor="), it->c_str(), 13))
+        {
+          supervisorPid = (DWORD)string_traits<tchar>::atoi(it->c_str() + 13);
+        }
     }
 
   try
@@ -306,7 +331,7 @@ int Application::onRun(const std::vector<tstring>& args)
       // ɾע
       tstring::size_type index = line.find(_T('#'));
       if (tstring::npos != index)
-        line = line.substr(index);
+        line = line.substr(0, index);
 
       // ɾհ
       line = trim_right(line);
@@ -343,21 +368,199 @@ int Application::onRun(const std::vector<tstring>& args)
 
   //core_.listenWith(_T("tcp://0.0.0.0:6544"), new proxy::Proxy(core_.basePath()));
   //core_.listenWith(_T("tcp://0.0.0.0:6543"), new EchoProtocolFactory());
+
+  // , ʹüؽ̹ļ socket
+  if (0 <= workerIndex)
+    {
+      WorkerAgent agent;
+      if (!agent.attach(supervisorPid, workerIndex, core_))
+        return -1;
+
+      if (!core_.executor().start(executorThreads_))
+        return -1;
+
+      startProfiler();
+      startCapture();
+      if (!startShards())
+        return -1;
+      core_.runForever();
+      stopShards();
+      profiler_.stop();
+      return 0;
+    }
+
+  if (0 <= workers)
+    workers_ = workers;
+
+  // ؽ, 򿪼ַ
+  if (0 < workers_)
+    {
+      Supervisor supervisor(workers_);
+      for (std::vector<tstring>::const_iterator it = listenEndPoints_.begin()
+           ; it != listenEndPoints_.end(); ++ it)
+        {
+          if (!supervisor.addListener(*it))
+            return -1;
+        }
+
+      supervisor_ = &supervisor;
+      int result = supervisor.run(args);
+      supervisor_ = NULL;
+      return result;
+    }
+
+  if (!core_.executor().start(executorThreads_))
+    return -1;
+
+  startProfiler();
+  startCapture();
+  if (!startShards())
+    return -1;
   core_.runForever();
+  stopShards();
+  profiler_.stop();
   return 0;
 }
 
-void Application::onControl(DWORD dwEventType
+void Application::startProfiler()
+{
+  tstring output = profilerOutput_;
+  if (output.empty())
+    {
+      tstring path = combinePath(core_.basePath(), _T("log"));
+      if (!existDirectory(path))
+        createDirectory(path);
+      output = combinePath(path, concat<tstring>(_T("profile."), ::toString((int)GetCurrentProcessId()), _T(".folded")));
+    }
+
+  // ʧܲӰ
+  if (!profiler_.start(profilerInterval_, output))
+    return;
+
+  profiler_.addCurrentThread();
+  if (profilerEnabled_)
+    profiler_.toggle();
+}
+
+void Application::startCapture()
+{
+  TrafficCapture::Options options = captureOptions_;
+  if (options.path.empty())
+    {
+      tstring path = combinePath(core_.basePath(), _T("log"));
+      if (!existDirectory(path))
+        createDirectory(path);
+      options.path = combinePath(path, concat<tstring>(_T("capture."), ::toString((int)GetCurrentProcessId()), _T(".jxcap")));
+    }
+
+  // ץʧܲӰ, ̨߳ core_ رʱֹͣ
+  if (!core_.capture().start(options))
+    return;
+
+  if (captureEnabled_)
+    core_.capture().toggle();
+}
+
+bool Application::startShards()
+{
+  if (1 == reactorShards_)
+    return true;
+
+  // Ƭ߳ҲǼǵ
+  return shards_.start(reactorShards_, reactorAffinity_, &profiler_);
+}
+
+void Application::stopShards()
+{
+  if (0 == shards_.size())
+    return;
+
+  shards_.logStats();
+  shards_.stop();
+}
+
+void Application::onControl(DWORD dwControl
+                            , DWORD dwEventType
                             , LPVOID lpEventData)
 {
+  if (PROFILER_TOGGLE_CONTROL == dwControl)
+    {
+      if (NULL != supervisor_)
+        supervisor_->toggleProfilers();
+      else
+        profiler_.toggle();
+    }
+  else if (CAPTURE_TOGGLE_CONTROL == dwControl)
+    {
+      if (NULL != supervisor_)
+        supervisor_->toggleCaptures();
+      else
+        core_.capture().toggle();
+    }
+  else if (MEMORY_DUMP_CONTROL == dwControl)
+    {
+      if (NULL != supervisor_)
+        supervisor_->dumpMemory();
+      else
+        MemoryBudget::dump(GetCurrentProcessId());
+    }
 }
 
 void Application::interrupt()
 {
-  core_.interrupt();
+  if (NULL != supervisor_)
+    supervisor_->interrupt();
+  else
+    core_.interrupt();
 }
 
 
+namespace
+{
+  /**
+   * IfModule , ָֻ callbacks_ лصָ, Է
+   * delegate 洢
+   */
+  class IfModule
+  {
+  public:
+    IfModule(const configure::callback_type* ptr)
+        : ptr_(ptr)
+    {
+    }
+
+    bool operator()(configure::Context& context, const tstring& txt)
+    {
+      tstring line = replace_all(replace_all(trim_all(txt)
+                                             , 0, _T(" "), 1, _T(""), 0)
+                                 , 0, _T("\t"), 1, _T(""), 0);
+      if (0 == string_traits<tstring::value_type>::strcmp(_T("</IfModule>"), line.c_str()))
+        return true;
+
+      return (*ptr_)(context, txt);
+    }
+
+  private:
+    const configure::callback_type* ptr_;
+  };
+
+  /**
+   * ȡе, еĵλΪ KB/s, 0 ʾ
+   */
+  bool readRate(const tchar* text, uint32_t& rate)
+  {
+    if (!ctype_traits<tchar>::is_digit(*text))
+      return false;
+
+    int value = string_traits<tchar>::atoi(text);
+    if (0 > value || 4*1024*1024 <= value)
+      return false;
+
+    rate = (uint32_t)value * 1024;
+    return true;
+  }
+}
+
 bool Application::configure(configure::Context& context, const tstring& txt)
 {
   tstring::size_type index = txt.find_first_of(_T(" \t"));
@@ -390,22 +593,493 @@ bool Application::configure(configure::Context& context, const tstring& txt)
           return false;
         }
 
-      if (!core_.listenWith(sa.ptr(0), protocolFactory))
+      // Эǹ,  socket 
+      IProtocolFactory* listenFactory = protocolFactory;
+      if (2 < sa.size())
+        {
+          FilterProtocolFactory* filterFactory = new FilterProtocolFactory(&core_.timers(), protocolFactory);
+          for (size_t i = 2; i < sa.size(); ++ i)
+            {
+              IFilterFactory* filter = createFilterFactory(sa.ptr(i));
+              if (null_ptr == filter)
+                {
+                  LOG_FATAL(context.logger(), _T(" '")<< sa.ptr(i) << _T("' ʧ!"));
+                  delete filterFactory;
+                  context.exit();
+                  return false;
+                }
+              filterFactory->push(filter);
+            }
+          listenFactory = filterFactory;
+        }
+
+      if (!core_.listenWith(sa.ptr(0), listenFactory))
         {
           LOG_FATAL(context.logger(), _T(" 'listen' ʽȷ"));
           context.exit();
           return false;
         }
+      listenEndPoints_.push_back(sa.ptr(0));
 
 
-	  callbacks_[sa.ptr(1)] = new _connection<IProtocolFactory
-		  ,bool (configure::Context& context, const tstring& txt)>
-						(protocolFactory, &IProtocolFactory::configure);
+	  callbacks_[sa.ptr(1)] = configure::callback_type(protocolFactory, &IProtocolFactory::configure);
 
       //context.connect(protocolFactory, &IProtocolFactory::configure);
       return true;
     }
 
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("workers"), command.c_str()))
+    {
+      int workers = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > workers)
+        {
+          LOG_FATAL(context.logger(), _T(" 'workers' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      workers_ = workers;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("executorThreads"), command.c_str()))
+    {
+      int threads = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > threads)
+        {
+          LOG_FATAL(context.logger(), _T(" 'executorThreads' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      executorThreads_ = threads;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("coroutineStackSize"), command.c_str()))
+    {
+      int size = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 >= size)
+        {
+          LOG_FATAL(context.logger(), _T(" 'coroutineStackSize' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.coroutines().stackSize(size * 1024);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("coroutinePool"), command.c_str()))
+    {
+      int count = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > count)
+        {
+          LOG_FATAL(context.logger(), _T(" 'coroutinePool' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.coroutines().maxPooled(count);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("reactorShards"), command.c_str()))
+    {
+      int count = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > count)
+        {
+          LOG_FATAL(context.logger(), _T(" 'reactorShards' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      reactorShards_ = count;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("reactorAffinity"), command.c_str()))
+    {
+      tstring value = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("on"), value.c_str()))
+        reactorAffinity_ = true;
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("off"), value.c_str()))
+        reactorAffinity_ = false;
+      else
+        {
+          LOG_FATAL(context.logger(), _T(" 'reactorAffinity' ʽȷ"));
+          context.exit();
+        }
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("reactorBalance"), command.c_str()))
+    {
+      tstring value = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("roundRobin"), value.c_str()))
+        shards_.policy(ShardPolicy::RoundRobin);
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("leastLoaded"), value.c_str()))
+        shards_.policy(ShardPolicy::LeastLoaded);
+      else
+        {
+          LOG_FATAL(context.logger(), _T(" 'reactorBalance' ʽȷ"));
+          context.exit();
+        }
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("profiler"), command.c_str()))
+    {
+      tstring value = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("on"), value.c_str()))
+        profilerEnabled_ = true;
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("off"), value.c_str()))
+        profilerEnabled_ = false;
+      else
+        {
+          LOG_FATAL(context.logger(), _T(" 'profiler' ʽȷ"));
+          context.exit();
+        }
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("profilerInterval"), command.c_str()))
+    {
+      int interval = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 >= interval)
+        {
+          LOG_FATAL(context.logger(), _T(" 'profilerInterval' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      profilerInterval_ = (DWORD)interval;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("profilerOutput"), command.c_str()))
+    {
+      tstring path = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (path.empty())
+        {
+          LOG_FATAL(context.logger(), _T(" 'profilerOutput' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      profilerOutput_ = isAbsolute(path) ? path : combinePath(core_.basePath(), path);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("capture"), command.c_str()))
+    {
+      tstring value = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("on"), value.c_str()))
+        captureEnabled_ = true;
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("off"), value.c_str()))
+        captureEnabled_ = false;
+      else
+        {
+          LOG_FATAL(context.logger(), _T(" 'capture' ʽȷ"));
+          context.exit();
+        }
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("capturePorts"), command.c_str()))
+    {
+      captureOptions_.ports.clear();
+      StringArray<tstring::value_type> sa = split((tstring::npos == index) ? _T("") : txt.c_str() + index + 1
+                                                  , _T(" \t,")
+                                                  , StringSplitOptions::RemoveEmptyEntries);
+      for (size_t i = 0; i < sa.size(); ++ i)
+        {
+          int port = string_traits<tstring::value_type>::atoi(sa.ptr(i));
+          if (0 >= port || 65535 < port)
+            {
+              LOG_FATAL(context.logger(), _T(" 'capturePorts' ʽȷ"));
+              context.exit();
+              return true;
+            }
+          captureOptions_.ports.push_back(port);
+        }
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("captureSampling"), command.c_str()))
+    {
+      int sampling = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 >= sampling)
+        {
+          LOG_FATAL(context.logger(), _T(" 'captureSampling' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      captureOptions_.sampling = sampling;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("captureBudget"), command.c_str()))
+    {
+      int budget = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 >= budget)
+        {
+          LOG_FATAL(context.logger(), _T(" 'captureBudget' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      captureOptions_.budget = (uint64_t)budget * 1024 * 1024;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("captureOutput"), command.c_str()))
+    {
+      tstring path = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (path.empty())
+        {
+          LOG_FATAL(context.logger(), _T(" 'captureOutput' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      captureOptions_.path = isAbsolute(path) ? path : combinePath(core_.basePath(), path);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("shapeConnection"), command.c_str()))
+    {
+      StringArray<tstring::value_type> sa = split((tstring::npos == index) ? _T("") : txt.c_str() + index + 1
+                                                  , _T(" \t")
+                                                  , StringSplitOptions::RemoveEmptyEntries);
+      uint32_t receive = 0;
+      uint32_t send = 0;
+      if (2 != sa.size() || !readRate(sa.ptr(0), receive) || !readRate(sa.ptr(1), send))
+        {
+          LOG_FATAL(context.logger(), _T(" 'shapeConnection' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.shaper().connectionRate(receive, send);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("shapeListener"), command.c_str()))
+    {
+      StringArray<tstring::value_type> sa = split((tstring::npos == index) ? _T("") : txt.c_str() + index + 1
+                                                  , _T(" \t")
+                                                  , StringSplitOptions::RemoveEmptyEntries);
+      Endpoint endpoint;
+      uint32_t receive = 0;
+      uint32_t send = 0;
+      if (3 != sa.size()
+          || !Endpoint::parse(sa.ptr(0), endpoint)
+          || !readRate(sa.ptr(1), receive)
+          || !readRate(sa.ptr(2), send))
+        {
+          LOG_FATAL(context.logger(), _T(" 'shapeListener' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.shaper().listenerRate(endpoint.address(), receive, send);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("shapeUser"), command.c_str()))
+    {
+      StringArray<tstring::value_type> sa = split((tstring::npos == index) ? _T("") : txt.c_str() + index + 1
+                                                  , _T(" \t")
+                                                  , StringSplitOptions::RemoveEmptyEntries);
+      uint32_t upload = 0;
+      uint32_t download = 0;
+      if (3 != sa.size() || !readRate(sa.ptr(1), upload) || !readRate(sa.ptr(2), download))
+        {
+          LOG_FATAL(context.logger(), _T(" 'shapeUser' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.shaper().userRate(sa.ptr(0), upload, download);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("maxSessions"), command.c_str()))
+    {
+      int limit = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > limit)
+        {
+          LOG_FATAL(context.logger(), _T(" 'maxSessions' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.admission().options().maxSessions = limit;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("maxListenerSessions"), command.c_str()))
+    {
+      StringArray<tstring::value_type> sa = split((tstring::npos == index) ? _T("") : txt.c_str() + index + 1
+                                                  , _T(" \t")
+                                                  , StringSplitOptions::RemoveEmptyEntries);
+      Endpoint endpoint;
+      const tchar* limit = (0 == sa.size()) ? null_ptr : sa.ptr(sa.size() - 1);
+      if (is_null(limit)
+          || 2 < sa.size()
+          || !ctype_traits<tchar>::is_digit(*limit)
+          || (2 == sa.size() && !Endpoint::parse(sa.ptr(0), endpoint)))
+        {
+          LOG_FATAL(context.logger(), _T(" 'maxListenerSessions' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      if (2 == sa.size())
+        core_.admission().listenerLimit(endpoint.address(), string_traits<tchar>::atoi(limit));
+      else
+        core_.admission().options().maxListenerSessions = string_traits<tchar>::atoi(limit);
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("maxSourceSessions"), command.c_str()))
+    {
+      int limit = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > limit)
+        {
+          LOG_FATAL(context.logger(), _T(" 'maxSourceSessions' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.admission().options().maxSourceSessions = limit;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("maxLoopLag"), command.c_str()))
+    {
+      int lag = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > lag)
+        {
+          LOG_FATAL(context.logger(), _T(" 'maxLoopLag' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.admission().options().maxLoopLag = lag;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("memoryBudget"), command.c_str()))
+    {
+      int megabytes = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > megabytes)
+        {
+          LOG_FATAL(context.logger(), _T(" 'memoryBudget' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.memory().options().limit = ((size_t)megabytes) * 1024 * 1024;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("memoryTopN"), command.c_str()))
+    {
+      int count = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > count)
+        {
+          LOG_FATAL(context.logger(), _T(" 'memoryTopN' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.memory().options().topN = count;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsCertificate"), command.c_str())
+      || 0 == string_traits<tstring::value_type>::stricmp(_T("tlsPrivateKey"), command.c_str())
+      || 0 == string_traits<tstring::value_type>::stricmp(_T("tlsTicketKey"), command.c_str()))
+    {
+      tstring path = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (path.empty())
+        {
+          LOG_FATAL(context.logger(), _T(" '") << command << _T("' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      path = isAbsolute(path) ? path : combinePath(core_.basePath(), path);
+      TLSContext::Options& options = core_.tls().options();
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsCertificate"), command.c_str()))
+        options.certificate = path;
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsPrivateKey"), command.c_str()))
+        options.privateKey = path;
+      else
+        options.ticketKey = path;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsCiphers"), command.c_str()))
+    {
+      tstring ciphers = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (ciphers.empty())
+        {
+          LOG_FATAL(context.logger(), _T(" 'tlsCiphers' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.tls().options().ciphers = ciphers;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsSessionCache"), command.c_str()))
+    {
+      int size = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 > size)
+        {
+          LOG_FATAL(context.logger(), _T(" 'tlsSessionCache' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.tls().options().sessionCacheSize = size;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsSessionTimeout"), command.c_str()))
+    {
+      int seconds = (tstring::npos == index) ? -1 : string_traits<tstring::value_type>::atoi(txt.c_str() + index + 1);
+      if (0 >= seconds)
+        {
+          LOG_FATAL(context.logger(), _T(" 'tlsSessionTimeout' ʽȷ"));
+          context.exit();
+          return true;
+        }
+
+      core_.tls().options().sessionTimeout = seconds;
+      return true;
+    }
+
+  if (0 == string_traits<tstring::value_type>::stricmp(_T("tlsTickets"), command.c_str()))
+    {
+      tstring value = (tstring::npos == index) ? tstring() : trim_all(txt.substr(index + 1));
+      if (0 == string_traits<tstring::value_type>::stricmp(_T("on"), value.c_str()))
+        core_.tls().options().tickets = true;
+      else if (0 == string_traits<tstring::value_type>::stricmp(_T("off"), value.c_str()))
+        core_.tls().options().tickets = false;
+      else
+        {
+          LOG_FATAL(context.logger(), _T(" 'tlsTickets' ʽȷ"));
+          context.exit();
+        }
+      return true;
+    }
+
   if (0 == string_traits<tstring::value_type>::strcmp(_T("<IfModule"), command.c_str()))
   {
       if (tstring::npos == index)
@@ -432,7 +1106,7 @@ bool Application::configure(configure::Context& context, const tstring& txt)
           return true;
 	    }
 
-	  std::map<tstring, configure::callback_type*>::iterator it = callbacks_.find(sa.ptr(1));
+	  std::map<tstring, configure::callback_type>::iterator it = callbacks_.find(sa.ptr(1));
 	  if(it == callbacks_.end())
 	  {
           LOG_FATAL(context.logger(), _T("ģ '") << sa.ptr(1) << _T("' ʶ!"));
@@ -440,34 +1114,7 @@ bool Application::configure(configure::Context& context, const tstring& txt)
           return false;
 	  }
 
-	  // IfModule 
-	  class IfModule : public configure::callback_type
-	  {
-	  public:
-			IfModule(configure::callback_type* ptr)
-				: ptr_(ptr)
-			{
-			}
-
-			virtual ~IfModule()
-			{
-			}
-
-			virtual bool call(configure::Context& context, const tstring& txt)
-			{
-				tstring line = replace_all(replace_all(trim_all(txt)
-											, 0, _T(" "), 1, _T(""), 0)
-												, 0, _T("\t"), 1, _T(""), 0);
-				if(0 == string_traits<tstring::value_type>::strcmp(_T("</IfModule>"), line.c_str()))
-					return true;
-
-				return ptr_->call(context, txt);
-			}
-	  private:
-		  configure::callback_type* ptr_;
-	  };
-
-	  context.push(new IfModule(it->second));
+	  context.push(IfModule(&it->second));
 	  return true;
   }
   
@@ -482,6 +1129,20 @@ IProtocolFactory* Application::createProtocolFactory(tchar* name)
   if (0 == string_traits<tchar>::stricmp(_T("echo"), name))
     return new EchoProtocolFactory();
 
+  if (0 == string_traits<tchar>::stricmp(_T("coecho"), name))
+    return new CoroutineEchoProtocolFactory(&core_.coroutines());
+
+  if (0 == string_traits<tchar>::stricmp(_T("http"), name))
+    return new http::HttpProtocolFactory();
+
+  return NULL;
+}
+
+IFilterFactory* Application::createFilterFactory(tchar* name)
+{
+  if (0 == string_traits<tchar>::stricmp(_T("lz4"), name))
+    return new CompressionFilterFactory();
+
   return NULL;
 }
 
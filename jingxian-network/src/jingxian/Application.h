@@ -14,8 +14,12 @@
 #include <iostream>
 #include "jingxian/directory.h"
 #include "jingxian/configure.h"
+#include "jingxian/IFilter.h"
 #include "jingxian/networks/IOCPServer.h"
+#include "jingxian/networks/ReactorShards.h"
+#include "jingxian/proc/Supervisor.h"
 #include "jingxian/utilities/NTService.h"
+#include "jingxian/utilities/SamplingProfiler.h"
 
 _jingxian_begin
 
@@ -45,11 +49,15 @@ public:
 
     /**
      * յһû֪ͨ
+     * @param dwControl , PROFILER_TOGGLE_CONTROL ʼ,
+     *                  CAPTURE_TOGGLE_CONTROL ʼץ,
+     *                  MEMORY_DUMP_CONTROL ־ڴͳ
      * @param dwEventType û¼
      * @param lpEventData û¼
      * @remarks ע⣬Է쳣
      */
-    virtual void onControl(DWORD dwEventType
+    virtual void onControl(DWORD dwControl
+                           , DWORD dwEventType
                            , LPVOID lpEventData);
 
     /**
@@ -68,10 +76,57 @@ private:
     Application(const tstring& name, const tstring& descr);
 
 	IProtocolFactory* createProtocolFactory(tchar* name);
+	IFilterFactory* createFilterFactory(tchar* name);
+
+    /**
+     * ̲߳Ǽǵǰ߳
+     */
+    void startProfiler();
+
+    /**
+     * ץĺ̨߳
+     */
+    void startCapture();
+
+    /**
+     * ¼ѭķƬ
+     */
+    bool startShards();
+
+    /**
+     * ¼Ƭͳƺֹͣ
+     */
+    void stopShards();
 
     IOCPServer core_;
+    /// ¼ѭķƬ,  0  core_
+    ReactorShards shards_;
+    /// Ƭ, Ϊ 1 ʱƬ, Ϊ 0 ʱȡ CPU ĸ
+    size_t reactorShards_;
+    /// ǷÿƬ󶨵һ CPU 
+    bool reactorAffinity_;
     tstring name_;
-	std::map<tstring, configure::callback_type*> callbacks_;
+    /// ,  0 ʱԶģʽ
+    size_t workers_;
+    /// ̳߳ص߳, Ϊ 0 ʱȡ CPU ĸ
+    size_t executorThreads_;
+    /// еļַ, ģʽɼؽ̴
+    std::vector<tstring> listenEndPoints_;
+    /// ģʽµļؽ
+    Supervisor* supervisor_;
+    /// ¼ѭ̵߳Ĳ
+    SamplingProfiler profiler_;
+    /// Ͽʼ
+    bool profilerEnabled_;
+    /// (  )
+    DWORD profilerInterval_;
+    /// ļ, Ϊʱд log/profile.<pid>.folded
+    tstring profilerOutput_;
+    /// Ͽʼץ
+    bool captureEnabled_;
+    /// ץѡ, path Ϊʱд log/capture.<pid>.jxcap
+    TrafficCapture::Options captureOptions_;
+	std::map<tstring, configure::callback_type> callbacks_;
     tstring toString_;
 };
 
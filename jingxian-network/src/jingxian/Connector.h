@@ -9,7 +9,7 @@
 #endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
 
 // Include files
-# include <functional>
+# include "jingxian/delegate.h"
 # include "jingxian/string/string.h"
 # include "jingxian/IReactorCore.h"
 
@@ -18,13 +18,21 @@ _jingxian_begin
 class Connector
 {
 public:
-    template<typename F1, typename F2, typename T>
+    /**
+     * һĻص, ص delegate ʽر. 
+     * ǰΪ context  IReactorCore, ÿҪһ
+     * , صڴ
+     */
+    template<typename T>
     class closure
     {
     public:
-        closure(const F1& func1, const F2& func2, T context)
-                : function1_(func1)
-                , function2_(func2)
+        typedef delegate<void (ITransport*, T&)> complete_type;
+        typedef delegate<void (const ErrorCode&, T&)> error_type;
+
+        closure(const complete_type& onComplete, const error_type& onError, T context)
+                : onComplete_(onComplete)
+                , onError_(onError)
                 , context_(context)
         {
         }
@@ -32,51 +40,43 @@ public:
         static void OnComplete(ITransport* transport, void* context)
         {
             std::auto_ptr<closure> self(static_cast<closure*>(context));
-            self->function1_(transport, self->context_);
+            self->onComplete_(transport, self->context_);
         }
 
         static void OnError(const ErrorCode& err, void* context)
         {
             std::auto_ptr<closure> self(static_cast<closure*>(context));
-            self->function2_(err, self->context_);
+            self->onError_(err, self->context_);
         }
 
     private:
-        F1 function1_;
-        F2 function2_;
+        complete_type onComplete_;
+        error_type onError_;
         T context_;
     };
 
-    template<typename C, typename F1, typename F2, typename T>
-    class closure_0
+    /**
+     * ĳԱ, ָֻС, Է delegate 洢
+     */
+    template<typename C, typename F, typename T>
+    class method_closure
     {
     public:
-
-        closure_0(C c, const F1& func1, const F2& func2, T context)
+        method_closure(C c, F f)
                 : c_(c)
-                , function1_(func1)
-                , function2_(func2)
-                , context_(context)
+                , f_(f)
         {
         }
 
-        static void OnComplete(ITransport* transport, void* context)
+        template<typename A>
+        void operator()(const A& a, T& context)
         {
-            std::auto_ptr<closure_0> self(static_cast<closure_0*>(context));
-            (self->c_->*(self->function1_))(transport, self->context_);
-        }
-
-        static void OnError(const ErrorCode& err, void* context)
-        {
-            std::auto_ptr<closure_0> self(static_cast<closure_0*>(context));
-            (self->c_->*(self->function2_))(err, self->context_);
+            (c_->*f_)(a, context);
         }
 
     private:
         C c_;
-        F1 function1_;
-        F2 function2_;
-        T context_;
+        F f_;
     };
 
     Connector(IReactorCore* core, const tchar* host)
@@ -111,7 +111,7 @@ public:
                             , F2 onError
                             , T context)
     {
-        typedef closure<F1, F2, T> closure_type;
+        typedef closure<T> closure_type;
         core->connectWith(host
                           , closure_type::OnComplete
                           , closure_type::OnError
@@ -129,11 +129,13 @@ public:
                             , F2 onError
                             , T context)
     {
-        typedef closure_0<C, F1, F2, T> closure_type;
+        typedef closure<T> closure_type;
         core->connectWith(host
                           , closure_type::OnComplete
                           , closure_type::OnError
-                          , new closure_type(c, onComplete, onError, context));
+                          , new closure_type(method_closure<C, F1, T>(c, onComplete)
+                                             , method_closure<C, F2, T>(c, onError)
+                                             , context));
     }
 
 
@@ -145,7 +147,7 @@ public:
                      , F2 onError
                      , T context)
     {
-        typedef closure<F1, F2, T> closure_type;
+        typedef closure<T> closure_type;
         core_->connectWith(host_.c_str()
                            , closure_type::OnComplete
                            , closure_type::OnError
@@ -161,11 +163,13 @@ public:
                      , F2 onError
                      , T context)
     {
-        typedef closure_0<C, F1, F2, T> closure_type;
+        typedef closure<T> closure_type;
         core_->connectWith(host_.c_str()
                            , closure_type::OnComplete
                            , closure_type::OnError
-                           , new closure_type(c, onComplete, onError, context));
+                           , new closure_type(method_closure<C, F1, T>(c, onComplete)
+                                             , method_closure<C, F2, T>(c, onError)
+                                             , context));
     }
 
 
@@ -212,17 +216,34 @@ public:
     typedef void (T::*ONERROR)(const ErrorCode&, CONTEXT);
 
     ConnectProxy(T* t, const tstring& host, IReactorCore* core, ONCOMPLETE onComplete, ONERROR onError, CONTEXT context)
-            : t_(t)
-            , host_(host)
+            : host_(host)
             , core_(core)
-            , function1_(onComplete)
-            , function2_(onError)
+            , onComplete_(t, onComplete)
+            , onError_(t, onError)
+            , context_(context)
+    {
+    }
+
+    ConnectProxy(T* t, const Endpoint& endPoint, IReactorCore* core, ONCOMPLETE onComplete, ONERROR onError, CONTEXT context)
+            : endPoint_(endPoint)
+            , core_(core)
+            , onComplete_(t, onComplete)
+            , onError_(t, onError)
             , context_(context)
     {
     }
 
     void connectWith()
     {
+        if (endPoint_.isValid())
+        {
+            core_->connectWith(endPoint_
+                               , ConnectProxy::OnComplete
+                               , ConnectProxy::OnError
+                               , this);
+            return;
+        }
+
         core_->connectWith(host_.c_str()
                            , ConnectProxy::OnComplete
                            , ConnectProxy::OnError
@@ -231,35 +252,36 @@ public:
 
     void shutdown()
     {
-        t_ = null_ptr;
+        onComplete_.clear();
+        onError_.clear();
     }
 
-    const tstring& host() const
+    tstring host() const
     {
-        return host_;
+        return endPoint_.isValid() ? endPoint_.toString() : host_;
     }
 
     static void OnComplete(ITransport* transport, void* context)
     {
         std::auto_ptr<ConnectProxy> self(static_cast<ConnectProxy*>(context));
-        if (null_ptr != self->t_)
-            (self->t_->*(self->function1_))(transport, self->context_);
+        if (!self->onComplete_.empty())
+            self->onComplete_(transport, self->context_);
     }
 
     static void OnError(const ErrorCode& err, void* context)
     {
         std::auto_ptr<ConnectProxy> self(static_cast<ConnectProxy*>(context));
-        if (null_ptr != self->t_)
-            (self->t_->*(self->function2_))(err, self->context_);
+        if (!self->onError_.empty())
+            self->onError_(err, self->context_);
     }
 
 private:
     NOCOPY(ConnectProxy);
-    T* t_;
     tstring host_;
+    Endpoint endPoint_;
     IReactorCore* core_;
-    ONCOMPLETE function1_;
-    ONERROR function2_;
+    delegate<void (ITransport*, CONTEXT)> onComplete_;
+    delegate<void (const ErrorCode&, CONTEXT)> onError_;
     CONTEXT context_;
 };
 
@@ -1,124 +1,407 @@
 
 # include "pro_config.h"
+# include <deque>
+# include <hash_map>
+# include "jingxian/threading/mutex.h"
 # include "jingxian/Dictionary.h"
 
 _jingxian_begin
 
-inline bool toBoolean(const tstring& s)
+namespace
 {
-    return s == _T("true") || s == _T("1");
+    /**
+     * ĵǼǱ, Ŵ 1 ʼ, 0 Чľ
+     *
+     * ̶߳ܵǼǺͲҼ, Ҫ.  deque , ʱ
+     * еԪزƶ, name() صһֱЧ.
+     */
+    class KeyRegistry
+    {
+    public:
+        KeyRegistry()
+        {
+            names_.push_back(tstring());
+        }
+
+        uint32_t intern(const tstring& name)
+        {
+            mutex::spcode_lock lock(lock_);
+            stdext::hash_map<tstring, uint32_t>::const_iterator it = index_.find(name);
+            if (index_.end() != it)
+                return it->second;
+
+            uint32_t id = (uint32_t)names_.size();
+            names_.push_back(name);
+            index_[name] = id;
+            return id;
+        }
+
+        uint32_t find(const tstring& name)
+        {
+            mutex::spcode_lock lock(lock_);
+            stdext::hash_map<tstring, uint32_t>::const_iterator it = index_.find(name);
+            return (index_.end() == it) ? 0 : it->second;
+        }
+
+        const tstring& name(uint32_t id)
+        {
+            mutex::spcode_lock lock(lock_);
+            return (id < names_.size()) ? names_[id] : names_[0];
+        }
+
+    private:
+        mutex lock_;
+        stdext::hash_map<tstring, uint32_t> index_;
+        std::deque<tstring> names_;
+    };
+
+    KeyRegistry& registry()
+    {
+        static KeyRegistry instance;
+        return instance;
+    }
+
+    /// ھ̬ʼʱʹǼǱ, ߳ͬʱһε registry()
+    KeyRegistry& initialRegistry = registry();
+
+    inline bool isBlank(tchar c)
+    {
+        return _T(' ') == c || _T('\t') == c || _T('\r') == c || _T('\n') == c;
+    }
+
+    /**
+     * ϸؽһʮ, ǰпհ, ַʱ false
+     */
+    bool parseInteger(const tchar* begin, const tchar* end, int64_t& value)
+    {
+        while (begin != end && isBlank(*begin))
+            ++ begin;
+        while (begin != end && isBlank(*(end - 1)))
+            -- end;
+
+        bool negative = false;
+        if (begin != end && (_T('-') == *begin || _T('+') == *begin))
+            negative = (_T('-') == *(begin ++));
+
+        if (begin == end)
+            return false;
+
+        const uint64_t limit = negative ? (uint64_t)1 << 63 : ((uint64_t)1 << 63) - 1;
+        uint64_t result = 0;
+        for (; begin != end; ++ begin)
+        {
+            if (*begin < _T('0') || *begin > _T('9'))
+                return false;
+
+            uint64_t digit = *begin - _T('0');
+            if (result > (limit - digit) / 10)
+                return false;
+            result = result * 10 + digit;
+        }
+
+        value = negative ? (int64_t)(0 - result) : (int64_t)result;
+        return true;
+    }
+
+    bool parseBoolean(const tstring& text, int64_t integer, bool hasInteger, bool& value)
+    {
+        if (hasInteger)
+        {
+            value = (0 != integer);
+            return true;
+        }
+
+        static const tchar* trueNames[] = { _T("true"), _T("yes"), _T("on") };
+        static const tchar* falseNames[] = { _T("false"), _T("no"), _T("off") };
+        for (size_t i = 0; i < sizeof(trueNames) / sizeof(trueNames[0]); ++ i)
+        {
+            if (0 == string_traits<tchar>::stricmp(text.c_str(), trueNames[i]))
+            {
+                value = true;
+                return true;
+            }
+            if (0 == string_traits<tchar>::stricmp(text.c_str(), falseNames[i]))
+            {
+                value = false;
+                return true;
+            }
+        }
+        return false;
+    }
 }
 
-inline int8_t toInt8(const tstring& s, int8_t defaultValue)
+DictionaryKey DictionaryKey::intern(const tstring& name)
 {
-    return (int8_t)string_traits<tstring::value_type>::atoi(s.c_str());
+    return DictionaryKey(registry().intern(name));
 }
 
-inline int16_t toInt16(const tstring& s, int16_t defaultValue)
+DictionaryKey DictionaryKey::find(const tstring& name)
 {
-    return (int16_t)string_traits<tstring::value_type>::atoi(s.c_str());
+    uint32_t id = registry().find(name);
+    return (0 == id) ? DictionaryKey() : DictionaryKey(id);
 }
 
-inline int32_t toInt32(const tstring& s, int32_t defaultValue)
+const tstring& DictionaryKey::name() const
 {
-    return string_traits<tstring::value_type>::atoi(s.c_str());
+    return registry().name(id_);
 }
 
-inline int64_t toInt64(const tstring& s, int64_t defaultValue)
+Dictionary::Dictionary(void)
+    : mask_(0)
 {
-    return string_traits<tstring::value_type>::atoi64(s.c_str());
 }
 
 Dictionary::~Dictionary(void)
 {
 }
 
-bool Dictionary::has(const tstring& key) const
+const Dictionary::Value* Dictionary::find(const DictionaryKey& key) const
 {
-    return _container.find(key) != _container.end();
+    if (!key.isValid() || slots_.empty())
+        return null_ptr;
+
+    for (size_t i = key.hash() & mask_; ; i = (i + 1) & mask_)
+    {
+        const Slot& slot = slots_[i];
+        if (slot.id == key.id())
+            return &values_[slot.index];
+        if (0 == slot.id)
+            return null_ptr;
+    }
 }
 
-bool Dictionary::getBoolean(const tstring& key, bool defaultValue) const
+Dictionary::Value& Dictionary::insert(const DictionaryKey& key)
+{
+    // װӱ 1/2 , ֤̽кܶ
+    if ((values_.size() + 1) * 2 > slots_.size())
+        rehash(slots_.empty() ? 16 : slots_.size() * 2);
+
+    size_t i = key.hash() & mask_;
+    for (; 0 != slots_[i].id; i = (i + 1) & mask_)
+    {
+        if (slots_[i].id == key.id())
+            return values_[slots_[i].index];
+    }
+
+    slots_[i].id = key.id();
+    slots_[i].index = (uint32_t)values_.size();
+
+    values_.push_back(Value());
+    Value& value = values_.back();
+    value.key = key;
+    value.flags = 0;
+    value.boolean = false;
+    value.integer = 0;
+    return value;
+}
+
+void Dictionary::rehash(size_t capacity)
+{
+    Slot empty = { 0, 0 };
+    slots_.assign(capacity, empty);
+    mask_ = capacity - 1;
+
+    for (size_t index = 0; index < values_.size(); ++ index)
+    {
+        const DictionaryKey& key = values_[index].key;
+        size_t i = key.hash() & mask_;
+        while (0 != slots_[i].id)
+            i = (i + 1) & mask_;
+
+        slots_[i].id = key.id();
+        slots_[i].index = (uint32_t)index;
+    }
+}
+
+bool Dictionary::getInteger(const DictionaryKey& key, int64_t minValue, int64_t maxValue, int64_t& value) const
+{
+    const Value* v = find(key);
+    if (is_null(v) || 0 == (v->flags & HAS_INTEGER))
+        return false;
+    if (v->integer < minValue || v->integer > maxValue)
+        return false;
+
+    value = v->integer;
+    return true;
+}
+
+void Dictionary::setInteger(const DictionaryKey& key, int64_t value)
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
+    Value& v = insert(key);
+    v.flags = HAS_INTEGER | HAS_BOOLEAN;
+    v.integer = value;
+    v.boolean = (0 != value);
+    v.text = ::toString(value);
+}
+
+bool Dictionary::has(const DictionaryKey& key) const
+{
+    return !is_null(find(key));
+}
+
+bool Dictionary::getBoolean(const DictionaryKey& key, bool defaultValue) const
+{
+    const Value* v = find(key);
+    if (is_null(v) || 0 == (v->flags & HAS_BOOLEAN))
         return defaultValue;
-    return toBoolean(it->second);
+    return v->boolean;
 }
 
-int8_t Dictionary::getInt8(const tstring& key, int8_t defaultValue) const
+int8_t Dictionary::getInt8(const DictionaryKey& key, int8_t defaultValue) const
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
+    int64_t value;
+    if (!getInteger(key, -128, 127, value))
         return defaultValue;
-    return toInt8(it->second, defaultValue);
+    return (int8_t)value;
 }
 
+int16_t Dictionary::getInt16(const DictionaryKey& key, int16_t defaultValue) const
+{
+    int64_t value;
+    if (!getInteger(key, -32768, 32767, value))
+        return defaultValue;
+    return (int16_t)value;
+}
 
-int16_t Dictionary::getInt16(const tstring& key, int16_t defaultValue) const
+int32_t Dictionary::getInt32(const DictionaryKey& key, int32_t defaultValue) const
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
+    int64_t value;
+    if (!getInteger(key, -2147483647 - 1, 2147483647, value))
         return defaultValue;
-    return toInt16(it->second, defaultValue);
+    return (int32_t)value;
 }
 
-int32_t Dictionary::getInt32(const tstring& key, int32_t defaultValue) const
+int64_t Dictionary::getInt64(const DictionaryKey& key, int64_t defaultValue) const
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
+    const Value* v = find(key);
+    if (is_null(v) || 0 == (v->flags & HAS_INTEGER))
         return defaultValue;
-    return toInt32(it->second, defaultValue);
+    return v->integer;
 }
 
-int64_t Dictionary::getInt64(const tstring& key, int64_t defaultValue) const
+const tstring& Dictionary::getString(const DictionaryKey& key, const tstring& defaultValue) const
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
+    const Value* v = find(key);
+    if (is_null(v))
         return defaultValue;
-    return toInt64(it->second, defaultValue);
+    return v->text;
+}
+
+bool Dictionary::has(const tstring& key) const
+{
+    return has(DictionaryKey::find(key));
+}
+
+bool Dictionary::getBoolean(const tstring& key, bool defaultValue) const
+{
+    return getBoolean(DictionaryKey::find(key), defaultValue);
+}
+
+int8_t Dictionary::getInt8(const tstring& key, int8_t defaultValue) const
+{
+    return getInt8(DictionaryKey::find(key), defaultValue);
+}
+
+int16_t Dictionary::getInt16(const tstring& key, int16_t defaultValue) const
+{
+    return getInt16(DictionaryKey::find(key), defaultValue);
+}
+
+int32_t Dictionary::getInt32(const tstring& key, int32_t defaultValue) const
+{
+    return getInt32(DictionaryKey::find(key), defaultValue);
+}
+
+int64_t Dictionary::getInt64(const tstring& key, int64_t defaultValue) const
+{
+    return getInt64(DictionaryKey::find(key), defaultValue);
 }
 
 const tstring& Dictionary::getString(const tstring& key, const tstring& defaultValue) const
 {
-    const_iterator it = _container.find(key);
-    if (_container.end() == it)
-        return defaultValue;
-    return it->second;
+    return getString(DictionaryKey::find(key), defaultValue);
+}
+
+void Dictionary::setBoolean(const DictionaryKey& key, bool value)
+{
+    Value& v = insert(key);
+    v.flags = HAS_INTEGER | HAS_BOOLEAN;
+    v.integer = value ? 1 : 0;
+    v.boolean = value;
+    v.text = value ? _T("true") : _T("false");
+}
+
+void Dictionary::setInt8(const DictionaryKey& key, int8_t value)
+{
+    setInteger(key, value);
+}
+
+void Dictionary::setInt16(const DictionaryKey& key, int16_t value)
+{
+    setInteger(key, value);
+}
+
+void Dictionary::setInt32(const DictionaryKey& key, int32_t value)
+{
+    setInteger(key, value);
+}
+
+void Dictionary::setInt64(const DictionaryKey& key, int64_t value)
+{
+    setInteger(key, value);
+}
+
+void Dictionary::setString(const DictionaryKey& key, const tchar* buf, size_t len)
+{
+    Value& v = insert(key);
+    v.text.assign(buf, len);
+    v.flags = 0;
+    v.integer = 0;
+    v.boolean = false;
+
+    if (parseInteger(buf, buf + len, v.integer))
+        v.flags |= HAS_INTEGER;
+    else
+        v.integer = 0;
+
+    if (parseBoolean(v.text, v.integer, 0 != (v.flags & HAS_INTEGER), v.boolean))
+        v.flags |= HAS_BOOLEAN;
 }
 
 void Dictionary::setBoolean(const tstring& key, bool value)
 {
-    _container[ key ] = toString(value);
+    setBoolean(DictionaryKey::intern(key), value);
 }
 
 void Dictionary::setInt8(const tstring& key, int8_t value)
 {
-    _container[ key ] = toString(value);
+    setInt8(DictionaryKey::intern(key), value);
 }
 
 void Dictionary::setInt16(const tstring& key, int16_t value)
 {
-    _container[ key ] = toString(value);
+    setInt16(DictionaryKey::intern(key), value);
 }
 
 void Dictionary::setInt32(const tstring& key, int32_t value)
 {
-    _container[ key ] = toString(value);
+    setInt32(DictionaryKey::intern(key), value);
 }
 
 void Dictionary::setInt64(const tstring& key, int64_t value)
 {
-    _container[ key ] = toString(value);
+    setInt64(DictionaryKey::intern(key), value);
 }
 
 void Dictionary::setString(const tstring& key, const tchar* buf, size_t len)
 {
-    _container[ key ] = tstring(buf, len);
+    setString(DictionaryKey::intern(key), buf, len);
 }
 
 void Dictionary::dump(tostream& target) const
 {
+    for (std::vector<Value>::const_iterator it = values_.begin(); it != values_.end(); ++ it)
+        target << it->key.name() << _T(" = ") << it->text << std::endl;
 }
 
-_jingxian_end
\ No newline at end of file
+_jingxian_end
@@ -0,0 +1,271 @@
+
+# include "pro_config.h"
+# include <hash_map>
+# include "jingxian/threading/semaphore.h"
+# include "jingxian/threading/thread.h"
+# include "jingxian/Dictionary.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    /**
+     * ԭʵ( hash_map<tstring, tstring>, ÿζȡ atoi ), ΪԱȵĻ׼
+     */
+    class StringDictionary
+    {
+    public:
+        bool has(const tstring& key) const
+        {
+            return container_.find(key) != container_.end();
+        }
+
+        int32_t getInt32(const tstring& key, int32_t defaultValue) const
+        {
+            stdext::hash_map<tstring, tstring>::const_iterator it = container_.find(key);
+            if (container_.end() == it)
+                return defaultValue;
+            return string_traits<tstring::value_type>::atoi(it->second.c_str());
+        }
+
+        const tstring& getString(const tstring& key, const tstring& defaultValue) const
+        {
+            stdext::hash_map<tstring, tstring>::const_iterator it = container_.find(key);
+            if (container_.end() == it)
+                return defaultValue;
+            return it->second;
+        }
+
+        void setInt32(const tstring& key, int32_t value)
+        {
+            container_[ key ] = ::toString(value);
+        }
+
+    private:
+        stdext::hash_map<tstring, tstring> container_;
+    };
+
+    template<typename T>
+    void fillDictionary(T& dict, tstring* keys, size_t count)
+    {
+        for (size_t i = 0; i < count; ++ i)
+        {
+            keys[i] = concat<tstring>(_T("jingxian.session.option"), ::toString((int)i));
+            dict.setInt32(keys[i], (int32_t)(i * 100));
+        }
+    }
+
+    void internKeys(const tstring* keys, DictionaryKey* handles, size_t count)
+    {
+        for (size_t i = 0; i < count; ++ i)
+            handles[i] = DictionaryKey::intern(keys[i]);
+    }
+
+    void setString(Dictionary& dict, const tstring& key, const tchar* value)
+    {
+        dict.setString(key, value, string_traits<tchar>::strlen(value));
+    }
+
+    /**
+     * ߳ͬʱǼͬһ
+     */
+    struct InternThreads
+    {
+        InternThreads()
+                : start(0, LONG_MAX)
+                , exited(0, LONG_MAX)
+        {
+            for (size_t i = 0; i < 1000; ++ i)
+                keys[i] = concat<tstring>(_T("dictionary.test.thread."), ::toString((int)i));
+        }
+
+        tstring keys[1000];
+        DictionaryKey handles[4][1000];
+        semaphore start;
+        semaphore exited;
+    };
+
+    void internThread(InternThreads* threads, size_t index)
+    {
+        threads->start.acquire();
+        internKeys(threads->keys, threads->handles[index], 1000);
+        threads->exited.release();
+    }
+}
+
+TEST(dictionary, typedValues)
+{
+    Dictionary dict;
+    setString(dict, _T("int"), _T(" -123 "));
+    setString(dict, _T("bad"), _T("12abc"));
+    setString(dict, _T("big"), _T("300"));
+    setString(dict, _T("huge"), _T("99999999999999999999"));
+    setString(dict, _T("yes"), _T("Yes"));
+    dict.setInt64(_T("int64"), (int64_t)1 << 40);
+    dict.setBoolean(_T("flag"), true);
+
+    ASSERT_TRUE(-123 == dict.getInt32(_T("int"), 7));
+    ASSERT_TRUE(-123 == dict.getInt8(_T("int"), 7));
+    ASSERT_TRUE(7 == dict.getInt32(_T("bad"), 7));
+    ASSERT_TRUE(_T("12abc") == dict.getString(_T("bad"), _T("")));
+    ASSERT_TRUE(7 == dict.getInt8(_T("big"), 7));
+    ASSERT_TRUE(300 == dict.getInt16(_T("big"), 7));
+    ASSERT_TRUE(7 == dict.getInt64(_T("huge"), 7));
+    ASSERT_TRUE(dict.getBoolean(_T("yes"), false));
+    ASSERT_TRUE(dict.getBoolean(_T("bad"), true));
+    ASSERT_TRUE(!dict.getBoolean(_T("bad"), false));
+    ASSERT_TRUE(((int64_t)1 << 40) == dict.getInt64(_T("int64"), 0));
+    ASSERT_TRUE(7 == dict.getInt32(_T("int64"), 7));
+    ASSERT_TRUE(dict.getBoolean(_T("flag"), false));
+    ASSERT_TRUE(1 == dict.getInt32(_T("flag"), 0));
+    ASSERT_TRUE(!dict.has(_T("dictionary.test.never.set")));
+    ASSERT_TRUE(!DictionaryKey::find(_T("dictionary.test.never.set")).isValid());
+
+    tstring keys[100];
+    DictionaryKey handles[100];
+    fillDictionary(dict, keys, 100);
+    internKeys(keys, handles, 100);
+    for (size_t i = 0; i < 100; ++ i)
+    {
+        ASSERT_TRUE(keys[i] == handles[i].name());
+        ASSERT_TRUE((int32_t)(i * 100) == dict.getInt32(handles[i], -1));
+    }
+    ASSERT_TRUE(107 == dict.size());
+}
+
+TEST(dictionary, internThreads)
+{
+    // ȡһ, ǼǴļȻЧ
+    DictionaryKey first = DictionaryKey::intern(_T("dictionary.test.first"));
+    const tstring& name = first.name();
+
+    std::auto_ptr<InternThreads> threads(new InternThreads());
+    for (size_t i = 0; i < 4; ++ i)
+        create_thread(&internThread, threads.get(), i, _T("intern"));
+    threads->start.release(4);
+    for (size_t i = 0; i < 4; ++ i)
+        threads->exited.acquire();
+
+    // ÿֻǼһ, ̵߳õľͬ
+    bool same = true;
+    for (size_t i = 0; i < 1000; ++ i)
+    {
+        for (size_t j = 1; j < 4; ++ j)
+        {
+            if (threads->handles[0][i] != threads->handles[j][i])
+                same = false;
+        }
+        if (threads->keys[i] != threads->handles[0][i].name())
+            same = false;
+    }
+    ASSERT_TRUE(same);
+    ASSERT_TRUE(_T("dictionary.test.first") == name);
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(Dictionary_getInt32)
+{
+    Dictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getInt32(keys[i & 31], -1));
+}
+
+BENCHMARK(Dictionary_getInt32_key)
+{
+    Dictionary dict;
+    tstring keys[32];
+    DictionaryKey handles[32];
+    fillDictionary(dict, keys, 32);
+    internKeys(keys, handles, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getInt32(handles[i & 31], -1));
+}
+
+BENCHMARK(Dictionary_getInt32_string_baseline)
+{
+    StringDictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getInt32(keys[i & 31], -1));
+}
+
+BENCHMARK(Dictionary_getString)
+{
+    Dictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getString(keys[i & 31], _T("")));
+}
+
+BENCHMARK(Dictionary_getString_key)
+{
+    Dictionary dict;
+    tstring keys[32];
+    DictionaryKey handles[32];
+    fillDictionary(dict, keys, 32);
+    internKeys(keys, handles, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getString(handles[i & 31], _T("")));
+}
+
+BENCHMARK(Dictionary_getString_string_baseline)
+{
+    StringDictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.getString(keys[i & 31], _T("")));
+}
+
+BENCHMARK(Dictionary_has_missing)
+{
+    Dictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+    tstring missing(_T("jingxian.session.missing"));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.has(missing));
+}
+
+BENCHMARK(Dictionary_has_missing_key)
+{
+    Dictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+    DictionaryKey missing = DictionaryKey::intern(_T("jingxian.session.missing"));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.has(missing));
+}
+
+BENCHMARK(Dictionary_has_missing_string_baseline)
+{
+    StringDictionary dict;
+    tstring keys[32];
+    fillDictionary(dict, keys, 32);
+    tstring missing(_T("jingxian.session.missing"));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(dict.has(missing));
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
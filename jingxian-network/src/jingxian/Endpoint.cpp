@@ -0,0 +1,327 @@
+
+# include "pro_config.h"
+# include <hash_map>
+# include "jingxian/Endpoint.h"
+# include "jingxian/networks/networking.h"
+
+_jingxian_begin
+
+namespace
+{
+    /**
+     * ЭĵǼǱ, Ŵ 1 ʼ, 0 ʾЧĵַ
+     */
+    class SchemeRegistry
+    {
+    public:
+        SchemeRegistry()
+        {
+            names_.push_back(tstring());
+            intern(_T("tcp"));
+            intern(_T("tls"));
+        }
+
+        uint32_t intern(const tstring& name)
+        {
+            stdext::hash_map<tstring, uint32_t>::const_iterator it = index_.find(name);
+            if (index_.end() != it)
+                return it->second;
+
+            uint32_t id = (uint32_t)names_.size();
+            names_.push_back(name);
+            index_[name] = id;
+            return id;
+        }
+
+        const tstring& name(uint32_t id) const
+        {
+            return (id < names_.size()) ? names_[id] : names_[0];
+        }
+
+    private:
+        stdext::hash_map<tstring, uint32_t> index_;
+        std::vector<tstring> names_;
+    };
+
+    SchemeRegistry& registry()
+    {
+        static SchemeRegistry instance;
+        return instance;
+    }
+
+    inline size_t hashBytes(size_t hash, const void* data, size_t len)
+    {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < len; ++ i)
+            hash = (hash ^ p[i]) * 16777619;
+        return hash;
+    }
+
+    /**
+     * ֵַ( Դ˿ )ת sockaddr, family Ϊ AF_UNSPEC ʱγ IPv4  IPv6
+     */
+    bool stringToSockaddr(const tchar* text, int family, SOCKADDR_STORAGE* addr, int* len)
+    {
+        tchar buf[256];
+        size_t n = string_traits<tchar>::strlen(text);
+        if (n >= sizeof(buf) / sizeof(buf[0]))
+            return false;
+        memcpy(buf, text, (n + 1) * sizeof(tchar));
+
+        int families[2] = { AF_INET, AF_INET6 };
+        if (AF_UNSPEC != family)
+            families[0] = families[1] = family;
+
+        for (int i = 0; i < 2; ++ i)
+        {
+            memset(addr, 0, sizeof(SOCKADDR_STORAGE));
+            *len = sizeof(SOCKADDR_STORAGE);
+            if (SOCKET_ERROR != ::WSAStringToAddress(buf, families[i], 0, (struct sockaddr*)addr, len))
+                return true;
+        }
+        return false;
+    }
+
+    bool parsePort(const tchar* begin, const tchar* end, uint16_t& port)
+    {
+        if (begin == end || end - begin > 5)
+            return false;
+
+        uint32_t value = 0;
+        for (; begin != end; ++ begin)
+        {
+            if (*begin < _T('0') || *begin > _T('9'))
+                return false;
+            value = value * 10 + (*begin - _T('0'));
+        }
+
+        if (value > 65535)
+            return false;
+        port = (uint16_t)value;
+        return true;
+    }
+}
+
+Endpoint::Endpoint()
+    : scheme_(0)
+    , addrLen_(0)
+    , port_(0)
+{
+    memset(&addr_, 0, sizeof(addr_));
+}
+
+Endpoint::Endpoint(uint32_t scheme, const struct sockaddr* addr, int len)
+    : scheme_(scheme)
+    , addrLen_(0)
+    , port_(0)
+{
+    assign(addr, len);
+}
+
+Endpoint::Endpoint(uint32_t scheme, const tstring& host, uint16_t port)
+    : scheme_(scheme)
+    , addrLen_(0)
+    , port_(port)
+{
+    memset(&addr_, 0, sizeof(addr_));
+
+    SOCKADDR_STORAGE addr;
+    int len = sizeof(addr);
+    if (isStream(scheme) && stringToSockaddr(host.c_str(), AF_UNSPEC, &addr, &len))
+    {
+        ((struct sockaddr_in*)&addr)->sin_port = htons(port);
+        assign((struct sockaddr*)&addr, len);
+        return;
+    }
+
+    host_ = isStream(scheme) ? to_lower<tstring>(host) : host;
+}
+
+void Endpoint::assign(const struct sockaddr* addr, int len)
+{
+    // ֻЧĲ, ֤ȽϺɢʱֽܶڵӰ
+    memset(&addr_, 0, sizeof(addr_));
+    if (AF_INET == addr->sa_family)
+        len = sizeof(struct sockaddr_in);
+    else if (AF_INET6 == addr->sa_family)
+        len = sizeof(struct sockaddr_in6);
+    else if (len > (int)sizeof(addr_))
+        len = sizeof(addr_);
+
+    memcpy(&addr_, addr, len);
+    addrLen_ = len;
+    port_ = ntohs(((const struct sockaddr_in*)addr)->sin_port);
+    host_.clear();
+}
+
+bool Endpoint::parse(const tchar* text, Endpoint& endpoint)
+{
+    const tchar* sep = string_traits<tchar>::strstr(text, _T("://"));
+    if (null_ptr == sep || sep == text || 0 == *(sep + 3))
+        return false;
+
+    tstring name = to_lower<tstring>(tstring(text, sep));
+    int family = AF_UNSPEC;
+    if (1 < name.size() && _T('6') == name[name.size() - 1])
+    {
+        family = AF_INET6;
+        name.resize(name.size() - 1);
+    }
+
+    uint32_t scheme = schemeId(name);
+    const tchar* address = sep + 3;
+
+    // ֻ tcp  tls ĵַ <addr>:<port> ʽ, Эĵַԭ
+    if (!isStream(scheme))
+    {
+        endpoint = Endpoint();
+        endpoint.scheme_ = scheme;
+        endpoint.host_ = address;
+        return true;
+    }
+
+    SOCKADDR_STORAGE addr;
+    int len = sizeof(addr);
+    if (stringToSockaddr(address, family, &addr, &len))
+    {
+        endpoint = Endpoint(scheme, (struct sockaddr*)&addr, len);
+        return true;
+    }
+
+    // , Ҫ DNS 
+    uint16_t port = 0;
+    const tchar* end = address + string_traits<tchar>::strlen(address);
+    const tchar* colon = string_traits<tchar>::strrchr(address, _T(':'));
+    if (null_ptr != colon)
+    {
+        if (!parsePort(colon + 1, end, port))
+            return false;
+        end = colon;
+    }
+
+    if (address == end)
+        return false;
+
+    endpoint = Endpoint();
+    endpoint.scheme_ = scheme;
+    endpoint.port_ = port;
+    endpoint.host_ = to_lower<tstring>(tstring(address, end));
+    return true;
+}
+
+uint32_t Endpoint::schemeId(const tstring& name)
+{
+    return registry().intern(to_lower<tstring>(name));
+}
+
+uint32_t Endpoint::tcp()
+{
+    //  SchemeRegistry Ĺ캯еһǼ
+    return 1;
+}
+
+uint32_t Endpoint::tls()
+{
+    return 2;
+}
+
+bool Endpoint::isStream(uint32_t scheme)
+{
+    return tcp() == scheme || tls() == scheme;
+}
+
+const tstring& Endpoint::schemeName() const
+{
+    return registry().name(scheme_);
+}
+
+tstring Endpoint::address() const
+{
+    if (isResolved())
+    {
+        tstring text;
+        if (!networking::addressToString((struct sockaddr*)&addr_, addrLen_, schemeName().c_str(), text))
+            return tstring();
+
+        return text.substr(text.find(_T("://")) + 3);
+    }
+
+    if (!isStream(scheme_) || 0 == port_)
+        return host_;
+
+    return concat<tstring>(host_, _T(":"), ::toString((int)port_));
+}
+
+tstring Endpoint::toString() const
+{
+    if (!isValid())
+        return tstring();
+
+    return concat<tstring>(schemeName()
+                           , (AF_INET6 == addr_.ss_family) ? _T("6://") : _T("://")
+                           , address());
+}
+
+size_t Endpoint::hash() const
+{
+    size_t hash = 2166136261U;
+    hash = hashBytes(hash, &scheme_, sizeof(scheme_));
+    hash = hashBytes(hash, &port_, sizeof(port_));
+    hash = hashBytes(hash, &addr_, addrLen_);
+    return hashBytes(hash, host_.c_str(), host_.size() * sizeof(tchar));
+}
+
+bool Endpoint::operator==(const Endpoint& other) const
+{
+    return scheme_ == other.scheme_
+           && addrLen_ == other.addrLen_
+           && port_ == other.port_
+           && 0 == memcmp(&addr_, &other.addr_, addrLen_)
+           && host_ == other.host_;
+}
+
+bool Endpoint::operator<(const Endpoint& other) const
+{
+    if (scheme_ != other.scheme_)
+        return scheme_ < other.scheme_;
+    if (addrLen_ != other.addrLen_)
+        return addrLen_ < other.addrLen_;
+    if (port_ != other.port_)
+        return port_ < other.port_;
+
+    int result = memcmp(&addr_, &other.addr_, addrLen_);
+    if (0 != result)
+        return result < 0;
+    return host_ < other.host_;
+}
+
+EndpointCache::EndpointCache()
+    : hits_(0)
+    , misses_(0)
+{
+}
+
+bool EndpointCache::parse(const tchar* text, Endpoint& endpoint)
+{
+    size_t hash = 2166136261U;
+    for (const tchar* p = text; 0 != *p; ++ p)
+        hash = (hash ^ (size_t)*p) * 16777619;
+
+    Entry& entry = entries_[hash % CACHE_SIZE];
+    if (entry.endpoint.isValid() && entry.text == text)
+    {
+        ++ hits_;
+        endpoint = entry.endpoint;
+        return true;
+    }
+
+    ++ misses_;
+    if (!Endpoint::parse(text, endpoint))
+        return false;
+
+    entry.text = text;
+    entry.endpoint = endpoint;
+    return true;
+}
+
+_jingxian_end
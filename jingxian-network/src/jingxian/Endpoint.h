@@ -0,0 +1,198 @@
+
+#ifndef _Endpoint_H_
+#define _Endpoint_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <Winsock2.h>
+# include "jingxian/string/string.h"
+
+_jingxian_begin
+
+/**
+ * õĵַ
+ *
+ * <schema>://<addr>:<port> ʽĵַֻһ, õЭźͶƵ
+ * sockaddr, ȽϺɢжڶƵʽϽ,  "TCP://127.0.0.1:80" 
+ * "tcp://127.0.0.1:0080" ͬһַ. ֵַʱ( Ҫ DNS  )
+ * Ͷ˿. schema һַ '6' ʱʾ IPv6 ʽ, 
+ * tcp6://[::1]:80,  tcp ͬһЭ.
+ */
+class Endpoint
+{
+public:
+    Endpoint();
+
+    /**
+     * ӶƵַ
+     */
+    Endpoint(uint32_t scheme, const struct sockaddr* addr, int len);
+
+    /**
+     * Ͷ˿ڴ, ֵַʱᱻתɶƵַ
+     */
+    Endpoint(uint32_t scheme, const tstring& host, uint16_t port);
+
+    /**
+     *  <schema>://<addr>:<port> ʽĵַ
+     * @return ʽȷʱ false
+     */
+    static bool parse(const tchar* text, Endpoint& endpoint);
+
+    /**
+     * ȡЭӦ( ЭִСд ), δǼǵЭᱻǼ
+     * @remarks Ǽǲ̰߳ȫ, Ӧ reactor ߳е
+     */
+    static uint32_t schemeId(const tstring& name);
+
+    /**
+     * tcp Э
+     */
+    static uint32_t tcp();
+
+    /**
+     * tls Э(  tcp ϼ )
+     */
+    static uint32_t tls();
+
+    /**
+     * ַǲ <addr>:<port> ʽ( tcp  tls )
+     */
+    static bool isStream(uint32_t scheme);
+
+    bool isValid() const
+    {
+        return 0 != scheme_;
+    }
+
+    /**
+     * ǷѾǶƵַ( Ҫ DNS  )
+     */
+    bool isResolved() const
+    {
+        return 0 != addrLen_;
+    }
+
+    uint32_t scheme() const
+    {
+        return scheme_;
+    }
+
+    const tstring& schemeName() const;
+
+    const struct sockaddr* addr() const
+    {
+        return (const struct sockaddr*)&addr_;
+    }
+
+    int addrLen() const
+    {
+        return addrLen_;
+    }
+
+    /**
+     * δ( isResolved() Ϊ true ʱΪ )
+     */
+    const tstring& host() const
+    {
+        return host_;
+    }
+
+    uint16_t port() const
+    {
+        return port_;
+    }
+
+    /**
+     * ȡòЭĵַ,  127.0.0.1:80
+     */
+    tstring address() const;
+
+    /**
+     * ȡù淶ĵַ,  tcp://127.0.0.1:80
+     */
+    tstring toString() const;
+
+    size_t hash() const;
+
+    bool operator==(const Endpoint& other) const;
+
+    bool operator!=(const Endpoint& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const Endpoint& other) const;
+
+private:
+    void assign(const struct sockaddr* addr, int len);
+
+    uint32_t scheme_;
+    int addrLen_;
+    uint16_t port_;
+    SOCKADDR_STORAGE addr_;
+    tstring host_;
+};
+
+inline size_t hash_value(const Endpoint& endpoint)
+{
+    return endpoint.hash();
+}
+
+inline tostream& operator<<(tostream& target, const Endpoint& endpoint)
+{
+    target << endpoint.toString();
+    return target;
+}
+
+/**
+ * ıַĻ
+ *
+ * ıɢֱֵӳ䵽̶ĿĲ, ʱֻҪһַȽ, 
+ * ʱ滻ԭĲ. ʽȷĵַᱻ. ̰߳ȫ.
+ */
+class EndpointCache
+{
+public:
+    EndpointCache();
+
+    /**
+     * ַ, ĵֱַӴӻȡ
+     * @return ʽȷʱ false
+     */
+    bool parse(const tchar* text, Endpoint& endpoint);
+
+    size_t hits() const
+    {
+        return hits_;
+    }
+
+    size_t misses() const
+    {
+        return misses_;
+    }
+
+private:
+    NOCOPY(EndpointCache);
+
+    enum { CACHE_SIZE = 64 };
+
+    struct Entry
+    {
+        tstring text;
+        Endpoint endpoint;
+    };
+
+    Entry entries_[CACHE_SIZE];
+    size_t hits_;
+    size_t misses_;
+};
+
+_jingxian_end
+
+#endif //_Endpoint_H_
@@ -0,0 +1,126 @@
+
+# include "pro_config.h"
+# include <hash_map>
+# include "jingxian/Endpoint.h"
+# include "jingxian/networks/networking.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+TEST(endpoint, parse)
+{
+    networking::initializeScket();
+
+    Endpoint a;
+    Endpoint b;
+    ASSERT_TRUE(Endpoint::parse(_T("tcp://127.0.0.1:80"), a));
+    ASSERT_TRUE(Endpoint::parse(_T("TCP://127.0.0.1:80"), b));
+    ASSERT_TRUE(a.isResolved());
+    ASSERT_TRUE(Endpoint::tcp() == a.scheme());
+    ASSERT_TRUE(80 == a.port());
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(a.hash() == b.hash());
+    ASSERT_TRUE(_T("tcp://127.0.0.1:80") == a.toString());
+    ASSERT_TRUE(_T("127.0.0.1:80") == a.address());
+
+    ASSERT_TRUE(Endpoint::parse(_T("tcp://127.0.0.1:81"), b));
+    ASSERT_TRUE(a != b);
+    ASSERT_TRUE(a < b || b < a);
+
+    ASSERT_TRUE(Endpoint::parse(_T("tcp6://[::1]:80"), b));
+    ASSERT_TRUE(b.isResolved());
+    ASSERT_TRUE(Endpoint::tcp() == b.scheme());
+    ASSERT_TRUE(_T("tcp6://[::1]:80") == b.toString());
+
+    ASSERT_TRUE(Endpoint::parse(_T("tcp://WWW.Example.com:8080"), b));
+    ASSERT_TRUE(!b.isResolved());
+    ASSERT_TRUE(_T("www.example.com") == b.host());
+    ASSERT_TRUE(8080 == b.port());
+    ASSERT_TRUE(b == Endpoint(Endpoint::tcp(), _T("www.example.com"), 8080));
+    ASSERT_TRUE(a == Endpoint(Endpoint::tcp(), _T("127.0.0.1"), 80));
+
+    ASSERT_TRUE(!Endpoint::parse(_T("127.0.0.1:80"), b));
+    ASSERT_TRUE(!Endpoint::parse(_T("tcp://"), b));
+    ASSERT_TRUE(!Endpoint::parse(_T("tcp://www.example.com:http"), b));
+    ASSERT_TRUE(!Endpoint::parse(_T("tcp://www.example.com:65536"), b));
+
+    ASSERT_TRUE(Endpoint::parse(_T("tls://127.0.0.1:443"), b));
+    ASSERT_TRUE(Endpoint::tls() == b.scheme());
+    ASSERT_TRUE(b.isResolved());
+    ASSERT_TRUE(_T("127.0.0.1:443") == b.address());
+
+    ASSERT_TRUE(Endpoint::parse(_T("pipe://c:\\bin\\a.exe"), b));
+    ASSERT_TRUE(Endpoint::tcp() != b.scheme());
+    ASSERT_TRUE(_T("pipe") == b.schemeName());
+    ASSERT_TRUE(_T("c:\\bin\\a.exe") == b.address());
+
+    EndpointCache cache;
+    ASSERT_TRUE(cache.parse(_T("tcp://127.0.0.1:80"), b));
+    ASSERT_TRUE(cache.parse(_T("tcp://127.0.0.1:80"), b));
+    ASSERT_TRUE(!cache.parse(_T("tcp://"), b));
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(1 == cache.hits());
+    ASSERT_TRUE(2 == cache.misses());
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(Endpoint_lookup_string_baseline)
+{
+    // ԭ: ÿζֵַ, תСд hash_map вЭ
+    networking::initializeScket();
+    stdext::hash_map<tstring, int> schemes;
+    schemes[_T("tcp")] = 1;
+    const tchar* text = _T("tcp://192.168.1.10:8080");
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        StringArray<tchar> sa = split_with_string(text, _T("://"));
+        DO_NOT_OPTIMIZE(schemes.find(to_lower<tstring>(sa.ptr(0))));
+    }
+}
+
+BENCHMARK(Endpoint_parse)
+{
+    networking::initializeScket();
+    const tchar* text = _T("tcp://192.168.1.10:8080");
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        Endpoint endpoint;
+        DO_NOT_OPTIMIZE(Endpoint::parse(text, endpoint));
+    }
+}
+
+BENCHMARK(Endpoint_parse_cached)
+{
+    networking::initializeScket();
+    EndpointCache cache;
+    const tchar* text = _T("tcp://192.168.1.10:8080");
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        Endpoint endpoint;
+        DO_NOT_OPTIMIZE(cache.parse(text, endpoint));
+    }
+}
+
+BENCHMARK(Endpoint_hash_lookup)
+{
+    networking::initializeScket();
+    stdext::hash_map<Endpoint, int> ports;
+    Endpoint endpoint;
+    Endpoint::parse(_T("tcp://192.168.1.10:8080"), endpoint);
+    ports[endpoint] = 1;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(ports.find(endpoint));
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
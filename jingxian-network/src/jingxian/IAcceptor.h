@@ -41,6 +41,7 @@ public:
 
     /**
      * һ
+     * ӱ׼ƾܾʱ,  on_complete  transport Ϊ null_ptr
      */
     virtual void accept(OnBuildConnectionComplete on_complete
                         , OnBuildConnectionError on_error
@@ -12,6 +12,7 @@
 # include "jingxian/string/string.h"
 # include "jingxian/exception.h"
 # include "jingxian/ITransport.h"
+# include "jingxian/Endpoint.h"
 
 _jingxian_begin
 
@@ -36,6 +37,17 @@ public:
                          , OnBuildConnectionError onError
                          , void* context) = 0;
 
+    /**
+     * һ, ַѾ, Ĭתַķ
+     */
+    virtual void connect(const Endpoint& endPoint
+                         , OnBuildConnectionComplete onComplete
+                         , OnBuildConnectionError onError
+                         , void* context)
+    {
+        connect(endPoint.toString().c_str(), onComplete, onError, context);
+    }
+
     /**
      * ȡõַ
      */
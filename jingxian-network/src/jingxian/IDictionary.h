@@ -13,11 +13,89 @@
 
 _jingxian_begin
 
+/**
+ * ֵļ
+ *
+ * ֻ intern ʱǼһ, õһźԤõɢֵ, Ժþ
+ * ʱҪٶַɢкͱȽ. Ч, Ա
+ * Э鹤ȶзʹ. עǼǲ̰߳ȫ, Ӧڳʼ׶.
+ */
+class DictionaryKey
+{
+public:
+    DictionaryKey()
+        : id_(0)
+        , hash_(0)
+    {
+    }
+
+    /**
+     * Ǽһ, ѾǼǹʱԭľ
+     */
+    static DictionaryKey intern(const tstring& name);
+
+    /**
+     * һѵǼǵļ, ûеǼǹʱЧľ
+     */
+    static DictionaryKey find(const tstring& name);
+
+    bool isValid() const
+    {
+        return 0 != id_;
+    }
+
+    uint32_t id() const
+    {
+        return id_;
+    }
+
+    uint32_t hash() const
+    {
+        return hash_;
+    }
+
+    const tstring& name() const;
+
+    bool operator==(const DictionaryKey& other) const
+    {
+        return id_ == other.id_;
+    }
+
+    bool operator!=(const DictionaryKey& other) const
+    {
+        return id_ != other.id_;
+    }
+
+private:
+    explicit DictionaryKey(uint32_t id)
+        : id_(id)
+        , hash_(id * 2654435761U)
+    {
+    }
+
+    uint32_t id_;
+    uint32_t hash_;
+};
+
 class IDictionary
 {
 public:
     virtual ~IDictionary(void) {}
 
+    virtual bool has(const DictionaryKey& key) const = 0;
+
+    virtual bool getBoolean(const DictionaryKey& key, bool defaultValue = 0) const = 0;
+
+    virtual int8_t getInt8(const DictionaryKey& key, int8_t defaultValue = 0) const = 0;
+
+    virtual int16_t getInt16(const DictionaryKey& key, int16_t defaultValue = 0) const = 0;
+
+    virtual int32_t getInt32(const DictionaryKey& key, int32_t defaultValue = 0) const = 0;
+
+    virtual int64_t getInt64(const DictionaryKey& key, int64_t defaultValue = 0) const = 0;
+
+    virtual const tstring& getString(const DictionaryKey& key, const tstring& defaultValue = _T("")) const = 0;
+
     virtual bool has(const tstring& key) const = 0;
 
     virtual bool getBoolean(const tstring& key, bool defaultValue = 0) const = 0;
@@ -44,6 +122,18 @@ public:
 
     virtual void setString(const tstring& key, const tchar* buf, size_t len) = 0;
 
+    virtual void setBoolean(const DictionaryKey& key, bool value) = 0;
+
+    virtual void setInt8(const DictionaryKey& key, int8_t value) = 0;
+
+    virtual void setInt16(const DictionaryKey& key, int16_t value) = 0;
+
+    virtual void setInt32(const DictionaryKey& key, int32_t value) = 0;
+
+    virtual void setInt64(const DictionaryKey& key, int64_t value) = 0;
+
+    virtual void setString(const DictionaryKey& key, const tchar* buf, size_t len) = 0;
+
     virtual void dump(tostream& target) const = 0;
 };
 
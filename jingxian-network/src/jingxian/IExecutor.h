@@ -0,0 +1,75 @@
+
+#ifndef _IExecutor_H_
+#define _IExecutor_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/string/string.h"
+# include "jingxian/IRunnable.h"
+# include "jingxian/IConcurrentPort.h"
+
+_jingxian_begin
+
+/**
+ * ̳߳صͳ
+ */
+struct ExecutorStats
+{
+    /// ύûпʼִе(  )
+    volatile LONG pending;
+    /// Ѿִ
+    volatile LONG executed;
+    /// ̵߳Ķ͵ȡ
+    volatile LONG steals;
+};
+
+/**
+ * ִмܼ̳߳ؽӿ
+ *
+ * ɶ˿ڵֻ߳Ӧ IO, ֤ʱĹϣ, ѹݼȺʱĹ
+ * Ӧýӿڹִ߳, ִٽĴصڵ
+ * ߳.
+ */
+class IExecutor
+{
+public:
+
+    virtual ~IExecutor() {}
+
+    /**
+     * ڹִ߳ work, ɺ continuation ͨ port  send 
+     *  port ڵִ߳
+     *
+     * @param[ in ] work ڹִ߳еķ, ִкɾ
+     * @param[ in ] port ִ continuation ߳, һڵ IReactorCore
+     * @param[ in ] continuation Ĵ, Ϊ null_ptr
+     * @return ̳߳ûʱ false, ʱ work  continuation ɵ
+     * ߸ɾ
+     */
+    virtual bool execute(IRunnable* work, IConcurrentPort* port, IRunnable* continuation) = 0;
+
+    /**
+     * ȡͳ
+     */
+    virtual const ExecutorStats& stats() const = 0;
+
+    /**
+    * ȡõַ
+    */
+    virtual const tstring& toString() const = 0;
+};
+
+inline tostream& operator<<(tostream& target, const IExecutor& executor)
+{
+    target << executor.toString();
+    return target;
+}
+
+_jingxian_end
+
+#endif // _IExecutor_H_
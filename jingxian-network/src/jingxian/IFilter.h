@@ -0,0 +1,96 @@
+
+#ifndef _IFilter_H_
+#define _IFilter_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/string/string.h"
+
+_jingxian_begin
+
+namespace FilterMode
+{
+enum type
+{
+    /// л, ȴչһ
+    normal,
+    /// л
+    flush,
+    /// Ӽر, ݺĽβ
+    finished
+};
+}
+
+/**
+ * ϵһݴ׶, ѹ
+ *
+ *  ConnectedSocket  IProtocol ֮, յ decode, 
+ *  encode. ʽ, ɹԼ.
+ */
+class IFilter
+{
+public:
+
+    virtual ~IFilter() {}
+
+    /**
+     * תյ
+     *
+     * @param[ in ] data ²յ
+     * @param[ in ] len ݵĳ
+     * @param[ out ] consumed õֽ, ʱ len,
+     *                        ȡʣµٴε
+     * @param[ out ] output ת׷ں
+     * @return ݸʽʱ false
+     */
+    virtual bool decode(const char* data
+                        , size_t len
+                        , size_t& consumed
+                        , std::vector<char>& output) = 0;
+
+    /**
+     * תҪ, ȫõ
+     *
+     * @param[ in ] data ϲд, Ϊ
+     * @param[ in ] len ݵĳ
+     * @param[ in ] mode ǷҪ
+     * @param[ out ] output ת׷ں
+     * @return ʱ false
+     */
+    virtual bool encode(const char* data
+                        , size_t len
+                        , FilterMode::type mode
+                        , std::vector<char>& output) = 0;
+
+    /**
+     * ȡù
+     */
+    virtual const tstring& toString() const = 0;
+};
+
+class IFilterFactory
+{
+public:
+
+    virtual ~IFilterFactory() {}
+
+    /**
+     * ΪһӴ
+     */
+    virtual IFilter* createFilter() = 0;
+
+    /**
+     * ȡù
+     */
+    virtual const tstring& toString() const = 0;
+};
+
+_jingxian_end
+
+#endif // _IFilter_H_
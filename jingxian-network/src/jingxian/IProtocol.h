@@ -64,6 +64,15 @@ public:
     */
     virtual databuffer_t* createBuffer(const ProtocolContext& context) = 0;
 
+    /**
+     * ЭԼռõֽ, ռõڴ, ڴ泬Ԥʱ
+     * ݴѡҪϿ
+     */
+    virtual size_t memory() const
+    {
+        return 0;
+    }
+
     /**
      * ȡõַ
      */
@@ -17,9 +17,13 @@
 # include "jingxian/IAcceptor.h"
 # include "jingxian/ProtocolContext.h"
 # include "jingxian/IDNSResolver.h"
+# include "jingxian/IExecutor.h"
 
 _jingxian_begin
 
+class TimerQueue;
+class CoroutineScheduler;
+
 class IReactorCore : public IConcurrentPort
 {
 public:
@@ -48,6 +52,21 @@ public:
     */
     virtual bool listenWith(const tchar* endPoint, IProtocolFactory* protocolFactory) = 0;
 
+    /**
+    * һ, ַѾ, Ҫַ
+    * @see connectWith
+    */
+    virtual void connectWith(const Endpoint& endPoint
+                             , OnBuildConnectionComplete onComplete
+                             , OnBuildConnectionError onError
+                             , void* context) = 0;
+
+    /**
+    * һ, ַѾ
+    * @see listenWith
+    */
+    virtual bool listenWith(const Endpoint& endPoint, IProtocolFactory* protocolFactory) = 0;
+
     /**
      * ʼֱInterruptŷ
      */
@@ -72,6 +91,25 @@ public:
      * ȡ dns ӿ
      */
     virtual IDNSResolver& resolver() = 0;
+
+    /**
+     * ȡִмܼ̳߳
+     */
+    virtual IExecutor& executor() = 0;
+
+    /**
+     * ȡ¼ѭ߳еĶʱ( ֻ¼ѭ߳ʹ )
+     *
+     * ƬʱڷƬĶʱ
+     */
+    virtual TimerQueue& timers() = 0;
+
+    /**
+     * ȡ¼ѭ߳еЭ̵( ֻ¼ѭ߳ʹ )
+     *
+     * ƬʱڷƬĵ
+     */
+    virtual CoroutineScheduler& coroutines() = 0;
 };
 
 _jingxian_end
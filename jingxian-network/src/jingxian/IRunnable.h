@@ -10,13 +10,14 @@
 
 // Include files
 # include "jingxian/string/string.h"
+# include "jingxian/threading/mpsc_queue.h"
 
 _jingxian_begin
 
 /**
- * ӿ
+ * ӿ,  mpsc_node ̳Ϊֱӷ IReactorCore 
  */
-class IRunnable
+class IRunnable : public mpsc_node
 {
 public:
     virtual ~IRunnable() {}
@@ -56,7 +56,14 @@ public:
     virtual void writeBatch(buffer_chain_t** buffers, size_t len) = 0;
 
     /**
-     * ر
+     * ͬʱû, ûΪûʱ
+     * @param[ in ] user û
+     * @param[ in ] upload ûϴ, Ƿû
+     */
+    virtual void shapeAs(const tstring& user, bool upload) = 0;
+
+    /**
+     * ر, ѾдݷϺϿ
      */
     virtual void disconnection() = 0;
 
@@ -30,6 +30,32 @@ public:
     virtual int64_t readInt64() = 0;
     virtual void readBlob(void* blob, size_t len) = 0;
 
+    /**
+     * ָֽ, BE Ϊ( ֽ ), LE ΪС
+     */
+    virtual uint16_t readUInt16BE() = 0;
+    virtual uint16_t readUInt16LE() = 0;
+    virtual uint32_t readUInt32BE() = 0;
+    virtual uint32_t readUInt32LE() = 0;
+    virtual uint64_t readUInt64BE() = 0;
+    virtual uint64_t readUInt64LE() = 0;
+
+    /**
+     *  LEB128 ı䳤, 볬ʱ ERROR_INVALID_DATA 
+     */
+    virtual uint32_t readVarUInt32() = 0;
+    virtual uint64_t readVarUInt64() = 0;
+
+    /**
+     *  count  values , ֱӴӸڴ鸴ƵĿ
+     */
+    virtual void readInt16Array(int16_t* values, size_t count) = 0;
+    virtual void readInt32Array(int32_t* values, size_t count) = 0;
+    virtual void readInt64Array(int64_t* values, size_t count) = 0;
+    virtual void readUInt16ArrayBE(uint16_t* values, size_t count) = 0;
+    virtual void readUInt32ArrayBE(uint32_t* values, size_t count) = 0;
+    virtual void readUInt64ArrayBE(uint64_t* values, size_t count) = 0;
+
     /**
      * ǰoffestֽ
      * @params[ int ] λƶֽ
@@ -37,6 +63,12 @@ public:
      */
     virtual void seek(int offest) = 0;
 
+    /**
+     * ȡõǰڴδ( , Ҳƶλ )
+     * @params[ out ] len ݵĳ
+     */
+    virtual const char* peek(size_t& len) = 0;
+
     /**
      *  Buffer еݵĳ
      */
@@ -29,6 +29,22 @@ public:
     virtual IOutBuffer& writeInt32(int32_t value) = 0;
     virtual IOutBuffer& writeInt64(const int64_t& value) = 0;
     virtual IOutBuffer& writeBlob(const void* blob, size_t len) = 0;
+
+    /**
+     * ָֽд, BE Ϊ( ֽ ), LE ΪС
+     */
+    virtual IOutBuffer& writeUInt16BE(uint16_t value) = 0;
+    virtual IOutBuffer& writeUInt16LE(uint16_t value) = 0;
+    virtual IOutBuffer& writeUInt32BE(uint32_t value) = 0;
+    virtual IOutBuffer& writeUInt32LE(uint32_t value) = 0;
+    virtual IOutBuffer& writeUInt64BE(const uint64_t& value) = 0;
+    virtual IOutBuffer& writeUInt64LE(const uint64_t& value) = 0;
+
+    /**
+     *  LEB128 д䳤
+     */
+    virtual IOutBuffer& writeVarUInt32(uint32_t value) = 0;
+    virtual IOutBuffer& writeVarUInt64(const uint64_t& value) = 0;
 };
 
 _jingxian_end
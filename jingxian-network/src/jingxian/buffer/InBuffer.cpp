@@ -1,5 +1,6 @@
 # include "pro_config.h"
 # include "jingxian/Buffer/InBuffer.h"
+# include "jingxian/Buffer/memsearch.h"
 # ifdef _GOOGLETEST_
 # include <gtest/gtest.h>
 # else
@@ -73,39 +74,6 @@ void InBuffer::reset(const std::vector<io_mem_buf>* iobuf, size_t totalLength)
     currentLength_ = (*memory_)[current_].len;
 }
 
-bool InBuffer::readBoolean()
-{
-    return 0 != readInt8();
-}
-
-int8_t InBuffer::readInt8()
-{
-    int8_t value = 0;
-    readBlob((char*)&value, sizeof(value));
-    return value;
-}
-
-int16_t InBuffer::readInt16()
-{
-    int16_t value = 0;
-    readBlob((char*)&value, sizeof(value));
-    return value;
-}
-
-int32_t InBuffer::readInt32()
-{
-    int32_t value = 0;
-    readBlob((char*)&value, sizeof(value));
-    return value;
-}
-
-int64_t InBuffer::readInt64()
-{
-    int64_t value = 0;
-    readBlob((char*)&value, sizeof(value));
-    return value;
-}
-
 void InBuffer::readBlob(void* blob, size_t len)
 {
     if (ERROR_SUCCESS != this->error())
@@ -161,6 +129,71 @@ void InBuffer::readBlob(void* blob, size_t len)
     readLength_ += len;
 }
 
+uint64_t InBuffer::readVarUIntSlow(size_t maxBytes, unsigned char lastMax)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < maxBytes; ++ i)
+    {
+        uint8_t byte = readFixed<uint8_t>();
+        if (ERROR_SUCCESS != this->error())
+            return 0;
+        if (i + 1 == maxBytes && byte > lastMax)
+            break;
+
+        value |= ((uint64_t)(byte & 0x7f)) << (7 * i);
+        if (0 == (byte & 0x80))
+            return value;
+    }
+
+    this->error(ERROR_INVALID_DATA);
+    return 0;
+}
+
+void InBuffer::readInt16Array(int16_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(int16_t));
+}
+
+void InBuffer::readInt32Array(int32_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(int32_t));
+}
+
+void InBuffer::readInt64Array(int64_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(int64_t));
+}
+
+template<typename T>
+inline void fromBigEndianArray(T* values, size_t count)
+{
+#ifndef JINGXIAN_BIG_ENDIAN
+    for (size_t i = 0; i < count; ++ i)
+        values[i] = byteorder::byteSwap(values[i]);
+#endif
+}
+
+void InBuffer::readUInt16ArrayBE(uint16_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(uint16_t));
+    if (ERROR_SUCCESS == this->error())
+        fromBigEndianArray(values, count);
+}
+
+void InBuffer::readUInt32ArrayBE(uint32_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(uint32_t));
+    if (ERROR_SUCCESS == this->error())
+        fromBigEndianArray(values, count);
+}
+
+void InBuffer::readUInt64ArrayBE(uint64_t* values, size_t count)
+{
+    readBlob(values, count * sizeof(uint64_t));
+    if (ERROR_SUCCESS == this->error())
+        fromBigEndianArray(values, count);
+}
+
 void InBuffer::seek(int offestLen)
 {
     if (0 == offestLen)
@@ -179,6 +212,15 @@ void InBuffer::seek(int offestLen)
             return;
         }
 
+        if (offest < currentLength_)
+        {
+            currentPtr_ += offest;
+            currentLength_ -= offest;
+            readLength_ += offest;
+            return;
+        }
+
+        // Ҫںڴֽ
         size_t len = offest - currentLength_;
         for (size_t i = current_ + 1; i < (*memory_).size(); ++i)
         {
@@ -190,7 +232,7 @@ void InBuffer::seek(int offestLen)
                 readLength_ += offest;
                 return;
             }
-            len += (*memory_)[i].len;
+            len -= (*memory_)[i].len;
         }
         currentPtr_ = null_ptr;
         currentLength_ = 0;
@@ -218,18 +260,30 @@ void InBuffer::seek(int offestLen)
         return;
     }
 
-    size_t len = offest - ((*memory_)[current_].len - currentLength_);
-    for (size_t i = current_ - 1; i >= 0 ; --i)
+    // ڵǰڴк
+    size_t currentRead = (current_ < (*memory_).size()) ? ((*memory_)[current_].len - currentLength_) : 0;
+    if (offest <= currentRead)
+    {
+        currentPtr_ -= offest;
+        currentLength_ += offest;
+        readLength_ -= offest;
+        return;
+    }
+
+    // Ҫǰڴк˵ֽ
+    size_t len = offest - currentRead;
+    for (size_t i = current_; i > 0; --i)
     {
-        if (len < (*memory_)[i].len)
+        const io_mem_buf& buf = (*memory_)[i - 1];
+        if (len <= buf.len)
         {
-            current_ = i;
-            currentPtr_ = (*memory_)[i].buf + ((*memory_)[i].len - len);
+            current_ = i - 1;
+            currentPtr_ = buf.buf + (buf.len - len);
             currentLength_ = len;
             readLength_ -= offest;
             return;
         }
-        len += (*memory_)[i].len;
+        len -= buf.len;
     }
 
     current_ = 0;
@@ -258,19 +312,16 @@ size_t InBuffer::size() const
 
 size_t InBuffer::search(char ch) const
 {
-    char* p = (char*)::memchr(currentPtr_, ch, currentLength_);
-    if (!is_null(p))
-        return p - currentPtr_;
+    size_t index = memsearch::find(currentPtr_, currentLength_, ch);
+    if (memsearch::npos != index)
+        return index;
 
     size_t len  = currentLength_;
     for (size_t i = current_ + 1; i < (*memory_).size(); ++i)
     {
-        p = (char*)::memchr((*memory_)[i].buf, ch, (*memory_)[i].len);
-        if (!is_null(p))
-        {
-            len += (p - (*memory_)[i].buf);
-            return len;
-        }
+        index = memsearch::find((*memory_)[i].buf, (*memory_)[i].len, ch);
+        if (memsearch::npos != index)
+            return len + index;
 
         len += (*memory_)[i].len;
     }
@@ -283,14 +334,35 @@ size_t InBuffer::search(wchar_t ch) const
     return search(&ch, sizeof(ch));
 }
 
-inline size_t mem_search(const void* mem, size_t searchLen, const void* context, size_t len)
+/**
+ * Ƚϴӵ index ڴ ptr ( ÿ黹ʣ count ֽ )ʼ
+ *  context ͬ, ݿԿԽڴ.
+ */
+inline bool matchAcross(const std::vector<io_mem_buf>& memory
+                        , size_t index
+                        , const char* ptr
+                        , size_t count
+                        , const char* context
+                        , size_t len)
 {
-    for (size_t i = 0; i < searchLen; ++i)
+    do
     {
-        if (!is_null(::memcmp(mem, context, len)))
-            return i;
+        size_t cmpLen = (count < len) ? count : len;
+        if (0 != ::memcmp(ptr, context, cmpLen))
+            return false;
+
+        context += cmpLen;
+        len -= cmpLen;
+        if (0 == len)
+            return true;
+
+        if (memory.size() <= ++index)
+            return false;
+
+        ptr = memory[index].buf;
+        count = memory[index].len;
     }
-    return buffer_type::npos;
+    while (true);
 }
 
 size_t InBuffer::search(const void* context, size_t len) const
@@ -305,95 +377,50 @@ size_t InBuffer::search(const void* context, size_t len) const
     // 1.ַһڴ, {"aaaacccc", "sdfsafdddsss" } ַ"ddd"ڵڶ
     // 2.ַڵڴ, {"aaaacccc", "sdfsafdddsss" } ַ"ccsd"ڶ
     // 3.ַڵĶڴ, {"aaaacccc","sa" "sdfsafdddsss" } ַ"ccsasd"
+    //
+    // ÿڴȲڿڵƥ, ٶԿβ len-1 ֽֽͬ
+    // λ, ֱӿαȽ, Ҫ.
 
-    // tmpbuf һڴlen-1ַһڴǰlen-1ַ,
-    std::vector<char> tmpbuf(4*len);
-    // tmpbuf Чַĳ.
-    size_t tmpLen = 0;
-    // "&tmpBuf[0]"Ĵ
-    char* tmpPtr = &tmpbuf[0];
-
-
-    // Ҫʵһڴ
-    size_t i = current_ + 1;
-    // Ѳҹڴܳ
-    size_t seekLen = 0;
+    const char* target = (const char*)context;
 
     // ǰڴڴ
+    size_t index = current_;
     const char* ptr = currentPtr_;
-    // ǰڴڴĴС
     size_t count = currentLength_;
+    // Ѳҹڴܳ
+    size_t seekLen = 0;
 
     do
     {
-
-        size_t searchLen = 0;
-        if (count > len)
+        size_t start = 0;
+        if (count >= len)
         {
-            // ֮ǰʵڴĽβַ(עпǶڴݼ˵ĵ3),
-            // ڽҪڴͷַ
-            if (tmpLen > 0)
-            {
-                size_t copy = len - 1;
-
-                if (0 != ::memcpy_s(tmpPtr + tmpLen, tmpbuf.size() - tmpLen, ptr, copy))
-                    ThrowException(RuntimeException);
+            size_t pos = memsearch::find(ptr, count, target, len);
+            if (memsearch::npos != pos)
+                return seekLen + pos;
 
-                searchLen = tmpLen;
-                size_t index = mem_search(tmpPtr, searchLen, context, len);
-                if (buffer_type::npos != index)
-                {
-                    seekLen += index;
-                    return seekLen;
-                }
-
-                seekLen += tmpLen;
-                tmpLen = 0;
-            }
-
-            // 㵱ǰڴҪĳ,ǰڴ,
-            searchLen = (count - len + 1);
-            size_t index = mem_search(ptr, searchLen, context, len);
-            if (buffer_type::npos != index)
-            {
-                seekLen += index;
-                return seekLen;
-            }
+            start = count - len + 1;
         }
 
-        // ĳ,εڴ鳤СĿĳ,searchLentmpLenΪ0.
-        if (0 == ::memcpy_s(tmpPtr + tmpLen, tmpbuf.size() - tmpLen, ptr + searchLen, count - searchLen))
-            ThrowException(RuntimeException);
-        seekLen += searchLen;
-        tmpLen += (count - searchLen);
-
-        // ڴСlen, ܳȴ len,
-        // Ŀ곤lenΪ3, 60 ڴĳΪ2,ʱͻᵼ tmpPtr
-        // ָڴ治.
-        if (tmpLen > len)
+        // ܿԽڴ߽ĺѡλ
+        while (start < count)
         {
-            // 㵱ǰڴҪĳ,ǰڴ,
-            searchLen = (tmpLen - len + 1);
-            size_t index = mem_search(tmpPtr, searchLen, context, len);
-            if (buffer_type::npos != index)
-            {
-                seekLen += index;
-                return seekLen;
-            }
-
-            if (0 == ::memmove_s(tmpPtr, tmpbuf.size(), tmpPtr + searchLen, tmpLen - searchLen))
-                ThrowException(RuntimeException);
-
-            tmpLen  -= searchLen;
-            seekLen += searchLen;
+            const char* p = (const char*)::memchr(ptr + start, target[0], count - start);
+            if (is_null(p))
+                break;
+
+            start = p - ptr;
+            if (matchAcross(*memory_, index, p, count - start, target, len))
+                return seekLen + start;
+            ++ start;
         }
 
-        if ((*memory_).size() <= i)
+        seekLen += count;
+        if ((*memory_).size() <= ++index)
             return buffer_type::npos;
 
-        ptr = (*memory_)[i].buf;
-        count = (*memory_)[i].len;
-        ++i;
+        ptr = (*memory_)[index].buf;
+        count = (*memory_)[index].len;
     }
     while (true);
     return buffer_type::npos;
@@ -405,29 +432,24 @@ size_t InBuffer::searchAny(const char* charset) const
         return buffer_type::npos;
 
     size_t charsetLen = string_traits<char>::strlen(charset);
+    if (0 == charsetLen)
+        return buffer_type::npos;
     if (1 == charsetLen)
         return search(*charset);
 
-    for (size_t i = 0; i < currentLength_; ++i)
-    {
-        if (!is_null(::memchr(charset, currentPtr_[i], charsetLen)))
-            return i;
-    }
+    memsearch::charset_bitmap bitmap(charset, charsetLen);
+
+    size_t index = memsearch::find_any(currentPtr_, currentLength_, bitmap);
+    if (memsearch::npos != index)
+        return index;
 
     size_t len  = currentLength_;
     for (size_t i = current_ + 1; i < (*memory_).size(); ++i)
     {
-        const char* ptr = (*memory_)[i].buf;
-        int count = (*memory_)[i].len;
+        index = memsearch::find_any((*memory_)[i].buf, (*memory_)[i].len, bitmap);
+        if (memsearch::npos != index)
+            return len + index;
 
-        for (int j = 0; j < count; ++j)
-        {
-            if (!is_null(::memchr(charset, ptr[j], charsetLen)))
-            {
-                len += j;
-                return len;
-            }
-        }
         len += (*memory_)[i].len;
     }
     return buffer_type::npos;
@@ -449,10 +471,133 @@ size_t InBuffer::rawLength() const
 }
 
 
+namespace
+{
+    void toMemBuf(std::vector<io_mem_buf>& memory, char** segments, size_t count)
+    {
+        for (size_t i = 0; i < count; ++ i)
+        {
+            io_mem_buf buf;
+            buf.buf = segments[i];
+            buf.len = (u_long)strlen(segments[i]);
+            memory.push_back(buf);
+        }
+    }
+
+    void addMemBuf(std::vector<io_mem_buf>& memory, unsigned char* ptr, size_t len)
+    {
+        io_mem_buf buf;
+        buf.buf = (char*)ptr;
+        buf.len = (u_long)len;
+        memory.push_back(buf);
+    }
+}
+
 TEST(buffer, bufferSearch)
 {
-    //TODO: д
+    char seg1[] = "aaaacccc";
+    char seg2[] = "sa";
+    char seg3[] = "sdfsafdddsss";
+
+    {
+        char* segments[] = { seg1, seg3 };
+        std::vector<io_mem_buf> memory;
+        toMemBuf(memory, segments, 2);
+        InBuffer buffer(&memory, 20);
+
+        ASSERT_TRUE(14 == buffer.search("ddd", 3));
+        ASSERT_TRUE(6 == buffer.search("ccsd", 4));
+        ASSERT_TRUE(buffer_type::npos == buffer.search("ccsa", 4));
+        ASSERT_TRUE(buffer_type::npos == buffer.search("sssx", 4));
+        ASSERT_TRUE(8 == buffer.search('s'));
+        ASSERT_TRUE(8 == buffer.searchAny("sd"));
+        ASSERT_TRUE(buffer_type::npos == buffer.searchAny("xyz"));
+
+        buffer.seek(9);
+        ASSERT_TRUE(5 == buffer.search("ddd", 3));
+        ASSERT_TRUE(buffer_type::npos == buffer.search("ccsd", 4));
+    }
+
+    {
+        char* segments[] = { seg1, seg2, seg3 };
+        std::vector<io_mem_buf> memory;
+        toMemBuf(memory, segments, 3);
+        InBuffer buffer(&memory, 22);
+
+        ASSERT_TRUE(6 == buffer.search("ccsasd", 6));
+        ASSERT_TRUE(5 == buffer.search("cccsas", 6));
+        ASSERT_TRUE(16 == buffer.search("dddsss", 6));
+        ASSERT_TRUE(8 == buffer.searchAny("fs"));
+    }
+
+    {
+        // βĺѡλֽͬ, Ƚʧ
+        char abca[] = "abca";
+        char bcx[] = "bcx";
+        char abcd[] = "abcd";
+        char* segments[] = { abca, bcx, abcd };
+        std::vector<io_mem_buf> memory;
+        toMemBuf(memory, segments, 3);
+        InBuffer buffer(&memory, 11);
+
+        ASSERT_TRUE(7 == buffer.search("abcd", 4));
+        ASSERT_TRUE(3 == buffer.search("abcx", 4));
+    }
 }
 
 
+TEST(buffer, bufferReadTyped)
+{
+    {
+        unsigned char seg1[] = { 0x12, 0x34, 0x56 };
+        unsigned char seg2[] = { 0x78, 0x01, 0x02, 0xac, 0x02, 0x96 };
+        unsigned char seg3[] = { 0x01, 0xff };
+
+        std::vector<io_mem_buf> memory;
+        addMemBuf(memory, seg1, sizeof(seg1));
+        addMemBuf(memory, seg2, sizeof(seg2));
+        addMemBuf(memory, seg3, sizeof(seg3));
+        InBuffer buffer(&memory, 11);
+
+        ASSERT_TRUE(0x1234 == buffer.readUInt16BE());
+        ASSERT_TRUE(0x56780102 == buffer.readUInt32BE());
+        ASSERT_TRUE(300 == buffer.readVarUInt32());
+        ASSERT_TRUE(150 == buffer.readVarUInt64());
+        ASSERT_TRUE(-1 == buffer.readInt8());
+        ASSERT_FALSE(buffer.fail());
+
+        buffer.readInt8();
+        ASSERT_TRUE(buffer.fail());
+    }
+
+    {
+        unsigned char seg1[] = { 0x34, 0x12, 0x00, 0x01, 0x00 };
+        unsigned char seg2[] = { 0x02 };
+
+        std::vector<io_mem_buf> memory;
+        addMemBuf(memory, seg1, sizeof(seg1));
+        addMemBuf(memory, seg2, sizeof(seg2));
+        InBuffer buffer(&memory, 6);
+
+        ASSERT_TRUE(0x1234 == buffer.readUInt16LE());
+
+        uint16_t values[2];
+        buffer.readUInt16ArrayBE(values, 2);
+        ASSERT_TRUE(1 == values[0]);
+        ASSERT_TRUE(2 == values[1]);
+    }
+
+    {
+        //  5 ֽڵ 32 λ䳤Ǵ
+        unsigned char seg1[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+
+        std::vector<io_mem_buf> memory;
+        addMemBuf(memory, seg1, sizeof(seg1));
+        InBuffer buffer(&memory, 6);
+
+        ASSERT_TRUE(0 == buffer.readVarUInt32());
+        ASSERT_TRUE(buffer.fail());
+    }
+}
+
 _jingxian_end
@@ -11,6 +11,7 @@
 // Include files
 # include "jingxian/Buffer/BaseBuffer.H"
 # include "jingxian/Buffer/IInBuffer.H"
+# include "jingxian/Buffer/byteorder.h"
 
 _jingxian_begin
 
@@ -42,15 +43,98 @@ public:
 
     virtual void reset(const std::vector<io_mem_buf>* buf, size_t totalLength);
 
-    virtual bool    readBoolean();
-    virtual int8_t  readInt8();
-    virtual int16_t readInt16();
-    virtual int32_t readInt32();
-    virtual int64_t readInt64();
+    virtual bool    readBoolean()
+    {
+        return 0 != readFixed<int8_t>();
+    }
+
+    virtual int8_t  readInt8()
+    {
+        return readFixed<int8_t>();
+    }
+
+    virtual int16_t readInt16()
+    {
+        return readFixed<int16_t>();
+    }
+
+    virtual int32_t readInt32()
+    {
+        return readFixed<int32_t>();
+    }
+
+    virtual int64_t readInt64()
+    {
+        return readFixed<int64_t>();
+    }
+
     virtual void    readBlob(void* blob, size_t len);
 
+    virtual uint16_t readUInt16BE()
+    {
+        return byteorder::fromBigEndian(readFixed<uint16_t>());
+    }
+
+    virtual uint16_t readUInt16LE()
+    {
+        return byteorder::fromLittleEndian(readFixed<uint16_t>());
+    }
+
+    virtual uint32_t readUInt32BE()
+    {
+        return byteorder::fromBigEndian(readFixed<uint32_t>());
+    }
+
+    virtual uint32_t readUInt32LE()
+    {
+        return byteorder::fromLittleEndian(readFixed<uint32_t>());
+    }
+
+    virtual uint64_t readUInt64BE()
+    {
+        return byteorder::fromBigEndian(readFixed<uint64_t>());
+    }
+
+    virtual uint64_t readUInt64LE()
+    {
+        return byteorder::fromLittleEndian(readFixed<uint64_t>());
+    }
+
+    virtual uint32_t readVarUInt32()
+    {
+        //  5 ֻֽе 4 λЧ
+        return (uint32_t)readVarUInt(5, 0x0F);
+    }
+
+    virtual uint64_t readVarUInt64()
+    {
+        //  10 ֻֽλЧ
+        return readVarUInt(10, 0x01);
+    }
+
+    virtual void readInt16Array(int16_t* values, size_t count);
+    virtual void readInt32Array(int32_t* values, size_t count);
+    virtual void readInt64Array(int64_t* values, size_t count);
+    virtual void readUInt16ArrayBE(uint16_t* values, size_t count);
+    virtual void readUInt32ArrayBE(uint32_t* values, size_t count);
+    virtual void readUInt64ArrayBE(uint64_t* values, size_t count);
+
     virtual void seek(int offest);
 
+    virtual const char* peek(size_t& len)
+    {
+        // Ѷڴ
+        while (0 == currentLength_ && current_ + 1 < (*memory_).size())
+        {
+            ++ current_;
+            currentPtr_ = (*memory_)[current_].buf;
+            currentLength_ = (*memory_)[current_].len;
+        }
+
+        len = currentLength_;
+        return currentPtr_;
+    }
+
     virtual size_t size() const;
 
     virtual size_t search(char ch) const;
@@ -66,6 +150,60 @@ public:
 private:
     NOCOPY(InBuffer);
 
+    /**
+     * һֵ, ֵȫڵǰڴʱֱӸ,  readBlob
+     */
+    template<typename T>
+    T readFixed()
+    {
+        T value = 0;
+        if (currentLength_ >= sizeof(T) && ERROR_SUCCESS == errno_)
+        {
+            memcpy(&value, currentPtr_, sizeof(T));
+            currentPtr_ += sizeof(T);
+            currentLength_ -= sizeof(T);
+            readLength_ += sizeof(T);
+            return value;
+        }
+
+        readBlob(&value, sizeof(value));
+        return value;
+    }
+
+    /**
+     *  LEB128 䳤, maxBytes Ϊ볤,  maxBytes ֽ
+     * ܴ lastMax, ֵ˷Χ
+     */
+    uint64_t readVarUInt(size_t maxBytes, unsigned char lastMax)
+    {
+        if (currentLength_ >= maxBytes && ERROR_SUCCESS == errno_)
+        {
+            const unsigned char* ptr = (const unsigned char*)currentPtr_;
+            uint64_t value = 0;
+            for (size_t i = 0; i < maxBytes; ++ i)
+            {
+                if (i + 1 == maxBytes && ptr[i] > lastMax)
+                    break;
+
+                value |= ((uint64_t)(ptr[i] & 0x7f)) << (7 * i);
+                if (0 == (ptr[i] & 0x80))
+                {
+                    currentPtr_ += (i + 1);
+                    currentLength_ -= (i + 1);
+                    readLength_ += (i + 1);
+                    return value;
+                }
+            }
+
+            this->error(ERROR_INVALID_DATA);
+            return 0;
+        }
+
+        return readVarUIntSlow(maxBytes, lastMax);
+    }
+
+    uint64_t readVarUIntSlow(size_t maxBytes, unsigned char lastMax);
+
     // еڴ
     const std::vector<io_mem_buf>* memory_;
     // ݵֽ,ֵᱻ
@@ -0,0 +1,57 @@
+
+# include "pro_config.h"
+# include "jingxian/buffer/MemoryAccount.h"
+
+_jingxian_begin
+
+volatile LONGLONG MemoryAccount::bytes_[MemoryKind::Count] = { 0 };
+
+void MemoryAccount::charge(MemoryKind::type kind, size_t bytes)
+{
+    if (MemoryKind::Count <= (size_t)kind)
+        kind = MemoryKind::Other;
+    ::InterlockedExchangeAdd64(&bytes_[kind], (LONGLONG)bytes);
+}
+
+void MemoryAccount::credit(MemoryKind::type kind, size_t bytes)
+{
+    if (MemoryKind::Count <= (size_t)kind)
+        kind = MemoryKind::Other;
+    ::InterlockedExchangeAdd64(&bytes_[kind], -(LONGLONG)bytes);
+}
+
+size_t MemoryAccount::bytes(MemoryKind::type kind)
+{
+    // 32 λ 64 λĶԭӵ
+    LONGLONG value = ::InterlockedCompareExchange64(&bytes_[kind], 0, 0);
+    return (0 > value) ? 0 : (size_t)value;
+}
+
+size_t MemoryAccount::total()
+{
+    size_t result = 0;
+    for (size_t i = 0; i < MemoryKind::Count; ++ i)
+        result += bytes((MemoryKind::type)i);
+    return result;
+}
+
+const tchar* MemoryAccount::toString(MemoryKind::type kind)
+{
+    switch (kind)
+    {
+    case MemoryKind::Other:
+        return _T("");
+    case MemoryKind::Receive:
+        return _T("ջ");
+    case MemoryKind::Send:
+        return _T("ͻ");
+    case MemoryKind::DNS:
+        return _T("");
+    case MemoryKind::Logging:
+        return _T("־");
+    default:
+        return _T("δ֪");
+    }
+}
+
+_jingxian_end
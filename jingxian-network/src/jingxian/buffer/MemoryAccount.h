@@ -0,0 +1,118 @@
+
+#ifndef _MemoryAccount_H_
+#define _MemoryAccount_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/string/string.h"
+
+_jingxian_begin
+
+/**
+ *  my_malloc_as() ڴ
+ */
+namespace MemoryKind
+{
+    enum type
+    {
+        /// ûָ
+        Other = 0,
+        /// ӵĽջ
+        Receive,
+        /// ӵķͻ
+        Send,
+        /// Ľ
+        DNS,
+        /// ־
+        Logging,
+
+        Count
+    };
+}
+
+/**
+ * ͳ my_malloc ϵкֽ
+ *
+ * my_malloc_as() ÿڴǰ´С, my_free() ʱµֵȥ,
+ * Լ׼ȷ. ԭӲ޸, κ߳ʹ. 
+ * my_malloc ڴ(  new  std  ) charge()  credit() ֹ.
+ */
+class MemoryAccount
+{
+public:
+    /**
+     * ¼ bytes ֽ
+     */
+    static void charge(MemoryKind::type kind, size_t bytes);
+
+    /**
+     * ¼ͷ bytes ֽ
+     */
+    static void credit(MemoryKind::type kind, size_t bytes);
+
+    /**
+     * ǰֽ
+     */
+    static size_t bytes(MemoryKind::type kind);
+
+    /**
+     * ֽϼ
+     */
+    static size_t total();
+
+    static const tchar* toString(MemoryKind::type kind);
+
+private:
+    ///  64 λ, 64 λԤԳ 2G
+    static volatile LONGLONG bytes_[MemoryKind::Count];
+};
+
+/**
+ *  my_malloc ( Элѹ )
+ *
+ * 仯 update(), ʱ۳ȫֽ.
+ */
+class MemoryCharge
+{
+public:
+    MemoryCharge(MemoryKind::type kind)
+            : kind_(kind)
+            , bytes_(0)
+    {
+    }
+
+    ~MemoryCharge()
+    {
+        MemoryAccount::credit(kind_, bytes_);
+    }
+
+    void update(size_t bytes)
+    {
+        if (bytes == bytes_)
+            return;
+
+        MemoryAccount::charge(kind_, bytes);
+        MemoryAccount::credit(kind_, bytes_);
+        bytes_ = bytes;
+    }
+
+    size_t bytes() const
+    {
+        return bytes_;
+    }
+
+private:
+    NOCOPY(MemoryCharge);
+
+    MemoryKind::type kind_;
+    size_t bytes_;
+};
+
+_jingxian_end
+
+#endif //_MemoryAccount_H_
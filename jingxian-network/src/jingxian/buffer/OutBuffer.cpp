@@ -1,6 +1,7 @@
 
 # include "pro_config.h"
 # include "jingxian/buffer/OutBuffer.h"
+# include "jingxian/buffer/MemoryAccount.h"
 
 
 _jingxian_begin
@@ -50,40 +51,9 @@ void OutBuffer::freeBuffer()
     dataBuffer_.clear();
 }
 
-IOutBuffer& OutBuffer::writeBoolean(bool value)
-{
-    int8_t tmp = value ? 1 : 0;
-    writeBlob(&tmp, sizeof(tmp));
-    return *this;
-}
-
-IOutBuffer& OutBuffer::writeInt8(int8_t value)
-{
-    writeBlob(&value, sizeof(value));
-    return *this;
-}
-
-IOutBuffer& OutBuffer::writeInt16(int16_t value)
-{
-    writeBlob(&value, sizeof(value));
-    return *this;
-}
-
-IOutBuffer& OutBuffer::writeInt32(int32_t value)
-{
-    writeBlob(&value, sizeof(value));
-    return *this;
-}
-
-IOutBuffer& OutBuffer::writeInt64(const int64_t& value)
-{
-    writeBlob(&value, sizeof(value));
-    return *this;
-}
-
 databuffer_t* OutBuffer::allocate(size_t len)
 {
-    databuffer_t* result = (databuffer_t*)my_calloc(1, sizeof(databuffer_t) + len);
+    databuffer_t* result = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + len, MemoryKind::Send);
 
     result->chain.context = result;
     result->chain.freebuffer = &free_Buffer;
@@ -106,11 +76,11 @@ IOutBuffer& OutBuffer::writeBlob(const void* blob, size_t len)
         {
             size_t capacity = data->ptr + data->capacity - data->end;
 
-            if (capacity > len)
+            if (capacity >= len)
             {
                 memcpy(data->end, ptr, len);
                 data->end += len;
-                exceptLen = 0;
+                bytes_ += len;
                 return *this;
             }
 
@@ -135,6 +105,28 @@ IOutBuffer& OutBuffer::writeBlob(const void* blob, size_t len)
     return *this;
 }
 
+char* OutBuffer::prepare(size_t len)
+{
+    if (!dataBuffer_.empty())
+    {
+        databuffer_t* data = databuffer_cast(dataBuffer_.back());
+        if ((size_t)(data->ptr + data->capacity - data->end) >= len)
+            return data->end;
+    }
+
+    databuffer_t* data = allocate(max(len, 100));
+    dataBuffer_.push_back((buffer_chain_t*)data);
+    return data->end;
+}
+
+void OutBuffer::commit(size_t len)
+{
+    databuffer_t* data = databuffer_cast(dataBuffer_.back());
+    assert(data->end + len <= data->ptr + data->capacity);
+    data->end += len;
+    bytes_ += len;
+}
+
 size_t OutBuffer::size() const
 {
     return bytes_;
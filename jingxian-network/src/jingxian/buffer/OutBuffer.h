@@ -12,6 +12,7 @@
 # include "jingxian/buffer/IOutBuffer.H"
 # include "jingxian/buffer/BaseBuffer.H"
 # include "jingxian/ITransport.H"
+# include "jingxian/buffer/byteorder.h"
 
 _jingxian_begin
 
@@ -21,21 +22,148 @@ public:
     OutBuffer(ITransport* transport);
     virtual ~OutBuffer();
 
-    virtual IOutBuffer& writeBoolean(bool value);
-    virtual IOutBuffer& writeInt8(int8_t value);
-    virtual IOutBuffer& writeInt16(int16_t value);
-    virtual IOutBuffer& writeInt32(int32_t value);
-    virtual IOutBuffer& writeInt64(const int64_t& value);
+    virtual IOutBuffer& writeBoolean(bool value)
+    {
+        return writeFixed<int8_t>(value ? 1 : 0);
+    }
+
+    virtual IOutBuffer& writeInt8(int8_t value)
+    {
+        return writeFixed(value);
+    }
+
+    virtual IOutBuffer& writeInt16(int16_t value)
+    {
+        return writeFixed(value);
+    }
+
+    virtual IOutBuffer& writeInt32(int32_t value)
+    {
+        return writeFixed(value);
+    }
+
+    virtual IOutBuffer& writeInt64(const int64_t& value)
+    {
+        return writeFixed(value);
+    }
+
     virtual IOutBuffer& writeBlob(const void* blob, size_t len);
 
+    virtual IOutBuffer& writeUInt16BE(uint16_t value)
+    {
+        return writeFixed(byteorder::toBigEndian(value));
+    }
+
+    virtual IOutBuffer& writeUInt16LE(uint16_t value)
+    {
+        return writeFixed(byteorder::toLittleEndian(value));
+    }
+
+    virtual IOutBuffer& writeUInt32BE(uint32_t value)
+    {
+        return writeFixed(byteorder::toBigEndian(value));
+    }
+
+    virtual IOutBuffer& writeUInt32LE(uint32_t value)
+    {
+        return writeFixed(byteorder::toLittleEndian(value));
+    }
+
+    virtual IOutBuffer& writeUInt64BE(const uint64_t& value)
+    {
+        return writeFixed(byteorder::toBigEndian(value));
+    }
+
+    virtual IOutBuffer& writeUInt64LE(const uint64_t& value)
+    {
+        return writeFixed(byteorder::toLittleEndian(value));
+    }
+
+    virtual IOutBuffer& writeVarUInt32(uint32_t value)
+    {
+        return writeVarUInt(value);
+    }
+
+    virtual IOutBuffer& writeVarUInt64(const uint64_t& value)
+    {
+        return writeVarUInt(value);
+    }
+
     virtual size_t size() const;
 
+    /**
+     * ȡ len ֽڵռ, һڴ鲻ʱµڴ.
+     * д commit ύʵдֽ( ܳ len )
+     */
+    char* prepare(size_t len);
+
+    void commit(size_t len);
+
+    /**
+     * Ѿдڴ(  databuffer_t )
+     */
+    const std::vector<buffer_chain_t*>& rawBuffer() const
+    {
+        return dataBuffer_;
+    }
+
 private:
     std::vector<buffer_chain_t*> dataBuffer_;
     size_t bytes_;
     ITransport* transport_;
 
     virtual databuffer_t* allocate(size_t len);
+
+    /**
+     * һݿԤ len ֽ, ռ䲻ʱ null_ptr
+     */
+    char* reserve(size_t len)
+    {
+        if (dataBuffer_.empty())
+            return null_ptr;
+
+        databuffer_t* data = (databuffer_t*)dataBuffer_.back();
+        if ((size_t)(data->ptr + data->capacity - data->end) < len)
+            return null_ptr;
+
+        char* ptr = data->end;
+        data->end += len;
+        bytes_ += len;
+        return ptr;
+    }
+
+    /**
+     * дһֵ, һݿ㹻ռʱֱӸ,  writeBlob
+     */
+    template<typename T>
+    IOutBuffer& writeFixed(T value)
+    {
+        char* ptr = reserve(sizeof(T));
+        if (is_null(ptr))
+            return writeBlob(&value, sizeof(T));
+
+        memcpy(ptr, &value, sizeof(T));
+        return *this;
+    }
+
+    IOutBuffer& writeVarUInt(uint64_t value)
+    {
+        char tmp[10];
+        size_t len = 0;
+        while (value >= 0x80)
+        {
+            tmp[len ++] = (char)(value | 0x80);
+            value >>= 7;
+        }
+        tmp[len ++] = (char)value;
+
+        char* ptr = reserve(len);
+        if (is_null(ptr))
+            return writeBlob(tmp, len);
+
+        memcpy(ptr, tmp, len);
+        return *this;
+    }
     //std::vector<buffer_chain_t*>& dataBuffer();
     //void releaseBuffer();
     void freeBuffer();
@@ -120,6 +120,27 @@ inline bool   isMemory(const buffer_chain_t* chain)
     return BUFFER_ELEMENT_MEMORY == chain->type;
 }
 
+/**
+ * ռõڴֽ( ͷ )
+ */
+inline size_t memory_size(const buffer_chain_t* chain)
+{
+    switch (chain->type)
+    {
+    case BUFFER_ELEMENT_MEMORY:
+        return sizeof(databuffer_t) + cast_to_databuffer(chain)->capacity;
+    case BUFFER_ELEMENT_FILE:
+        return sizeof(filebuffer_t);
+    case BUFFER_ELEMENT_PACKET:
+    {
+        DWORD count = ((const packetbuffer_t*)chain)->element_count;
+        return sizeof(packetbuffer_t) + ((1 < count) ? (count - 1) : 0) * sizeof(TRANSMIT_PACKETS_ELEMENT);
+    }
+    default:
+        return 0;
+    }
+}
+
 inline char*  wd_ptr(buffer_chain_t* chain)
 {
     return cast_to_databuffer(chain)->end;
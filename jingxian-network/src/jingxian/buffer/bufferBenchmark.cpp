@@ -0,0 +1,276 @@
+
+# include "pro_config.h"
+# include "jingxian/Buffer/InBuffer.h"
+# include "jingxian/Buffer/OutBuffer.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    bool readVarUInt32(const std::string& data, size_t segmentSize, uint32_t& value)
+    {
+        std::string copy(data);
+        std::vector<io_mem_buf> segments;
+        for (size_t offset = 0; offset < copy.size(); offset += segmentSize)
+        {
+            io_mem_buf buf;
+            buf.buf = &copy[offset];
+            buf.len = (u_long)((copy.size() - offset < segmentSize) ? (copy.size() - offset) : segmentSize);
+            segments.push_back(buf);
+        }
+
+        InBuffer buffer(&segments, copy.size());
+        value = buffer.readVarUInt32();
+        return ERROR_SUCCESS == buffer.error();
+    }
+}
+
+TEST(buffer, varUInt32)
+{
+    // һڴеĿ·Ϳڴ·ͬ
+    const size_t segmentSizes[] = { 1, 8 };
+    for (size_t i = 0; i < 2; ++ i)
+    {
+        size_t segmentSize = segmentSizes[i];
+        uint32_t value = 0;
+        ASSERT_TRUE(readVarUInt32(std::string("\x7f" "xxxx", 5), segmentSize, value));
+        ASSERT_TRUE(0x7f == value);
+        ASSERT_TRUE(readVarUInt32(std::string("\xff\xff\xff\xff\x0f", 5), segmentSize, value));
+        ASSERT_TRUE(0xffffffff == value);
+
+        //  5 ֽڳ 0x0F ʱ 32 λ
+        ASSERT_FALSE(readVarUInt32(std::string("\xff\xff\xff\xff\x10", 5), segmentSize, value));
+        ASSERT_FALSE(readVarUInt32(std::string("\x80\x80\x80\x80\x7f", 5), segmentSize, value));
+        ASSERT_FALSE(readVarUInt32(std::string("\xff\xff\xff\xff\x8f", 5), segmentSize, value));
+    }
+}
+
+# ifndef _GOOGLETEST_
+
+namespace
+{
+    /**
+     * ģտɵ, ƥݷһм, 
+     * Խı߽
+     */
+    class SegmentedData
+    {
+    public:
+        SegmentedData(size_t segmentCount, size_t segmentSize, const char* tail, bool acrossSeam = false)
+            : data_(segmentCount * segmentSize, 'a')
+            , totalLength_(segmentCount * segmentSize)
+        {
+            size_t tailLen = strlen(tail);
+            size_t offset = acrossSeam ? (totalLength_ - segmentSize - tailLen / 2)
+                            : (totalLength_ - segmentSize / 2 - tailLen / 2);
+            memcpy(&data_[offset], tail, tailLen);
+
+            // ֽڵĿ괮ʱһЩֽͬĸַ, ӽ HTTP ͷ
+            // Ļзֲ
+            if (1 < tailLen)
+            {
+                for (size_t pos = 64; pos + 1 < offset; pos += 64)
+                    data_[pos] = tail[0];
+            }
+
+            for (size_t i = 0; i < segmentCount; ++ i)
+            {
+                io_mem_buf buf;
+                buf.len = (u_long)segmentSize;
+                buf.buf = &data_[i * segmentSize];
+                segments_.push_back(buf);
+            }
+        }
+
+        const std::vector<io_mem_buf>* segments() const
+        {
+            return &segments_;
+        }
+
+        size_t totalLength() const
+        {
+            return totalLength_;
+        }
+
+    private:
+        std::vector<char> data_;
+        std::vector<io_mem_buf> segments_;
+        size_t totalLength_;
+    };
+}
+
+BENCHMARK(InBuffer_search_char)
+{
+    SegmentedData data(16, 1460, "\n");
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.search('\n'));
+}
+
+BENCHMARK(InBuffer_search_crlfcrlf)
+{
+    SegmentedData data(16, 1460, "\r\n\r\n");
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.search("\r\n\r\n", 4));
+}
+
+BENCHMARK(InBuffer_search_crlfcrlf_4k)
+{
+    SegmentedData data(4, 4096, "\r\n\r\n");
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.search("\r\n\r\n", 4));
+}
+
+BENCHMARK(InBuffer_search_crlfcrlf_seam)
+{
+    SegmentedData data(16, 1460, "\r\n\r\n", true);
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.search("\r\n\r\n", 4));
+}
+
+BENCHMARK(InBuffer_search_small_segments)
+{
+    SegmentedData data(256, 7, "\r\n\r\n", true);
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.search("\r\n\r\n", 4));
+}
+
+BENCHMARK(InBuffer_searchAny)
+{
+    SegmentedData data(16, 1460, ";");
+    InBuffer buffer(data.segments(), data.totalLength());
+    state.setBytesProcessed(data.totalLength());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(buffer.searchAny(",;\r\n"));
+}
+
+BENCHMARK(InBuffer_readInt32)
+{
+    SegmentedData data(16, 1460, "");
+    InBuffer buffer(data.segments(), data.totalLength());
+    size_t count = data.totalLength() / sizeof(int32_t);
+    state.setBytesProcessed(count * sizeof(int32_t));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        state.pauseTiming();
+        buffer.reset(data.segments(), data.totalLength());
+        state.resumeTiming();
+
+        int32_t sum = 0;
+        for (size_t j = 0; j < count; ++ j)
+            sum += buffer.readInt32();
+        DO_NOT_OPTIMIZE(sum);
+    }
+}
+
+BENCHMARK(InBuffer_readUInt32BE)
+{
+    SegmentedData data(16, 1460, "");
+    InBuffer buffer(data.segments(), data.totalLength());
+    size_t count = data.totalLength() / sizeof(uint32_t);
+    state.setBytesProcessed(count * sizeof(uint32_t));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        state.pauseTiming();
+        buffer.reset(data.segments(), data.totalLength());
+        state.resumeTiming();
+
+        uint32_t sum = 0;
+        for (size_t j = 0; j < count; ++ j)
+            sum += buffer.readUInt32BE();
+        DO_NOT_OPTIMIZE(sum);
+    }
+}
+
+BENCHMARK(InBuffer_readUInt32ArrayBE)
+{
+    SegmentedData data(16, 1460, "");
+    InBuffer buffer(data.segments(), data.totalLength());
+    size_t count = data.totalLength() / sizeof(uint32_t);
+    std::vector<uint32_t> values(count);
+    state.setBytesProcessed(count * sizeof(uint32_t));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        state.pauseTiming();
+        buffer.reset(data.segments(), data.totalLength());
+        state.resumeTiming();
+
+        buffer.readUInt32ArrayBE(&values[0], count);
+        DO_NOT_OPTIMIZE(values[count - 1]);
+    }
+}
+
+BENCHMARK(InBuffer_readVarUInt64)
+{
+    // 'a' λΪ 0, ÿֽڶһ䳤
+    SegmentedData data(16, 1460, "");
+    InBuffer buffer(data.segments(), data.totalLength());
+    size_t count = data.totalLength();
+    state.setBytesProcessed(count);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        state.pauseTiming();
+        buffer.reset(data.segments(), data.totalLength());
+        state.resumeTiming();
+
+        uint64_t sum = 0;
+        for (size_t j = 0; j < count; ++ j)
+            sum += buffer.readVarUInt64();
+        DO_NOT_OPTIMIZE(sum);
+    }
+}
+
+BENCHMARK(OutBuffer_writeUInt32BE)
+{
+    const size_t count = 4096;
+    state.setBytesProcessed(count * sizeof(uint32_t));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        OutBuffer buffer(null_ptr);
+        for (size_t j = 0; j < count; ++ j)
+            buffer.writeUInt32BE((uint32_t)j);
+        DO_NOT_OPTIMIZE(buffer.size());
+    }
+}
+
+BENCHMARK(OutBuffer_writeVarUInt64)
+{
+    const size_t count = 4096;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        OutBuffer buffer(null_ptr);
+        for (size_t j = 0; j < count; ++ j)
+            buffer.writeVarUInt64((uint64_t)j * 977);
+        DO_NOT_OPTIMIZE(buffer.size());
+    }
+}
+
+_jingxian_end
+
+#endif // _GOOGLETEST_
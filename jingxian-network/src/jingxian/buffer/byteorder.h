@@ -0,0 +1,83 @@
+
+#ifndef _byteorder_h_
+#define _byteorder_h_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <stdlib.h>
+
+_jingxian_begin
+
+/**
+ * ֽת, ĬϱΪС( x86/x64 ), ڴ˻붨 JINGXIAN_BIG_ENDIAN
+ */
+namespace byteorder
+{
+    inline uint16_t byteSwap(uint16_t value)
+    {
+#ifdef __GNUG__
+        return __builtin_bswap16(value);
+#else
+        return _byteswap_ushort(value);
+#endif
+    }
+
+    inline uint32_t byteSwap(uint32_t value)
+    {
+#ifdef __GNUG__
+        return __builtin_bswap32(value);
+#else
+        return _byteswap_ulong(value);
+#endif
+    }
+
+    inline uint64_t byteSwap(uint64_t value)
+    {
+#ifdef __GNUG__
+        return __builtin_bswap64(value);
+#else
+        return _byteswap_uint64(value);
+#endif
+    }
+
+    template<typename T>
+    inline T toBigEndian(T value)
+    {
+#ifdef JINGXIAN_BIG_ENDIAN
+        return value;
+#else
+        return byteSwap(value);
+#endif
+    }
+
+    template<typename T>
+    inline T toLittleEndian(T value)
+    {
+#ifdef JINGXIAN_BIG_ENDIAN
+        return byteSwap(value);
+#else
+        return value;
+#endif
+    }
+
+    template<typename T>
+    inline T fromBigEndian(T value)
+    {
+        return toBigEndian(value);
+    }
+
+    template<typename T>
+    inline T fromLittleEndian(T value)
+    {
+        return toLittleEndian(value);
+    }
+}
+
+_jingxian_end
+
+#endif // _byteorder_h_
@@ -0,0 +1,244 @@
+
+#ifndef _memsearch_h_
+#define _memsearch_h_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <string.h>
+
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JINGXIAN_HAS_SSE2 1
+#  include <emmintrin.h>
+# endif
+
+# if defined(__AVX2__)
+#  define JINGXIAN_HAS_AVX2 1
+#  include <immintrin.h>
+# endif
+
+# if !defined(__GNUG__) && defined(JINGXIAN_HAS_SSE2)
+#  include <intrin.h>
+#  pragma intrinsic(_BitScanForward)
+# endif
+
+_jingxian_begin
+
+namespace memsearch
+{
+    const size_t npos = (size_t) - 1;
+
+#ifdef JINGXIAN_HAS_SSE2
+
+    /**
+     *  mask ͵һλλ, mask Ϊ 0
+     */
+    inline unsigned int lowestBit(unsigned int mask)
+    {
+#ifdef __GNUG__
+        return __builtin_ctz(mask);
+#else
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#endif
+    }
+
+#endif // JINGXIAN_HAS_SSE2
+
+    /**
+     * 256 λַλͼ,  searchAny һĲ
+     */
+    class charset_bitmap
+    {
+    public:
+        charset_bitmap(const char* charset, size_t len)
+            : len_(len)
+            , charset_(charset)
+        {
+            memset(bits_, 0, sizeof(bits_));
+            for (size_t i = 0; i < len; ++ i)
+            {
+                unsigned char ch = (unsigned char)charset[i];
+                bits_[ch >> 5] |= (1u << (ch & 31));
+            }
+        }
+
+        bool test(unsigned char ch) const
+        {
+            return 0 != (bits_[ch >> 5] & (1u << (ch & 31)));
+        }
+
+        size_t size() const
+        {
+            return len_;
+        }
+
+        const char* charset() const
+        {
+            return charset_;
+        }
+
+    private:
+        unsigned int bits_[8];
+        size_t len_;
+        const char* charset_;
+    };
+
+    /**
+     *  [ptr, ptr + len) вַ ch, Ҳʱ npos
+     */
+    inline size_t find(const char* ptr, size_t len, char ch)
+    {
+        size_t i = 0;
+
+#if defined(JINGXIAN_HAS_AVX2)
+        const __m256i target32 = _mm256_set1_epi8(ch);
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i*)(ptr + i));
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, target32));
+            if (0 != mask)
+                return i + lowestBit(mask);
+        }
+#endif
+
+#if defined(JINGXIAN_HAS_SSE2)
+        const __m128i target = _mm_set1_epi8(ch);
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i*)(ptr + i));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, target));
+            if (0 != mask)
+                return i + lowestBit(mask);
+        }
+#endif
+
+        const char* p = (const char*)::memchr(ptr + i, ch, len - i);
+        if (NULL == p)
+            return npos;
+        return p - ptr;
+    }
+
+    /**
+     *  [ptr, ptr + len) в pattern, ֻڴеƥ,
+     * Ҳʱ npos.
+     *
+     * βֽڹ˳ѡλ, Ƚмֽ.
+     */
+    inline size_t find(const char* ptr, size_t len, const char* pattern, size_t patternLen)
+    {
+        if (0 == patternLen || len < patternLen)
+            return npos;
+
+        if (1 == patternLen)
+            return find(ptr, len, pattern[0]);
+
+        const size_t last = patternLen - 1;
+        size_t i = 0;
+
+#if defined(JINGXIAN_HAS_AVX2)
+        const __m256i first32 = _mm256_set1_epi8(pattern[0]);
+        const __m256i last32 = _mm256_set1_epi8(pattern[last]);
+        for (; i + 32 + last <= len; i += 32)
+        {
+            __m256i blockFirst = _mm256_loadu_si256((const __m256i*)(ptr + i));
+            __m256i blockLast = _mm256_loadu_si256((const __m256i*)(ptr + i + last));
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+                                    _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first32)
+                                                     , _mm256_cmpeq_epi8(blockLast, last32)));
+            while (0 != mask)
+            {
+                unsigned int bit = lowestBit(mask);
+                if (0 == ::memcmp(ptr + i + bit + 1, pattern + 1, last - 1))
+                    return i + bit;
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+#if defined(JINGXIAN_HAS_SSE2)
+        const __m128i first = _mm_set1_epi8(pattern[0]);
+        const __m128i lastch = _mm_set1_epi8(pattern[last]);
+        for (; i + 16 + last <= len; i += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128((const __m128i*)(ptr + i));
+            __m128i blockLast = _mm_loadu_si128((const __m128i*)(ptr + i + last));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(
+                                    _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first)
+                                                  , _mm_cmpeq_epi8(blockLast, lastch)));
+            while (0 != mask)
+            {
+                unsigned int bit = lowestBit(mask);
+                if (0 == ::memcmp(ptr + i + bit + 1, pattern + 1, last - 1))
+                    return i + bit;
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        // ʣµĲ( û SIMD ʱȫ ) memchr ֽ
+        const size_t end = len - last;
+        while (i < end)
+        {
+            const char* p = (const char*)::memchr(ptr + i, pattern[0], end - i);
+            if (NULL == p)
+                return npos;
+
+            i = p - ptr;
+            if (ptr[i + last] == pattern[last]
+                    && 0 == ::memcmp(ptr + i + 1, pattern + 1, last - 1))
+                return i;
+            ++ i;
+        }
+        return npos;
+    }
+
+    /**
+     *  [ptr, ptr + len) вҵһ charset ַ, Ҳʱ npos.
+     *
+     * ַ 4 ַʱ(  "\r\n", ",;" ) SIMD Ƚ, λͼ.
+     */
+    inline size_t find_any(const char* ptr, size_t len, const charset_bitmap& charset)
+    {
+        size_t i = 0;
+
+#if defined(JINGXIAN_HAS_SSE2)
+        if (0 < charset.size() && charset.size() <= 4)
+        {
+            const char* cs = charset.charset();
+            const size_t n = charset.size();
+            __m128i targets[4];
+            for (size_t k = 0; k < 4; ++ k)
+                targets[k] = _mm_set1_epi8(cs[k < n ? k : 0]);
+
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i block = _mm_loadu_si128((const __m128i*)(ptr + i));
+                __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, targets[0])
+                                                       , _mm_cmpeq_epi8(block, targets[1]))
+                                          , _mm_or_si128(_mm_cmpeq_epi8(block, targets[2])
+                                                         , _mm_cmpeq_epi8(block, targets[3])));
+                unsigned int mask = (unsigned int)_mm_movemask_epi8(eq);
+                if (0 != mask)
+                    return i + lowestBit(mask);
+            }
+        }
+#endif
+
+        for (; i < len; ++ i)
+        {
+            if (charset.test((unsigned char)ptr[i]))
+                return i;
+        }
+        return npos;
+    }
+}
+
+_jingxian_end
+
+#endif // _memsearch_h_
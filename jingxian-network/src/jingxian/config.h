@@ -210,6 +210,10 @@ void  my_free(__inout_opt void * _Memory);
 void* my_malloc(__in size_t _Size);                 
 void* my_realloc(__in_opt void * _Memory, __in size_t _NewSize);
 
+// ˵ķ, _Kind Ϊ MemoryKind::type(  jingxian/buffer/MemoryAccount.h )
+void* my_malloc_as(__in size_t _Size, __in int _Kind);
+void* my_calloc_as(__in size_t _NumOfElements, __in size_t _SizeOfElements, __in int _Kind);
+
 char*  my_strdup(__in_z_opt const char * _Src);
 wchar_t* my_wcsdup(__in_z const wchar_t * _Str);
 
@@ -10,8 +10,7 @@
 
 // Include files
 # include <stack>
-# include <list>
-# include "jingxian/connection_functionals.h"
+# include "jingxian/delegate.h"
 # include "jingxian/logging/logging.h"
 
 _jingxian_begin
@@ -21,18 +20,18 @@ namespace configure
 
 class Context;
 
-typedef _connection_base<bool (Context& context, const tstring& txt)> callback_type;
+typedef delegate<bool (Context& context, const tstring& txt)> callback_type;
 
 class IContext
 {
 public:
   virtual ~IContext() {}
 
-  virtual void connect(callback_type* connection) = 0;
+  virtual void connect(const callback_type& connection) = 0;
 
-  virtual void disconnect(callback_type* connection) = 0;
+  virtual void disconnect(const callback_type& connection) = 0;
 
-  virtual void push(callback_type* callback) = 0;
+  virtual void push(const callback_type& callback) = 0;
 
   virtual void pop() = 0;
 
@@ -52,7 +51,7 @@ public:
 
   virtual ~Context() {}
 
-  virtual void connect(callback_type* connection)
+  virtual void connect(const callback_type& connection)
   {
     pimpl_->connect(connection);
   }
@@ -60,18 +59,15 @@ public:
   template<class desttype>
   void connect(desttype* pclass, bool (desttype::*pmemfun)(Context& , const tstring&))
   {
-    _connection<desttype, bool (Context& , const tstring&)>* conn =
-      new _connection<desttype, bool (Context& , const tstring&)>(pclass, pmemfun);
-
-    connect(conn);
+    connect(callback_type(pclass, pmemfun));
   }
 
-  virtual void disconnect(callback_type* connection)
+  virtual void disconnect(const callback_type& connection)
   {
     pimpl_->disconnect(connection);
   }
 
-  virtual void push(callback_type* connection)
+  virtual void push(const callback_type& connection)
   {
     pimpl_->push(connection);
   }
@@ -79,10 +75,7 @@ public:
   template<class desttype>
   void push(desttype* pclass, bool (desttype::*pmemfun)(Context& , const tstring&))
   {
-    _connection<desttype, bool (Context& , const tstring&)>* conn =
-      new _connection<desttype, bool (Context& , const tstring&)>(pclass, pmemfun);
-
-    push(conn);
+    push(callback_type(pclass, pmemfun));
   }
 
   virtual void pop()
@@ -111,82 +104,34 @@ class ContextImpl : public IContext
 {
 public:
 
-  class ConnectionSlot
-  {
-  public:
-
-    typedef std::list<callback_type *>  connections_list;
-
-    ConnectionSlot()
-    {
-    }
-
-    virtual ~ConnectionSlot()
-    {
-      for (connections_list::iterator it = m_slots.begin()
-                                           ; it != m_slots.end(); ++ it)
-        {
-          delete (*it);
-        }
-
-      m_slots.clear();
-    }
-
-    virtual void connect(callback_type* connection)
-    {
-      m_slots.push_back(connection);
-    }
-
-    virtual void disconnect(callback_type* connection)
-    {
-      m_slots.remove(connection);
-    }
-
-    virtual bool call(Context& context, const tstring& txt)
-    {
-      connections_list::const_iterator itNext, it = m_slots.begin();
-      connections_list::const_iterator itEnd = m_slots.end();
-
-      while (it != itEnd)
-        {
-          itNext = it;
-          ++itNext;
-
-          if ((*it)->call(context, txt))
-            return true;
-
-          it = itNext;
-        }
-      return false;
-    }
-  private:
-    NOCOPY(ConnectionSlot);
-    connections_list m_slots;
-  };
+  /**
+   * ͬһĻص, , ӵ˳ֱһ true
+   */
+  typedef delegate_signal<bool (Context& context, const tstring& txt)> ConnectionSlot;
 
   ContextImpl(logging::logger& alogger)
       : m_exit(false)
       , m_logger(alogger)
   {
-    m_slots.push(new ConnectionSlot());
+    m_slots.push(ConnectionSlot());
   }
 
   virtual ~ContextImpl() {}
 
-  virtual void connect(callback_type* connection)
+  virtual void connect(const callback_type& connection)
   {
-    m_slots.top()->connect(connection);
+    m_slots.top().connect(connection);
   }
 
-  virtual void disconnect(callback_type* connection)
+  virtual void disconnect(const callback_type& connection)
   {
-    m_slots.top()->disconnect(connection);
+    m_slots.top().disconnect(connection);
   }
 
-  virtual void push(callback_type* connection)
+  virtual void push(const callback_type& connection)
   {
-    m_slots.push(new ConnectionSlot());
-    m_slots.top()->connect(connection);
+    m_slots.push(ConnectionSlot());
+    m_slots.top().connect(connection);
   }
 
   virtual void pop()
@@ -196,7 +141,15 @@ public:
 
   virtual bool call(Context& context, const tstring& txt)
   {
-    return m_slots.top()->call(context, txt);
+    // صпܻ push µһ, std::stack ײ deque ĩβԪʱ
+    // ʹԪصʧЧ, һֱʹ slot
+    const ConnectionSlot& slot = m_slots.top();
+    for (size_t i = 0; i < slot.size(); ++ i)
+      {
+        if (slot[i](context, txt))
+          return true;
+      }
+    return false;
   }
 
   virtual void exit()
@@ -216,7 +169,7 @@ public:
 
 private:
   NOCOPY(ContextImpl);
-  std::stack<ConnectionSlot*> m_slots;
+  std::stack<ConnectionSlot> m_slots;
   bool m_exit;
   logging::logger& m_logger;
 };
@@ -0,0 +1,379 @@
+
+# include "pro_config.h"
+# include <algorithm>
+# include "jingxian/exception.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/IReactorCore.h"
+# include "jingxian/coroutine/Channel.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ÿζȡĻС, ݻḴƵ in_ , Ҫ̫
+    const size_t RECEIVE_SIZE = 4*1024;
+
+    /**
+     * Эеһ, Э̵ջ, ǰЭ̲᷵
+     */
+    struct ConnectRequest
+    {
+        CoroutineScheduler* scheduler;
+        Coroutine* coroutine;
+        ITransport* transport;
+        tstring error;
+        bool done;
+
+        static void OnComplete(ITransport* transport, void* context)
+        {
+            ConnectRequest* self = (ConnectRequest*)context;
+            self->transport = transport;
+            self->done = true;
+            self->scheduler->wake(self->coroutine);
+        }
+
+        static void OnError(const ErrorCode& err, void* context)
+        {
+            ConnectRequest* self = (ConnectRequest*)context;
+            self->error = err.toString();
+            self->done = true;
+            self->scheduler->wake(self->coroutine);
+        }
+    };
+}
+
+Channel::Channel(CoroutineScheduler* scheduler, IReactorCore* core)
+        : scheduler_(scheduler)
+        , core_(core)
+        , transport_(null_ptr)
+        , starter_(null_ptr)
+        , waiter_(null_ptr)
+        , inStart_(0)
+        , inCharge_(MemoryKind::Receive)
+        , connected_(false)
+        , disconnected_(false)
+        , released_(false)
+        , paused_(false)
+        , toString_(_T("Channel"))
+{
+    if (is_null(scheduler))
+        ThrowException1(ArgumentNullException, _T("scheduler"));
+}
+
+Channel::~Channel()
+{
+}
+
+void Channel::startOnConnected(Coroutine* coroutine)
+{
+    starter_ = coroutine;
+}
+
+Channel* Channel::connect(CoroutineScheduler* scheduler
+                          , IReactorCore* core
+                          , const tstring& endPoint
+                          , tstring& error)
+{
+    Coroutine* coroutine = scheduler->current();
+    if (is_null(coroutine))
+        ThrowException1(RuntimeException, _T("ֻЭз"));
+
+    ConnectRequest request;
+    request.scheduler = scheduler;
+    request.coroutine = coroutine;
+    request.transport = null_ptr;
+    request.done = false;
+
+    core->connectWith(endPoint.c_str(), &ConnectRequest::OnComplete, &ConnectRequest::OnError, &request);
+    while (!request.done)
+        coroutine->suspend(_T("connect"));
+
+    if (is_null(request.transport))
+    {
+        error = request.error;
+        return null_ptr;
+    }
+
+    Channel* channel = new Channel(scheduler, core);
+    request.transport->bindProtocol(channel);
+    request.transport->initialize();
+    return channel;
+}
+
+bool Channel::read(void* buf, size_t len)
+{
+    while (available() < len)
+    {
+        if (disconnected_)
+            return false;
+        wait(_T("read"));
+    }
+
+    memcpy(buf, &in_[inStart_], len);
+    consumed(len);
+    return true;
+}
+
+bool Channel::readUntil(const char* delim, size_t delimLen, std::string& line, size_t maxLen)
+{
+    // ѾҹĲֲظ
+    size_t searched = 0;
+    for (;;)
+    {
+        size_t len = available();
+        if (len >= delimLen)
+        {
+            const char* begin = &in_[inStart_];
+            const char* end = begin + len;
+            const char* from = begin + searched;
+            const char* found = std::search(from, end, delim, delim + delimLen);
+            if (found != end)
+            {
+                size_t lineLen = found - begin + delimLen;
+                if (lineLen > maxLen)
+                    return false;
+
+                line.assign(begin, lineLen);
+                consumed(lineLen);
+                return true;
+            }
+            searched = len - delimLen + 1;
+        }
+
+        if (len >= maxLen || disconnected_)
+            return false;
+        wait(_T("readUntil"));
+    }
+}
+
+size_t Channel::readSome(void* buf, size_t len)
+{
+    while (0 == available())
+    {
+        if (disconnected_)
+            return 0;
+        wait(_T("readSome"));
+    }
+
+    if (len > available())
+        len = available();
+    memcpy(buf, &in_[inStart_], len);
+    consumed(len);
+    return len;
+}
+
+bool Channel::write(const void* data, size_t len)
+{
+    if (!isOpen())
+        return false;
+    if (0 == len)
+        return true;
+
+    databuffer_t* buffer = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + len, MemoryKind::Send);
+    buffer->chain.type = BUFFER_ELEMENT_MEMORY;
+    buffer->capacity = len;
+    buffer->start = buffer->ptr;
+    buffer->end = buffer->ptr + len;
+    memcpy(buffer->ptr, data, len);
+
+    transport_->write(cast_to_buffer_chain(buffer));
+    return true;
+}
+
+void Channel::close()
+{
+    if (isOpen())
+        transport_->disconnection();
+}
+
+void Channel::release()
+{
+    released_ = true;
+    if (disconnected_ || !connected_)
+    {
+        delete this;
+        return;
+    }
+
+    // ӶϿʱɾ
+    transport_->disconnection();
+}
+
+bool Channel::isOpen() const
+{
+    return connected_ && !disconnected_;
+}
+
+size_t Channel::available() const
+{
+    return in_.size() - inStart_;
+}
+
+IReactorCore* Channel::core()
+{
+    return core_;
+}
+
+ITransport* Channel::transport()
+{
+    return transport_;
+}
+
+void Channel::onTimeout(ProtocolContext& context)
+{
+}
+
+void Channel::onConnected(ProtocolContext& context)
+{
+    transport_ = &(context.transport());
+    connected_ = true;
+    toString_ = concat<tstring>(_T("Channel["), transport_->toString(), _T("]"));
+
+    if (!is_null(starter_))
+    {
+        Coroutine* coroutine = starter_;
+        starter_ = null_ptr;
+        scheduler_->spawn(coroutine);
+    }
+}
+
+void Channel::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+{
+    disconnected_ = true;
+    if (released_)
+    {
+        delete this;
+        return;
+    }
+
+    if (!is_null(waiter_))
+        scheduler_->wake(waiter_);
+}
+
+size_t Channel::onReceived(ProtocolContext& context)
+{
+    if (released_)
+        return context.inBytes();
+
+    const std::vector<io_mem_buf>& segments = context.inMemory();
+    for (std::vector<io_mem_buf>::const_iterator it = segments.begin(); it != segments.end(); ++ it)
+        in_.insert(in_.end(), it->buf, it->buf + it->len);
+    inCharge_.update(in_.capacity());
+
+    if (!paused_ && available() >= MAX_BACKLOG)
+    {
+        paused_ = true;
+        transport_->stopReading();
+    }
+
+    if (!is_null(waiter_))
+        scheduler_->wake(waiter_);
+    return context.inBytes();
+}
+
+databuffer_t* Channel::createBuffer(const ProtocolContext& context)
+{
+    databuffer_t* result = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + RECEIVE_SIZE, MemoryKind::Receive);
+    result->chain.type = BUFFER_ELEMENT_MEMORY;
+    result->capacity = RECEIVE_SIZE;
+    result->start = result->end = result->ptr;
+    return result;
+}
+
+size_t Channel::memory() const
+{
+    return inCharge_.bytes();
+}
+
+const tstring& Channel::toString() const
+{
+    return toString_;
+}
+
+void Channel::wait(const tchar* reason)
+{
+    Coroutine* coroutine = scheduler_->current();
+    if (is_null(coroutine))
+        ThrowException1(RuntimeException, _T("ֻЭжȡ Channel"));
+
+    waiter_ = coroutine;
+    coroutine->suspend(reason);
+    waiter_ = null_ptr;
+}
+
+void Channel::consumed(size_t len)
+{
+    inStart_ += len;
+    if (inStart_ == in_.size())
+    {
+        in_.clear();
+        inStart_ = 0;
+    }
+    else if (inStart_ * 2 >= in_.size())
+    {
+        in_.erase(in_.begin(), in_.begin() + inStart_);
+        inStart_ = 0;
+    }
+
+    if (paused_ && available() < MAX_BACKLOG / 2 && isOpen())
+    {
+        paused_ = false;
+        transport_->startReading();
+    }
+}
+
+CoroutineProtocolFactory::CoroutineProtocolFactory(CoroutineScheduler* scheduler, const tstring& name)
+        : scheduler_(scheduler)
+        , tracing_(false)
+        , toString_(name)
+{
+    if (is_null(scheduler))
+        ThrowException1(ArgumentNullException, _T("scheduler"));
+}
+
+CoroutineProtocolFactory::~CoroutineProtocolFactory()
+{
+}
+
+IProtocol* CoroutineProtocolFactory::createProtocol(ITransport* transport, IReactorCore* core)
+{
+    // ƬϵҪڷƬԼĵ
+    CoroutineScheduler* scheduler = is_null(core) ? scheduler_ : &(core->coroutines());
+
+    Channel* channel = new Channel(scheduler, core);
+    Coroutine* session = createSession(channel);
+    session->trace(tracing_);
+    channel->startOnConnected(session);
+    return channel;
+}
+
+bool CoroutineProtocolFactory::configure(configure::Context& context, const tstring& t)
+{
+    StringArray<tstring::value_type> sa = split(t.c_str()
+                                          , _T(" \t")
+                                          , StringSplitOptions::RemoveEmptyEntries);
+
+    if (0 == sa.size())
+        return true;
+
+    if (0 != string_traits<tstring::value_type>::stricmp(_T("trace"), sa.ptr(0)))
+        return false;
+
+    if (2 == sa.size() && 0 == string_traits<tstring::value_type>::stricmp(_T("on"), sa.ptr(1)))
+        tracing_ = true;
+    else if (2 == sa.size() && 0 == string_traits<tstring::value_type>::stricmp(_T("off"), sa.ptr(1)))
+        tracing_ = false;
+    else
+    {
+        LOG_FATAL(context.logger(), _T(" 'trace' ʽȷ"));
+        context.exit();
+    }
+    return true;
+}
+
+const tstring& CoroutineProtocolFactory::toString() const
+{
+    return toString_;
+}
+
+_jingxian_end
@@ -0,0 +1,209 @@
+
+#ifndef _Channel_H_
+#define _Channel_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/ITransport.h"
+# include "jingxian/IProtocol.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/coroutine/Coroutine.h"
+
+_jingxian_begin
+
+class IReactorCore;
+
+/**
+ * Эʹõ, ϵ¼ɿԵȴĶд
+ *
+ *  ITransport  IProtocol, յȷԼĻ, ڵȴ
+ * ݵЭݹʱ. еݳ MAX_BACKLOG ʱͣ
+ * ȡ, Эȡߺټ. еĶдֻЭе.
+ *
+ * Э̲ʹʱ release(), ӶϿԶɾ.
+ */
+class Channel : public IProtocol
+{
+public:
+    Channel(CoroutineScheduler* scheduler, IReactorCore* core);
+
+    virtual ~Channel();
+
+    /**
+     * ӽʱ coroutine, ڽܵ
+     */
+    void startOnConnected(Coroutine* coroutine);
+
+    /**
+     * ӵ endPoint, ɹʱµ Channel, ʧʱ null_ptr 
+     *  error иԭ
+     * @remarks ֻЭе
+     */
+    static Channel* connect(CoroutineScheduler* scheduler
+                            , IReactorCore* core
+                            , const tstring& endPoint
+                            , tstring& error);
+
+    /**
+     * ȡ len ֽ
+     * @return ڶ֮ǰϿʱ false
+     */
+    bool read(void* buf, size_t len);
+
+    /**
+     *  delim Ϊֹ, delim  line 
+     * @param[ in ] maxLen line 󳤶
+     * @return ӶϿ򳬹 maxLen ʱ false
+     */
+    bool readUntil(const char* delim, size_t delimLen, std::string& line, size_t maxLen);
+
+    /**
+     * ȡѾ, ûʱȴ
+     * @return ֽ, ӶϿʱ 0
+     */
+    size_t readSome(void* buf, size_t len);
+
+    /**
+     * , ݽӺ
+     * @return ѾϿʱ false
+     */
+    bool write(const void* data, size_t len);
+
+    /**
+     * Ͽ
+     */
+    void close();
+
+    /**
+     * Э̲ʹñ
+     */
+    void release();
+
+    bool isOpen() const;
+
+    /**
+     * лûжȡֽ
+     */
+    size_t available() const;
+
+    IReactorCore* core();
+
+    ITransport* transport();
+
+    /**
+     * @implements onTimeout
+     */
+    virtual void onTimeout(ProtocolContext& context);
+
+    /**
+     * @implements onConnected
+     */
+    virtual void onConnected(ProtocolContext& context);
+
+    /**
+     * @implements onDisconnected
+     */
+    virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason);
+
+    /**
+     * @implements onReceived
+     */
+    virtual size_t onReceived(ProtocolContext& context);
+
+    /**
+     * @implements createBuffer
+     */
+    virtual databuffer_t* createBuffer(const ProtocolContext& context);
+
+    /**
+     * @implements memory
+     */
+    virtual size_t memory() const;
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+    /// еݳʱͣȡ
+    enum { MAX_BACKLOG = 256*1024 };
+
+private:
+    NOCOPY(Channel);
+
+    void wait(const tchar* reason);
+    void consumed(size_t len);
+
+    CoroutineScheduler* scheduler_;
+    IReactorCore* core_;
+    ITransport* transport_;
+    /// ӽʱЭ
+    Coroutine* starter_;
+    /// ڵȴӵЭ
+    Coroutine* waiter_;
+
+    std::vector<char> in_;
+    size_t inStart_;
+    /// in_ ռõڴ
+    MemoryCharge inCharge_;
+
+    bool connected_;
+    bool disconnected_;
+    bool released_;
+    bool paused_;
+
+    tstring toString_;
+};
+
+/**
+ * ΪÿܵһЭ̵Э鹤
+ *
+ * ʵ createSession(), дӵЭ.
+ */
+class CoroutineProtocolFactory : public IProtocolFactory
+{
+public:
+    CoroutineProtocolFactory(CoroutineScheduler* scheduler, const tstring& name);
+
+    virtual ~CoroutineProtocolFactory();
+
+    /**
+     * ΪһӴЭ, Э̽ʱ channel->release()
+     */
+    virtual Coroutine* createSession(Channel* channel) = 0;
+
+    /**
+     * @implements createProtocol
+     */
+    virtual IProtocol* createProtocol(ITransport* transport, IReactorCore* core);
+
+    /**
+     * ֧ "trace on|off", ٱЭЭ̵л
+     * @implements configure
+     */
+    virtual bool configure(configure::Context& context, const tstring& t);
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+protected:
+    CoroutineScheduler* scheduler_;
+    bool tracing_;
+
+private:
+    NOCOPY(CoroutineProtocolFactory);
+
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_Channel_H_
@@ -0,0 +1,366 @@
+
+# include "pro_config.h"
+# include <algorithm>
+# include "jingxian/exception.h"
+# include "jingxian/coroutine/Coroutine.h"
+
+_jingxian_begin
+
+Coroutine::Coroutine(const tstring& name)
+        : scheduler_(null_ptr)
+        , worker_(null_ptr)
+        , state_(CoroutineState::created)
+        , woken_(false)
+        , queued_(false)
+        , tracing_(false)
+        , waitingFor_(null_ptr)
+        , switches_(0)
+        , suspendedAt_(0)
+        , id_(0)
+        , toString_(name)
+{
+    sleepTimer_.owner_ = this;
+}
+
+Coroutine::~Coroutine()
+{
+    if (sleepTimer_.isScheduled())
+        scheduler_->timers()->cancel(&sleepTimer_);
+}
+
+void Coroutine::onExit()
+{
+}
+
+void Coroutine::suspend(const tchar* reason)
+{
+    if (is_null(scheduler_) || this != scheduler_->current())
+        ThrowException1(RuntimeException, _T("ֻЭԼй"));
+
+    scheduler_->suspend(this, reason);
+}
+
+void Coroutine::sleep(uint32_t milliseconds)
+{
+    if (is_null(scheduler_) || is_null(scheduler_->timers()))
+        ThrowException1(RuntimeException, _T("Э̵ûжʱ"));
+
+    sleepTimer_.expired_ = false;
+    scheduler_->timers()->schedule(&sleepTimer_, milliseconds);
+    while (!sleepTimer_.expired_)
+        suspend(_T("sleep"));
+}
+
+void Coroutine::SleepTimer::onTimeout()
+{
+    expired_ = true;
+    owner_->scheduler_->wake(owner_);
+}
+
+void Coroutine::trace(bool enabled)
+{
+    tracing_ = enabled;
+}
+
+bool Coroutine::isTracing() const
+{
+    return tracing_;
+}
+
+CoroutineState::type Coroutine::state() const
+{
+    return state_;
+}
+
+const tchar* Coroutine::waitingFor() const
+{
+    return waitingFor_;
+}
+
+uint64_t Coroutine::switches() const
+{
+    return switches_;
+}
+
+CoroutineScheduler* Coroutine::scheduler()
+{
+    return scheduler_;
+}
+
+uint32_t Coroutine::id() const
+{
+    return id_;
+}
+
+const tstring& Coroutine::toString() const
+{
+    return toString_;
+}
+
+CoroutineScheduler::Worker::Worker(CoroutineScheduler* owner, size_t stackSize)
+        : owner_(owner)
+        , coroutine_(null_ptr)
+        , fiber_(stackSize, &Worker::main, this)
+{
+}
+
+void CoroutineScheduler::Worker::main(void* context)
+{
+    Worker* self = (Worker*)context;
+    for (;;)
+    {
+        Coroutine* coroutine = self->coroutine_;
+        try
+        {
+            coroutine->run();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR(self->owner_->logger_, _T("Э ") << coroutine->toString()
+                      << _T("[") << coroutine->id() << _T("] 쳣 - ") << e.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR(self->owner_->logger_, _T("Э ") << coroutine->toString()
+                      << _T("[") << coroutine->id() << _T("] δ֪쳣"));
+        }
+
+        // ˳̲ܷ, ص¼ѭȴһЭ
+        coroutine->state_ = CoroutineState::finished;
+        self->coroutine_ = null_ptr;
+        Fiber::switchTo(self->fiber_, *self->owner_->main_);
+    }
+}
+
+CoroutineScheduler::CoroutineScheduler(TimerQueue* timers)
+        : timers_(timers)
+        , current_(null_ptr)
+        , stackSize_(64*1024)
+        , maxPooled_(256)
+        , nextId_(0)
+        , logger_(_T("jingxian.coroutine"))
+        , toString_(_T("CoroutineScheduler"))
+{
+    stats_.spawned = 0;
+    stats_.alive = 0;
+    stats_.fibers = 0;
+    stats_.pooled = 0;
+    stats_.switches = 0;
+}
+
+CoroutineScheduler::~CoroutineScheduler()
+{
+    if (0 != stats_.alive)
+        LOG_WARN(logger_, _T(" ") << stats_.alive << _T(" Эûн, ǵջᱻͷ"));
+
+    for (std::vector<Worker*>::iterator it = pool_.begin(); it != pool_.end(); ++ it)
+        delete *it;
+    pool_.clear();
+}
+
+void CoroutineScheduler::stackSize(size_t bytes)
+{
+    stackSize_ = bytes;
+}
+
+size_t CoroutineScheduler::stackSize() const
+{
+    return stackSize_;
+}
+
+void CoroutineScheduler::maxPooled(size_t count)
+{
+    maxPooled_ = count;
+    while (pool_.size() > maxPooled_)
+    {
+        delete pool_.back();
+        pool_.pop_back();
+        -- stats_.fibers;
+    }
+    stats_.pooled = pool_.size();
+}
+
+size_t CoroutineScheduler::maxPooled() const
+{
+    return maxPooled_;
+}
+
+void CoroutineScheduler::spawn(Coroutine* coroutine)
+{
+    if (is_null(coroutine))
+        ThrowException1(ArgumentNullException, _T("coroutine"));
+    if (CoroutineState::created != coroutine->state_)
+        ThrowException1(RuntimeException, _T("ЭѾ"));
+
+    coroutine->scheduler_ = this;
+    coroutine->id_ = ++ nextId_;
+    ++ stats_.spawned;
+    ++ stats_.alive;
+
+    if (coroutine->tracing_)
+        LOG_INFO(logger_, _T("Э ") << coroutine->toString() << _T("[") << coroutine->id_ << _T("] "));
+
+    wake(coroutine);
+}
+
+void CoroutineScheduler::wake(Coroutine* coroutine)
+{
+    if (CoroutineState::finished == coroutine->state_)
+        return;
+
+    if (coroutine == current_)
+    {
+        coroutine->woken_ = true;
+        return;
+    }
+
+    // ڱЭ, ص¼ѭл
+    if (!is_null(current_))
+    {
+        if (!coroutine->queued_)
+        {
+            coroutine->queued_ = true;
+            ready_.push_back(coroutine);
+        }
+        return;
+    }
+
+    resume(coroutine);
+    dispatch();
+}
+
+Coroutine* CoroutineScheduler::current()
+{
+    return current_;
+}
+
+size_t CoroutineScheduler::stackCommitted() const
+{
+    if (is_null(current_))
+        ThrowException1(RuntimeException, _T("Э"));
+
+    return ((Worker*)current_->worker_)->fiber_.stackCommitted();
+}
+
+TimerQueue* CoroutineScheduler::timers()
+{
+    return timers_;
+}
+
+const CoroutineScheduler::Stats& CoroutineScheduler::stats() const
+{
+    return stats_;
+}
+
+const tstring& CoroutineScheduler::toString() const
+{
+    return toString_;
+}
+
+void CoroutineScheduler::resume(Coroutine* coroutine)
+{
+    if (is_null(main_.get()))
+        main_.reset(new Fiber());
+
+    if (is_null(coroutine->worker_))
+    {
+        Worker* worker = acquire();
+        worker->coroutine_ = coroutine;
+        coroutine->worker_ = worker;
+    }
+
+    if (coroutine->tracing_ && CoroutineState::suspended == coroutine->state_)
+        LOG_INFO(logger_, _T("Э ") << coroutine->toString() << _T("[") << coroutine->id_
+                 << _T("] ָ, ȴ ") << coroutine->waitingFor_ << _T("  ")
+                 << (is_null(timers_) ? 0 : timers_->now() - coroutine->suspendedAt_) << _T(" "));
+
+    coroutine->state_ = CoroutineState::running;
+    ++ coroutine->switches_;
+    ++ stats_.switches;
+    current_ = coroutine;
+
+    Fiber::switchTo(*main_, ((Worker*)coroutine->worker_)->fiber_);
+
+    current_ = null_ptr;
+    if (CoroutineState::finished != coroutine->state_)
+        return;
+
+    release((Worker*)coroutine->worker_);
+    coroutine->worker_ = null_ptr;
+    -- stats_.alive;
+
+    if (coroutine->queued_)
+    {
+        ready_.erase(std::find(ready_.begin(), ready_.end(), coroutine));
+        coroutine->queued_ = false;
+    }
+
+    if (coroutine->tracing_)
+        LOG_INFO(logger_, _T("Э ") << coroutine->toString() << _T("[") << coroutine->id_
+                 << _T("] , л ") << coroutine->switches_ << _T(" "));
+
+    coroutine->onExit();
+}
+
+void CoroutineScheduler::suspend(Coroutine* coroutine, const tchar* reason)
+{
+    if (coroutine->woken_)
+    {
+        coroutine->woken_ = false;
+        return;
+    }
+
+    coroutine->state_ = CoroutineState::suspended;
+    coroutine->waitingFor_ = reason;
+    if (!is_null(timers_))
+        coroutine->suspendedAt_ = timers_->now();
+
+    if (coroutine->tracing_)
+        LOG_INFO(logger_, _T("Э ") << coroutine->toString() << _T("[") << coroutine->id_
+                 << _T("] , ȴ ") << reason);
+
+    Fiber::switchTo(((Worker*)coroutine->worker_)->fiber_, *main_);
+    coroutine->waitingFor_ = null_ptr;
+}
+
+void CoroutineScheduler::dispatch()
+{
+    while (!ready_.empty())
+    {
+        Coroutine* coroutine = ready_.front();
+        ready_.pop_front();
+        coroutine->queued_ = false;
+        resume(coroutine);
+    }
+}
+
+CoroutineScheduler::Worker* CoroutineScheduler::acquire()
+{
+    if (!pool_.empty())
+    {
+        Worker* worker = pool_.back();
+        pool_.pop_back();
+        stats_.pooled = pool_.size();
+        return worker;
+    }
+
+    Worker* worker = new Worker(this, stackSize_);
+    ++ stats_.fibers;
+    return worker;
+}
+
+void CoroutineScheduler::release(Worker* worker)
+{
+    // ջСĹ˵˳̲ٷŻس
+    if (pool_.size() < maxPooled_ && worker->fiber_.stackSize() >= stackSize_)
+    {
+        pool_.push_back(worker);
+        stats_.pooled = pool_.size();
+        return;
+    }
+
+    delete worker;
+    -- stats_.fibers;
+}
+
+_jingxian_end
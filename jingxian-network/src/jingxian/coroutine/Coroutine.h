@@ -0,0 +1,250 @@
+
+#ifndef _Coroutine_H_
+#define _Coroutine_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <deque>
+# include <memory>
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/coroutine/Fiber.h"
+# include "jingxian/networks/TimerQueue.h"
+
+_jingxian_begin
+
+class CoroutineScheduler;
+
+namespace CoroutineState
+{
+enum type
+{
+    /// Ѵ, ûпʼ
+    created,
+    /// 
+    running,
+    /// ڵȴĳ¼
+    suspended,
+    /// run() Ѿ
+    finished
+};
+}
+
+/**
+ * ԼջЭ, дһ˳дЭ
+ *
+ * ʵ run(), е suspend() ȴ¼, ¼ʱɱ˵
+ * CoroutineScheduler::wake() . ѿǶ, Եȴд
+ *
+ *   while (!) suspend(_T("ԭ"));
+ *
+ * run() غ¼ѭе onExit(), ɾ.
+ */
+class Coroutine
+{
+public:
+    Coroutine(const tstring& name);
+
+    virtual ~Coroutine();
+
+    /**
+     * Э̵
+     */
+    virtual void run() = 0;
+
+    /**
+     * run() غ󱻵, ʱѾЭ̵ջ
+     */
+    virtual void onExit();
+
+    /**
+     * Э, ֱ
+     * @param[ in ] reason ȴԭ, ڸ
+     * @remarks ֻڱЭе
+     */
+    void suspend(const tchar* reason);
+
+    /**
+     *  milliseconds 
+     * @remarks ֻڱЭе
+     */
+    void sleep(uint32_t milliseconds);
+
+    /**
+     * ǷЭ̵л
+     */
+    void trace(bool enabled);
+
+    bool isTracing() const;
+
+    CoroutineState::type state() const;
+
+    /**
+     * ڵȴԭ
+     */
+    const tchar* waitingFor() const;
+
+    /**
+     * лĴ
+     */
+    uint64_t switches() const;
+
+    CoroutineScheduler* scheduler();
+
+    uint32_t id() const;
+
+    const tstring& toString() const;
+
+private:
+    NOCOPY(Coroutine);
+    friend class CoroutineScheduler;
+
+    class SleepTimer : public Timer
+    {
+    public:
+        SleepTimer()
+                : owner_(null_ptr)
+                , expired_(false)
+        {
+        }
+
+        virtual void onTimeout();
+
+        Coroutine* owner_;
+        bool expired_;
+    };
+
+    CoroutineScheduler* scheduler_;
+    /// бЭ̵˳, ڼӳȡ
+    void* worker_;
+    CoroutineState::type state_;
+    /// ڼ䱻, һ suspend() ֱӷ
+    bool woken_;
+    /// ھ
+    bool queued_;
+    bool tracing_;
+    const tchar* waitingFor_;
+    uint64_t switches_;
+    /// ʱʱ, ڸٵȴ˶
+    uint64_t suspendedAt_;
+    SleepTimer sleepTimer_;
+    uint32_t id_;
+    tstring toString_;
+};
+
+/**
+ * ¼ѭ߳еЭ̵, ֻ¼ѭ߳ʹ
+ *
+ * Эڳе˳, run() غ˳̻صиһЭʹ, 
+ * ƵϿʱ÷ջ. ЭдĻȷ,
+ * ص¼ѭĺлȥ, Э֮䲻ֱл.
+ */
+class CoroutineScheduler
+{
+public:
+    struct Stats
+    {
+        /// Э
+        uint64_t spawned;
+        /// ûнЭ
+        size_t alive;
+        /// ˳
+        size_t fibers;
+        /// пе˳
+        size_t pooled;
+        /// лܴ
+        uint64_t switches;
+    };
+
+    /**
+     * @param[ in ] timers Э sleep() õĶʱ, Ϊ
+     */
+    CoroutineScheduler(TimerQueue* timers);
+
+    ~CoroutineScheduler();
+
+    /**
+     * ÿЭ̵ջС, ֻӰԺ󴴽˳
+     */
+    void stackSize(size_t bytes);
+
+    size_t stackSize() const;
+
+    /**
+     * ౣĿ˳
+     */
+    void maxPooled(size_t count);
+
+    size_t maxPooled() const;
+
+    /**
+     * һЭ, ¼ѭеʱеһι
+     */
+    void spawn(Coroutine* coroutine);
+
+    /**
+     * һЭ
+     */
+    void wake(Coroutine* coroutine);
+
+    /**
+     * еЭ, ¼ѭʱΪ
+     */
+    Coroutine* current();
+
+    /**
+     * ǰЭ̵ջѾռڴֽ
+     * @remarks ֻЭе
+     */
+    size_t stackCommitted() const;
+
+    TimerQueue* timers();
+
+    const Stats& stats() const;
+
+    const tstring& toString() const;
+
+private:
+    NOCOPY(CoroutineScheduler);
+    friend class Coroutine;
+
+    struct Worker
+    {
+        Worker(CoroutineScheduler* owner, size_t stackSize);
+
+        static void main(void* context);
+
+        CoroutineScheduler* owner_;
+        Coroutine* coroutine_;
+        Fiber fiber_;
+    };
+
+    void resume(Coroutine* coroutine);
+    void suspend(Coroutine* coroutine, const tchar* reason);
+    void dispatch();
+    Worker* acquire();
+    void release(Worker* worker);
+
+    TimerQueue* timers_;
+    /// ¼ѭ, һлʱת
+    std::auto_ptr<Fiber> main_;
+    Coroutine* current_;
+    std::deque<Coroutine*> ready_;
+    std::vector<Worker*> pool_;
+    size_t stackSize_;
+    size_t maxPooled_;
+    uint32_t nextId_;
+    Stats stats_;
+    logging::logger logger_;
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_Coroutine_H_
@@ -0,0 +1,768 @@
+
+# include "pro_config.h"
+# include "jingxian/IReactorCore.h"
+# include "jingxian/coroutine/Coroutine.h"
+# include "jingxian/coroutine/Channel.h"
+# include "jingxian/networks/LoopbackTransport.h"
+
+#ifdef _GOOGLETEST_
+#include <gtest/gtest.h>
+#else
+#include "jingxian/utilities/unittest.h"
+#endif
+
+namespace
+{
+    class Counter : public Coroutine
+    {
+    public:
+        Counter(int rounds)
+                : Coroutine(_T("Counter"))
+                , rounds(rounds)
+                , steps(0)
+                , exited(false)
+        {
+        }
+
+        virtual void run()
+        {
+            for (int i = 0; i < rounds; ++ i)
+            {
+                ++ steps;
+                suspend(_T("test"));
+            }
+        }
+
+        virtual void onExit()
+        {
+            exited = true;
+        }
+
+        int rounds;
+        int steps;
+        bool exited;
+    };
+
+    /**
+     * л,  "quit\r\n" ʱϿ
+     */
+    class LineSession : public Coroutine
+    {
+    public:
+        LineSession(Channel* channel)
+                : Coroutine(_T("LineSession"))
+                , channel_(channel)
+                , lines(0)
+                , exited(false)
+        {
+        }
+
+        virtual void run()
+        {
+            std::string line;
+            while (channel_->readUntil("\r\n", 2, line, 1024))
+            {
+                ++ lines;
+                if ("quit\r\n" == line)
+                {
+                    channel_->close();
+                    return;
+                }
+                channel_->write(line.data(), line.size());
+            }
+        }
+
+        virtual void onExit()
+        {
+            exited = true;
+            channel_->release();
+        }
+
+        Channel* channel_;
+        int lines;
+        bool exited;
+    };
+
+    /**
+     * ȶһ 4 ֽڵĳ, ٶô
+     */
+    class FrameSession : public Coroutine
+    {
+    public:
+        FrameSession(Channel* channel)
+                : Coroutine(_T("FrameSession"))
+                , channel_(channel)
+                , ok(false)
+        {
+        }
+
+        virtual void run()
+        {
+            uint32_t len = 0;
+            if (!channel_->read(&len, sizeof(len)))
+                return;
+            body.resize(len);
+            ok = channel_->read(&body[0], len);
+        }
+
+        virtual void onExit()
+        {
+            channel_->release();
+        }
+
+        Channel* channel_;
+        std::string body;
+        bool ok;
+    };
+
+    class EchoSession : public Coroutine
+    {
+    public:
+        EchoSession(Channel* channel)
+                : Coroutine(_T("EchoSession"))
+                , channel_(channel)
+                , committed(0)
+        {
+        }
+
+        virtual void run()
+        {
+            char buf[4096];
+            for (;;)
+            {
+                size_t len = channel_->readSome(buf, sizeof(buf));
+                if (0 == committed)
+                    committed = scheduler()->stackCommitted();
+                if (0 == len || !channel_->write(buf, len))
+                    return;
+            }
+        }
+
+        virtual void onExit()
+        {
+            channel_->release();
+        }
+
+        Channel* channel_;
+        size_t committed;
+    };
+
+    /**
+     * ͬܵĻصЭ, ڶԱ
+     */
+    class CallbackEchoProtocol : public IProtocol
+    {
+    public:
+        CallbackEchoProtocol()
+                : name_(_T("CallbackEchoProtocol"))
+        {
+        }
+
+        virtual void onTimeout(ProtocolContext& context)
+        {
+        }
+
+        virtual void onConnected(ProtocolContext& context)
+        {
+        }
+
+        virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+        {
+        }
+
+        virtual size_t onReceived(ProtocolContext& context)
+        {
+            size_t len = context.inBytes();
+            databuffer_t* buffer = (databuffer_t*)my_calloc(1, sizeof(databuffer_t) + len);
+            buffer->chain.type = BUFFER_ELEMENT_MEMORY;
+            buffer->capacity = len;
+            buffer->start = buffer->ptr;
+            buffer->end = buffer->ptr + len;
+
+            const std::vector<io_mem_buf>& segments = context.inMemory();
+            char* ptr = buffer->ptr;
+            for (std::vector<io_mem_buf>::const_iterator it = segments.begin(); it != segments.end(); ++ it)
+            {
+                memcpy(ptr, it->buf, it->len);
+                ptr += it->len;
+            }
+
+            context.transport().write(cast_to_buffer_chain(buffer));
+            return len;
+        }
+
+        virtual databuffer_t* createBuffer(const ProtocolContext& context)
+        {
+            return null_ptr;
+        }
+
+        virtual const tstring& toString() const
+        {
+            return name_;
+        }
+
+    private:
+        tstring name_;
+    };
+
+    /**
+     * ֻʵ connectWith  IReactorCore,  pending ֵԺ
+     */
+    class ConnectOnlyCore : public IReactorCore
+    {
+    public:
+        ConnectOnlyCore()
+                : pending(false)
+                , fail(false)
+                , onComplete_(null_ptr)
+                , onError_(null_ptr)
+                , context_(null_ptr)
+                , name_(_T("ConnectOnlyCore"))
+        {
+        }
+
+        virtual bool send(IRunnable* runnable)
+        {
+            return false;
+        }
+
+        virtual void connectWith(const tchar* endPoint
+                                 , OnBuildConnectionComplete onComplete
+                                 , OnBuildConnectionError onError
+                                 , void* context)
+        {
+            endPoint_ = endPoint;
+            onComplete_ = onComplete;
+            onError_ = onError;
+            context_ = context;
+            if (!pending)
+                complete();
+        }
+
+        virtual bool listenWith(const tchar* endPoint, IProtocolFactory* protocolFactory)
+        {
+            return false;
+        }
+
+        virtual void connectWith(const Endpoint& endPoint
+                                 , OnBuildConnectionComplete onComplete
+                                 , OnBuildConnectionError onError
+                                 , void* context)
+        {
+            ThrowException(NotImplementedException);
+        }
+
+        virtual bool listenWith(const Endpoint& endPoint, IProtocolFactory* protocolFactory)
+        {
+            return false;
+        }
+
+        virtual void runForever()
+        {
+        }
+
+        virtual void interrupt()
+        {
+        }
+
+        virtual bool isRunning() const
+        {
+            return true;
+        }
+
+        virtual bool bind(HANDLE systemHandler, void* completion_key)
+        {
+            return false;
+        }
+
+        virtual IDNSResolver& resolver()
+        {
+            ThrowException(NotImplementedException);
+        }
+
+        virtual IExecutor& executor()
+        {
+            ThrowException(NotImplementedException);
+        }
+
+        virtual TimerQueue& timers()
+        {
+            ThrowException(NotImplementedException);
+        }
+
+        virtual CoroutineScheduler& coroutines()
+        {
+            ThrowException(NotImplementedException);
+        }
+
+        virtual const tstring& toString() const
+        {
+            return name_;
+        }
+
+        void complete()
+        {
+            if (fail)
+                onError_(ErrorCode(_T("refused")), context_);
+            else
+                onComplete_(&transport, context_);
+        }
+
+        bool pending;
+        bool fail;
+        tstring endPoint_;
+        LoopbackTransport transport;
+
+    private:
+        OnBuildConnectionComplete onComplete_;
+        OnBuildConnectionError onError_;
+        void* context_;
+        tstring name_;
+    };
+
+    class Client : public Coroutine
+    {
+    public:
+        Client(ConnectOnlyCore* core)
+                : Coroutine(_T("Client"))
+                , core_(core)
+                , connected(false)
+        {
+        }
+
+        virtual void run()
+        {
+            Channel* channel = Channel::connect(scheduler(), core_, _T("tcp://127.0.0.1:7"), error);
+            if (is_null(channel))
+                return;
+
+            connected = true;
+            channel->write("ping", 4);
+            char buf[4];
+            if (channel->read(buf, sizeof(buf)))
+                reply.assign(buf, sizeof(buf));
+            channel->release();
+        }
+
+        ConnectOnlyCore* core_;
+        bool connected;
+        tstring error;
+        std::string reply;
+    };
+
+    class Sleeper : public Coroutine
+    {
+    public:
+        Sleeper()
+                : Coroutine(_T("Sleeper"))
+                , done(false)
+        {
+        }
+
+        virtual void run()
+        {
+            sleep(5);
+            done = true;
+        }
+
+        bool done;
+    };
+
+    class Thrower : public Coroutine
+    {
+    public:
+        Thrower()
+                : Coroutine(_T("Thrower"))
+                , exited(false)
+        {
+        }
+
+        virtual void run()
+        {
+            ThrowException1(RuntimeException, _T("test"));
+        }
+
+        virtual void onExit()
+        {
+            exited = true;
+        }
+
+        bool exited;
+    };
+
+    /**
+     * һЭ, ҪȱЭ̹
+     */
+    class Waker : public Coroutine
+    {
+    public:
+        Waker(Coroutine* target, std::vector<int>& order)
+                : Coroutine(_T("Waker"))
+                , target_(target)
+                , order_(order)
+        {
+        }
+
+        virtual void run()
+        {
+            order_.push_back(1);
+            scheduler()->wake(target_);
+            order_.push_back(2);
+
+            // Լʱһιֱӷ
+            scheduler()->wake(this);
+            suspend(_T("self"));
+            order_.push_back(3);
+        }
+
+        Coroutine* target_;
+        std::vector<int>& order_;
+    };
+
+    class Recorder : public Coroutine
+    {
+    public:
+        Recorder(std::vector<int>& order)
+                : Coroutine(_T("Recorder"))
+                , order_(order)
+        {
+        }
+
+        virtual void run()
+        {
+            suspend(_T("test"));
+            order_.push_back(4);
+        }
+
+        std::vector<int>& order_;
+    };
+}
+
+TEST(coroutine, suspendAndWake)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    Counter counter(3);
+    scheduler.spawn(&counter);
+    ASSERT_TRUE(1 == counter.steps);
+    ASSERT_TRUE(CoroutineState::suspended == counter.state());
+    ASSERT_TRUE(0 == tstring(_T("test")).compare(counter.waitingFor()));
+    ASSERT_TRUE(is_null(scheduler.current()));
+
+    scheduler.wake(&counter);
+    scheduler.wake(&counter);
+    ASSERT_TRUE(3 == counter.steps);
+    ASSERT_FALSE(counter.exited);
+
+    scheduler.wake(&counter);
+    ASSERT_TRUE(counter.exited);
+    ASSERT_TRUE(CoroutineState::finished == counter.state());
+    ASSERT_TRUE(4 == counter.switches());
+    ASSERT_TRUE(0 == scheduler.stats().alive);
+    ASSERT_TRUE(1 == scheduler.stats().pooled);
+
+    // ٻʲôҲ
+    scheduler.wake(&counter);
+    ASSERT_TRUE(4 == counter.switches());
+
+    // ˳̱һЭ
+    Counter next(1);
+    scheduler.spawn(&next);
+    ASSERT_TRUE(1 == scheduler.stats().fibers);
+    ASSERT_TRUE(0 == scheduler.stats().pooled);
+    scheduler.wake(&next);
+    ASSERT_TRUE(next.exited);
+    ASSERT_TRUE(2 == scheduler.stats().spawned);
+}
+
+TEST(coroutine, wakeInsideCoroutine)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    std::vector<int> order;
+    Recorder recorder(order);
+    Waker waker(&recorder, order);
+    scheduler.spawn(&recorder);
+    scheduler.spawn(&waker);
+
+    ASSERT_TRUE(4 == order.size());
+    ASSERT_TRUE(1 == order[0] && 2 == order[1] && 3 == order[2] && 4 == order[3]);
+    ASSERT_TRUE(CoroutineState::finished == waker.state());
+    ASSERT_TRUE(CoroutineState::finished == recorder.state());
+    ASSERT_TRUE(2 == scheduler.stats().fibers);
+}
+
+TEST(coroutine, exception)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    Thrower thrower;
+    scheduler.spawn(&thrower);
+    ASSERT_TRUE(thrower.exited);
+    ASSERT_TRUE(0 == scheduler.stats().alive);
+    ASSERT_TRUE(1 == scheduler.stats().pooled);
+}
+
+TEST(coroutine, sleep)
+{
+    TimerQueue timers;
+    CoroutineScheduler scheduler(&timers);
+    Sleeper sleeper;
+    scheduler.spawn(&sleeper);
+    ASSERT_FALSE(sleeper.done);
+
+    uint64_t deadline = timers.now() + 2000;
+    while (!sleeper.done && timers.now() < deadline)
+    {
+        timers.runExpired();
+        ::Sleep(1);
+    }
+    ASSERT_TRUE(sleeper.done);
+}
+
+TEST(coroutine, readUntil)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    LoopbackTransport transport;
+    Channel* channel = new Channel(&scheduler, null_ptr);
+    LineSession session(channel);
+    channel->startOnConnected(&session);
+    transport.bindProtocol(channel);
+    transport.initialize();
+    ASSERT_TRUE(CoroutineState::suspended == session.state());
+
+    // һзּε, һε
+    transport.receive(std::string("hel"));
+    transport.receive(std::string("lo\r"));
+    ASSERT_TRUE(transport.wire.empty());
+    transport.receive(std::string("\nab\r\ncd\r\n"));
+    ASSERT_TRUE("hello\r\nab\r\ncd\r\n" == transport.wire);
+    ASSERT_TRUE(3 == session.lines);
+
+    transport.receive(std::string("quit\r\n"));
+    ASSERT_TRUE(session.exited);
+    ASSERT_TRUE(transport.disconnected);
+
+    // release() ӶϿʱɾ Channel
+    transport.closed();
+    ASSERT_TRUE(0 == scheduler.stats().alive);
+
+    // 
+    LoopbackTransport flood;
+    channel = new Channel(&scheduler, null_ptr);
+    LineSession second(channel);
+    channel->startOnConnected(&second);
+    flood.bindProtocol(channel);
+    flood.initialize();
+    flood.receive(std::string(600, 'a'));
+    ASSERT_FALSE(second.exited);
+    flood.receive(std::string(600, 'a') + "\r\n");
+    ASSERT_TRUE(second.exited);
+    ASSERT_TRUE(0 == second.lines);
+    ASSERT_TRUE(flood.disconnected);
+    flood.closed();
+}
+
+TEST(coroutine, readExact)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    LoopbackTransport transport;
+    Channel* channel = new Channel(&scheduler, null_ptr);
+    FrameSession session(channel);
+    channel->startOnConnected(&session);
+    transport.bindProtocol(channel);
+    transport.initialize();
+
+    uint32_t len = 10;
+    transport.receive((const char*)&len, 2);
+    transport.receive((const char*)&len + 2, 2);
+    transport.receive(std::string("01234"));
+    ASSERT_TRUE(CoroutineState::suspended == session.state());
+    transport.receive(std::string("56789"));
+    ASSERT_TRUE(session.ok);
+    ASSERT_TRUE("0123456789" == session.body);
+    transport.closed();
+
+    // ֮ǰӶϿ
+    LoopbackTransport broken;
+    channel = new Channel(&scheduler, null_ptr);
+    FrameSession second(channel);
+    channel->startOnConnected(&second);
+    broken.bindProtocol(channel);
+    broken.initialize();
+    broken.receive((const char*)&len, sizeof(len));
+    broken.receive(std::string("012"));
+    broken.closed();
+    ASSERT_FALSE(second.ok);
+    ASSERT_TRUE(CoroutineState::finished == second.state());
+}
+
+TEST(coroutine, backlog)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    LoopbackTransport transport;
+    Channel* channel = new Channel(&scheduler, null_ptr);
+    FrameSession session(channel);
+    channel->startOnConnected(&session);
+    transport.bindProtocol(channel);
+    transport.initialize();
+
+    // ЭҪݱ MAX_BACKLOG , չ MAX_BACKLOG ʱͣȡ
+    uint32_t len = Channel::MAX_BACKLOG * 2;
+    transport.receive((const char*)&len, sizeof(len));
+    std::string chunk(64 * 1024, 'x');
+    while (transport.reading && channel->available() < len)
+        transport.receive(chunk);
+    ASSERT_FALSE(transport.reading);
+    ASSERT_TRUE(channel->available() >= (size_t)Channel::MAX_BACKLOG);
+
+    transport.closed();
+}
+
+TEST(coroutine, connect)
+{
+    CoroutineScheduler scheduler(null_ptr);
+
+    // ص connectWith ֱӱ
+    ConnectOnlyCore core;
+    Client client(&core);
+    scheduler.spawn(&client);
+    ASSERT_TRUE(client.connected);
+    ASSERT_TRUE("ping" == core.transport.wire);
+    core.transport.receive(std::string("pong"));
+    ASSERT_TRUE("pong" == client.reply);
+    ASSERT_TRUE(CoroutineState::finished == client.state());
+    ASSERT_TRUE(core.transport.disconnected);
+    core.transport.closed();
+
+    // Ժ
+    ConnectOnlyCore later;
+    later.pending = true;
+    Client second(&later);
+    scheduler.spawn(&second);
+    ASSERT_TRUE(0 == tstring(_T("connect")).compare(second.waitingFor()));
+    later.complete();
+    ASSERT_TRUE(second.connected);
+    later.transport.closed();
+    ASSERT_TRUE(CoroutineState::finished == second.state());
+
+    // ʧ
+    ConnectOnlyCore refused;
+    refused.fail = true;
+    Client third(&refused);
+    scheduler.spawn(&third);
+    ASSERT_FALSE(third.connected);
+    ASSERT_FALSE(third.error.empty());
+    ASSERT_TRUE(0 == scheduler.stats().alive);
+}
+
+TEST(coroutine, idleFootprint)
+{
+    // ռõڴ: ջʵõҳ Channel Э̶
+    CoroutineScheduler scheduler(null_ptr);
+    const size_t count = 64;
+    std::vector<LoopbackTransport*> transports;
+    std::vector<EchoSession*> sessions;
+    for (size_t i = 0; i < count; ++ i)
+    {
+        LoopbackTransport* transport = new LoopbackTransport();
+        Channel* channel = new Channel(&scheduler, null_ptr);
+        EchoSession* session = new EchoSession(channel);
+        channel->startOnConnected(session);
+        transport->bindProtocol(channel);
+        transport->initialize();
+        transport->receive(std::string("x"));
+        transports.push_back(transport);
+        sessions.push_back(session);
+    }
+
+    ASSERT_TRUE(count == scheduler.stats().alive);
+    ASSERT_TRUE(count == scheduler.stats().fibers);
+
+    size_t committed = 0;
+    for (size_t i = 0; i < count; ++ i)
+        committed += sessions[i]->committed;
+    size_t perConnection = committed / count + sizeof(Channel) + sizeof(EchoSession);
+
+    // ջõʱύ, ԶСڱĴС; صЭÿֻ sizeof(Э)
+    ASSERT_TRUE(0 != committed);
+    ASSERT_TRUE(perConnection < scheduler.stackSize() / 2);
+    ASSERT_TRUE(perConnection > sizeof(CallbackEchoProtocol));
+
+    for (size_t i = 0; i < count; ++ i)
+    {
+        transports[i]->closed();
+        delete sessions[i];
+        delete transports[i];
+    }
+    ASSERT_TRUE(0 == scheduler.stats().alive);
+}
+
+#ifndef _GOOGLETEST_
+
+BENCHMARK(coroutine_switch)
+{
+    // һλѼһι, ˳л
+    CoroutineScheduler scheduler(null_ptr);
+    Counter counter((int)state.iterations() + 1);
+    scheduler.spawn(&counter);
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        scheduler.wake(&counter);
+    DO_NOT_OPTIMIZE(counter.steps);
+
+    state.pauseTiming();
+    scheduler.wake(&counter);
+    state.resumeTiming();
+}
+
+BENCHMARK(coroutine_spawn)
+{
+    // ˳̴ӳȡ, ջ
+    CoroutineScheduler scheduler(null_ptr);
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        Counter counter(0);
+        scheduler.spawn(&counter);
+        DO_NOT_OPTIMIZE(counter.exited);
+    }
+}
+
+namespace
+{
+    void echoMessages(BenchmarkState& state, LoopbackTransport& transport)
+    {
+        std::string message(64, 'x');
+        for (size_t i = 0; i < state.iterations(); ++ i)
+        {
+            transport.receive(message);
+            transport.wire.clear();
+        }
+        state.setBytesProcessed(state.iterations() * message.size());
+    }
+}
+
+BENCHMARK(coroutine_echo)
+{
+    CoroutineScheduler scheduler(null_ptr);
+    LoopbackTransport transport;
+    Channel* channel = new Channel(&scheduler, null_ptr);
+    EchoSession session(channel);
+    channel->startOnConnected(&session);
+    transport.bindProtocol(channel);
+    transport.initialize();
+
+    echoMessages(state, transport);
+
+    state.pauseTiming();
+    transport.closed();
+    state.resumeTiming();
+}
+
+BENCHMARK(callback_echo)
+{
+    LoopbackTransport transport;
+    CallbackEchoProtocol protocol;
+    transport.bindProtocol(&protocol);
+    transport.initialize();
+
+    echoMessages(state, transport);
+}
+
+#endif // _GOOGLETEST_
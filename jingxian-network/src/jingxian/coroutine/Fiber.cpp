@@ -0,0 +1,170 @@
+
+# include "pro_config.h"
+# include "jingxian/exception.h"
+# include "jingxian/lastError.h"
+# include "jingxian/coroutine/Fiber.h"
+#ifndef _WIN32
+# include <sys/mman.h>
+# include <unistd.h>
+# include <vector>
+#endif
+
+_jingxian_begin
+
+size_t Fiber::pageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return (size_t)::sysconf(_SC_PAGESIZE);
+#endif
+}
+
+size_t Fiber::stackSize() const
+{
+    return stackSize_;
+}
+
+#ifdef _WIN32
+
+Fiber::Fiber()
+        : fiber_(null_ptr)
+        , converted_(false)
+        , stackSize_(0)
+        , entry_(null_ptr)
+        , param_(null_ptr)
+{
+    fiber_ = ::ConvertThreadToFiber(null_ptr);
+    if (null_ptr != fiber_)
+    {
+        converted_ = true;
+        return;
+    }
+
+    // ߳Ѿ˳( 类ģת )
+    if (ERROR_ALREADY_FIBER != ::GetLastError())
+        ThrowException1(SystemException, concat<tstring>(_T("ת߳Ϊ˳ʧ - "), lastError()));
+    fiber_ = ::GetCurrentFiber();
+}
+
+Fiber::Fiber(size_t stackSize, entry_type entry, void* context)
+        : fiber_(null_ptr)
+        , converted_(false)
+        , entry_(entry)
+        , param_(context)
+{
+    size_t page = pageSize();
+    stackSize_ = (stackSize + page - 1) / page * page;
+
+    fiber_ = ::CreateFiberEx(page, stackSize_, 0, &Fiber::start, this);
+    if (null_ptr == fiber_)
+        ThrowException1(SystemException, concat<tstring>(_T("˳ʧ - "), lastError()));
+}
+
+Fiber::~Fiber()
+{
+    if (converted_)
+        ::ConvertFiberToThread();
+    else if (0 != stackSize_)
+        ::DeleteFiber(fiber_);
+}
+
+void Fiber::switchTo(Fiber& from, Fiber& to)
+{
+    ::SwitchToFiber(to.fiber_);
+}
+
+size_t Fiber::stackCommitted() const
+{
+    NT_TIB* tib = (NT_TIB*)::NtCurrentTeb();
+    return (char*)tib->StackBase - (char*)tib->StackLimit;
+}
+
+VOID CALLBACK Fiber::start(PVOID param)
+{
+    Fiber* self = (Fiber*)param;
+    self->entry_(self->param_);
+}
+
+#else
+
+Fiber::Fiber()
+        : memory_(null_ptr)
+        , mapped_(0)
+        , stackSize_(0)
+        , entry_(null_ptr)
+        , param_(null_ptr)
+{
+    // һлȥʱ swapcontext 浱ǰ
+    memset(&context_, 0, sizeof(context_));
+}
+
+Fiber::Fiber(size_t stackSize, entry_type entry, void* context)
+        : memory_(null_ptr)
+        , mapped_(0)
+        , entry_(entry)
+        , param_(context)
+{
+    size_t page = pageSize();
+    stackSize_ = (stackSize + page - 1) / page * page;
+    mapped_ = stackSize_ + page;
+
+    void* memory = ::mmap(null_ptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == memory)
+        ThrowException1(SystemException, _T("Э̵ջʧ"));
+    memory_ = (char*)memory;
+
+    if (0 != ::mprotect(memory_, page, PROT_NONE) || 0 != ::getcontext(&context_))
+    {
+        ::munmap(memory_, mapped_);
+        ThrowException1(SystemException, _T("ʼЭ̵ջʧ"));
+    }
+
+    context_.uc_stack.ss_sp = memory_ + page;
+    context_.uc_stack.ss_size = stackSize_;
+    context_.uc_link = null_ptr;
+
+    // makecontext ֻܴ int , ָ
+    uint64_t self = (uint64_t)(uintptr_t)this;
+    ::makecontext(&context_, (void (*)())&Fiber::start, 2, (unsigned int)(self >> 32), (unsigned int)self);
+}
+
+Fiber::~Fiber()
+{
+    if (null_ptr != memory_)
+        ::munmap(memory_, mapped_);
+}
+
+void Fiber::switchTo(Fiber& from, Fiber& to)
+{
+    ::swapcontext(&from.context_, &to.context_);
+}
+
+size_t Fiber::stackCommitted() const
+{
+    if (null_ptr == memory_)
+        return 0;
+
+    size_t page = pageSize();
+    size_t pages = stackSize_ / page;
+    std::vector<unsigned char> resident(pages);
+    if (0 != ::mincore(memory_ + page, stackSize_, &resident[0]))
+        return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < pages; ++ i)
+        count += (resident[i] & 1);
+    return count * page;
+}
+
+void Fiber::start(unsigned int high, unsigned int low)
+{
+    Fiber* self = (Fiber*)(uintptr_t)((((uint64_t)high) << 32) | low);
+    self->entry_(self->param_);
+}
+
+#endif
+
+_jingxian_end
@@ -0,0 +1,86 @@
+
+#ifndef _Fiber_H_
+#define _Fiber_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+#ifndef _WIN32
+# include <ucontext.h>
+#endif
+
+_jingxian_begin
+
+/**
+ * Լջִ, Элĵײʵ
+ *
+ * Windows ˳, ջϵͳ CreateFiberEx  stackSize , ֻύõ
+ * ҳ, ջϵͳıҳ. ƽ̨ ucontext, ջ mmap ,
+ * ͵һҳΪɷΪҳ, ʱǸдڴ.
+ * swapcontext ÿлҪź( һϵͳ ), ˳ö, ֻ
+ * ƽ̨ܵԪ.
+ */
+class Fiber
+{
+public:
+    typedef void (*entry_type)(void* context);
+
+    /**
+     * ѵǰ߳תΪ˳, ΪлĿ
+     */
+    Fiber();
+
+    /**
+     * һµ˳, һлʱ entry(context)
+     * @param[ in ] stackSize ջĴС, ҳ
+     * @remarks entry ܷ
+     */
+    Fiber(size_t stackSize, entry_type entry, void* context);
+
+    ~Fiber();
+
+    /**
+     *  from л to, from ǵǰе˳
+     */
+    static void switchTo(Fiber& from, Fiber& to);
+
+    size_t stackSize() const;
+
+    /**
+     * ջѾʵռڴֽ
+     * @remarks Windows ֻڱ˳е
+     */
+    size_t stackCommitted() const;
+
+    static size_t pageSize();
+
+private:
+    NOCOPY(Fiber);
+
+#ifdef _WIN32
+    static VOID CALLBACK start(PVOID param);
+
+    void* fiber_;
+    /// ǲ߳ת
+    bool converted_;
+#else
+    static void start(unsigned int high, unsigned int low);
+
+    ucontext_t context_;
+    /// mmap ڴ, һҳǱҳ
+    char* memory_;
+    size_t mapped_;
+#endif
+
+    size_t stackSize_;
+    entry_type entry_;
+    void* param_;
+};
+
+_jingxian_end
+
+#endif //_Fiber_H_
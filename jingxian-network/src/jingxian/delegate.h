@@ -0,0 +1,1163 @@
+
+#ifndef _delegate_h_
+#define _delegate_h_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <new>
+# include <vector>
+# include <string.h>
+
+_jingxian_begin
+
+namespace delegate_detail
+{
+    /**
+     * 洢ĴС, ܷһָһԱָ( MSVC ¶̳л
+     * ̳еĳԱָΪ 16 ֽ ), Լֻ˼ָС
+     */
+    enum { storage_size = sizeof(void*) + 16 };
+
+    union storage
+    {
+        void* object;
+        void (*function)();
+        double align1;
+        int64_t align2;
+        char buffer[storage_size];
+    };
+
+    enum manager_operation
+    {
+        clone_operation,
+        destroy_operation
+    };
+
+    /**
+     * ƻٴ洢еĺ, ԰ֽڸƵĿ( Աͺָ )
+     * Ҫ, ʱΪ null_ptr
+     */
+    typedef void (*manager_type)(manager_operation operation, const storage& source, storage& target);
+
+    /**
+     * ŵý洢ĺֱӹڴ洢
+     */
+    template<typename F, bool small = (sizeof(F) <= storage_size)>
+    struct functor_manager
+    {
+        enum { inplace = true };
+
+        static F* get(const storage& s)
+        {
+            return (F*)(const_cast<char*>(s.buffer));
+        }
+
+        static void store(storage& s, const F& functor)
+        {
+            new (s.buffer) F(functor);
+        }
+
+        static void manage(manager_operation operation, const storage& source, storage& target)
+        {
+            if (clone_operation == operation)
+                store(target, *get(source));
+            else
+                get(target)->~F();
+        }
+    };
+
+    /**
+     * Ųµĺڶ
+     */
+    template<typename F>
+    struct functor_manager<F, false>
+    {
+        enum { inplace = false };
+
+        static F* get(const storage& s)
+        {
+            return (F*)s.object;
+        }
+
+        static void store(storage& s, const F& functor)
+        {
+            s.object = new F(functor);
+        }
+
+        static void manage(manager_operation operation, const storage& source, storage& target)
+        {
+            if (clone_operation == operation)
+                store(target, *get(source));
+            else
+                delete get(target);
+        }
+    };
+
+    template<typename T, typename M>
+    struct method_target
+    {
+        T* object;
+        M method;
+
+        static method_target& get(storage& s)
+        {
+            return *functor_manager<method_target>::get(s);
+        }
+    };
+
+    /**
+     * ޹صĲ, 洢ĸƺ
+     */
+    class delegate_base
+    {
+    protected:
+        delegate_base()
+                : manager_(null_ptr)
+        {
+        }
+
+        delegate_base(const delegate_base& other)
+                : manager_(other.manager_)
+        {
+            copy(other);
+        }
+
+        ~delegate_base()
+        {
+            reset();
+        }
+
+        delegate_base& operator=(const delegate_base& other)
+        {
+            if (this == &other)
+                return *this;
+
+            reset();
+            manager_ = other.manager_;
+            copy(other);
+            return *this;
+        }
+
+        void reset()
+        {
+            if (is_null(manager_))
+                return;
+
+            manager_(destroy_operation, storage_, storage_);
+            manager_ = null_ptr;
+        }
+
+        /**
+         * ֻаֽڸƵĿܱȽ, ǲ
+         */
+        bool equals(const delegate_base& other) const
+        {
+            return is_null(manager_) && is_null(other.manager_)
+                   && 0 == memcmp(&storage_, &other.storage_, sizeof(storage_));
+        }
+
+        template<typename T, typename M>
+        void storeMethod(T* object, M method)
+        {
+            typedef method_target<T, M> target_type;
+            target_type target = { object, method };
+
+            // ٴ, ȽʱֱӱȽֽ
+            memset(&storage_, 0, sizeof(storage_));
+            functor_manager<target_type>::store(storage_, target);
+            if (!functor_manager<target_type>::inplace)
+                manager_ = &functor_manager<target_type>::manage;
+        }
+
+        template<typename F>
+        void storeFunction(F function)
+        {
+            memset(&storage_, 0, sizeof(storage_));
+            *(F*)storage_.buffer = function;
+        }
+
+        template<typename F>
+        void storeFunctor(const F& functor)
+        {
+            functor_manager<F>::store(storage_, functor);
+            manager_ = &functor_manager<F>::manage;
+        }
+
+        mutable storage storage_;
+
+    private:
+        void copy(const delegate_base& other)
+        {
+            if (is_null(manager_))
+                storage_ = other.storage_;
+            else
+                manager_(clone_operation, other.storage_, storage_);
+        }
+
+        manager_type manager_;
+    };
+}
+
+/**
+ * Ͳί,  _connection_base/_connection.
+ *
+ * Ա, ָСĺֱӴڶڲ, ͸ƶҪ
+ * ڴ, ֻһָͨļӵ. ĺŻڶ.
+ * ίֵ, ֱӷ.
+ *
+ * :
+ *   delegate<void (int)> d(&example, &ConnectionExample::OnHandler1);
+ *   d(1);
+ */
+template<typename Signature>
+class delegate;
+
+template<typename R>
+class delegate<R ()> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)())
+            : invoker_(&method_call<T, R (T::*)()>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)() const)
+            : invoker_(&method_call<const T, R (T::*)() const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)())
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()() const
+    {
+        return invoker_(storage_);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)();
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s)
+        {
+            return (*(R (**)())s.buffer)();
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))();
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1>
+class delegate<R (A1)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1))
+            : invoker_(&method_call<T, R (T::*)(A1)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1) const)
+            : invoker_(&method_call<const T, R (T::*)(A1) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1) const
+    {
+        return invoker_(storage_, a1);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1)
+        {
+            return (*(R (**)(A1))s.buffer)(a1);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2>
+class delegate<R (A1, A2)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2))
+            : invoker_(&method_call<T, R (T::*)(A1, A2)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2) const
+    {
+        return invoker_(storage_, a1, a2);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2)
+        {
+            return (*(R (**)(A1, A2))s.buffer)(a1, a2);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3>
+class delegate<R (A1, A2, A3)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3) const
+    {
+        return invoker_(storage_, a1, a2, a3);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3)
+        {
+            return (*(R (**)(A1, A2, A3))s.buffer)(a1, a2, a3);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4>
+class delegate<R (A1, A2, A3, A4)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3, A4))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3, A4)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3, A4) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3, A4) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3, A4))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3, A4 a4) const
+    {
+        return invoker_(storage_, a1, a2, a3, a4);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3, A4);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3, a4);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4)
+        {
+            return (*(R (**)(A1, A2, A3, A4))s.buffer)(a1, a2, a3, a4);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3, a4);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4, typename A5>
+class delegate<R (A1, A2, A3, A4, A5)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3, A4, A5))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3, A4, A5)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3, A4, A5) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3, A4, A5) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3, A4, A5))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) const
+    {
+        return invoker_(storage_, a1, a2, a3, a4, a5);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3, A4, A5);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3, a4, a5);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5)
+        {
+            return (*(R (**)(A1, A2, A3, A4, A5))s.buffer)(a1, a2, a3, a4, a5);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3, a4, a5);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+class delegate<R (A1, A2, A3, A4, A5, A6)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3, A4, A5, A6))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3, A4, A5, A6)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3, A4, A5, A6) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3, A4, A5, A6) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3, A4, A5, A6))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) const
+    {
+        return invoker_(storage_, a1, a2, a3, a4, a5, a6);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3, A4, A5, A6);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3, a4, a5, a6);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6)
+        {
+            return (*(R (**)(A1, A2, A3, A4, A5, A6))s.buffer)(a1, a2, a3, a4, a5, a6);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3, a4, a5, a6);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+class delegate<R (A1, A2, A3, A4, A5, A6, A7)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3, A4, A5, A6, A7))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3, A4, A5, A6, A7)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3, A4, A5, A6, A7) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3, A4, A5, A6, A7) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3, A4, A5, A6, A7))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) const
+    {
+        return invoker_(storage_, a1, a2, a3, a4, a5, a6, a7);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3, A4, A5, A6, A7);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3, a4, a5, a6, a7);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7)
+        {
+            return (*(R (**)(A1, A2, A3, A4, A5, A6, A7))s.buffer)(a1, a2, a3, a4, a5, a6, a7);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3, a4, a5, a6, a7);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+class delegate<R (A1, A2, A3, A4, A5, A6, A7, A8)> : public delegate_detail::delegate_base
+{
+public:
+    typedef R result_type;
+
+    delegate()
+            : invoker_(null_ptr)
+    {
+    }
+
+    template<typename T>
+    delegate(T* object, R (T::*method)(A1, A2, A3, A4, A5, A6, A7, A8))
+            : invoker_(&method_call<T, R (T::*)(A1, A2, A3, A4, A5, A6, A7, A8)>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    template<typename T>
+    delegate(const T* object, R (T::*method)(A1, A2, A3, A4, A5, A6, A7, A8) const)
+            : invoker_(&method_call<const T, R (T::*)(A1, A2, A3, A4, A5, A6, A7, A8) const>::invoke)
+    {
+        storeMethod(object, method);
+    }
+
+    delegate(R (*function)(A1, A2, A3, A4, A5, A6, A7, A8))
+            : invoker_(&function_call::invoke)
+    {
+        storeFunction(function);
+    }
+
+    template<typename F>
+    delegate(const F& functor)
+            : invoker_(&functor_call<F>::invoke)
+    {
+        storeFunctor(functor);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) const
+    {
+        return invoker_(storage_, a1, a2, a3, a4, a5, a6, a7, a8);
+    }
+
+    bool empty() const
+    {
+        return is_null(invoker_);
+    }
+
+    void clear()
+    {
+        reset();
+        invoker_ = null_ptr;
+    }
+
+    bool operator==(const delegate& other) const
+    {
+        return invoker_ == other.invoker_ && equals(other);
+    }
+
+    bool operator!=(const delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    typedef R (*invoker_type)(delegate_detail::storage&, A1, A2, A3, A4, A5, A6, A7, A8);
+
+    template<typename T, typename M>
+    struct method_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8)
+        {
+            delegate_detail::method_target<T, M>& target = delegate_detail::method_target<T, M>::get(s);
+            return (target.object->*target.method)(a1, a2, a3, a4, a5, a6, a7, a8);
+        }
+    };
+
+    struct function_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8)
+        {
+            return (*(R (**)(A1, A2, A3, A4, A5, A6, A7, A8))s.buffer)(a1, a2, a3, a4, a5, a6, a7, a8);
+        }
+    };
+
+    template<typename F>
+    struct functor_call
+    {
+        static R invoke(delegate_detail::storage& s, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8)
+        {
+            return (*delegate_detail::functor_manager<F>::get(s))(a1, a2, a3, a4, a5, a6, a7, a8);
+        }
+    };
+
+    invoker_type invoker_;
+};
+
+/**
+ * ίаӵ˳شһ, ʱûָת.
+ * õĲʹ߾(  configure ڵһ true Ļصֹͣ ),
+ * ùв޸ͬһ delegate_signal.
+ */
+template<typename Signature>
+class delegate_signal
+{
+public:
+    typedef delegate<Signature> slot_type;
+    typedef typename std::vector<slot_type>::const_iterator const_iterator;
+
+    void connect(const slot_type& slot)
+    {
+        slots_.push_back(slot);
+    }
+
+    /**
+     * Ͽһ slot ȵί, ֻгԱͺָܶϿ
+     */
+    bool disconnect(const slot_type& slot)
+    {
+        for (typename std::vector<slot_type>::iterator it = slots_.begin()
+                ; it != slots_.end(); ++ it)
+        {
+            if (*it == slot)
+            {
+                slots_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        slots_.clear();
+    }
+
+    bool empty() const
+    {
+        return slots_.empty();
+    }
+
+    size_t size() const
+    {
+        return slots_.size();
+    }
+
+    const slot_type& operator[](size_t index) const
+    {
+        return slots_[index];
+    }
+
+    const_iterator begin() const
+    {
+        return slots_.begin();
+    }
+
+    const_iterator end() const
+    {
+        return slots_.end();
+    }
+
+private:
+    std::vector<slot_type> slots_;
+};
+
+_jingxian_end
+
+#endif // _delegate_h_
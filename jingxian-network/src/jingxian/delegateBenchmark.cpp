@@ -0,0 +1,227 @@
+
+# include "pro_config.h"
+# include "jingxian/connection_functionals.h"
+# include "jingxian/delegate.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    class Counter
+    {
+    public:
+        Counter()
+                : count_(0)
+        {
+        }
+
+        bool add(int value)
+        {
+            count_ += value;
+            return true;
+        }
+
+        int count() const
+        {
+            return count_;
+        }
+
+        int count_;
+    };
+
+    int twice(int value)
+    {
+        return value * 2;
+    }
+
+    /**
+     * ָֻСĺ, Ӧ÷洢
+     */
+    struct AddTo
+    {
+        AddTo(int* total, int step)
+                : total_(total)
+                , step_(step)
+        {
+        }
+
+        int operator()(int value)
+        {
+            *total_ += value * step_;
+            return *total_;
+        }
+
+        int* total_;
+        int step_;
+    };
+
+    /**
+     * Ų洢ĺ, ڶ
+     */
+    struct LargeFunctor
+    {
+        LargeFunctor(int* total)
+                : total_(total)
+        {
+            memset(padding_, 0, sizeof(padding_));
+        }
+
+        int operator()(int value)
+        {
+            *total_ += value;
+            return *total_;
+        }
+
+        int* total_;
+        char padding_[64];
+    };
+}
+
+TEST(delegate, call)
+{
+    Counter counter;
+    delegate<bool (int)> method(&counter, &Counter::add);
+    ASSERT_FALSE(method.empty());
+    ASSERT_TRUE(method(3));
+    ASSERT_TRUE(3 == counter.count());
+
+    delegate<int ()> constMethod(&counter, &Counter::count);
+    ASSERT_TRUE(3 == constMethod());
+
+    delegate<int (int)> function(&twice);
+    ASSERT_TRUE(8 == function(4));
+
+    int total = 0;
+    delegate<int (int)> small = AddTo(&total, 2);
+    ASSERT_TRUE(6 == small(3));
+
+    delegate<int (int)> large = LargeFunctor(&total);
+    ASSERT_TRUE(7 == large(1));
+
+    // ƺ߻Ӱ
+    delegate<int (int)> copy = large;
+    large.clear();
+    ASSERT_TRUE(large.empty());
+    ASSERT_TRUE(8 == copy(1));
+
+    copy = small;
+    ASSERT_TRUE(12 == copy(2));
+}
+
+TEST(delegate, signal)
+{
+    Counter first;
+    Counter second;
+
+    delegate_signal<bool (int)> sig;
+    sig.connect(delegate<bool (int)>(&first, &Counter::add));
+    sig.connect(delegate<bool (int)>(&second, &Counter::add));
+    ASSERT_TRUE(2 == sig.size());
+
+    for (delegate_signal<bool (int)>::const_iterator it = sig.begin(); it != sig.end(); ++ it)
+        (*it)(2);
+    ASSERT_TRUE(2 == first.count());
+    ASSERT_TRUE(2 == second.count());
+
+    // ĿͳԱȽ
+    ASSERT_TRUE(sig.disconnect(delegate<bool (int)>(&first, &Counter::add)));
+    ASSERT_TRUE(1 == sig.size());
+    ASSERT_FALSE(sig.disconnect(delegate<bool (int)>(&first, &Counter::add)));
+    sig[0](1);
+    ASSERT_TRUE(3 == second.count());
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(delegate_construct_connection)
+{
+    Counter counter;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        _connection_base<bool (int)>* conn = new _connection<Counter, bool (int)>(&counter, &Counter::add);
+        DO_NOT_OPTIMIZE(conn);
+        delete conn;
+    }
+}
+
+BENCHMARK(delegate_construct_delegate)
+{
+    Counter counter;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        delegate<bool (int)> d(&counter, &Counter::add);
+        DO_NOT_OPTIMIZE(d);
+    }
+}
+
+BENCHMARK(delegate_construct_functor)
+{
+    int total = 0;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        delegate<int (int)> d = AddTo(&total, 1);
+        DO_NOT_OPTIMIZE(d);
+    }
+}
+
+BENCHMARK(delegate_invoke_connection)
+{
+    Counter counter;
+    std::auto_ptr<_connection_base<bool (int)> > conn(new _connection<Counter, bool (int)>(&counter, &Counter::add));
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        conn->call(1);
+    DO_NOT_OPTIMIZE(counter.count());
+}
+
+BENCHMARK(delegate_invoke_delegate)
+{
+    Counter counter;
+    delegate<bool (int)> d(&counter, &Counter::add);
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        d(1);
+    DO_NOT_OPTIMIZE(counter.count());
+}
+
+BENCHMARK(delegate_invoke_list_8)
+{
+    Counter counters[8];
+    std::list<_connection_base<bool (int)>*> slots;
+    for (size_t i = 0; i < 8; ++ i)
+        slots.push_back(new _connection<Counter, bool (int)>(&counters[i], &Counter::add));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        for (std::list<_connection_base<bool (int)>*>::const_iterator it = slots.begin()
+                ; it != slots.end(); ++ it)
+            (*it)->call(1);
+    }
+    DO_NOT_OPTIMIZE(counters[0].count());
+
+    for (std::list<_connection_base<bool (int)>*>::iterator it = slots.begin()
+            ; it != slots.end(); ++ it)
+        delete (*it);
+}
+
+BENCHMARK(delegate_invoke_signal_8)
+{
+    Counter counters[8];
+    delegate_signal<bool (int)> sig;
+    for (size_t i = 0; i < 8; ++ i)
+        sig.connect(delegate<bool (int)>(&counters[i], &Counter::add));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        for (delegate_signal<bool (int)>::const_iterator it = sig.begin(); it != sig.end(); ++ it)
+            (*it)(1);
+    }
+    DO_NOT_OPTIMIZE(counters[0].count());
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
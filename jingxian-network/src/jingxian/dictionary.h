@@ -9,21 +9,31 @@
 #endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
 
 // Include files
-# include <hash_map>
+# include <vector>
 # include "IDictionary.h"
 
 _jingxian_begin
 
+/**
+ * ֵʵ
+ *
+ * ֵдʱͽͻֵ, ȡʱ atoi ַȽ, ַ
+ * ܽҪ( 򳬳Χ )ʱ defaultValue.  DictionaryKey
+ * һѰַ̽, þʱֻȽ.
+ */
 class Dictionary : public IDictionary
 {
 public:
 
-    typedef stdext::hash_map<tstring, tstring> container_type;
-    typedef container_type::const_iterator const_iterator;
-    typedef container_type::iterator iterator;
+    Dictionary(void);
 
     virtual ~Dictionary(void);
 
+    size_t size() const
+    {
+        return values_.size();
+    }
+
     virtual bool has(const tstring& key) const;
 
     virtual bool getBoolean(const tstring& key, bool defaultValue) const;
@@ -38,6 +48,20 @@ public:
 
     virtual const tstring& getString(const tstring& key, const tstring& defaultValue) const;
 
+    virtual bool has(const DictionaryKey& key) const;
+
+    virtual bool getBoolean(const DictionaryKey& key, bool defaultValue) const;
+
+    virtual int8_t getInt8(const DictionaryKey& key, int8_t defaultValue) const;
+
+    virtual int16_t getInt16(const DictionaryKey& key, int16_t defaultValue) const;
+
+    virtual int32_t getInt32(const DictionaryKey& key, int32_t defaultValue) const;
+
+    virtual int64_t getInt64(const DictionaryKey& key, int64_t defaultValue) const;
+
+    virtual const tstring& getString(const DictionaryKey& key, const tstring& defaultValue) const;
+
 
     virtual void setBoolean(const tstring& key, bool value);
 
@@ -51,13 +75,59 @@ public:
 
     virtual void setString(const tstring& key, const tchar* buf, size_t len);
 
+    virtual void setBoolean(const DictionaryKey& key, bool value);
+
+    virtual void setInt8(const DictionaryKey& key, int8_t value);
+
+    virtual void setInt16(const DictionaryKey& key, int16_t value);
+
+    virtual void setInt32(const DictionaryKey& key, int32_t value);
+
+    virtual void setInt64(const DictionaryKey& key, int64_t value);
+
+    virtual void setString(const DictionaryKey& key, const tchar* buf, size_t len);
+
     virtual void dump(tostream& target) const;
 
 private:
 
-    stdext::hash_map<tstring, tstring> _container;
+    enum
+    {
+        HAS_BOOLEAN = 1,
+        HAS_INTEGER = 2
+    };
+
+    /**
+     * ͻֵ, text Ǳֵַʽ,  getString  dump ʹ
+     */
+    struct Value
+    {
+        DictionaryKey key;
+        int flags;
+        bool boolean;
+        int64_t integer;
+        tstring text;
+    };
+
+    const Value* find(const DictionaryKey& key) const;
+    Value& insert(const DictionaryKey& key);
+    void rehash(size_t capacity);
+
+    bool getInteger(const DictionaryKey& key, int64_t minValue, int64_t maxValue, int64_t& value) const;
+    void setInteger(const DictionaryKey& key, int64_t value);
+
+    // ѰַĲ, id Ϊ 0 ʾղ
+    struct Slot
+    {
+        uint32_t id;
+        uint32_t index;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<Value> values_;
+    size_t mask_;
 };
 
 _jingxian_end
 
-#endif //_IDictionary_H_
\ No newline at end of file
+#endif //_Dictionary12_H_
@@ -1,6 +1,7 @@
 # include "pro_config.h"
 # include "log4cpp.h"
 # include "jingxian/directory.h"
+# include "jingxian/buffer/MemoryAccount.h"
 
 _jingxian_begin
 
@@ -133,7 +134,7 @@ Tracer::Tracer(const tchar* nm, const tstring& thost, const tstring& tpeer, cons
     std::string peer = toNarrowString(tpeer);
 
     size_t len = host.size() + peer.size() + 20;
-    name_ = (char*)my_malloc(len);
+    name_ = (char*)my_malloc_as(len, MemoryKind::Logging);
     memset(name_, 0, len);
     name_[0] = '[';
     memcpy(name_ + 1, host.c_str(), host.size());
@@ -3,6 +3,7 @@
 #include "pro_config.h"
 #include <iostream>
 #include "jingxian/Application.h"
+#include "jingxian/buffer/MemoryAccount.h"
 
 #ifdef _GOOGLETEST_
 #include <gtest/gtest.h>
@@ -10,26 +11,73 @@
 #include "jingxian/utilities/unittest.h"
 #endif
 
-void* my_calloc(__in size_t _NumOfElements, __in size_t _SizeOfElements)
+namespace
 {
-	void* ptr = my_malloc(_NumOfElements*_SizeOfElements);
-	memset(ptr, 0, _NumOfElements*_SizeOfElements);
+	/// my_malloc ڴǰͷ, ´С, ͷʱͳмȥ
+	struct block_header
+	{
+		size_t size;
+		size_t kind;
+	};
+}
+
+void* my_malloc_as(__in size_t _Size, __in int _Kind)
+{
+	block_header* header = (block_header*)malloc(_Size + sizeof(block_header));
+	if (NULL == header)
+		return NULL;
+
+	header->size = _Size;
+	header->kind = (size_t)_Kind;
+	MemoryAccount::charge((MemoryKind::type)_Kind, _Size);
+	return header + 1;
+}
+
+void* my_calloc_as(__in size_t _NumOfElements, __in size_t _SizeOfElements, __in int _Kind)
+{
+	void* ptr = my_malloc_as(_NumOfElements*_SizeOfElements, _Kind);
+	if (NULL != ptr)
+		memset(ptr, 0, _NumOfElements*_SizeOfElements);
 	return ptr;
 }
 
+void* my_calloc(__in size_t _NumOfElements, __in size_t _SizeOfElements)
+{
+	return my_calloc_as(_NumOfElements, _SizeOfElements, MemoryKind::Other);
+}
+
 void  my_free(__inout_opt void * _Memory)
 {
-	return free(((char*)_Memory) - 4);
+	if (NULL == _Memory)
+		return;
+
+	block_header* header = ((block_header*)_Memory) - 1;
+	MemoryAccount::credit((MemoryKind::type)header->kind, header->size);
+	free(header);
 }
 
 void* my_malloc(__in size_t _Size)
 {
-	return ((char*)malloc(_Size + 4)) + 4;
+	return my_malloc_as(_Size, MemoryKind::Other);
 }
 
 void* my_realloc(__in_opt void * _Memory, __in size_t _NewSize)
 {
-	return ((char*)realloc(((char*)_Memory) - 4, _NewSize + 4)) + 4;
+	if (NULL == _Memory)
+		return my_malloc(_NewSize);
+
+	block_header* header = ((block_header*)_Memory) - 1;
+	MemoryKind::type kind = (MemoryKind::type)header->kind;
+	size_t oldSize = header->size;
+
+	header = (block_header*)realloc(header, _NewSize + sizeof(block_header));
+	if (NULL == header)
+		return NULL;
+
+	header->size = _NewSize;
+	MemoryAccount::credit(kind, oldSize);
+	MemoryAccount::charge(kind, _NewSize);
+	return header + 1;
 }
 
 char*  my_strdup(__in_z_opt const char * _Src)
@@ -60,6 +108,15 @@ int _tmain(int argc, tchar* argv[])
 #endif
     RUN_ALL_TESTS();
 
+#ifndef _GOOGLETEST_
+    // л׼, --benchmark=xxx ʱֻа xxx 
+    if (2 <= argc && 0 == string_traits<tchar>::strnicmp(argv[1], _T("--benchmark"), 11))
+    {
+        if (_T('=') == argv[1][11])
+            return RUN_ALL_BENCHMARKS(toNarrowString(argv[1] + 12).c_str());
+        return RUN_ALL_BENCHMARKS();
+    }
+#endif
 
     return Application::main(argc, argv);
 }
@@ -0,0 +1,408 @@
+
+# include "pro_config.h"
+# include "jingxian/lastError.h"
+# include "jingxian/networks/AdmissionControl.h"
+# include "jingxian/networks/IOCPServer.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ϣĳʼС( 2  )
+    const size_t INITIAL_ENTRIES = 64;
+
+    /// ¼ѭӳٵļ(  )
+    const uint32_t PROBE_INTERVAL = 100;
+
+    /// IPv6 ַָƵıλ, IPv4 ļ 33 λ
+    const uint64_t IPV6_KEY = 0x8000000000000000ULL;
+    const uint64_t IPV4_KEY = 0x100000000ULL;
+
+    /**
+     * splitmix64 ĻϺ
+     */
+    uint64_t mix64(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /**
+     * ɹϣ, Ҫѧǿ, ֻҪԶ޷Ԥ
+     */
+    uint64_t randomSeed(const void* self)
+    {
+        LARGE_INTEGER counter;
+        ::QueryPerformanceCounter(&counter);
+
+        uint64_t seed = mix64((uint64_t)counter.QuadPart);
+        seed = mix64(seed ^ ((uint64_t)::GetCurrentProcessId() << 32) ^ ::GetCurrentThreadId());
+        seed = mix64(seed ^ (uint64_t)(size_t)self ^ ((uint64_t)::GetTickCount() << 16));
+        return seed;
+    }
+}
+
+SourceCounter::SourceCounter()
+        : entries_(INITIAL_ENTRIES)
+        , mask_(INITIAL_ENTRIES - 1)
+        , size_(0)
+        , seed_(randomSeed(this))
+{
+    memset(&entries_[0], 0, entries_.size() * sizeof(Entry));
+}
+
+size_t SourceCounter::slot(uint64_t key) const
+{
+    return (size_t)mix64(key ^ seed_) & mask_;
+}
+
+size_t SourceCounter::find(uint64_t key) const
+{
+    size_t index = slot(key);
+    while (0 != entries_[index].key && key != entries_[index].key)
+        index = (index + 1) & mask_;
+    return index;
+}
+
+uint32_t SourceCounter::increase(uint64_t key)
+{
+    // װӲ 1/2
+    if ((size_ + 1) * 2 > entries_.size())
+        grow();
+
+    size_t index = find(key);
+    if (0 == entries_[index].key)
+    {
+        entries_[index].key = key;
+        entries_[index].count = 0;
+        ++ size_;
+    }
+    return ++ entries_[index].count;
+}
+
+void SourceCounter::decrease(uint64_t key)
+{
+    size_t index = find(key);
+    if (0 == entries_[index].key)
+        return;
+
+    if (0 != -- entries_[index].count)
+        return;
+
+    // Ѻͬһ̽ϵǰ, ֤ʱն
+    size_t hole = index;
+    size_t next = (hole + 1) & mask_;
+    while (0 != entries_[next].key)
+    {
+        size_t home = slot(entries_[next].key);
+        if (((next - home) & mask_) >= ((next - hole) & mask_))
+        {
+            entries_[hole] = entries_[next];
+            hole = next;
+        }
+        next = (next + 1) & mask_;
+    }
+    entries_[hole].key = 0;
+    entries_[hole].count = 0;
+    -- size_;
+}
+
+uint32_t SourceCounter::count(uint64_t key) const
+{
+    return entries_[find(key)].count;
+}
+
+size_t SourceCounter::size() const
+{
+    return size_;
+}
+
+void SourceCounter::grow()
+{
+    std::vector<Entry> old(entries_.size() * 2);
+    old.swap(entries_);
+    memset(&entries_[0], 0, entries_.size() * sizeof(Entry));
+    mask_ = entries_.size() - 1;
+
+    for (std::vector<Entry>::const_iterator it = old.begin(); it != old.end(); ++ it)
+    {
+        if (0 != it->key)
+            entries_[find(it->key)] = *it;
+    }
+}
+
+uint64_t SourceCounter::key(const sockaddr* addr) const
+{
+    if (AF_INET6 != addr->sa_family)
+        return IPV4_KEY | ((const sockaddr_in*)addr)->sin_addr.s_addr;
+
+    // ӵ FNV-1a, 64 λָڲ֪ʱ
+    const unsigned char* bytes = (const unsigned char*)&((const sockaddr_in6*)addr)->sin6_addr;
+    uint64_t result = 14695981039346656037ULL ^ seed_;
+    for (size_t i = 0; i < sizeof(in6_addr); ++ i)
+    {
+        result ^= bytes[i];
+        result *= 1099511628211ULL;
+    }
+    return IPV6_KEY | mix64(result);
+}
+
+void AdmissionControl::LagProbe::start(AdmissionControl* owner, TimerQueue* timers)
+{
+    owner_ = owner;
+    timers_ = timers;
+    expected_ = timers_->now() + PROBE_INTERVAL;
+    timers_->schedule(this, PROBE_INTERVAL);
+}
+
+void AdmissionControl::LagProbe::onTimeout()
+{
+    // ʱʱ¼ѭռõʱ
+    uint64_t now = timers_->now();
+    owner_->onLag((now > expected_) ? (uint32_t)(now - expected_) : 0);
+
+    expected_ = now + PROBE_INTERVAL;
+    timers_->schedule(this, PROBE_INTERVAL);
+}
+
+AdmissionControl::AdmissionControl()
+        : sessions_(0)
+        , reserve_(INVALID_SOCKET)
+        , lag_(0)
+        , shedding_(false)
+        , rejecting_(false)
+        , rejectedSince_(0)
+        , pauses_(0)
+        , stats_(null_ptr)
+        , logger_(_T("jingxian.system.admission"))
+{
+    memset(rejected_, 0, sizeof(rejected_));
+}
+
+AdmissionControl::~AdmissionControl()
+{
+    if (INVALID_SOCKET != reserve_)
+    {
+        ::closesocket(reserve_);
+        reserve_ = INVALID_SOCKET;
+    }
+}
+
+AdmissionControl::Options& AdmissionControl::options()
+{
+    return options_;
+}
+
+void AdmissionControl::listenerLimit(const tstring& address, size_t limit)
+{
+    listenerLimits_[address] = limit;
+}
+
+void AdmissionControl::stats(ServerStats* stats)
+{
+    stats_ = stats;
+}
+
+void AdmissionControl::start(TimerQueue& timers)
+{
+    restoreReserve();
+
+    if (0 != options_.maxLoopLag)
+        probe_.start(this, &timers);
+}
+
+void AdmissionControl::stop(TimerQueue& timers)
+{
+    timers.cancel(&probe_);
+}
+
+admission_result::type AdmissionControl::admit(const tstring& listener, const sockaddr* source, Ticket& ticket)
+{
+    if (shedding_)
+    {
+        onRejected(admission_result::Overloaded, listener);
+        return admission_result::Overloaded;
+    }
+
+    if (0 != options_.maxSessions && sessions_ >= options_.maxSessions)
+    {
+        onRejected(admission_result::GlobalLimit, listener);
+        return admission_result::GlobalLimit;
+    }
+
+    std::map<tstring, size_t>::iterator it = listeners_.find(listener);
+    if (listeners_.end() == it)
+        it = listeners_.insert(std::make_pair(listener, (size_t)0)).first;
+
+    std::map<tstring, size_t>::const_iterator limit = listenerLimits_.find(listener);
+    size_t maxListenerSessions = (listenerLimits_.end() == limit) ? options_.maxListenerSessions : limit->second;
+    if (0 != maxListenerSessions && it->second >= maxListenerSessions)
+    {
+        onRejected(admission_result::ListenerLimit, listener);
+        return admission_result::ListenerLimit;
+    }
+
+    uint64_t key = 0;
+    if (0 != options_.maxSourceSessions)
+    {
+        key = sources_.key(source);
+        if (sources_.count(key) >= options_.maxSourceSessions)
+        {
+            onRejected(admission_result::SourceLimit, listener);
+            return admission_result::SourceLimit;
+        }
+        sources_.increase(key);
+    }
+
+    ++ it->second;
+    ++ sessions_;
+    ticket.listener_ = &(it->second);
+    ticket.source_ = key;
+
+    if (rejecting_)
+    {
+        LOG_INFO(logger_, _T("ָ, ڼܾ ") << rejectedSince_ << _T(" "));
+        rejecting_ = false;
+        rejectedSince_ = 0;
+    }
+    return admission_result::Accepted;
+}
+
+void AdmissionControl::release(Ticket& ticket)
+{
+    if (!ticket.isValid())
+        return;
+
+    -- *ticket.listener_;
+    -- sessions_;
+    if (0 != ticket.source_)
+        sources_.decrease(ticket.source_);
+
+    ticket.listener_ = null_ptr;
+    ticket.source_ = 0;
+}
+
+void AdmissionControl::reject(admission_result::type reason, const tstring& listener)
+{
+    onRejected(reason, listener);
+}
+
+void AdmissionControl::onRejected(admission_result::type reason, const tstring& listener)
+{
+    ++ rejected_[reason];
+    ++ rejectedSince_;
+    if (!is_null(stats_))
+        ::InterlockedIncrement(&stats_->rejected);
+
+    if (!rejecting_)
+    {
+        LOG_WARN(logger_, _T("ʼַܾ '") << listener << _T("' ϵ - ") << toString(reason)
+                 << _T(", ǰ ") << sessions_);
+        rejecting_ = true;
+        return;
+    }
+
+    LOG_TRACE(logger_, _T("ַܾ '") << listener << _T("' ϵ - ") << toString(reason));
+}
+
+bool AdmissionControl::takeReserve()
+{
+    if (INVALID_SOCKET == reserve_)
+        return false;
+
+    ::closesocket(reserve_);
+    reserve_ = INVALID_SOCKET;
+    return true;
+}
+
+void AdmissionControl::restoreReserve()
+{
+    if (INVALID_SOCKET != reserve_)
+        return;
+
+    reserve_ = ::WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, 0, 0, WSA_FLAG_OVERLAPPED);
+    if (INVALID_SOCKET == reserve_)
+        LOG_WARN(logger_, _T("Ԥʧ - ") << lastError(::WSAGetLastError()));
+}
+
+void AdmissionControl::paused()
+{
+    ++ pauses_;
+    if (!is_null(stats_))
+        ::InterlockedIncrement(&stats_->acceptPauses);
+}
+
+void AdmissionControl::onLag(uint32_t lag)
+{
+    // ƽһ, żһĴ
+    lag_ = (lag_ * 7 + lag) / 8;
+
+    if (!shedding_ && lag_ > options_.maxLoopLag)
+    {
+        shedding_ = true;
+        LOG_WARN(logger_, _T("¼ѭӳ ") << lag_ << _T(" ,  ")
+                 << options_.maxLoopLag << _T(" , ʼܾ"));
+    }
+    else if (shedding_ && lag_ < options_.maxLoopLag / 2)
+    {
+        shedding_ = false;
+        LOG_WARN(logger_, _T("¼ѭӳٽ ") << lag_ << _T(" , ֹͣ"));
+    }
+
+    if (!is_null(stats_))
+        ::InterlockedExchange(&stats_->shedding, shedding_ ? 1 : 0);
+}
+
+bool AdmissionControl::isShedding() const
+{
+    return shedding_;
+}
+
+uint32_t AdmissionControl::loopLag() const
+{
+    return lag_;
+}
+
+size_t AdmissionControl::sessions() const
+{
+    return sessions_;
+}
+
+size_t AdmissionControl::rejected(admission_result::type reason) const
+{
+    return rejected_[reason];
+}
+
+bool AdmissionControl::isExhausted(int code)
+{
+    return WSAEMFILE == code
+           || WSAENOBUFS == code
+           || WSA_NOT_ENOUGH_MEMORY == code;
+}
+
+const tchar* AdmissionControl::toString(admission_result::type reason)
+{
+    switch (reason)
+    {
+    case admission_result::Accepted:
+        return _T("");
+    case admission_result::GlobalLimit:
+        return _T("ȫ");
+    case admission_result::ListenerLimit:
+        return _T("˿");
+    case admission_result::SourceLimit:
+        return _T("ͬһԴַ");
+    case admission_result::Overloaded:
+        return _T("¼ѭ");
+    case admission_result::Exhausted:
+        return _T("ڴ治");
+    default:
+        return _T("δ֪");
+    }
+}
+
+_jingxian_end
@@ -0,0 +1,290 @@
+
+#ifndef _AdmissionControl_H_
+#define _AdmissionControl_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <map>
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/networks/networking.h"
+# include "jingxian/networks/TimerQueue.h"
+
+_jingxian_begin
+
+struct ServerStats;
+
+/**
+ * ׼ƵĽ
+ */
+namespace admission_result
+{
+    enum type
+    {
+        /// 
+        Accepted = 0,
+        /// ȫ
+        GlobalLimit,
+        /// ˼˿ڵ
+        ListenerLimit,
+        /// ͬһԴַ
+        SourceLimit,
+        /// ¼ѭӳ̫, ڼ
+        Overloaded,
+        /// ڴ, ԤܺϹر
+        Exhausted,
+
+        Count
+    };
+}
+
+/**
+ * ԴַĿѰַϣ
+ *
+ * бԴַļ( IPv4 ַ, IPv6 ַ 64 λָ )ͼ, ͬ
+ * ַļͬ, ֻڲλϳͻ. λɴӵĹϣ, Զ޷
+ * ͬһ̽ϵĴַ. ̽, ɾʱǰƶ, Ҫ
+ * Ĺ.
+ */
+class SourceCounter
+{
+public:
+    SourceCounter();
+
+    /**
+     * һ
+     * @return һļ
+     */
+    uint32_t increase(uint64_t key);
+
+    /**
+     * һ,  0 ʱɾ
+     */
+    void decrease(uint64_t key);
+
+    uint32_t count(uint64_t key) const;
+
+    /**
+     * ͬԴַ
+     */
+    size_t size() const;
+
+    /**
+     * ȡԴַ( ˿ )ļ,  0
+     *
+     * IPv4 ֱַΪ; IPv6 ַñ 64 λָ, λ 1,
+     *  IPv4 ļͬ.
+     */
+    uint64_t key(const sockaddr* addr) const;
+
+private:
+    struct Entry
+    {
+        /// Ϊ 0 ʾ
+        uint64_t key;
+        uint32_t count;
+    };
+
+    size_t slot(uint64_t key) const;
+    size_t find(uint64_t key) const;
+    void grow();
+
+    std::vector<Entry> entries_;
+    size_t mask_;
+    size_t size_;
+    /// ÿʱѡȡĹϣ
+    uint64_t seed_;
+};
+
+/**
+ * ˿ڽʱ׼
+ *
+ * ȫ, ÿ˿ڵĺÿԴַĲ, ¼ѭӳ̫ʱ
+ * ܾе(  ), Ԥһ, ʱӺ
+ * ر, ÿͻ˾֪ܾ, һֱڶ. ֻ¼ѭ߳ʹ.
+ */
+class AdmissionControl
+{
+public:
+    struct Options
+    {
+        Options()
+                : maxSessions(0)
+                , maxListenerSessions(0)
+                , maxSourceSessions(0)
+                , maxLoopLag(0)
+        {
+        }
+
+        /// ܵ, Ϊ 0 ʱ
+        size_t maxSessions;
+        /// ûеõļ˿ڵ, Ϊ 0 ʱ
+        size_t maxListenerSessions;
+        /// ͬһԴַĲ, Ϊ 0 ʱ
+        size_t maxSourceSessions;
+        /// ¼ѭӳٳʱ, Ϊ 0 ʱ
+        uint32_t maxLoopLag;
+    };
+
+    /**
+     * ܵռõλ, ӹرʱ release() 
+     */
+    class Ticket
+    {
+    public:
+        Ticket()
+                : listener_(null_ptr)
+                , source_(0)
+        {
+        }
+
+        bool isValid() const
+        {
+            return !is_null(listener_);
+        }
+
+    private:
+        friend class AdmissionControl;
+
+        size_t* listener_;
+        uint64_t source_;
+    };
+
+    AdmissionControl();
+
+    ~AdmissionControl();
+
+    Options& options();
+
+    /**
+     * ָһ˿ڵ
+     * @param[ in ] address ĵַ, ʽͬ Endpoint::address()
+     */
+    void listenerLimit(const tstring& address, size_t limit);
+
+    /**
+     * ָͳݵĴλ
+     */
+    void stats(ServerStats* stats);
+
+    /**
+     * Ԥ, ÿʼ¼ѭӳ
+     */
+    void start(TimerQueue& timers);
+
+    void stop(TimerQueue& timers);
+
+    /**
+     * жǷһ, ʱռһλ
+     * @param[ in ] listener ĵַ
+     * @param[ in ] source Դַ
+     * @param[ out ] ticket ռõλ
+     */
+    admission_result::type admit(const tstring& listener, const sockaddr* source, Ticket& ticket);
+
+    /**
+     * ռõλ
+     */
+    void release(Ticket& ticket);
+
+    /**
+     * ¼һûо admit() ;ܾ
+     */
+    void reject(admission_result::type reason, const tstring& listener);
+
+    /**
+     * رԤԱһ
+     * @return ûԤʱ false
+     */
+    bool takeReserve();
+
+    /**
+     * ´Ԥ
+     */
+    void restoreReserve();
+
+    /**
+     * ¼һΪԴͣ
+     */
+    void paused();
+
+    /**
+     * Ƿڼ
+     */
+    bool isShedding() const;
+
+    /**
+     * õ¼ѭӳ(  )
+     */
+    uint32_t loopLag() const;
+
+    size_t sessions() const;
+
+    size_t rejected(admission_result::type reason) const;
+
+    /**
+     * ǲǱʾڴ
+     */
+    static bool isExhausted(int code);
+
+    static const tchar* toString(admission_result::type reason);
+
+private:
+    NOCOPY(AdmissionControl);
+
+    /**
+     * ʱ¼ѭӳ
+     */
+    class LagProbe : public Timer
+    {
+    public:
+        LagProbe()
+                : owner_(null_ptr)
+                , timers_(null_ptr)
+                , expected_(0)
+        {
+        }
+
+        void start(AdmissionControl* owner, TimerQueue* timers);
+
+        virtual void onTimeout();
+
+    private:
+        AdmissionControl* owner_;
+        TimerQueue* timers_;
+        uint64_t expected_;
+    };
+
+    void onLag(uint32_t lag);
+    void onRejected(admission_result::type reason, const tstring& listener);
+
+    Options options_;
+    std::map<tstring, size_t> listenerLimits_;
+    std::map<tstring, size_t> listeners_;
+    SourceCounter sources_;
+    size_t sessions_;
+
+    SOCKET reserve_;
+    LagProbe probe_;
+    uint32_t lag_;
+    bool shedding_;
+
+    /// ϴνӺǷܾ, ֻ״̬仯ʱд־
+    bool rejecting_;
+    size_t rejectedSince_;
+    size_t rejected_[admission_result::Count];
+    size_t pauses_;
+
+    ServerStats* stats_;
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_AdmissionControl_H_
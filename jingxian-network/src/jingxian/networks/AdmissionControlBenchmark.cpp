@@ -0,0 +1,203 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/AdmissionControl.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    sockaddr_in makeAddress(uint32_t ip)
+    {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(ip);
+        addr.sin_port = htons((u_short)(ip & 0xFFFF));
+        return addr;
+    }
+}
+
+TEST(admission, sourceCounter)
+{
+    SourceCounter counter;
+    ASSERT_TRUE(0 == counter.size());
+    ASSERT_TRUE(0 == counter.count(12345));
+
+    ASSERT_TRUE(1 == counter.increase(12345));
+    ASSERT_TRUE(2 == counter.increase(12345));
+    ASSERT_TRUE(1 == counter.size());
+
+    counter.decrease(12345);
+    ASSERT_TRUE(1 == counter.count(12345));
+    counter.decrease(12345);
+    ASSERT_TRUE(0 == counter.count(12345));
+    ASSERT_TRUE(0 == counter.size());
+
+    // ڵ
+    counter.decrease(12345);
+    ASSERT_TRUE(0 == counter.size());
+
+    // ݺ, ͬһλϵɾҵ
+    for (uint32_t i = 1; i <= 1000; ++ i)
+        counter.increase(i * 64);
+    ASSERT_TRUE(1000 == counter.size());
+    for (uint32_t i = 1; i <= 1000; i += 2)
+        counter.decrease(i * 64);
+    ASSERT_TRUE(500 == counter.size());
+
+    bool found = true;
+    for (uint32_t i = 1; i <= 1000; ++ i)
+    {
+        if (counter.count(i * 64) != ((0 == i % 2) ? 1u : 0u))
+            found = false;
+    }
+    ASSERT_TRUE(found);
+}
+
+TEST(admission, sourceKey)
+{
+    SourceCounter counter;
+
+    // ˿ڲͬͬһַͬ, IPv4 ļǵַ
+    sockaddr_in a = makeAddress(0x0A000001);
+    sockaddr_in b = makeAddress(0x0A000001);
+    b.sin_port = htons(4321);
+    sockaddr_in c = makeAddress(0x0A000002);
+
+    ASSERT_TRUE(counter.key((sockaddr*)&a) == counter.key((sockaddr*)&b));
+    ASSERT_FALSE(counter.key((sockaddr*)&a) == counter.key((sockaddr*)&c));
+    ASSERT_FALSE(0 == counter.key((sockaddr*)&a));
+    ASSERT_TRUE(a.sin_addr.s_addr == (uint32_t)counter.key((sockaddr*)&a));
+
+    // IPv6 ַָ IPv4 ļͬ, ӲͬĶָƲͬ
+    sockaddr_in6 d;
+    memset(&d, 0, sizeof(d));
+    d.sin6_family = AF_INET6;
+    d.sin6_addr.s6_addr[0] = 0x20;
+    d.sin6_addr.s6_addr[15] = 0x01;
+    sockaddr_in6 e = d;
+    e.sin6_port = htons(4321);
+    sockaddr_in6 f = d;
+    f.sin6_addr.s6_addr[15] = 0x02;
+
+    ASSERT_TRUE(counter.key((sockaddr*)&d) == counter.key((sockaddr*)&e));
+    ASSERT_FALSE(counter.key((sockaddr*)&d) == counter.key((sockaddr*)&f));
+    ASSERT_TRUE(0 != (counter.key((sockaddr*)&d) >> 63));
+
+    SourceCounter other;
+    ASSERT_FALSE(counter.key((sockaddr*)&d) == other.key((sockaddr*)&d));
+}
+
+TEST(admission, sourceNoCollision)
+{
+    AdmissionControl admission;
+    admission.options().maxSourceSessions = 1;
+
+    // ÿַֻһ, ַͬļܺһ
+    std::vector<AdmissionControl::Ticket> tickets(20000);
+    bool accepted = true;
+    for (size_t i = 0; i < tickets.size(); ++ i)
+    {
+        sockaddr_in addr = makeAddress(0x0A000000 + (uint32_t)i * 7919);
+        if (admission_result::Accepted != admission.admit(_T("0.0.0.0:80"), (sockaddr*)&addr, tickets[i]))
+            accepted = false;
+    }
+    ASSERT_TRUE(accepted);
+
+    sockaddr_in again = makeAddress(0x0A000000 + 7919);
+    AdmissionControl::Ticket ticket;
+    ASSERT_TRUE(admission_result::SourceLimit == admission.admit(_T("0.0.0.0:80"), (sockaddr*)&again, ticket));
+
+    for (size_t i = 0; i < tickets.size(); ++ i)
+        admission.release(tickets[i]);
+    ASSERT_TRUE(0 == admission.sessions());
+}
+
+TEST(admission, limits)
+{
+    AdmissionControl admission;
+    admission.options().maxSessions = 4;
+    admission.options().maxListenerSessions = 3;
+    admission.options().maxSourceSessions = 2;
+    admission.listenerLimit(_T("0.0.0.0:80"), 1);
+
+    sockaddr_in a = makeAddress(0x0A000001);
+    sockaddr_in b = makeAddress(0x0A000002);
+    sockaddr_in c = makeAddress(0x0A000003);
+
+    AdmissionControl::Ticket tickets[5];
+    ASSERT_TRUE(admission_result::Accepted == admission.admit(_T("0.0.0.0:80"), (sockaddr*)&a, tickets[0]));
+    ASSERT_TRUE(tickets[0].isValid());
+    ASSERT_TRUE(admission_result::ListenerLimit == admission.admit(_T("0.0.0.0:80"), (sockaddr*)&b, tickets[4]));
+    ASSERT_FALSE(tickets[4].isValid());
+
+    ASSERT_TRUE(admission_result::Accepted == admission.admit(_T("0.0.0.0:81"), (sockaddr*)&a, tickets[1]));
+    ASSERT_TRUE(admission_result::SourceLimit == admission.admit(_T("0.0.0.0:81"), (sockaddr*)&a, tickets[4]));
+    ASSERT_TRUE(admission_result::Accepted == admission.admit(_T("0.0.0.0:81"), (sockaddr*)&b, tickets[2]));
+    ASSERT_TRUE(admission_result::Accepted == admission.admit(_T("0.0.0.0:82"), (sockaddr*)&c, tickets[3]));
+    ASSERT_TRUE(admission_result::GlobalLimit == admission.admit(_T("0.0.0.0:82"), (sockaddr*)&c, tickets[4]));
+    ASSERT_TRUE(4 == admission.sessions());
+
+    // ٽ, ظ
+    admission.release(tickets[0]);
+    admission.release(tickets[0]);
+    ASSERT_TRUE(3 == admission.sessions());
+    ASSERT_TRUE(admission_result::Accepted == admission.admit(_T("0.0.0.0:80"), (sockaddr*)&a, tickets[0]));
+
+    ASSERT_TRUE(1 == admission.rejected(admission_result::ListenerLimit));
+    ASSERT_TRUE(1 == admission.rejected(admission_result::SourceLimit));
+    ASSERT_TRUE(1 == admission.rejected(admission_result::GlobalLimit));
+
+    for (size_t i = 0; i < 4; ++ i)
+        admission.release(tickets[i]);
+    ASSERT_TRUE(0 == admission.sessions());
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(admission_unlimited)
+{
+    AdmissionControl admission;
+    sockaddr_in addr = makeAddress(0x0A000001);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        AdmissionControl::Ticket ticket;
+        admission.admit(_T("0.0.0.0:80"), (sockaddr*)&addr, ticket);
+        admission.release(ticket);
+    }
+}
+
+BENCHMARK(admission_many_sources)
+{
+    AdmissionControl admission;
+    admission.options().maxSourceSessions = 16;
+
+    // һԴַ, ԹϣдʱĿ
+    std::vector<AdmissionControl::Ticket> tickets(10000);
+    for (size_t i = 0; i < tickets.size(); ++ i)
+    {
+        sockaddr_in addr = makeAddress(0x0A000000 + (uint32_t)i);
+        admission.admit(_T("0.0.0.0:80"), (sockaddr*)&addr, tickets[i]);
+    }
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        sockaddr_in addr = makeAddress(0x0B000000 + (uint32_t)(i % 20000));
+        AdmissionControl::Ticket ticket;
+        admission.admit(_T("0.0.0.0:80"), (sockaddr*)&addr, ticket);
+        admission.release(ticket);
+    }
+
+    for (size_t i = 0; i < tickets.size(); ++ i)
+        admission.release(tickets[i]);
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -3,23 +3,70 @@
 # include "jingxian/exception.h"
 # include "jingxian/directory.h"
 # include "jingxian/networks/IOCPServer.h"
+# include "jingxian/networks/ReactorShards.h"
 # include "jingxian/networks/TCPAcceptor.h"
 # include "jingxian/networks/TCPConnector.h"
-# include "jingxian/networks/commands/RunCommand.h"
+# include "jingxian/networks/TLSAcceptor.h"
 # include "jingxian/networks/commands/command_queue.h"
 
 _jingxian_begin
 
+namespace
+{
+    /**
+     * 在主循环的线程中交还分片上的连接占用的位置
+     */
+    class ReleaseAdmission : public IRunnable
+    {
+    public:
+        ReleaseAdmission(AdmissionControl& admission, AdmissionControl::Ticket& ticket)
+                : admission_(admission)
+                , ticket_(ticket)
+        {
+        }
+
+        virtual void run()
+        {
+            admission_.release(ticket_);
+        }
+
+    private:
+        NOCOPY(ReleaseAdmission);
+
+        AdmissionControl& admission_;
+        AdmissionControl::Ticket ticket_;
+    };
+}
+
 IOCPServer::IOCPServer(void)
         : completion_port_(null_ptr)
+        , closed_(0)
+        , senders_(0)
+        , wakeupFailed_(0)
         , isRunning_(false)
+        , coroutines_(&timers_)
+        , primary_(null_ptr)
+        , shards_(null_ptr)
+        , load_(0)
+        , stats_(&localStats_)
         , logger_(_T("jingxian.system"))
         , toString_(_T("IOCPServer"))
 {
 
+    localStats_.connections = 0;
+    localStats_.sessions = 0;
+    localStats_.rejected = 0;
+    localStats_.acceptPauses = 0;
+    localStats_.shedding = 0;
+    localStats_.memory = 0;
+
+    admission_.stats(stats_);
+    memory_.initialize(this);
+    memory_.stats(stats_);
     resolver_.initialize(this);
-    acceptorFactories_[_T("tcp")] = new TCPAcceptorFactory(this);
-    connectionBuilders_[_T("tcp")] = new TCPConnector(this);
+    acceptorFactories_[Endpoint::tcp()] = new TCPAcceptorFactory(this);
+    acceptorFactories_[Endpoint::tls()] = new TLSAcceptorFactory(this, acceptorFactories_[Endpoint::tcp()]);
+    connectionBuilders_[Endpoint::tcp()] = new TCPConnector(this);
 
     path_ = simplify(getApplicationDirectory());
 
@@ -30,14 +77,14 @@ IOCPServer::IOCPServer(void)
 
 IOCPServer::~IOCPServer(void)
 {
-    for (stdext::hash_map<tstring, IAcceptorFactory* >::iterator it = acceptorFactories_.begin()
+    for (stdext::hash_map<uint32_t, IAcceptorFactory* >::iterator it = acceptorFactories_.begin()
             ; it != acceptorFactories_.end()
             ; ++ it)
     {
         delete(it->second);
     }
 
-    for (stdext::hash_map<tstring, IConnectionBuilder* >::iterator it = connectionBuilders_.begin()
+    for (stdext::hash_map<uint32_t, IConnectionBuilder* >::iterator it = connectionBuilders_.begin()
             ; it != connectionBuilders_.end()
             ; ++ it)
     {
@@ -46,11 +93,17 @@ IOCPServer::~IOCPServer(void)
 
     close();
 
-    for (stdext::hash_map<tstring, ListenPort*>::iterator it = listenPorts_.begin()
+    for (stdext::hash_map<Endpoint, ListenPort*>::iterator it = listenPorts_.begin()
             ; it != listenPorts_.end(); ++it)
     {
         delete(it->second);
     }
+
+    for (stdext::hash_map<Endpoint, SOCKET>::iterator it = sharedSockets_.begin()
+            ; it != sharedSockets_.end(); ++it)
+    {
+        closesocket(it->second);
+    }
 }
 
 
@@ -81,7 +134,7 @@ bool IOCPServer::initialize(size_t number_of_threads)
 
 bool IOCPServer::isPending()
 {
-    for (stdext::hash_map<tstring, ListenPort*>::iterator it = listenPorts_.begin()
+    for (stdext::hash_map<Endpoint, ListenPort*>::iterator it = listenPorts_.begin()
             ; it != listenPorts_.end(); ++it)
     {
         if (it->second->isPending())
@@ -112,11 +165,35 @@ void IOCPServer::close(void)
     if (is_null(completion_port_))
         return ;
 
+    // 线程池中的任务会将后续处理发到完成端口, 必须在关闭完成端口前停止
+    executor_.stop();
+
     wait(3*60);
+    runTasks();
+    admission_.stop(timers_);
+    memory_.stop(timers_);
+
+    // 连接都已关闭, 写完还在缓冲区中的记录
+    capture_.stop();
+
+    // 先拒绝新的任务, 再等已经通过检查的 send() 把任务放入队列并唤醒完
+    // 成端口后才关闭, 否则它们的任务会漏掉, 唤醒也会发到已关闭的句柄上
+    ::InterlockedExchange(&closed_, 1);
+    while (0 != senders_)
+        ::Sleep(0);
 
     ::CloseHandle(completion_port_);
     completion_port_ = null_ptr;
 
+    // 关闭后不再执行队列中剩下的任务
+    IRunnable* task = tasks_.pop_all();
+    while (!is_null(task))
+    {
+        IRunnable* next = mpsc_queue<IRunnable>::next(task);
+        delete task;
+        task = next;
+    }
+
 }
 
 /// If the function dequeues a completion packet for a successful I/O operation
@@ -161,17 +238,22 @@ int IOCPServer::handle_events(uint32_t milli_seconds)
 
     ULONG_PTR completion_key = 0;
 
+    // 每次循环开始时成批执行其它线程提交的任务
+    runTasks();
+
+    // 最多等到最近一个定时器到期
     BOOL result = ::GetQueuedCompletionStatus(completion_port_,
                   &bytes_transferred,
                   &completion_key,
                   &overlapped,
-                  milli_seconds);
+                  timers_.timeout(milli_seconds));
     if (FALSE == result && is_null(overlapped))
     {
         switch (GetLastError())
         {
         case WAIT_TIMEOUT:
-            return 1;
+            // 为定时器提前返回的不算空闲
+            return (0 == timers_.runExpired()) ? 1 : 0;
 
         case ERROR_SUCCESS:
             return 0;
@@ -181,6 +263,11 @@ int IOCPServer::handle_events(uint32_t milli_seconds)
             return -1;
         }
     }
+    else if (is_null(overlapped))
+    {
+        // send() 发来的唤醒
+        runTasks();
+    }
     else
     {
         ICommand *asynch_result = (ICommand *) overlapped;
@@ -193,6 +280,9 @@ int IOCPServer::handle_events(uint32_t milli_seconds)
                                         (void *) completion_key,
                                         error);
     }
+
+    // 一直有完成事件时也要执行到期的定时器
+    timers_.runExpired();
     return 0;
 }
 
@@ -255,8 +345,8 @@ void IOCPServer::connectWith(const tchar* endPoint
                              , OnBuildConnectionError onError
                              , void* context)
 {
-    StringArray<tchar> sa = split_with_string(endPoint, _T("://"));
-    if (2 != sa.size())
+    Endpoint addr;
+    if (!endpoints_.parse(endPoint, addr))
     {
         LOG_ERROR(logger_, _T("尝试连接到 '") << endPoint
                   << _T("' 时发生错误 - 地址格式不正确"));
@@ -266,16 +356,24 @@ void IOCPServer::connectWith(const tchar* endPoint
         return ;
     }
 
-    stdext::hash_map<tstring, IConnectionBuilder*>::iterator it =
-        connectionBuilders_.find(to_lower<tstring>(sa.ptr(0)));
+    connectWith(addr, onComplete, onError, context);
+}
+
+void IOCPServer::connectWith(const Endpoint& endPoint
+                             , OnBuildConnectionComplete onComplete
+                             , OnBuildConnectionError onError
+                             , void* context)
+{
+    stdext::hash_map<uint32_t, IConnectionBuilder*>::iterator it =
+        connectionBuilders_.find(endPoint.scheme());
     if (it == connectionBuilders_.end())
     {
         LOG_ERROR(logger_, _T("尝试连接到 '") << endPoint
-                  << _T("' 时发生错误 - 不能识别的协议‘") << sa.ptr(0)
+                  << _T("' 时发生错误 - 不能识别的协议‘") << endPoint.schemeName()
                   << _T("’"));
 
         tstring err = _T("不能识别的协议 - ");
-        err += sa.ptr(0);
+        err += endPoint.schemeName();
         err += _T("!");
 
         ErrorCode error(err.c_str());
@@ -283,54 +381,117 @@ void IOCPServer::connectWith(const tchar* endPoint
         return ;
     }
 
-
     it->second->connect(endPoint, onComplete, onError, context);
 }
 
 bool IOCPServer::listenWith(const tchar* endPoint, IProtocolFactory* protocolFactory)
 {
-    // NOTICE: 用字符串地址直接查找是不好的，转换成 IEndpoint 对象进行比较才更准确
-    tstring addr = endPoint;
-    stdext::hash_map<tstring, ListenPort*>::iterator acceptorIt = listenPorts_.find(to_lower<tstring>(addr));
-    if (listenPorts_.end() != acceptorIt)
+    Endpoint addr;
+    if (!Endpoint::parse(endPoint, addr))
     {
-        LOG_TRACE(logger_, _T("已经创建过监听器 '") << endPoint
-                  << _T("' 了!"));
+        LOG_ERROR(logger_, _T("尝试监听地址 '") << endPoint
+                  << _T("' 时发生错误 - 地址格式不正确!"));
         return false;
     }
 
-    StringArray<tchar> sa = split_with_string(endPoint, _T("://"));
-    if (2 != sa.size())
+    return listenWith(addr, protocolFactory);
+}
+
+bool IOCPServer::listenWith(const Endpoint& endPoint, IProtocolFactory* protocolFactory)
+{
+    stdext::hash_map<Endpoint, ListenPort*>::iterator acceptorIt = listenPorts_.find(endPoint);
+    if (listenPorts_.end() != acceptorIt)
     {
-        LOG_ERROR(logger_, _T("尝试监听地址 '") << endPoint
-                  << _T("' 时发生错误 - 地址格式不正确!"));
+        LOG_TRACE(logger_, _T("已经创建过监听器 '") << endPoint
+                  << _T("' 了!"));
         return false;
     }
 
-    stdext::hash_map<tstring, IAcceptorFactory*>::iterator it =
-        acceptorFactories_.find(to_lower<tstring>(sa.ptr(0)));
+    stdext::hash_map<uint32_t, IAcceptorFactory*>::iterator it =
+        acceptorFactories_.find(endPoint.scheme());
     if (it == acceptorFactories_.end())
     {
         LOG_ERROR(logger_, _T("尝试监听地址 '") << endPoint
-                  << _T("' 时发生错误 - 不能识别的协议‘") << sa.ptr(0)
+                  << _T("' 时发生错误 - 不能识别的协议‘") << endPoint.schemeName()
                   << _T("’"));
         return false;
     }
 
     listenPorts_[endPoint] = new ListenPort(this, protocolFactory
-                                            , it->second->createAcceptor(sa.ptr(1)));
+                                            , it->second->createAcceptor(endPoint.address().c_str()));
+
+    // tls 连接共用本对象的会话缓存, 不分给分片
+    if (Endpoint::tcp() == endPoint.scheme())
+        shardedListeners_[endPoint.address()] = protocolFactory;
     return true;
 }
 
 bool IOCPServer::send(IRunnable* runnable)
 {
-    std::auto_ptr< ICommand > ptr(new RunCommand(completion_port_, runnable));
-    if (ptr->execute())
+    if (is_null(runnable))
+        ThrowException1(ArgumentNullException, _T("runnable"));
+
+    ::InterlockedIncrement(&senders_);
+    if (0 != closed_ || is_null(completion_port_))
     {
-        ptr.release();
-        return true;
+        ::InterlockedDecrement(&senders_);
+        delete runnable;
+        return false;
     }
-    return false;
+
+    // 队列由空变为非空时才需要唤醒, 其它时候已经有一个唤醒在路上了. 上次
+    // 唤醒失败时没有唤醒在路上, 要重新唤醒
+    bool first = tasks_.push(runnable);
+    if ((first || 0 != ::InterlockedExchange(&wakeupFailed_, 0)) && !wakeup())
+    {
+        ::InterlockedExchange(&wakeupFailed_, 1);
+        LOG_ERROR(logger_ , _T("唤醒完成端口失败 - ") << lastError(::GetLastError()) << _T(" !"));
+    }
+
+    ::InterlockedDecrement(&senders_);
+    return true;
+}
+
+bool IOCPServer::wakeup()
+{
+    DWORD bytes_transferred = 0;
+    ULONG_PTR comp_key = reinterpret_cast < ULONG_PTR >(&tasks_);
+
+    return TRUE == ::PostQueuedCompletionStatus(completion_port_,  // completion port
+            bytes_transferred ,      // xfer count
+            comp_key,               // completion key
+            null_ptr                  // overlapped
+                                               );
+}
+
+size_t IOCPServer::runTasks()
+{
+    // 在取出任务之前清除, 之后加入的任务由 send() 唤醒
+    ::InterlockedExchange(&wakeupFailed_, 0);
+
+    size_t count = 0;
+    IRunnable* task = tasks_.pop_all();
+    while (!is_null(task))
+    {
+        IRunnable* next = mpsc_queue<IRunnable>::next(task);
+        try
+        {
+            task->run();
+        }
+        catch (std::exception& e)
+        {
+            LOG_FATAL(logger_ , "error :" << e.what());
+        }
+        catch (...)
+        {
+            LOG_FATAL(logger_ , "unkown error!");
+        }
+        delete task;
+
+        task = next;
+        ++ count;
+    }
+    return count;
 }
 
 void IOCPServer::runForever()
@@ -339,11 +500,15 @@ void IOCPServer::runForever()
 
     isRunning_ = true;
 
+    // 先打开预留的描述符, 监听端口启动后就可能用到
+    admission_.start(timers_);
+    memory_.start(timers_, is_null(primary_));
+
     std::list<ListenPort*> instances;
-    for (stdext::hash_map<tstring, ListenPort*>::iterator it = listenPorts_.begin()
+    for (stdext::hash_map<Endpoint, ListenPort*>::iterator it = listenPorts_.begin()
             ; it != listenPorts_.end();)
     {
-        stdext::hash_map<tstring, ListenPort* >::iterator current =  it++;
+        stdext::hash_map<Endpoint, ListenPort* >::iterator current =  it++;
         if (!current->second->start())
         {
             isRunning_ = false;
@@ -383,10 +548,10 @@ void IOCPServer::runForever()
 
     LOG_CRITICAL(logger_, _T("服务停止,开始清理工作!"));
 
-    for (stdext::hash_map<tstring, ListenPort*>::iterator it = listenPorts_.begin()
+    for (stdext::hash_map<Endpoint, ListenPort*>::iterator it = listenPorts_.begin()
             ; it != listenPorts_.end();)
     {
-        stdext::hash_map<tstring, ListenPort* >::iterator current =  it++;
+        stdext::hash_map<Endpoint, ListenPort* >::iterator current =  it++;
         current->second->stop();
     }
 
@@ -419,6 +584,11 @@ IDNSResolver& IOCPServer::resolver()
     return resolver_;
 }
 
+WorkStealingExecutor& IOCPServer::executor()
+{
+    return is_null(primary_) ? executor_ : primary_->executor_;
+}
+
 const tstring& IOCPServer::basePath() const
 {
     return path_;
@@ -431,14 +601,164 @@ void IOCPServer::onIdle()
 
 SessionList::iterator IOCPServer::addSession(ISession* session)
 {
+    InterlockedIncrement(&stats_->connections);
+    InterlockedIncrement(&stats_->sessions);
+    ++ load_;
     return sessions_.insert(sessions_.end(), session);
 }
 
 void IOCPServer::removeSession(SessionList::iterator& it)
 {
+    InterlockedDecrement(&stats_->sessions);
+    -- load_;
     sessions_.erase(it);
 }
 
+SessionList& IOCPServer::sessions()
+{
+    return sessions_;
+}
+
+void IOCPServer::addSharedSocket(const tstring& endPoint, SOCKET socket)
+{
+    Endpoint key;
+    if (!Endpoint::parse(endPoint.c_str(), key))
+    {
+        LOG_ERROR(logger_, _T("共享的监听地址 '") << endPoint
+                  << _T("' 格式不正确!"));
+        closesocket(socket);
+        return;
+    }
+
+    stdext::hash_map<Endpoint, SOCKET>::iterator it = sharedSockets_.find(key);
+    if (sharedSockets_.end() != it)
+        closesocket(it->second);
+
+    sharedSockets_[key] = socket;
+}
+
+SOCKET IOCPServer::takeSharedSocket(const tstring& endPoint)
+{
+    Endpoint key;
+    if (!Endpoint::parse(endPoint.c_str(), key))
+        return INVALID_SOCKET;
+
+    stdext::hash_map<Endpoint, SOCKET>::iterator it = sharedSockets_.find(key);
+    if (sharedSockets_.end() == it)
+        return INVALID_SOCKET;
+
+    SOCKET socket = it->second;
+    sharedSockets_.erase(it);
+    return socket;
+}
+
+void IOCPServer::stats(ServerStats* stats)
+{
+    stats_ = is_null(stats) ? &localStats_ : stats;
+    admission_.stats(stats_);
+    memory_.stats(stats_);
+}
+
+const ServerStats& IOCPServer::stats() const
+{
+    return *stats_;
+}
+
+TrafficCapture& IOCPServer::capture()
+{
+    return is_null(primary_) ? capture_ : primary_->capture_;
+}
+
+TimerQueue& IOCPServer::timers()
+{
+    return timers_;
+}
+
+CoroutineScheduler& IOCPServer::coroutines()
+{
+    return coroutines_;
+}
+
+TrafficShaper& IOCPServer::shaper()
+{
+    return shaper_;
+}
+
+AdmissionControl& IOCPServer::admission()
+{
+    return admission_;
+}
+
+MemoryBudget& IOCPServer::memory()
+{
+    return memory_;
+}
+
+TLSContext& IOCPServer::tls()
+{
+    return tls_;
+}
+
+void IOCPServer::joinAsShard(IOCPServer* primary, size_t shares)
+{
+    if (is_null(primary))
+        ThrowException1(ArgumentNullException, _T("primary"));
+
+    primary_ = primary;
+    stats(primary->stats_);
+    shaper_.share(&(primary->shaper_));
+    memory_.share(primary->memory_, shares);
+    coroutines_.stackSize(primary->coroutines_.stackSize());
+    coroutines_.maxPooled(primary->coroutines_.maxPooled());
+    toString_ = _T("IOCPServer[shard]");
+}
+
+void IOCPServer::shards(ReactorShards* shards)
+{
+    shards_ = shards;
+}
+
+ReactorShards* IOCPServer::shards()
+{
+    return shards_;
+}
+
+LONG IOCPServer::load() const
+{
+    return load_;
+}
+
+bool IOCPServer::handoff(SOCKET socket
+                         , const tstring& host
+                         , const tstring& peer
+                         , const tstring& listenAddr
+                         , AdmissionControl::Ticket& ticket)
+{
+    if (is_null(shards_))
+        return false;
+
+    std::map<tstring, IProtocolFactory*>::iterator it = shardedListeners_.find(listenAddr);
+    if (shardedListeners_.end() == it)
+        return false;
+
+    return shards_->handoff(socket, host, peer, listenAddr, it->second, ticket);
+}
+
+void IOCPServer::releaseAdmission(AdmissionControl::Ticket& ticket, IOCPServer* from)
+{
+    if (!ticket.isValid())
+        return;
+
+    if (this == from)
+    {
+        admission_.release(ticket);
+        return;
+    }
+
+    send(new ReleaseAdmission(admission_, ticket));
+    ticket = AdmissionControl::Ticket();
+}
+
 void IOCPServer::onExeception(int errCode, const tstring& description)
 {
     LOG_ERROR(logger_, _T("发生错误 - '") << errCode << _T("' ")
@@ -10,6 +10,7 @@
 
 // Include files
 # include <hash_map>
+# include <map>
 # include "jingxian/string/string.h"
 # include "jingxian/logging/logging.h"
 # include "jingxian/IReactorCore.h"
@@ -17,14 +18,43 @@
 # include "jingxian/networks/commands/ICommand.h"
 # include "jingxian/networks/connection_status.h"
 # include "jingxian/networks/networking.h"
+# include "jingxian/coroutine/Coroutine.h"
+# include "jingxian/networks/AdmissionControl.h"
+# include "jingxian/networks/MemoryBudget.h"
+# include "jingxian/networks/TLSContext.h"
 # include "jingxian/networks/ThreadDNSResolver.h"
+# include "jingxian/networks/TimerQueue.h"
+# include "jingxian/networks/TrafficCapture.h"
+# include "jingxian/networks/TrafficShaper.h"
+# include "jingxian/networks/WorkStealingExecutor.h"
+# include "jingxian/threading/mpsc_queue.h"
 # include "jingxian/networks/ListenPort.H"
 
 _jingxian_begin
 
+class ReactorShards;
 
 typedef std::list<ISession*> SessionList;
 
+/**
+ * ͳ, ģʽλڹڴ, ɼؽ̻
+ */
+struct ServerStats
+{
+    /// ۼƵ
+    volatile LONG connections;
+    /// ǰ
+    volatile LONG sessions;
+    /// ׼ƾܾ
+    volatile LONG rejected;
+    /// Ϊڴ治ͣӵĴ
+    volatile LONG acceptPauses;
+    /// Ƿڼ
+    volatile LONG shedding;
+    /// ̵ڴϼ( KB )
+    volatile LONG memory;
+};
+
 class IOCPServer : public IReactorCore
 {
 public:
@@ -52,6 +82,19 @@ public:
      */
     virtual bool listenWith(const tchar* endPoint, IProtocolFactory* protocolFactory);
 
+    /**
+     * @implements connectWith
+     */
+    virtual void connectWith(const Endpoint& endPoint
+                             , OnBuildConnectionComplete onComplete
+                             , OnBuildConnectionError onError
+                             , void* context);
+
+    /**
+     * @implements listenWith
+     */
+    virtual bool listenWith(const Endpoint& endPoint, IProtocolFactory* protocolFactory);
+
 
     /**
      * @implements send
@@ -83,6 +126,11 @@ public:
      */
     virtual IDNSResolver& resolver();
 
+    /**
+     * @implements executor
+     */
+    virtual WorkStealingExecutor& executor();
+
     /**
      *  ʱִеĻصԼ̳б
      */
@@ -111,6 +159,101 @@ public:
      */
     void removeSession(SessionList::iterator& it);
 
+    /**
+     * е( ֻ¼ѭ߳ʹ )
+     */
+    SessionList& sessions();
+
+    /**
+     * һɼؽ̹ļ socket, õַʱֱʹ
+     * @param[ in ] endPoint ĵַ,  tcp://0.0.0.0:80
+     */
+    void addSharedSocket(const tstring& endPoint, SOCKET socket);
+
+    /**
+     * ȡļ socket, ûʱ INVALID_SOCKET
+     */
+    SOCKET takeSharedSocket(const tstring& endPoint);
+
+    /**
+     * ָͳݵĴλ( ģʽָڴ )
+     */
+    void stats(ServerStats* stats);
+
+    const ServerStats& stats() const;
+
+    /**
+     * շݵץ
+     */
+    TrafficCapture& capture();
+
+    /**
+     * @implements timers
+     */
+    virtual TimerQueue& timers();
+
+    /**
+     * @implements coroutines
+     */
+    virtual CoroutineScheduler& coroutines();
+
+    /**
+     * , ûͼ˿ڵ
+     */
+    TrafficShaper& shaper();
+
+    /**
+     * ʱ׼( ֻ¼ѭ߳ʹ )
+     */
+    AdmissionControl& admission();
+
+    /**
+     * ڴԤ( ֻ¼ѭ߳ʹ )
+     */
+    MemoryBudget& memory();
+
+    /**
+     * tls:// ˿ڹõ TLS úͻỰ
+     */
+    TLSContext& tls();
+
+    /**
+     * Ϊ primary һƬ, ʹ primary ̳߳, ץͳ, 
+     * ڴԤЭ. ÿӵٲ, ˿ںû
+     * primary Ͱ, ڴԤ㰴Ƭƽ̯
+     * @param[ in ] shares Ƭ
+     */
+    void joinAsShard(IOCPServer* primary, size_t shares);
+
+    /**
+     * ܵ tcp ҪָķƬ, Ϊ null_ptr ʱɱ
+     */
+    void shards(ReactorShards* shards);
+
+    ReactorShards* shards();
+
+    /**
+     * ǰ, ߳жȡ
+     */
+    LONG load() const;
+
+    /**
+     * һսܵӽķƬ
+     * @return Ϊ false ʱɵߴ;  socket  ticket Ѿ
+     * ˱ķƬ
+     */
+    bool handoff(SOCKET socket
+                 , const tstring& host
+                 , const tstring& peer
+                 , const tstring& listenAddr
+                 , AdmissionControl::Ticket& ticket);
+
+    /**
+     * ׼Ƶλ, from Ǳʱͨ send() ߳
+     * @param[ in ] from ڵ¼ѭ
+     */
+    void releaseAdmission(AdmissionControl::Ticket& ticket, IOCPServer* from);
+
     /**
     * ȡõַ
     */
@@ -129,6 +272,17 @@ private:
      */
     bool post(ICommand *result);
 
+    /**
+     * ɶ˿ڵִ߳е
+     */
+    bool wakeup();
+
+    /**
+     * ִе
+     * @return ִе
+     */
+    size_t runTasks();
+
     /**
      * ȡɵ¼,¼
      * @return ʱ1,ȡ¼ɹ0,ȡʧܷ-1
@@ -152,20 +306,59 @@ private:
 
     /// ɶ˿ھ
     HANDLE completion_port_;
+    /// ߳ͨ send() ύ
+    mpsc_queue<IRunnable> tasks_;
+    /// رպΪ 1, send() ٽ
+    volatile LONG closed_;
+    ///  send() е߳, رɶ˿ǰҪǷ
+    volatile LONG senders_;
+    /// ʧʱΪ 1, һ send() »
+    volatile LONG wakeupFailed_;
     /// Բ߳
     u_long number_of_threads_;
     /// ǲ
     bool isRunning_;
-    /// socket Ӵ
-    stdext::hash_map<tstring, IConnectionBuilder* > connectionBuilders_;
-    /// Acceptor
-    stdext::hash_map<tstring, IAcceptorFactory* > acceptorFactories_;
+    /// socket Ӵ( ЭΪ )
+    stdext::hash_map<uint32_t, IConnectionBuilder* > connectionBuilders_;
+    /// Acceptor( ЭΪ )
+    stdext::hash_map<uint32_t, IAcceptorFactory* > acceptorFactories_;
     /// ڼAcceptor
-    stdext::hash_map<tstring, ListenPort*> listenPorts_;
+    stdext::hash_map<Endpoint, ListenPort*> listenPorts_;
+    /// ıַ
+    EndpointCache endpoints_;
     /// dns 
     ThreadDNSResolver resolver_;
+    /// ִмܼ̳߳
+    WorkStealingExecutor executor_;
+    /// ץ
+    TrafficCapture capture_;
+    /// ʱ
+    TimerQueue timers_;
+    /// Э̵
+    CoroutineScheduler coroutines_;
+    /// 
+    TrafficShaper shaper_;
+    /// ׼
+    AdmissionControl admission_;
+    /// ڴԤ
+    MemoryBudget memory_;
+    /// TLS úͻỰ
+    TLSContext tls_;
     /// е connection
     SessionList sessions_;
+    /// ɼؽ̹ļ socket
+    stdext::hash_map<Endpoint, SOCKET> sharedSockets_;
+    /// ΪƬʱѭ
+    IOCPServer* primary_;
+    /// ܵҪָķƬ
+    ReactorShards* shards_;
+    /// ܵӿԷָƬļַЭ鹤
+    std::map<tstring, IProtocolFactory*> shardedListeners_;
+    /// ǰ
+    volatile LONG load_;
+    /// ͳ
+    ServerStats localStats_;
+    ServerStats* stats_;
     /// еĻ·
     tstring path_;
     /// ־ӿ
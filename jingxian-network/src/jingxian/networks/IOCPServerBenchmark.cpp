@@ -0,0 +1,244 @@
+
+# include "pro_config.h"
+# include "jingxian/threading/mpsc_queue.h"
+# include "jingxian/threading/semaphore.h"
+# include "jingxian/threading/thread.h"
+# include "jingxian/networks/commands/RunCommand.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    class CountTask : public IRunnable
+    {
+    public:
+        CountTask(size_t* count)
+                : count_(count)
+        {
+        }
+
+        virtual void run()
+        {
+            ++ *count_;
+        }
+
+    private:
+        size_t* count_;
+    };
+}
+
+TEST(mpsc_queue, order)
+{
+    size_t count = 0;
+    mpsc_queue<IRunnable> queue;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_TRUE(is_null(queue.pop_all()));
+
+    CountTask tasks[] = { CountTask(&count), CountTask(&count), CountTask(&count) };
+
+    // ֻеһμʱҪ
+    ASSERT_TRUE(queue.push(&tasks[0]));
+    ASSERT_FALSE(queue.push(&tasks[1]));
+    ASSERT_FALSE(queue.push(&tasks[2]));
+    ASSERT_FALSE(queue.empty());
+
+    // ˳ȡ
+    IRunnable* task = queue.pop_all();
+    ASSERT_TRUE(&tasks[0] == task);
+    task = mpsc_queue<IRunnable>::next(task);
+    ASSERT_TRUE(&tasks[1] == task);
+    task = mpsc_queue<IRunnable>::next(task);
+    ASSERT_TRUE(&tasks[2] == task);
+    ASSERT_TRUE(is_null(mpsc_queue<IRunnable>::next(task)));
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_TRUE(queue.push(&tasks[0]));
+    ASSERT_TRUE(&tasks[0] == queue.pop_all());
+}
+
+# ifndef _GOOGLETEST_
+
+namespace
+{
+    /**
+     * ̵߳Ĺ, ̴߳úͬʱʼ
+     */
+    struct Producers
+    {
+        Producers(size_t threads, size_t tasks)
+                : start(0, LONG_MAX)
+                , exited(0, LONG_MAX)
+                , threads(threads)
+                , tasks(tasks)
+                , port(::CreateIoCompletionPort(INVALID_HANDLE_VALUE, 0, 0, 1))
+                , count(0)
+        {
+        }
+
+        ~Producers()
+        {
+            ::CloseHandle(port);
+        }
+
+        semaphore start;
+        semaphore exited;
+        size_t threads;
+        size_t tasks;
+        HANDLE port;
+        mpsc_queue<IRunnable> queue;
+        size_t count;
+    };
+
+    /**
+     * ԭ, ÿһ RunCommand һ PostQueuedCompletionStatus
+     */
+    void postPerTask(Producers* producers, size_t tasks)
+    {
+        producers->start.acquire();
+        for (size_t i = 0; i < tasks; ++ i)
+        {
+            RunCommand* command = new RunCommand(producers->port, new CountTask(&producers->count));
+            if (!command->execute())
+                delete command;
+        }
+        producers->exited.release();
+    }
+
+    /**
+     * , ֻڶɿձΪǿʱһ
+     */
+    void pushToQueue(Producers* producers, size_t tasks)
+    {
+        producers->start.acquire();
+        for (size_t i = 0; i < tasks; ++ i)
+        {
+            if (producers->queue.push(new CountTask(&producers->count)))
+                ::PostQueuedCompletionStatus(producers->port, 0, 0, null_ptr);
+        }
+        producers->exited.release();
+    }
+
+    void startProducers(BenchmarkState& state, Producers& producers, void (*producer)(Producers*, size_t))
+    {
+        state.pauseTiming();
+        for (size_t i = 0; i < producers.threads; ++ i)
+        {
+            size_t tasks = producers.tasks / producers.threads
+                           + ((i < producers.tasks % producers.threads) ? 1 : 0);
+            create_thread(producer, &producers, tasks);
+        }
+        state.resumeTiming();
+
+        producers.start.release((long)producers.threads);
+    }
+
+    void waitProducers(Producers& producers)
+    {
+        for (size_t i = 0; i < producers.threads; ++ i)
+            producers.exited.acquire();
+    }
+
+    void runPostPerTask(BenchmarkState& state, size_t threads)
+    {
+        Producers producers(threads, state.iterations());
+        startProducers(state, producers, &postPerTask);
+
+        while (producers.count < producers.tasks)
+        {
+            OVERLAPPED* overlapped = null_ptr;
+            DWORD bytes_transferred = 0;
+            ULONG_PTR completion_key = 0;
+            if (!::GetQueuedCompletionStatus(producers.port, &bytes_transferred
+                                             , &completion_key, &overlapped, INFINITE))
+                break;
+
+            ICommand* command = (ICommand*)overlapped;
+            command->on_complete(bytes_transferred, true, (void*)completion_key, 0);
+            delete command;
+        }
+        waitProducers(producers);
+    }
+
+    void runQueue(BenchmarkState& state, size_t threads)
+    {
+        Producers producers(threads, state.iterations());
+        startProducers(state, producers, &pushToQueue);
+
+        while (producers.count < producers.tasks)
+        {
+            OVERLAPPED* overlapped = null_ptr;
+            DWORD bytes_transferred = 0;
+            ULONG_PTR completion_key = 0;
+            if (!::GetQueuedCompletionStatus(producers.port, &bytes_transferred
+                                             , &completion_key, &overlapped, INFINITE))
+                break;
+
+            IRunnable* task = producers.queue.pop_all();
+            while (!is_null(task))
+            {
+                IRunnable* next = mpsc_queue<IRunnable>::next(task);
+                task->run();
+                delete task;
+                task = next;
+            }
+        }
+        waitProducers(producers);
+
+        // һλѿܻɶ˿
+        OVERLAPPED* overlapped = null_ptr;
+        DWORD bytes_transferred = 0;
+        ULONG_PTR completion_key = 0;
+        while (::GetQueuedCompletionStatus(producers.port, &bytes_transferred
+                                           , &completion_key, &overlapped, 0))
+            ;
+    }
+}
+
+BENCHMARK(send_post_per_task_1)
+{
+    runPostPerTask(state, 1);
+}
+
+BENCHMARK(send_post_per_task_2)
+{
+    runPostPerTask(state, 2);
+}
+
+BENCHMARK(send_post_per_task_4)
+{
+    runPostPerTask(state, 4);
+}
+
+BENCHMARK(send_post_per_task_8)
+{
+    runPostPerTask(state, 8);
+}
+
+BENCHMARK(send_mpsc_queue_1)
+{
+    runQueue(state, 1);
+}
+
+BENCHMARK(send_mpsc_queue_2)
+{
+    runQueue(state, 2);
+}
+
+BENCHMARK(send_mpsc_queue_4)
+{
+    runQueue(state, 4);
+}
+
+BENCHMARK(send_mpsc_queue_8)
+{
+    runQueue(state, 8);
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -1,25 +1,37 @@
 # include "pro_config.h"
 # include "jingxian/networks/ListenPort.h"
+# include "jingxian/networks/IOCPServer.h"
 
 _jingxian_begin
 
-ListenPort::ListenPort(IReactorCore* core
+namespace
+{
+    /// ڴͣӵʱ(  )
+    const uint32_t MIN_BACKOFF = 50;
+    const uint32_t MAX_BACKOFF = 5*1000;
+}
+
+ListenPort::ListenPort(IOCPServer* core
                        , IProtocolFactory* protocolFactory
                        , IAcceptor* acceptor)
-        : reactor_(core)
+        : core_(core)
+        , reactor_(core)
         , protocolFactory_(protocolFactory)
         , acceptor_(acceptor)
         , isPending_(false)
         , errorCount_(0)
+        , backoff_(0)
         , logger_(_T("jingxian.system.listenPort"))
 {
     toString_ = _T("ListenPort[address=")
                 + acceptor_.bindPoint()
                 + _T("]");
+    resumeTimer_.initialize(this);
 }
 
 ListenPort::~ListenPort()
 {
+    core_->timers().cancel(&resumeTimer_);
 }
 
 bool ListenPort::start()
@@ -40,23 +52,30 @@ bool ListenPort::start()
               << acceptor_.bindPoint()
               << _T("' ɹ!"));
 
-    isPending_ = true;
-    acceptor_.accept(this
-                     , &ListenPort::onComplete
-                     , &ListenPort::onError
-                     , reactor_);
+    accept();
     return true;
 }
 
 void ListenPort::stop()
 {
+    core_->timers().cancel(&resumeTimer_);
     acceptor_.close();
 }
 
+void ListenPort::accept()
+{
+    isPending_ = true;
+    acceptor_.accept(this
+                     , &ListenPort::onComplete
+                     , &ListenPort::onError
+                     , reactor_);
+}
+
 void ListenPort::onComplete(ITransport* transport
                             , IReactorCore* core)
 {
     errorCount_ = 0;
+    backoff_ = 0;
     isPending_ = false;
     if (!reactor_->isRunning())
     {
@@ -65,15 +84,15 @@ void ListenPort::onComplete(ITransport* transport
         return;
     }
 
-    transport->bindProtocol(protocolFactory_->
-                            createProtocol(transport, reactor_));
-    transport->initialize();
+    // Ϊ null ʱʾӱ׼ƾܾ, ߽˱ķƬ
+    if (!is_null(transport))
+    {
+        transport->bindProtocol(protocolFactory_->
+                                createProtocol(transport, reactor_));
+        transport->initialize();
+    }
 
-    isPending_ = true;
-    acceptor_.accept(this
-                     , &ListenPort::onComplete
-                     , &ListenPort::onError
-                     , reactor_);
+    accept();
 }
 
 void ListenPort::onError(const ErrorCode& err
@@ -87,6 +106,23 @@ void ListenPort::onError(const ErrorCode& err
         return;
     }
 
+    if (AdmissionControl::isExhausted(err.errorCode()))
+    {
+        // ڴ˲Ǽ˿ڵĴ, һ
+        backoff_ = (0 == backoff_) ? MIN_BACKOFF : backoff_ * 2;
+        if (backoff_ > MAX_BACKOFF)
+            backoff_ = MAX_BACKOFF;
+        core_->admission().paused();
+
+        LOG_WARN(logger_, toString()
+                 << _T(" Դ, ͣ ")
+                 << backoff_
+                 << _T("  - ")
+                 << err);
+        core_->timers().schedule(&resumeTimer_, backoff_);
+        return;
+    }
+
     if (errorCount_ > 20)
     {
         LOG_FATAL(logger_, toString()
@@ -98,11 +134,7 @@ void ListenPort::onError(const ErrorCode& err
     }
 
     ++ errorCount_;
-    isPending_ = true;
-    acceptor_.accept(this
-                     , &ListenPort::onComplete
-                     , &ListenPort::onError
-                     , reactor_);
+    accept();
 }
 
 bool ListenPort::isPending() const
@@ -10,13 +10,16 @@
 
 // Include files
 # include "jingxian/IReactorCore.h"
+# include "jingxian/networks/TimerQueue.h"
 
 _jingxian_begin
 
+class IOCPServer;
+
 class ListenPort
 {
 public:
-    ListenPort(IReactorCore* core, IProtocolFactory* protocolFactory, IAcceptor* acceptor);
+    ListenPort(IOCPServer* core, IProtocolFactory* protocolFactory, IAcceptor* acceptor);
 
     virtual ~ListenPort();
 
@@ -34,11 +37,43 @@ public:
 
 private:
     NOCOPY(ListenPort);
+
+    /**
+     * ڴ, һٽӵĶʱ
+     */
+    class ResumeTimer : public Timer
+    {
+    public:
+        ResumeTimer()
+                : owner_(null_ptr)
+        {
+        }
+
+        void initialize(ListenPort* owner)
+        {
+            owner_ = owner;
+        }
+
+        virtual void onTimeout()
+        {
+            owner_->accept();
+        }
+
+    private:
+        ListenPort* owner_;
+    };
+
+    void accept();
+
+    IOCPServer* core_;
     IReactorCore* reactor_;
     IProtocolFactory* protocolFactory_;
     Acceptor acceptor_;
     int errorCount_;
     bool isPending_;
+    /// ͣӵĺ, ͣʱӱ
+    uint32_t backoff_;
+    ResumeTimer resumeTimer_;
 	logging::logger logger_;
     tstring toString_;
 };
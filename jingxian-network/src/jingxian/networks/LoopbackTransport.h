@@ -0,0 +1,289 @@
+
+#ifndef _LoopbackTransport_H_
+#define _LoopbackTransport_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/ITransport.h"
+# include "jingxian/IProtocol.h"
+# include "jingxian/ProtocolContext.h"
+
+_jingxian_begin
+
+// ǵԪõڴ, ֻ *Benchmark.cpp ʹ
+
+/**
+ * ֱָյݵ
+ */
+class LoopbackContext : public ProtocolContext
+{
+public:
+    void inMemory(const std::vector<io_mem_buf>* buffers, size_t totalLen)
+    {
+        inMemory_ = buffers;
+        inBytes_ = totalLen;
+    }
+};
+
+/**
+ * ڴе², дݱ wire ,  deliver() һ,
+ *  receive() ģյ
+ */
+class LoopbackTransport : public ITransport
+{
+public:
+    LoopbackTransport(const tstring& name = _T("loopback"))
+            : protocol_(null_ptr)
+            , batches(0)
+            , reading(true)
+            , disconnected(false)
+            , name_(name)
+    {
+    }
+
+    virtual void initialize()
+    {
+        LoopbackContext context;
+        context.initialize(null_ptr, this);
+        protocol_->onConnected(context);
+    }
+
+    virtual IProtocol* bindProtocol(IProtocol* protocol)
+    {
+        IProtocol* old = protocol_;
+        protocol_ = protocol;
+        return old;
+    }
+
+    virtual void startReading()
+    {
+        reading = true;
+    }
+
+    virtual void stopReading()
+    {
+        reading = false;
+    }
+
+    virtual void write(buffer_chain_t* buffer)
+    {
+        writeBatch(&buffer, 1);
+    }
+
+    virtual void writeBatch(buffer_chain_t** buffers, size_t len)
+    {
+        ++ batches;
+        for (size_t i = 0; i < len; ++ i)
+        {
+            wire.append(rd_ptr(buffers[i]), rd_length(buffers[i]));
+            freebuffer(buffers[i]);
+        }
+    }
+
+    virtual void shapeAs(const tstring& user, bool upload)
+    {
+    }
+
+    virtual void disconnection()
+    {
+        disconnected = true;
+    }
+
+    virtual void disconnection(const tstring& error)
+    {
+        disconnected = true;
+    }
+
+    virtual const tstring& host() const
+    {
+        return name_;
+    }
+
+    virtual const tstring& peer() const
+    {
+        return name_;
+    }
+
+    virtual time_t timeout() const
+    {
+        return 0;
+    }
+
+    virtual const tstring& toString() const
+    {
+        return name_;
+    }
+
+    /**
+     * дݷֳƬνԷ, Ա㸲ǿƬε, Էֹͣ
+     * ȡʱ
+     */
+    size_t deliver(LoopbackTransport& to)
+    {
+        if (wire.empty() || is_null(to.protocol_) || !to.reading)
+            return 0;
+
+        size_t half = wire.size() / 2;
+        std::vector<io_mem_buf> segments(0 == half ? 1 : 2);
+        segments[0].buf = &wire[0];
+        segments[0].len = (u_long)(0 == half ? wire.size() : half);
+        if (0 != half)
+        {
+            segments[1].buf = &wire[half];
+            segments[1].len = (u_long)(wire.size() - half);
+        }
+
+        LoopbackContext context;
+        context.initialize(null_ptr, &to);
+        context.inMemory(&segments, wire.size());
+        size_t len = to.protocol_->onReceived(context);
+        wire.erase(0, len);
+        return len;
+    }
+
+    /**
+     *  data ΪһƬνЭ
+     */
+    size_t receive(const char* data, size_t len)
+    {
+        std::vector<io_mem_buf> segments(1);
+        segments[0].buf = (char*)data;
+        segments[0].len = (u_long)len;
+
+        LoopbackContext context;
+        context.initialize(null_ptr, this);
+        context.inMemory(&segments, len);
+        return protocol_->onReceived(context);
+    }
+
+    size_t receive(const std::string& data)
+    {
+        return receive(data.data(), data.size());
+    }
+
+    /**
+     *  data г segmentSize СƬνЭ
+     */
+    size_t receive(const std::string& data, size_t segmentSize)
+    {
+        std::vector<io_mem_buf> segments;
+        for (size_t offset = 0; offset < data.size(); offset += segmentSize)
+        {
+            io_mem_buf buf;
+            buf.buf = (char*)data.data() + offset;
+            buf.len = (u_long)((data.size() - offset < segmentSize) ? (data.size() - offset) : segmentSize);
+            segments.push_back(buf);
+        }
+
+        LoopbackContext context;
+        context.initialize(null_ptr, this);
+        context.inMemory(&segments, data.size());
+        return protocol_->onReceived(context);
+    }
+
+    /**
+     * ֪ͨЭѶϿ
+     */
+    void closed()
+    {
+        if (is_null(protocol_))
+            return;
+
+        LoopbackContext context;
+        context.initialize(null_ptr, this);
+        IProtocol* protocol = protocol_;
+        protocol_ = null_ptr;
+        protocol->onDisconnected(context, 0, _T("closed"));
+    }
+
+    IProtocol* protocol_;
+    std::string wire;
+    /// writeBatch() ĵô
+    size_t batches;
+    bool reading;
+    bool disconnected;
+
+private:
+    tstring name_;
+};
+
+/**
+ * յݵЭ
+ */
+class RecordProtocol : public IProtocol
+{
+public:
+    RecordProtocol()
+            : connected(false)
+            , received(0)
+            , keep(true)
+            , hold(false)
+            , name_(_T("RecordProtocol"))
+    {
+    }
+
+    virtual void onTimeout(ProtocolContext& context)
+    {
+    }
+
+    virtual void onConnected(ProtocolContext& context)
+    {
+        connected = true;
+    }
+
+    virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+    {
+        connected = false;
+    }
+
+    virtual size_t onReceived(ProtocolContext& context)
+    {
+        if (hold)
+            return 0;
+
+        for (std::vector<io_mem_buf>::const_iterator it = context.inMemory().begin()
+                ; it != context.inMemory().end(); ++ it)
+        {
+            if (keep)
+                data.append(it->buf, it->len);
+        }
+        received += context.inBytes();
+        return context.inBytes();
+    }
+
+    virtual databuffer_t* createBuffer(const ProtocolContext& context)
+    {
+        databuffer_t* result = (databuffer_t*)my_calloc(1, sizeof(databuffer_t) + 4096);
+        result->chain.type = BUFFER_ELEMENT_MEMORY;
+        result->capacity = 4096;
+        result->start = result->end = result->ptr;
+        return result;
+    }
+
+    virtual const tstring& toString() const
+    {
+        return name_;
+    }
+
+    bool connected;
+    size_t received;
+    /// Ϊ false ʱֻ, 
+    bool keep;
+    /// Ϊ true ʱһֽҲȡ
+    bool hold;
+    std::string data;
+
+private:
+    tstring name_;
+};
+
+_jingxian_end
+
+#endif //_LoopbackTransport_H_
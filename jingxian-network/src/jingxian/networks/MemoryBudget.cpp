@@ -0,0 +1,382 @@
+
+# include "pro_config.h"
+# include <algorithm>
+# include <map>
+# include "jingxian/lastError.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/networks/MemoryBudget.h"
+# include "jingxian/networks/IOCPServer.h"
+# include "jingxian/networks/ReactorShards.h"
+# include "jingxian/networks/ConnectedSocket.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ڴļ(  ), ÿ׶ҪһܿЧ
+    const uint32_t CHECK_INTERVAL = 1000;
+
+    tstring dumpName(DWORD pid)
+    {
+        return concat<tstring>(_T("jingxian.memory."), ::toString((int)pid), _T(".dump"));
+    }
+
+    struct ByBytes
+    {
+        bool operator()(const MemoryBudget::Usage& lhs, const MemoryBudget::Usage& rhs) const
+        {
+            return lhs.bytes > rhs.bytes;
+        }
+    };
+
+    struct ByReceived
+    {
+        bool operator()(const MemoryBudget::Usage& lhs, const MemoryBudget::Usage& rhs) const
+        {
+            return lhs.received > rhs.received;
+        }
+    };
+
+    /**
+     * ڷƬ߳ڴͳ
+     */
+    class DumpMemory : public IRunnable
+    {
+    public:
+        DumpMemory(IOCPServer* shard)
+                : shard_(shard)
+        {
+        }
+
+        virtual void run()
+        {
+            shard_->memory().dump();
+        }
+
+    private:
+        IOCPServer* shard_;
+    };
+}
+
+void MemoryBudget::Probe::start(MemoryBudget* owner, TimerQueue* timers)
+{
+    owner_ = owner;
+    timers_ = timers;
+    timers_->schedule(this, CHECK_INTERVAL);
+}
+
+void MemoryBudget::Probe::onTimeout()
+{
+    owner_->check();
+    timers_->schedule(this, CHECK_INTERVAL);
+}
+
+MemoryBudget::MemoryBudget()
+        : core_(null_ptr)
+        , shares_(1)
+        , stats_(null_ptr)
+        , pressure_(memory_pressure::Normal)
+        , primary_(false)
+        , dumpEvent_(NULL)
+        , shed_(0)
+        , peak_(0)
+        , logger_(_T("jingxian.system.memory"))
+{
+}
+
+MemoryBudget::~MemoryBudget()
+{
+    if (NULL != dumpEvent_)
+    {
+        ::CloseHandle(dumpEvent_);
+        dumpEvent_ = NULL;
+    }
+}
+
+void MemoryBudget::initialize(IOCPServer* core)
+{
+    core_ = core;
+}
+
+MemoryBudget::Options& MemoryBudget::options()
+{
+    return options_;
+}
+
+void MemoryBudget::share(const MemoryBudget& other, size_t shares)
+{
+    options_ = other.options_;
+    shares_ = (0 == shares) ? 1 : shares;
+}
+
+void MemoryBudget::stats(ServerStats* stats)
+{
+    stats_ = stats;
+}
+
+void MemoryBudget::start(TimerQueue& timers, bool primary)
+{
+    primary_ = primary;
+    if (primary_ && NULL == dumpEvent_)
+    {
+        dumpEvent_ = ::CreateEvent(NULL, FALSE, FALSE, dumpName(::GetCurrentProcessId()).c_str());
+        if (NULL == dumpEvent_)
+            LOG_WARN(logger_, _T("ڴͳƵ¼ʧ - ") << lastError(::GetLastError()));
+    }
+
+    // ѭʹڴҲҪʱͳ
+    if (primary_ || 0 != options_.limit)
+        probe_.start(this, &timers);
+}
+
+void MemoryBudget::stop(TimerQueue& timers)
+{
+    timers.cancel(&probe_);
+}
+
+memory_pressure::type MemoryBudget::pressure() const
+{
+    return pressure_;
+}
+
+bool MemoryBudget::isLean() const
+{
+    return memory_pressure::Normal != pressure_;
+}
+
+bool MemoryBudget::dump(DWORD pid)
+{
+    HANDLE event = ::OpenEvent(EVENT_MODIFY_STATE, FALSE, dumpName(pid).c_str());
+    if (NULL == event)
+        return false;
+
+    BOOL result = ::SetEvent(event);
+    ::CloseHandle(event);
+    return FALSE != result;
+}
+
+void MemoryBudget::check()
+{
+    if (NULL != dumpEvent_ && WAIT_OBJECT_0 == ::WaitForSingleObject(dumpEvent_, 0))
+    {
+        dump();
+
+        // ƬֻԼ߳з
+        ReactorShards* shards = core_->shards();
+        if (!is_null(shards))
+        {
+            for (size_t i = 1; i < shards->size(); ++ i)
+                shards->shard(i)->send(new DumpMemory(shards->shard(i)));
+        }
+    }
+
+    size_t total = this->total();
+    if (total > peak_)
+        peak_ = total;
+    if (primary_ && !is_null(stats_))
+        ::InterlockedExchange(&stats_->memory, (LONG)(total / 1024));
+
+    if (0 == options_.limit)
+        return;
+
+    if (total > options_.limit)
+        enforce(total - options_.limit);
+    else if (memory_pressure::Normal != pressure_ && total < options_.limit / 4 * 3)
+        relax();
+}
+
+void MemoryBudget::consumers(std::vector<IMemoryConsumer*>& result)
+{
+    SessionList& sessions = core_->sessions();
+    result.reserve(sessions.size());
+
+    for (SessionList::iterator it = sessions.begin(); it != sessions.end(); ++ it)
+    {
+        ConnectedSocket* connection = dynamic_cast<ConnectedSocket*>(*it);
+        if (!is_null(connection))
+            result.push_back(connection);
+    }
+}
+
+size_t MemoryBudget::total() const
+{
+    return MemoryAccount::total();
+}
+
+void MemoryBudget::collect(std::vector<Usage>& usages, bool take)
+{
+    std::vector<IMemoryConsumer*> connections;
+    consumers(connections);
+    usages.reserve(connections.size());
+
+    for (std::vector<IMemoryConsumer*>::iterator it = connections.begin(); it != connections.end(); ++ it)
+    {
+        Usage usage;
+        usage.connection = *it;
+        usage.bytes = (*it)->memory();
+        usage.received = take ? (*it)->takeReceived() : (*it)->received();
+        usages.push_back(usage);
+    }
+}
+
+void MemoryBudget::enforce(size_t excess)
+{
+    excess = (excess + shares_ - 1) / shares_;
+
+    std::vector<Usage> usages;
+    collect(usages, true);
+
+    switch (pressure_)
+    {
+    case memory_pressure::Normal:
+    {
+        // ڶȡ, غͷ,  ConnectedSocket::shrink()
+        pressure_ = memory_pressure::Lean;
+        size_t freed = 0;
+        for (std::vector<Usage>::iterator it = usages.begin(); it != usages.end(); ++ it)
+            freed += it->connection->shrink();
+
+        LOG_WARN(logger_, _T("ڴ泬Ԥ ") << options_.limit << _T(" ֽ,  ") << excess
+                 << _T(" ֽ, еͷ ") << freed << _T(" ֽڵĽջ"));
+        break;
+    }
+    case memory_pressure::Lean:
+    {
+        pressure_ = memory_pressure::Paused;
+        size_t count = select(usages, excess, true);
+        if (0 != count)
+        {
+            for (size_t i = 0; i < count; ++ i)
+                usages[i].connection->pauseReading(true);
+
+            LOG_WARN(logger_, _T("ڴȻ ") << excess << _T(" ֽ, ͣȡյ ")
+                     << count << _T(" "));
+            break;
+        }
+
+        // ûлݵ, ͣȡû, ֱӶϿ
+    }
+    // 
+    case memory_pressure::Paused:
+    case memory_pressure::Shedding:
+    {
+        pressure_ = memory_pressure::Shedding;
+        size_t count = select(usages, excess, false);
+        for (size_t i = 0; i < count; ++ i)
+        {
+            LOG_WARN(logger_, _T("ڴ泬Ԥ, Ͽռ ") << usages[i].bytes << _T(" ֽڵ ")
+                     << usages[i].connection->toString());
+            usages[i].connection->disconnection(_T("ڴ泬Ԥ"));
+        }
+        shed_ += count;
+        break;
+    }
+    default:
+        assert(false);
+        break;
+    }
+}
+
+void MemoryBudget::relax()
+{
+    pressure_ = memory_pressure::Normal;
+
+    // ָȡʱܳϿ, ȡȫָ
+    std::vector<IMemoryConsumer*> connections;
+    consumers(connections);
+    for (std::vector<IMemoryConsumer*>::iterator it = connections.begin(); it != connections.end(); ++ it)
+        (*it)->pauseReading(false);
+
+    LOG_WARN(logger_, _T("ڴ潵 ") << total() << _T(" ֽ, ָȡ"));
+}
+
+void MemoryBudget::dump()
+{
+    if (primary_)
+    {
+        LOG_INFO(logger_, _T("ڴϼ ") << total()
+                 << _T(" ֽ, ֵ ") << peak_
+                 << _T(" ֽ, Ԥ ") << options_.limit
+                 << _T(" ֽ, ") << toString(pressure_));
+        for (size_t i = 0; i < MemoryKind::Count; ++ i)
+            LOG_INFO(logger_, _T("    ") << MemoryAccount::toString((MemoryKind::type)i)
+                     << _T(" ") << MemoryAccount::bytes((MemoryKind::type)i) << _T(" ֽ"));
+    }
+
+    std::vector<Usage> usages;
+    collect(usages, false);
+
+    // ˿ںϼֽ
+    std::map<tstring, std::pair<size_t, size_t> > listeners;
+    size_t total = 0;
+    for (std::vector<Usage>::iterator it = usages.begin(); it != usages.end(); ++ it)
+    {
+        std::pair<size_t, size_t>& listener = listeners[it->connection->listener()];
+        ++ listener.first;
+        listener.second += it->bytes;
+        total += it->bytes;
+    }
+
+    LOG_INFO(logger_, (is_null(core_) ? tstring(_T("¼ѭ")) : core_->toString()) << _T("  ") << usages.size() << _T(" ռ ")
+             << total << _T(" ֽ, ΪڴϿ ") << shed_ << _T(" "));
+    for (std::map<tstring, std::pair<size_t, size_t> >::iterator it = listeners.begin()
+            ; it != listeners.end(); ++ it)
+    {
+        LOG_INFO(logger_, _T("    ˿ '") << (it->first.empty() ? tstring(_T("<>")) : it->first)
+                 << _T("'  ") << it->second.first << _T(" ռ ") << it->second.second << _T(" ֽ"));
+    }
+
+    size_t count = top(usages, options_.topN);
+    for (size_t i = 0; i < count; ++ i)
+    {
+        LOG_INFO(logger_, _T("     ") << (i + 1) << _T("  ") << usages[i].connection->toString()
+                 << _T(" ռ ") << usages[i].bytes << _T(" ֽ, ϴμյ ")
+                 << usages[i].received << _T(" ֽ"));
+    }
+}
+
+size_t MemoryBudget::select(std::vector<Usage>& usages, size_t excess, bool byReceived)
+{
+    if (byReceived)
+        std::sort(usages.begin(), usages.end(), ByReceived());
+    else
+        std::sort(usages.begin(), usages.end(), ByBytes());
+
+    size_t sum = 0;
+    size_t count = 0;
+    while (count < usages.size() && sum < excess)
+    {
+        size_t value = byReceived ? usages[count].received : usages[count].bytes;
+        if (0 == value)
+            break;
+
+        sum += value;
+        ++ count;
+    }
+    return count;
+}
+
+size_t MemoryBudget::top(std::vector<Usage>& usages, size_t topN)
+{
+    std::sort(usages.begin(), usages.end(), ByBytes());
+    return (usages.size() < topN) ? usages.size() : topN;
+}
+
+const tchar* MemoryBudget::toString(memory_pressure::type pressure)
+{
+    switch (pressure)
+    {
+    case memory_pressure::Normal:
+        return _T("");
+    case memory_pressure::Lean:
+        return _T("ͷſеĽջ");
+    case memory_pressure::Paused:
+        return _T("ͣȡ");
+    case memory_pressure::Shedding:
+        return _T("Ͽ");
+    default:
+        return _T("δ֪");
+    }
+}
+
+_jingxian_end
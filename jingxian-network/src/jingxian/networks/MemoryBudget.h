@@ -0,0 +1,255 @@
+
+#ifndef _MemoryBudget_H_
+#define _MemoryBudget_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/networks/TimerQueue.h"
+
+_jingxian_begin
+
+class IOCPServer;
+struct ServerStats;
+
+/**
+ * ,  "sc control <> 130" ־ڴͳ
+ */
+const DWORD MEMORY_DUMP_CONTROL = 130;
+
+/**
+ * ڴԤʱĴ׶, ÿμȻʱһ׶
+ */
+namespace memory_pressure
+{
+    enum type
+    {
+        /// ûгԤ
+        Normal = 0,
+        /// еͷŽջ, ֽڵĶȴ
+        Lean,
+        /// ͣȡյ
+        Paused,
+        /// Ͽռڴ
+        Shedding
+    };
+}
+
+/**
+ * ڴԤ
+ */
+class IMemoryConsumer
+{
+public:
+    virtual ~IMemoryConsumer() {}
+
+    /**
+     * շЭ黺ռõֽ
+     */
+    virtual size_t memory() const = 0;
+
+    /**
+     * ϴ takeReceived() յֽ
+     */
+    virtual size_t received() const = 0;
+
+    /**
+     * ȡ received() 
+     */
+    virtual size_t takeReceived() = 0;
+
+    /**
+     * ͷŽջ, δʱȡ
+     * @return ͷŵֽ, ȡĶ󷵻غͷŵĲ
+     */
+    virtual size_t shrink() = 0;
+
+    /**
+     * ڴ泬Ԥʱָͣȡ, û stopReading() Ӱ
+     */
+    virtual void pauseReading(bool paused) = 0;
+
+    /**
+     * Ͽ
+     */
+    virtual void disconnection(const tstring& error) = 0;
+
+    /**
+     * ܱӵļַ, Ϊ
+     */
+    virtual const tstring& listener() const = 0;
+
+    virtual const tstring& toString() const = 0;
+};
+
+/**
+ * ڴԤ
+ *
+ * ʱȽ MemoryAccount ͳƵȫڴԤ, ʱÿеͷŽ
+ * , ͣȡյ, Ͽռڴ, ֱԤ
+ * 3/4 ȫָ. ڴͳ̵, ƬʱÿƬֻԼ,
+ * ҪͷŵֽɸƬƽ̯. ֻ¼ѭ߳ʹ.
+ */
+class MemoryBudget
+{
+public:
+    struct Options
+    {
+        Options()
+                : limit(0)
+                , topN(10)
+        {
+        }
+
+        /// ȫڴ( ֽ ), Ϊ 0 ʱ
+        size_t limit;
+        /// ڴͳʱгӸ
+        size_t topN;
+    };
+
+    /**
+     * һռõڴ
+     */
+    struct Usage
+    {
+        IMemoryConsumer* connection;
+        /// շЭ黺ռõֽ
+        size_t bytes;
+        /// ϴμյֽ
+        size_t received;
+    };
+
+    MemoryBudget();
+
+    virtual ~MemoryBudget();
+
+    void initialize(IOCPServer* core);
+
+    Options& options();
+
+    /**
+     * ΪƬʱ other , Ҫͷŵֽ shares Ƭƽ̯
+     */
+    void share(const MemoryBudget& other, size_t shares);
+
+    /**
+     * ָͳݵĴλ
+     */
+    void stats(ServerStats* stats);
+
+    /**
+     * ʼʱ
+     * @param[ in ] primary Ƿѭ, ѭͳƺӦڴ
+     * ͳƵ
+     */
+    void start(TimerQueue& timers, bool primary);
+
+    void stop(TimerQueue& timers);
+
+    memory_pressure::type pressure() const;
+
+    /**
+     * еǷӦͷŽջ
+     */
+    bool isLean() const;
+
+    /**
+     * ־ڴ, ˿ڵĺϼƺռڴ
+     */
+    void dump();
+
+    /**
+     * ý pid ڴͳ( ̺߳ͽе )
+     * @return ûڴԤʱ false
+     */
+    static bool dump(DWORD pid);
+
+    /**
+     * ӴС, ѡϼƴﵽ excess ٵǰ, ֵΪ 0 Ĳѡ
+     * @param[ in ] byReceived Ϊ true ʱյֽ, ռõڴ
+     * @return ѡеĸ,  usages ǰ
+     */
+    static size_t select(std::vector<Usage>& usages, size_t excess, bool byReceived);
+
+    /**
+     * ռõڴӴС, ͳʱҪгĸ
+     */
+    static size_t top(std::vector<Usage>& usages, size_t topN);
+
+    static const tchar* toString(memory_pressure::type pressure);
+
+protected:
+    /**
+     * һڴ, Ԥʱһ׶, Ԥ 3/4 ʱָ
+     */
+    void check();
+
+    /**
+     * ȡܹ, ȱʡ¼ѭе ConnectedSocket
+     */
+    virtual void consumers(std::vector<IMemoryConsumer*>& result);
+
+    /**
+     * ȡȫڴ, ȱʡ MemoryAccount::total()
+     */
+    virtual size_t total() const;
+
+private:
+    NOCOPY(MemoryBudget);
+
+    /**
+     * ʱ
+     */
+    class Probe : public Timer
+    {
+    public:
+        Probe()
+                : owner_(null_ptr)
+                , timers_(null_ptr)
+        {
+        }
+
+        void start(MemoryBudget* owner, TimerQueue* timers);
+
+        virtual void onTimeout();
+
+    private:
+        MemoryBudget* owner_;
+        TimerQueue* timers_;
+    };
+
+    /**
+     * @param[ in ] take Ƿͬʱյֽ, ֻдʱ,
+     * ͳƲӰһͣȡѡ
+     */
+    void collect(std::vector<Usage>& usages, bool take);
+    void enforce(size_t excess);
+    void relax();
+
+    IOCPServer* core_;
+    Options options_;
+    size_t shares_;
+    ServerStats* stats_;
+    memory_pressure::type pressure_;
+    bool primary_;
+    HANDLE dumpEvent_;
+    Probe probe_;
+
+    /// ΪڴϿ
+    size_t shed_;
+    /// ʱڴ
+    size_t peak_;
+
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_MemoryBudget_H_
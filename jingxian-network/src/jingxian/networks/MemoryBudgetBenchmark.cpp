@@ -0,0 +1,315 @@
+
+# include "pro_config.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/networks/MemoryBudget.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    MemoryBudget::Usage makeUsage(size_t bytes, size_t received)
+    {
+        MemoryBudget::Usage usage;
+        usage.connection = null_ptr;
+        usage.bytes = bytes;
+        usage.received = received;
+        return usage;
+    }
+
+    /**
+     * ԤĴ
+     */
+    class FakeConsumer : public IMemoryConsumer
+    {
+    public:
+        FakeConsumer(const tstring& name, size_t bytes, size_t received)
+                : name_(name)
+                , listener_(_T("tcp://0.0.0.0:80"))
+                , bytes_(bytes)
+                , received_(received)
+                , shrunk_(0)
+                , paused_(false)
+                , disconnected_(false)
+        {
+        }
+
+        virtual size_t memory() const { return bytes_; }
+        virtual size_t received() const { return received_; }
+
+        virtual size_t takeReceived()
+        {
+            size_t received = received_;
+            received_ = 0;
+            return received;
+        }
+
+        virtual size_t shrink()
+        {
+            ++ shrunk_;
+            return 0;
+        }
+
+        virtual void pauseReading(bool paused) { paused_ = paused; }
+        virtual void disconnection(const tstring& error) { disconnected_ = true; }
+        virtual const tstring& listener() const { return listener_; }
+        virtual const tstring& toString() const { return name_; }
+
+        tstring name_;
+        tstring listener_;
+        size_t bytes_;
+        size_t received_;
+        size_t shrunk_;
+        bool paused_;
+        bool disconnected_;
+    };
+
+    /**
+     * üӺͼٵڴϼ
+     */
+    class FakeBudget : public MemoryBudget
+    {
+    public:
+        FakeBudget(size_t limit)
+                : total_(0)
+        {
+            options().limit = limit;
+        }
+
+        using MemoryBudget::check;
+
+        virtual void consumers(std::vector<IMemoryConsumer*>& result)
+        {
+            result.insert(result.end(), connections_.begin(), connections_.end());
+        }
+
+        virtual size_t total() const
+        {
+            return total_;
+        }
+
+        std::vector<IMemoryConsumer*> connections_;
+        size_t total_;
+    };
+}
+
+TEST(memoryAccount, kinds)
+{
+    size_t receive = MemoryAccount::bytes(MemoryKind::Receive);
+    size_t send = MemoryAccount::bytes(MemoryKind::Send);
+
+    char* ptr = (char*)my_malloc_as(100, MemoryKind::Receive);
+    ASSERT_TRUE(receive + 100 == MemoryAccount::bytes(MemoryKind::Receive));
+    ASSERT_TRUE(send == MemoryAccount::bytes(MemoryKind::Send));
+
+    // ·Ȼԭ
+    ptr = (char*)my_realloc(ptr, 300);
+    ASSERT_TRUE(receive + 300 == MemoryAccount::bytes(MemoryKind::Receive));
+
+    my_free(ptr);
+    ASSERT_TRUE(receive == MemoryAccount::bytes(MemoryKind::Receive));
+
+    char* zeroed = (char*)my_calloc_as(4, 8, MemoryKind::Send);
+    ASSERT_TRUE(send + 32 == MemoryAccount::bytes(MemoryKind::Send));
+    for (size_t i = 0; i < 32; ++ i)
+        ASSERT_TRUE(0 == zeroed[i]);
+
+    my_free(zeroed);
+    ASSERT_TRUE(send == MemoryAccount::bytes(MemoryKind::Send));
+}
+
+TEST(memoryAccount, large)
+{
+    size_t other = MemoryAccount::bytes(MemoryKind::Other);
+
+    //  2G ʱܻƳɸ
+    const size_t large = (size_t)0x80001000U;
+    MemoryAccount::charge(MemoryKind::Other, large);
+    ASSERT_TRUE(other + large == MemoryAccount::bytes(MemoryKind::Other));
+    ASSERT_TRUE(MemoryAccount::total() >= large);
+
+    MemoryAccount::credit(MemoryKind::Other, large);
+    ASSERT_TRUE(other == MemoryAccount::bytes(MemoryKind::Other));
+}
+
+TEST(memoryBudget, selectByBytes)
+{
+    std::vector<MemoryBudget::Usage> usages;
+    usages.push_back(makeUsage(100, 0));
+    usages.push_back(makeUsage(500, 0));
+    usages.push_back(makeUsage(300, 0));
+    usages.push_back(makeUsage(0, 0));
+
+    // ϼ 800 Ź 600
+    ASSERT_TRUE(2 == MemoryBudget::select(usages, 600, false));
+    ASSERT_TRUE(500 == usages[0].bytes);
+    ASSERT_TRUE(300 == usages[1].bytes);
+
+    ASSERT_TRUE(1 == MemoryBudget::select(usages, 500, false));
+
+    // ռΪ 0 Ĳѡ
+    ASSERT_TRUE(3 == MemoryBudget::select(usages, 10000, false));
+}
+
+TEST(memoryBudget, selectByReceived)
+{
+    std::vector<MemoryBudget::Usage> usages;
+    usages.push_back(makeUsage(900, 0));
+    usages.push_back(makeUsage(100, 4000));
+    usages.push_back(makeUsage(100, 2000));
+
+    ASSERT_TRUE(1 == MemoryBudget::select(usages, 1000, true));
+    ASSERT_TRUE(4000 == usages[0].received);
+
+    // ûݵͣҲû
+    ASSERT_TRUE(2 == MemoryBudget::select(usages, 10000, true));
+}
+
+TEST(memoryBudget, selectEmpty)
+{
+    std::vector<MemoryBudget::Usage> usages;
+    ASSERT_TRUE(0 == MemoryBudget::select(usages, 100, false));
+
+    usages.push_back(makeUsage(100, 100));
+    ASSERT_TRUE(0 == MemoryBudget::select(usages, 0, false));
+}
+
+TEST(memoryBudget, top)
+{
+    std::vector<MemoryBudget::Usage> usages;
+    usages.push_back(makeUsage(100, 0));
+    usages.push_back(makeUsage(500, 0));
+    usages.push_back(makeUsage(300, 0));
+
+    ASSERT_TRUE(2 == MemoryBudget::top(usages, 2));
+    ASSERT_TRUE(500 == usages[0].bytes);
+    ASSERT_TRUE(300 == usages[1].bytes);
+    ASSERT_TRUE(100 == usages[2].bytes);
+
+    ASSERT_TRUE(3 == MemoryBudget::top(usages, 10));
+}
+
+TEST(memoryBudget, stages)
+{
+    FakeConsumer idle(_T("idle"), 100, 0);
+    FakeConsumer reader(_T("reader"), 200, 5000);
+    FakeConsumer hog(_T("hog"), 900, 10);
+
+    FakeBudget budget(1000);
+    budget.connections_.push_back(&idle);
+    budget.connections_.push_back(&reader);
+    budget.connections_.push_back(&hog);
+
+    budget.total_ = 900;
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Normal == budget.pressure());
+    ASSERT_TRUE(0 == idle.shrunk_);
+
+    // һγ: ͷŽջ
+    budget.total_ = 1200;
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Lean == budget.pressure());
+    ASSERT_TRUE(budget.isLean());
+    ASSERT_TRUE(1 == idle.shrunk_ && 1 == reader.shrunk_ && 1 == hog.shrunk_);
+    ASSERT_TRUE(!reader.paused_ && !hog.disconnected_);
+
+    // ͳƲܰյֽ, һѡҪͣ
+    reader.received_ = 5000;
+    budget.dump();
+    ASSERT_TRUE(5000 == reader.received_);
+
+    // ڶ: ͣȡյ
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Paused == budget.pressure());
+    ASSERT_TRUE(reader.paused_);
+    ASSERT_TRUE(!idle.paused_ && !hog.paused_);
+    ASSERT_TRUE(!hog.disconnected_);
+
+    // : Ͽռ
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Shedding == budget.pressure());
+    ASSERT_TRUE(hog.disconnected_);
+    ASSERT_TRUE(!idle.disconnected_ && !reader.disconnected_);
+
+    //  3/4 Ԥ֮䱣ֲ
+    budget.total_ = 800;
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Shedding == budget.pressure());
+    ASSERT_TRUE(reader.paused_);
+
+    //  3/4 ȫָ
+    budget.total_ = 700;
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Normal == budget.pressure());
+    ASSERT_TRUE(!budget.isLean());
+    ASSERT_TRUE(!reader.paused_);
+}
+
+TEST(memoryBudget, dumpKeepsReceived)
+{
+    FakeConsumer reader(_T("reader"), 200, 5000);
+
+    FakeBudget budget(1000);
+    budget.connections_.push_back(&reader);
+
+    budget.dump();
+    ASSERT_TRUE(5000 == reader.received_);
+
+    // ֻдʱ
+    budget.total_ = 1200;
+    budget.check();
+    ASSERT_TRUE(0 == reader.received_);
+}
+
+TEST(memoryBudget, shedWithoutReceivers)
+{
+    FakeConsumer idle(_T("idle"), 100, 0);
+    FakeConsumer hog(_T("hog"), 900, 0);
+
+    FakeBudget budget(1000);
+    budget.connections_.push_back(&idle);
+    budget.connections_.push_back(&hog);
+
+    budget.total_ = 1200;
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Lean == budget.pressure());
+
+    // ûлݵʱͣ, ֱӶϿ
+    budget.check();
+    ASSERT_TRUE(memory_pressure::Shedding == budget.pressure());
+    ASSERT_TRUE(hog.disconnected_ && !idle.disconnected_);
+    ASSERT_TRUE(!hog.paused_);
+}
+
+#ifndef _GOOGLETEST_
+
+/**
+ * ˵ķͷ, ֱ malloc ıȽϾǼ˵Ŀ
+ */
+BENCHMARK(memory_malloc_as)
+{
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        void* ptr = my_malloc_as(256, MemoryKind::Receive);
+        DO_NOT_OPTIMIZE(ptr);
+        my_free(ptr);
+    }
+}
+
+BENCHMARK(memory_malloc_crt)
+{
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        void* ptr = malloc(256);
+        DO_NOT_OPTIMIZE(ptr);
+        free(ptr);
+    }
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
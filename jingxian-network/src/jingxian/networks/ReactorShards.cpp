@@ -0,0 +1,348 @@
+
+# include "pro_config.h"
+# include "jingxian/exception.h"
+# include "jingxian/threading/thread.h"
+# include "jingxian/utilities/SamplingProfiler.h"
+# include "jingxian/networks/ReactorShards.h"
+# include "jingxian/networks/IOCPServer.h"
+# include "jingxian/networks/ConnectedSocket.h"
+
+_jingxian_begin
+
+namespace
+{
+    /**
+     * ڷƬ߳нѭ
+     */
+    class AdoptConnection : public IRunnable
+    {
+    public:
+        AdoptConnection(IOCPServer* primary
+                        , IOCPServer* shard
+                        , volatile LONG* pending
+                        , SOCKET socket
+                        , const tstring& host
+                        , const tstring& peer
+                        , const tstring& listenAddr
+                        , IProtocolFactory* protocolFactory
+                        , AdmissionControl::Ticket& ticket)
+                : primary_(primary)
+                , shard_(shard)
+                , pending_(pending)
+                , socket_(socket)
+                , host_(host)
+                , peer_(peer)
+                , listenAddr_(listenAddr)
+                , protocolFactory_(protocolFactory)
+                , ticket_(ticket)
+        {
+            ::InterlockedIncrement(pending_);
+        }
+
+        virtual ~AdoptConnection()
+        {
+            // Ƭֹͣ, ûִоͱɾ
+            if (INVALID_SOCKET != socket_)
+                closesocket(socket_);
+            primary_->releaseAdmission(ticket_, shard_);
+
+            ::InterlockedDecrement(pending_);
+        }
+
+        virtual void run()
+        {
+            std::auto_ptr<ConnectedSocket> connectedSocket(new ConnectedSocket(shard_, socket_, host_, peer_));
+            socket_ = INVALID_SOCKET;
+            connectedSocket->admitted(ticket_, primary_);
+            ticket_ = AdmissionControl::Ticket();
+
+            if (!shard_->bind((HANDLE)(connectedSocket->handle()), connectedSocket.get()))
+            {
+                int errCode = ::WSAGetLastError();
+                ThrowException1(RuntimeException, concat<tstring>(_T("Ƭ '")
+                                , peer_
+                                , _T("' ʱ󶨵iocp - ")
+                                , lastError(errCode)));
+            }
+
+            connectedSocket->shapeListener(listenAddr_);
+            connectedSocket->bindProtocol(protocolFactory_->createProtocol(connectedSocket.get(), shard_));
+            connectedSocket->initialize();
+            connectedSocket.release();
+        }
+
+    private:
+        NOCOPY(AdoptConnection);
+
+        IOCPServer* primary_;
+        IOCPServer* shard_;
+        volatile LONG* pending_;
+        SOCKET socket_;
+        tstring host_;
+        tstring peer_;
+        tstring listenAddr_;
+        IProtocolFactory* protocolFactory_;
+        AdmissionControl::Ticket ticket_;
+    };
+
+    /**
+     * ڷƬֹ߳ͣ¼ѭ
+     */
+    class StopShard : public IRunnable
+    {
+    public:
+        StopShard(IOCPServer* shard)
+                : shard_(shard)
+        {
+        }
+
+        virtual void run()
+        {
+            shard_->interrupt();
+        }
+
+    private:
+        IOCPServer* shard_;
+    };
+}
+
+ReactorShards::ReactorShards(IOCPServer* primary)
+        : primary_(primary)
+        , policy_(ShardPolicy::RoundRobin)
+        , affinity_(false)
+        , cpus_(1)
+        , profiler_(null_ptr)
+        , next_(0)
+        , logger_(_T("jingxian.system.shards"))
+{
+    if (is_null(primary))
+        ThrowException1(ArgumentNullException, _T("primary"));
+}
+
+ReactorShards::~ReactorShards()
+{
+    stop();
+}
+
+void ReactorShards::policy(ShardPolicy::type policy)
+{
+    policy_ = policy;
+}
+
+ShardPolicy::type ReactorShards::policy() const
+{
+    return policy_;
+}
+
+bool ReactorShards::start(size_t count, bool affinity, SamplingProfiler* profiler)
+{
+    if (!shards_.empty())
+    {
+        LOG_WARN(logger_ , _T("!"));
+        return false;
+    }
+
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    cpus_ = info.dwNumberOfProcessors;
+    if (cpus_ > sizeof(DWORD_PTR) * 8)
+        cpus_ = sizeof(DWORD_PTR) * 8;
+    if (0 == count)
+        count = info.dwNumberOfProcessors;
+
+    affinity_ = affinity;
+    profiler_ = profiler;
+    exited_.reset(new semaphore(0, LONG_MAX));
+
+    //  0 ƬѭԼ, ڵߵ߳
+    Shard* first = new Shard();
+    first->server = primary_;
+    first->pending = 0;
+    shards_.push_back(first);
+
+    for (size_t i = 1; i < count; ++ i)
+    {
+        std::auto_ptr<IOCPServer> server(new IOCPServer());
+        if (!server->initialize(1))
+        {
+            LOG_FATAL(logger_ , _T(" ") << i << _T(" Ƭʧ"));
+            destroy();
+            return false;
+        }
+        server->joinAsShard(primary_, count);
+
+        Shard* shard = new Shard();
+        shard->server = server.release();
+        shard->pending = 0;
+        shards_.push_back(shard);
+    }
+    loads_.assign(count, 0);
+    next_ = 0;
+
+    for (size_t i = 1; i < count; ++ i)
+    {
+        try
+        {
+            create_thread(&ReactorShards::shardMain, this, i, _T("reactor"));
+        }
+        catch (const std::exception& e)
+        {
+            LOG_FATAL(logger_ , _T("Ƭ߳ʧ - ") << e.what());
+
+            // û̵߳ķƬֱɾ, ѾķƬҪ˳
+            for (size_t j = i; j < count; ++ j)
+            {
+                delete shards_[j]->server;
+                delete shards_[j];
+            }
+            shards_.resize(i);
+            stop();
+            return false;
+        }
+    }
+
+    if (affinity_)
+        ::SetThreadAffinityMask(::GetCurrentThread(), 1);
+
+    primary_->shards(this);
+    LOG_INFO(logger_ , _T(" ") << count << _T(" ¼ѭƬ"));
+    return true;
+}
+
+void ReactorShards::stop()
+{
+    if (shards_.empty())
+        return;
+
+    primary_->shards(null_ptr);
+
+    // Ƭ runForever() ҪȵԼӶرպŷ
+    for (size_t i = 1; i < shards_.size(); ++ i)
+        shards_[i]->server->send(new StopShard(shards_[i]->server));
+    for (size_t i = 1; i < shards_.size(); ++ i)
+        exited_->acquire();
+
+    destroy();
+}
+
+void ReactorShards::destroy()
+{
+    for (size_t i = 0; i < shards_.size(); ++ i)
+    {
+        if (primary_ != shards_[i]->server)
+            delete shards_[i]->server;
+        delete shards_[i];
+    }
+    shards_.clear();
+    loads_.clear();
+}
+
+size_t ReactorShards::size() const
+{
+    return shards_.size();
+}
+
+IOCPServer* ReactorShards::shard(size_t index)
+{
+    return shards_[index]->server;
+}
+
+IOCPServer* ReactorShards::pick()
+{
+    if (shards_.empty())
+        return primary_;
+    return shards_[pickIndex()]->server;
+}
+
+size_t ReactorShards::pickIndex()
+{
+    if (shards_.empty())
+        return 0;
+
+    // ڽҪȷƬִ㵽ĸ, ڴ֮ǰҲҪ
+    if (ShardPolicy::LeastLoaded == policy_)
+    {
+        for (size_t i = 0; i < shards_.size(); ++ i)
+            loads_[i] = shards_[i]->server->load() + shards_[i]->pending;
+    }
+    return select(policy_, loads_, next_);
+}
+
+bool ReactorShards::handoff(SOCKET socket
+                            , const tstring& host
+                            , const tstring& peer
+                            , const tstring& listenAddr
+                            , IProtocolFactory* protocolFactory
+                            , AdmissionControl::Ticket& ticket)
+{
+    size_t index = pickIndex();
+    if (0 == index)
+        return false;
+
+    Shard* shard = shards_[index];
+    shard->server->send(new AdoptConnection(primary_
+                                            , shard->server
+                                            , &(shard->pending)
+                                            , socket
+                                            , host
+                                            , peer
+                                            , listenAddr
+                                            , protocolFactory
+                                            , ticket));
+    ticket = AdmissionControl::Ticket();
+    return true;
+}
+
+void ReactorShards::logStats()
+{
+    LONG total = 0;
+    for (size_t i = 0; i < shards_.size(); ++ i)
+    {
+        LONG load = shards_[i]->server->load();
+        total += load;
+        LOG_INFO(logger_ , _T("Ƭ ") << i << _T(" ǰ ") << load
+                 << _T(", ȴֵ ") << shards_[i]->pending);
+    }
+
+    const ServerStats& stats = primary_->stats();
+    LOG_INFO(logger_ , _T(" ") << shards_.size() << _T(" Ƭ, ǰ ") << total
+             << _T(", ۼ ") << stats.connections
+             << _T(", ܾ ") << stats.rejected);
+}
+
+size_t ReactorShards::select(ShardPolicy::type policy
+                             , const std::vector<LONG>& loads
+                             , size_t& next)
+{
+    if (loads.empty())
+        return 0;
+
+    size_t start = next % loads.size();
+    next = start + 1;
+    if (ShardPolicy::RoundRobin == policy)
+        return start;
+
+    // תλÿʼ, ͬʱѡ, ѹڵһ
+    size_t best = start;
+    for (size_t i = 1; i < loads.size(); ++ i)
+    {
+        size_t index = (start + i) % loads.size();
+        if (loads[index] < loads[best])
+            best = index;
+    }
+    return best;
+}
+
+void ReactorShards::shardMain(ReactorShards* owner, size_t index)
+{
+    if (owner->affinity_)
+        ::SetThreadAffinityMask(::GetCurrentThread(), ((DWORD_PTR)1) << (index % owner->cpus_));
+
+    if (!is_null(owner->profiler_))
+        owner->profiler_->addCurrentThread();
+
+    owner->shards_[index]->server->runForever();
+    owner->exited_->release();
+}
+
+_jingxian_end
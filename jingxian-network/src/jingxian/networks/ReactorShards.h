@@ -0,0 +1,149 @@
+
+#ifndef _ReactorShards_H_
+#define _ReactorShards_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/networks/AdmissionControl.h"
+# include "jingxian/threading/semaphore.h"
+
+_jingxian_begin
+
+class IOCPServer;
+class IProtocolFactory;
+class SamplingProfiler;
+
+namespace ShardPolicy
+{
+    enum type
+    {
+        /// ηָÿƬ
+        RoundRobin,
+        /// ָٵķƬ
+        LeastLoaded
+    };
+}
+
+/**
+ * ÿһ¼ѭƬ
+ *
+ * ÿƬһ IOCPServer, Լ߳, ռԼɶ˿,
+ * , , ʱЭ, Ƭ֮䲻κҪ. ѭ( 
+ *  0 Ƭ )׼, ܵ tcp ӰԷָһƬ, ֮
+ * е¼ڸ÷Ƭ߳д. Ƭֻ֮ͨ send() 
+ * Ϣ,  socket Ƭ, ׼Ƶλýѭ.
+ *
+ * ֻѭ߳ʹ.
+ */
+class ReactorShards
+{
+public:
+    ReactorShards(IOCPServer* primary);
+
+    ~ReactorShards();
+
+    void policy(ShardPolicy::type policy);
+
+    ShardPolicy::type policy() const;
+
+    /**
+     * Ƭ
+     * @param[ in ] count Ƭ( ѭ ), Ϊ 0 ʱ CPU 
+     * @param[ in ] affinity ǷÿƬ󶨵һ CPU , ߵ߳
+     *  0 Ƭ, 󶨵һ CPU
+     * @param[ in ] profiler Ϊ null_ptr ʱԷƬ̲߳
+     */
+    bool start(size_t count, bool affinity, SamplingProfiler* profiler);
+
+    /**
+     * ֹͣзƬ, ȵǵӶرպ󷵻
+     */
+    void stop();
+
+    /**
+     * Ƭ( ѭ )
+     */
+    size_t size() const;
+
+    /**
+     * ȡ÷Ƭ,  0 ѭ
+     */
+    IOCPServer* shard(size_t index);
+
+    /**
+     * ѡһƬ
+     */
+    IOCPServer* pick();
+
+    /**
+     * ѡһƬ, 
+     */
+    size_t pickIndex();
+
+    /**
+     * һսܵӽ pick() ѡķƬ
+     * @return ѡеѭʱ false, Լ; 
+     * socket  ticket Ƭ, ߲ʹ
+     */
+    bool handoff(SOCKET socket
+                 , const tstring& host
+                 , const tstring& peer
+                 , const tstring& listenAddr
+                 , IProtocolFactory* protocolFactory
+                 , AdmissionControl::Ticket& ticket);
+
+    /**
+     * ־м¼ÿƬͺϼ
+     */
+    void logStats();
+
+    /**
+     * Դ loads ѡһƬ
+     * @param[ in ] loads ÿƬĸ
+     * @param[ in, out ] next תλ, ÿεúһ
+     * @return ѡзƬ
+     */
+    static size_t select(ShardPolicy::type policy
+                         , const std::vector<LONG>& loads
+                         , size_t& next);
+
+private:
+    NOCOPY(ReactorShards);
+
+    struct Shard
+    {
+        IOCPServer* server;
+        /// ѾƬûнֵ
+        volatile LONG pending;
+    };
+
+    static void shardMain(ReactorShards* owner, size_t index);
+
+    /**
+     * ɾзƬ, ǰƬ̱߳Ѿ˳
+     */
+    void destroy();
+
+    IOCPServer* primary_;
+    ShardPolicy::type policy_;
+    bool affinity_;
+    size_t cpus_;
+    SamplingProfiler* profiler_;
+    std::vector<Shard*> shards_;
+    std::vector<LONG> loads_;
+    size_t next_;
+    std::auto_ptr<semaphore> exited_;
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_ReactorShards_H_
@@ -0,0 +1,244 @@
+
+# include "pro_config.h"
+# include "jingxian/threading/semaphore.h"
+# include "jingxian/threading/thread.h"
+# include "jingxian/protocol/EchoProtocolFactory.h"
+# include "jingxian/networks/IOCPServer.h"
+# include "jingxian/networks/ReactorShards.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+TEST(reactorShards, roundRobin)
+{
+    std::vector<LONG> loads(3, 0);
+    loads[0] = 5;
+
+    // תʱ
+    size_t next = 0;
+    ASSERT_TRUE(0 == ReactorShards::select(ShardPolicy::RoundRobin, loads, next));
+    ASSERT_TRUE(1 == ReactorShards::select(ShardPolicy::RoundRobin, loads, next));
+    ASSERT_TRUE(2 == ReactorShards::select(ShardPolicy::RoundRobin, loads, next));
+    ASSERT_TRUE(0 == ReactorShards::select(ShardPolicy::RoundRobin, loads, next));
+}
+
+TEST(reactorShards, leastLoaded)
+{
+    std::vector<LONG> loads(4, 0);
+    loads[0] = 3;
+    loads[1] = 1;
+    loads[2] = 2;
+    loads[3] = 1;
+
+    // ͬ 1  3 ѡ
+    size_t next = 0;
+    ASSERT_TRUE(1 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+    ASSERT_TRUE(1 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+    ASSERT_TRUE(3 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+    ASSERT_TRUE(3 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+
+    loads[2] = 0;
+    ASSERT_TRUE(2 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+}
+
+TEST(reactorShards, empty)
+{
+    std::vector<LONG> loads;
+    size_t next = 0;
+    ASSERT_TRUE(0 == ReactorShards::select(ShardPolicy::LeastLoaded, loads, next));
+}
+
+#ifndef _GOOGLETEST_
+
+namespace
+{
+    /// ͬʱߵĿͻ, Ƭ仯ʱֲ
+    const size_t ECHO_CONNECTIONS = 32;
+    /// ÿϢ
+    const size_t ECHO_MESSAGE = 64;
+
+    /**
+     * ѭֹ߳ͣ
+     */
+    class StopPrimary : public IRunnable
+    {
+    public:
+        StopPrimary(IOCPServer* primary)
+                : primary_(primary)
+        {
+        }
+
+        virtual void run()
+        {
+            primary_->interrupt();
+        }
+
+    private:
+        IOCPServer* primary_;
+    };
+
+    /**
+     * пͻ̵߳Ĺ, ȫϺͬʱʼ
+     */
+    struct EchoClients
+    {
+        EchoClients(const char* port, size_t rounds)
+                : port(port)
+                , rounds(rounds)
+                , ready(0, LONG_MAX)
+                , start(0, LONG_MAX)
+                , done(0, LONG_MAX)
+                , failed(0)
+        {
+        }
+
+        const char* port;
+        size_t rounds;
+        semaphore ready;
+        semaphore start;
+        semaphore done;
+        volatile LONG failed;
+    };
+
+    void runPrimary(IOCPServer* primary, semaphore* exited)
+    {
+        primary->runForever();
+        exited->release();
+    }
+
+    SOCKET connectEcho(const char* port)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        addr.sin_port = htons((u_short)atoi(port));
+
+        // ѭ runForever() вſʼ, տʼ
+        for (int retries = 0; retries < 100; ++ retries)
+        {
+            SOCKET sock = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (INVALID_SOCKET == sock)
+                return INVALID_SOCKET;
+            if (0 == ::connect(sock, (struct sockaddr*)&addr, sizeof(addr)))
+            {
+                BOOL nodelay = TRUE;
+                ::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+                return sock;
+            }
+            closesocket(sock);
+            ::Sleep(10);
+        }
+        return INVALID_SOCKET;
+    }
+
+    bool roundTrip(SOCKET sock, char* message, char* reply)
+    {
+        if (ECHO_MESSAGE != ::send(sock, message, ECHO_MESSAGE, 0))
+            return false;
+
+        size_t received = 0;
+        while (received < ECHO_MESSAGE)
+        {
+            int len = ::recv(sock, reply + received, (int)(ECHO_MESSAGE - received), 0);
+            if (0 >= len)
+                return false;
+            received += len;
+        }
+        return 0 == memcmp(message, reply, ECHO_MESSAGE);
+    }
+
+    void runClient(EchoClients* clients)
+    {
+        char message[ECHO_MESSAGE];
+        char reply[ECHO_MESSAGE];
+        memset(message, 'e', sizeof(message));
+
+        SOCKET sock = connectEcho(clients->port);
+        clients->ready.release();
+        clients->start.acquire();
+
+        bool ok = (INVALID_SOCKET != sock);
+        for (size_t i = 0; ok && i < clients->rounds; ++ i)
+            ok = roundTrip(sock, message, reply);
+
+        if (!ok)
+            ::InterlockedIncrement(&clients->failed);
+        if (INVALID_SOCKET != sock)
+            closesocket(sock);
+        clients->done.release();
+    }
+
+    /**
+     * ѭ ECHO_CONNECTIONS Ӳת shards Ƭ( 
+     * ѭԼ ), ͻ߳Щ ECHO_MESSAGE ֽڵ, ÿ
+     * һ. ԱȲͬƬµ ns/op ǻԷƬ
+     * , Ƭ CPU Ӧٱ.
+     */
+    void runEcho(BenchmarkState& state, size_t shards, const char* port)
+    {
+        state.pauseTiming();
+        state.setBytesProcessed(2 * ECHO_MESSAGE);
+
+        IOCPServer primary;
+        primary.initialize(1);
+        EchoProtocolFactory factory;
+        tstring endpoint = concat<tstring>(_T("tcp://127.0.0.1:"), toTstring(port));
+        ASSERT_TRUE(primary.listenWith(endpoint.c_str(), &factory));
+
+        ReactorShards group(&primary);
+        group.policy(ShardPolicy::RoundRobin);
+        group.start(shards, false, null_ptr);
+
+        semaphore exited(0, 1);
+        create_thread(&runPrimary, &primary, &exited, _T("primary"));
+
+        EchoClients clients(port, (state.iterations() + ECHO_CONNECTIONS - 1) / ECHO_CONNECTIONS);
+        for (size_t i = 0; i < ECHO_CONNECTIONS; ++ i)
+            create_thread(&runClient, &clients, _T("client"));
+        for (size_t i = 0; i < ECHO_CONNECTIONS; ++ i)
+            clients.ready.acquire();
+        state.resumeTiming();
+
+        clients.start.release(ECHO_CONNECTIONS);
+        for (size_t i = 0; i < ECHO_CONNECTIONS; ++ i)
+            clients.done.acquire();
+
+        state.pauseTiming();
+        ASSERT_TRUE(0 == clients.failed);
+
+        // ƬҪӶϿ˳, ͻѾȫر
+        primary.send(new StopPrimary(&primary));
+        exited.acquire();
+        group.stop();
+        state.resumeTiming();
+    }
+}
+
+BENCHMARK(shards_echo_1)
+{
+    runEcho(state, 1, "30081");
+}
+
+BENCHMARK(shards_echo_2)
+{
+    runEcho(state, 2, "30082");
+}
+
+BENCHMARK(shards_echo_4)
+{
+    runEcho(state, 4, "30084");
+}
+
+BENCHMARK(shards_echo_8)
+{
+    runEcho(state, 8, "30088");
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
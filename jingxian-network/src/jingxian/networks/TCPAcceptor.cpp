@@ -97,6 +97,50 @@ bool TCPAcceptor::startListening()
     }
     SOCKADDR_STORAGE  addr;
     int len = sizeof(SOCKADDR_STORAGE);
+
+    socket_ = core_->takeSharedSocket(_T("tcp://") + endpoint_);
+    if (INVALID_SOCKET != socket_)
+    {
+        // ɼؽ̴, Ѿڼ
+        if (SOCKET_ERROR == ::getsockname(socket_, (struct sockaddr*)&addr, &len))
+        {
+            LOG_ERROR(logger_, _T("ַ '") << endpoint_
+                      << _T("' ʱ -  socket  - '") << lastError()
+                      << _T("'"));
+            return false;
+        }
+    }
+    else if (!createSocket(addr, len))
+    {
+        return false;
+    }
+
+    if (!core_->bind((HANDLE)socket_, this))
+    {
+        LOG_ERROR(logger_, _T("󶨼ַ '") << endpoint_
+                  << _T("' ɶ˿ʱ -  '") << lastError()
+                  << _T("'"));
+        return false;
+    }
+
+    status_ = connection_status::listening;
+    family_ = addr.ss_family;
+
+    LOG_INFO(logger_, _T("ַ '") << endpoint_
+             << _T("' ɹ!"));
+
+    toString_ = concat<tstring>(_T("TCPAcceptor[ socket=")
+                                , ::toString((int)socket_)
+                                , _T(",address=")
+                                , endpoint_
+                                , _T("]"));
+
+    return true;
+}
+
+
+bool TCPAcceptor::createSocket(SOCKADDR_STORAGE& addr, int& len)
+{
     if (!networking::stringToAddress(endpoint_.c_str(), (struct sockaddr*)&addr, &len))
     {
         LOG_ERROR(logger_, _T("ַ '") << endpoint_
@@ -130,30 +174,9 @@ bool TCPAcceptor::startListening()
         return false;
     }
 
-    if (!core_->bind((HANDLE)socket_, this))
-    {
-        LOG_ERROR(logger_, _T("󶨼ַ '") << endpoint_
-                  << _T("' ɶ˿ʱ -  '") << lastError()
-                  << _T("'"));
-        return false;
-    }
-
-    status_ = connection_status::listening;
-    family_ = addr.ss_family;
-
-    LOG_INFO(logger_, _T("ַ '") << endpoint_
-             << _T("' ɹ!"));
-
-    toString_ = concat<tstring>(_T("TCPAcceptor[ socket=")
-                                , ::toString((int)socket_)
-                                , _T(",address=")
-                                , endpoint_
-                                , _T("]"));
-
     return true;
 }
 
-
 bool TCPAcceptor::initialize()
 {
     return startListening();
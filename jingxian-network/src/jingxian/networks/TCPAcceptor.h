@@ -81,6 +81,11 @@ private:
 
     friend class AcceptCommand;
 
+    /**
+     *  socket 󶨺ͼ endpoint_
+     */
+    bool createSocket(SOCKADDR_STORAGE& addr, int& len);
+
     //SOCKET handle() { return socket_; }
     //IOCPServer* nextCore(){ return core_; }
     //ILogger* logger(){ return logger_; }
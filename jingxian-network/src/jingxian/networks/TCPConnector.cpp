@@ -23,16 +23,39 @@ void TCPConnector::connect(const tchar* endPoint
                            , OnBuildConnectionError onError
                            , void* context)
 {
-    std::auto_ptr< ICommand> command(new ConnectCommand(core_
-                                     , endPoint
-                                     , onComplete
-                                     , onError
-                                     , context));
+    execute(new ConnectCommand(core_
+                               , endPoint
+                               , onComplete
+                               , onError
+                               , context)
+            , onError
+            , context);
+}
+
+void TCPConnector::connect(const Endpoint& endPoint
+                           , OnBuildConnectionComplete onComplete
+                           , OnBuildConnectionError onError
+                           , void* context)
+{
+    execute(new ConnectCommand(core_
+                               , endPoint
+                               , onComplete
+                               , onError
+                               , context)
+            , onError
+            , context);
+}
+
+void TCPConnector::execute(ConnectCommand* cmd
+                           , OnBuildConnectionError onError
+                           , void* context)
+{
+    std::auto_ptr< ConnectCommand> command(cmd);
     if (! command->execute())
     {
         int code = WSAGetLastError();
         tstring descr = concat<tstring>(_T("ӵַ '")
-                                        , endPoint
+                                        , command->host()
                                         , _T("' ʱ - ")
                                         , lastError(code));
         LOG_ERROR(logger_, descr);
@@ -17,6 +17,8 @@
 
 _jingxian_begin
 
+class ConnectCommand;
+
 class TCPConnector : public IConnectionBuilder
 {
 public:
@@ -36,6 +38,14 @@ public:
                          , OnBuildConnectionError onError
                          , void* context);
 
+    /**
+     * @implements connect
+     */
+    virtual void connect(const Endpoint& endPoint
+                         , OnBuildConnectionComplete onComplete
+                         , OnBuildConnectionError onError
+                         , void* context);
+
     /**
      * @implements toString
      */
@@ -46,6 +56,10 @@ private:
 
     friend class ConnectCommand;
 
+    void execute(ConnectCommand* cmd
+                 , OnBuildConnectionError onError
+                 , void* context);
+
     IOCPServer* nextCore()
     {
         return core_;
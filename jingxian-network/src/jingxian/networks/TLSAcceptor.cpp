@@ -0,0 +1,134 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/TLSAcceptor.h"
+# include "jingxian/networks/TLSTransport.h"
+# include "jingxian/networks/IOCPServer.h"
+
+_jingxian_begin
+
+TLSAcceptor::TLSAcceptor(IOCPServer* core, IAcceptor* acceptor)
+        : core_(core)
+        , acceptor_(acceptor)
+        , logger_(_T("jingxian.acceptor.tlsAcceptor"))
+{
+    toString_ = _T("TLSAcceptor[address=") + acceptor_->bindPoint() + _T("]");
+}
+
+TLSAcceptor::~TLSAcceptor()
+{
+}
+
+time_t TLSAcceptor::timeout() const
+{
+    return acceptor_->timeout();
+}
+
+bool TLSAcceptor::initialize()
+{
+    TLSContext& tls = core_->tls();
+    if (!tls.initialize())
+        return false;
+
+    if (!tls.hasCertificate())
+    {
+        LOG_ERROR(logger_, _T("ַ '") << acceptor_->bindPoint()
+                  << _T("' ʱ - û֤( tlsCertificate )"));
+        return false;
+    }
+
+    return acceptor_->initialize();
+}
+
+const tstring& TLSAcceptor::bindPoint() const
+{
+    return acceptor_->bindPoint();
+}
+
+bool TLSAcceptor::isListening() const
+{
+    return acceptor_->isListening();
+}
+
+void TLSAcceptor::accept(OnBuildConnectionComplete onComplete
+                         , OnBuildConnectionError onError
+                         , void* context)
+{
+    Request* request = new Request();
+    request->owner = this;
+    request->onComplete = onComplete;
+    request->onError = onError;
+    request->context = context;
+
+    acceptor_->accept(&TLSAcceptor::onAccepted, &TLSAcceptor::onFailed, request);
+}
+
+void TLSAcceptor::onAccepted(ITransport* transport, void* context)
+{
+    std::auto_ptr<Request> request((Request*)context);
+
+    // ׼ƾܾ
+    if (is_null(transport))
+    {
+        request->onComplete(null_ptr, request->context);
+        return;
+    }
+
+    IOCPServer* core = request->owner->core_;
+    TLSTransport* tls = null_ptr;
+    try
+    {
+        tls = new TLSTransport(core, &core->tls(), &core->timers(), transport);
+    }
+    catch (const Exception& e)
+    {
+        LOG_ERROR(request->owner->logger_, _T(" TLS ʧ - ") << e);
+        transport->disconnection(_T(" TLS ʧ"));
+        request->onComplete(null_ptr, request->context);
+        return;
+    }
+
+    request->onComplete(tls, request->context);
+}
+
+void TLSAcceptor::onFailed(const ErrorCode& err, void* context)
+{
+    std::auto_ptr<Request> request((Request*)context);
+    request->onError(err, request->context);
+}
+
+void TLSAcceptor::close()
+{
+    acceptor_->close();
+}
+
+const tstring& TLSAcceptor::toString() const
+{
+    return toString_;
+}
+
+TLSAcceptorFactory::TLSAcceptorFactory(IOCPServer* core, IAcceptorFactory* factory)
+        : core_(core)
+        , factory_(factory)
+        , toString_(_T("TLSAcceptorFactory"))
+{
+}
+
+TLSAcceptorFactory::~TLSAcceptorFactory()
+{
+}
+
+IAcceptor* TLSAcceptorFactory::createAcceptor(const tchar* endPoint)
+{
+    IAcceptor* acceptor = factory_->createAcceptor(endPoint);
+    if (is_null(acceptor))
+        return null_ptr;
+
+    return new TLSAcceptor(core_, acceptor);
+}
+
+const tstring& TLSAcceptorFactory::toString() const
+{
+    return toString_;
+}
+
+_jingxian_end
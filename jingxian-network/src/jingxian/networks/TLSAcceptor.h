@@ -0,0 +1,126 @@
+
+#ifndef _TLSAcceptor_H_
+#define _TLSAcceptor_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <memory>
+# include "jingxian/string/string.h"
+# include "jingxian/IAcceptor.h"
+# include "jingxian/logging/logging.h"
+
+_jingxian_begin
+
+class IOCPServer;
+
+/**
+ * tls:// ַĽ,  TCP Ӻװ TLSTransport
+ */
+class TLSAcceptor : public IAcceptor
+{
+public:
+
+    TLSAcceptor(IOCPServer* core, IAcceptor* acceptor);
+
+    /**
+     * @implements ~TLSAcceptor
+     */
+    virtual ~TLSAcceptor();
+
+    /**
+     * @implements timeout
+     */
+    virtual time_t timeout() const;
+
+    /**
+     * @implements initialize
+     */
+    virtual bool initialize();
+
+    /**
+     * @implements bindPoint
+     */
+    virtual const tstring& bindPoint() const;
+
+    /**
+     * @implements isListening
+     */
+    virtual bool isListening() const;
+
+    /**
+     * @implements accept
+     */
+    virtual void accept(OnBuildConnectionComplete onComplete
+                        , OnBuildConnectionError onError
+                        , void* context);
+
+    /**
+     * @implements close
+     */
+    virtual void close();
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(TLSAcceptor);
+
+    struct Request
+    {
+        TLSAcceptor* owner;
+        OnBuildConnectionComplete onComplete;
+        OnBuildConnectionError onError;
+        void* context;
+    };
+
+    static void onAccepted(ITransport* transport, void* context);
+    static void onFailed(const ErrorCode& err, void* context);
+
+    IOCPServer* core_;
+    std::auto_ptr<IAcceptor> acceptor_;
+    logging::logger logger_;
+    tstring toString_;
+};
+
+class TLSAcceptorFactory : public IAcceptorFactory
+{
+public:
+
+    /**
+     * @param[ in ] factory  TCP Ĺ( ӵ )
+     */
+    TLSAcceptorFactory(IOCPServer* core, IAcceptorFactory* factory);
+
+    /**
+     * @implements ~TLSAcceptorFactory
+     */
+    virtual ~TLSAcceptorFactory();
+
+    /**
+     * @implements createAcceptor
+     */
+    virtual IAcceptor* createAcceptor(const tchar* endPoint);
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(TLSAcceptorFactory);
+
+    IOCPServer* core_;
+    IAcceptorFactory* factory_;
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_TLSAcceptor_H_
@@ -0,0 +1,341 @@
+
+# include "pro_config.h"
+# include <openssl/ssl.h>
+# include <openssl/evp.h>
+# include <openssl/x509.h>
+# include "jingxian/networks/TLSContext.h"
+# include "jingxian/networks/TLSTransport.h"
+# include "jingxian/networks/LoopbackTransport.h"
+
+#ifdef _GOOGLETEST_
+#include <gtest/gtest.h>
+#else
+#include "jingxian/utilities/unittest.h"
+#endif
+
+namespace
+{
+    /**
+     * һǩ P-256 ֤, װ˵ TLSContext 
+     */
+    bool useTestCertificate(TLSContext& tls)
+    {
+        EVP_PKEY* key = null_ptr;
+        EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, null_ptr);
+        if (is_null(keyContext)
+                || 0 >= EVP_PKEY_keygen_init(keyContext)
+                || 0 >= EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1)
+                || 0 >= EVP_PKEY_keygen(keyContext, &key))
+        {
+            EVP_PKEY_CTX_free(keyContext);
+            return false;
+        }
+        EVP_PKEY_CTX_free(keyContext);
+
+        X509* cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_get_notBefore(cert), 0);
+        X509_gmtime_adj(X509_get_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+
+        bool ok = 0 < X509_sign(cert, key, EVP_sha256())
+                  && 1 == SSL_CTX_use_certificate(tls.handle(), cert)
+                  && 1 == SSL_CTX_use_PrivateKey(tls.handle(), key);
+
+        X509_free(cert);
+        EVP_PKEY_free(key);
+        return ok;
+    }
+
+    /**
+     * һڴ TLS 
+     */
+    struct TLSPair
+    {
+        TLSPair(TLSContext& server, TLSContext& client, TimerQueue& timers)
+                : serverLower(_T("server"))
+                , clientLower(_T("client"))
+                , timers_(timers)
+        {
+            serverTLS = new TLSTransport(null_ptr, &server, &timers, &serverLower);
+            clientTLS = new TLSTransport(null_ptr, &client, &timers, &clientLower);
+            serverTLS->bindProtocol(&serverProtocol);
+            clientTLS->bindProtocol(&clientProtocol);
+        }
+
+        ~TLSPair()
+        {
+            serverLower.closed();
+            clientLower.closed();
+        }
+
+        void connect()
+        {
+            serverTLS->initialize();
+            clientTLS->initialize();
+            pump();
+        }
+
+        /**
+         * ر(  close_notify ), 쳣ϿĻỰٻָ
+         */
+        void close()
+        {
+            clientTLS->disconnection();
+            pump();
+        }
+
+        void pump()
+        {
+            for (;;)
+            {
+                timers_.runExpired();
+                size_t len = clientLower.deliver(serverLower);
+                len += serverLower.deliver(clientLower);
+                if (0 == len && 0 == timers_.size())
+                    return;
+            }
+        }
+
+        void write(TLSContext& tls, TLSTransport* transport, const char* data, size_t len)
+        {
+            while (0 != len)
+            {
+                databuffer_t* buffer = tls.allocate();
+                buffer_chain_t* chain = cast_to_buffer_chain(buffer);
+                size_t size = (len > wd_length(chain)) ? wd_length(chain) : len;
+                memcpy(wd_ptr(chain), data, size);
+                wd_ptr(chain, size);
+                transport->write(chain);
+                data += size;
+                len -= size;
+            }
+        }
+
+        LoopbackTransport serverLower;
+        LoopbackTransport clientLower;
+        RecordProtocol serverProtocol;
+        RecordProtocol clientProtocol;
+        TLSTransport* serverTLS;
+        TLSTransport* clientTLS;
+
+    private:
+        TimerQueue& timers_;
+    };
+
+    bool initializeServer(TLSContext& server)
+    {
+        return server.initialize() && useTestCertificate(server);
+    }
+}
+
+TEST(tls, sessionCache)
+{
+    TLSSessionCache cache;
+    cache.capacity(2);
+    cache.timeout(10);
+
+    std::string data;
+    cache.put((const unsigned char*)"a", 1, (const unsigned char*)"1", 1, 100);
+    cache.put((const unsigned char*)"b", 1, (const unsigned char*)"2", 1, 100);
+    ASSERT_TRUE(cache.get((const unsigned char*)"a", 1, data, 101));
+    ASSERT_TRUE("1" == data);
+
+    // ʱ̭ûù b
+    cache.put((const unsigned char*)"c", 1, (const unsigned char*)"3", 1, 102);
+    ASSERT_TRUE(2 == cache.size());
+    ASSERT_FALSE(cache.get((const unsigned char*)"b", 1, data, 102));
+    ASSERT_TRUE(cache.get((const unsigned char*)"c", 1, data, 102));
+    ASSERT_TRUE("3" == data);
+
+    // ڵĻỰȡʱɾ
+    ASSERT_FALSE(cache.get((const unsigned char*)"a", 1, data, 111));
+    ASSERT_TRUE(1 == cache.size());
+
+    cache.remove((const unsigned char*)"c", 1);
+    ASSERT_TRUE(0 == cache.size());
+    ASSERT_TRUE(2 == cache.hits());
+    ASSERT_TRUE(2 == cache.misses());
+}
+
+TEST(tls, exchange)
+{
+    TLSContext server(true);
+    TLSContext client(false);
+    ASSERT_TRUE(initializeServer(server));
+    ASSERT_TRUE(client.initialize());
+
+    TimerQueue timers;
+    TLSPair pair(server, client, timers);
+    pair.connect();
+    ASSERT_TRUE(pair.serverTLS->isEstablished());
+    ASSERT_TRUE(pair.clientTLS->isEstablished());
+    ASSERT_TRUE(pair.serverProtocol.connected);
+    ASSERT_TRUE(pair.clientProtocol.connected);
+    ASSERT_FALSE(pair.serverTLS->isResumed());
+
+    // ¼֮ĶСдϲһ¼, ڶʱз
+    std::string expected;
+    for (int i = 0; i < 100; ++ i)
+    {
+        pair.write(client, pair.clientTLS, "hello", 5);
+        expected += "hello";
+    }
+    ASSERT_TRUE(pair.clientLower.wire.empty());
+    size_t batches = pair.clientLower.batches;
+    timers.runExpired();
+    ASSERT_TRUE(batches + 1 == pair.clientLower.batches);
+    ASSERT_TRUE(pair.clientLower.wire.size() < 600);
+    pair.pump();
+    ASSERT_TRUE(expected == pair.serverProtocol.data);
+
+    // ݰ¼
+    std::string bulk(100*1000, 'x');
+    for (size_t i = 0; i < bulk.size(); ++ i)
+        bulk[i] = (char)('a' + i % 26);
+    pair.write(server, pair.serverTLS, bulk.data(), bulk.size());
+    pair.pump();
+    ASSERT_TRUE(bulk == pair.clientProtocol.data);
+
+    // close_notify öԷҲر
+    pair.clientTLS->disconnection();
+    ASSERT_TRUE(pair.clientLower.disconnected);
+    pair.pump();
+    ASSERT_TRUE(pair.serverLower.disconnected);
+}
+
+TEST(tls, resumption)
+{
+    for (int tickets = 0; tickets < 2; ++ tickets)
+    {
+        TLSContext server(true);
+        TLSContext client(false);
+        server.options().tickets = (0 != tickets);
+        ASSERT_TRUE(initializeServer(server));
+        ASSERT_TRUE(client.initialize());
+
+        TimerQueue timers;
+        SSL_SESSION* session = null_ptr;
+        {
+            TLSPair pair(server, client, timers);
+            pair.connect();
+            ASSERT_TRUE(pair.clientTLS->isEstablished());
+            session = SSL_get1_session(pair.clientTLS->handle());
+            pair.close();
+        }
+        ASSERT_TRUE(!is_null(session));
+
+        {
+            TLSPair pair(server, client, timers);
+            SSL_set_session(pair.clientTLS->handle(), session);
+            pair.connect();
+            ASSERT_TRUE(pair.serverTLS->isResumed());
+            ASSERT_TRUE(pair.clientTLS->isResumed());
+        }
+        SSL_SESSION_free(session);
+
+        ASSERT_TRUE(2 == server.handshakes());
+        ASSERT_TRUE(1 == server.resumed());
+        // ƱʱĻỰָ
+        if (0 == tickets)
+            ASSERT_TRUE(1 == server.sessions().hits());
+    }
+}
+
+#ifndef _GOOGLETEST_
+
+BENCHMARK(tls_full_handshake)
+{
+    TLSContext server(true);
+    TLSContext client(false);
+    initializeServer(server);
+    client.initialize();
+    TimerQueue timers;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        TLSPair pair(server, client, timers);
+        pair.connect();
+        DO_NOT_OPTIMIZE(pair.serverTLS->isEstablished());
+        pair.close();
+    }
+}
+
+BENCHMARK(tls_resumed_handshake)
+{
+    TLSContext server(true);
+    TLSContext client(false);
+    initializeServer(server);
+    client.initialize();
+    TimerQueue timers;
+
+    SSL_SESSION* session = null_ptr;
+    {
+        TLSPair pair(server, client, timers);
+        pair.connect();
+        session = SSL_get1_session(pair.clientTLS->handle());
+        pair.close();
+    }
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        TLSPair pair(server, client, timers);
+        SSL_set_session(pair.clientTLS->handle(), session);
+        pair.connect();
+        DO_NOT_OPTIMIZE(pair.serverTLS->isResumed());
+        pair.close();
+    }
+    SSL_SESSION_free(session);
+}
+
+BENCHMARK(tls_bulk)
+{
+    TLSContext server(true);
+    TLSContext client(false);
+    initializeServer(server);
+    client.initialize();
+    TimerQueue timers;
+
+    TLSPair pair(server, client, timers);
+    pair.connect();
+    pair.clientProtocol.keep = false;
+
+    std::string block(64*1024, 'x');
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        pair.write(server, pair.serverTLS, block.data(), block.size());
+        pair.pump();
+    }
+    state.setBytesProcessed(block.size() * state.iterations());
+    DO_NOT_OPTIMIZE(pair.clientProtocol.received);
+}
+
+BENCHMARK(tls_small_writes)
+{
+    TLSContext server(true);
+    TLSContext client(false);
+    initializeServer(server);
+    client.initialize();
+    TimerQueue timers;
+
+    TLSPair pair(server, client, timers);
+    pair.connect();
+    pair.clientProtocol.keep = false;
+
+    char message[100];
+    memset(message, 'x', sizeof(message));
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        for (int j = 0; j < 32; ++ j)
+            pair.write(server, pair.serverTLS, message, sizeof(message));
+        pair.pump();
+    }
+    state.setBytesProcessed(sizeof(message) * 32 * state.iterations());
+    DO_NOT_OPTIMIZE(pair.clientProtocol.received);
+}
+
+#endif // _GOOGLETEST_
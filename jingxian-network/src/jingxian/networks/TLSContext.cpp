@@ -0,0 +1,425 @@
+
+# include "pro_config.h"
+# include <fstream>
+# include <openssl/ssl.h>
+# include <openssl/err.h>
+# include <openssl/evp.h>
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/networks/TLSContext.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ౣĿݿ
+    const size_t MAX_FREE_CHUNKS = 256;
+
+    /// SSL_CTX ϱ TLSContext ָλ, Ƭ߳̿ͬʱʼ,
+    /// ֻеһȡõλЧ
+    int contextIndex()
+    {
+        static volatile LONG index = -1;
+        if (-1 == index)
+        {
+            LONG created = SSL_CTX_get_ex_new_index(0, null_ptr, null_ptr, null_ptr, null_ptr);
+            ::InterlockedCompareExchange(&index, created, -1);
+        }
+        return (int)index;
+    }
+
+    TLSContext* fromSSL(SSL* ssl)
+    {
+        return (TLSContext*)SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), contextIndex());
+    }
+}
+
+TLSSessionCache::TLSSessionCache()
+        : capacity_(20*1000)
+        , timeout_(5*60)
+        , hits_(0)
+        , misses_(0)
+{
+}
+
+void TLSSessionCache::capacity(size_t capacity)
+{
+    capacity_ = capacity;
+    while (entries_.size() > capacity_)
+    {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+size_t TLSSessionCache::capacity() const
+{
+    return capacity_;
+}
+
+void TLSSessionCache::timeout(time_t seconds)
+{
+    timeout_ = seconds;
+}
+
+time_t TLSSessionCache::timeout() const
+{
+    return timeout_;
+}
+
+void TLSSessionCache::put(const unsigned char* id, size_t idLen
+                          , const unsigned char* data, size_t dataLen
+                          , time_t now)
+{
+    if (0 == capacity_)
+        return;
+
+    std::string key((const char*)id, idLen);
+    container_type::iterator it = entries_.find(key);
+    if (entries_.end() == it)
+    {
+        if (entries_.size() >= capacity_)
+        {
+            entries_.erase(lru_.back());
+            lru_.pop_back();
+        }
+
+        lru_.push_front(key);
+        it = entries_.insert(std::make_pair(key, Entry())).first;
+        it->second.position = lru_.begin();
+    }
+    else
+    {
+        lru_.splice(lru_.begin(), lru_, it->second.position);
+    }
+
+    it->second.data.assign((const char*)data, dataLen);
+    it->second.expires = now + timeout_;
+}
+
+bool TLSSessionCache::get(const unsigned char* id, size_t idLen, std::string& data, time_t now)
+{
+    container_type::iterator it = entries_.find(std::string((const char*)id, idLen));
+    if (entries_.end() == it)
+    {
+        ++ misses_;
+        return false;
+    }
+
+    if (it->second.expires <= now)
+    {
+        lru_.erase(it->second.position);
+        entries_.erase(it);
+        ++ misses_;
+        return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.position);
+    data = it->second.data;
+    ++ hits_;
+    return true;
+}
+
+void TLSSessionCache::remove(const unsigned char* id, size_t idLen)
+{
+    container_type::iterator it = entries_.find(std::string((const char*)id, idLen));
+    if (entries_.end() == it)
+        return;
+
+    lru_.erase(it->second.position);
+    entries_.erase(it);
+}
+
+size_t TLSSessionCache::size() const
+{
+    return entries_.size();
+}
+
+size_t TLSSessionCache::hits() const
+{
+    return hits_;
+}
+
+size_t TLSSessionCache::misses() const
+{
+    return misses_;
+}
+
+TLSContext::TLSContext(bool server)
+        : server_(server)
+        , ctx_(null_ptr)
+        , handshakes_(0)
+        , resumed_(0)
+        , logger_(_T("jingxian.system.tls"))
+{
+}
+
+TLSContext::~TLSContext()
+{
+    if (!is_null(ctx_))
+    {
+        SSL_CTX_free(ctx_);
+        ctx_ = null_ptr;
+    }
+
+    for (std::vector<databuffer_t*>::iterator it = chunks_.begin(); it != chunks_.end(); ++ it)
+        my_free(*it);
+    chunks_.clear();
+}
+
+TLSContext::Options& TLSContext::options()
+{
+    return options_;
+}
+
+bool TLSContext::initialize()
+{
+    if (!is_null(ctx_))
+        return true;
+
+    SSL_library_init();
+    SSL_load_error_strings();
+
+    ctx_ = SSL_CTX_new(server_ ? SSLv23_server_method() : SSLv23_client_method());
+    if (is_null(ctx_))
+    {
+        LOG_ERROR(logger_, _T(" SSL_CTX ʧ - ") << lastError());
+        return false;
+    }
+
+    SSL_CTX_set_ex_data(ctx_, contextIndex(), this);
+    SSL_CTX_set_options(ctx_, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 | SSL_OP_NO_COMPRESSION);
+    // Ӳд
+    SSL_CTX_set_mode(ctx_, SSL_MODE_RELEASE_BUFFERS);
+
+    if (!options_.ciphers.empty()
+        && 1 != SSL_CTX_set_cipher_list(ctx_, toNarrowString(options_.ciphers).c_str()))
+    {
+        LOG_ERROR(logger_, _T("׼ '") << options_.ciphers << _T("' ȷ - ") << lastError());
+        SSL_CTX_free(ctx_);
+        ctx_ = null_ptr;
+        return false;
+    }
+
+    if (!server_)
+    {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT);
+        return true;
+    }
+
+    if (!options_.certificate.empty())
+    {
+        tstring key = options_.privateKey.empty() ? options_.certificate : options_.privateKey;
+        if (1 != SSL_CTX_use_certificate_chain_file(ctx_, toNarrowString(options_.certificate).c_str())
+            || 1 != SSL_CTX_use_PrivateKey_file(ctx_, toNarrowString(key).c_str(), SSL_FILETYPE_PEM)
+            || 1 != SSL_CTX_check_private_key(ctx_))
+        {
+            LOG_ERROR(logger_, _T("֤ '") << options_.certificate
+                      << _T("' ˽Կ '") << key << _T("' ʧ - ") << lastError());
+            SSL_CTX_free(ctx_);
+            ctx_ = null_ptr;
+            return false;
+        }
+    }
+
+    // Ự sessions_ , м˿ڹ
+    sessions_.capacity(options_.sessionCacheSize);
+    sessions_.timeout(options_.sessionTimeout);
+    static const unsigned char sessionContext[] = "jingxian";
+    SSL_CTX_set_session_id_context(ctx_, sessionContext, sizeof(sessionContext) - 1);
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_set_timeout(ctx_, (long)options_.sessionTimeout);
+    SSL_CTX_sess_set_new_cb(ctx_, &TLSContext::onNewSession);
+    SSL_CTX_sess_set_get_cb(ctx_, &TLSContext::onGetSession);
+    SSL_CTX_sess_set_remove_cb(ctx_, &TLSContext::onRemoveSession);
+
+    if (!options_.tickets)
+        SSL_CTX_set_options(ctx_, SSL_OP_NO_TICKET);
+    else if (!options_.ticketKey.empty() && !loadTicketKey())
+    {
+        SSL_CTX_free(ctx_);
+        ctx_ = null_ptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool TLSContext::loadTicketKey()
+{
+    std::ifstream in(toNarrowString(options_.ticketKey).c_str(), std::ios::in | std::ios::binary);
+    std::string seed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in.eof() || 16 > seed.size())
+    {
+        LOG_ERROR(logger_, _T("ỰƱԿļ '") << options_.ticketKey
+                  << _T("' ʧ,  16 ֽ"));
+        return false;
+    }
+
+    // Կ OpenSSL 汾ͬ, ӵ SHA-256 ժҪչҪĳ
+    long len = SSL_CTX_get_tlsext_ticket_keys(ctx_, null_ptr, 0);
+    std::vector<unsigned char> keys;
+    for (unsigned char counter = 0; (long)keys.size() < len; ++ counter)
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digestLen = 0;
+        EVP_MD_CTX* md = EVP_MD_CTX_create();
+        EVP_DigestInit_ex(md, EVP_sha256(), null_ptr);
+        EVP_DigestUpdate(md, &counter, 1);
+        EVP_DigestUpdate(md, seed.data(), seed.size());
+        EVP_DigestFinal_ex(md, digest, &digestLen);
+        EVP_MD_CTX_destroy(md);
+        keys.insert(keys.end(), digest, digest + digestLen);
+    }
+
+    if (1 != SSL_CTX_set_tlsext_ticket_keys(ctx_, &keys[0], len))
+    {
+        LOG_ERROR(logger_, _T("ûỰƱԿʧ - ") << lastError());
+        return false;
+    }
+    return true;
+}
+
+bool TLSContext::isInitialized() const
+{
+    return !is_null(ctx_);
+}
+
+bool TLSContext::isServer() const
+{
+    return server_;
+}
+
+bool TLSContext::hasCertificate() const
+{
+    return !is_null(ctx_) && !is_null(SSL_CTX_get0_certificate(ctx_));
+}
+
+ssl_st* TLSContext::createSSL()
+{
+    if (is_null(ctx_))
+        ThrowException1(RuntimeException, _T("TLSContext ûгʼ"));
+
+    SSL* ssl = SSL_new(ctx_);
+    if (is_null(ssl))
+        ThrowException1(RuntimeException, concat<tstring>(_T(" SSL ʧ - "), lastError()));
+    return ssl;
+}
+
+ssl_ctx_st* TLSContext::handle()
+{
+    return ctx_;
+}
+
+TLSSessionCache& TLSContext::sessions()
+{
+    return sessions_;
+}
+
+databuffer_t* TLSContext::allocate()
+{
+    databuffer_t* result = null_ptr;
+    if (chunks_.empty())
+    {
+        // еĿշ, ڽջ
+        result = (databuffer_t*)my_malloc_as(sizeof(databuffer_t) + CHUNK_SIZE, MemoryKind::Receive);
+        result->chain.context = this;
+        result->chain.freebuffer = &TLSContext::freeChunk;
+        result->chain.type = BUFFER_ELEMENT_MEMORY;
+        result->capacity = CHUNK_SIZE;
+    }
+    else
+    {
+        result = chunks_.back();
+        chunks_.pop_back();
+    }
+
+    result->chain._next = null_ptr;
+    result->start = result->end = result->ptr;
+    return result;
+}
+
+void TLSContext::freeChunk(buffer_chain_t* chain, void* context)
+{
+    TLSContext* self = (TLSContext*)context;
+    if (self->chunks_.size() >= MAX_FREE_CHUNKS)
+    {
+        my_free(chain);
+        return;
+    }
+    self->chunks_.push_back(cast_to_databuffer(chain));
+}
+
+void TLSContext::handshaked(bool resumed)
+{
+    ++ handshakes_;
+    if (resumed)
+        ++ resumed_;
+}
+
+size_t TLSContext::handshakes() const
+{
+    return handshakes_;
+}
+
+size_t TLSContext::resumed() const
+{
+    return resumed_;
+}
+
+int TLSContext::onNewSession(SSL* ssl, SSL_SESSION* session)
+{
+    unsigned int idLen = 0;
+    const unsigned char* id = SSL_SESSION_get_id(session, &idLen);
+    int len = i2d_SSL_SESSION(session, null_ptr);
+    if (0 >= len || 0 == idLen)
+        return 0;
+
+    std::vector<unsigned char> data(len);
+    unsigned char* ptr = &data[0];
+    i2d_SSL_SESSION(session, &ptr);
+
+    fromSSL(ssl)->sessions_.put(id, idLen, &data[0], len, time(null_ptr));
+
+    //  0 ʾûб session 
+    return 0;
+}
+
+SSL_SESSION* TLSContext::onGetSession(SSL* ssl, const unsigned char* id, int len, int* copy)
+{
+    *copy = 0;
+
+    std::string data;
+    if (!fromSSL(ssl)->sessions_.get(id, len, data, time(null_ptr)))
+        return null_ptr;
+
+    const unsigned char* ptr = (const unsigned char*)data.data();
+    return d2i_SSL_SESSION(null_ptr, &ptr, (long)data.size());
+}
+
+void TLSContext::onRemoveSession(SSL_CTX* ctx, SSL_SESSION* session)
+{
+    TLSContext* self = (TLSContext*)SSL_CTX_get_ex_data(ctx, contextIndex());
+    if (is_null(self))
+        return;
+
+    unsigned int idLen = 0;
+    const unsigned char* id = SSL_SESSION_get_id(session, &idLen);
+    self->sessions_.remove(id, idLen);
+}
+
+tstring TLSContext::lastError()
+{
+    tstring result;
+    unsigned long code = 0;
+    while (0 != (code = ERR_get_error()))
+    {
+        char buf[256];
+        ERR_error_string_n(code, buf, sizeof(buf));
+        if (!result.empty())
+            result += _T("; ");
+        result += toTstring(buf);
+    }
+    return result.empty() ? tstring(_T("δ֪")) : result;
+}
+
+_jingxian_end
@@ -0,0 +1,208 @@
+
+#ifndef _TLSContext_H_
+#define _TLSContext_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <list>
+# include <map>
+# include <vector>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/buffer/buffer.h"
+
+struct ssl_ctx_st;
+struct ssl_st;
+struct ssl_session_st;
+
+_jingxian_begin
+
+/**
+ * ˵ TLS Ự
+ *
+ * Ự ID л( DER )ĻỰ, ʱ̭ûù, ڵ
+ * Ựȡʱɾ. ͬһ TLSContext ϵм˿ڹһ, ʹ
+ * ỰƱݻͻ˲֧Ʊʱ, ٴӵĿͻ.
+ */
+class TLSSessionCache
+{
+public:
+    TLSSessionCache();
+
+    /**
+     * ౣĻỰ
+     */
+    void capacity(size_t capacity);
+
+    size_t capacity() const;
+
+    /**
+     * ỰЧ(  )
+     */
+    void timeout(time_t seconds);
+
+    time_t timeout() const;
+
+    /**
+     * Ự, Ѵʱ滻
+     */
+    void put(const unsigned char* id, size_t idLen
+             , const unsigned char* data, size_t dataLen
+             , time_t now);
+
+    /**
+     * ȡỰ
+     * @return ڻѹʱ false
+     */
+    bool get(const unsigned char* id, size_t idLen, std::string& data, time_t now);
+
+    void remove(const unsigned char* id, size_t idLen);
+
+    size_t size() const;
+
+    size_t hits() const;
+
+    size_t misses() const;
+
+private:
+    NOCOPY(TLSSessionCache);
+
+    struct Entry
+    {
+        std::string data;
+        time_t expires;
+        std::list<std::string>::iterator position;
+    };
+
+    typedef std::map<std::string, Entry> container_type;
+
+    container_type entries_;
+    /// ʹеĻỰ ID, ùǰ
+    std::list<std::string> lru_;
+    size_t capacity_;
+    time_t timeout_;
+    size_t hits_;
+    size_t misses_;
+};
+
+/**
+ * TLS ú͹״̬
+ *
+ * װһ SSL_CTX, ֤˽Կ, װỰͻỰƱݵԿ, ṩ
+ * շ TLS ¼õݿ. ֻ¼ѭ߳ʹ.
+ */
+class TLSContext
+{
+public:
+    struct Options
+    {
+        Options()
+                : sessionCacheSize(20*1000)
+                , sessionTimeout(5*60)
+                , tickets(true)
+        {
+        }
+
+        /// ֤ļ( PEM ʽ, ԰֤ )
+        tstring certificate;
+        /// ˽Կļ( PEM ʽ ), Ϊʱ֤ļжȡ
+        tstring privateKey;
+        /// ļ׼( OpenSSL ʽ ), ΪʱĬֵ
+        tstring ciphers;
+        /// Ự
+        size_t sessionCacheSize;
+        /// ỰЧ(  )
+        time_t sessionTimeout;
+        /// ǷͻỰƱ
+        bool tickets;
+        /// ỰƱԿļ, ͬһļʱԻָỰ
+        tstring ticketKey;
+    };
+
+    /**
+     * @param[ in ] server ǷǷ
+     */
+    TLSContext(bool server = true);
+
+    ~TLSContext();
+
+    Options& options();
+
+    /**
+     * ô SSL_CTX
+     * @return ʧʱд־ false
+     */
+    bool initialize();
+
+    bool isInitialized() const;
+
+    bool isServer() const;
+
+    /**
+     * ǷѼ֤
+     */
+    bool hasCertificate() const;
+
+    /**
+     * һ SSL 
+     */
+    ssl_st* createSSL();
+
+    ssl_ctx_st* handle();
+
+    TLSSessionCache& sessions();
+
+    /**
+     * ӳȡһݿ, Ϊ CHUNK_SIZE,  freebuffer() ͷʱص
+     */
+    databuffer_t* allocate();
+
+    /**
+     * ¼һ
+     */
+    void handshaked(bool resumed);
+
+    size_t handshakes() const;
+
+    size_t resumed() const;
+
+    /**
+     * ȡ OpenSSL еĴ
+     */
+    static tstring lastError();
+
+    /// ܷһ TLS ¼( 16K ļͷУ )
+    enum { CHUNK_SIZE = 16*1024 + 512 };
+
+private:
+    NOCOPY(TLSContext);
+
+    bool loadTicketKey();
+
+    static int onNewSession(ssl_st* ssl, ssl_session_st* session);
+    static ssl_session_st* onGetSession(ssl_st* ssl, const unsigned char* id, int len, int* copy);
+    static void onRemoveSession(ssl_ctx_st* ctx, ssl_session_st* session);
+    static void freeChunk(buffer_chain_t* chain, void* context);
+
+    Options options_;
+    bool server_;
+    ssl_ctx_st* ctx_;
+    TLSSessionCache sessions_;
+
+    /// еݿ
+    std::vector<databuffer_t*> chunks_;
+
+    size_t handshakes_;
+    size_t resumed_;
+
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_TLSContext_H_
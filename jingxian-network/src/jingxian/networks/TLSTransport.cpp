@@ -0,0 +1,529 @@
+
+# include "pro_config.h"
+# include <openssl/ssl.h>
+# include <openssl/err.h>
+# include "jingxian/networks/TLSTransport.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// һ TLS ¼ܷŵ
+    const size_t MAX_RECORD_PLAIN = 16*1024;
+
+    /**
+     * ӹõ BIO_METHOD, Ƭ߳̿ͬʱһ TLS ,
+     * ֻеһŽȥЧ, ̴߳ͷŵ
+     */
+    BIO_METHOD* bioMethod(int (*write)(BIO*, const char*, int)
+                          , int (*read)(BIO*, char*, int)
+                          , long (*ctrl)(BIO*, int, long, void*))
+    {
+        static BIO_METHOD* volatile method = null_ptr;
+        BIO_METHOD* current = method;
+        if (!is_null(current))
+            return current;
+
+        BIO_METHOD* created = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "jingxian transport");
+        BIO_meth_set_write(created, write);
+        BIO_meth_set_read(created, read);
+        BIO_meth_set_ctrl(created, ctrl);
+
+        current = (BIO_METHOD*)::InterlockedCompareExchangePointer((PVOID volatile*)&method, created, null_ptr);
+        if (is_null(current))
+            return created;
+
+        BIO_meth_free(created);
+        return current;
+    }
+}
+
+TLSTransport::TLSTransport(IReactorCore* core
+                           , TLSContext* tls
+                           , TimerQueue* timers
+                           , ITransport* transport)
+        : core_(core)
+        , tls_(tls)
+        , timers_(timers)
+        , transport_(transport)
+        , protocol_(null_ptr)
+        , ssl_(null_ptr)
+        , input_(null_ptr)
+        , inputIndex_(0)
+        , inputOffset_(0)
+        , inputBytes_(0)
+        , plainStart_(0)
+        , charge_(MemoryKind::Receive)
+        , current_(null_ptr)
+        , isInitialize_(false)
+        , established_(false)
+        , dispatching_(false)
+        , shutdowning_(false)
+{
+    if (is_null(transport))
+        ThrowException1(ArgumentNullException, _T("transport"));
+
+    ssl_ = tls_->createSSL();
+    BIO* bio = createBIO(this);
+    SSL_set_bio(ssl_, bio, bio);
+    if (tls_->isServer())
+        SSL_set_accept_state(ssl_);
+    else
+        SSL_set_connect_state(ssl_);
+
+    flushTimer_.initialize(this);
+    toString_ = _T("TLSTransport[") + transport_->toString() + _T("]");
+}
+
+TLSTransport::~TLSTransport()
+{
+    timers_->cancel(&flushTimer_);
+
+    if (!is_null(current_))
+        freebuffer(cast_to_buffer_chain(current_));
+    for (std::vector<buffer_chain_t*>::iterator it = records_.begin(); it != records_.end(); ++ it)
+        freebuffer(*it);
+
+    SSL_free(ssl_);
+    ssl_ = null_ptr;
+}
+
+void TLSTransport::initialize()
+{
+    if (isInitialize_)
+        return;
+
+    isInitialize_ = true;
+    transport_->bindProtocol(this);
+    transport_->initialize();
+}
+
+IProtocol* TLSTransport::bindProtocol(IProtocol* protocol)
+{
+    IProtocol* old = protocol_;
+    protocol_ = protocol;
+    return old;
+}
+
+void TLSTransport::startReading()
+{
+    transport_->startReading();
+}
+
+void TLSTransport::stopReading()
+{
+    transport_->stopReading();
+}
+
+void TLSTransport::write(buffer_chain_t* buffer)
+{
+    writeBatch(&buffer, 1);
+}
+
+void TLSTransport::writeBatch(buffer_chain_t** buffers, size_t len)
+{
+    if (is_null(buffers))
+        ThrowException1(ArgumentNullException, _T("buffers"));
+
+    for (size_t i = 0; i < len; ++ i)
+    {
+        buffer_chain_t* buffer = buffers[i];
+        if (is_null(buffer))
+            ThrowException1(ArgumentNullException, _T("buffer"));
+
+        if (!isMemory(buffer))
+        {
+            freebuffer(buffer);
+            ThrowException1(IllegalArgumentException, _T("TLS ֻܷڴݿ"));
+        }
+
+        if (!shutdowning_)
+            pending_.insert(pending_.end(), rd_ptr(buffer), rd_ptr(buffer) + rd_length(buffer));
+        freebuffer(buffer);
+    }
+
+    // Ѿ¼Ĳϼ, ʣµĵȴͺдϲ
+    if (established_ && pending_.size() >= MAX_RECORD_PLAIN)
+    {
+        size_t full = pending_.size() - pending_.size() % MAX_RECORD_PLAIN;
+        encrypt(&pending_[0], full);
+        pending_.erase(pending_.begin(), pending_.begin() + full);
+    }
+
+    account();
+    scheduleFlush();
+}
+
+void TLSTransport::shapeAs(const tstring& user, bool upload)
+{
+    transport_->shapeAs(user, upload);
+}
+
+void TLSTransport::disconnection()
+{
+    disconnection(_T("ûر"));
+}
+
+void TLSTransport::disconnection(const tstring& error)
+{
+    if (shutdowning_)
+        return;
+
+    flush();
+    shutdowning_ = true;
+
+    //  close_notify, Էݴرպͱض
+    if (established_)
+        SSL_shutdown(ssl_);
+    sendRecords();
+
+    transport_->disconnection(error);
+}
+
+const tstring& TLSTransport::host() const
+{
+    return transport_->host();
+}
+
+const tstring& TLSTransport::peer() const
+{
+    return transport_->peer();
+}
+
+time_t TLSTransport::timeout() const
+{
+    return transport_->timeout();
+}
+
+const tstring& TLSTransport::toString() const
+{
+    return toString_;
+}
+
+void TLSTransport::onTimeout(ProtocolContext& context)
+{
+    if (!is_null(protocol_))
+        protocol_->onTimeout(context_);
+}
+
+void TLSTransport::onConnected(ProtocolContext& context)
+{
+    context_.initialize(core_, this);
+
+    // ͻȷ ClientHello, ˵ȶԷ
+    if (!tls_->isServer() && handshake())
+        flush();
+}
+
+void TLSTransport::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+{
+    timers_->cancel(&flushTimer_);
+
+    IProtocol* protocol = protocol_;
+    if (!is_null(protocol))
+        protocol->onDisconnected(context_, errCode, reason);
+
+    delete this;
+}
+
+size_t TLSTransport::onReceived(ProtocolContext& context)
+{
+    if (shutdowning_)
+        return context.inBytes();
+
+    dispatching_ = true;
+    input_ = &context.inMemory();
+    inputIndex_ = 0;
+    inputOffset_ = 0;
+    inputBytes_ = 0;
+
+    bool ok = true;
+    if (!established_)
+    {
+        ok = handshake();
+        if (ok && established_ && !is_null(protocol_))
+            protocol_->onConnected(context_);
+    }
+
+    if (ok && established_)
+        ok = decrypt();
+    input_ = null_ptr;
+
+    if (ok)
+        deliver();
+
+    dispatching_ = false;
+    flush();
+    account();
+
+    return ok ? inputBytes_ : context.inBytes();
+}
+
+databuffer_t* TLSTransport::createBuffer(const ProtocolContext& context)
+{
+    return tls_->allocate();
+}
+
+size_t TLSTransport::memory() const
+{
+    size_t bytes = charge_.bytes();
+    if (!is_null(protocol_))
+        bytes += protocol_->memory();
+    return bytes;
+}
+
+bool TLSTransport::isEstablished() const
+{
+    return established_;
+}
+
+bool TLSTransport::isResumed() const
+{
+    return established_ && 0 != SSL_session_reused(ssl_);
+}
+
+void TLSTransport::account()
+{
+    charge_.update(plain_.capacity() + pending_.capacity());
+}
+
+void TLSTransport::flush()
+{
+    if (flushTimer_.isScheduled())
+        timers_->cancel(&flushTimer_);
+
+    if (established_ && !shutdowning_ && !pending_.empty())
+    {
+        encrypt(&pending_[0], pending_.size());
+        pending_.clear();
+    }
+    sendRecords();
+}
+
+ssl_st* TLSTransport::handle()
+{
+    return ssl_;
+}
+
+bool TLSTransport::handshake()
+{
+    int result = SSL_do_handshake(ssl_);
+    if (1 == result)
+    {
+        established_ = true;
+        tls_->handshaked(isResumed());
+        return true;
+    }
+
+    switch (SSL_get_error(ssl_, result))
+    {
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+        return true;
+    default:
+        fail(concat<tstring>(_T("TLS ʧ - "), TLSContext::lastError()));
+        return false;
+    }
+}
+
+bool TLSTransport::decrypt()
+{
+    if (0 != plainStart_ && plainStart_ == plain_.size())
+    {
+        plain_.clear();
+        plainStart_ = 0;
+    }
+
+    for (;;)
+    {
+        size_t used = plain_.size();
+        plain_.resize(used + MAX_RECORD_PLAIN);
+        int result = SSL_read(ssl_, &plain_[used], MAX_RECORD_PLAIN);
+        if (0 < result)
+        {
+            plain_.resize(used + result);
+            continue;
+        }
+        plain_.resize(used);
+
+        switch (SSL_get_error(ssl_, result))
+        {
+        case SSL_ERROR_WANT_READ:
+        case SSL_ERROR_WANT_WRITE:
+            return true;
+        case SSL_ERROR_ZERO_RETURN:
+            // Է close_notify, Ȱѽܵݽϲ
+            deliver();
+            disconnection(_T("Էر TLS "));
+            return false;
+        default:
+            fail(concat<tstring>(_T("TLS ʧ - "), TLSContext::lastError()));
+            return false;
+        }
+    }
+}
+
+void TLSTransport::deliver()
+{
+    if (is_null(protocol_) || plainStart_ == plain_.size())
+        return;
+
+    std::vector<io_mem_buf> ioBuf(1);
+    ioBuf[0].buf = &plain_[plainStart_];
+    ioBuf[0].len = (u_long)(plain_.size() - plainStart_);
+    context_.inMemory(&ioBuf, ioBuf[0].len);
+
+    plainStart_ += protocol_->onReceived(context_);
+    if (plainStart_ == plain_.size())
+    {
+        plain_.clear();
+        plainStart_ = 0;
+    }
+    else if (plainStart_ * 2 >= plain_.size())
+    {
+        plain_.erase(plain_.begin(), plain_.begin() + plainStart_);
+        plainStart_ = 0;
+    }
+}
+
+void TLSTransport::encrypt(const char* data, size_t len)
+{
+    while (0 != len)
+    {
+        int size = (int)((len > MAX_RECORD_PLAIN) ? MAX_RECORD_PLAIN : len);
+        int result = SSL_write(ssl_, data, size);
+        if (0 >= result)
+        {
+            fail(concat<tstring>(_T("TLS ʧ - "), TLSContext::lastError()));
+            return;
+        }
+
+        data += result;
+        len -= result;
+    }
+}
+
+void TLSTransport::sendRecords()
+{
+    if (!is_null(current_))
+    {
+        if (0 == rd_length(cast_to_buffer_chain(current_)))
+            freebuffer(cast_to_buffer_chain(current_));
+        else
+            records_.push_back(cast_to_buffer_chain(current_));
+        current_ = null_ptr;
+    }
+
+    if (records_.empty())
+        return;
+
+    std::vector<buffer_chain_t*> records;
+    records.swap(records_);
+    transport_->writeBatch(&records[0], records.size());
+}
+
+void TLSTransport::fail(const tstring& reason)
+{
+    if (shutdowning_)
+        return;
+
+    //  OpenSSL ɵĸ澯ȥٶϿ
+    shutdowning_ = true;
+    pending_.clear();
+    sendRecords();
+    transport_->disconnection(reason);
+}
+
+void TLSTransport::scheduleFlush()
+{
+    if (!dispatching_ && !flushTimer_.isScheduled())
+        timers_->schedule(&flushTimer_, 0);
+}
+
+BIO* TLSTransport::createBIO(TLSTransport* owner)
+{
+    BIO* bio = BIO_new(bioMethod(&TLSTransport::bioWrite
+                                 , &TLSTransport::bioRead
+                                 , &TLSTransport::bioCtrl));
+    BIO_set_data(bio, owner);
+    BIO_set_init(bio, 1);
+    return bio;
+}
+
+int TLSTransport::bioWrite(BIO* bio, const char* data, int len)
+{
+    TLSTransport* self = (TLSTransport*)BIO_get_data(bio);
+    BIO_clear_retry_flags(bio);
+
+    int written = 0;
+    while (written < len)
+    {
+        if (is_null(self->current_))
+            self->current_ = self->tls_->allocate();
+
+        buffer_chain_t* chain = cast_to_buffer_chain(self->current_);
+        size_t size = wd_length(chain);
+        if (size > (size_t)(len - written))
+            size = len - written;
+
+        memcpy(wd_ptr(chain), data + written, size);
+        wd_ptr(chain, size);
+        written += (int)size;
+
+        if (0 == wd_length(chain))
+        {
+            self->records_.push_back(chain);
+            self->current_ = null_ptr;
+        }
+    }
+    return written;
+}
+
+int TLSTransport::bioRead(BIO* bio, char* data, int len)
+{
+    TLSTransport* self = (TLSTransport*)BIO_get_data(bio);
+    BIO_clear_retry_flags(bio);
+
+    // ֱӴ²ջĸƬж
+    int read = 0;
+    while (!is_null(self->input_)
+           && self->inputIndex_ < self->input_->size()
+           && read < len)
+    {
+        const io_mem_buf& segment = (*self->input_)[self->inputIndex_];
+        size_t size = segment.len - self->inputOffset_;
+        if (size > (size_t)(len - read))
+            size = len - read;
+
+        memcpy(data + read, segment.buf + self->inputOffset_, size);
+        read += (int)size;
+        self->inputOffset_ += size;
+        self->inputBytes_ += size;
+
+        if (self->inputOffset_ == segment.len)
+        {
+            ++ self->inputIndex_;
+            self->inputOffset_ = 0;
+        }
+    }
+
+    if (0 == read)
+    {
+        BIO_set_retry_read(bio);
+        return -1;
+    }
+    return read;
+}
+
+long TLSTransport::bioCtrl(BIO* bio, int cmd, long num, void* ptr)
+{
+    switch (cmd)
+    {
+    case BIO_CTRL_FLUSH:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+_jingxian_end
@@ -0,0 +1,238 @@
+
+#ifndef _TLSTransport_H_
+#define _TLSTransport_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/ITransport.h"
+# include "jingxian/IProtocol.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/networks/TCPContext.h"
+# include "jingxian/networks/TimerQueue.h"
+# include "jingxian/networks/TLSContext.h"
+
+struct bio_st;
+
+_jingxian_begin
+
+/**
+ * TLS , װһĵ ITransport
+ *
+ * ² ITransport ˵ IProtocol, ϲЭ˵ ITransport,
+ * κ IProtocolFactory Э鶼Բ޸ĵ TLS . 
+ * ֱӴ²Ľջн( ȸƵڴ BIO  ), ܺļ¼
+ * д TLSContext еݿٽ²㷢.
+ *
+ * ϲһ¼еĶСдȺϲ, ¼ʱ( ۻ
+ * һ¼ʱ )ż, Сֻһ TLS ¼. ²Ӷ
+ * Զɾ.
+ */
+class TLSTransport : public ITransport, public IProtocol
+{
+public:
+    /**
+     * @param[ in ] core ϲЭ IReactorCore
+     * @param[ in ] tls ѳʼ TLSContext, Ƿ˻ǿͻ
+     * @param[ in ] timers ƳٺϲдĶʱ
+     * @param[ in ] transport ²
+     */
+    TLSTransport(IReactorCore* core
+                 , TLSContext* tls
+                 , TimerQueue* timers
+                 , ITransport* transport);
+
+    virtual ~TLSTransport();
+
+    /**
+     * @implements initialize
+     */
+    virtual void initialize();
+
+    /**
+     * @implements bindProtocol
+     */
+    virtual IProtocol* bindProtocol(IProtocol* protocol);
+
+    /**
+     * @implements startReading
+     */
+    virtual void startReading();
+
+    /**
+     * @implements stopReading
+     */
+    virtual void stopReading();
+
+    /**
+     * @implements write
+     */
+    virtual void write(buffer_chain_t* buffer);
+    virtual void writeBatch(buffer_chain_t** buffers, size_t len);
+
+    /**
+     * @implements shapeAs
+     */
+    virtual void shapeAs(const tstring& user, bool upload);
+
+    /**
+     * @implements disconnection
+     */
+    virtual void disconnection();
+    virtual void disconnection(const tstring& error);
+
+    /**
+     * @implements host
+     */
+    virtual const tstring& host() const;
+
+    /**
+     * @implements peer
+     */
+    virtual const tstring& peer() const;
+
+    /**
+     * @implements timeout
+     */
+    virtual time_t timeout() const;
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+    /**
+     * @implements onTimeout
+     */
+    virtual void onTimeout(ProtocolContext& context);
+
+    /**
+     * @implements onConnected
+     */
+    virtual void onConnected(ProtocolContext& context);
+
+    /**
+     * @implements onDisconnected
+     */
+    virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason);
+
+    /**
+     * @implements onReceived
+     */
+    virtual size_t onReceived(ProtocolContext& context);
+
+    /**
+     * @implements createBuffer
+     */
+    virtual databuffer_t* createBuffer(const ProtocolContext& context);
+
+    /**
+     * @implements memory
+     */
+    virtual size_t memory() const;
+
+    /**
+     * Ƿ
+     */
+    bool isEstablished() const;
+
+    /**
+     * ǷǻָĻỰ(  )
+     */
+    bool isResumed() const;
+
+    /**
+     * ϼܲͺϲе
+     */
+    void flush();
+
+    ssl_st* handle();
+
+private:
+    NOCOPY(TLSTransport);
+
+    /**
+     * ¼֮дڱ¼ѭʱżܷ
+     */
+    class FlushTimer : public Timer
+    {
+    public:
+        FlushTimer()
+                : owner_(null_ptr)
+        {
+        }
+
+        void initialize(TLSTransport* owner)
+        {
+            owner_ = owner;
+        }
+
+        virtual void onTimeout()
+        {
+            owner_->flush();
+        }
+
+    private:
+        TLSTransport* owner_;
+    };
+
+    bool handshake();
+    bool decrypt();
+    void deliver();
+    void encrypt(const char* data, size_t len);
+    void sendRecords();
+    void fail(const tstring& reason);
+    void scheduleFlush();
+    void account();
+
+    static bio_st* createBIO(TLSTransport* owner);
+    static int bioWrite(bio_st* bio, const char* data, int len);
+    static int bioRead(bio_st* bio, char* data, int len);
+    static long bioCtrl(bio_st* bio, int cmd, long num, void* ptr);
+
+    IReactorCore* core_;
+    TLSContext* tls_;
+    TimerQueue* timers_;
+    ITransport* transport_;
+    IProtocol* protocol_;
+    ssl_st* ssl_;
+
+    /// ϲЭ
+    TCPContext context_;
+
+    /// ڽܵ², ֻ onReceived() Ч
+    const std::vector<io_mem_buf>* input_;
+    size_t inputIndex_;
+    size_t inputOffset_;
+    size_t inputBytes_;
+
+    /// ܺûбϲȡߵ
+    std::vector<char> plain_;
+    size_t plainStart_;
+
+    /// ȴϲܵ
+    std::vector<char> pending_;
+    /// plain_  pending_ ռõڴ
+    MemoryCharge charge_;
+    /// дݿдݿ
+    databuffer_t* current_;
+    std::vector<buffer_chain_t*> records_;
+    FlushTimer flushTimer_;
+
+    bool isInitialize_;
+    bool established_;
+    /// ڴ²¼, ڼдڴʱһ
+    bool dispatching_;
+    bool shutdowning_;
+
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_TLSTransport_H_
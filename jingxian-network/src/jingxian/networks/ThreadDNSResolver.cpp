@@ -4,6 +4,7 @@
 # include <Ws2tcpip.h>
 # include "jingxian/networks/ThreadDNSResolver.h"
 # include "jingxian/IReactorCore.h"
+# include "jingxian/buffer/MemoryAccount.h"
 # include "jingxian/threading/thread.h"
 
 _jingxian_begin
@@ -65,11 +66,25 @@ public:
             , name_(name)
             , port_(port)
             , onComplete_(onComplete)
+            , charged_(0)
     {
     }
 
     virtual ~ResolveCompleteTask()
     {
+        MemoryAccount::credit(MemoryKind::DNS, charged_);
+    }
+
+    /**
+     * ú, ִɾʱ۳
+     */
+    void charge()
+    {
+        charged_ = sizeof(*this)
+                   + hostEntry_.AddressList.size() * sizeof(HostAddress)
+                   + hostEntry_.Aliases.size() * sizeof(tstring)
+                   + (name_.size() + port_.size()) * sizeof(tchar);
+        MemoryAccount::charge(MemoryKind::DNS, charged_);
     }
 
     virtual void run()
@@ -87,6 +102,7 @@ private:
     tstring port_;
     IPHostEntry hostEntry_;
     ResolveComplete onComplete_;
+    size_t charged_;
 };
 
 void dnsQuery(const tstring& name
@@ -143,6 +159,7 @@ void dnsQuery(const tstring& name
 #else
     freeaddrinfo(res);
 #endif
+    ptr->charge();
     if (core->send(ptr.get()))
         ptr.release();
     else
@@ -0,0 +1,86 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/TimerQueue.h"
+
+_jingxian_begin
+
+TimerQueue::TimerQueue()
+        : lastTick_(::GetTickCount())
+        , epoch_(0)
+{
+}
+
+TimerQueue::~TimerQueue()
+{
+    for (container_type::iterator it = timers_.begin(); it != timers_.end(); ++ it)
+        it->second->scheduled_ = false;
+    timers_.clear();
+}
+
+uint64_t TimerQueue::now()
+{
+    DWORD tick = ::GetTickCount();
+    if (tick < lastTick_)
+        ++ epoch_;
+    lastTick_ = tick;
+    return (epoch_ << 32) | tick;
+}
+
+void TimerQueue::schedule(Timer* timer, uint32_t milliseconds)
+{
+    cancel(timer);
+
+    timer->position_ = timers_.insert(std::make_pair(now() + milliseconds, timer));
+    timer->scheduled_ = true;
+}
+
+void TimerQueue::cancel(Timer* timer)
+{
+    if (!timer->scheduled_)
+        return;
+
+    timers_.erase(timer->position_);
+    timer->scheduled_ = false;
+}
+
+uint32_t TimerQueue::timeout(uint32_t limit)
+{
+    if (timers_.empty())
+        return limit;
+
+    uint64_t current = now();
+    uint64_t due = timers_.begin()->first;
+    if (due <= current)
+        return 0;
+
+    return (due - current < limit) ? (uint32_t)(due - current) : limit;
+}
+
+size_t TimerQueue::runExpired()
+{
+    if (timers_.empty())
+        return 0;
+
+    // onTimeout() пܻ¼ȡʱ, ÿζͷȡ, ִ
+    // ʼʱĸ,  0 Ķʱһֱѭ
+    uint64_t current = now();
+    size_t limit = timers_.size();
+    size_t count = 0;
+    while (count < limit && !timers_.empty() && timers_.begin()->first <= current)
+    {
+        Timer* timer = timers_.begin()->second;
+        timers_.erase(timers_.begin());
+        timer->scheduled_ = false;
+
+        timer->onTimeout();
+        ++ count;
+    }
+    return count;
+}
+
+size_t TimerQueue::size() const
+{
+    return timers_.size();
+}
+
+_jingxian_end
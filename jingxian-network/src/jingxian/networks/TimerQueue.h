@@ -0,0 +1,111 @@
+
+#ifndef _TimerQueue_H_
+#define _TimerQueue_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <map>
+
+_jingxian_begin
+
+/**
+ * ʱ, ʱ¼ѭ߳е onTimeout()
+ *
+ * ʱʹ߳, ǰȴ TimerQueue ȡ.
+ */
+class Timer
+{
+public:
+    Timer()
+            : scheduled_(false)
+    {
+    }
+
+    virtual ~Timer()
+    {
+    }
+
+    /**
+     * ʱ
+     */
+    virtual void onTimeout() = 0;
+
+    /**
+     * ǲڵȴ
+     */
+    bool isScheduled() const
+    {
+        return scheduled_;
+    }
+
+private:
+    NOCOPY(Timer);
+    friend class TimerQueue;
+
+    bool scheduled_;
+    std::multimap<uint64_t, Timer*>::iterator position_;
+};
+
+/**
+ * ¼ѭ߳еĶʱ, ֻ¼ѭ߳ʹ
+ *
+ * ¼ѭ timeout() Ƶȴɶ˿ڵʱ, ÿηغ runExpired().
+ */
+class TimerQueue
+{
+public:
+    TimerQueue();
+
+    ~TimerQueue();
+
+    /**
+     * ĺ( GetTickCount ƺ )
+     */
+    uint64_t now();
+
+    /**
+     *  milliseconds  timer  onTimeout(), ڵȴʱ¼ʱ
+     */
+    void schedule(Timer* timer, uint32_t milliseconds);
+
+    /**
+     * ȡʱ, ûڵȴʱʲôҲ
+     */
+    void cancel(Timer* timer);
+
+    /**
+     * һʱǰĺ, ᳬ limit
+     */
+    uint32_t timeout(uint32_t limit);
+
+    /**
+     * ִѵڵĶʱ
+     * @return ִеĶʱ
+     */
+    size_t runExpired();
+
+    /**
+     * ڵȴĶʱ
+     */
+    size_t size() const;
+
+private:
+    NOCOPY(TimerQueue);
+
+    typedef std::multimap<uint64_t, Timer*> container_type;
+
+    container_type timers_;
+    /// ϴȡ GetTickCount() ֵ, ڼ
+    DWORD lastTick_;
+    /// ѻƵĴ
+    uint64_t epoch_;
+};
+
+_jingxian_end
+
+#endif //_TimerQueue_H_
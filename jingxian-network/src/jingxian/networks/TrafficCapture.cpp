@@ -0,0 +1,395 @@
+
+# include "pro_config.h"
+# include <algorithm>
+# include "jingxian/lastError.h"
+# include "jingxian/networks/TrafficCapture.h"
+# include "jingxian/threading/thread.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ץʱ̨߳дļļ
+    const DWORD FLUSH_INTERVAL = 100;
+
+    tstring toggleName(DWORD pid)
+    {
+        return concat<tstring>(_T("jingxian.capture."), ::toString((int)pid), _T(".toggle"));
+    }
+
+    int portOf(const tstring& address)
+    {
+        tstring::size_type index = address.find_last_of(_T(':'));
+        if (tstring::npos == index)
+            return 0;
+        return string_traits<tstring::value_type>::atoi(address.c_str() + index + 1);
+    }
+
+    uint64_t now()
+    {
+        // FILETIME Ǵ 1601-01-01 ʼ 100 
+        FILETIME ft;
+        ::GetSystemTimeAsFileTime(&ft);
+        uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+        return (t - 116444736000000000ULL) / 10;
+    }
+}
+
+/**
+ * һ̵߳Ļλ, ֻһ( ߳ )һ( ̨߳ ).
+ * дһ¼ƶ head_,  [tail_, head_) ֮ļ¼,
+ * ʽļеһ, ֱдļ.
+ */
+class TrafficCapture::Ring
+{
+public:
+    Ring(size_t capacity)
+            : buffer_(new char[capacity])
+            , mask_(capacity - 1)
+            , head_(0)
+            , tail_(0)
+    {
+    }
+
+    ~Ring()
+    {
+        delete[] buffer_;
+    }
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    /**
+     * дһ¼, ռ䲻ʱ false
+     */
+    bool write(const CaptureRecord& header, const io_mem_buf* buffers, size_t count)
+    {
+        size_t total = sizeof(CaptureRecord) + header.length;
+        LONG head = head_;
+        if (capacity() - (ULONG)(head - tail_) < total)
+            return false;
+
+        size_t position = put((ULONG)head, &header, sizeof(CaptureRecord));
+        size_t remain = header.length;
+        for (size_t i = 0; i < count && 0 < remain; ++ i)
+        {
+            size_t len = (buffers[i].len < remain) ? buffers[i].len : remain;
+            position = put(position, buffers[i].buf, len);
+            remain -= len;
+        }
+
+        ::InterlockedExchange(&head_, head + (LONG)total);
+        return true;
+    }
+
+    /**
+     * ȡɵļ¼д out , out Ϊ null_ptr ʱ
+     * @return ȡֽ
+     */
+    size_t read(std::ostream* out)
+    {
+        LONG tail = tail_;
+        LONG head = head_;
+        size_t len = (ULONG)(head - tail);
+        if (0 == len)
+            return 0;
+
+        if (!is_null(out))
+        {
+            size_t offset = (ULONG)tail & mask_;
+            size_t first = (len < capacity() - offset) ? len : capacity() - offset;
+            out->write(buffer_ + offset, (std::streamsize)first);
+            if (first < len)
+                out->write(buffer_, (std::streamsize)(len - first));
+        }
+
+        ::InterlockedExchange(&tail_, head);
+        return len;
+    }
+
+private:
+    NOCOPY(Ring);
+
+    size_t put(size_t position, const void* data, size_t len)
+    {
+        size_t offset = position & mask_;
+        size_t first = (len < capacity() - offset) ? len : capacity() - offset;
+        memcpy(buffer_ + offset, data, first);
+        memcpy(buffer_, (const char*)data + first, len - first);
+        return position + len;
+    }
+
+    char* buffer_;
+    size_t mask_;
+    volatile LONG head_;
+    volatile LONG tail_;
+};
+
+TrafficCapture::TrafficCapture()
+        : tlsIndex_(::TlsAlloc())
+        , toggleEvent_(NULL)
+        , stopping_(0)
+        , capturing_(0)
+        , session_(0)
+        , connections_(0)
+        , admitted_(0)
+        , firstAdmitted_(0)
+        , dropped_(0)
+        , written_(0)
+        , logger_(_T("jingxian.capture"))
+{
+    if (TLS_OUT_OF_INDEXES == tlsIndex_)
+        ThrowException1(RuntimeException, _T("ֲ߳̾洢ʧ"));
+}
+
+TrafficCapture::~TrafficCapture()
+{
+    stop();
+
+    for (std::vector<Ring*>::iterator it = rings_.begin(); it != rings_.end(); ++ it)
+        delete *it;
+    rings_.clear();
+
+    ::TlsFree(tlsIndex_);
+}
+
+bool TrafficCapture::start(const Options& options)
+{
+    if (NULL != toggleEvent_)
+    {
+        LOG_WARN(logger_ , _T("!"));
+        return false;
+    }
+
+    options_ = options;
+    if (0 == options_.sampling)
+        options_.sampling = 1;
+
+    size_t ringSize = 4096;
+    while (ringSize < options_.ringSize)
+        ringSize <<= 1;
+    options_.ringSize = ringSize;
+
+    stopping_ = 0;
+    toggleEvent_ = ::CreateEvent(NULL, FALSE, FALSE, toggleName(::GetCurrentProcessId()).c_str());
+    if (NULL == toggleEvent_)
+    {
+        LOG_ERROR(logger_ , _T("ץл¼ʧ - ") << lastError(::GetLastError()));
+        return false;
+    }
+
+    exited_.reset(new semaphore(0, 1));
+    try
+    {
+        create_thread(&TrafficCapture::writerMain, this, _T("capture"));
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR(logger_ , _T("ץ߳ʧ - ") << e.what());
+        ::CloseHandle(toggleEvent_);
+        toggleEvent_ = NULL;
+        return false;
+    }
+
+    LOG_INFO(logger_ , _T("ץ߳,  '") << options_.path << _T("'"));
+    return true;
+}
+
+void TrafficCapture::stop()
+{
+    if (NULL == toggleEvent_)
+        return;
+
+    ::InterlockedExchange(&stopping_, 1);
+    ::SetEvent(toggleEvent_);
+    exited_->acquire();
+
+    ::CloseHandle(toggleEvent_);
+    toggleEvent_ = NULL;
+}
+
+void TrafficCapture::toggle()
+{
+    if (NULL != toggleEvent_)
+        ::SetEvent(toggleEvent_);
+}
+
+bool TrafficCapture::toggle(DWORD pid)
+{
+    HANDLE event = ::OpenEvent(EVENT_MODIFY_STATE, FALSE, toggleName(pid).c_str());
+    if (NULL == event)
+        return false;
+
+    BOOL result = ::SetEvent(event);
+    ::CloseHandle(event);
+    return FALSE != result;
+}
+
+uint32_t TrafficCapture::admit(const tstring& host, const tstring& peer)
+{
+    if (!isCapturing())
+        return 0;
+
+    if (!options_.ports.empty()
+            && options_.ports.end() == std::find(options_.ports.begin(), options_.ports.end(), portOf(host))
+            && options_.ports.end() == std::find(options_.ports.begin(), options_.ports.end(), portOf(peer)))
+        return 0;
+
+    if (0 != (ULONG)(::InterlockedIncrement(&connections_) - 1) % options_.sampling)
+        return 0;
+
+    // ڶץ֮һֱ, ϴץʱֵŵεļ
+    // Ҳظ. 0 ʾץ, ʱ
+    uint32_t connection = (uint32_t)::InterlockedIncrement(&admitted_);
+    if (0 == connection)
+        connection = (uint32_t)::InterlockedIncrement(&admitted_);
+
+    std::string text = toNarrowString(concat<tstring>(host, _T(" "), peer));
+    io_mem_buf buffer;
+    buffer.buf = (char*)text.c_str();
+    buffer.len = (ULONG)text.size();
+    append(connection, capture_record::Open, &buffer, 1, text.size());
+    return connection;
+}
+
+void TrafficCapture::record(uint32_t connection
+                            , capture_record::type type
+                            , const std::vector<io_mem_buf>& buffers
+                            , size_t bytes)
+{
+    if (!isCapturing() || 0 == connection || buffers.empty() || 0 == bytes)
+        return;
+
+    append(connection, type, &buffers[0], buffers.size(), bytes);
+}
+
+TrafficCapture::Ring* TrafficCapture::ring()
+{
+    Ring* ring = (Ring*)::TlsGetValue(tlsIndex_);
+    if (!is_null(ring))
+        return ring;
+
+    // ÿ̵߳һμ¼ʱŷ
+    ring = new Ring(options_.ringSize);
+    {
+        mutex::spcode_lock lock(lock_);
+        rings_.push_back(ring);
+    }
+    ::TlsSetValue(tlsIndex_, ring);
+    return ring;
+}
+
+bool TrafficCapture::append(uint32_t connection
+                            , capture_record::type type
+                            , const io_mem_buf* buffers
+                            , size_t count
+                            , size_t bytes)
+{
+    Ring* buffer = ring();
+
+    CaptureRecord header;
+    header.timestamp = now();
+    header.connection = connection;
+    header.type = (uint8_t)type;
+    memset(header.reserved, 0, sizeof(header.reserved));
+
+    // ȻֻǰĲ
+    size_t limit = buffer->capacity() - sizeof(CaptureRecord);
+    header.length = (uint32_t)((bytes < limit) ? bytes : limit);
+
+    if (buffer->write(header, buffers, count))
+        return true;
+
+    ::InterlockedIncrement(&dropped_);
+    return false;
+}
+
+void TrafficCapture::writerMain(TrafficCapture* capture)
+{
+    capture->run();
+    capture->exited_->release();
+}
+
+void TrafficCapture::run()
+{
+    while (0 == stopping_)
+    {
+        DWORD result = ::WaitForSingleObject(toggleEvent_, (0 == capturing_) ? INFINITE : FLUSH_INTERVAL);
+        if (0 != stopping_)
+            break;
+
+        if (WAIT_OBJECT_0 == result)
+        {
+            if (0 == capturing_)
+                open();
+            else
+                close();
+            continue;
+        }
+
+        if (WAIT_TIMEOUT != result)
+        {
+            LOG_ERROR(logger_ , _T("ȴץл¼ʧ - ") << lastError(::GetLastError()));
+            break;
+        }
+
+        drain(false);
+        if (options_.budget <= written_)
+        {
+            LOG_WARN(logger_ , _T("д ") << options_.budget << _T(" ֽڵԤ, ֹͣץ"));
+            close();
+        }
+    }
+
+    if (0 != capturing_)
+        close();
+}
+
+bool TrafficCapture::open()
+{
+    // ϴֹͣдļ¼һ
+    drain(true);
+
+    file_.open(toNarrowString(options_.path).c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file_.is_open())
+    {
+        LOG_ERROR(logger_ , _T("ץļ '") << options_.path << _T("' ʧ"));
+        file_.clear();
+        return false;
+    }
+
+    file_.write(CAPTURE_FILE_MAGIC, sizeof(CAPTURE_FILE_MAGIC));
+    written_ = sizeof(CAPTURE_FILE_MAGIC);
+    connections_ = 0;
+    firstAdmitted_ = admitted_;
+    dropped_ = 0;
+
+    ::InterlockedIncrement(&session_);
+    ::InterlockedExchange(&capturing_, 1);
+    LOG_INFO(logger_ , _T("ʼץ"));
+    return true;
+}
+
+void TrafficCapture::drain(bool discard)
+{
+    mutex::spcode_lock lock(lock_);
+    for (std::vector<Ring*>::iterator it = rings_.begin(); it != rings_.end(); ++ it)
+        written_ += (*it)->read(discard ? null_ptr : &file_);
+
+    if (!discard)
+        file_.flush();
+}
+
+void TrafficCapture::close()
+{
+    ::InterlockedExchange(&capturing_, 0);
+    drain(false);
+    file_.close();
+
+    LOG_INFO(logger_ , _T("ץ, ץ ") << (uint32_t)(admitted_ - firstAdmitted_) << _T(" , д ")
+             << written_ << _T(" ֽ, ʱ ") << dropped_ << _T(" "));
+}
+
+_jingxian_end
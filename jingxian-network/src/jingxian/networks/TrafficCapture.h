@@ -0,0 +1,204 @@
+
+#ifndef _TrafficCapture_H_
+#define _TrafficCapture_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include <fstream>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/ITransport.h"
+# include "jingxian/threading/mutex.h"
+# include "jingxian/threading/semaphore.h"
+# include "jingxian/networks/networking.h"
+
+_jingxian_begin
+
+/// лץķ,  "sc control jingxian 129"
+const DWORD CAPTURE_TOGGLE_CONTROL = 129;
+
+/**
+ * ץļеļ¼
+ */
+namespace capture_record
+{
+    enum type
+    {
+        /// ʼ¼һ, Ϊ "صַ Զ̵ַ"
+        Open = 0,
+        /// յ
+        Receive = 1,
+        /// 
+        Send = 2
+    };
+}
+
+/**
+ * ץļÿ¼ͷ,  length ֽڵ( Сֽ )
+ *
+ * ļ 8 ֽڵ CAPTURE_FILE_MAGIC ͷ, Ȼһһļ¼.
+ */
+#pragma pack(push, 1)
+struct CaptureRecord
+{
+    ///  1970-01-01 ʼ΢
+    uint64_t timestamp;
+    /// ӵı, ڽΨһ
+    uint32_t connection;
+    /// capture_record::type
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t length;
+};
+#pragma pack(pop)
+
+/// ץļļͷ
+const char CAPTURE_FILE_MAGIC[8] = { 'j', 'x', 'c', 'a', 'p', '0', '0', '1' };
+
+/**
+ * пԴ򿪺͹رյץ
+ *
+ * ¼ѭ̰߳շͬʱӱŸƵ̵߳Ļλ,
+ * ʱһβ, Ӳ. ̶̨߳ʱлеļ¼
+ * дļ. ֻץָ˿ڵ, ÿ N ץһ, дֽԤ
+ * Զֹͣ.
+ *
+ * ץһ̺¼л, Կд̴򿪻ر,
+ *  toggle(DWORD pid). 򿪺еһշʱҲᱻ.
+ */
+class TrafficCapture
+{
+public:
+    struct Options
+    {
+        Options()
+                : sampling(1)
+                , budget(64*1024*1024)
+                , ringSize(1024*1024)
+        {
+        }
+
+        /// ֻץػԶ̶˿е, Ϊʱץе
+        std::vector<int> ports;
+        /// ÿ sampling ץһ
+        size_t sampling;
+        /// ÿץдֽ, ˺Զֹͣ( ɺ̨̼߳, ܻ
+        /// д뻺е )
+        uint64_t budget;
+        /// ÿ̵߳ĻλС, ȡΪ 2 
+        size_t ringSize;
+        /// ץļ, ÿοʼʱ
+        tstring path;
+    };
+
+    TrafficCapture();
+
+    ~TrafficCapture();
+
+    /**
+     * ̨߳, 󲢲ץ,  toggle() ſʼ
+     */
+    bool start(const Options& options);
+
+    /**
+     * ֹ̨ͣ߳, ץʱдеļ¼
+     */
+    void stop();
+
+    /**
+     * ʼץ( ߳е )
+     */
+    void toggle();
+
+    /**
+     * ʼһеץ
+     * @param[ in ] pid Ŀ̺
+     */
+    static bool toggle(DWORD pid);
+
+    /**
+     * ǲץ, շʱж, ץʱû
+     */
+    bool isCapturing() const
+    {
+        return 0 != capturing_;
+    }
+
+    /**
+     * ץ, ÿοʼץʱһ, жǷҪ admit()
+     */
+    LONG session() const
+    {
+        return session_;
+    }
+
+    /**
+     * Ƿץӵ
+     * @param[ in ] host صַ
+     * @param[ in ] peer Զ̵ַ
+     * @return ӱ, Ϊ 0 ʱʾץ
+     */
+    uint32_t admit(const tstring& host, const tstring& peer);
+
+    /**
+     * ¼һշ
+     * @param[ in ] connection admit() صı
+     * @param[ in ] type ¼
+     * @param[ in ] buffers ڵĻ
+     * @param[ in ] bytes ʵʵݳ, Сڻܳ
+     */
+    void record(uint32_t connection
+                , capture_record::type type
+                , const std::vector<io_mem_buf>& buffers
+                , size_t bytes);
+
+private:
+    NOCOPY(TrafficCapture);
+
+    class Ring;
+
+    Ring* ring();
+    bool append(uint32_t connection
+                , capture_record::type type
+                , const io_mem_buf* buffers
+                , size_t count
+                , size_t bytes);
+
+    static void writerMain(TrafficCapture* capture);
+    void run();
+    bool open();
+    void drain(bool discard);
+    void close();
+
+    Options options_;
+    DWORD tlsIndex_;
+    mutex lock_;
+    std::vector<Ring*> rings_;
+
+    HANDLE toggleEvent_;
+    volatile LONG stopping_;
+    volatile LONG capturing_;
+    volatile LONG session_;
+    volatile LONG connections_;
+    /// ֳȥһӱ, ץ
+    volatile LONG admitted_;
+    /// ץʼʱ admitted_
+    LONG firstAdmitted_;
+    volatile LONG dropped_;
+    /// ץдֽ, ֻں̨߳ʹ
+    uint64_t written_;
+
+    std::ofstream file_;
+    std::auto_ptr<semaphore> exited_;
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_TrafficCapture_H_
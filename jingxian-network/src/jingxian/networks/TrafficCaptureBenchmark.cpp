@@ -0,0 +1,230 @@
+
+# include "pro_config.h"
+# include <fstream>
+# include "jingxian/directory.h"
+# include "jingxian/networks/TrafficCapture.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    tstring capturePath()
+    {
+        return simplify(combinePath(getApplicationDirectory(), _T("capture_test.jxcap")));
+    }
+
+    /**
+     * toggle() ɺ̴̨߳, лָ״̬
+     */
+    bool waitFor(TrafficCapture& capture, bool capturing)
+    {
+        for (int i = 0; i < 500; ++ i)
+        {
+            if (capturing == capture.isCapturing())
+                return true;
+            ::Sleep(10);
+        }
+        return false;
+    }
+
+    std::vector<io_mem_buf> makeIovec(char* data, size_t len, size_t parts)
+    {
+        std::vector<io_mem_buf> iovec;
+        size_t step = (len + parts - 1) / parts;
+        for (size_t offset = 0; offset < len; offset += step)
+        {
+            io_mem_buf buf;
+            buf.buf = data + offset;
+            buf.len = (ULONG)((len - offset < step) ? len - offset : step);
+            iovec.push_back(buf);
+        }
+        return iovec;
+    }
+
+    bool readRecord(std::ifstream& in, CaptureRecord& header, std::string& data)
+    {
+        if (!in.read((char*)&header, sizeof(header)))
+            return false;
+        data.resize(header.length);
+        return 0 == header.length || in.read(&data[0], header.length);
+    }
+}
+
+TEST(capture, roundTrip)
+{
+    TrafficCapture::Options options;
+    options.ports.push_back(80);
+    options.path = capturePath();
+
+    TrafficCapture capture;
+    ASSERT_TRUE(capture.start(options));
+    ASSERT_FALSE(capture.isCapturing());
+    ASSERT_TRUE(0 == capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5000")));
+
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, true));
+
+    uint32_t connection = capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5000"));
+    ASSERT_TRUE(0 != connection);
+    ASSERT_TRUE(0 == capture.admit(_T("tcp://127.0.0.1:81"), _T("tcp://10.0.0.1:5001")));
+
+    // ʵյݳ, ֻ¼յĲ
+    char received[] = "hello world";
+    capture.record(connection, capture_record::Receive, makeIovec(received, sizeof(received) - 1, 3), 5);
+    char sent[] = "bye";
+    capture.record(connection, capture_record::Send, makeIovec(sent, sizeof(sent) - 1, 1), 3);
+
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, false));
+    capture.stop();
+
+    // ֹͣݲټ¼
+    capture.record(connection, capture_record::Send, makeIovec(sent, sizeof(sent) - 1, 1), 3);
+
+    std::ifstream in(toNarrowString(options.path).c_str(), std::ios::in | std::ios::binary);
+    char magic[sizeof(CAPTURE_FILE_MAGIC)];
+    ASSERT_TRUE(in.read(magic, sizeof(magic)));
+    ASSERT_TRUE(0 == memcmp(magic, CAPTURE_FILE_MAGIC, sizeof(magic)));
+
+    CaptureRecord header;
+    std::string data;
+    ASSERT_TRUE(readRecord(in, header, data));
+    ASSERT_TRUE(capture_record::Open == header.type);
+    ASSERT_TRUE(connection == header.connection);
+    ASSERT_TRUE("tcp://127.0.0.1:80 tcp://10.0.0.1:5000" == data);
+
+    ASSERT_TRUE(readRecord(in, header, data));
+    ASSERT_TRUE(capture_record::Receive == header.type);
+    ASSERT_TRUE("hello" == data);
+
+    uint64_t timestamp = header.timestamp;
+    ASSERT_TRUE(readRecord(in, header, data));
+    ASSERT_TRUE(capture_record::Send == header.type);
+    ASSERT_TRUE("bye" == data);
+    ASSERT_TRUE(timestamp <= header.timestamp);
+
+    ASSERT_FALSE(readRecord(in, header, data));
+}
+
+TEST(capture, sampling)
+{
+    TrafficCapture::Options options;
+    options.sampling = 3;
+    options.path = capturePath();
+
+    TrafficCapture capture;
+    ASSERT_TRUE(capture.start(options));
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, true));
+
+    size_t admitted = 0;
+    for (int i = 0; i < 9; ++ i)
+    {
+        if (0 != capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5000")))
+            ++ admitted;
+    }
+    ASSERT_TRUE(3 == admitted);
+}
+
+TEST(capture, idsAcrossSessions)
+{
+    TrafficCapture::Options options;
+    options.path = capturePath();
+
+    TrafficCapture capture;
+    ASSERT_TRUE(capture.start(options));
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, true));
+    uint32_t first = capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5000"));
+    ASSERT_TRUE(0 != first);
+
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, false));
+    capture.toggle();
+    ASSERT_TRUE(waitFor(capture, true));
+
+    // ϴץʱֵŵӻþɱ, Ӳظ
+    uint32_t second = capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5001"));
+    ASSERT_TRUE(0 != second);
+    ASSERT_TRUE(first != second);
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(capture_idle)
+{
+    TrafficCapture capture;
+    char data[1460] = {0};
+    std::vector<io_mem_buf> iovec = makeIovec(data, sizeof(data), 1);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        if (capture.isCapturing())
+            capture.record(1, capture_record::Receive, iovec, sizeof(data));
+    }
+}
+
+BENCHMARK(capture_record)
+{
+    TrafficCapture::Options options;
+    options.ringSize = 16*1024*1024;
+    options.path = capturePath();
+
+    TrafficCapture capture;
+    capture.start(options);
+    capture.toggle();
+    waitFor(capture, true);
+
+    uint32_t connection = capture.admit(_T("tcp://127.0.0.1:80"), _T("tcp://10.0.0.1:5000"));
+    char data[1460] = {0};
+    std::vector<io_mem_buf> iovec = makeIovec(data, sizeof(data), 1);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        capture.record(connection, capture_record::Receive, iovec, sizeof(data));
+
+    state.pauseTiming();
+    capture.stop();
+    state.resumeTiming();
+}
+
+// ԭ DUMPFILE , ֽڸʽдıļ
+BENCHMARK(capture_text_dump)
+{
+    std::ofstream os(toNarrowString(capturePath()).c_str());
+    char data[1460];
+    for (size_t i = 0; i < sizeof(data); ++ i)
+        data[i] = (char)i;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        for (size_t j = 0; j < sizeof(data); ++ j)
+        {
+            if ((unsigned)(data[j] + 1) > 256)
+                os << "<" << (int)data[j] << ">";
+            else if (::isalpha(data[j]))
+                os << data[j];
+            else if (::isdigit(data[j]))
+                os << data[j];
+            else if ('\r' == data[j])
+                os << "<\\r>";
+            else if ('\n' == data[j])
+                os << "<\\n>" << std::endl;
+            else if ('\t' == data[j])
+                os << "\t<\\t>";
+            else if (::isprint(data[j]))
+                os << "<" << (int)data[j] << ":" << data[j] << ">";
+            else
+                os << "<" << (int)data[j] << ">";
+        }
+        os.flush();
+    }
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -0,0 +1,129 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/TrafficShaper.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ٿԻֽܵ
+    const uint32_t MIN_BURST = 16*1024;
+}
+
+TrafficShaper::TrafficShaper()
+        : primary_(null_ptr)
+{
+}
+
+uint32_t TrafficShaper::burstOf(uint32_t rate)
+{
+    return (rate < MIN_BURST) ? MIN_BURST : rate;
+}
+
+void TrafficShaper::resetBuckets(Buckets& buckets, uint32_t first, uint32_t second)
+{
+    buckets.first.share(&lock_);
+    buckets.first.reset(first, burstOf(first));
+    buckets.second.share(&lock_);
+    buckets.second.reset(second, burstOf(second));
+}
+
+void TrafficShaper::connectionRate(uint32_t receive, uint32_t send)
+{
+    connection_.first = receive;
+    connection_.second = send;
+}
+
+void TrafficShaper::listenerRate(const tstring& address, uint32_t receive, uint32_t send)
+{
+    mutex::spcode_lock lock(lock_);
+    resetBuckets(listeners_[address], receive, send);
+}
+
+void TrafficShaper::userRate(const tstring& name, uint32_t upload, uint32_t download)
+{
+    mutex::spcode_lock lock(lock_);
+
+    Rate& rate = userRates_[name];
+    rate.first = upload;
+    rate.second = download;
+
+    // ѾʹõͰΪµ
+    if (_T("*") == name)
+    {
+        for (std::map<tstring, Buckets>::iterator it = users_.begin(); it != users_.end(); ++ it)
+        {
+            if (userRates_.end() != userRates_.find(it->first))
+                continue;
+            resetBuckets(it->second, upload, download);
+        }
+        return;
+    }
+
+    std::map<tstring, Buckets>::iterator it = users_.find(name);
+    if (users_.end() == it)
+        return;
+    resetBuckets(it->second, upload, download);
+}
+
+void TrafficShaper::share(TrafficShaper* primary)
+{
+    primary_ = primary;
+    connection_ = primary->connection_;
+}
+
+void TrafficShaper::initialize(Throttle& receive, Throttle& send)
+{
+    receive.own().reset(connection_.first, burstOf(connection_.first));
+    send.own().reset(connection_.second, burstOf(connection_.second));
+}
+
+void TrafficShaper::attachListener(Throttle& receive, Throttle& send, const tstring& address)
+{
+    if (!is_null(primary_))
+    {
+        primary_->attachListener(receive, send, address);
+        return;
+    }
+
+    mutex::spcode_lock lock(lock_);
+
+    std::map<tstring, Buckets>::iterator it = listeners_.find(address);
+    if (listeners_.end() == it)
+        return;
+
+    if (it->second.first.isLimited())
+        receive.attach(&(it->second.first));
+    if (it->second.second.isLimited())
+        send.attach(&(it->second.second));
+}
+
+TokenBucket* TrafficShaper::user(const tstring& name, bool upload)
+{
+    if (name.empty())
+        return null_ptr;
+
+    if (!is_null(primary_))
+        return primary_->user(name, upload);
+
+    mutex::spcode_lock lock(lock_);
+
+    std::map<tstring, Buckets>::iterator it = users_.find(name);
+    if (users_.end() == it)
+    {
+        std::map<tstring, Rate>::const_iterator rate = userRates_.find(name);
+        if (userRates_.end() == rate)
+            rate = userRates_.find(_T("*"));
+        if (userRates_.end() == rate)
+            return null_ptr;
+
+        // һõʱŴ, Ժûе( Ƭϵ )
+        it = users_.insert(std::make_pair(name, Buckets())).first;
+        resetBuckets(it->second, rate->second.first, rate->second.second);
+    }
+
+    TokenBucket& bucket = upload ? it->second.first : it->second.second;
+    return bucket.isLimited() ? &bucket : null_ptr;
+}
+
+_jingxian_end
@@ -0,0 +1,301 @@
+
+#ifndef _TrafficShaper_H_
+#define _TrafficShaper_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <map>
+# include "jingxian/string/string.h"
+# include "jingxian/threading/mutex.h"
+
+_jingxian_begin
+
+/**
+ * Ͱ, rate Ϊ 0 ʱ
+ *
+ * ʵĵλֽ/, Ҳ 1/1000 ֽ/,  1/1000 ֽΪλ
+ * 벹, û. дɺ֪ʵʵֽ, ú,
+ * ƿǸ, ´ζдǰȵΪֹ.
+ *
+ * ˿ںûͰзƬӹ, ʱ share() ָһ,
+ * delay()  consume() н.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket()
+            : rate_(0)
+            , capacity_(0)
+            , tokens_(0)
+            , last_(0)
+            , lock_(null_ptr)
+    {
+    }
+
+    /**
+     * ָ̹߳ñʱ,  reset() ʱҪɵ߳
+     */
+    void share(mutex* lock)
+    {
+        lock_ = lock;
+    }
+
+    /**
+     * ( ֽ/ )Իֽܵ
+     */
+    void reset(uint32_t rate, uint32_t burst)
+    {
+        rate_ = rate;
+        capacity_ = (int64_t)burst * 1000;
+        tokens_ = capacity_;
+        last_ = 0;
+    }
+
+    bool isLimited() const
+    {
+        return 0 != rate_;
+    }
+
+    uint32_t rate() const
+    {
+        return rate_;
+    }
+
+    /**
+     * 䵽 now Ϊֹ
+     * @param[ in ] now ǰĺ,  TimerQueue::now()
+     * @return Ҫȴĺ, Ϊ 0 ʱԶд
+     */
+    uint32_t delay(uint64_t now)
+    {
+        if (0 == rate_)
+            return 0;
+
+        if (is_null(lock_))
+            return refill(now);
+
+        mutex::spcode_lock lock(*lock_);
+        return refill(now);
+    }
+
+    /**
+     * ۳ʵʶдֽ
+     */
+    void consume(size_t bytes)
+    {
+        if (0 == rate_)
+            return;
+
+        if (is_null(lock_))
+        {
+            tokens_ -= (int64_t)bytes * 1000;
+            return;
+        }
+
+        mutex::spcode_lock lock(*lock_);
+        tokens_ -= (int64_t)bytes * 1000;
+    }
+
+private:
+    enum { MAX_ELAPSED = 60*60*1000 };
+
+    uint32_t refill(uint64_t now)
+    {
+        // ̵߳ now һ, ʱò
+        if (now > last_)
+        {
+            // һεʱ last_ Ϊ 0, , ƼΪ˲
+            uint64_t elapsed = now - last_;
+            if (elapsed > MAX_ELAPSED)
+                elapsed = MAX_ELAPSED;
+            int64_t tokens = tokens_ + (int64_t)elapsed * rate_;
+            tokens_ = (tokens < capacity_) ? tokens : capacity_;
+            last_ = now;
+        }
+
+        if (0 < tokens_)
+            return 0;
+        return (uint32_t)(-tokens_ / rate_) + 1;
+    }
+
+    /// ֽ/
+    uint32_t rate_;
+    /// Իܵ( 1/1000 ֽ )
+    int64_t capacity_;
+    /// ǰ( 1/1000 ֽ ), Ϊ
+    int64_t tokens_;
+    /// ϴβʱ(  )
+    uint64_t last_;
+    /// ʱ, ʱΪ null_ptr
+    mutex* lock_;
+};
+
+/**
+ * һϵ, μԼ, ûĺͼ˿ڵͰ,
+ * һûʱҪȴ, деͰп۳.
+ */
+class Throttle
+{
+public:
+    Throttle()
+            : count_(0)
+    {
+    }
+
+    /**
+     * ԼͰ
+     */
+    TokenBucket& own()
+    {
+        return own_;
+    }
+
+    /**
+     * һͰ(  TrafficShaper  )
+     */
+    void attach(TokenBucket* bucket)
+    {
+        if (is_null(bucket) || MAX_SHARED <= count_)
+            return;
+
+        for (size_t i = 0; i < count_; ++ i)
+        {
+            if (bucket == shared_[i])
+                return;
+        }
+        shared_[count_ ++] = bucket;
+    }
+
+    bool isLimited() const
+    {
+        return own_.isLimited() || 0 != count_;
+    }
+
+    /**
+     * @return Ҫȴĺ, Ϊ 0 ʱԶд
+     */
+    uint32_t delay(uint64_t now)
+    {
+        uint32_t result = own_.delay(now);
+        for (size_t i = 0; i < count_; ++ i)
+        {
+            uint32_t wait = shared_[i]->delay(now);
+            if (wait > result)
+                result = wait;
+        }
+        return result;
+    }
+
+    void consume(size_t bytes)
+    {
+        own_.consume(bytes);
+        for (size_t i = 0; i < count_; ++ i)
+            shared_[i]->consume(bytes);
+    }
+
+private:
+    enum { MAX_SHARED = 2 };
+
+    TokenBucket own_;
+    TokenBucket* shared_[MAX_SHARED];
+    size_t count_;
+};
+
+/**
+ * , ûͼ˿ٵ, ûͼ˿ڵͰ
+ *
+ * ʵĵλΪֽ/, Ϊ 0 ʱ. Ƭ TrafficShaper Ͱ,
+ * ˿ںûͰȡѭ, зƬϼƲõ.
+ * ЩͰʹ, Ƭ߳з; ֻѭ޸.
+ */
+class TrafficShaper
+{
+public:
+    TrafficShaper();
+
+    /**
+     * ÿշ
+     */
+    void connectionRate(uint32_t receive, uint32_t send);
+
+    /**
+     * һ˿Ӻϼշ
+     * @param[ in ] address ĵַ, ʽͬ Endpoint::address()
+     */
+    void listenerRate(const tstring& address, uint32_t receive, uint32_t send);
+
+    /**
+     * һûӺϼƵϴ
+     * @param[ in ] name û, Ϊ "*" ʱûеõûԵ
+     */
+    void userRate(const tstring& name, uint32_t upload, uint32_t download);
+
+    /**
+     * ʼӵ
+     */
+    void initialize(Throttle& receive, Throttle& send);
+
+    /**
+     * ˿ڵͰ
+     * @param[ in ] address ӵļַ
+     */
+    void attachListener(Throttle& receive, Throttle& send, const tstring& address);
+
+    /**
+     * ȡûͰ, ûʱ null_ptr
+     * @param[ in ] upload Ϊ true ʱȡϴ, ȡص
+     */
+    TokenBucket* user(const tstring& name, bool upload);
+
+    /**
+     * Ϊ primary ķƬ, ÿӵ, ˿ںûͰ
+     * primary 
+     */
+    void share(TrafficShaper* primary);
+
+    /**
+     * һ, ٿԻһĴС
+     */
+    static uint32_t burstOf(uint32_t rate);
+
+private:
+    NOCOPY(TrafficShaper);
+
+    struct Rate
+    {
+        Rate()
+                : first(0)
+                , second(0)
+        {
+        }
+
+        uint32_t first;
+        uint32_t second;
+    };
+
+    struct Buckets
+    {
+        TokenBucket first;
+        TokenBucket second;
+    };
+
+    void resetBuckets(Buckets& buckets, uint32_t first, uint32_t second);
+
+    Rate connection_;
+    /// ΪƬʱѭ, Ϊ null_ptr
+    TrafficShaper* primary_;
+    /// ıеͰ
+    mutex lock_;
+    std::map<tstring, Buckets> listeners_;
+    std::map<tstring, Rate> userRates_;
+    std::map<tstring, Buckets> users_;
+};
+
+_jingxian_end
+
+#endif //_TrafficShaper_H_
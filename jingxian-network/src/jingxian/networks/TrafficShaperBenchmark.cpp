@@ -0,0 +1,222 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/TimerQueue.h"
+# include "jingxian/networks/TrafficShaper.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    class CountTimer : public Timer
+    {
+    public:
+        CountTimer(TimerQueue* queue = null_ptr)
+                : queue_(queue)
+                , count(0)
+        {
+        }
+
+        virtual void onTimeout()
+        {
+            ++ count;
+
+            //  onTimeout() ¼벻ͬһ runExpired() ִ
+            if (!is_null(queue_))
+                queue_->schedule(this, 0);
+        }
+
+        TimerQueue* queue_;
+        int count;
+    };
+}
+
+TEST(shaper, tokenBucket)
+{
+    TokenBucket bucket;
+    ASSERT_FALSE(bucket.isLimited());
+    ASSERT_TRUE(0 == bucket.delay(1000));
+
+    // 1000 ֽ/,  1 ֽ/, ʼʱ
+    bucket.reset(1000, 2000);
+    ASSERT_TRUE(0 == bucket.delay(1000));
+
+    bucket.consume(2000);
+    ASSERT_TRUE(0 != bucket.delay(1000));
+
+    // ú, Ƿ 500 ֽҪ 500 
+    bucket.consume(499);
+    ASSERT_TRUE(500 == bucket.delay(1000));
+    ASSERT_TRUE(1 == bucket.delay(1499));
+    ASSERT_TRUE(0 == bucket.delay(1500));
+
+    //  burst ֽ
+    ASSERT_TRUE(0 == bucket.delay(100000));
+    bucket.consume(2000);
+    ASSERT_TRUE(0 != bucket.delay(100000));
+}
+
+TEST(shaper, throttle)
+{
+    TrafficShaper shaper;
+    shaper.connectionRate(0, 0);
+    shaper.userRate(_T("*"), 1000, 0);
+    shaper.userRate(_T("vip"), 0, 0);
+
+    Throttle receive;
+    Throttle send;
+    shaper.initialize(receive, send);
+    ASSERT_FALSE(receive.isLimited());
+    ASSERT_FALSE(send.isLimited());
+
+    ASSERT_TRUE(is_null(shaper.user(_T(""), true)));
+    ASSERT_TRUE(is_null(shaper.user(_T("vip"), true)));
+    ASSERT_TRUE(is_null(shaper.user(_T("guest"), false)));
+
+    // ͬһûӹһͰ
+    TokenBucket* guest = shaper.user(_T("guest"), true);
+    ASSERT_TRUE(!is_null(guest));
+    ASSERT_TRUE(guest == shaper.user(_T("guest"), true));
+    ASSERT_TRUE(guest != shaper.user(_T("other"), true));
+
+    Throttle other;
+    receive.attach(guest);
+    receive.attach(guest);
+    other.attach(guest);
+    ASSERT_TRUE(receive.isLimited());
+    ASSERT_TRUE(0 == receive.delay(1000));
+
+    receive.consume(TrafficShaper::burstOf(1000) + 1000);
+    ASSERT_TRUE(1000 <= other.delay(1000));
+    ASSERT_TRUE(0 == other.delay(3000));
+}
+
+TEST(shaper, share)
+{
+    TrafficShaper shaper;
+    shaper.connectionRate(0, 2000);
+    shaper.listenerRate(_T("0.0.0.0:80"), 1000, 0);
+    shaper.userRate(_T("*"), 1000, 3);
+
+    // Ƭÿӵ, ˿ںûͰѭ
+    TrafficShaper first;
+    first.share(&shaper);
+    TrafficShaper second;
+    second.share(&shaper);
+
+    Throttle receive;
+    Throttle send;
+    first.initialize(receive, send);
+    ASSERT_FALSE(receive.isLimited());
+    ASSERT_TRUE(2000 == send.own().rate());
+
+    Throttle primaryReceive;
+    Throttle primarySend;
+    shaper.initialize(primaryReceive, primarySend);
+    shaper.attachListener(primaryReceive, primarySend, _T("0.0.0.0:80"));
+
+    Throttle otherReceive;
+    Throttle otherSend;
+    second.initialize(otherReceive, otherSend);
+    second.attachListener(otherReceive, otherSend, _T("0.0.0.0:80"));
+
+    // һƬ˿ڵƺ, ѭƬϵҲҪȴ,
+    // зƬϼƲõ
+    first.attachListener(receive, send, _T("0.0.0.0:80"));
+    ASSERT_TRUE(receive.isLimited());
+    ASSERT_TRUE(0 == receive.delay(1000));
+    receive.consume(TrafficShaper::burstOf(1000) + 1000);
+    ASSERT_TRUE(1000 <= receive.delay(1000));
+    ASSERT_TRUE(1000 <= primaryReceive.delay(1000));
+    ASSERT_TRUE(1000 <= otherReceive.delay(1000));
+    ASSERT_TRUE(0 == otherReceive.delay(3000));
+
+    // ûʲƬƽ, ͬһûڸƬϹһͰ
+    TokenBucket* guest = first.user(_T("guest"), true);
+    ASSERT_TRUE(1000 == guest->rate());
+    ASSERT_TRUE(3 == first.user(_T("guest"), false)->rate());
+    ASSERT_TRUE(guest == second.user(_T("guest"), true));
+    ASSERT_TRUE(guest == shaper.user(_T("guest"), true));
+
+    // ѭ޸öԷƬеҲЧ
+    shaper.userRate(_T("*"), 500, 3);
+    ASSERT_TRUE(500 == guest->rate());
+}
+
+TEST(shaper, timerQueue)
+{
+    TimerQueue timers;
+    CountTimer first;
+    CountTimer second;
+
+    ASSERT_TRUE(1000 == timers.timeout(1000));
+
+    timers.schedule(&first, 0);
+    timers.schedule(&second, 60*1000);
+    ASSERT_TRUE(first.isScheduled());
+    ASSERT_TRUE(0 == timers.timeout(1000));
+
+    ASSERT_TRUE(1 == timers.runExpired());
+    ASSERT_TRUE(1 == first.count);
+    ASSERT_FALSE(first.isScheduled());
+    ASSERT_TRUE(0 == second.count);
+
+    timers.cancel(&second);
+    ASSERT_TRUE(0 == timers.size());
+    ASSERT_TRUE(0 == timers.runExpired());
+
+    CountTimer repeat(&timers);
+    timers.schedule(&repeat, 0);
+    ASSERT_TRUE(1 == timers.runExpired());
+    ASSERT_TRUE(repeat.isScheduled());
+    timers.cancel(&repeat);
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(shaper_unlimited)
+{
+    TrafficShaper shaper;
+    Throttle receive;
+    Throttle send;
+    shaper.initialize(receive, send);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        if (receive.isLimited() && 0 != receive.delay(i))
+            continue;
+        if (receive.isLimited())
+            receive.consume(1460);
+    }
+}
+
+BENCHMARK(shaper_three_levels)
+{
+    TrafficShaper shaper;
+    shaper.connectionRate(1024*1024*1024, 0);
+    shaper.listenerRate(_T("0.0.0.0:80"), 1024*1024*1024, 0);
+    shaper.userRate(_T("*"), 1024*1024*1024, 0);
+
+    Throttle receive;
+    Throttle send;
+    shaper.initialize(receive, send);
+    shaper.attachListener(receive, send, _T("0.0.0.0:80"));
+    receive.attach(shaper.user(_T("guest"), true));
+
+    size_t delayed = 0;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        if (0 != receive.delay(i))
+            ++ delayed;
+        receive.consume(1460);
+    }
+    DO_NOT_OPTIMIZE(delayed);
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
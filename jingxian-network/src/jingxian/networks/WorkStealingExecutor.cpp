@@ -0,0 +1,237 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/WorkStealingExecutor.h"
+# include "jingxian/threading/thread.h"
+
+_jingxian_begin
+
+WorkStealingExecutor::WorkStealingExecutor()
+        : next_(0)
+        , stopping_(0)
+        , tlsIndex_(::TlsAlloc())
+        , logger_(_T("jingxian.executor"))
+        , toString_(_T("WorkStealingExecutor"))
+{
+    stats_.pending = 0;
+    stats_.executed = 0;
+    stats_.steals = 0;
+
+    if (TLS_OUT_OF_INDEXES == tlsIndex_)
+        ThrowException1(RuntimeException, _T("ֲ߳̾洢ʧ"));
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    stop();
+    ::TlsFree(tlsIndex_);
+}
+
+bool WorkStealingExecutor::start(size_t number_of_threads)
+{
+    if (!workers_.empty())
+    {
+        LOG_WARN(logger_ , _T("!"));
+        return false;
+    }
+
+    if (0 == number_of_threads)
+    {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        number_of_threads = info.dwNumberOfProcessors;
+    }
+
+    stopping_ = 0;
+    wakeup_.reset(new semaphore(0, LONG_MAX));
+    exited_.reset(new semaphore(0, LONG_MAX));
+
+    for (size_t i = 0; i < number_of_threads; ++ i)
+        workers_.push_back(new Worker());
+
+    for (size_t i = 0; i < number_of_threads; ++ i)
+    {
+        try
+        {
+            create_thread(&WorkStealingExecutor::workerMain, this, i, _T("executor"));
+        }
+        catch (const std::exception& e)
+        {
+            LOG_FATAL(logger_ , _T("߳ʧ - ") << e.what());
+
+            // Ѿ߳Ҫ˳
+            ::InterlockedExchange(&stopping_, 1);
+            wakeup_->release((long)i + 1);
+            for (size_t j = 0; j < i; ++ j)
+                exited_->acquire();
+
+            for (std::vector<Worker*>::iterator it = workers_.begin(); it != workers_.end(); ++ it)
+                delete *it;
+            workers_.clear();
+            return false;
+        }
+    }
+
+    LOG_INFO(logger_ , _T(" ") << number_of_threads << _T(" ߳"));
+    return true;
+}
+
+void WorkStealingExecutor::stop()
+{
+    if (workers_.empty())
+        return;
+
+    ::InterlockedExchange(&stopping_, 1);
+    wakeup_->release((long)workers_.size());
+    for (size_t i = 0; i < workers_.size(); ++ i)
+        exited_->acquire();
+
+    //  stop() ͬʱύûִ߳
+    for (std::vector<Worker*>::iterator it = workers_.begin(); it != workers_.end(); ++ it)
+    {
+        for (std::deque<Task>::iterator task = (*it)->tasks.begin(); task != (*it)->tasks.end(); ++ task)
+        {
+            LOG_WARN(logger_ , _T("ֹ̳߳ͣ, һδִе"));
+            delete task->work;
+            delete task->continuation;
+            ::InterlockedDecrement(&stats_.pending);
+        }
+        delete *it;
+    }
+    workers_.clear();
+}
+
+bool WorkStealingExecutor::isRunning() const
+{
+    return !workers_.empty() && 0 == stopping_;
+}
+
+size_t WorkStealingExecutor::size() const
+{
+    return workers_.size();
+}
+
+bool WorkStealingExecutor::execute(IRunnable* work, IConcurrentPort* port, IRunnable* continuation)
+{
+    if (is_null(work))
+        ThrowException1(ArgumentNullException, _T("work"));
+    if (!is_null(continuation) && is_null(port))
+        ThrowException1(ArgumentNullException, _T("port"));
+
+    if (!isRunning())
+        return false;
+
+    Task task;
+    task.work = work;
+    task.port = port;
+    task.continuation = continuation;
+
+    // ߳ύԼĶ, ߳ύ
+    size_t index = (size_t)::TlsGetValue(tlsIndex_);
+    if (0 == index)
+        index = (size_t)(::InterlockedIncrement(&next_) & 0x7fffffff) % workers_.size();
+    else
+        -- index;
+
+    {
+        mutex::spcode_lock lock(workers_[index]->lock);
+        workers_[index]->tasks.push_back(task);
+    }
+    ::InterlockedIncrement(&stats_.pending);
+    wakeup_->release();
+    return true;
+}
+
+const ExecutorStats& WorkStealingExecutor::stats() const
+{
+    return stats_;
+}
+
+const tstring& WorkStealingExecutor::toString() const
+{
+    return toString_;
+}
+
+void WorkStealingExecutor::workerMain(WorkStealingExecutor* executor, size_t index)
+{
+    ::TlsSetValue(executor->tlsIndex_, (LPVOID)(index + 1));
+    executor->run(index);
+    ::TlsSetValue(executor->tlsIndex_, null_ptr);
+    executor->exited_->release();
+}
+
+void WorkStealingExecutor::run(size_t index)
+{
+    Task task;
+    while (true)
+    {
+        if (pop(index, task) || steal(index, task))
+        {
+            process(task);
+            continue;
+        }
+
+        // ֹͣʱȰѶеִ˳
+        if (0 != stopping_)
+            break;
+
+        wakeup_->acquire();
+    }
+}
+
+bool WorkStealingExecutor::pop(size_t index, Task& task)
+{
+    Worker* worker = workers_[index];
+    mutex::spcode_lock lock(worker->lock);
+    if (worker->tasks.empty())
+        return false;
+
+    task = worker->tasks.back();
+    worker->tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingExecutor::steal(size_t index, Task& task)
+{
+    for (size_t i = 1; i < workers_.size(); ++ i)
+    {
+        Worker* victim = workers_[(index + i) % workers_.size()];
+
+        // סĶڱʹ, һ
+        mutex::spcode_lock lock(victim->lock, false, true);
+        if (!lock.try_lock() || victim->tasks.empty())
+            continue;
+
+        task = victim->tasks.front();
+        victim->tasks.pop_front();
+        ::InterlockedIncrement(&stats_.steals);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingExecutor::process(Task& task)
+{
+    ::InterlockedDecrement(&stats_.pending);
+
+    try
+    {
+        task.work->run();
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR(logger_ , _T("ִʱ쳣 - ") << e.what());
+    }
+    catch (...)
+    {
+        LOG_ERROR(logger_ , _T("ִʱδ֪쳣"));
+    }
+    delete task.work;
+    ::InterlockedIncrement(&stats_.executed);
+
+    // ʹ work ʧҲҪ continuation, ӻһֱȴ
+    // NOTICE: send ʧʱ IOCPServer Ѿɾ continuation
+    if (!is_null(task.continuation) && !task.port->send(task.continuation))
+        LOG_ERROR(logger_ , _T("ͺ '") << task.port->toString() << _T("' ʧ"));
+}
+
+_jingxian_end
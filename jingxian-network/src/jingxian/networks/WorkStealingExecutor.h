@@ -0,0 +1,120 @@
+
+#ifndef _WorkStealingExecutor_H_
+#define _WorkStealingExecutor_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <deque>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/IExecutor.h"
+# include "jingxian/threading/mutex.h"
+# include "jingxian/threading/semaphore.h"
+
+_jingxian_begin
+
+/**
+ * ͵ȡĹ̳߳
+ *
+ * ÿ߳ԼĶ, ߳ύŵԼĶ, ߳
+ * ύŵ. ̴߳Լеβȡ( ȳ,
+ * ݶ뻹ڻ ), ԼĶпʱеͷ͵ȡ( Ƚȳ, ͵
+ * ύ ). ÿԼ, ֻ͵ȡʱŻо.
+ */
+class WorkStealingExecutor : public IExecutor
+{
+public:
+    WorkStealingExecutor();
+
+    virtual ~WorkStealingExecutor();
+
+    /**
+     * ߳
+     * @param[ in ] number_of_threads ߳, Ϊ 0 ʱȡ CPU ĸ
+     */
+    bool start(size_t number_of_threads);
+
+    /**
+     * ֹͣ߳, Ѿύִŷ
+     */
+    void stop();
+
+    /**
+     * ǲ
+     */
+    bool isRunning() const;
+
+    /**
+     * ߳
+     */
+    size_t size() const;
+
+    /**
+     * @implements execute
+     */
+    virtual bool execute(IRunnable* work, IConcurrentPort* port, IRunnable* continuation);
+
+    /**
+     * @implements stats
+     */
+    virtual const ExecutorStats& stats() const;
+
+    /**
+    * ȡõַ
+    */
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(WorkStealingExecutor);
+
+    struct Task
+    {
+        IRunnable* work;
+        IConcurrentPort* port;
+        IRunnable* continuation;
+    };
+
+    struct Worker
+    {
+        mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    static void workerMain(WorkStealingExecutor* executor, size_t index);
+
+    void run(size_t index);
+
+    bool pop(size_t index, Task& task);
+
+    bool steal(size_t index, Task& task);
+
+    void process(Task& task);
+
+    /// ÿ̵߳Ķ
+    std::vector<Worker*> workers_;
+    /// ʱѿе߳
+    std::auto_ptr<semaphore> wakeup_;
+    /// ߳˳ʱ֪ͨ stop()
+    std::auto_ptr<semaphore> exited_;
+    /// ⲿύʱѡ
+    volatile LONG next_;
+    /// ǲֹͣ
+    volatile LONG stopping_;
+    /// 浱ǰ߳ workers_ еż 1
+    DWORD tlsIndex_;
+    /// ͳ
+    ExecutorStats stats_;
+    /// ־ӿ
+    logging::logger logger_;
+    /// ʵ
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_WorkStealingExecutor_H_
@@ -0,0 +1,486 @@
+
+# include "pro_config.h"
+# include "jingxian/threading/thread.h"
+# include "jingxian/protocol/BaseProtocol.h"
+# include "jingxian/networks/WorkStealingExecutor.h"
+# include "jingxian/networks/IOCPServer.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    /**
+     * ģڵ߳, յĺڵ drain() ִ߳
+     */
+    class QueuePort : public IConcurrentPort
+    {
+    public:
+        QueuePort()
+                : ready_(0, LONG_MAX)
+                , toString_(_T("QueuePort"))
+        {
+        }
+
+        virtual ~QueuePort()
+        {
+            drain();
+        }
+
+        virtual bool send(IRunnable* runnable)
+        {
+            {
+                mutex::spcode_lock lock(lock_);
+                queue_.push_back(runnable);
+            }
+            ready_.release();
+            return true;
+        }
+
+        /**
+         * ִѾյĺ, ȴ
+         */
+        size_t drain()
+        {
+            std::deque<IRunnable*> queue;
+            {
+                mutex::spcode_lock lock(lock_);
+                queue.swap(queue_);
+            }
+
+            for (std::deque<IRunnable*>::iterator it = queue.begin(); it != queue.end(); ++ it)
+            {
+                ready_.acquire();
+                (*it)->run();
+                delete *it;
+            }
+            return queue.size();
+        }
+
+        /**
+         * ȴִ count 
+         */
+        void wait(size_t count)
+        {
+            while (0 < count)
+            {
+                IRunnable* runnable;
+                ready_.acquire();
+                {
+                    mutex::spcode_lock lock(lock_);
+                    runnable = queue_.front();
+                    queue_.pop_front();
+                }
+                runnable->run();
+                delete runnable;
+                -- count;
+            }
+        }
+
+        virtual const tstring& toString() const
+        {
+            return toString_;
+        }
+
+    private:
+        NOCOPY(QueuePort);
+
+        mutex lock_;
+        semaphore ready_;
+        std::deque<IRunnable*> queue_;
+        tstring toString_;
+    };
+
+    /**
+     *  CPU ļ, ֤ʱĹϣ, ѹݼ
+     */
+    uint32_t burn(size_t rounds)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < rounds; ++ i)
+            hash = (hash ^ (uint32_t)i) * 16777619u;
+        return hash;
+    }
+
+    class BurnTask : public IRunnable
+    {
+    public:
+        BurnTask(size_t rounds, volatile LONG* done)
+                : rounds_(rounds)
+                , done_(done)
+        {
+        }
+
+        virtual void run()
+        {
+            DO_NOT_OPTIMIZE(burn(rounds_));
+            ::InterlockedIncrement(done_);
+        }
+
+    private:
+        size_t rounds_;
+        volatile LONG* done_;
+    };
+
+    /**
+     * ڹ߳ύ children , Щڱ̵߳Ķ, Ա
+     * ߳͵
+     */
+    class SpawnTask : public IRunnable
+    {
+    public:
+        SpawnTask(IExecutor& executor, QueuePort& port, size_t children, size_t rounds, volatile LONG* done)
+                : executor_(executor)
+                , port_(port)
+                , children_(children)
+                , rounds_(rounds)
+                , done_(done)
+        {
+        }
+
+        virtual void run()
+        {
+            for (size_t i = 0; i < children_; ++ i)
+                executor_.execute(new BurnTask(rounds_, done_), &port_, new BurnTask(0, done_));
+            ::InterlockedIncrement(done_);
+        }
+
+    private:
+        IExecutor& executor_;
+        QueuePort& port_;
+        size_t children_;
+        size_t rounds_;
+        volatile LONG* done_;
+    };
+
+    /// һʱļ, ԼǱʱļʮ
+    const size_t HEAVY_ROUNDS = 80000;
+}
+
+TEST(executor, offload)
+{
+    WorkStealingExecutor executor;
+    QueuePort port;
+    volatile LONG done = 0;
+
+    // ûʱʧ, ɵɾ
+    std::auto_ptr<BurnTask> task(new BurnTask(0, &done));
+    ASSERT_FALSE(executor.execute(task.get(), &port, null_ptr));
+    ASSERT_TRUE(executor.start(4));
+    ASSERT_TRUE(4 == executor.size());
+
+    // 100 ڹ߳ύ 10 ,  1100  1100 
+    for (int i = 0; i < 100; ++ i)
+        ASSERT_TRUE(executor.execute(new SpawnTask(executor, port, 10, 10000, &done), &port, new BurnTask(0, &done)));
+
+    port.wait(1100);
+    ASSERT_TRUE(2200 == done);
+    ASSERT_TRUE(1100 == executor.stats().executed);
+    ASSERT_TRUE(0 == executor.stats().pending);
+
+    executor.stop();
+    ASSERT_FALSE(executor.isRunning());
+    ASSERT_FALSE(executor.execute(task.get(), &port, null_ptr));
+}
+
+TEST(executor, steal)
+{
+    WorkStealingExecutor executor;
+    QueuePort port;
+    volatile LONG done = 0;
+    ASSERT_TRUE(executor.start(4));
+
+    // еһ߳ύ, ԼĶ, ֻ߳͵
+    ASSERT_TRUE(executor.execute(new SpawnTask(executor, port, 64, 1000000, &done), &port, new BurnTask(0, &done)));
+
+    port.wait(65);
+    ASSERT_TRUE(130 == done);
+    ASSERT_TRUE(65 == executor.stats().executed);
+    ASSERT_TRUE(0 < executor.stats().steals);
+
+    executor.stop();
+}
+
+# ifndef _GOOGLETEST_
+
+namespace
+{
+    const char ECHO_REQUEST = 'e';
+    const char HEAVY_REQUEST = 'h';
+
+    /**
+     * ʱ̳߳, ڵ߳лظ
+     */
+    class ReplyTask : public IRunnable
+    {
+    public:
+        ReplyTask(ITransport* transport, char reply)
+                : transport_(transport)
+                , reply_(reply)
+        {
+        }
+
+        virtual void run()
+        {
+            OutBuffer out(transport_);
+            out.writeInt8(reply_);
+        }
+
+    private:
+        ITransport* transport_;
+        char reply_;
+    };
+
+    /**
+     * ÿֽһ, ԭ, ʱ HEAVY_ROUNDS 
+     * . offload Ϊ true ʱʱ󽻸̳߳.
+     *
+     * ͻյظǰϿ,  ReplyTask ִʱӻ.
+     */
+    class LoadProtocol : public BaseProtocol
+    {
+    public:
+        LoadProtocol(IReactorCore* core, bool offload)
+                : BaseProtocol(_T("LoadProtocol"))
+                , core_(core)
+                , offload_(offload)
+                , done_(0)
+        {
+        }
+
+        virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+        {
+            delete this;
+        }
+
+        virtual size_t onReceived(ProtocolContext& context)
+        {
+            std::string reply;
+            for (std::vector<io_mem_buf>::const_iterator it = context.inMemory().begin()
+                    ; it != context.inMemory().end(); ++ it)
+            {
+                for (u_long i = 0; i < it->len; ++ i)
+                {
+                    if (HEAVY_REQUEST != it->buf[i])
+                        reply.push_back(it->buf[i]);
+                    else if (offload_)
+                        core_->executor().execute(new BurnTask(HEAVY_ROUNDS, &done_)
+                                                  , core_
+                                                  , new ReplyTask(&context.transport(), HEAVY_REQUEST));
+                    else
+                    {
+                        DO_NOT_OPTIMIZE(burn(HEAVY_ROUNDS));
+                        reply.push_back(HEAVY_REQUEST);
+                    }
+                }
+            }
+
+            if (!reply.empty())
+            {
+                OutBuffer out(&context.transport());
+                out.writeBlob(reply.data(), reply.size());
+            }
+            return context.inBytes();
+        }
+
+    private:
+        NOCOPY(LoadProtocol);
+
+        IReactorCore* core_;
+        bool offload_;
+        volatile LONG done_;
+    };
+
+    class LoadProtocolFactory : public IProtocolFactory
+    {
+    public:
+        LoadProtocolFactory(bool offload)
+                : offload_(offload)
+                , toString_(_T("LoadProtocolFactory"))
+        {
+        }
+
+        virtual IProtocol* createProtocol(ITransport* transport, IReactorCore* core)
+        {
+            return new LoadProtocol(core, offload_);
+        }
+
+        virtual bool configure(configure::Context& context, const tstring& t)
+        {
+            return false;
+        }
+
+        virtual const tstring& toString() const
+        {
+            return toString_;
+        }
+
+    private:
+        bool offload_;
+        tstring toString_;
+    };
+
+    class StopServer : public IRunnable
+    {
+    public:
+        StopServer(IOCPServer* server)
+                : server_(server)
+        {
+        }
+
+        virtual void run()
+        {
+            server_->interrupt();
+        }
+
+    private:
+        IOCPServer* server_;
+    };
+
+    void runServer(IOCPServer* server, semaphore* exited)
+    {
+        server->runForever();
+        exited->release();
+    }
+
+    SOCKET connectLoad(u_short port)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        addr.sin_port = htons(port);
+
+        //  runForever() вſʼ, տʼ
+        for (int retries = 0; retries < 100; ++ retries)
+        {
+            SOCKET sock = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (INVALID_SOCKET == sock)
+                return INVALID_SOCKET;
+            if (0 == ::connect(sock, (struct sockaddr*)&addr, sizeof(addr)))
+            {
+                BOOL nodelay = TRUE;
+                ::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+                return sock;
+            }
+            closesocket(sock);
+            ::Sleep(10);
+        }
+        return INVALID_SOCKET;
+    }
+
+    bool request(SOCKET sock, char ch)
+    {
+        char reply = 0;
+        return 1 == ::send(sock, &ch, 1, 0)
+               && 1 == ::recv(sock, &reply, 1, 0)
+               && ch == reply;
+    }
+
+    struct HeavyClient
+    {
+        HeavyClient(u_short port)
+                : port(port)
+                , stopping(0)
+                , ready(0, 1)
+                , exited(0, 1)
+        {
+        }
+
+        u_short port;
+        volatile LONG stopping;
+        semaphore ready;
+        semaphore exited;
+    };
+
+    /**
+     * ͣطͺʱ, ÷һֱкʱĹ
+     */
+    void runHeavyClient(HeavyClient* client)
+    {
+        SOCKET sock = connectLoad(client->port);
+        bool ok = (INVALID_SOCKET != sock) && request(sock, HEAVY_REQUEST);
+        client->ready.release();
+
+        while (ok && 0 == client->stopping)
+            ok = request(sock, HEAVY_REQUEST);
+
+        if (INVALID_SOCKET != sock)
+            closesocket(sock);
+        client->exited.release();
+    }
+
+    /**
+     * һӲͣطͺʱ, ʵϵʱ.
+     * ֱ߳ӴʱҪںʱ, ̳߳ʱõ.
+     */
+    void runEchoUnderLoad(BenchmarkState& state, bool offload, u_short port)
+    {
+        state.pauseTiming();
+        IOCPServer server;
+        server.initialize(1);
+        if (offload)
+            ASSERT_TRUE(server.executor().start(0));
+
+        LoadProtocolFactory factory(offload);
+        tstring endpoint = concat<tstring>(_T("tcp://127.0.0.1:"), ::toString((int)port));
+        ASSERT_TRUE(server.listenWith(endpoint.c_str(), &factory));
+
+        semaphore exited(0, 1);
+        create_thread(&runServer, &server, &exited, _T("server"));
+
+        HeavyClient heavy(port);
+        create_thread(&runHeavyClient, &heavy, _T("heavy"));
+        heavy.ready.acquire();
+
+        SOCKET sock = connectLoad(port);
+        ASSERT_TRUE(INVALID_SOCKET != sock);
+        bool ok = true;
+        state.resumeTiming();
+
+        for (size_t i = 0; ok && i < state.iterations(); ++ i)
+            ok = request(sock, ECHO_REQUEST);
+
+        state.pauseTiming();
+        ASSERT_TRUE(ok);
+        ::InterlockedExchange(&heavy.stopping, 1);
+        heavy.exited.acquire();
+        closesocket(sock);
+
+        server.send(new StopServer(&server));
+        exited.acquire();
+        state.resumeTiming();
+    }
+}
+
+BENCHMARK(executor_echo_inline)
+{
+    runEchoUnderLoad(state, false, 30091);
+}
+
+BENCHMARK(executor_echo_offload)
+{
+    runEchoUnderLoad(state, true, 30092);
+}
+
+BENCHMARK(executor_round_trip)
+{
+    WorkStealingExecutor executor;
+    QueuePort port;
+    volatile LONG done = 0;
+    executor.start(0);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        executor.execute(new BurnTask(0, &done), &port, new BurnTask(0, &done));
+        port.wait(1);
+    }
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -63,6 +63,17 @@ ICommand* IncomingBuffer::makeCommand()
     return command.release();
 }
 
+ICommand* IncomingBuffer::makeProbe()
+{
+    std::auto_ptr<ReadCommand> command(new ReadCommand(connectedSocket_, true));
+
+    io_mem_buf tmp;
+    tmp.buf = null_ptr;
+    tmp.len = 0;
+    command->iovec().push_back(tmp);
+    return command.release();
+}
+
 bool IncomingBuffer::increaseBytes(size_t len)
 {
     size_t exceptLen = len;
@@ -142,4 +153,40 @@ void IncomingBuffer::copyTo(std::vector<io_mem_buf>& buf)
     }
 }
 
+bool IncomingBuffer::hasData() const
+{
+    const buffer_chain_t* current = null_ptr;
+    while (null_ptr != (current = dataBuffer_.next(current)))
+    {
+        if (0 != rd_length(current))
+            return true;
+    }
+    return false;
+}
+
+size_t IncomingBuffer::shrink()
+{
+    if (hasData())
+        return 0;
+
+    size_t bytes = 0;
+    buffer_chain_t* current = null_ptr;
+    while (null_ptr != (current = dataBuffer_.pop()))
+    {
+        bytes += memory_size(current);
+        freebuffer(current);
+    }
+    current_ = null_ptr;
+    return bytes;
+}
+
+size_t IncomingBuffer::memory() const
+{
+    size_t bytes = 0;
+    const buffer_chain_t* current = null_ptr;
+    while (null_ptr != (current = dataBuffer_.next(current)))
+        bytes += memory_size(current);
+    return bytes;
+}
+
 _jingxian_end
@@ -29,12 +29,33 @@ public:
 
     ICommand* makeCommand();
 
+    /**
+     * һֽڵĶ, ռû, ݿɶʱ
+     */
+    ICommand* makeProbe();
+
     bool decreaseBytes(size_t len);
 
     bool increaseBytes(size_t len);
 
     void copyTo(std::vector<io_mem_buf>& buf);
 
+    /**
+     * ǷлûбЭȡߵ
+     */
+    bool hasData() const;
+
+    /**
+     * ûʱͷеĻ, жδʱ
+     * @return ͷŵֽ
+     */
+    size_t shrink();
+
+    /**
+     * ռõڴֽ
+     */
+    size_t memory() const;
+
 private:
 	NOCOPY(IncomingBuffer);
 
@@ -89,6 +89,20 @@ bool OutgoingBuffer::clearBytes(size_t len)
     return (0 == exceptLen);
 }
 
+size_t OutgoingBuffer::memory() const
+{
+    size_t bytes = 0;
+    const buffer_chain_t* current = null_ptr;
+    while (null_ptr != (current = buffer_.next(current)))
+        bytes += memory_size(current);
+    return bytes;
+}
+
+bool OutgoingBuffer::hasData() const
+{
+    return null_ptr != buffer_.next(null_ptr);
+}
+
 void assertBuffer(buffer_chain_t* newbuf)
 {
     switch (newbuf->type)
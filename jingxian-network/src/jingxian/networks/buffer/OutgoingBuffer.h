@@ -36,6 +36,16 @@ public:
 
     bool clearBytes(size_t len);
 
+    /**
+     * ûзĻռõڴֽ
+     */
+    size_t memory() const;
+
+    /**
+     * Ƿûз͵
+     */
+    bool hasData() const;
+
 private:
     NOCOPY(OutgoingBuffer);
     ConnectedSocket* connectedSocket_;
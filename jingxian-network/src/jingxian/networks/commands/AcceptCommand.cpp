@@ -19,7 +19,9 @@ AcceptCommand::AcceptCommand(IOCPServer* core
         , context_(context)
         , listener_(listenHandle)
         , listenAddr_(listenAddr)
-        , socket_(WSASocket(family, SOCK_STREAM, IPPROTO_TCP, 0, 0, WSA_FLAG_OVERLAPPED))
+        , family_(family)
+        , socket_(INVALID_SOCKET)
+        , rejecting_(false)
         , ptr_((char*)my_malloc(sizeof(SOCKADDR_STORAGE)*2 + sizeof(SOCKADDR_STORAGE)*2 + 100))
         , len_(sizeof(SOCKADDR_STORAGE)*2 + sizeof(SOCKADDR_STORAGE)*2 + 100)
 {
@@ -36,6 +38,9 @@ AcceptCommand::~AcceptCommand()
         closesocket(socket_);
         socket_ = INVALID_SOCKET;
     }
+
+    if (rejecting_)
+        core_->admission().restoreReserve();
 }
 
 void AcceptCommand::on_complete(size_t bytes_transferred
@@ -53,6 +58,16 @@ void AcceptCommand::on_complete(size_t bytes_transferred
         return;
     }
 
+    if (rejecting_)
+    {
+        // û, Ϲرÿͻ˾֪ܾ
+        closesocket(socket_);
+        socket_ = INVALID_SOCKET;
+        core_->admission().reject(admission_result::Exhausted, listenAddr_);
+        onComplete_(null_ptr, context_);
+        return;
+    }
+
     //if (!acceptor_->isListening())
     //{
     //  ErrorCode err(_T(" '")
@@ -116,8 +131,25 @@ void AcceptCommand::on_complete(size_t bytes_transferred
         return;
     }
 
+    AdmissionControl::Ticket ticket;
+    if (admission_result::Accepted != core_->admission().admit(listenAddr_, remote_addr, ticket))
+    {
+        closesocket(socket_);
+        socket_ = INVALID_SOCKET;
+        onComplete_(null_ptr, context_);
+        return;
+    }
+
+    if (core_->handoff(socket_, host, peer, listenAddr_, ticket))
+    {
+        socket_ = INVALID_SOCKET;
+        onComplete_(null_ptr, context_);
+        return;
+    }
+
     std::auto_ptr<ConnectedSocket> connectedSocket(new ConnectedSocket(core_, socket_, host, peer));
     socket_ = INVALID_SOCKET;
+    connectedSocket->admitted(ticket);
 
     if (!core_->bind((HANDLE)(connectedSocket->handle()), connectedSocket.get()))
     {
@@ -129,6 +161,7 @@ void AcceptCommand::on_complete(size_t bytes_transferred
         onError_(err, context_);
         return;
     }
+    connectedSocket->shapeListener(listenAddr_);
     onComplete_(connectedSocket.get(), context_);
     connectedSocket->initialize();
     connectedSocket.release();
@@ -136,6 +169,25 @@ void AcceptCommand::on_complete(size_t bytes_transferred
 
 bool AcceptCommand::execute()
 {
+    socket_ = WSASocket(family_, SOCK_STREAM, IPPROTO_TCP, 0, 0, WSA_FLAG_OVERLAPPED);
+    if (INVALID_SOCKET == socket_)
+    {
+        // ʱԤһٹر, һֱڶ
+        if (!AdmissionControl::isExhausted(::WSAGetLastError())
+            || !core_->admission().takeReserve())
+            return false;
+
+        socket_ = WSASocket(family_, SOCK_STREAM, IPPROTO_TCP, 0, 0, WSA_FLAG_OVERLAPPED);
+        if (INVALID_SOCKET == socket_)
+        {
+            int errCode = ::WSAGetLastError();
+            core_->admission().restoreReserve();
+            ::WSASetLastError(errCode);
+            return false;
+        }
+        rejecting_ = true;
+    }
+
     DWORD bytesTransferred;
     if (networking::acceptEx(listener_
                              , socket_
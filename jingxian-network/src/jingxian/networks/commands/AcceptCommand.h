@@ -44,7 +44,10 @@ private:
 
     SOCKET listener_;
     tstring listenAddr_;
+    int family_;
     SOCKET socket_;
+    /// Ԥܵ, ܺϹر
+    bool rejecting_;
     char* ptr_;
     size_t len_;
 };
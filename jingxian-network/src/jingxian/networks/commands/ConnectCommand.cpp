@@ -37,6 +37,20 @@ ConnectCommand::ConnectCommand(IOCPServer* core
 {
 }
 
+ConnectCommand::ConnectCommand(IOCPServer* core
+                               , const Endpoint& endPoint
+                               , OnBuildConnectionComplete onComplete
+                               , OnBuildConnectionError onError
+                               , void* context)
+        : core_(core)
+        , onComplete_(onComplete)
+        , onError_(onError)
+        , context_(context)
+        , endPoint_(endPoint)
+        , socket_(INVALID_SOCKET)
+{
+}
+
 ConnectCommand::~ConnectCommand()
 {
     if (INVALID_SOCKET != socket_)
@@ -85,8 +99,24 @@ void ConnectCommand::dnsQuery(const tchar* name, const tchar* port)
     //create_thread(&GetName, name, networking::fetchPort(host_.c_str()), this);
 }
 
+const tstring& ConnectCommand::host()
+{
+    if (host_.empty())
+        host_ = endPoint_.toString();
+    return host_;
+}
+
 bool ConnectCommand::execute()
 {
+    if (endPoint_.isValid())
+    {
+        if (endPoint_.isResolved())
+            return execute(endPoint_.addr(), endPoint_.addrLen());
+
+        dnsQuery(endPoint_.host().c_str(), ::toString((int)endPoint_.port()).c_str());
+        return true;
+    }
+
     SOCKADDR_STORAGE addr;
     int len = sizeof(addr);
 
@@ -134,7 +164,7 @@ void ConnectCommand::on_complete(size_t bytes_transferred
     if (!success)
     {
         ErrorCode err(error, concat<tstring>(_T("ӵ '")
-                      , host_
+                      , host()
                       , _T("' ʧ - ")
                       , lastError(error)));
         onError_(err, context_);
@@ -155,7 +185,7 @@ void ConnectCommand::on_complete(size_t bytes_transferred
         if (SOCKET_ERROR == getsockname(socket_, & name, &namelen))
         {
             ErrorCode err(error, concat<tstring>(_T("ӵ '")
-                          , host_
+                          , host()
                           , _T("' ɹ,ȡصַʱʧ - ")
                           , lastError(error)));
             onError_(err, context_);
@@ -166,14 +196,14 @@ void ConnectCommand::on_complete(size_t bytes_transferred
         if (!networking::addressToString(&name, namelen, _T("tcp"), local))
         {
             ErrorCode err(error, concat<tstring>(_T("ӵ '")
-                          , host_
+                          , host()
                           , _T("' ɹ,תصַʱʧ - ")
                           , lastError(error)));
             onError_(err, context_);
             return;
         }
 
-        std::auto_ptr<ConnectedSocket> connectedSocket(new ConnectedSocket(core_, socket_, local, host_));
+        std::auto_ptr<ConnectedSocket> connectedSocket(new ConnectedSocket(core_, socket_, local, host()));
         socket_ = INVALID_SOCKET;
 
         onComplete_(connectedSocket.get(), context_);
@@ -184,7 +214,7 @@ void ConnectCommand::on_complete(size_t bytes_transferred
     catch (std::exception& e)
     {
         ErrorCode err(error, concat<tstring>(_T("ӵ '")
-                      , host_
+                      , host()
                       , _T("' ɹ,ʼʱʧ - ")
                       , toTstring(e.what())));
         onError_(err, context_);
@@ -23,6 +23,12 @@ public:
                    , OnBuildConnectionError onError
                    , void* context);
 
+    ConnectCommand(IOCPServer* core
+                   , const Endpoint& endPoint
+                   , OnBuildConnectionComplete onComplete
+                   , OnBuildConnectionError onError
+                   , void* context);
+
     virtual ~ConnectCommand();
 
     virtual void on_complete(size_t bytes_transferred
@@ -35,6 +41,11 @@ public:
     void onResolveComplete(const tstring& name, const tstring& port, const IPHostEntry& hostEntry);
     void onResolveError(const tstring& name, const tstring& port, errcode_t err);
 
+    /**
+     * ȡĿַ,  Endpoint ʱڵһõʱ
+     */
+    const tstring& host();
+
 private:
     NOCOPY(ConnectCommand);
 
@@ -46,6 +57,7 @@ private:
     OnBuildConnectionError onError_;
     void* context_;
 
+    Endpoint endPoint_;
     tstring host_;
     SOCKET socket_;
 };
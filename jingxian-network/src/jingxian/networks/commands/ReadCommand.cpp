@@ -5,8 +5,9 @@
 
 _jingxian_begin
 
-ReadCommand::ReadCommand(ConnectedSocket* transport)
+ReadCommand::ReadCommand(ConnectedSocket* transport, bool probe)
         : transport_(transport)
+        , probe_(probe)
 {
 }
 
@@ -19,6 +20,11 @@ std::vector<io_mem_buf>& ReadCommand::iovec()
     return iovec_;
 }
 
+bool ReadCommand::isProbe() const
+{
+    return probe_;
+}
+
 void ReadCommand::on_complete(size_t bytes_transferred
                               , bool success
                               , void *completion_key
@@ -30,6 +36,12 @@ void ReadCommand::on_complete(size_t bytes_transferred
         transport_->onError(*this, transport_mode::Receive, error, err);
         return;
     }
+    else if (probe_)
+    {
+        // ֽڵĶ󷵻 0 ֻʾݿɶ( Էѹر ), Ҫٶһβ֪
+        transport_->onProbe(*this);
+        return;
+    }
     else if (0 == bytes_transferred)
     {
         transport_->onError(*this, transport_mode::Receive, error, _T("Էر!"));
@@ -47,7 +59,7 @@ bool ReadCommand::execute()
     DWORD flags = 0;
 
     assert(iovec_.size() > 0);
-    assert(iovec_[0].len > 0);
+    assert(probe_ || iovec_[0].len > 0);
 
     if (SOCKET_ERROR != ::WSARecv(transport_->handle()
                                   ,  &(iovec_[0])
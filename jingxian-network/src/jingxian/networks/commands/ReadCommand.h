@@ -18,7 +18,10 @@ class ReadCommand : public ICommand
 {
 public:
 
-    ReadCommand(ConnectedSocket* transport);
+    /**
+     * @param[ in ] probe ǷֽڵĶ, ʱֻʾݿɶ
+     */
+    ReadCommand(ConnectedSocket* transport, bool probe = false);
 
     virtual ~ReadCommand();
 
@@ -31,11 +34,14 @@ public:
 
     std::vector<io_mem_buf>& iovec();
 
+    bool isProbe() const;
+
 private:
     NOCOPY(ReadCommand);
 
     ConnectedSocket* transport_;
     std::vector<io_mem_buf> iovec_;
+    bool probe_;
 };
 
 _jingxian_end
@@ -23,9 +23,18 @@ ConnectedSocket::ConnectedSocket(IOCPServer* core
         , isInitialize_(false)
         , stopReading_(false)
         , reading_(false)
+        , pausedByBudget_(false)
+        , probed_(false)
+        , readCommand_(null_ptr)
+        , cancelling_(false)
+        , received_(0)
         , writing_(false)
         , shutdowning_(false)
+        , draining_(false)
         , isPosition_(false)
+        , admittedBy_(core)
+        , captureSession_(0)
+        , captureId_(0)
         , tracer_(0)
 {
     toString_ = concat<tstring>(_T("ConnectedSocket[")
@@ -46,10 +55,17 @@ ConnectedSocket::ConnectedSocket(IOCPServer* core
     context_.initialize(core, this);
     incoming_.initialize(this);
     outgoing_.initialize(this);
+
+    core_->shaper().initialize(receiveThrottle_, sendThrottle_);
+    readTimer_.initialize(this, transport_mode::Receive);
+    writeTimer_.initialize(this, transport_mode::Send);
 }
 
 ConnectedSocket::~ConnectedSocket( )
 {
+    core_->timers().cancel(&readTimer_);
+    core_->timers().cancel(&writeTimer_);
+
     if ( INVALID_SOCKET != socket_)
     {
         ::closesocket(socket_);
@@ -62,6 +78,8 @@ ConnectedSocket::~ConnectedSocket( )
         isPosition_ = false;
     }
 
+    admittedBy_->releaseAdmission(ticket_, core_);
+
     TP_CRITICAL(tracer_, transport_mode::Both
                 , _T(" ConnectedSocket ɹ"));
     delete tracer_;
@@ -80,17 +98,6 @@ void ConnectedSocket::initialize()
     if ( isInitialize_ )
         return;
 
-#ifdef DUMPFILE
-    tstring logPath = combinePath(core_->basePath(), _T("log"));
-    if (!existDirectory(logPath))
-        createDirectory(logPath);
-
-    os.reset( new std::ofstream(toNarrowString(simplify (combinePath(logPath,concat<tstring>(_T("raw_out_"), ::toString(socket_), _T(".txt"))))).c_str()));
-
-
-    is.reset( new std::ofstream(toNarrowString(simplify (combinePath(logPath,concat<tstring>(_T("raw_in_"), ::toString(socket_), _T(".txt"))))).c_str()));
-
-#endif
 
     if (null_ptr == protocol_)
     {
@@ -153,6 +160,79 @@ void ConnectedSocket::writeBatch(buffer_chain_t** buffers, size_t len)
         doWrite();
 }
 
+void ConnectedSocket::shapeAs(const tstring& user, bool upload)
+{
+    receiveThrottle_.attach(core_->shaper().user(user, upload));
+}
+
+void ConnectedSocket::shapeListener(const tstring& address)
+{
+    listener_ = address;
+    core_->shaper().attachListener(receiveThrottle_, sendThrottle_, address);
+}
+
+void ConnectedSocket::admitted(AdmissionControl::Ticket& ticket, IOCPServer* by)
+{
+    ticket_ = ticket;
+    admittedBy_ = is_null(by) ? core_ : by;
+}
+
+const tstring& ConnectedSocket::listener() const
+{
+    return listener_;
+}
+
+size_t ConnectedSocket::memory() const
+{
+    size_t bytes = incoming_.memory() + outgoing_.memory();
+    if (!is_null(protocol_))
+        bytes += protocol_->memory();
+    return bytes;
+}
+
+size_t ConnectedSocket::received() const
+{
+    return received_;
+}
+
+size_t ConnectedSocket::takeReceived()
+{
+    size_t received = received_;
+    received_ = 0;
+    return received;
+}
+
+size_t ConnectedSocket::shrink()
+{
+    if (!reading_)
+        return incoming_.shrink();
+
+    // δʱڱʹ, ȡ, غ doRead() ͷ
+    if (cancelling_ || is_null(readCommand_) || 0 == incoming_.memory() || incoming_.hasData())
+        return 0;
+
+    if (::CancelIoEx((HANDLE)socket_, readCommand_))
+    {
+        TP_TRACE(tracer_, transport_mode::Receive, _T("ڴ泬Ԥ, ȡ - ")
+                 << ((size_t)readCommand_));
+        cancelling_ = true;
+    }
+    return 0;
+}
+
+void ConnectedSocket::pauseReading(bool paused)
+{
+    if (pausedByBudget_ == paused)
+        return;
+
+    pausedByBudget_ = paused;
+    TP_TRACE(tracer_, transport_mode::Receive
+             , (paused ? _T("ڴ泬Ԥ, ͣ") : _T("ڴصԤ, ָ")));
+
+    if (!paused && connection_status::connected == state_)
+        doRead();
+}
+
 void ConnectedSocket::disconnection()
 {
     disconnection(_T("ûر"));
@@ -179,6 +259,13 @@ void ConnectedSocket::doRead()
         return;
     }
 
+    if (pausedByBudget_)
+    {
+        TP_TRACE(tracer_, transport_mode::Receive
+                 , _T("Զʱڴ泬Ԥ"));
+        return;
+    }
+
     if (shutdowning_)
     {
         tstring err = concat<tstring>(_T("ԶʱѶϿ - ")
@@ -188,7 +275,20 @@ void ConnectedSocket::doRead()
         return;
     }
 
-    std::auto_ptr<ICommand> command(incoming_.makeCommand());
+    if (receiveThrottle_.isLimited() && throttle(receiveThrottle_, readTimer_))
+    {
+        TP_TRACE(tracer_, transport_mode::Receive, _T(", Ƴٶ"));
+        return;
+    }
+
+    // ڴʱûδȡݵȷһֽڵĶ, ͷŽջ,
+    // ٷ
+    bool probe = !probed_ && core_->memory().isLean() && !incoming_.hasData();
+    probed_ = false;
+    if (probe)
+        incoming_.shrink();
+
+    std::auto_ptr<ICommand> command(probe ? incoming_.makeProbe() : incoming_.makeCommand());
     if (is_null(command))
     {
         tstring err = _T("Զʱʧ");
@@ -210,7 +310,7 @@ void ConnectedSocket::doRead()
     TP_TRACE(tracer_, transport_mode::Receive, _T("Ͷ - ")
              << ((size_t)command.get()));
     reading_ = true;
-    command.release();
+    readCommand_ = command.release();
 }
 
 void ConnectedSocket::doWrite()
@@ -222,7 +322,7 @@ void ConnectedSocket::doWrite()
         return;
     }
 
-    if (shutdowning_)
+    if (shutdowning_ && !draining_)
     {
         tstring err = concat<tstring>(_T("дʱѶϿ - ")
                                       , disconnectReason_);
@@ -231,11 +331,23 @@ void ConnectedSocket::doWrite()
         return;
     }
 
+    if (sendThrottle_.isLimited() && throttle(sendThrottle_, writeTimer_))
+    {
+        TP_TRACE(tracer_, transport_mode::Send, _T(", Ƴд"));
+        return;
+    }
+
     std::auto_ptr<ICommand> command(outgoing_.makeCommand());
     if (is_null(command))
     {
         tstring err = _T("ݷ! ");
         TP_TRACE(tracer_, transport_mode::Send, err);
+
+        if (draining_)
+        {
+            draining_ = false;
+            doDisconnect(transport_mode::Send, 0, disconnectReason_);
+        }
         return;
     }
 
@@ -265,12 +377,26 @@ void ConnectedSocket::doDisconnect(transport_mode::type mode
         return;
     }
 
+    // ϿʱȰдݷ( Ƴٵ ),  doWrite()
+    if (transport_mode::Both == mode && 0 == error
+            && (writing_ || outgoing_.hasData()))
+    {
+        shutdowning_ = true;
+        draining_ = true;
+        disconnectReason_ = description;
+
+        TP_TRACE(tracer_, mode,_T("׼Ͽʱδ, ȴݷ"));
+        return;
+    }
+
     if (writing_)
     {
         assert( transport_mode::Send != mode);
         shutdowning_ = true;
         disconnectReason_ = description;
 
+        draining_ = false;
+
         if ( INVALID_SOCKET != socket_ )
             ::shutdown(socket_,  SD_BOTH);
 
@@ -311,48 +437,14 @@ void ConnectedSocket::onRead(const ICommand& command, size_t bytes_transferred)
     TP_TRACE(tracer_, transport_mode::Receive, _T(" '")<< (size_t)&command <<_T("' ɹ!"));
 
     reading_ = false;
+    readCommand_ = null_ptr;
+    cancelling_ = false;
+    received_ += bytes_transferred;
 
-#ifdef DUMPFILE
-    int rawLen = bytes_transferred;
-    ReadCommand* readCmd = (ReadCommand*)&command;
-    for (std::vector<io_mem_buf>::const_iterator it = readCmd->iovec().begin()
-            ; it != readCmd->iovec().end() && rawLen > 0
-            ; ++ it )
-    {
-        int len = 0;
-        if ( it->len > rawLen)
-        {
-            len = rawLen;
-            rawLen = 0;
-        }
-        else
-        {
-            len = it->len;
-            rawLen -= it->len;
-        }
-
-        for (int i = 0; i < len; ++ i)
-        {
-            if ((unsigned)(it->buf[i] + 1) > 256)
-                (*is) << "<" << (int)it->buf[i] << ">";
-            else if ( ::isalpha(it->buf[i]) )
-                (*is) << it->buf[i];
-            else  if ( ::isdigit(it->buf[i]) )
-                (*is) << it->buf[i];
-            else if (_T('\r') == it->buf[i])
-                (*is) << "<\\r>";
-            else if (_T('\n') == it->buf[i])
-                (*is) << "<\\n>" << std::endl;
-            else if (_T('\t') == it->buf[i])
-                (*is) << "\t<\\t>";
-            else if (::isprint(it->buf[i]))
-                (*is) << "<" << (int)it->buf[i] << ":" << it->buf[i] << ">";
-            else
-                (*is) << "<" << (int)it->buf[i] << ">";
-        }
-        is->flush();
-    }
-#endif
+    if (core_->capture().isCapturing())
+        capture(capture_record::Receive, ((ReadCommand&)command).iovec(), bytes_transferred);
+    if (receiveThrottle_.isLimited())
+        receiveThrottle_.consume(bytes_transferred);
 
     if (!incoming_.increaseBytes(bytes_transferred))
     {
@@ -408,54 +500,29 @@ void ConnectedSocket::onRead(const ICommand& command, size_t bytes_transferred)
     doRead();
 }
 
-void ConnectedSocket::onWrite(const ICommand& command, size_t bytes_transferred)
+void ConnectedSocket::onProbe(const ICommand& command)
 {
 	tickCount_ = GetTickCount();
 
-    TP_TRACE(tracer_, transport_mode::Send, _T("д '")<< (size_t)&command <<_T("' ɹ!"));
+    TP_TRACE(tracer_, transport_mode::Receive, _T("ֽڶ '")<< (size_t)&command <<_T("' , ݿɶ!"));
 
+    reading_ = false;
+    readCommand_ = null_ptr;
+    cancelling_ = false;
+    probed_ = true;
+    doRead();
+}
 
-#ifdef DUMPFILE
-    int rawLen = bytes_transferred;
-    WriteCommand* writeCmd = (WriteCommand*)&command;
-    for (std::vector<io_mem_buf>::const_iterator it = writeCmd->iovec().begin()
-            ; it != writeCmd->iovec().end() && rawLen > 0
-            ; ++ it )
-    {
-        int len = 0;
-        if ( it->len > rawLen)
-        {
-            len = rawLen;
-            rawLen = 0;
-        }
-        else
-        {
-            len = it->len;
-            rawLen -= it->len;
-        }
+void ConnectedSocket::onWrite(const ICommand& command, size_t bytes_transferred)
+{
+	tickCount_ = GetTickCount();
 
-        for (int i = 0; i < len; ++ i)
-        {
-            if ((unsigned)(it->buf[i] + 1) > 256)
-                (*os) << "<" << (int)it->buf[i] << ">";
-            else if ( ::isalpha(it->buf[i]) )
-                (*os) << it->buf[i];
-            else  if ( ::isdigit(it->buf[i]) )
-                (*os) << it->buf[i];
-            else if (_T('\r') == it->buf[i])
-                (*os) << "<\\r>";
-            else if (_T('\n') == it->buf[i])
-                (*os) << "<\\n>" << std::endl;
-            else if (_T('\t') == it->buf[i])
-                (*os) << "\t<\\t>";
-            else if (::isprint(it->buf[i]))
-                (*os) << "<" << (int)it->buf[i] << ":" << it->buf[i] << ">";
-            else
-                (*os) << "<" << (int)it->buf[i] << ">";
-        }
-        os->flush();
-    }
-#endif
+    TP_TRACE(tracer_, transport_mode::Send, _T("д '")<< (size_t)&command <<_T("' ɹ!"));
+
+    if (core_->capture().isCapturing())
+        capture(capture_record::Send, ((WriteCommand&)command).iovec(), bytes_transferred);
+    if (sendThrottle_.isLimited())
+        sendThrottle_.consume(bytes_transferred);
 
     writing_ = false;
     outgoing_.clearBytes(bytes_transferred);
@@ -477,6 +544,18 @@ void ConnectedSocket::onError(const ICommand& command
                  <<_T("' 󷵻,")
                  << description);
         reading_ = false;
+        readCommand_ = null_ptr;
+        if (cancelling_)
+        {
+            cancelling_ = false;
+
+            //  shrink() ȡĶ, ·( ڴʱֽڵ )
+            if (ERROR_OPERATION_ABORTED == error && !shutdowning_)
+            {
+                doRead();
+                return;
+            }
+        }
         break;
     case transport_mode::Send:
         TP_TRACE(tracer_, transport_mode::Send, _T("д '")
@@ -532,4 +611,47 @@ databuffer_t* ConnectedSocket::allocateProtocolBuffer()
     return protocol_->createBuffer(context_);
 }
 
+void ConnectedSocket::capture(capture_record::type type
+                              , const std::vector<io_mem_buf>& iovec
+                              , size_t bytes_transferred)
+{
+    TrafficCapture& capture = core_->capture();
+
+    // ÿοʼץʱ¾Ƿץ
+    LONG session = capture.session();
+    if (session != captureSession_)
+    {
+        captureSession_ = session;
+        captureId_ = capture.admit(host_, peer_);
+    }
+
+    capture.record(captureId_, type, iovec, bytes_transferred);
+}
+
+bool ConnectedSocket::throttle(Throttle& throttle, ThrottleTimer& timer)
+{
+    // Ѿڵȴ
+    if (timer.isScheduled())
+        return true;
+
+    TimerQueue& timers = core_->timers();
+    uint32_t delay = throttle.delay(timers.now());
+    if (0 == delay)
+        return false;
+
+    timers.schedule(&timer, delay);
+    return true;
+}
+
+void ConnectedSocket::onThrottled(transport_mode::type mode)
+{
+    if (connection_status::connected != state_)
+        return;
+
+    if (transport_mode::Receive == mode)
+        doRead();
+    else
+        doWrite();
+}
+
 _jingxian_end
\ No newline at end of file
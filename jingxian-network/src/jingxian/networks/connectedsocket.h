@@ -11,14 +11,17 @@
 
 // Include files
 # include <Winsock2.h>
-# include <fstream>
 # include "jingxian/IProtocol.h"
 # include "jingxian/ISession.h"
 # include "jingxian/ProtocolContext.h"
 # include "jingxian/networks/connection_status.h"
 # include "jingxian/logging/logging.h"
 # include "jingxian/networks/IOCPServer.h"
+# include "jingxian/networks/MemoryBudget.h"
 # include "jingxian/networks/TCPContext.h"
+# include "jingxian/networks/TimerQueue.h"
+# include "jingxian/networks/TrafficShaper.h"
+# include "jingxian/networks/TrafficCapture.h"
 # include "jingxian/networks/buffer/IncomingBuffer.h"
 # include "jingxian/networks/buffer/OutgoingBuffer.h"
 
@@ -28,7 +31,7 @@ _jingxian_begin
  * Onͷĺûֱӵõķвʹá
  * ûõķΪITransportӿеķ
  */
-class ConnectedSocket : public ITransport, public ISession
+class ConnectedSocket : public ITransport, public ISession, public IMemoryConsumer
 {
 public:
 
@@ -65,6 +68,11 @@ public:
     virtual void write(buffer_chain_t* buffer);
     virtual void writeBatch(buffer_chain_t** buffers, size_t len);
 
+    /**
+     * @implements shapeAs
+     */
+    virtual void shapeAs(const tstring& user, bool upload);
+
     /**
      * @implements disconnection
      */
@@ -129,17 +137,94 @@ public:
 
     void onWrite(const ICommand& command, size_t bytes_transferred);
     void onRead(const ICommand& command, size_t bytes_transferred);
+    void onProbe(const ICommand& command);
     void onError(const ICommand& command, transport_mode::type mode, errcode_t error, const tstring& description);
     void onDisconnected(const ICommand& command, errcode_t error, const tstring& description);
 
     databuffer_t* allocateProtocolBuffer();
 
+    /**
+     * ˿ڵ
+     * @param[ in ] address ܱӵļַ
+     */
+    void shapeListener(const tstring& address);
+
+    /**
+     * ׼Ʒλ, ʱ
+     * @param[ in ] by λõ¼ѭ, Ϊ null_ptr ʱǱڵ
+     */
+    void admitted(AdmissionControl::Ticket& ticket, IOCPServer* by = null_ptr);
+
+    /**
+     * @implements listener
+     */
+    virtual const tstring& listener() const;
+
+    /**
+     * շЭ黺
+     * @implements memory
+     */
+    virtual size_t memory() const;
+
+    /**
+     * @implements received
+     */
+    virtual size_t received() const;
+
+    /**
+     * @implements takeReceived
+     */
+    virtual size_t takeReceived();
+
+    /**
+     * ûδȡߵʱͷŽջ, δʱ CancelIoEx ȡ,
+     * ȡ󷵻غķֽڵĶ
+     * @implements shrink
+     */
+    virtual size_t shrink();
+
+    /**
+     * @implements pauseReading
+     */
+    virtual void pauseReading(bool paused);
+
 private:
     NOCOPY(ConnectedSocket);
 
+    /**
+     * ʱƳٶдĶʱ
+     */
+    class ThrottleTimer : public Timer
+    {
+    public:
+        ThrottleTimer()
+                : owner_(null_ptr)
+                , mode_(transport_mode::Receive)
+        {
+        }
+
+        void initialize(ConnectedSocket* owner, transport_mode::type mode)
+        {
+            owner_ = owner;
+            mode_ = mode;
+        }
+
+        virtual void onTimeout()
+        {
+            owner_->onThrottled(mode_);
+        }
+
+    private:
+        ConnectedSocket* owner_;
+        transport_mode::type mode_;
+    };
+
     void doRead();
     void doWrite();
     void doDisconnect(transport_mode::type mode, errcode_t error, const tstring& description);
+    void capture(capture_record::type type, const std::vector<io_mem_buf>& iovec, size_t bytes_transferred);
+    bool throttle(Throttle& throttle, ThrottleTimer& timer);
+    void onThrottled(transport_mode::type mode);
 
 
     /// iocp
@@ -166,6 +251,16 @@ private:
     bool stopReading_;
     /// ʾһ,ûз
     bool reading_;
+    /// ڴ泬Ԥͣȡ
+    bool pausedByBudget_;
+    /// ֽڵĶշ, ´Ҫ
+    bool probed_;
+    /// δصĶ
+    ICommand* readCommand_;
+    /// shrink() ȡδصĶ, ʱϿ
+    bool cancelling_;
+    /// ϴ takeReceived() յֽ
+    size_t received_;
     IncomingBuffer incoming_;
     /// ʾһд,ûз
     bool writing_;
@@ -173,6 +268,8 @@ private:
 
     /// Ͽ,Ϊٷд.
     bool shutdowning_;
+    /// Ͽʱдδ, дݷϺٶϿ
+    bool draining_;
     /// 汻ֹͣԭ
     tstring disconnectReason_;
 
@@ -181,14 +278,28 @@ private:
     ///coresessionsеλ
     SessionList::iterator sessionPosition_;
 
+    /// д
+    Throttle receiveThrottle_;
+    Throttle sendThrottle_;
+    ThrottleTimer readTimer_;
+    ThrottleTimer writeTimer_;
+
+    /// ܱӵļַ
+    tstring listener_;
+
+    /// ׼Ʒλ
+    AdmissionControl::Ticket ticket_;
+    /// λõ¼ѭ
+    IOCPServer* admittedBy_;
+
+    /// ϴξǷץʱץ
+    LONG captureSession_;
+    /// ץеӱ, Ϊ 0 ʱץ
+    uint32_t captureId_;
+
     /// ־
     ITracer* tracer_;
     tstring toString_;
-
-#ifdef DUMPFILE
-    std::auto_ptr<std::ofstream> os;
-    std::auto_ptr<std::ofstream> is;
-#endif
 };
 
 _jingxian_end
@@ -0,0 +1,263 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/filters/CompressionFilter.h"
+# include "jingxian/networks/filters/lz4.h"
+
+_jingxian_begin
+
+namespace
+{
+    enum
+    {
+        FRAME_RAW = 0,
+        FRAME_LZ4 = 1
+    };
+
+    /// ѹʱĿ
+    const size_t MAX_SKIP = 16;
+
+    inline void write24(char* p, size_t value)
+    {
+        p[0] = (char)(value & 0xFF);
+        p[1] = (char)((value >> 8) & 0xFF);
+        p[2] = (char)((value >> 16) & 0xFF);
+    }
+
+    inline size_t read24(const char* p)
+    {
+        const unsigned char* u = (const unsigned char*)p;
+        return u[0] | (u[1] << 8) | (u[2] << 16);
+    }
+
+    /**
+     * ֡ͷ, ȡ֡ĳ
+     */
+    bool parseHeader(const char* header, size_t& frameLen)
+    {
+        size_t payload = read24(header + 1);
+        size_t original = read24(header + 4);
+        if (0 == original || original > lz4::MAX_BLOCK)
+            return false;
+
+        switch (header[0])
+        {
+        case FRAME_RAW:
+            if (payload != original)
+                return false;
+            break;
+        case FRAME_LZ4:
+            if (0 == payload || payload > lz4::bound(lz4::MAX_BLOCK))
+                return false;
+            break;
+        default:
+            return false;
+        }
+
+        frameLen = CompressionFilter::HEADER_SIZE + payload;
+        return true;
+    }
+}
+
+CompressionFilter::CompressionFilter()
+        : skip_(0)
+        , backoff_(0)
+        , bytesIn_(0)
+        , bytesOut_(0)
+        , toString_(_T("lz4"))
+{
+}
+
+bool CompressionFilter::decode(const char* data
+                               , size_t len
+                               , size_t& consumed
+                               , std::vector<char>& output)
+{
+    size_t start = output.size();
+    size_t frameLen = 0;
+
+    consumed = 0;
+    while (consumed < len && output.size() - start < MAX_DECODE_OUTPUT)
+    {
+        const char* p = data + consumed;
+        size_t remain = len - consumed;
+
+        if (partial_.empty())
+        {
+            // ֱ֡Ӵнѹ, 
+            if (remain >= HEADER_SIZE)
+            {
+                if (!parseHeader(p, frameLen))
+                    return false;
+
+                if (remain >= frameLen)
+                {
+                    if (!decodeFrame(p, frameLen, output))
+                        return false;
+                    consumed += frameLen;
+                    continue;
+                }
+            }
+
+            partial_.assign(p, p + remain);
+            consumed = len;
+            break;
+        }
+
+        // Ȳ֡ͷ, ٲ֡
+        size_t need = HEADER_SIZE;
+        if (partial_.size() >= HEADER_SIZE)
+        {
+            if (!parseHeader(&partial_[0], frameLen))
+                return false;
+            need = frameLen;
+        }
+
+        size_t size = need - partial_.size();
+        if (size > remain)
+            size = remain;
+        partial_.insert(partial_.end(), p, p + size);
+        consumed += size;
+
+        if (partial_.size() >= HEADER_SIZE && need == HEADER_SIZE)
+            continue;
+
+        if (partial_.size() == need)
+        {
+            if (!decodeFrame(&partial_[0], need, output))
+                return false;
+            partial_.clear();
+        }
+    }
+    return true;
+}
+
+bool CompressionFilter::encode(const char* data
+                               , size_t len
+                               , FilterMode::type mode
+                               , std::vector<char>& output)
+{
+    bytesIn_ += len;
+    while (0 != len)
+    {
+        // ֱѹ,  block_
+        if (block_.empty() && len >= lz4::MAX_BLOCK)
+        {
+            encodeBlock(data, lz4::MAX_BLOCK, output);
+            data += lz4::MAX_BLOCK;
+            len -= lz4::MAX_BLOCK;
+            continue;
+        }
+
+        size_t size = lz4::MAX_BLOCK - block_.size();
+        if (size > len)
+            size = len;
+        block_.insert(block_.end(), data, data + size);
+        data += size;
+        len -= size;
+
+        if (lz4::MAX_BLOCK == block_.size())
+        {
+            encodeBlock(&block_[0], block_.size(), output);
+            block_.clear();
+        }
+    }
+
+    if (FilterMode::normal != mode && !block_.empty())
+    {
+        encodeBlock(&block_[0], block_.size(), output);
+        block_.clear();
+    }
+    return true;
+}
+
+const tstring& CompressionFilter::toString() const
+{
+    return toString_;
+}
+
+uint64_t CompressionFilter::bytesIn() const
+{
+    return bytesIn_;
+}
+
+uint64_t CompressionFilter::bytesOut() const
+{
+    return bytesOut_;
+}
+
+void CompressionFilter::encodeBlock(const char* data, size_t len, std::vector<char>& output)
+{
+    size_t start = output.size();
+    size_t capacity = lz4::bound(len);
+    output.resize(start + HEADER_SIZE + capacity);
+    char* frame = &output[start];
+
+    size_t payload = 0;
+    if (0 == skip_)
+    {
+        payload = lz4::compress(data, len, frame + HEADER_SIZE, capacity);
+        if (0 != payload && payload < len)
+        {
+            backoff_ = 0;
+        }
+        else
+        {
+            payload = 0;
+            skip_ = backoff_;
+            backoff_ = (0 == backoff_) ? 1 : backoff_ * 2;
+            if (backoff_ > MAX_SKIP)
+                backoff_ = MAX_SKIP;
+        }
+    }
+    else
+    {
+        -- skip_;
+    }
+
+    if (0 == payload)
+    {
+        frame[0] = FRAME_RAW;
+        memcpy(frame + HEADER_SIZE, data, len);
+        payload = len;
+    }
+    else
+    {
+        frame[0] = FRAME_LZ4;
+    }
+    write24(frame + 1, payload);
+    write24(frame + 4, len);
+
+    output.resize(start + HEADER_SIZE + payload);
+    bytesOut_ += HEADER_SIZE + payload;
+}
+
+bool CompressionFilter::decodeFrame(const char* frame, size_t len, std::vector<char>& output)
+{
+    size_t original = read24(frame + 4);
+    if (FRAME_RAW == frame[0])
+    {
+        output.insert(output.end(), frame + HEADER_SIZE, frame + len);
+        return true;
+    }
+
+    size_t start = output.size();
+    output.resize(start + original);
+    return lz4::decompress(frame + HEADER_SIZE, len - HEADER_SIZE, &output[start], original);
+}
+
+CompressionFilterFactory::CompressionFilterFactory()
+        : toString_(_T("CompressionFilterFactory[lz4]"))
+{
+}
+
+IFilter* CompressionFilterFactory::createFilter()
+{
+    return new CompressionFilter();
+}
+
+const tstring& CompressionFilterFactory::toString() const
+{
+    return toString_;
+}
+
+_jingxian_end
@@ -0,0 +1,112 @@
+
+#ifndef _CompressionFilter_H_
+#define _CompressionFilter_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/IFilter.h"
+
+_jingxian_begin
+
+/**
+ * ʽѹ, ԼĴڵ֮
+ *
+ * ݴճ 64K Ŀ, ÿ LZ4 ѹ 7 ֽڵ֡ͷ:
+ *
+ *   ( 1 ֽ, 0 ԭ, 1 LZ4 ) ֡( 3 ֽ ) ԭʼ( 3 ֽ )
+ *
+ * ѹûбСĿԭ. ѹĿʱ, 漸鲻ٳѹ
+ * , Ѽܻѹϰװ˷ CPU.
+ */
+class CompressionFilter : public IFilter
+{
+public:
+
+    CompressionFilter();
+
+    /**
+     * @implements decode
+     */
+    virtual bool decode(const char* data
+                        , size_t len
+                        , size_t& consumed
+                        , std::vector<char>& output);
+
+    /**
+     * @implements encode
+     */
+    virtual bool encode(const char* data
+                        , size_t len
+                        , FilterMode::type mode
+                        , std::vector<char>& output);
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+    /**
+     * ԭʼֽѹֽ( ֡ͷ )
+     */
+    uint64_t bytesIn() const;
+
+    uint64_t bytesOut() const;
+
+    enum
+    {
+        HEADER_SIZE = 7,
+        /// һ decode() , Ƚϲ
+        MAX_DECODE_OUTPUT = 256*1024
+    };
+
+private:
+    NOCOPY(CompressionFilter);
+
+    void encodeBlock(const char* data, size_t len, std::vector<char>& output);
+    bool decodeFrame(const char* frame, size_t len, std::vector<char>& output);
+
+    /// ڴյĿ
+    std::vector<char> block_;
+    /// ֡
+    std::vector<char> partial_;
+    /// Ҫ鲻ѹ
+    size_t skip_;
+    /// ´ѹĿʱĿ
+    size_t backoff_;
+
+    uint64_t bytesIn_;
+    uint64_t bytesOut_;
+    tstring toString_;
+};
+
+class CompressionFilterFactory : public IFilterFactory
+{
+public:
+
+    CompressionFilterFactory();
+
+    /**
+     * @implements createFilter
+     */
+    virtual IFilter* createFilter();
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(CompressionFilterFactory);
+
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif // _CompressionFilter_H_
@@ -0,0 +1,363 @@
+
+# include "pro_config.h"
+# include <stdlib.h>
+# include "jingxian/networks/filters/lz4.h"
+# include "jingxian/networks/filters/CompressionFilter.h"
+# include "jingxian/networks/filters/FilterTransport.h"
+# include "jingxian/networks/LoopbackTransport.h"
+
+#ifdef _GOOGLETEST_
+#include <gtest/gtest.h>
+#else
+#include "jingxian/utilities/unittest.h"
+#endif
+
+namespace
+{
+    /**
+     * ־ HTTP ͷһѹ
+     */
+    std::string textPayload(size_t len)
+    {
+        static const char* words[] = { "GET ", "/index.html ", "HTTP/1.1\r\n", "Host: ", "example.com\r\n"
+                                       , "Content-Length: ", "1024", "\r\n", "Connection: keep-alive\r\n" };
+        std::string result;
+        for (size_t i = 0; result.size() < len; ++ i)
+            result += words[(i * 7 + i / 3) % (sizeof(words) / sizeof(words[0]))];
+        result.resize(len);
+        return result;
+    }
+
+    /**
+     * һѹ
+     */
+    std::string randomPayload(size_t len)
+    {
+        std::string result(len, '\0');
+        uint32_t seed = 2463534242U;
+        for (size_t i = 0; i < len; ++ i)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            result[i] = (char)(seed & 0xFF);
+        }
+        return result;
+    }
+
+    bool roundTrip(const std::string& data)
+    {
+        std::vector<char> compressed(lz4::bound(data.size()));
+        size_t len = lz4::compress(data.data(), data.size(), &compressed[0], compressed.size());
+        if (0 == len)
+            return false;
+
+        std::string result(data.size(), '\0');
+        if (!lz4::decompress(&compressed[0], len, data.empty() ? null_ptr : &result[0], data.size()))
+            return false;
+        return data == result;
+    }
+
+    class RecordProtocolFactory : public IProtocolFactory
+    {
+    public:
+        virtual IProtocol* createProtocol(ITransport* transport, IReactorCore* core)
+        {
+            return &protocol;
+        }
+
+        virtual bool configure(configure::Context& context, const tstring& t)
+        {
+            return false;
+        }
+
+        virtual const tstring& toString() const
+        {
+            return protocol.toString();
+        }
+
+        RecordProtocol protocol;
+    };
+
+    /**
+     * ˶ѹ,  FilterProtocolFactory  stages 
+     */
+    struct FilterPair
+    {
+        FilterPair(TimerQueue& timers, size_t stages)
+                : timers_(timers)
+                , factory_(&timers, &server_)
+        {
+            for (size_t i = 0; i < stages; ++ i)
+                factory_.push(new CompressionFilterFactory());
+            serverLower.bindProtocol(factory_.createProtocol(&serverLower, null_ptr));
+
+            // ͻֹ𼶰װ
+            ITransport* lower = &clientLower;
+            for (size_t i = 0; i < stages; ++ i)
+            {
+                FilterTransport* stage = new FilterTransport(null_ptr, new CompressionFilter(), &timers, lower);
+                if (0 == i)
+                    clientLower.bindProtocol(stage);
+                else
+                    ((FilterTransport*)lower)->bindProtocol(stage);
+                lower = stage;
+            }
+            client = (FilterTransport*)lower;
+            client->bindProtocol(&clientProtocol);
+
+            serverLower.initialize();
+            clientLower.initialize();
+        }
+
+        ~FilterPair()
+        {
+            serverLower.closed();
+            clientLower.closed();
+        }
+
+        RecordProtocol& serverProtocol()
+        {
+            return server_.protocol;
+        }
+
+        void write(const char* data, size_t len)
+        {
+            databuffer_t* buffer = (databuffer_t*)my_calloc(1, sizeof(databuffer_t) + len);
+            buffer->chain.type = BUFFER_ELEMENT_MEMORY;
+            buffer->capacity = len;
+            buffer->start = buffer->ptr;
+            buffer->end = buffer->ptr + len;
+            memcpy(buffer->ptr, data, len);
+            client->write(cast_to_buffer_chain(buffer));
+        }
+
+        void pump()
+        {
+            for (;;)
+            {
+                timers_.runExpired();
+                size_t len = clientLower.deliver(serverLower);
+                len += serverLower.deliver(clientLower);
+                if (0 == len && 0 == timers_.size())
+                    return;
+            }
+        }
+
+        LoopbackTransport serverLower;
+        LoopbackTransport clientLower;
+        RecordProtocol clientProtocol;
+        FilterTransport* client;
+
+    private:
+        TimerQueue& timers_;
+        RecordProtocolFactory server_;
+        FilterProtocolFactory factory_;
+    };
+}
+
+TEST(filter, lz4)
+{
+    ASSERT_TRUE(roundTrip(""));
+    ASSERT_TRUE(roundTrip("a"));
+    ASSERT_TRUE(roundTrip("abcdefghijkl"));
+    ASSERT_TRUE(roundTrip(std::string(1000, 'a')));
+    ASSERT_TRUE(roundTrip(textPayload(lz4::MAX_BLOCK)));
+    ASSERT_TRUE(roundTrip(randomPayload(lz4::MAX_BLOCK)));
+    for (size_t len = 1; len < 300; len += 7)
+        ASSERT_TRUE(roundTrip(textPayload(len)));
+
+    // ѹѹһ
+    std::string text = textPayload(lz4::MAX_BLOCK);
+    std::vector<char> compressed(lz4::bound(text.size()));
+    size_t len = lz4::compress(text.data(), text.size(), &compressed[0], compressed.size());
+    ASSERT_TRUE(0 != len && len < text.size() / 2);
+
+    // Ŀ껺̫Сʱ 0
+    ASSERT_TRUE(0 == lz4::compress(text.data(), text.size(), &compressed[0], 100));
+
+    // ݲԽ
+    std::string result(text.size(), '\0');
+    ASSERT_FALSE(lz4::decompress(&compressed[0], len, &result[0], text.size() - 1));
+    ASSERT_FALSE(lz4::decompress(&compressed[0], len / 2, &result[0], text.size()));
+    compressed[1] = (char)0xFF;
+    compressed[2] = (char)0xFF;
+    ASSERT_FALSE(lz4::decompress(&compressed[0], len, &result[0], text.size()));
+}
+
+TEST(filter, compression)
+{
+    std::string text = textPayload(200*1000);
+    std::string random = randomPayload(200*1000);
+
+    for (int kind = 0; kind < 2; ++ kind)
+    {
+        const std::string& data = (0 == kind) ? text : random;
+
+        // ֿд,  flush
+        CompressionFilter encoder;
+        std::vector<char> wire;
+        for (size_t offset = 0; offset < data.size();)
+        {
+            size_t len = 1 + (offset * 31) % 20000;
+            if (len > data.size() - offset)
+                len = data.size() - offset;
+            ASSERT_TRUE(encoder.encode(data.data() + offset, len, FilterMode::normal, wire));
+            offset += len;
+        }
+        ASSERT_TRUE(encoder.encode(null_ptr, 0, FilterMode::flush, wire));
+        ASSERT_TRUE(wire.size() == encoder.bytesOut());
+        if (0 == kind)
+        {
+            ASSERT_TRUE(wire.size() < data.size() / 2);
+        }
+        else
+        {
+            ASSERT_TRUE(wire.size() <= data.size() + 4 * CompressionFilter::HEADER_SIZE);
+        }
+
+        // ķֶν
+        CompressionFilter decoder;
+        std::vector<char> output;
+        for (size_t offset = 0; offset < wire.size();)
+        {
+            size_t len = 1 + (offset * 17) % 3000;
+            if (len > wire.size() - offset)
+                len = wire.size() - offset;
+
+            size_t used = 0;
+            while (used < len)
+            {
+                size_t consumed = 0;
+                ASSERT_TRUE(decoder.decode(&wire[offset + used], len - used, consumed, output));
+                used += consumed;
+            }
+            offset += len;
+        }
+        ASSERT_TRUE(data == std::string(output.begin(), output.end()));
+    }
+
+    // ֡ͷ
+    CompressionFilter decoder;
+    std::vector<char> output;
+    size_t consumed = 0;
+    ASSERT_FALSE(decoder.decode("\x07\x01\x00\x00\x01\x00\x00", 7, consumed, output));
+}
+
+TEST(filter, pipeline)
+{
+    TimerQueue timers;
+    FilterPair pair(timers, 2);
+    ASSERT_TRUE(pair.clientProtocol.connected);
+    ASSERT_TRUE(pair.serverProtocol().connected);
+
+    // ¼֮дڶʱһ
+    std::string expected;
+    for (int i = 0; i < 100; ++ i)
+    {
+        pair.write("hello world ", 12);
+        expected += "hello world ";
+    }
+    ASSERT_TRUE(pair.clientLower.wire.empty());
+    pair.pump();
+    ASSERT_TRUE(expected == pair.serverProtocol().data);
+
+    std::string bulk = textPayload(500*1000);
+    pair.write(bulk.data(), bulk.size());
+    pair.pump();
+    ASSERT_TRUE(expected + bulk == pair.serverProtocol().data);
+
+    pair.client->disconnection();
+    ASSERT_TRUE(pair.clientLower.disconnected);
+}
+
+TEST(filter, backlog)
+{
+    TimerQueue timers;
+    FilterPair pair(timers, 1);
+    RecordProtocol& server = pair.serverProtocol();
+    FilterTransport* filter = (FilterTransport*)pair.serverLower.protocol_;
+
+    // ϲһֽҲȡ, ѹ MAX_BACKLOG ²ֹͣȡ
+    server.hold = true;
+    std::string bulk = textPayload(2 * FilterTransport::MAX_BACKLOG);
+    pair.write(bulk.data(), bulk.size());
+    pair.pump();
+    ASSERT_FALSE(pair.serverLower.reading);
+    ASSERT_TRUE(server.data.empty());
+
+    // ֮ڶԷ, ӱ˵ڴ
+    std::string more = textPayload(1000);
+    pair.write(more.data(), more.size());
+    pair.pump();
+    ASSERT_FALSE(pair.clientLower.wire.empty());
+    bulk += more;
+
+    // ϲָ, ѹڶʱн, Ȼ²ָȡ
+    server.hold = false;
+    filter->startReading();
+    pair.pump();
+    ASSERT_TRUE(pair.serverLower.reading);
+    ASSERT_TRUE(pair.clientLower.wire.empty());
+    ASSERT_TRUE(bulk == server.data);
+}
+
+#ifndef _GOOGLETEST_
+
+BENCHMARK(lz4_compress_text)
+{
+    std::string data = textPayload(lz4::MAX_BLOCK);
+    std::vector<char> compressed(lz4::bound(data.size()));
+    size_t len = 0;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        len += lz4::compress(data.data(), data.size(), &compressed[0], compressed.size());
+    state.setBytesProcessed(data.size() * state.iterations());
+    DO_NOT_OPTIMIZE(len);
+}
+
+BENCHMARK(lz4_decompress_text)
+{
+    std::string data = textPayload(lz4::MAX_BLOCK);
+    std::vector<char> compressed(lz4::bound(data.size()));
+    size_t len = lz4::compress(data.data(), data.size(), &compressed[0], compressed.size());
+    std::string result(data.size(), '\0');
+    bool ok = true;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        ok = lz4::decompress(&compressed[0], len, &result[0], result.size()) && ok;
+    state.setBytesProcessed(data.size() * state.iterations());
+    DO_NOT_OPTIMIZE(ok);
+}
+
+BENCHMARK(filter_relay_text)
+{
+    TimerQueue timers;
+    FilterPair pair(timers, 1);
+    pair.serverProtocol().keep = false;
+
+    std::string data = textPayload(256*1024);
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        pair.write(data.data(), data.size());
+        pair.pump();
+    }
+    state.setBytesProcessed(data.size() * state.iterations());
+    DO_NOT_OPTIMIZE(pair.serverProtocol().received);
+}
+
+BENCHMARK(filter_relay_random)
+{
+    TimerQueue timers;
+    FilterPair pair(timers, 1);
+    pair.serverProtocol().keep = false;
+
+    std::string data = randomPayload(256*1024);
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        pair.write(data.data(), data.size());
+        pair.pump();
+    }
+    state.setBytesProcessed(data.size() * state.iterations());
+    DO_NOT_OPTIMIZE(pair.serverProtocol().received);
+}
+
+#endif // _GOOGLETEST_
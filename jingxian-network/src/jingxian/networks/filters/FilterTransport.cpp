@@ -0,0 +1,431 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/filters/FilterTransport.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/IReactorCore.h"
+
+_jingxian_begin
+
+namespace
+{
+    /// ʱ¼, Ϸȥ
+    const size_t MAX_OUTPUT = 64*1024;
+
+    /// ӶݵĻС
+    const size_t RECEIVE_SIZE = 4*1024;
+}
+
+FilterTransport::FilterTransport(IReactorCore* core
+                                 , IFilter* filter
+                                 , TimerQueue* timers
+                                 , ITransport* transport)
+        : core_(core)
+        , filter_(filter)
+        , timers_(timers)
+        , transport_(transport)
+        , protocol_(null_ptr)
+        , plainStart_(0)
+        , charge_(MemoryKind::Receive)
+        , isInitialize_(false)
+        , dispatching_(false)
+        , shutdowning_(false)
+        , stopped_(false)
+        , paused_(false)
+{
+    if (is_null(filter))
+        ThrowException1(ArgumentNullException, _T("filter"));
+    if (is_null(transport))
+        ThrowException1(ArgumentNullException, _T("transport"));
+
+    flushTimer_.initialize(this, &FilterTransport::flush);
+    resumeTimer_.initialize(this, &FilterTransport::resume);
+    toString_ = concat<tstring>(filter_->toString(), _T("["), transport_->toString(), _T("]"));
+}
+
+FilterTransport::~FilterTransport()
+{
+    timers_->cancel(&flushTimer_);
+    timers_->cancel(&resumeTimer_);
+}
+
+void FilterTransport::initialize()
+{
+    if (isInitialize_)
+        return;
+
+    isInitialize_ = true;
+    transport_->bindProtocol(this);
+    transport_->initialize();
+}
+
+IProtocol* FilterTransport::bindProtocol(IProtocol* protocol)
+{
+    IProtocol* old = protocol_;
+    protocol_ = protocol;
+    return old;
+}
+
+void FilterTransport::startReading()
+{
+    stopped_ = false;
+    if (!paused_)
+        transport_->startReading();
+
+    // ϲϴûȡݲٴ², Ҫ¼֮ٽ
+    if (plainStart_ != plain_.size() && !resumeTimer_.isScheduled())
+        timers_->schedule(&resumeTimer_, 0);
+}
+
+void FilterTransport::stopReading()
+{
+    stopped_ = true;
+    transport_->stopReading();
+}
+
+void FilterTransport::write(buffer_chain_t* buffer)
+{
+    writeBatch(&buffer, 1);
+}
+
+void FilterTransport::writeBatch(buffer_chain_t** buffers, size_t len)
+{
+    if (is_null(buffers))
+        ThrowException1(ArgumentNullException, _T("buffers"));
+
+    for (size_t i = 0; i < len; ++ i)
+    {
+        buffer_chain_t* buffer = buffers[i];
+        if (is_null(buffer))
+            ThrowException1(ArgumentNullException, _T("buffer"));
+
+        if (!isMemory(buffer))
+        {
+            freebuffer(buffer);
+            ThrowException1(IllegalArgumentException, _T("ֻܴڴݿ"));
+        }
+
+        if (!shutdowning_ && !filter_->encode(rd_ptr(buffer), rd_length(buffer), FilterMode::normal, output_))
+            fail(concat<tstring>(filter_->toString(), _T(" ת͵ʧ")));
+        freebuffer(buffer);
+    }
+
+    if (shutdowning_)
+        return;
+
+    account();
+    if (output_.size() >= MAX_OUTPUT)
+        send(FilterMode::normal);
+
+    if (!dispatching_ && !flushTimer_.isScheduled())
+        timers_->schedule(&flushTimer_, 0);
+}
+
+void FilterTransport::shapeAs(const tstring& user, bool upload)
+{
+    transport_->shapeAs(user, upload);
+}
+
+void FilterTransport::disconnection()
+{
+    disconnection(_T("ûر"));
+}
+
+void FilterTransport::disconnection(const tstring& error)
+{
+    if (shutdowning_)
+        return;
+
+    if (flushTimer_.isScheduled())
+        timers_->cancel(&flushTimer_);
+    if (resumeTimer_.isScheduled())
+        timers_->cancel(&resumeTimer_);
+    send(FilterMode::finished);
+    shutdowning_ = true;
+
+    transport_->disconnection(error);
+}
+
+const tstring& FilterTransport::host() const
+{
+    return transport_->host();
+}
+
+const tstring& FilterTransport::peer() const
+{
+    return transport_->peer();
+}
+
+time_t FilterTransport::timeout() const
+{
+    return transport_->timeout();
+}
+
+const tstring& FilterTransport::toString() const
+{
+    return toString_;
+}
+
+void FilterTransport::onTimeout(ProtocolContext& context)
+{
+    if (!is_null(protocol_))
+        protocol_->onTimeout(context_);
+}
+
+void FilterTransport::onConnected(ProtocolContext& context)
+{
+    context_.initialize(core_, this);
+    if (!is_null(protocol_))
+        protocol_->onConnected(context_);
+}
+
+void FilterTransport::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+{
+    timers_->cancel(&flushTimer_);
+    timers_->cancel(&resumeTimer_);
+
+    IProtocol* protocol = protocol_;
+    if (!is_null(protocol))
+        protocol->onDisconnected(context_, errCode, reason);
+
+    delete this;
+}
+
+size_t FilterTransport::onReceived(ProtocolContext& context)
+{
+    if (shutdowning_)
+        return context.inBytes();
+
+    dispatching_ = true;
+
+    // ȰϴλѹĽϲ, ٽµ
+    deliver();
+
+    const std::vector<io_mem_buf>& segments = context.inMemory();
+    for (std::vector<io_mem_buf>::const_iterator it = segments.begin()
+            ; !shutdowning_ && it != segments.end(); ++ it)
+    {
+        size_t offset = 0;
+        while (!shutdowning_ && offset < it->len)
+        {
+            size_t consumed = 0;
+            if (!filter_->decode(it->buf + offset, it->len - offset, consumed, plain_))
+            {
+                dispatching_ = false;
+                fail(concat<tstring>(filter_->toString(), _T(" תյʧ")));
+                return context.inBytes();
+            }
+
+            offset += consumed;
+            deliver();
+        }
+    }
+
+    dispatching_ = false;
+    if (shutdowning_)
+        return context.inBytes();
+
+    account();
+    throttle();
+    flush();
+    return context.inBytes();
+}
+
+databuffer_t* FilterTransport::createBuffer(const ProtocolContext& context)
+{
+    // յתǰ, ϲЭҪĻ޹
+    databuffer_t* result = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + RECEIVE_SIZE, MemoryKind::Receive);
+    result->chain.type = BUFFER_ELEMENT_MEMORY;
+    result->capacity = RECEIVE_SIZE;
+    result->start = result->end = result->ptr;
+    return result;
+}
+
+size_t FilterTransport::memory() const
+{
+    size_t bytes = charge_.bytes();
+    if (!is_null(protocol_))
+        bytes += protocol_->memory();
+    return bytes;
+}
+
+void FilterTransport::flush()
+{
+    if (flushTimer_.isScheduled())
+        timers_->cancel(&flushTimer_);
+
+    if (!shutdowning_)
+        send(FilterMode::flush);
+}
+
+IFilter& FilterTransport::filter()
+{
+    return *filter_;
+}
+
+void FilterTransport::deliver()
+{
+    if (is_null(protocol_) || plainStart_ == plain_.size())
+        return;
+
+    std::vector<io_mem_buf> ioBuf(1);
+    ioBuf[0].buf = &plain_[plainStart_];
+    ioBuf[0].len = (u_long)(plain_.size() - plainStart_);
+    context_.inMemory(&ioBuf, ioBuf[0].len);
+
+    plainStart_ += protocol_->onReceived(context_);
+    if (plainStart_ == plain_.size())
+    {
+        plain_.clear();
+        plainStart_ = 0;
+    }
+    else if (plainStart_ * 2 >= plain_.size())
+    {
+        plain_.erase(plain_.begin(), plain_.begin() + plainStart_);
+        plainStart_ = 0;
+    }
+}
+
+void FilterTransport::resume()
+{
+    if (shutdowning_)
+        return;
+
+    dispatching_ = true;
+    deliver();
+    dispatching_ = false;
+    if (shutdowning_)
+        return;
+
+    account();
+    throttle();
+    flush();
+}
+
+void FilterTransport::throttle()
+{
+    size_t backlog = plain_.size() - plainStart_;
+    if (!paused_ && backlog >= MAX_BACKLOG)
+    {
+        // ϲȡ̫, Ȳ², ݻѹ²Ľջ
+        paused_ = true;
+        transport_->stopReading();
+    }
+    else if (paused_ && backlog < MAX_BACKLOG / 2)
+    {
+        paused_ = false;
+        if (!stopped_)
+            transport_->startReading();
+    }
+}
+
+void FilterTransport::account()
+{
+    charge_.update(plain_.capacity() + output_.capacity());
+}
+
+void FilterTransport::send(FilterMode::type mode)
+{
+    if (FilterMode::normal != mode && !filter_->encode(null_ptr, 0, mode, output_))
+    {
+        fail(concat<tstring>(filter_->toString(), _T(" ת͵ʧ")));
+        return;
+    }
+
+    if (output_.empty())
+        return;
+
+    databuffer_t* buffer = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + output_.size(), MemoryKind::Send);
+    buffer->chain.type = BUFFER_ELEMENT_MEMORY;
+    buffer->capacity = output_.size();
+    buffer->start = buffer->ptr;
+    buffer->end = buffer->ptr + output_.size();
+    memcpy(buffer->ptr, &output_[0], output_.size());
+    output_.clear();
+
+    transport_->write(cast_to_buffer_chain(buffer));
+}
+
+void FilterTransport::fail(const tstring& reason)
+{
+    if (shutdowning_)
+        return;
+
+    shutdowning_ = true;
+    output_.clear();
+    transport_->disconnection(reason);
+}
+
+FilterProtocolFactory::FilterProtocolFactory(TimerQueue* timers, IProtocolFactory* factory)
+        : timers_(timers)
+        , factory_(factory)
+{
+    if (is_null(factory))
+        ThrowException1(ArgumentNullException, _T("factory"));
+
+    toString_ = factory_->toString();
+}
+
+FilterProtocolFactory::~FilterProtocolFactory()
+{
+    for (std::vector<IFilterFactory*>::iterator it = filters_.begin()
+            ; it != filters_.end(); ++ it)
+        delete *it;
+}
+
+void FilterProtocolFactory::push(IFilterFactory* filter)
+{
+    if (is_null(filter))
+        ThrowException1(ArgumentNullException, _T("filter"));
+
+    filters_.push_back(filter);
+
+    toString_.clear();
+    for (std::vector<IFilterFactory*>::iterator it = filters_.begin()
+            ; it != filters_.end(); ++ it)
+        toString_ += (*it)->toString() + _T(" > ");
+    toString_ += factory_->toString();
+}
+
+size_t FilterProtocolFactory::size() const
+{
+    return filters_.size();
+}
+
+IProtocol* FilterProtocolFactory::createProtocol(ITransport* transport, IReactorCore* core)
+{
+    // ƬϵҪ÷ƬԼĶʱ
+    TimerQueue* timers = is_null(core) ? timers_ : &(core->timers());
+
+    // 𼶰װ, һΪ transport Э
+    IProtocol* bottom = null_ptr;
+    FilterTransport* top = null_ptr;
+    for (std::vector<IFilterFactory*>::iterator it = filters_.begin()
+            ; it != filters_.end(); ++ it)
+    {
+        ITransport* lower = is_null(top) ? transport : top;
+        FilterTransport* stage = new FilterTransport(core, (*it)->createFilter(), timers, lower);
+        if (is_null(top))
+            bottom = stage;
+        else
+            top->bindProtocol(stage);
+        top = stage;
+    }
+
+    if (is_null(top))
+        return factory_->createProtocol(transport, core);
+
+    top->bindProtocol(factory_->createProtocol(top, core));
+    return bottom;
+}
+
+bool FilterProtocolFactory::configure(configure::Context& context, const tstring& t)
+{
+    return factory_->configure(context, t);
+}
+
+const tstring& FilterProtocolFactory::toString() const
+{
+    return toString_;
+}
+
+_jingxian_end
@@ -0,0 +1,270 @@
+
+#ifndef _FilterTransport_H_
+#define _FilterTransport_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <memory>
+# include <vector>
+# include "jingxian/ITransport.h"
+# include "jingxian/IProtocol.h"
+# include "jingxian/IFilter.h"
+# include "jingxian/buffer/MemoryAccount.h"
+# include "jingxian/networks/TCPContext.h"
+# include "jingxian/networks/TimerQueue.h"
+
+_jingxian_begin
+
+/**
+ * еһ, һ IFilter ת²ϵ
+ *
+ *  TLSTransport һ, ² IProtocol, ϲ ITransport, ༶
+ * Ե. ϲһ¼едȽ, ʱҪ
+ * ; ¼֮дڱ¼ѭʱ.
+ *
+ * ²յȫ, ϲûȡߵĳ MAX_BACKLOG ʱͣ²
+ * Ķȡ, һʱָ, ϲ㲻ñ²ڴ.
+ * ϲûȡʱ, Ҫܼʱ startReading(), ʣµݻ
+ * ¼ѭʱٽ.
+ * ²ӶϿԶɾ.
+ */
+class FilterTransport : public ITransport, public IProtocol
+{
+public:
+    /**
+     * @param[ in ] core ϲЭ IReactorCore
+     * @param[ in ] filter Ĺ, 鱾
+     * @param[ in ] timers ƳĶʱ
+     * @param[ in ] transport ²
+     */
+    FilterTransport(IReactorCore* core
+                    , IFilter* filter
+                    , TimerQueue* timers
+                    , ITransport* transport);
+
+    virtual ~FilterTransport();
+
+    /**
+     * @implements initialize
+     */
+    virtual void initialize();
+
+    /**
+     * @implements bindProtocol
+     */
+    virtual IProtocol* bindProtocol(IProtocol* protocol);
+
+    /**
+     * @implements startReading
+     */
+    virtual void startReading();
+
+    /**
+     * @implements stopReading
+     */
+    virtual void stopReading();
+
+    /**
+     * @implements write
+     */
+    virtual void write(buffer_chain_t* buffer);
+    virtual void writeBatch(buffer_chain_t** buffers, size_t len);
+
+    /**
+     * @implements shapeAs
+     */
+    virtual void shapeAs(const tstring& user, bool upload);
+
+    /**
+     * @implements disconnection
+     */
+    virtual void disconnection();
+    virtual void disconnection(const tstring& error);
+
+    /**
+     * @implements host
+     */
+    virtual const tstring& host() const;
+
+    /**
+     * @implements peer
+     */
+    virtual const tstring& peer() const;
+
+    /**
+     * @implements timeout
+     */
+    virtual time_t timeout() const;
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+    /**
+     * @implements onTimeout
+     */
+    virtual void onTimeout(ProtocolContext& context);
+
+    /**
+     * @implements onConnected
+     */
+    virtual void onConnected(ProtocolContext& context);
+
+    /**
+     * @implements onDisconnected
+     */
+    virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason);
+
+    /**
+     * @implements onReceived
+     */
+    virtual size_t onReceived(ProtocolContext& context);
+
+    /**
+     * @implements createBuffer
+     */
+    virtual databuffer_t* createBuffer(const ProtocolContext& context);
+
+    /**
+     * @implements memory
+     */
+    virtual size_t memory() const;
+
+    /**
+     * л
+     */
+    void flush();
+
+    IFilter& filter();
+
+    /// ϲûȡߵݳʱͣ
+    enum { MAX_BACKLOG = 1024*1024 };
+
+private:
+    NOCOPY(FilterTransport);
+
+    class EventTimer : public Timer
+    {
+    public:
+        typedef void (FilterTransport::*Handler)();
+
+        EventTimer()
+                : owner_(null_ptr)
+                , handler_(null_ptr)
+        {
+        }
+
+        void initialize(FilterTransport* owner, Handler handler)
+        {
+            owner_ = owner;
+            handler_ = handler;
+        }
+
+        virtual void onTimeout()
+        {
+            (owner_->*handler_)();
+        }
+
+    private:
+        FilterTransport* owner_;
+        Handler handler_;
+    };
+
+    void deliver();
+    void resume();
+    void throttle();
+    void account();
+    void send(FilterMode::type mode);
+    void fail(const tstring& reason);
+
+    IReactorCore* core_;
+    std::auto_ptr<IFilter> filter_;
+    TimerQueue* timers_;
+    ITransport* transport_;
+    IProtocol* protocol_;
+
+    /// ϲЭ
+    TCPContext context_;
+
+    /// ûбϲȡߵ
+    std::vector<char> plain_;
+    size_t plainStart_;
+    /// Ĵ
+    std::vector<char> output_;
+    /// plain_  output_ ռõڴ
+    MemoryCharge charge_;
+    EventTimer flushTimer_;
+    /// ϲûȡٽ
+    EventTimer resumeTimer_;
+
+    bool isInitialize_;
+    /// ڴ²¼, ڼдڴʱһ
+    bool dispatching_;
+    bool shutdowning_;
+    /// ϲ stopReading()
+    bool stopped_;
+    /// Ϊϲûȡߵ̫ͣ²Ķȡ
+    bool paused_;
+
+    tstring toString_;
+};
+
+/**
+ * һЭ鹤һ
+ *
+ *  "listen tcp://0.0.0.0:1081 proxy lz4" ʱ, ÿ
+ * ConnectedSocket, lz4  FilterTransport,  proxy Э.
+ */
+class FilterProtocolFactory : public IProtocolFactory
+{
+public:
+
+    /**
+     * @param[ in ] timers ƳõĶʱ
+     * @param[ in ] factory ϲЭĹ( ӵ )
+     */
+    FilterProtocolFactory(TimerQueue* timers, IProtocolFactory* factory);
+
+    virtual ~FilterProtocolFactory();
+
+    /**
+     * еĹ֮ټһ, 鱾
+     */
+    void push(IFilterFactory* filter);
+
+    size_t size() const;
+
+    /**
+     * @implements createProtocol
+     */
+    virtual IProtocol* createProtocol(ITransport* transport, IReactorCore* core);
+
+    /**
+     * @implements configure
+     */
+    virtual bool configure(configure::Context& context, const tstring& t);
+
+    /**
+     * @implements toString
+     */
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(FilterProtocolFactory);
+
+    TimerQueue* timers_;
+    IProtocolFactory* factory_;
+    /// еĹ
+    std::vector<IFilterFactory*> filters_;
+    tstring toString_;
+};
+
+_jingxian_end
+
+#endif //_FilterTransport_H_
@@ -0,0 +1,207 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/filters/lz4.h"
+
+_jingxian_begin
+
+namespace lz4
+{
+namespace
+{
+    const size_t MIN_MATCH = 4;
+    ///  5 ֽ
+    const size_t LAST_LITERALS = 5;
+    /// һƥڽβ 12 ֽ֮ǰʼ
+    const size_t MF_LIMIT = 12;
+    const int HASH_LOG = 12;
+
+    inline uint32_t read32(const unsigned char* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761U) >> (32 - HASH_LOG);
+    }
+
+    /**
+     * д볬 15 ĳ, ÿֽ 255, һֽ
+     */
+    inline unsigned char* writeLength(unsigned char* op, size_t len)
+    {
+        for (; len >= 255; len -= 255)
+            *op++ = 255;
+        *op++ = (unsigned char)len;
+        return op;
+    }
+
+    inline bool readLength(const unsigned char*& ip, const unsigned char* end, size_t& len)
+    {
+        unsigned char s;
+        do
+        {
+            if (ip >= end)
+                return false;
+            s = *ip++;
+            len += s;
+        }
+        while (255 == s);
+        return true;
+    }
+
+    /**
+     * дһ: , , Լѡƥ
+     */
+    unsigned char* writeSequence(unsigned char* op
+                                 , unsigned char* end
+                                 , const unsigned char* literals
+                                 , size_t literalLen
+                                 , size_t offset
+                                 , size_t matchLen)
+    {
+        size_t need = 1 + literalLen + literalLen / 255 + 1
+                      + ((0 == offset) ? 0 : (2 + matchLen / 255 + 1));
+        if ((size_t)(end - op) < need)
+            return null_ptr;
+
+        unsigned char* token = op++;
+        *token = (unsigned char)(((literalLen >= 15) ? 15 : literalLen) << 4);
+        if (literalLen >= 15)
+            op = writeLength(op, literalLen - 15);
+        memcpy(op, literals, literalLen);
+        op += literalLen;
+
+        if (0 == offset)
+            return op;
+
+        *op++ = (unsigned char)(offset & 0xFF);
+        *op++ = (unsigned char)(offset >> 8);
+
+        size_t len = matchLen - MIN_MATCH;
+        *token |= (unsigned char)((len >= 15) ? 15 : len);
+        if (len >= 15)
+            op = writeLength(op, len - 15);
+        return op;
+    }
+}
+
+size_t compress(const char* src, size_t len, char* dst, size_t capacity)
+{
+    const unsigned char* base = (const unsigned char*)src;
+    const unsigned char* ip = base;
+    const unsigned char* anchor = base;
+    const unsigned char* end = base + len;
+    unsigned char* op = (unsigned char*)dst;
+    unsigned char* opEnd = op + capacity;
+
+    if (len > MAX_BLOCK)
+        return 0;
+
+    if (len > MF_LIMIT)
+    {
+        const unsigned char* matchLimit = end - LAST_LITERALS;
+        const unsigned char* mfLimit = end - MF_LIMIT;
+        uint16_t table[1 << HASH_LOG];
+        memset(table, 0, sizeof(table));
+
+        ++ ip;
+        while (ip < mfLimit)
+        {
+            uint32_t sequence = read32(ip);
+            uint32_t h = hash(sequence);
+            const unsigned char* candidate = base + table[h];
+            table[h] = (uint16_t)(ip - base);
+
+            if (candidate >= ip || sequence != read32(candidate))
+            {
+                // ʱҲƥʱӴ󲽳, ѹݺܿɨȥ
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const unsigned char* m = ip + MIN_MATCH;
+            const unsigned char* c = candidate + MIN_MATCH;
+            while (m < matchLimit && *m == *c)
+            {
+                ++ m;
+                ++ c;
+            }
+
+            op = writeSequence(op, opEnd, anchor, ip - anchor, ip - candidate, m - ip);
+            if (is_null(op))
+                return 0;
+
+            ip = m;
+            anchor = ip;
+            if (ip < mfLimit)
+                table[hash(read32(ip - 2))] = (uint16_t)(ip - 2 - base);
+        }
+    }
+
+    op = writeSequence(op, opEnd, anchor, end - anchor, 0, 0);
+    if (is_null(op))
+        return 0;
+    return op - (unsigned char*)dst;
+}
+
+bool decompress(const char* src, size_t srcLen, char* dst, size_t len)
+{
+    const unsigned char* ip = (const unsigned char*)src;
+    const unsigned char* ipEnd = ip + srcLen;
+    unsigned char* op = (unsigned char*)dst;
+    unsigned char* opEnd = op + len;
+
+    while (ip < ipEnd)
+    {
+        unsigned char token = *ip++;
+
+        size_t literalLen = token >> 4;
+        if (15 == literalLen && !readLength(ip, ipEnd, literalLen))
+            return false;
+        if (literalLen > (size_t)(ipEnd - ip) || literalLen > (size_t)(opEnd - op))
+            return false;
+        if (0 != literalLen)
+            memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        // һֻ
+        if (ip == ipEnd)
+            break;
+
+        if (2 > ipEnd - ip)
+            return false;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (0 == offset || offset > (size_t)(op - (unsigned char*)dst))
+            return false;
+
+        size_t matchLen = token & 15;
+        if (15 == matchLen && !readLength(ip, ipEnd, matchLen))
+            return false;
+        matchLen += MIN_MATCH;
+        if (matchLen > (size_t)(opEnd - op))
+            return false;
+
+        // ƥԺص( ظֽ ), ʱֻֽڸ
+        const unsigned char* match = op - offset;
+        if (offset >= matchLen)
+        {
+            memcpy(op, match, matchLen);
+            op += matchLen;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLen; ++ i)
+                *op++ = *match++;
+        }
+    }
+
+    return op == opEnd;
+}
+}
+
+_jingxian_end
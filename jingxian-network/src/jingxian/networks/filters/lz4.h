@@ -0,0 +1,55 @@
+
+#ifndef _lz4_H_
+#define _lz4_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+
+_jingxian_begin
+
+/**
+ * LZ4 ʽѹͽѹ( ֡ʽ )
+ *
+ * ֻʵ˿ٵ̰ƥ, ͹ٷ LZ4 ʽ. һ 64K, ƥ
+ * Ҳ 64K, Թϣб 16 λƫƾ͹.
+ */
+namespace lz4
+{
+/// һ󳤶
+const size_t MAX_BLOCK = 64*1024;
+
+/**
+ * ѹܵĳ
+ */
+inline size_t bound(size_t len)
+{
+    return len + len / 255 + 16;
+}
+
+/**
+ * ѹһ
+ * @param[ in ] src ԭʼ, ܳ MAX_BLOCK
+ * @param[ out ] dst ѹ
+ * @param[ in ] capacity dst ĴС
+ * @return ѹĳ, Ųʱ 0
+ */
+size_t compress(const char* src, size_t len, char* dst, size_t capacity);
+
+/**
+ * ѹһ
+ * @param[ in ] src ѹ
+ * @param[ out ] dst ѹ
+ * @param[ in ] len ѹĳ, õԭʼݵĳ
+ * @return ݸʽʱ false
+ */
+bool decompress(const char* src, size_t srcLen, char* dst, size_t len);
+}
+
+_jingxian_end
+
+#endif // _lz4_H_
@@ -11,14 +11,21 @@ ProcessManager::ProcessManager(void)
 
 ProcessManager::~ProcessManager(void)
 {
+	for(ProcessList::iterator it=processes_.begin()
+		; it != processes_.end(); ++it)
+	{
+		delete (*it);
+	}
+	processes_.clear();
 }
 
 HANDLE ProcessManager::startProcess(const tstring& filePath
 									, int argc
-									, tchar *argv[])
+									, tchar *argv[]
+									, DWORD creationFlags)
 {
 	std::auto_ptr<Process> ptr(new Process(filePath, argc, argv));
-	if(!ptr->start())
+	if(!ptr->start(creationFlags))
 	{
 		LOG_ERROR(logger_, _T(" '") 
 			<< filePath
@@ -65,27 +72,62 @@ void ProcessManager::stopProcess(HANDLE handle)
 	}
 }
 
-void ProcessManager::poll(DWORD seconds)
+void ProcessManager::removeProcess(HANDLE handle)
+{
+	for(ProcessList::iterator it=processes_.begin()
+		; it != processes_.end(); ++it)
+	{
+		if(handle != (*it)->ProcessInfo.hProcess)
+			continue;
+
+		delete (*it);
+		processes_.erase(it);
+		return;
+	}
+}
+
+Process* ProcessManager::find(HANDLE handle)
+{
+	for(ProcessList::iterator it=processes_.begin()
+		; it != processes_.end(); ++it)
+	{
+		if(handle == (*it)->ProcessInfo.hProcess)
+			return (*it);
+	}
+	return null_ptr;
+}
+
+HANDLE ProcessManager::poll(DWORD milliseconds, HANDLE interruptEvent)
 {
 	std::vector<HANDLE> handles;
+	if(NULL != interruptEvent)
+		handles.push_back(interruptEvent);
+
 	for(ProcessList::iterator it=processes_.begin()
 		; it != processes_.end(); ++ it)
 	{
 		handles.push_back((*it)->ProcessInfo.hProcess);
 	}
 
-	DWORD ret = WaitForMultipleObjects(handles.size(),&handles[0], FALSE, seconds*1000);
-	if (ret == WAIT_OBJECT_0) 
+	if(handles.empty())
 	{
-		//proctl_msg_main();
-	}
-	else if (ret == WAIT_FAILED) 
-	{
-			//LOG_ERROR(logger_, _T("ѯ 'PID=") 
-			//	<< (*it)->ProcessInfo.dwProcessId
-			//	<< _T("' ʧ - ")
-			//	<< lastError(GetLastError()));
+		Sleep(milliseconds);
+		return NULL;
 	}
+
+	if(MAXIMUM_WAIT_OBJECTS < handles.size())
+		handles.resize(MAXIMUM_WAIT_OBJECTS);
+
+	DWORD ret = WaitForMultipleObjects((DWORD)handles.size(), &handles[0], FALSE, milliseconds);
+	if (WAIT_TIMEOUT == ret) 
+		return NULL;
+
+	if (ret < WAIT_OBJECT_0 + handles.size())
+		return handles[ret - WAIT_OBJECT_0];
+
+	LOG_ERROR(logger_, _T("ѯʧ - ") 
+			<< lastError(GetLastError()));
+	return INVALID_HANDLE_VALUE;
 }
 
 ProcessList::const_iterator ProcessManager::begin() const
@@ -9,6 +9,7 @@
 #endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
 
 // Include files
+#include <list>
 #include <vector>
 #include "jingxian/string/string.h"
 #include "jingxian/logging/logging.h"
@@ -30,8 +31,10 @@ public:
 			CommandLine.push_back(_T('"'));
 			CommandLine.push_back(_T(' '));
 		}
+		CommandLine.push_back(0);
 
 		memset(&StartInfo, 0, sizeof(STARTUPINFO));
+		StartInfo.cb = sizeof(STARTUPINFO);
 		memset(&ProcessInfo, 0, sizeof(PROCESS_INFORMATION));
 		ProcessInfo.hProcess =  INVALID_HANDLE_VALUE;
 		ProcessInfo.hThread =  INVALID_HANDLE_VALUE;
@@ -51,14 +54,18 @@ public:
 		}
 	}
 
-	bool start()
+	/**
+	 * 
+	 * @param[ in ] creationFlags ӵĴ־,  CREATE_SUSPENDED
+	 */
+	bool start(DWORD creationFlags = 0)
 	{
 		return TRUE == CreateProcess(FilePath.c_str()
 					, &CommandLine[0]
 					, NULL
 					, NULL
 					, 0
-					, DETACHED_PROCESS
+					, DETACHED_PROCESS | creationFlags
 					, NULL
 					, NULL
 					, &StartInfo
@@ -97,7 +104,7 @@ public:
 	/**
 	 * һ
 	 */
-	HANDLE startProcess(const tstring& filePath, int argc, tchar *argv[]);
+	HANDLE startProcess(const tstring& filePath, int argc, tchar *argv[], DWORD creationFlags = 0);
 
 	/**
 	 * ֹͣһ
@@ -105,9 +112,23 @@ public:
 	void stopProcess(HANDLE handle);
 
 	/**
-	 * б
+	 * ɾһ˳Ľ
+	 */
+	void removeProcess(HANDLE handle);
+
+	/**
+	 * ҽ, Ҳʱ null_ptr
+	 */
+	Process* find(HANDLE handle);
+
+	/**
+	 * ȴһ˳ interruptEvent 
+	 *
+	 * @param[ in ] milliseconds ȴĺ
+	 * @param[ in ] interruptEvent ѡж¼
+	 * @return ˳Ľ̾ interruptEvent, ʱ NULL,  INVALID_HANDLE_VALUE
 	 */
-	void poll(DWORD seconds);
+	HANDLE poll(DWORD milliseconds, HANDLE interruptEvent = NULL);
 
 	ProcessList::const_iterator begin() const;
 
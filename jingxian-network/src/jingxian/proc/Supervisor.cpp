@@ -0,0 +1,553 @@
+
+# include "pro_config.h"
+# include "jingxian/proc/Supervisor.h"
+# include "jingxian/networks/MemoryBudget.h"
+# include "jingxian/networks/TrafficCapture.h"
+# include "jingxian/utilities/SamplingProfiler.h"
+
+_jingxian_begin
+
+namespace
+{
+	/// ͳƵļ
+	const DWORD STATS_INTERVAL = 60*1000;
+	/// гʱ˳ʧ
+	const DWORD STABLE_TIME = 60*1000;
+	/// ȴʱ
+	const DWORD MAX_RESTART_DELAY = 60*1000;
+	/// ֹͣʱȴ˳ʱ
+	const DWORD STOP_TIMEOUT = 3*60*1000;
+
+	tstring sharedName(DWORD pid, const tchar* suffix)
+	{
+		return concat<tstring>(_T("jingxian.supervisor."), ::toString((int)pid), suffix);
+	}
+
+	DWORD restartDelay(int failures)
+	{
+		DWORD delay = 1000 << ((6 < failures) ? 6 : failures);
+		return (MAX_RESTART_DELAY < delay) ? MAX_RESTART_DELAY : delay;
+	}
+
+	DWORD remaining(DWORD deadline, DWORD now)
+	{
+		return (0 > (LONG)(deadline - now)) ? 0 : (deadline - now);
+	}
+}
+
+Supervisor::Supervisor(size_t workers)
+: interruptEvent_(NULL)
+, stopEvent_(NULL)
+, mapping_(NULL)
+, shared_(null_ptr)
+, logger_(_T("jingxian.system.supervisor"))
+{
+	// ؽ̻Ҫȴж¼
+	if(MAXIMUM_WAIT_OBJECTS - 1 < workers)
+		workers = MAXIMUM_WAIT_OBJECTS - 1;
+
+	Worker worker;
+	memset(&worker, 0, sizeof(Worker));
+	workers_.resize(workers, worker);
+
+	tchar path[MAX_PATH];
+	DWORD len = GetModuleFileName(NULL, path, MAX_PATH);
+	executable_.assign(path, len);
+
+	interruptEvent_ = CreateEvent(NULL, TRUE, FALSE, NULL);
+	stopEvent_ = CreateEvent(NULL, TRUE, FALSE
+		, sharedName(GetCurrentProcessId(), _T(".stop")).c_str());
+}
+
+Supervisor::~Supervisor()
+{
+	if(!is_null(shared_))
+		UnmapViewOfFile(shared_);
+	if(NULL != mapping_)
+		CloseHandle(mapping_);
+	if(NULL != stopEvent_)
+		CloseHandle(stopEvent_);
+	if(NULL != interruptEvent_)
+		CloseHandle(interruptEvent_);
+
+	for(std::vector<std::pair<tstring, SOCKET> >::iterator it = listeners_.begin()
+		; it != listeners_.end(); ++it)
+	{
+		closesocket(it->second);
+	}
+}
+
+bool Supervisor::addListener(const tstring& endPoint)
+{
+	StringArray<tchar> sa = split_with_string(endPoint.c_str(), _T("://"));
+	if(2 != sa.size() || 0 != string_traits<tchar>::stricmp(_T("tcp"), sa.ptr(0)))
+	{
+		LOG_ERROR(logger_, _T("ģʽֻ֧ tcp ַ - '") << endPoint << _T("'"));
+		return false;
+	}
+
+	if(MAX_SHARED_LISTENERS <= listeners_.size()
+		|| sizeof(((SharedListener*)0)->endpoint)/sizeof(tchar) <= endPoint.size())
+	{
+		LOG_ERROR(logger_, _T("ַ̫̫ - '") << endPoint << _T("'"));
+		return false;
+	}
+
+	SOCKADDR_STORAGE addr;
+	int len = sizeof(SOCKADDR_STORAGE);
+	if(!networking::stringToAddress(sa.ptr(1), (struct sockaddr*)&addr, &len))
+	{
+		LOG_ERROR(logger_, _T("ַ '") << endPoint
+			<< _T("' ʽȷ - ") << lastError(WSAGetLastError()));
+		return false;
+	}
+
+	SOCKET socket = ::socket(addr.ss_family, SOCK_STREAM, IPPROTO_TCP);
+	if(INVALID_SOCKET == socket)
+	{
+		LOG_ERROR(logger_, _T("ַ '") << endPoint
+			<< _T("' ʱ socket ʧ - ") << lastError(WSAGetLastError()));
+		return false;
+	}
+
+	if(SOCKET_ERROR == ::bind(socket, (struct sockaddr*)&addr, len)
+		|| SOCKET_ERROR == ::listen(socket, SOMAXCONN))
+	{
+		LOG_ERROR(logger_, _T("ַ '") << endPoint
+			<< _T("' ʧ - ") << lastError(WSAGetLastError()));
+		closesocket(socket);
+		return false;
+	}
+
+	listeners_.push_back(std::make_pair(endPoint, socket));
+	LOG_INFO(logger_, _T("ַ '") << endPoint << _T("' ɹ!"));
+	return true;
+}
+
+bool Supervisor::createShared()
+{
+	if(NULL == interruptEvent_ || NULL == stopEvent_)
+	{
+		LOG_FATAL(logger_, _T("¼ʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	DWORD size = (DWORD)(sizeof(SupervisorShared) + (workers_.size() - 1)*sizeof(WorkerSlot));
+	mapping_ = CreateFileMapping(INVALID_HANDLE_VALUE
+		, NULL
+		, PAGE_READWRITE
+		, 0
+		, size
+		, sharedName(GetCurrentProcessId(), _T(".stats")).c_str());
+	if(NULL == mapping_)
+	{
+		LOG_FATAL(logger_, _T("ڴʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	shared_ = (SupervisorShared*)MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(is_null(shared_))
+	{
+		LOG_FATAL(logger_, _T("ӳ乲ڴʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	memset(shared_, 0, size);
+	shared_->workerCount = (LONG)workers_.size();
+	return true;
+}
+
+int Supervisor::run(const std::vector<tstring>& arguments)
+{
+	if(workers_.empty())
+		return -1;
+
+	for(std::vector<tstring>::const_iterator it = arguments.begin()
+		; it != arguments.end(); ++it)
+	{
+		if(0 != string_traits<tchar>::strnicmp(_T("--workers="), it->c_str(), 10))
+			arguments_.push_back(*it);
+	}
+
+	if(!createShared())
+		return -1;
+
+	LOG_CRITICAL(logger_, _T("ؽ̿ʼ,  ") << workers_.size());
+
+	for(size_t i = 0; i < workers_.size(); ++i)
+		startWorker(i);
+
+	DWORD nextStats = GetTickCount() + STATS_INTERVAL;
+	for(;;)
+	{
+		DWORD now = GetTickCount();
+		DWORD timeout = remaining(nextStats, now);
+		for(size_t i = 0; i < workers_.size(); ++i)
+		{
+			if(NULL != workers_[i].process)
+				continue;
+
+			DWORD delay = remaining(workers_[i].restartTime, now);
+			if(delay < timeout)
+				timeout = delay;
+		}
+
+		HANDLE handle = processes_.poll(timeout, interruptEvent_);
+		if(interruptEvent_ == handle)
+			break;
+
+		if(INVALID_HANDLE_VALUE == handle)
+		{
+			Sleep(1000);
+		}
+		else if(NULL != handle)
+		{
+			for(size_t i = 0; i < workers_.size(); ++i)
+			{
+				if(handle == workers_[i].process)
+				{
+					onWorkerExit(i);
+					break;
+				}
+			}
+		}
+
+		now = GetTickCount();
+		for(size_t i = 0; i < workers_.size(); ++i)
+		{
+			if(NULL == workers_[i].process && 0 == remaining(workers_[i].restartTime, now))
+				startWorker(i);
+		}
+
+		if(0 == remaining(nextStats, now))
+		{
+			logStats();
+			nextStats = now + STATS_INTERVAL;
+		}
+	}
+
+	LOG_CRITICAL(logger_, _T("ؽյֹͣ, ʼֹͣ!"));
+	stopWorkers();
+	logStats();
+	LOG_CRITICAL(logger_, _T("ؽ˳!"));
+	return 0;
+}
+
+void Supervisor::interrupt()
+{
+	if(NULL != interruptEvent_)
+		SetEvent(interruptEvent_);
+}
+
+void Supervisor::toggleProfilers()
+{
+	if(is_null(shared_))
+		return;
+
+	for(LONG i = 0; i < shared_->workerCount; ++i)
+	{
+		DWORD pid = (DWORD)shared_->workers[i].pid;
+		if(0 == pid)
+			continue;
+
+		if(!SamplingProfiler::toggle(pid))
+			LOG_WARN(logger_, _T("л ") << pid << _T(" Ĳʧ - ") << lastError(GetLastError()));
+	}
+}
+
+void Supervisor::toggleCaptures()
+{
+	if(is_null(shared_))
+		return;
+
+	for(LONG i = 0; i < shared_->workerCount; ++i)
+	{
+		DWORD pid = (DWORD)shared_->workers[i].pid;
+		if(0 == pid)
+			continue;
+
+		if(!TrafficCapture::toggle(pid))
+			LOG_WARN(logger_, _T("л ") << pid << _T(" ץʧ - ") << lastError(GetLastError()));
+	}
+}
+
+void Supervisor::dumpMemory()
+{
+	if(is_null(shared_))
+		return;
+
+	for(LONG i = 0; i < shared_->workerCount; ++i)
+	{
+		DWORD pid = (DWORD)shared_->workers[i].pid;
+		if(0 == pid)
+			continue;
+
+		if(!MemoryBudget::dump(pid))
+			LOG_WARN(logger_, _T("ù ") << pid << _T(" ڴͳʧ - ") << lastError(GetLastError()));
+	}
+}
+
+bool Supervisor::startWorker(size_t index)
+{
+	Worker& worker = workers_[index];
+
+	std::vector<tstring> args;
+	args.push_back(executable_);
+	args.push_back(_T("--console"));
+	args.push_back(concat<tstring>(_T("--worker="), ::toString((int)index)));
+	args.push_back(concat<tstring>(_T("--supervisor="), ::toString((int)GetCurrentProcessId())));
+	args.insert(args.end(), arguments_.begin(), arguments_.end());
+
+	std::vector<tchar*> argv;
+	for(std::vector<tstring>::iterator it = args.begin(); it != args.end(); ++it)
+		argv.push_back(const_cast<tchar*>(it->c_str()));
+
+	// ȹ, Ѽ socket Ƹ
+	HANDLE process = processes_.startProcess(executable_, (int)argv.size(), &argv[0], CREATE_SUSPENDED);
+	if(INVALID_HANDLE_VALUE == process)
+	{
+		worker.restartTime = GetTickCount() + restartDelay(++ worker.failures);
+		return false;
+	}
+
+	Process* p = processes_.find(process);
+	WorkerSlot& slot = shared_->workers[index];
+	slot.listenerCount = 0;
+	slot.stats.sessions = 0;
+	slot.stats.shedding = 0;
+	slot.stats.memory = 0;
+
+	for(size_t i = 0; i < listeners_.size(); ++i)
+	{
+		lstrcpyn(slot.listeners[i].endpoint, listeners_[i].first.c_str()
+			, sizeof(slot.listeners[i].endpoint)/sizeof(tchar));
+
+		if(0 != WSADuplicateSocket(listeners_[i].second
+			, p->ProcessInfo.dwProcessId
+			, &slot.listeners[i].protocolInfo))
+		{
+			LOG_ERROR(logger_, _T("Ƽ socket '") << listeners_[i].first
+				<< _T("'  ") << index << _T(" ʧ - ")
+				<< lastError(WSAGetLastError()));
+
+			processes_.stopProcess(process);
+			processes_.removeProcess(process);
+			worker.restartTime = GetTickCount() + restartDelay(++ worker.failures);
+			return false;
+		}
+	}
+
+	slot.listenerCount = (LONG)listeners_.size();
+	slot.pid = (LONG)p->ProcessInfo.dwProcessId;
+
+	worker.process = process;
+	worker.startTime = GetTickCount();
+	++ worker.starts;
+
+	ResumeThread(p->ProcessInfo.hThread);
+
+	LOG_INFO(logger_, _T(" ") << index << _T(" ɹ - PID=")
+		<< p->ProcessInfo.dwProcessId);
+	return true;
+}
+
+void Supervisor::onWorkerExit(size_t index)
+{
+	Worker& worker = workers_[index];
+
+	DWORD code = 0;
+	GetExitCodeProcess(worker.process, &code);
+	DWORD lived = GetTickCount() - worker.startTime;
+
+	processes_.removeProcess(worker.process);
+	worker.process = NULL;
+
+	shared_->workers[index].pid = 0;
+	shared_->workers[index].stats.sessions = 0;
+	shared_->workers[index].stats.shedding = 0;
+	shared_->workers[index].stats.memory = 0;
+
+	if(STABLE_TIME <= lived)
+		worker.failures = 0;
+	else
+		++ worker.failures;
+
+	DWORD delay = restartDelay(worker.failures);
+	worker.restartTime = GetTickCount() + delay;
+
+	LOG_ERROR(logger_, _T(" ") << index << _T(" ˳ - ˳ ") << code
+		<< _T(",  ") << lived/1000 << _T(" , ")
+		<< delay << _T(" "));
+}
+
+void Supervisor::stopWorkers()
+{
+	SetEvent(stopEvent_);
+
+	std::vector<HANDLE> handles;
+	for(size_t i = 0; i < workers_.size(); ++i)
+	{
+		if(NULL != workers_[i].process)
+			handles.push_back(workers_[i].process);
+	}
+
+	if(!handles.empty())
+		WaitForMultipleObjects((DWORD)handles.size(), &handles[0], TRUE, STOP_TIMEOUT);
+
+	for(size_t i = 0; i < workers_.size(); ++i)
+	{
+		if(NULL == workers_[i].process)
+			continue;
+
+		if(WAIT_TIMEOUT == WaitForSingleObject(workers_[i].process, 0))
+		{
+			LOG_ERROR(logger_, _T(" ") << i << _T(" ûаʱ˳, ǿֹ!"));
+			processes_.stopProcess(workers_[i].process);
+		}
+
+		processes_.removeProcess(workers_[i].process);
+		workers_[i].process = NULL;
+		shared_->workers[i].pid = 0;
+	}
+}
+
+void Supervisor::logStats()
+{
+	if(is_null(shared_))
+		return;
+
+	LONG connections = 0;
+	LONG sessions = 0;
+	LONG rejected = 0;
+	LONG shedding = 0;
+	LONG memory = 0;
+	LONG restarts = 0;
+	size_t running = 0;
+	for(size_t i = 0; i < workers_.size(); ++i)
+	{
+		connections += shared_->workers[i].stats.connections;
+		sessions += shared_->workers[i].stats.sessions;
+		rejected += shared_->workers[i].stats.rejected;
+		shedding += shared_->workers[i].stats.shedding;
+		memory += shared_->workers[i].stats.memory;
+		if(1 < workers_[i].starts)
+			restarts += workers_[i].starts - 1;
+		if(NULL != workers_[i].process)
+			++ running;
+	}
+
+	LOG_INFO(logger_, _T(" ") << running << _T("/") << workers_.size()
+		<< _T(" , ۼ ") << connections
+		<< _T(", ǰ ") << sessions
+		<< _T(", ܾ ") << rejected
+		<< _T(",  ") << shedding
+		<< _T(", ڴ ") << memory << _T(" KB")
+		<< _T(",  ") << restarts << _T(" "));
+}
+
+WorkerAgent::WorkerAgent()
+: core_(null_ptr)
+, mapping_(NULL)
+, shared_(null_ptr)
+, stopEvent_(NULL)
+, supervisor_(NULL)
+, stopWait_(NULL)
+, supervisorWait_(NULL)
+, logger_(_T("jingxian.system.worker"))
+{
+}
+
+WorkerAgent::~WorkerAgent()
+{
+	if(NULL != stopWait_)
+		UnregisterWaitEx(stopWait_, INVALID_HANDLE_VALUE);
+	if(NULL != supervisorWait_)
+		UnregisterWaitEx(supervisorWait_, INVALID_HANDLE_VALUE);
+
+	// ͳҪͷ
+	if(!is_null(core_))
+		core_->stats(null_ptr);
+
+	if(!is_null(shared_))
+		UnmapViewOfFile(shared_);
+	if(NULL != mapping_)
+		CloseHandle(mapping_);
+	if(NULL != stopEvent_)
+		CloseHandle(stopEvent_);
+	if(NULL != supervisor_)
+		CloseHandle(supervisor_);
+}
+
+bool WorkerAgent::attach(DWORD supervisorPid, size_t index, IOCPServer& core)
+{
+	mapping_ = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE
+		, sharedName(supervisorPid, _T(".stats")).c_str());
+	if(NULL == mapping_)
+	{
+		LOG_FATAL(logger_, _T("򿪼ؽ̵Ĺڴʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	shared_ = (SupervisorShared*)MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if(is_null(shared_))
+	{
+		LOG_FATAL(logger_, _T("ӳؽ̵Ĺڴʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	if(shared_->workerCount <= (LONG)index)
+	{
+		LOG_FATAL(logger_, _T(" ") << index << _T(" Χ!"));
+		return false;
+	}
+
+	WorkerSlot& slot = shared_->workers[index];
+	for(LONG i = 0; i < slot.listenerCount; ++i)
+	{
+		SOCKET socket = WSASocket(FROM_PROTOCOL_INFO
+			, FROM_PROTOCOL_INFO
+			, FROM_PROTOCOL_INFO
+			, &slot.listeners[i].protocolInfo
+			, 0
+			, WSA_FLAG_OVERLAPPED);
+		if(INVALID_SOCKET == socket)
+		{
+			LOG_FATAL(logger_, _T("򿪹ļ socket '") << slot.listeners[i].endpoint
+				<< _T("' ʧ - ") << lastError(WSAGetLastError()));
+			return false;
+		}
+		core.addSharedSocket(slot.listeners[i].endpoint, socket);
+	}
+
+	stopEvent_ = OpenEvent(SYNCHRONIZE, FALSE, sharedName(supervisorPid, _T(".stop")).c_str());
+	supervisor_ = OpenProcess(SYNCHRONIZE, FALSE, supervisorPid);
+	if(NULL == stopEvent_ || NULL == supervisor_)
+	{
+		LOG_FATAL(logger_, _T("򿪼ؽ̵¼ʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	core_ = &core;
+	core.stats(&slot.stats);
+
+	// ؽҪֹͣؽ˳ʱֹͣ
+	if(!RegisterWaitForSingleObject(&stopWait_, stopEvent_, &WorkerAgent::onStop
+			, this, INFINITE, WT_EXECUTEONLYONCE)
+		|| !RegisterWaitForSingleObject(&supervisorWait_, supervisor_, &WorkerAgent::onStop
+			, this, INFINITE, WT_EXECUTEONLYONCE))
+	{
+		LOG_FATAL(logger_, _T("ȴؽ̵¼ʧ - ") << lastError(GetLastError()));
+		return false;
+	}
+
+	LOG_INFO(logger_, _T(" ") << index << _T(" ӵؽ PID=")
+		<< supervisorPid << _T(", ַ ") << slot.listenerCount << _T(" "));
+	return true;
+}
+
+VOID CALLBACK WorkerAgent::onStop(PVOID context, BOOLEAN timeout)
+{
+	static_cast<WorkerAgent*>(context)->core_->interrupt();
+}
+
+_jingxian_end
@@ -0,0 +1,164 @@
+
+#ifndef _Supervisor_H_
+#define _Supervisor_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+#include <vector>
+#include "jingxian/string/string.h"
+#include "jingxian/logging/logging.h"
+#include "jingxian/networks/IOCPServer.h"
+#include "jingxian/proc/ProcessManager.h"
+
+_jingxian_begin
+
+/// ÿԹļַ
+const size_t MAX_SHARED_LISTENERS = 16;
+
+/**
+ * ̵ļ socket
+ */
+struct SharedListener
+{
+	tchar endpoint[128];
+	WSAPROTOCOL_INFO protocolInfo;
+};
+
+/**
+ * ڹڴе
+ */
+struct WorkerSlot
+{
+	ServerStats stats;
+	volatile LONG pid;
+	LONG listenerCount;
+	SharedListener listeners[MAX_SHARED_LISTENERS];
+};
+
+struct SupervisorShared
+{
+	LONG workerCount;
+	WorkerSlot workers[1];
+};
+
+/**
+ * ģʽµļؽ
+ *
+ * ؽ̴еļַ, Ȼ N ,  WSADuplicateSocket
+ * Ѽ socket ÿ, ̸Լ IOCPServer 
+ * ͬһ socket Ͷ AcceptEx, ϵͳ֮. 쳣
+ * ˳˱ʱ, ͳͨڴ.
+ */
+class Supervisor
+{
+public:
+	Supervisor(size_t workers);
+
+	~Supervisor();
+
+	/**
+	 * һļַ
+	 * @param[ in ] endPoint ĵַ,  tcp://0.0.0.0:80
+	 */
+	bool addListener(const tstring& endPoint);
+
+	/**
+	 * ̲, ֱ interrupt 
+	 * @param[ in ] arguments ̵Ĳ
+	 */
+	int run(const std::vector<tstring>& arguments);
+
+	/**
+	 * ֹͣ( ߳е )
+	 */
+	void interrupt();
+
+	/**
+	 * ʼйеĲ( ߳е )
+	 */
+	void toggleProfilers();
+
+	/**
+	 * ʼйеץ( ߳е )
+	 */
+	void toggleCaptures();
+
+	/**
+	 * й־ڴͳ( ߳е )
+	 */
+	void dumpMemory();
+
+private:
+	NOCOPY(Supervisor);
+
+	struct Worker
+	{
+		HANDLE process;
+		DWORD startTime;
+		DWORD restartTime;
+		int failures;
+		LONG starts;
+	};
+
+	bool createShared();
+	bool startWorker(size_t index);
+	void onWorkerExit(size_t index);
+	void stopWorkers();
+	void logStats();
+
+	ProcessManager processes_;
+	std::vector<Worker> workers_;
+	std::vector<std::pair<tstring, SOCKET> > listeners_;
+	std::vector<tstring> arguments_;
+	tstring executable_;
+
+	HANDLE interruptEvent_;
+	HANDLE stopEvent_;
+	HANDLE mapping_;
+	SupervisorShared* shared_;
+
+	logging::logger logger_;
+};
+
+/**
+ * ģʽ¹һ, Ӽؽȡùļ socket ͳ,
+ * ڼؽҪֹͣؽ˳ʱֹͣ IOCPServer
+ */
+class WorkerAgent
+{
+public:
+	WorkerAgent();
+
+	~WorkerAgent();
+
+	/**
+	 * ӵؽ
+	 * @param[ in ] supervisorPid ؽ̵ PID
+	 * @param[ in ] index ̵
+	 * @param[ in ] core ̵ IOCPServer
+	 */
+	bool attach(DWORD supervisorPid, size_t index, IOCPServer& core);
+
+private:
+	NOCOPY(WorkerAgent);
+
+	static VOID CALLBACK onStop(PVOID context, BOOLEAN timeout);
+
+	IOCPServer* core_;
+	HANDLE mapping_;
+	SupervisorShared* shared_;
+	HANDLE stopEvent_;
+	HANDLE supervisor_;
+	HANDLE stopWait_;
+	HANDLE supervisorWait_;
+	logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_Supervisor_H_
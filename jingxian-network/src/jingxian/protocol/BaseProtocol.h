@@ -14,6 +14,7 @@
 # include "jingxian/ProtocolContext.h"
 # include "jingxian/buffer/OutBuffer.h"
 # include "jingxian/buffer/InBuffer.h"
+# include "jingxian/buffer/MemoryAccount.h"
 # include "jingxian/logging/logging.h"
 
 _jingxian_begin
@@ -89,7 +90,7 @@ public:
 
     virtual databuffer_t* createBuffer(const ProtocolContext& context)
     {
-        databuffer_t* result = (databuffer_t*)my_calloc(1, sizeof(databuffer_t) + 100);
+        databuffer_t* result = (databuffer_t*)my_calloc_as(1, sizeof(databuffer_t) + 100, MemoryKind::Receive);
         result->chain.context = result;
         result->chain.freebuffer = &freeBuffer;
         result->chain.type = BUFFER_ELEMENT_MEMORY;
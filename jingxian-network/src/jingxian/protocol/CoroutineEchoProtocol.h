@@ -0,0 +1,65 @@
+
+#ifndef _CoroutineEchoProtocol_H_
+#define _CoroutineEchoProtocol_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/coroutine/Channel.h"
+
+_jingxian_begin
+
+/**
+ * ЭдĻԻỰ,  EchoProtocol Ĺһ
+ */
+class CoroutineEchoSession : public Coroutine
+{
+public:
+    CoroutineEchoSession(Channel* channel)
+        : Coroutine(_T("CoroutineEchoSession"))
+        , channel_(channel)
+    {
+    }
+
+    virtual void run()
+    {
+        char buf[4096];
+        for (;;)
+        {
+            size_t len = channel_->readSome(buf, sizeof(buf));
+            if (0 == len || !channel_->write(buf, len))
+                return;
+        }
+    }
+
+    virtual void onExit()
+    {
+        channel_->release();
+        delete this;
+    }
+
+private:
+    Channel* channel_;
+};
+
+class CoroutineEchoProtocolFactory : public CoroutineProtocolFactory
+{
+public:
+    CoroutineEchoProtocolFactory(CoroutineScheduler* scheduler)
+        : CoroutineProtocolFactory(scheduler, _T("CoroutineEchoProtocol"))
+    {
+    }
+
+    virtual Coroutine* createSession(Channel* channel)
+    {
+        return new CoroutineEchoSession(channel);
+    }
+};
+
+_jingxian_end
+
+#endif //_CoroutineEchoProtocol_H_
@@ -0,0 +1,148 @@
+
+#ifndef _FrameProtocol_H_
+#define _FrameProtocol_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/protocol/BaseProtocol.h"
+# include "jingxian/protocol/Framers.h"
+
+_jingxian_begin
+
+/**
+ * ֡ݵЭĻ, ʹ÷
+ *
+ *   class RpcHandler : public BaseFrameHandler
+ *   {
+ *   public:
+ *       bool onFrame(ProtocolContext& context, const char* frame, size_t len)
+ *       {
+ *           ...
+ *           return true;
+ *       }
+ *   };
+ *
+ *   new FrameProtocol<LengthPrefixedFramer<length_field::uint32_be>, RpcHandler>();
+ */
+class BaseFrameHandler : public BaseProtocol
+{
+public:
+    BaseFrameHandler(const tchar* descr = _T("FrameProtocol"))
+        : BaseProtocol(descr)
+    {
+    }
+
+    /**
+     * յһ֡,  false ʱٴյĺ֡
+     *
+     * @param[ in ] context Ự
+     * @param[ in ] frame ֡, ֻڱεЧ
+     * @param[ in ] len ֡ĳ
+     */
+    bool onFrame(ProtocolContext& context, const char* frame, size_t len)
+    {
+        return true;
+    }
+
+    /**
+     * յǷ֡, Ĭ϶Ͽ
+     */
+    void onFrameError(ProtocolContext& context, const tstring& reason)
+    {
+        LOG_ERROR(logger_, _T("յǷ֡, Ͽ - ") << context.transport().peer()
+                  << _T(" - ") << reason);
+        context.transport().disconnection(reason);
+    }
+};
+
+/**
+ * ֡Э,  Framer(  Framers.h )յзֳ֡󽻸
+ * Handler::onFrame . ֡һڴʱֱӰָ뽻,
+ * ֻпԽڴ֡ŻḴƴ; ֡ڽջеȴ.
+ *
+ * Handler ʵ IProtocol ( һ BaseFrameHandler ̳ ),
+ * ṩ onFrame  onFrameError.
+ */
+template<typename Framer, typename Handler>
+class FrameProtocol : public Handler
+{
+public:
+    FrameProtocol(const Framer& framer = Framer())
+        : framer_(framer)
+    {
+    }
+
+    FrameProtocol(const Framer& framer, const Handler& handler)
+        : Handler(handler)
+        , framer_(framer)
+    {
+    }
+
+    Framer& framer()
+    {
+        return framer_;
+    }
+
+    virtual size_t onReceived(ProtocolContext& context)
+    {
+        InBuffer in(&context.inMemory(), context.inBytes());
+        size_t consumed = 0;
+
+        while (0 < in.size())
+        {
+            size_t available = in.size();
+            size_t bodyLength = 0;
+            size_t trailerLength = 0;
+
+            frame_status::type status = framer_.decode(in, bodyLength, trailerLength);
+            if (frame_status::incomplete == status)
+                break;
+
+            if (frame_status::invalid == status)
+            {
+                Handler::onFrameError(context, _T("֡ʽ"));
+                return context.inBytes();
+            }
+
+            size_t headerLength = available - in.size();
+            if (in.size() < bodyLength + trailerLength)
+                break;
+
+            size_t len = 0;
+            const char* ptr = in.peek(len);
+            if (len >= bodyLength)
+            {
+                // ֡һڴ, Ҫ
+                in.seek((int)(bodyLength + trailerLength));
+            }
+            else
+            {
+                assemble_.resize(bodyLength);
+                in.readBlob(&assemble_[0], bodyLength);
+                in.seek((int)trailerLength);
+                ptr = &assemble_[0];
+            }
+
+            consumed += headerLength + bodyLength + trailerLength;
+            if (!Handler::onFrame(context, ptr, bodyLength))
+                break;
+        }
+
+        return consumed;
+    }
+
+private:
+    Framer framer_;
+    // ƴӿԽڴ֡
+    std::vector<char> assemble_;
+};
+
+_jingxian_end
+
+#endif //_FrameProtocol_H_
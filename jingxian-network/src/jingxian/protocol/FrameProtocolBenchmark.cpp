@@ -0,0 +1,201 @@
+
+# include "pro_config.h"
+# include "jingxian/protocol/FrameProtocol.h"
+# include "jingxian/networks/LoopbackTransport.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    class CollectHandler : public BaseFrameHandler
+    {
+    public:
+        bool onFrame(ProtocolContext& context, const char* frame, size_t len)
+        {
+            frames.push_back(std::string(frame, len));
+            return true;
+        }
+
+        void onFrameError(ProtocolContext& context, const tstring& reason)
+        {
+            frames.push_back("<error>");
+        }
+
+        std::vector<std::string> frames;
+    };
+
+    class CountHandler : public BaseFrameHandler
+    {
+    public:
+        CountHandler()
+            : count(0)
+            , bytes(0)
+        {
+        }
+
+        bool onFrame(ProtocolContext& context, const char* frame, size_t len)
+        {
+            ++ count;
+            bytes += len;
+            return true;
+        }
+
+        void onFrameError(ProtocolContext& context, const tstring& reason)
+        {
+        }
+
+        size_t count;
+        size_t bytes;
+    };
+
+    void appendFrame(std::string& data, size_t len, char ch)
+    {
+        data.push_back((char)((len >> 8) & 0xff));
+        data.push_back((char)(len & 0xff));
+        data.append(len, ch);
+    }
+}
+
+TEST(protocol, frameDecode)
+{
+    LoopbackTransport transport;
+
+    {
+        // ǰ׺, ڶ֡Խڴ, ֡
+        std::string data;
+        appendFrame(data, 3, 'a');
+        appendFrame(data, 6, 'b');
+        appendFrame(data, 4, 'c');
+        data.resize(data.size() - 1);
+
+        FrameProtocol<LengthPrefixedFramer<length_field::uint16_be>, CollectHandler> protocol;
+        transport.bindProtocol(&protocol);
+        ASSERT_TRUE(13 == transport.receive(data, 8));
+        ASSERT_TRUE(2 == protocol.frames.size());
+        ASSERT_TRUE("aaa" == protocol.frames[0]);
+        ASSERT_TRUE("bbbbbb" == protocol.frames[1]);
+    }
+
+    {
+        std::string data("abc\r\ndefgh\r\n\r\nxyz");
+
+        FrameProtocol<LineFramer, CollectHandler> protocol;
+        transport.bindProtocol(&protocol);
+        ASSERT_TRUE(14 == transport.receive(data, 4));
+        ASSERT_TRUE(3 == protocol.frames.size());
+        ASSERT_TRUE("abc" == protocol.frames[0]);
+        ASSERT_TRUE("defgh" == protocol.frames[1]);
+        ASSERT_TRUE("" == protocol.frames[2]);
+    }
+
+    {
+        // 󳤶ȻҲָ
+        std::string data("0123456789");
+
+        FrameProtocol<LineFramer, CollectHandler> protocol(LineFramer(4));
+        transport.bindProtocol(&protocol);
+        transport.receive(data, 4);
+        ASSERT_TRUE(1 == protocol.frames.size());
+        ASSERT_TRUE("<error>" == protocol.frames[0]);
+    }
+
+    {
+        std::string data("\x03" "abc" "\x81\x01");
+        data.append(129, 'z');
+
+        FrameProtocol<LengthPrefixedFramer<length_field::varint>, CollectHandler> protocol;
+        transport.bindProtocol(&protocol);
+        ASSERT_TRUE(data.size() == transport.receive(data, 5));
+        ASSERT_TRUE(2 == protocol.frames.size());
+        ASSERT_TRUE("abc" == protocol.frames[0]);
+        ASSERT_TRUE(129 == protocol.frames[1].size());
+    }
+
+    {
+        // ֡, 󲻹һ֡ڻ
+        std::string data("abcdefghij");
+
+        FrameProtocol<FixedLengthFramer, CollectHandler> protocol(FixedLengthFramer(4));
+        transport.bindProtocol(&protocol);
+        ASSERT_TRUE(8 == transport.receive(data, 3));
+        ASSERT_TRUE(2 == protocol.frames.size());
+        ASSERT_TRUE("abcd" == protocol.frames[0]);
+        ASSERT_TRUE("efgh" == protocol.frames[1]);
+    }
+}
+
+TEST(protocol, fixedLengthZero)
+{
+    // Ϊ 0 ֡ FrameProtocol һֱѭ, ʱ;ܾ
+    bool thrown = false;
+    try
+    {
+        FixedLengthFramer framer(0);
+    }
+    catch (IllegalArgumentException&)
+    {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+}
+
+# ifndef _GOOGLETEST_
+
+namespace
+{
+    template<typename Framer>
+    void runFrameBenchmark(BenchmarkState& state, const std::string& data, size_t segmentSize)
+    {
+        LoopbackTransport transport;
+        FrameProtocol<Framer, CountHandler> protocol;
+        transport.bindProtocol(&protocol);
+        state.setBytesProcessed(data.size());
+
+        for (size_t i = 0; i < state.iterations(); ++ i)
+            DO_NOT_OPTIMIZE(transport.receive(data, segmentSize));
+    }
+}
+
+BENCHMARK(FrameProtocol_small_frames)
+{
+    std::string data;
+    for (size_t i = 0; i < 1024; ++ i)
+        appendFrame(data, 16 + (i % 48), 'a');
+    runFrameBenchmark<LengthPrefixedFramer<length_field::uint16_be> >(state, data, 4096);
+}
+
+BENCHMARK(FrameProtocol_large_frames)
+{
+    std::string data;
+    for (size_t i = 0; i < 16; ++ i)
+        appendFrame(data, 60000, 'a');
+    runFrameBenchmark<LengthPrefixedFramer<length_field::uint16_be> >(state, data, 4096);
+}
+
+BENCHMARK(FrameProtocol_mixed_frames)
+{
+    std::string data;
+    for (size_t i = 0; i < 512; ++ i)
+        appendFrame(data, (0 == i % 32) ? 32000 : 24, 'a');
+    runFrameBenchmark<LengthPrefixedFramer<length_field::uint16_be> >(state, data, 4096);
+}
+
+BENCHMARK(FrameProtocol_lines)
+{
+    std::string data;
+    for (size_t i = 0; i < 1024; ++ i)
+    {
+        data.append(20 + (i % 60), 'a');
+        data.append("\r\n");
+    }
+    runFrameBenchmark<LineFramer>(state, data, 4096);
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
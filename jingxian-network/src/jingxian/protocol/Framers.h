@@ -0,0 +1,239 @@
+
+#ifndef _Framers_H_
+#define _Framers_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/exception.h"
+# include "jingxian/buffer/InBuffer.h"
+
+_jingxian_begin
+
+/**
+ * ֡Ľ
+ */
+namespace frame_status
+{
+    enum type
+    {
+        complete     // ֡ͷѶ, ֡ĳЧ
+        , incomplete // ݲһ֡ͷ
+        , invalid    // ݲǺϷ֡
+    };
+}
+
+/**
+ * ֡Լ(  FrameProtocol ʹ ):
+ *
+ *   frame_status::type decode(InBuffer& in, size_t& bodyLength, size_t& trailerLength);
+ *
+ *  in ĵǰλöȡ֡ͷ( ȡֽ֡ͷ ), ֡峤Ⱥ֮֡
+ * Ҫֽ( ָ ).  incomplete ʱ in ״̬.
+ */
+
+/**
+ * ֡
+ */
+class FixedLengthFramer
+{
+public:
+    /**
+     * @param[ in ] frameLength ֡ĳ, Ϊ 0 ʱÿν붼ȡ, 
+     * FrameProtocol һֱѭ, Բ
+     */
+    FixedLengthFramer(size_t frameLength)
+        : frameLength_(frameLength)
+    {
+        if (0 == frameLength)
+            ThrowException1(IllegalArgumentException, _T("֡ĳȲΪ 0"));
+    }
+
+    frame_status::type decode(InBuffer& in, size_t& bodyLength, size_t& trailerLength)
+    {
+        bodyLength = frameLength_;
+        trailerLength = 0;
+        return frame_status::complete;
+    }
+
+private:
+    size_t frameLength_;
+};
+
+/**
+ * ֶεĶȡ,  LengthPrefixedFramer ʹ
+ */
+namespace length_field
+{
+    struct uint8
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            if (1 > in.size())
+                return frame_status::incomplete;
+            length = (uint8_t)in.readInt8();
+            return frame_status::complete;
+        }
+    };
+
+    struct uint16_be
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            if (2 > in.size())
+                return frame_status::incomplete;
+            length = in.readUInt16BE();
+            return frame_status::complete;
+        }
+    };
+
+    struct uint16_le
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            if (2 > in.size())
+                return frame_status::incomplete;
+            length = in.readUInt16LE();
+            return frame_status::complete;
+        }
+    };
+
+    struct uint32_be
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            if (4 > in.size())
+                return frame_status::incomplete;
+            length = in.readUInt32BE();
+            return frame_status::complete;
+        }
+    };
+
+    struct uint32_le
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            if (4 > in.size())
+                return frame_status::incomplete;
+            length = in.readUInt32LE();
+            return frame_status::complete;
+        }
+    };
+
+    struct varint
+    {
+        static frame_status::type read(InBuffer& in, uint64_t& length)
+        {
+            length = in.readVarUInt64();
+            if (ERROR_SUCCESS == in.error())
+                return frame_status::complete;
+
+            frame_status::type status = (ERROR_HANDLE_EOF == in.error())
+                                        ? frame_status::incomplete : frame_status::invalid;
+            in.clearError();
+            return status;
+        }
+    };
+}
+
+/**
+ * ǰ׺֡, ֶεĸʽ LengthField ָ(  length_field ),
+ * ȳ maxFrameLength ֡ǷǷ.
+ */
+template<typename LengthField>
+class LengthPrefixedFramer
+{
+public:
+    LengthPrefixedFramer(size_t maxFrameLength = 16*1024*1024)
+        : maxFrameLength_(maxFrameLength)
+    {
+    }
+
+    frame_status::type decode(InBuffer& in, size_t& bodyLength, size_t& trailerLength)
+    {
+        uint64_t length = 0;
+        frame_status::type status = LengthField::read(in, length);
+        if (frame_status::complete != status)
+            return status;
+
+        if (length > maxFrameLength_)
+            return frame_status::invalid;
+
+        bodyLength = (size_t)length;
+        trailerLength = 0;
+        return frame_status::complete;
+    }
+
+private:
+    size_t maxFrameLength_;
+};
+
+/**
+ * Էָβ֡, ָ֡;  maxFrameLength 
+ * ҲָʱΪǷǷ.
+ */
+class DelimiterFramer
+{
+public:
+    DelimiterFramer(const char* delimiter, size_t maxFrameLength = 64*1024)
+        : delimiter_(delimiter)
+        , maxFrameLength_(maxFrameLength)
+        , searched_(0)
+    {
+    }
+
+    frame_status::type decode(InBuffer& in, size_t& bodyLength, size_t& trailerLength)
+    {
+        // ֡ʱ, ´յݲٴͷ
+        size_t skip = (searched_ >= delimiter_.size()) ? (searched_ - delimiter_.size() + 1) : 0;
+        if (0 != skip)
+            in.seek((int)skip);
+
+        size_t pos = in.search(delimiter_.c_str(), delimiter_.size());
+
+        if (0 != skip)
+            in.seek(-(int)skip);
+
+        if (buffer_type::npos == pos)
+        {
+            searched_ = in.size();
+            return (searched_ > maxFrameLength_ + delimiter_.size())
+                   ? frame_status::invalid : frame_status::incomplete;
+        }
+
+        searched_ = 0;
+        pos += skip;
+        if (pos > maxFrameLength_)
+            return frame_status::invalid;
+
+        bodyLength = pos;
+        trailerLength = delimiter_.size();
+        return frame_status::complete;
+    }
+
+private:
+    std::string delimiter_;
+    size_t maxFrameLength_;
+    // ϴѲҹ( ָ )ֽ
+    size_t searched_;
+};
+
+/**
+ *  "\r\n" βı
+ */
+class LineFramer : public DelimiterFramer
+{
+public:
+    LineFramer(size_t maxLineLength = 8*1024)
+        : DelimiterFramer("\r\n", maxLineLength)
+    {
+    }
+};
+
+_jingxian_end
+
+#endif //_Framers_H_
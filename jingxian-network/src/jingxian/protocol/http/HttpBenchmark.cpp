@@ -0,0 +1,279 @@
+
+# include "pro_config.h"
+# include "jingxian/networks/LoopbackTransport.h"
+# include "jingxian/protocol/http/HttpProtocol.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    using namespace http;
+
+    class RecordHandler : public IHttpHandler
+    {
+    public:
+        RecordHandler()
+            : deferFirst(false)
+            , deferred(null_ptr)
+        {
+        }
+
+        virtual void onRequest(const HttpRequest& request, HttpResponse& response)
+        {
+            uris.push_back(request.uri.str());
+            bodies.push_back(request.body.str());
+
+            if (deferFirst && is_null(deferred))
+            {
+                response.defer();
+                deferred = &response;
+                return;
+            }
+            response.write(request.uri.ptr, request.uri.len);
+        }
+
+        std::vector<std::string> uris;
+        std::vector<std::string> bodies;
+        bool deferFirst;
+        HttpResponse* deferred;
+    };
+
+    class CountHandler : public IHttpHandler
+    {
+    public:
+        virtual void onRequest(const HttpRequest& request, HttpResponse& response)
+        {
+            response.header("Content-Type", "text/plain");
+            response.write("hello", 5);
+        }
+    };
+
+    size_t countOf(const std::string& str, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t pos = str.find(pattern); std::string::npos != pos; pos = str.find(pattern, pos + 1))
+            ++ count;
+        return count;
+    }
+
+    const char SMALL_GET[] = "GET /index.html HTTP/1.1\r\n"
+                             "Host: localhost\r\n"
+                             "User-Agent: bench\r\n"
+                             "Accept: */*\r\n"
+                             "\r\n";
+}
+
+TEST(protocol, httpParse)
+{
+    {
+        // ˮ, Խڴ, һ
+        LoopbackTransport transport;
+        RecordHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string first("GET /a HTTP/1.1\r\nHost: x\r\n\r\n");
+        std::string second("POST /b HTTP/1.1\r\ncontent-length: 5\r\n\r\nhello");
+        std::string data = first + second + "GET /c HTTP/1.1\r\nHo";
+        ASSERT_TRUE(first.size() + second.size() == transport.receive(data, 7));
+        ASSERT_TRUE(2 == handler.uris.size());
+        ASSERT_TRUE("/a" == handler.uris[0]);
+        ASSERT_TRUE("/b" == handler.uris[1]);
+        ASSERT_TRUE("hello" == handler.bodies[1]);
+        ASSERT_TRUE(transport.wire.find("/a") < transport.wire.find("/b"));
+        ASSERT_TRUE(2 == countOf(transport.wire, "HTTP/1.1 200 OK\r\n"));
+        ASSERT_TRUE(!transport.disconnected);
+    }
+
+    {
+        // chunked
+        LoopbackTransport transport;
+        RecordHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string data("POST /u HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                         "4\r\nWiki\r\n5;x=y\r\npedia\r\n0\r\nX-Trailer: 1\r\n\r\n");
+        ASSERT_TRUE(data.size() == transport.receive(data, 5));
+        ASSERT_TRUE(1 == handler.bodies.size());
+        ASSERT_TRUE("Wikipedia" == handler.bodies[0]);
+    }
+
+    {
+        // chunked ּյ, ѽķֿ鲻ظ
+        LoopbackTransport transport;
+        RecordHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string data("POST /u HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                         "4\r\nWiki\r\n5\r\npedia\r\n3\r\n in\r\n0\r\n\r\n");
+        for (size_t length = 1; length < data.size(); ++ length)
+            ASSERT_TRUE(0 == transport.receive(data.substr(0, length), 3));
+        ASSERT_TRUE(handler.bodies.empty());
+
+        ASSERT_TRUE(data.size() == transport.receive(data, 3));
+        ASSERT_TRUE(1 == handler.bodies.size());
+        ASSERT_TRUE("Wikipedia in" == handler.bodies[0]);
+    }
+
+    {
+        // 첽ĻظҪȵǰĻظŷ
+        LoopbackTransport transport;
+        RecordHandler handler;
+        handler.deferFirst = true;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string data("GET /1 HTTP/1.1\r\n\r\nGET /2 HTTP/1.1\r\n\r\n");
+        ASSERT_TRUE(data.size() == transport.receive(data, 64));
+        ASSERT_TRUE(transport.wire.empty());
+
+        handler.deferred->write("first", 5);
+        handler.deferred->end();
+        ASSERT_TRUE(2 == countOf(transport.wire, "HTTP/1.1 200 OK\r\n"));
+        ASSERT_TRUE(transport.wire.find("first") < transport.wire.find("/2"));
+    }
+
+    {
+        // HTTP/1.0 ȱʡ, 󱻺
+        LoopbackTransport transport;
+        RecordHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string data("GET /1 HTTP/1.0\r\n\r\nGET /2 HTTP/1.0\r\n\r\n");
+        transport.receive(data, 64);
+        ASSERT_TRUE(1 == handler.uris.size());
+        ASSERT_TRUE(std::string::npos != transport.wire.find("Connection: close\r\n"));
+        ASSERT_TRUE(transport.disconnected);
+        ASSERT_TRUE(data.size() == transport.receive(data, 64));
+        ASSERT_TRUE(1 == handler.uris.size());
+    }
+
+    {
+        // ʽ
+        LoopbackTransport transport;
+        RecordHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        std::string data("GET /a HTTP/1.1\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n");
+        ASSERT_TRUE(data.size() == transport.receive(data, 64));
+        ASSERT_TRUE(handler.uris.empty());
+        ASSERT_TRUE(0 == transport.wire.find("HTTP/1.1 400 Bad Request\r\n"));
+        ASSERT_TRUE(transport.disconnected);
+    }
+}
+
+TEST(protocol, httpBodyResume)
+{
+    // 岻ʱͷֻһ, ֱ֮Ӵ忪ʼ
+    HttpRequestParser parser;
+    HttpRequest request;
+    size_t messageLength = 0;
+
+    std::string head("POST /upload HTTP/1.1\r\nHost: x\r\nContent-Length: 10\r\n\r\n");
+    std::string data = head + "01234";
+
+    std::vector<io_mem_buf> segments(1);
+    segments[0].buf = &data[0];
+    segments[0].len = (u_long)data.size();
+    {
+        InBuffer in(&segments, data.size());
+        ASSERT_TRUE(parse_status::incomplete == parser.parse(in, request, messageLength));
+    }
+
+    // ͷѾڽ, ջеͷĵҲӰ
+    data = std::string(head.size(), 'x') + "0123456789";
+    segments[0].buf = &data[0];
+    segments[0].len = (u_long)data.size();
+    {
+        InBuffer in(&segments, data.size());
+        ASSERT_TRUE(parse_status::complete == parser.parse(in, request, messageLength));
+        ASSERT_TRUE(data.size() == messageLength);
+        ASSERT_TRUE("/upload" == request.uri.str());
+        ASSERT_TRUE(request.method.equals("POST"));
+        ASSERT_TRUE(request.header("Host")->equals("x"));
+        ASSERT_TRUE("0123456789" == request.body.str());
+    }
+
+    // һ½ͷ
+    data = "GET /next HTTP/1.1\r\n\r\n";
+    segments[0].buf = &data[0];
+    segments[0].len = (u_long)data.size();
+    {
+        InBuffer in(&segments, data.size());
+        ASSERT_TRUE(parse_status::complete == parser.parse(in, request, messageLength));
+        ASSERT_TRUE("/next" == request.uri.str());
+        ASSERT_TRUE(request.body.empty());
+    }
+}
+
+# ifndef _GOOGLETEST_
+
+namespace
+{
+    void runHttpBenchmark(BenchmarkState& state, size_t pipeline)
+    {
+        std::string data;
+        for (size_t i = 0; i < pipeline; ++ i)
+            data.append(SMALL_GET);
+
+        LoopbackTransport transport;
+        CountHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+        state.setBytesProcessed(data.size());
+
+        for (size_t i = 0; i < state.iterations(); ++ i)
+        {
+            DO_NOT_OPTIMIZE(transport.receive(data, 4096));
+            transport.wire.clear();
+        }
+    }
+}
+
+BENCHMARK(HttpProtocol_small_get)
+{
+    runHttpBenchmark(state, 1);
+}
+
+BENCHMARK(HttpProtocol_small_get_pipelined_16)
+{
+    runHttpBenchmark(state, 16);
+}
+
+/**
+ * ͷ֮ 64K  1K һε, ÿζ½ͷʱͷԽ
+ * Խ
+ */
+BENCHMARK(HttpProtocol_post_body_1k_steps)
+{
+    std::string data("POST /upload HTTP/1.1\r\nHost: localhost\r\nUser-Agent: bench\r\n"
+                     "Content-Type: application/octet-stream\r\nContent-Length: 65536\r\n\r\n");
+    size_t headLength = data.size();
+    data.append(65536, 'x');
+    state.setBytesProcessed(data.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        LoopbackTransport transport;
+        CountHandler handler;
+        HttpProtocol protocol(&handler, &transport, null_ptr, 8*1024, 1024*1024);
+        transport.bindProtocol(&protocol);
+
+        for (size_t length = headLength + 1024; length < data.size(); length += 1024)
+            DO_NOT_OPTIMIZE(transport.receive(data.data(), length));
+        DO_NOT_OPTIMIZE(transport.receive(data));
+    }
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -0,0 +1,408 @@
+
+# include "pro_config.h"
+# include "jingxian/protocol/http/HttpParser.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+// ֿ鳤е󳤶( չ )
+const size_t MAX_CHUNK_LINE = 256;
+
+inline bool isTokenChar(char ch)
+{
+    return ' ' != ch && '\t' != ch && '\r' != ch && '\n' != ch && ':' != ch;
+}
+
+inline HttpString trimSpace(const char* begin, const char* end)
+{
+    while (begin < end && (' ' == *begin || '\t' == *begin))
+        ++ begin;
+    while (end > begin && (' ' == *(end - 1) || '\t' == *(end - 1)))
+        -- end;
+    return HttpString(begin, end - begin);
+}
+
+/**
+ * ŷָбǷֵָ( ִСд )
+ */
+inline bool containsToken(const HttpString& value, const char* token)
+{
+    const char* begin = value.ptr;
+    const char* end = value.ptr + value.len;
+    while (begin < end)
+    {
+        const char* comma = (const char*)::memchr(begin, ',', end - begin);
+        if (is_null(comma))
+            comma = end;
+
+        if (trimSpace(begin, comma).equalsIgnoreCase(token))
+            return true;
+        begin = comma + 1;
+    }
+    return false;
+}
+
+inline bool parseDecimal(const HttpString& value, size_t& result)
+{
+    if (value.empty())
+        return false;
+
+    size_t number = 0;
+    for (size_t i = 0; i < value.len; ++ i)
+    {
+        char ch = value.ptr[i];
+        if (ch < '0' || ch > '9')
+            return false;
+        if (number > (((size_t) - 1) - 9) / 10)
+            return false;
+        number = number * 10 + (ch - '0');
+    }
+    result = number;
+    return true;
+}
+
+HttpRequestParser::HttpRequestParser(size_t maxHeaderSize, size_t maxBodySize)
+    : maxHeaderSize_(maxHeaderSize)
+    , maxBodySize_(maxBodySize)
+    , searched_(0)
+    , headLength_(0)
+    , chunkParsed_(0)
+    , chunkTrailer_(false)
+    , trailerLength_(0)
+{
+}
+
+parse_status::type HttpRequestParser::parse(InBuffer& in, HttpRequest& request, size_t& messageLength)
+{
+    request.clear();
+
+    size_t available = in.size();
+
+    // ϴ岻, ͷѽ, ֱӴ忪ʼ
+    if (0 != headLength_)
+    {
+        request = head_;
+        in.seek((int)headLength_);
+
+        parse_status::type status = parseBody(in, request);
+        if (parse_status::incomplete == status)
+            return status;
+
+        headLength_ = 0;
+        if (parse_status::complete == status)
+            messageLength = available - in.size();
+        return status;
+    }
+
+    // ͷĽβ, ϴѲҹĲֲٲ
+    size_t skip = (searched_ >= 4) ? (searched_ - 3) : 0;
+    if (0 != skip)
+        in.seek((int)skip);
+
+    size_t pos = in.search("\r\n\r\n", 4);
+
+    if (0 != skip)
+        in.seek(-(int)skip);
+
+    if (buffer_type::npos == pos)
+    {
+        searched_ = available;
+        return (available > maxHeaderSize_) ? parse_status::header_too_large : parse_status::incomplete;
+    }
+
+    searched_ = 0;
+    size_t headLength = pos + skip + 4;
+    if (headLength > maxHeaderSize_)
+        return parse_status::header_too_large;
+
+    size_t len = 0;
+    const char* head = in.peek(len);
+    if (len >= headLength)
+    {
+        in.seek((int)headLength);
+    }
+    else
+    {
+        headBuffer_.resize(headLength);
+        in.readBlob(&headBuffer_[0], headLength);
+        head = &headBuffer_[0];
+    }
+
+    parse_status::type status = parseHead(head, headLength, request);
+    if (parse_status::complete != status)
+        return status;
+
+    status = parseBody(in, request);
+    if (parse_status::incomplete == status)
+    {
+        headLength_ = headLength;
+        keepHead(head, request);
+        return status;
+    }
+
+    if (parse_status::complete == status)
+        messageLength = available - in.size();
+    return status;
+}
+
+parse_status::type HttpRequestParser::parseBody(InBuffer& in, HttpRequest& request)
+{
+    if (request.chunked)
+    {
+        parse_status::type status = parseChunked(in, request);
+
+        // 󲻻ټ
+        if (parse_status::complete != status && parse_status::incomplete != status)
+            chunkParsed_ = 0;
+        return status;
+    }
+
+    if (0 < request.contentLength)
+    {
+        if (request.contentLength > maxBodySize_)
+            return parse_status::body_too_large;
+
+        if (in.size() < request.contentLength)
+            return parse_status::incomplete;
+
+        size_t len = 0;
+        const char* body = in.peek(len);
+        if (len >= request.contentLength)
+        {
+            in.seek((int)request.contentLength);
+        }
+        else
+        {
+            bodyBuffer_.resize(request.contentLength);
+            in.readBlob(&bodyBuffer_[0], request.contentLength);
+            body = &bodyBuffer_[0];
+        }
+        request.body = HttpString(body, request.contentLength);
+    }
+    return parse_status::complete;
+}
+
+void HttpRequestParser::keepHead(const char* head, const HttpRequest& request)
+{
+    // ͷָջʱƵ headBuffer_ , ´յʱջ
+    // Ѿƶ
+    if (headBuffer_.empty() || head != &headBuffer_[0])
+    {
+        headBuffer_.assign(head, head + headLength_);
+    }
+
+    const char* base = &headBuffer_[0];
+    head_ = request;
+    head_.method.ptr = base + (request.method.ptr - head);
+    head_.uri.ptr = base + (request.uri.ptr - head);
+    for (size_t i = 0; i < head_.headers.size(); ++ i)
+    {
+        head_.headers[i].name.ptr = base + (request.headers[i].name.ptr - head);
+        head_.headers[i].value.ptr = base + (request.headers[i].value.ptr - head);
+    }
+}
+
+parse_status::type HttpRequestParser::parseHead(const char* ptr, size_t len, HttpRequest& request)
+{
+    const char* end = ptr + len;
+
+    // : METHOD SP URI SP HTTP/x.y CRLF
+    const char* lineEnd = (const char*)::memchr(ptr, '\r', end - ptr);
+    if (is_null(lineEnd) || lineEnd + 1 >= end || '\n' != lineEnd[1])
+        return parse_status::bad_request;
+
+    const char* sp = (const char*)::memchr(ptr, ' ', lineEnd - ptr);
+    if (is_null(sp) || sp == ptr)
+        return parse_status::bad_request;
+    request.method = HttpString(ptr, sp - ptr);
+
+    const char* uri = sp + 1;
+    sp = (const char*)::memchr(uri, ' ', lineEnd - uri);
+    if (is_null(sp) || sp == uri)
+        return parse_status::bad_request;
+    request.uri = HttpString(uri, sp - uri);
+
+    const char* version = sp + 1;
+    if (8 != (lineEnd - version)
+            || 0 != ::memcmp(version, "HTTP/", 5)
+            || version[5] < '0' || version[5] > '9'
+            || '.' != version[6]
+            || version[7] < '0' || version[7] > '9')
+        return parse_status::bad_request;
+
+    request.versionMajor = version[5] - '0';
+    request.versionMinor = version[7] - '0';
+    if (1 != request.versionMajor)
+        return parse_status::bad_request;
+    request.keepAlive = (1 <= request.versionMinor);
+
+    bool hasContentLength = false;
+    bool hasTransferEncoding = false;
+
+    // ͷ: NAME ":" OWS VALUE OWS CRLF, Կн
+    ptr = lineEnd + 2;
+    while (ptr < end)
+    {
+        lineEnd = (const char*)::memchr(ptr, '\r', end - ptr);
+        if (is_null(lineEnd) || lineEnd + 1 >= end || '\n' != lineEnd[1])
+            return parse_status::bad_request;
+
+        if (lineEnd == ptr)
+            break;
+
+        const char* colon = (const char*)::memchr(ptr, ':', lineEnd - ptr);
+        if (is_null(colon) || colon == ptr)
+            return parse_status::bad_request;
+
+        for (const char* p = ptr; p < colon; ++ p)
+        {
+            // ֧ obs-fold, Ҳհ
+            if (!isTokenChar(*p))
+                return parse_status::bad_request;
+        }
+
+        HttpHeader header;
+        header.name = HttpString(ptr, colon - ptr);
+        header.value = trimSpace(colon + 1, lineEnd);
+        request.headers.push_back(header);
+
+        if (header.name.equalsIgnoreCase("Content-Length"))
+        {
+            size_t length = 0;
+            if (!parseDecimal(header.value, length))
+                return parse_status::bad_request;
+            if (hasContentLength && length != request.contentLength)
+                return parse_status::bad_request;
+            hasContentLength = true;
+            request.contentLength = length;
+        }
+        else if (header.name.equalsIgnoreCase("Transfer-Encoding"))
+        {
+            // ֻ֧ chunked
+            if (!header.value.equalsIgnoreCase("chunked"))
+                return parse_status::bad_request;
+            hasTransferEncoding = true;
+            request.chunked = true;
+        }
+        else if (header.name.equalsIgnoreCase("Connection"))
+        {
+            if (containsToken(header.value, "close"))
+                request.keepAlive = false;
+            else if (containsToken(header.value, "keep-alive"))
+                request.keepAlive = true;
+        }
+
+        ptr = lineEnd + 2;
+    }
+
+    // ͬʱʱ˽, ֱӾܾ
+    if (hasContentLength && hasTransferEncoding)
+        return parse_status::bad_request;
+
+    return parse_status::complete;
+}
+
+parse_status::type HttpRequestParser::parseChunked(InBuffer& in, HttpRequest& request)
+{
+    // ϴνλü
+    if (0 == chunkParsed_)
+    {
+        bodyBuffer_.clear();
+        chunkTrailer_ = false;
+        trailerLength_ = 0;
+    }
+    else
+    {
+        in.seek((int)chunkParsed_);
+    }
+
+    char line[MAX_CHUNK_LINE + 2];
+    while (!chunkTrailer_)
+    {
+        // chunk-size [ chunk-ext ] CRLF
+        size_t lineLength = in.search("\r\n", 2);
+        if (buffer_type::npos == lineLength)
+            return (in.size() > MAX_CHUNK_LINE) ? parse_status::bad_request : parse_status::incomplete;
+        if (lineLength > MAX_CHUNK_LINE)
+            return parse_status::bad_request;
+
+        in.readBlob(line, lineLength + 2);
+
+        size_t chunkSize = 0;
+        size_t digits = 0;
+        for (; digits < lineLength; ++ digits)
+        {
+            char ch = line[digits];
+            int value;
+            if (ch >= '0' && ch <= '9')
+                value = ch - '0';
+            else if (ch >= 'a' && ch <= 'f')
+                value = ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F')
+                value = ch - 'A' + 10;
+            else
+                break;
+
+            if (chunkSize > (((size_t) - 1) >> 4))
+                return parse_status::bad_request;
+            chunkSize = (chunkSize << 4) | value;
+        }
+
+        if (0 == digits || (digits < lineLength && ';' != line[digits]
+                            && ' ' != line[digits] && '\t' != line[digits]))
+            return parse_status::bad_request;
+
+        if (0 == chunkSize)
+        {
+            chunkTrailer_ = true;
+            chunkParsed_ += lineLength + 2;
+            break;
+        }
+
+        if (chunkSize > maxBodySize_ || bodyBuffer_.size() + chunkSize > maxBodySize_)
+            return parse_status::body_too_large;
+
+        // ֿ鲻ʱ´¶, в MAX_CHUNK_LINE
+        if (in.size() < chunkSize + 2)
+            return parse_status::incomplete;
+
+        size_t offset = bodyBuffer_.size();
+        bodyBuffer_.resize(offset + chunkSize);
+        in.readBlob(&bodyBuffer_[offset], chunkSize);
+
+        char crlf[2];
+        in.readBlob(crlf, 2);
+        if ('\r' != crlf[0] || '\n' != crlf[1])
+            return parse_status::bad_request;
+
+        chunkParsed_ += lineLength + 2 + chunkSize + 2;
+    }
+
+    //  trailer, ֱ
+    for (;;)
+    {
+        size_t pos = in.search("\r\n", 2);
+        if (buffer_type::npos == pos)
+            return (in.size() > maxHeaderSize_) ? parse_status::header_too_large : parse_status::incomplete;
+
+        in.seek((int)(pos + 2));
+        chunkParsed_ += pos + 2;
+        if (0 == pos)
+            break;
+
+        trailerLength_ += pos + 2;
+        if (trailerLength_ > maxHeaderSize_)
+            return parse_status::header_too_large;
+    }
+
+    chunkParsed_ = 0;
+    request.contentLength = bodyBuffer_.size();
+    request.body = bodyBuffer_.empty() ? HttpString() : HttpString(&bodyBuffer_[0], bodyBuffer_.size());
+    return parse_status::complete;
+}
+
+}
+
+_jingxian_end
@@ -0,0 +1,104 @@
+
+#ifndef _HttpParser_H_
+#define _HttpParser_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/buffer/InBuffer.h"
+# include "jingxian/protocol/http/HttpRequest.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+namespace parse_status
+{
+    enum type
+    {
+        complete            // յһ
+        , incomplete        // ݲ, ȴ
+        , bad_request       // ʽ( 400 )
+        , header_too_large  // ͷ̫( 431 )
+        , body_too_large    // ̫( 413 )
+    };
+}
+
+/**
+ * ʽ HTTP/1.x , ֱڽյڴϽ.
+ *
+ * ͷһڴʱ, ֱֶָջ; Խڴ
+ * ͷŸƵڲ( õ ). ͷʱס
+ * ҹĳ; 岻ʱѽͷƵڲб, ֿ
+ * 廹סѽķֿ, ´յʱظҺͽ.
+ */
+class HttpRequestParser
+{
+public:
+    HttpRequestParser(size_t maxHeaderSize = 8*1024, size_t maxBodySize = 1024*1024);
+
+    /**
+     *  in ĵǰλýһ
+     *
+     * @param[ in ] in յ
+     * @param[ out ] request 
+     * @param[ out ] messageLength ܳ( ͷ )
+     */
+    parse_status::type parse(InBuffer& in, HttpRequest& request, size_t& messageLength);
+
+    size_t maxHeaderSize() const
+    {
+        return maxHeaderSize_;
+    }
+
+    size_t maxBodySize() const
+    {
+        return maxBodySize_;
+    }
+
+    /**
+     * ͷĻռõֽ
+     */
+    size_t memory() const
+    {
+        return headBuffer_.capacity() + bodyBuffer_.capacity();
+    }
+
+private:
+    NOCOPY(HttpRequestParser);
+
+    parse_status::type parseHead(const char* ptr, size_t len, HttpRequest& request);
+    parse_status::type parseBody(InBuffer& in, HttpRequest& request);
+    parse_status::type parseChunked(InBuffer& in, HttpRequest& request);
+    void keepHead(const char* head, const HttpRequest& request);
+
+    size_t maxHeaderSize_;
+    size_t maxBodySize_;
+    // ͷʱѲҹֽ
+    size_t searched_;
+    // Խڴͷ, 岻ʱͷ
+    std::vector<char> headBuffer_;
+    // 岻ʱѽͷĳ, Ϊ 0 ʱû
+    size_t headLength_;
+    // ѽͷ, ֶָ headBuffer_
+    HttpRequest head_;
+    // Խڴֿ鴫
+    std::vector<char> bodyBuffer_;
+    // ֿѽֽ( 忪ʼ ), ѽķֿ鱣
+    //  bodyBuffer_ 
+    size_t chunkParsed_;
+    // Ƿѽ trailer
+    bool chunkTrailer_;
+    size_t trailerLength_;
+};
+
+}
+
+_jingxian_end
+
+#endif //_HttpParser_H_
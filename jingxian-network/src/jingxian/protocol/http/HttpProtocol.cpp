@@ -0,0 +1,247 @@
+
+# include "pro_config.h"
+# include "jingxian/protocol/http/HttpProtocol.h"
+# include "jingxian/IReactorCore.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+HttpProtocol::HttpProtocol(IHttpHandler* handler
+                           , ITransport* transport
+                           , IReactorCore* core
+                           , size_t maxHeaderSize
+                           , size_t maxBodySize
+                           , uint32_t idleTimeout)
+    : BaseProtocol(_T("HttpProtocol"))
+    , handler_(handler)
+    , transport_(transport)
+    , core_(core)
+    , timers_(is_null(core) ? null_ptr : &(core->timers()))
+    , idleTimeout_(idleTimeout)
+    , parser_(maxHeaderSize, maxBodySize)
+    , parserCharge_(MemoryKind::Receive)
+    , closing_(false)
+    , disconnecting_(false)
+    , disconnected_(false)
+{
+    idleTimer_.initialize(this);
+}
+
+HttpProtocol::~HttpProtocol()
+{
+    if (!is_null(timers_))
+        timers_->cancel(&idleTimer_);
+
+    for (std::deque<HttpResponse*>::iterator it = pending_.begin()
+            ; it != pending_.end(); ++ it)
+        delete *it;
+
+    for (std::vector<HttpResponse*>::iterator it = free_.begin()
+            ; it != free_.end(); ++ it)
+        delete *it;
+}
+
+void HttpProtocol::touch()
+{
+    if (is_null(timers_) || 0 == idleTimeout_ || disconnecting_ || disconnected_)
+        return;
+    timers_->schedule(&idleTimer_, idleTimeout_);
+}
+
+void HttpProtocol::onIdle()
+{
+    // ڴʱ
+    if (!pending_.empty())
+    {
+        touch();
+        return;
+    }
+
+    LOG_TRACE(logger_, _T("ӿгʱ - ") << transport_->peer());
+    closing_ = true;
+    disconnecting_ = true;
+    transport_->disconnection(_T("HTTP ӿгʱ"));
+}
+
+void HttpProtocol::onConnected(ProtocolContext& context)
+{
+    LOG_TRACE(logger_, _T("ӵ - ") << context.transport().peer());
+    touch();
+}
+
+void HttpProtocol::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
+{
+    LOG_TRACE(logger_, _T("ӶϿ - ") << context.transport().peer()
+              << _T(" - ") << reason);
+
+    disconnected_ = true;
+    if (!is_null(timers_))
+        timers_->cancel(&idleTimer_);
+
+    for (std::deque<HttpResponse*>::iterator it = pending_.begin()
+            ; it != pending_.end(); ++ it)
+    {
+        // 첽е, ǽɾ
+        if (!(*it)->isEnded())
+            return;
+    }
+
+    delete this;
+}
+
+size_t HttpProtocol::onReceived(ProtocolContext& context)
+{
+    if (closing_ || disconnected_)
+        return context.inBytes();
+
+    touch();
+
+    InBuffer in(&context.inMemory(), context.inBytes());
+    size_t consumed = 0;
+
+    while (0 < in.size())
+    {
+        size_t messageLength = 0;
+        parse_status::type status = parser_.parse(in, request_, messageLength);
+        if (parse_status::incomplete == status)
+            break;
+
+        if (parse_status::complete != status)
+        {
+            sendError(status);
+            consumed = context.inBytes();
+            break;
+        }
+
+        consumed += messageLength;
+
+        HttpResponse* response = allocResponse(request_);
+        pending_.push_back(response);
+        handler_->onRequest(request_, *response);
+
+        if (!response->isDeferred())
+            response->ended_ = true;
+
+        if (!response->keepAlive())
+        {
+            closing_ = true;
+            break;
+        }
+    }
+
+    parserCharge_.update(parser_.memory());
+    flush();
+    return consumed;
+}
+
+size_t HttpProtocol::memory() const
+{
+    return parserCharge_.bytes();
+}
+
+void HttpProtocol::onResponseEnded()
+{
+    if (!disconnected_)
+    {
+        flush();
+        return;
+    }
+
+    for (std::deque<HttpResponse*>::iterator it = pending_.begin()
+            ; it != pending_.end(); ++ it)
+    {
+        if (!(*it)->isEnded())
+            return;
+    }
+
+    delete this;
+}
+
+void HttpProtocol::flush()
+{
+    if (disconnecting_ || pending_.empty() || !pending_.front()->isEnded())
+        return;
+
+    {
+        OutBuffer out(transport_);
+        while (!pending_.empty() && pending_.front()->isEnded())
+        {
+            HttpResponse* response = pending_.front();
+            pending_.pop_front();
+
+            response->serialize(out);
+            free_.push_back(response);
+
+            if (!response->keepAlive())
+            {
+                // Ļظٷ
+                closing_ = true;
+                disconnecting_ = true;
+                break;
+            }
+        }
+    }
+
+    // out ʱѽ, ӷϿ
+    if (disconnecting_)
+    {
+        if (!is_null(timers_))
+            timers_->cancel(&idleTimer_);
+        transport_->disconnection(_T("HTTP ӹر"));
+    }
+    else if (pending_.empty())
+    {
+        touch();
+    }
+}
+
+void HttpProtocol::sendError(parse_status::type status)
+{
+    HttpResponse* response = allocResponse(request_);
+    switch (status)
+    {
+    case parse_status::header_too_large:
+        response->status(431, "Request Header Fields Too Large");
+        break;
+    case parse_status::body_too_large:
+        response->status(413, "Payload Too Large");
+        break;
+    default:
+        response->status(400, "Bad Request");
+        break;
+    }
+
+    LOG_WARN(logger_, _T("յ - ") << transport_->peer()
+             << _T(" - ") << response->statusCode());
+
+    response->write(response->reason_);
+    response->close();
+    response->ended_ = true;
+    pending_.push_back(response);
+    closing_ = true;
+}
+
+HttpResponse* HttpProtocol::allocResponse(const HttpRequest& request)
+{
+    HttpResponse* response;
+    if (free_.empty())
+    {
+        response = new HttpResponse(this);
+    }
+    else
+    {
+        response = free_.back();
+        free_.pop_back();
+    }
+
+    response->reset(request.versionMinor
+                    , request.keepAlive
+                    , request.method.equals("HEAD"));
+    return response;
+}
+
+}
+
+_jingxian_end
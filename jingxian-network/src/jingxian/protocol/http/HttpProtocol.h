@@ -0,0 +1,134 @@
+
+#ifndef _HttpProtocol_H_
+#define _HttpProtocol_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <deque>
+# include <vector>
+# include "jingxian/IReactorCore.h"
+# include "jingxian/networks/TimerQueue.h"
+# include "jingxian/protocol/BaseProtocol.h"
+# include "jingxian/protocol/http/HttpParser.h"
+# include "jingxian/protocol/http/IHttpHandler.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+/**
+ * HTTP/1.1 Э, ÿһʵ
+ *
+ * ֧ keep-alive ˮ( ظ˳ ), ֧
+ * Content-Length  chunked ַʽ. յ Connection: close(  HTTP/1.0
+ * û keep-alive,  )ٴ, һظ
+ * Ͽ.  idleTimeout ûյ, ҲûڴʱϿ.
+ */
+class HttpProtocol : public BaseProtocol
+{
+public:
+    HttpProtocol(IHttpHandler* handler
+                 , ITransport* transport
+                 , IReactorCore* core
+                 , size_t maxHeaderSize
+                 , size_t maxBodySize
+                 , uint32_t idleTimeout = 0);
+
+    virtual ~HttpProtocol();
+
+    virtual void onConnected(ProtocolContext& context);
+
+    virtual void onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason);
+
+    virtual size_t onReceived(ProtocolContext& context);
+
+    virtual size_t memory() const;
+
+    IReactorCore& core()
+    {
+        return *core_;
+    }
+
+private:
+    NOCOPY(HttpProtocol);
+
+    friend class HttpResponse;
+
+    class IdleTimer : public Timer
+    {
+    public:
+        IdleTimer()
+                : owner_(null_ptr)
+        {
+        }
+
+        void initialize(HttpProtocol* owner)
+        {
+            owner_ = owner;
+        }
+
+        virtual void onTimeout()
+        {
+            owner_->onIdle();
+        }
+
+    private:
+        HttpProtocol* owner_;
+    };
+
+    /**
+     * ¿ʼʱ
+     */
+    void touch();
+
+    void onIdle();
+
+    /**
+     * ӳٵĻظʱ
+     */
+    void onResponseEnded();
+
+    /**
+     * ˳ͶͷѽĻظ
+     */
+    void flush();
+
+    void sendError(parse_status::type status);
+
+    HttpResponse* allocResponse(const HttpRequest& request);
+
+    IHttpHandler* handler_;
+    ITransport* transport_;
+    IReactorCore* core_;
+    // Ϊ null_ptr  idleTimeout_ Ϊ 0 ʱ
+    TimerQueue* timers_;
+    uint32_t idleTimeout_;
+    IdleTimer idleTimer_;
+    HttpRequestParser parser_;
+    /// parser_ Ļռõڴ
+    MemoryCharge parserCharge_;
+    HttpRequest request_;
+
+    // ȴ͵Ļظ( ˳ )
+    std::deque<HttpResponse*> pending_;
+    // õĻظ
+    std::vector<HttpResponse*> free_;
+
+    // ٴ
+    bool closing_;
+    // һظѽ, ڶϿ
+    bool disconnecting_;
+    bool disconnected_;
+};
+
+}
+
+_jingxian_end
+
+#endif //_HttpProtocol_H_
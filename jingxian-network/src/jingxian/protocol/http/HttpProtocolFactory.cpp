@@ -0,0 +1,82 @@
+
+# include "pro_config.h"
+# include "jingxian/string/string.h"
+# include "jingxian/protocol/http/HttpProtocolFactory.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+void DefaultHttpHandler::onRequest(const HttpRequest& request, HttpResponse& response)
+{
+    if (!request.method.equals("GET") && !request.method.equals("HEAD"))
+    {
+        response.status(405, "Method Not Allowed");
+        response.header("Allow", "GET, HEAD");
+        return;
+    }
+
+    response.header("Content-Type", "text/plain");
+    response.write("jingxian\r\n", 10);
+}
+
+HttpProtocolFactory::HttpProtocolFactory(IHttpHandler* handler)
+    : handler_(handler)
+    , maxHeaderSize_(8*1024)
+    , maxBodySize_(1024*1024)
+    , idleTimeout_(60)
+    , toString_(_T("HTTP "))
+{
+    if (is_null(handler_))
+    {
+        defaultHandler_.reset(new DefaultHttpHandler());
+        handler_ = defaultHandler_.get();
+    }
+}
+
+IProtocol* HttpProtocolFactory::createProtocol(ITransport* transport, IReactorCore* core)
+{
+    return new HttpProtocol(handler_, transport, core, maxHeaderSize_, maxBodySize_
+                            , (uint32_t)(idleTimeout_ * 1000));
+}
+
+bool HttpProtocolFactory::configure(configure::Context& context, const tstring& t)
+{
+    StringArray<tstring::value_type> sa = split(t.c_str()
+                                          , _T(" \t")
+                                          , StringSplitOptions::RemoveEmptyEntries);
+
+    if (0 == sa.size())
+        return true;
+
+    size_t* value = null_ptr;
+    if (0 == string_traits<tstring::value_type>::stricmp(_T("maxHeaderSize"), sa.ptr(0)))
+        value = &maxHeaderSize_;
+    else if (0 == string_traits<tstring::value_type>::stricmp(_T("maxBodySize"), sa.ptr(0)))
+        value = &maxBodySize_;
+    else if (0 == string_traits<tstring::value_type>::stricmp(_T("idleTimeout"), sa.ptr(0)))
+        value = &idleTimeout_;
+    else
+        return false;
+
+    int size = (2 == sa.size()) ? string_traits<tstring::value_type>::atoi(sa.ptr(1)) : 0;
+    if (0 >= size)
+    {
+        LOG_FATAL(context.logger(), _T(" '") << sa.ptr(0) << _T("' ʽȷ"));
+        context.exit();
+        return true;
+    }
+
+    *value = (size_t)size;
+    return true;
+}
+
+const tstring& HttpProtocolFactory::toString() const
+{
+    return toString_;
+}
+
+}
+
+_jingxian_end
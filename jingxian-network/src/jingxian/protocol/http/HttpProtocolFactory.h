@@ -0,0 +1,66 @@
+
+#ifndef _HttpProtocolFactory_H_
+#define _HttpProtocolFactory_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <memory>
+# include "jingxian/protocol/http/HttpProtocol.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+/**
+ * ȱʡĴ, GET  HEAD һ򵥵ı,  405
+ */
+class DefaultHttpHandler : public IHttpHandler
+{
+public:
+    virtual void onRequest(const HttpRequest& request, HttpResponse& response);
+};
+
+/**
+ * HTTP Э鹤, ֵ֧
+ *
+ *   maxHeaderSize <ֽ>
+ *   maxBodySize <ֽ>
+ *   idleTimeout <>     жúϿ, ȱʡΪ 60 
+ */
+class HttpProtocolFactory : public IProtocolFactory
+{
+public:
+    /**
+     * @param[ in ] handler , Ϊ null_ptr ʱʹ DefaultHttpHandler
+     * @remarks handler ɵ߹
+     */
+    HttpProtocolFactory(IHttpHandler* handler = null_ptr);
+
+    virtual IProtocol* createProtocol(ITransport* transport, IReactorCore* core);
+
+    virtual bool configure(configure::Context& context, const tstring& t);
+
+    virtual const tstring& toString() const;
+
+private:
+    NOCOPY(HttpProtocolFactory);
+
+    std::auto_ptr<IHttpHandler> defaultHandler_;
+    IHttpHandler* handler_;
+    size_t maxHeaderSize_;
+    size_t maxBodySize_;
+    size_t idleTimeout_;
+    tstring toString_;
+};
+
+}
+
+_jingxian_end
+
+#endif //_HttpProtocolFactory_H_
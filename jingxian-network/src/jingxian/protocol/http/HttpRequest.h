@@ -0,0 +1,125 @@
+
+#ifndef _HttpRequest_H_
+#define _HttpRequest_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <vector>
+# include "jingxian/string/string.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+/**
+ * ָջеһַ, ӵڴ, ֻ onRequest Ч
+ */
+struct HttpString
+{
+    const char* ptr;
+    size_t len;
+
+    HttpString()
+        : ptr(null_ptr)
+        , len(0)
+    {
+    }
+
+    HttpString(const char* p, size_t l)
+        : ptr(p)
+        , len(l)
+    {
+    }
+
+    bool empty() const
+    {
+        return 0 == len;
+    }
+
+    bool equals(const char* str) const
+    {
+        return len == ::strlen(str) && 0 == ::memcmp(ptr, str, len);
+    }
+
+    bool equalsIgnoreCase(const char* str) const
+    {
+        return len == ::strlen(str) && 0 == ::_strnicmp(ptr, str, len);
+    }
+
+    std::string str() const
+    {
+        return (0 == len) ? std::string() : std::string(ptr, len);
+    }
+};
+
+struct HttpHeader
+{
+    HttpString name;
+    HttpString value;
+};
+
+/**
+ * HTTP , ֶζֱָյ
+ */
+class HttpRequest
+{
+public:
+    HttpRequest()
+        : versionMajor(1)
+        , versionMinor(1)
+        , contentLength(0)
+        , chunked(false)
+        , keepAlive(true)
+    {
+    }
+
+    void clear()
+    {
+        method = HttpString();
+        uri = HttpString();
+        versionMajor = 1;
+        versionMinor = 1;
+        headers.clear();
+        body = HttpString();
+        contentLength = 0;
+        chunked = false;
+        keepAlive = true;
+    }
+
+    /**
+     * ָ( ִСд )ͷ, Ҳʱ null_ptr
+     */
+    const HttpString* header(const char* name) const
+    {
+        for (std::vector<HttpHeader>::const_iterator it = headers.begin()
+                ; it != headers.end(); ++ it)
+        {
+            if (it->name.equalsIgnoreCase(name))
+                return &(it->value);
+        }
+        return null_ptr;
+    }
+
+    HttpString method;
+    HttpString uri;
+    int versionMajor;
+    int versionMinor;
+    std::vector<HttpHeader> headers;
+    HttpString body;
+
+    size_t contentLength;
+    bool chunked;
+    bool keepAlive;
+};
+
+}
+
+_jingxian_end
+
+#endif //_HttpRequest_H_
@@ -0,0 +1,133 @@
+
+# include "pro_config.h"
+# include "jingxian/IReactorCore.h"
+# include "jingxian/protocol/http/HttpResponse.h"
+# include "jingxian/protocol/http/HttpProtocol.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+namespace
+{
+    class EndResponseRunnable : public IRunnable
+    {
+    public:
+        EndResponseRunnable(HttpResponse* response)
+            : response_(response)
+        {
+        }
+
+        virtual void run()
+        {
+            response_->end();
+        }
+
+    private:
+        NOCOPY(EndResponseRunnable);
+
+        HttpResponse* response_;
+    };
+
+    void writeString(OutBuffer& out, const char* str)
+    {
+        out.writeBlob(str, ::strlen(str));
+    }
+
+    void writeNumber(OutBuffer& out, size_t number)
+    {
+        char buf[24];
+        char* p = buf + sizeof(buf);
+        do
+        {
+            *--p = (char)('0' + number % 10);
+            number /= 10;
+        }
+        while (0 != number);
+        out.writeBlob(p, buf + sizeof(buf) - p);
+    }
+}
+
+HttpResponse::HttpResponse(HttpProtocol* owner)
+    : owner_(owner)
+{
+    reset(1, true, false);
+}
+
+void HttpResponse::reset(int versionMinor, bool keepAlive, bool headRequest)
+{
+    statusCode_ = 200;
+    reason_ = "OK";
+    headers_.clear();
+    body_.clear();
+    versionMinor_ = versionMinor;
+    keepAlive_ = keepAlive;
+    headRequest_ = headRequest;
+    deferred_ = false;
+    ended_ = false;
+}
+
+void HttpResponse::status(int code, const char* reason)
+{
+    statusCode_ = code;
+    reason_ = reason;
+}
+
+void HttpResponse::header(const char* name, const char* value)
+{
+    headers_.append(name);
+    headers_.append(": ");
+    headers_.append(value);
+    headers_.append("\r\n");
+}
+
+void HttpResponse::write(const char* data, size_t len)
+{
+    body_.append(data, len);
+}
+
+void HttpResponse::end()
+{
+    if (ended_)
+        return;
+
+    ended_ = true;
+    if (deferred_)
+        owner_->onResponseEnded();
+}
+
+bool HttpResponse::post()
+{
+    return owner_->core().send(new EndResponseRunnable(this));
+}
+
+void HttpResponse::serialize(OutBuffer& out) const
+{
+    writeString(out, (0 == versionMinor_) ? "HTTP/1.0 " : "HTTP/1.1 ");
+    writeNumber(out, statusCode_);
+    out.writeBlob(" ", 1);
+    out.writeBlob(reason_.c_str(), reason_.size());
+    out.writeBlob("\r\n", 2);
+
+    if (!headers_.empty())
+        out.writeBlob(headers_.c_str(), headers_.size());
+
+    writeString(out, "Content-Length: ");
+    writeNumber(out, body_.size());
+    out.writeBlob("\r\n", 2);
+
+    if (!keepAlive_)
+        writeString(out, "Connection: close\r\n");
+    else if (0 == versionMinor_)
+        writeString(out, "Connection: keep-alive\r\n");
+
+    out.writeBlob("\r\n", 2);
+
+    if (!headRequest_ && !body_.empty())
+        out.writeBlob(body_.c_str(), body_.size());
+}
+
+}
+
+_jingxian_end
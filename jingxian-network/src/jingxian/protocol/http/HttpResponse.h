@@ -0,0 +1,125 @@
+
+#ifndef _HttpResponse_H_
+#define _HttpResponse_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/string/string.h"
+# include "jingxian/buffer/OutBuffer.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+class HttpProtocol;
+
+/**
+ * HTTP ظ
+ *
+ * ͬʱ IHttpHandler::onRequest дظ, onRequest غԶ
+ * . 첽ʱȵ defer(), Ȼ reactor ߳е end(), 
+ * ߳д post() ͨ IReactorCore::send ص reactor ߳̽.
+ * ˮϵĻظǰ˳.
+ */
+class HttpResponse
+{
+public:
+    HttpResponse(HttpProtocol* owner);
+
+    /**
+     * ״̬, ĬΪ 200 OK
+     */
+    void status(int code, const char* reason);
+
+    /**
+     * һͷ, Content-Length  Connection ЭԶ
+     */
+    void header(const char* name, const char* value);
+
+    /**
+     * ׷ӻظ
+     */
+    void write(const char* data, size_t len);
+
+    void write(const std::string& data)
+    {
+        write(data.c_str(), data.size());
+    }
+
+    /**
+     * 걾ظر
+     */
+    void close()
+    {
+        keepAlive_ = false;
+    }
+
+    /**
+     * ӳٻظ, onRequest غ󲻻ظ
+     */
+    void defer()
+    {
+        deferred_ = true;
+    }
+
+    /**
+     * ظ,  reactor ߳е
+     */
+    void end();
+
+    /**
+     * ߳нظ, غ󲻿ٷʱ
+     */
+    bool post();
+
+    int statusCode() const
+    {
+        return statusCode_;
+    }
+
+    bool keepAlive() const
+    {
+        return keepAlive_;
+    }
+
+    bool isDeferred() const
+    {
+        return deferred_;
+    }
+
+    bool isEnded() const
+    {
+        return ended_;
+    }
+
+private:
+    NOCOPY(HttpResponse);
+
+    friend class HttpProtocol;
+
+    void reset(int versionMinor, bool keepAlive, bool headRequest);
+    void serialize(OutBuffer& out) const;
+
+    HttpProtocol* owner_;
+    int statusCode_;
+    std::string reason_;
+    std::string headers_;
+    std::string body_;
+    int versionMinor_;
+    bool keepAlive_;
+    bool headRequest_;
+    bool deferred_;
+    bool ended_;
+};
+
+}
+
+_jingxian_end
+
+#endif //_HttpResponse_H_
@@ -0,0 +1,41 @@
+
+#ifndef _IHttpHandler_H_
+#define _IHttpHandler_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/protocol/http/HttpRequest.h"
+# include "jingxian/protocol/http/HttpResponse.h"
+
+_jingxian_begin
+
+namespace http
+{
+
+/**
+ * HTTP ӿ
+ */
+class IHttpHandler
+{
+public:
+    virtual ~IHttpHandler() {}
+
+    /**
+     * յһʱ(  reactor ߳ )
+     *
+     * @param[ in ] request , ֻڱεЧ, 첽ʱ븴Ҫֶ
+     * @param[ in ] response ظ,  response.defer() Ժ
+     */
+    virtual void onRequest(const HttpRequest& request, HttpResponse& response) = 0;
+};
+
+}
+
+_jingxian_end
+
+#endif //_IHttpHandler_H_
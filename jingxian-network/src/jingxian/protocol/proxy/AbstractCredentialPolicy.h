@@ -48,10 +48,16 @@ public:
         return _complete;
     }
 
+    virtual const tstring& user() const
+    {
+        return _user;
+    }
+
 protected:
     ProxyProtocolFactory* _server;
     config::Credential _credential;
     bool _complete;
+    tstring _user;
 };
 }
 
@@ -67,6 +67,7 @@ public:
         }
         else
         {
+            _user = toTstring(name);
             sendReply(context, AuthenticationStatus::Success);
         }
         return 3 + name.size() + password.size();
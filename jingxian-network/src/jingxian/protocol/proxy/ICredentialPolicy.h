@@ -55,6 +55,11 @@ public:
     * ֤ɣΪ trueΪ false
     */
     virtual bool isComplete() = 0;
+
+    /**
+    * ֤ͨû, Ҫ֤ʱΪ
+    */
+    virtual const tstring& user() const = 0;
 };
 
 class ICredentials
@@ -37,6 +37,14 @@ public:
     {
         return true;
     }
+
+    virtual const tstring& user() const
+    {
+        return user_;
+    }
+
+private:
+    tstring user_;
 };
 }
 
@@ -30,10 +30,6 @@ void SOCKSv5Incoming::write(const std::vector<io_mem_buf>& buffers)
             ; ++ it)
     {
         out.writeBlob(it->buf, it->len);
-#ifdef DUMPFILE
-        (*os) << std::string(it->buf, it->len);
-        os->flush();
-#endif
     }
 }
 
@@ -52,35 +48,14 @@ bool SOCKSv5Incoming::isActive() const
 
 size_t SOCKSv5Incoming::onReceived(ProtocolContext& context)
 {
-#ifdef DUMPFILE
-    for (std::vector<io_mem_buf>::const_iterator it = context.inMemory().begin()
-            ; it != context.inMemory().end()
-            ; ++ it)
-    {
-        *is << std::string(it->buf, it->len);
-        is->flush();
-    }
-#endif
-
     socks_->writeOutgoing(context.inMemory());
     return context.inBytes();
 }
 
-
-
 void SOCKSv5Incoming::onConnected(ProtocolContext& context)
 {
     BaseProtocol::onConnected(context);
     transport_ = &context.transport();
-
-#ifdef DUMPFILE
-    static int id = 0;
-    os.reset(new std::ofstream(toNarrowString(simplify(combinePath(combinePath(socks_->internalCore()->basePath(), _T("session")), concat<tstring>(_T("incoming_os_"), ::toString(++id), _T(".txt"))))).c_str()));
-    *os <<  toNarrowString(context.transport().toString())  << std::endl;
-
-    is.reset(new std::ofstream(toNarrowString(simplify(combinePath(combinePath(socks_->internalCore()->basePath(), _T("session")), concat<tstring>(_T("incoming_is_"), ::toString(id), _T(".txt"))))).c_str()));
-    *is  <<  toNarrowString(context.transport().toString()) << std::endl;
-#endif
 }
 
 void SOCKSv5Incoming::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
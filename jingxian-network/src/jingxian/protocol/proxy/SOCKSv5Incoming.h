@@ -40,11 +40,6 @@ public:
 private:
     SOCKSv5Protocol* socks_;
     ITransport* transport_;
-
-#ifdef DUMPFILE
-    std::auto_ptr<std::ofstream> os;
-    std::auto_ptr<std::ofstream> is;
-#endif
 };
 
 }
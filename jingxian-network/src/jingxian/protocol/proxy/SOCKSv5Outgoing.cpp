@@ -30,10 +30,6 @@ void SOCKSv5Outgoing::write(const std::vector<io_mem_buf>& buffers)
             ; ++ it)
     {
         out.writeBlob(it->buf, it->len);
-#ifdef DUMPFILE
-        *os << std::string(it->buf, it->len);
-        os->flush();
-#endif
     }
 }
 
@@ -52,16 +48,6 @@ bool SOCKSv5Outgoing::isActive() const
 
 size_t SOCKSv5Outgoing::onReceived(ProtocolContext& context)
 {
-#ifdef DUMPFILE
-    for (std::vector<io_mem_buf>::const_iterator it = context.inMemory().begin()
-            ; it != context.inMemory().end()
-            ; ++ it)
-    {
-        *is << std::string(it->buf, it->len);
-        is->flush();
-    }
-#endif
-
     socks_->writeIncoming(context.inMemory());
     return context.inBytes();
 }
@@ -70,15 +56,6 @@ void SOCKSv5Outgoing::onConnected(ProtocolContext& context)
 {
     BaseProtocol::onConnected(context);
     transport_ = &(context.transport());
-
-#ifdef DUMPFILE
-    static int id = 0;
-    os.reset(new std::ofstream(toNarrowString(simplify(combinePath(combinePath(socks_->internalCore()->basePath(), _T("session")), concat<tstring>(_T("outgoing_os_"), ::toString(++id), _T(".txt"))))).c_str()));
-    *os <<  toNarrowString(context.transport().toString()) << std::endl;
-
-    is.reset(new std::ofstream(toNarrowString(simplify(combinePath(combinePath(socks_->internalCore()->basePath(), _T("session")), concat<tstring>(_T("outgoing_is_"), ::toString(id), _T(".txt"))))).c_str()));
-    *is <<  toNarrowString(context.transport().toString()) << std::endl;
-#endif
 }
 
 void SOCKSv5Outgoing::onDisconnected(ProtocolContext& context, errcode_t errCode, const tstring& reason)
@@ -169,16 +169,29 @@ size_t SOCKSv5Protocol::onAuthenticating(ProtocolContext& context, InBuffer& inB
     return len;
 }
 
-bool readNetAddress(InBuffer& inBuffer, tstring& host, int af, size_t len)
+bool readNetAddress(InBuffer& inBuffer, Endpoint& host, int af, size_t len)
 {
-    SOCKADDR addr;
+    SOCKADDR_STORAGE addr;
     memset(&addr, 0, sizeof(addr));
 
-    ((sockaddr_in*)&addr)->sin_family = af;
-    inBuffer.readBlob(&(((sockaddr_in*)&addr)->sin_addr), len);
-    ((sockaddr_in*)&addr)->sin_port = inBuffer.readInt16();
+    int addrLen;
+    if (AF_INET6 == af)
+    {
+        ((sockaddr_in6*)&addr)->sin6_family = af;
+        inBuffer.readBlob(&(((sockaddr_in6*)&addr)->sin6_addr), len);
+        ((sockaddr_in6*)&addr)->sin6_port = byteorder::toBigEndian(inBuffer.readUInt16BE());
+        addrLen = sizeof(sockaddr_in6);
+    }
+    else
+    {
+        ((sockaddr_in*)&addr)->sin_family = af;
+        inBuffer.readBlob(&(((sockaddr_in*)&addr)->sin_addr), len);
+        ((sockaddr_in*)&addr)->sin_port = byteorder::toBigEndian(inBuffer.readUInt16BE());
+        addrLen = sizeof(sockaddr_in);
+    }
 
-    return networking::addressToString(&addr, sizeof(addr), _T("tcp"), host);
+    host = Endpoint(Endpoint::tcp(), (struct sockaddr*)&addr, addrLen);
+    return true;
 }
 
 size_t SOCKSv5Protocol::onCommand(ProtocolContext& context, InBuffer& inBuffer)
@@ -219,7 +232,7 @@ size_t SOCKSv5Protocol::onCommand(ProtocolContext& context, InBuffer& inBuffer)
     //char addr[1024];
     //char addressLen = 0;
 
-    tstring host;
+    Endpoint host;
     switch (addressType)
     {
 
@@ -255,7 +268,7 @@ size_t SOCKSv5Protocol::onCommand(ProtocolContext& context, InBuffer& inBuffer)
         inBuffer.readBlob(buf, nameLen);
         buf[nameLen] = 0;
 
-        host = concat<tstring>(_T("tcp://"), toTstring(buf), _T(":"), ::toString(ntohs(inBuffer.readInt16())));
+        host = Endpoint(Endpoint::tcp(), toTstring(buf), inBuffer.readUInt16BE());
     }
     break;
     default:
@@ -275,7 +288,7 @@ size_t SOCKSv5Protocol::onCommand(ProtocolContext& context, InBuffer& inBuffer)
     {
     case 0x01://    CONNECT
     {
-        connectTo(context, host.c_str());
+        connectTo(context, host);
         status_ = 3; // CONNECTING;
         return bytes;
     }
@@ -304,7 +317,7 @@ size_t SOCKSv5Protocol::onCommand(ProtocolContext& context, InBuffer& inBuffer)
     }
 }
 
-void SOCKSv5Protocol::connectTo(ProtocolContext& context, const tstring& host)
+void SOCKSv5Protocol::connectTo(ProtocolContext& context, const Endpoint& host)
 {
     connectProxy_ = new connectorType(this, host, &context.core(), &SOCKSv5Protocol::onConnectComplete, &SOCKSv5Protocol::onConnectError, context);
     connectProxy_->connectWith();
@@ -339,6 +352,13 @@ void SOCKSv5Protocol::onConnectComplete(ITransport* transport, ProtocolContext&
     transport->bindProtocol(&outgoing_);
     transport->initialize();
 
+    // ûʱֻƶ, תݲظ
+    if (!is_null(credentialPolicy_.get()) && !credentialPolicy_->user().empty())
+    {
+        context.transport().shapeAs(credentialPolicy_->user(), true);
+        transport->shapeAs(credentialPolicy_->user(), false);
+    }
+
 
     sendReply(context, (int)SOCKSv5Error::Success, 5, 1, "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 4, 0);
     context.transport().bindProtocol(&incoming_);
@@ -483,7 +503,7 @@ void SOCKSv5Protocol::sendReply(ProtocolContext& context, int reply, int version
     }
 
 
-    out.writeInt16(htons(port));
+    out.writeUInt16BE(static_cast<uint16_t>(port));
 }
 
 }
@@ -80,7 +80,7 @@ public :
     size_t onAuthenticating(ProtocolContext& context, InBuffer& inBuffer);
     size_t onCommand(ProtocolContext& context, InBuffer& inBuffer);
 
-    void connectTo(ProtocolContext& context, const tstring& host);
+    void connectTo(ProtocolContext& context, const Endpoint& host);
     void onConnectComplete(ITransport* transport, ProtocolContext& context);
     void onConnectError(const ErrorCode&, ProtocolContext& context);
 
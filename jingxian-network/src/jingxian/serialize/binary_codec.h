@@ -0,0 +1,291 @@
+
+#ifndef _binary_codec_h_
+#define _binary_codec_h_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+#include <string>
+#include <string.h>
+
+_jingxian_begin
+
+/**
+ * Ƹʽı뺯, ʽ binary_writer/binary_reader ͬ.
+ *
+ * register_class_N Ϊÿṹ binary_size, binary_encode  binary_decode
+ * 麯, ֱֶչ binary_format::size/encode/decode ĵ, 
+ *  serialize_writer 麯, Ҳֶ. binary_size ر󳤶ȵ
+ * , ǰһԤÿռ, ֮д벻ټ߽. ǳ, û
+ * ַĽṹڱʱ.
+ */
+namespace binary_format
+{
+    inline uint32_t zigzag(int32_t value)
+    {
+        return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    }
+
+    inline uint64_t zigzag(int64_t value)
+    {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    inline int32_t unzigzag(uint32_t value)
+    {
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+
+    inline int64_t unzigzag(uint64_t value)
+    {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    inline char* encodeVarUInt(char* p, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            *p ++ = (char)(value | 0x80);
+            value >>= 7;
+        }
+        *p ++ = (char)value;
+        return p;
+    }
+
+    /**
+     *  maxBytes ֽڴ lastMax ʱֵ˷Χ,  InBuffer һ
+     * ʽ
+     */
+    inline bool decodeVarUInt(const char*& p, const char* end, size_t maxBytes, unsigned char lastMax, uint64_t& value)
+    {
+        value = 0;
+        for (size_t i = 0; i < maxBytes && p + i < end; ++ i)
+        {
+            unsigned char ch = (unsigned char)p[i];
+            if (i + 1 == maxBytes && ch > lastMax)
+                return false;
+
+            value |= ((uint64_t)(ch & 0x7f)) << (7 * i);
+            if (0 == (ch & 0x80))
+            {
+                p += (i + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline char* put(char* p, bool value)
+    {
+        *p ++ = value ? 1 : 0;
+        return p;
+    }
+
+    inline char* put(char* p, int8_t value)
+    {
+        *p ++ = (char)value;
+        return p;
+    }
+
+    inline char* put(char* p, int16_t value)
+    {
+        return encodeVarUInt(p, zigzag((int32_t)value));
+    }
+
+    inline char* put(char* p, int32_t value)
+    {
+        return encodeVarUInt(p, zigzag(value));
+    }
+
+    inline char* put(char* p, int64_t value)
+    {
+        return encodeVarUInt(p, zigzag(value));
+    }
+
+    inline bool get(const char*& p, const char* end, bool& value)
+    {
+        if (p >= end)
+            return false;
+        value = (0 != *p ++);
+        return true;
+    }
+
+    inline bool get(const char*& p, const char* end, int8_t& value)
+    {
+        if (p >= end)
+            return false;
+        value = (int8_t)*p ++;
+        return true;
+    }
+
+    inline bool get(const char*& p, const char* end, int32_t& value)
+    {
+        uint64_t v;
+        if (!decodeVarUInt(p, end, 5, 0x0F, v))
+            return false;
+        value = unzigzag((uint32_t)v);
+        return true;
+    }
+
+    inline bool get(const char*& p, const char* end, int16_t& value)
+    {
+        int32_t v;
+        if (!get(p, end, v) || v != (int16_t)v)
+            return false;
+        value = (int16_t)v;
+        return true;
+    }
+
+    inline bool get(const char*& p, const char* end, int64_t& value)
+    {
+        uint64_t v;
+        if (!decodeVarUInt(p, end, 10, 0x01, v))
+            return false;
+        value = unzigzag(v);
+        return true;
+    }
+
+    /**
+     * ֶͶӦıͺͱ󳤶,  serialize.h  serialize
+     * ĸصĶӦϵͬ. max_size Ϊ 0 ǽṹ
+     */
+    template<typename T>
+    struct wire
+    {
+        enum { max_size = 0 };
+    };
+
+# define JINGXIAN_BINARY_WIRE(T, W, N) \
+    template<> struct wire<T> { typedef W type; enum { max_size = N }; }
+
+    JINGXIAN_BINARY_WIRE(bool, bool, 1);
+    JINGXIAN_BINARY_WIRE(char, int8_t, 1);
+    JINGXIAN_BINARY_WIRE(unsigned char, int8_t, 1);
+    JINGXIAN_BINARY_WIRE(short, int16_t, 3);
+    JINGXIAN_BINARY_WIRE(unsigned short, int16_t, 3);
+    JINGXIAN_BINARY_WIRE(int, int32_t, 5);
+    JINGXIAN_BINARY_WIRE(unsigned int, int32_t, 5);
+    JINGXIAN_BINARY_WIRE(long, int32_t, 5);
+    JINGXIAN_BINARY_WIRE(unsigned long, int32_t, 5);
+    JINGXIAN_BINARY_WIRE(__int64, int64_t, 10);
+    JINGXIAN_BINARY_WIRE(unsigned __int64, int64_t, 10);
+
+# undef JINGXIAN_BINARY_WIRE
+
+    /**
+     * ṹͨ ADL  register_class_N ɵ binary_size, binary_encode
+     *  binary_decode
+     */
+    template<typename T, bool primitive = (0 != wire<T>::max_size)>
+    struct codec
+    {
+        static size_t size(const T& t)
+        {
+            return binary_size(t);
+        }
+
+        static char* encode(char* p, const T& t)
+        {
+            return binary_encode(p, t);
+        }
+
+        static bool decode(const char*& p, const char* end, T& t)
+        {
+            return binary_decode(p, end, t);
+        }
+    };
+
+    template<typename T>
+    struct codec<T, true>
+    {
+        static size_t size(const T& t)
+        {
+            return wire<T>::max_size;
+        }
+
+        static char* encode(char* p, const T& t)
+        {
+            return put(p, (typename wire<T>::type)t);
+        }
+
+        static bool decode(const char*& p, const char* end, T& t)
+        {
+            typename wire<T>::type value;
+            if (!get(p, end, value))
+                return false;
+            t = (T)value;
+            return true;
+        }
+    };
+
+    /**
+     * ַ serialize() һ, дβ 0 ڵֽ, дݿ
+     */
+    template<class _Elem, class _Traits, class _Ax>
+    struct codec<std::basic_string<_Elem, _Traits, _Ax>, false>
+    {
+        typedef std::basic_string<_Elem, _Traits, _Ax> string_type;
+
+        static size_t size(const string_type& t)
+        {
+            return 10 + (t.size() + 1) * sizeof(_Elem);
+        }
+
+        static char* encode(char* p, const string_type& t)
+        {
+            size_t len = (t.size() + 1) * sizeof(_Elem);
+            p = put(p, (int32_t)len);
+            p = encodeVarUInt(p, len);
+            memcpy(p, t.c_str(), len);
+            return p + len;
+        }
+
+        static bool decode(const char*& p, const char* end, string_type& t)
+        {
+            int32_t value;
+            uint64_t len;
+            if (!get(p, end, value)
+                    || !decodeVarUInt(p, end, 5, 0x0F, len)
+                    || (uint64_t)value != len
+                    || 0 == len
+                    || 0 != len % sizeof(_Elem)
+                    || len > (uint64_t)(end - p))
+                return false;
+
+            t.resize((size_t)len / sizeof(_Elem) - 1);
+            if (!t.empty())
+                memcpy(&t[0], p, (size_t)len - sizeof(_Elem));
+            p += len;
+            return true;
+        }
+    };
+
+    /**
+     * register_class_N ɵĴͨÿֶ
+     */
+    template<typename T>
+    inline size_t size(const T& t)
+    {
+        return codec<T>::size(t);
+    }
+
+    template<typename T>
+    inline char* encode(char* p, const T& t)
+    {
+        return codec<T>::encode(p, t);
+    }
+
+    template<typename T>
+    inline bool decode(const char*& p, const char* end, T& t)
+    {
+        return codec<T>::decode(p, end, t);
+    }
+}
+
+_jingxian_end
+
+#endif // _binary_codec_h_
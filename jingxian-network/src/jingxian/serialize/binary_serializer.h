@@ -0,0 +1,368 @@
+
+#ifndef _binary_serializer_h_
+#define _binary_serializer_h_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+#include "jingxian/serialize/serialize.h"
+#include "jingxian/serialize/binary_codec.h"
+#include "jingxian/buffer/IInBuffer.h"
+#include "jingxian/buffer/OutBuffer.h"
+
+_jingxian_begin
+
+/**
+ * ƸʽҪ¼ֶ, յ serialize_context Ϳ
+ */
+class binary_context : public serialize_context
+{
+public:
+    binary_context()
+            : depth_(0)
+            , type_(serialize_context::USER)
+    {
+    }
+
+    virtual void push(const tstring& className, const tstring& fieldName)
+    {
+        ++ depth_;
+    }
+
+    virtual void pop()
+    {
+        -- depth_;
+    }
+
+    virtual const tstring& currentClass() const
+    {
+        return empty_;
+    }
+
+    virtual const tstring& currentField() const
+    {
+        return empty_;
+    }
+
+    virtual serialize_context::Type currentType() const
+    {
+        return type_;
+    }
+
+    virtual void currentType(serialize_context::Type type)
+    {
+        type_ = type;
+    }
+
+    virtual size_t depth() const
+    {
+        return depth_;
+    }
+
+    virtual const tstring& getClass(int level) const
+    {
+        return empty_;
+    }
+
+    virtual const tstring& getField(int level) const
+    {
+        return empty_;
+    }
+
+    virtual const tstring& operator[](const tstring& key) const
+    {
+        ThrowException1(NotFindException, key);
+    }
+
+private:
+    NOCOPY(binary_context);
+
+    size_t depth_;
+    serialize_context::Type type_;
+    tstring empty_;
+};
+
+/**
+ * лʽ
+ *
+ * ֶΰ register_class_N ˳д, дֶ, ṹĿʼ
+ * Ҳռֽ. bool  int8 ռһֽ,  zigzag 任д
+ * LEB128 䳤, ݿ( ַ )Ǳ䳤ĳȼ. ֱд
+ * OutBuffer ڴ, ʱֱӴ InBuffer ڴиƵĿֶ.
+ */
+class binary_writer : public serialize_writer
+{
+public:
+    binary_writer(IOutBuffer& out)
+            : out_(out)
+            , is_good_(true)
+    {
+    }
+
+    virtual bool open(serialize_context& context, const tchar* className, const tchar* field)
+    {
+        return is_good_;
+    }
+
+    /**
+     * дڴ鲻ʧ, ֻڽṹʱһλ״̬
+     */
+    virtual bool close(serialize_context& context)
+    {
+        if (out_.fail())
+            last_error(_T("дʧ"));
+        return is_good_;
+    }
+
+    virtual bool write(serialize_context& context, bool t, const tchar* field_name)
+    {
+        out_.writeBoolean(t);
+        return true;
+    }
+
+    virtual bool write(serialize_context& context, int8_t t, const tchar* field_name)
+    {
+        out_.writeInt8(t);
+        return true;
+    }
+
+    virtual bool write(serialize_context& context, int16_t t, const tchar* field_name)
+    {
+        out_.writeVarUInt32(binary_format::zigzag((int32_t)t));
+        return true;
+    }
+
+    virtual bool write(serialize_context& context, int32_t t, const tchar* field_name)
+    {
+        out_.writeVarUInt32(binary_format::zigzag(t));
+        return true;
+    }
+
+    virtual bool write(serialize_context& context, int64_t t, const tchar* field_name)
+    {
+        out_.writeVarUInt64(binary_format::zigzag(t));
+        return true;
+    }
+
+    virtual bool write(serialize_context& context, const void* blob, size_t len, const tchar* field_name = _T("blob"))
+    {
+        out_.writeVarUInt32((uint32_t)len);
+        out_.writeBlob(blob, len);
+        return true;
+    }
+
+    virtual bool is_good() const
+    {
+        return is_good_;
+    }
+
+    virtual const tstring& last_error() const
+    {
+        return last_error_;
+    }
+
+    virtual void last_error(const tstring& err)
+    {
+        is_good_ = false;
+        last_error_ = err;
+    }
+
+private:
+    NOCOPY(binary_writer);
+
+    IOutBuffer& out_;
+    bool is_good_;
+    tstring last_error_;
+};
+
+class binary_reader : public serialize_reader
+{
+public:
+    /**
+     * @param[ in ] in ȡĻ
+     * @param[ in ] maxBlob ַݿĳ
+     */
+    binary_reader(IInBuffer& in, size_t maxBlob = DEFAULT_MAX_BLOB)
+            : in_(in)
+            , maxBlob_(maxBlob)
+            , is_good_(true)
+    {
+    }
+
+    virtual bool open(serialize_context& context, const tchar* className, const tchar* field)
+    {
+        return is_good_;
+    }
+
+    virtual bool close(serialize_context& context)
+    {
+        return check();
+    }
+
+    virtual bool read(serialize_context& context, bool& t, const tchar* field_name)
+    {
+        t = in_.readBoolean();
+        return check();
+    }
+
+    virtual bool read(serialize_context& context, int8_t& t, const tchar* field_name)
+    {
+        t = in_.readInt8();
+        return check();
+    }
+
+    virtual bool read(serialize_context& context, int16_t& t, const tchar* field_name)
+    {
+        int32_t value = binary_format::unzigzag(in_.readVarUInt32());
+        if (!check())
+            return false;
+        if (value != (int16_t)value)
+        {
+            last_error(_T("ֵ int16 ķΧ"));
+            return false;
+        }
+        t = (int16_t)value;
+        return true;
+    }
+
+    virtual bool read(serialize_context& context, int32_t& t, const tchar* field_name)
+    {
+        t = binary_format::unzigzag(in_.readVarUInt32());
+        return check();
+    }
+
+    virtual bool read(serialize_context& context, int64_t& t, const tchar* field_name)
+    {
+        t = binary_format::unzigzag(in_.readVarUInt64());
+        return check();
+    }
+
+    virtual bool read(serialize_context& context, void* blob, size_t& len, const tchar* field_name)
+    {
+        uint32_t size = in_.readVarUInt32();
+        if (!check())
+            return false;
+        if (size > len)
+        {
+            last_error(_T("ݿĳȳ˻ĴС"));
+            return false;
+        }
+        in_.readBlob(blob, size);
+        len = size;
+        return check();
+    }
+
+    /**
+     * ᳬʣµֽ
+     */
+    virtual size_t max_blob() const
+    {
+        size_t remaining = in_.size();
+        return (remaining < maxBlob_) ? remaining : maxBlob_;
+    }
+
+    virtual bool is_good() const
+    {
+        return is_good_;
+    }
+
+    virtual const tstring& last_error() const
+    {
+        return last_error_;
+    }
+
+    virtual void last_error(const tstring& err)
+    {
+        is_good_ = false;
+        last_error_ = err;
+    }
+
+private:
+    NOCOPY(binary_reader);
+
+    bool check()
+    {
+        if (in_.fail())
+            last_error(_T("ݲʽȷ"));
+        return is_good_;
+    }
+
+    IInBuffer& in_;
+    size_t maxBlob_;
+    bool is_good_;
+    tstring last_error_;
+};
+
+/**
+ *  register_class_N ɵ binary_encode  t д out ,  binary_size
+ * Ԥһοռֱдڴ
+ */
+template<typename T>
+inline void binary_encode(OutBuffer& out, const T& t)
+{
+    char* ptr = out.prepare(binary_format::size(t));
+    out.commit(binary_format::encode(ptr, t) - ptr);
+}
+
+/**
+ *  in нһ t, ݿڴı߽ʱȸƵڴٽ
+ *
+ * Ƶĳȴ binary_size Ĺֵ( ǵһڴ )ʼ, 
+ * ʧʱ, ֱ껺е. лѹ˺ܶϢʱÿ
+ * ֻ뱾Ϣ൱ֽ, ÿϢʣµȫ.
+ * @return ݲʽȷʱ false, ʱλò
+ */
+template<typename T>
+inline bool binary_decode(IInBuffer& in, T& t)
+{
+    size_t len = 0;
+    const char* begin = in.peek(len);
+    const char* ptr = begin;
+    if (!is_null(begin) && binary_format::decode(ptr, begin + len, t))
+    {
+        in.seek((int)(ptr - begin));
+        return true;
+    }
+
+    size_t total = in.size();
+    if (total <= len)
+        return false;
+
+    size_t window = binary_format::size(t);
+    if (window < 2 * len)
+        window = 2 * len;
+
+    std::vector<char> data;
+    size_t copied = 0;
+    for (;;)
+    {
+        if (window > total)
+            window = total;
+
+        data.resize(window);
+        in.readBlob(&data[copied], window - copied);
+        copied = window;
+
+        begin = ptr = &data[0];
+        if (binary_format::decode(ptr, begin + copied, t))
+        {
+            in.seek(-(int)(begin + copied - ptr));
+            return true;
+        }
+
+        if (copied == total)
+        {
+            in.seek(-(int)copied);
+            return false;
+        }
+        window *= 2;
+    }
+}
+
+_jingxian_end
+
+#endif // _binary_serializer_h_
@@ -75,6 +75,17 @@ public:
 	 */
 	virtual bool read(serialize_context& context, void* blob, size_t& len, const tchar* field_name) = 0;
 
+	/**
+	 * һݿжֽ, ڷڴǰԷĳ
+	 */
+	virtual size_t max_blob() const
+	{
+		return DEFAULT_MAX_BLOB;
+	}
+
+	/// ֪лжʱݿĳ
+	enum { DEFAULT_MAX_BLOB = 16*1024*1024 };
+
 	/**
 	 * Ƿ
 	 */
@@ -25,6 +25,7 @@
 #include <set>
 #include "jingxian/serialize/reader.hpp"
 #include "jingxian/serialize/writer.hpp"
+#include "jingxian/serialize/binary_codec.h"
 
 _jingxian_begin
 
@@ -110,13 +111,13 @@ bool inline serialize(serialize_writer& stream, serialize_context& context, cons
 
 //л
 
-bool inline deserialize(serialize_writer& stream, serialize_context& context, bool& t, const tchar* name = 0)
+bool inline deserialize(serialize_reader& stream, serialize_context& context, bool& t, const tchar* name = 0)
 {
     return stream.read(context, t, name);
 }
 
 template< typename T, typename P>
-inline bool ___deserialize_object(serialize_writer& stream, serialize_context& context, P& t, const tchar* name = 0)
+inline bool ___deserialize_object(serialize_reader& stream, serialize_context& context, P& t, const tchar* name = 0)
 {
     T value;
     if (stream.read(context, value, name))
@@ -139,7 +140,7 @@ bool inline deserialize(serialize_reader& stream, serialize_context& context, sh
 
 bool inline deserialize(serialize_reader& stream, serialize_context& context, int& t, const tchar* name = 0)
 {
-    return stream.read(t, name);
+    return stream.read(context, t, name);
 }
 
 bool inline deserialize(serialize_reader& stream, serialize_context& context, long& t, const tchar* name = 0)
@@ -164,23 +165,23 @@ bool inline deserialize(serialize_reader& stream, serialize_context& context, un
 
 bool inline deserialize(serialize_reader& stream, serialize_context& context, unsigned int& t, const tchar* name = 0)
 {
-    return ___deserialize_object< int32_t, unsigned int>(t, stream, name);
+    return ___deserialize_object< int32_t, unsigned int>(stream, context, t, name);
 }
 
 bool inline deserialize(serialize_reader& stream, serialize_context& context, unsigned long& t, const tchar* name = 0)
 {
-    return ___deserialize_object< int32_t, unsigned long>(t, stream, name);
+    return ___deserialize_object< int32_t, unsigned long>(stream, context, t, name);
 }
 
 bool inline deserialize(serialize_reader& stream, serialize_context& context, unsigned __int64& t, const tchar* name = 0)
 {
-    return ___deserialize_object<int64_t, unsigned __int64>(t, stream, name);
+    return ___deserialize_object<int64_t, unsigned __int64>(stream, context, t, name);
 }
 
 template < class _Elem,
 class _Traits,
 class _Ax >
-bool inline deserialize(serialize_writer& stream, serialize_context& context, std::basic_string<_Elem, _Traits, _Ax>& t, const tchar* name = 0)
+bool inline deserialize(serialize_reader& stream, serialize_context& context, std::basic_string<_Elem, _Traits, _Ax>& t, const tchar* name = 0)
 {
     //typedef std::basic_string<_Elem,_Traits,_Ax> string_type;
 
@@ -190,12 +191,28 @@ bool inline deserialize(serialize_writer& stream, serialize_context& context, st
     if (!stream.read(context, value, name))
         return false;
 
-    t.resize(value);
-    size_t len = 0;
-    if (!stream.read(context, (void*)t.c_str(), len, name))
+    // value ǰβ 0 ڵֽ, ԶԷ, ڴǰȼ
+    if (0 >= value
+            || 0 != (size_t)value % sizeof(_Elem)
+            || (size_t)value > stream.max_blob())
+    {
+        stream.last_error(_T("ַĳȲȷ"));
+        return false;
+    }
+
+    size_t len = value;
+    t.resize(len / sizeof(_Elem));
+    if (!stream.read(context, &t[0], len, name))
         return false;
 
-    t.resize(len - 1);
+    // ݿԼĳȿԱǰĶ
+    if (0 == len || 0 != len % sizeof(_Elem))
+    {
+        stream.last_error(_T("ַĳȲȷ"));
+        return false;
+    }
+
+    t.resize(len / sizeof(_Elem) - 1);
     return true;
 }
 
@@ -0,0 +1,473 @@
+
+# include "pro_config.h"
+# include "jingxian/serialize/binary_serializer.h"
+# include "jingxian/buffer/InBuffer.h"
+# include "jingxian/buffer/OutBuffer.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    struct Order
+    {
+        int id;
+        short count;
+        __int64 amount;
+        bool paid;
+        std::string symbol;
+    };
+
+    register_class_5(Order, id, count, amount, paid, symbol)
+
+    /**
+     * ı XML д, ÿֶ <name>value</name>, ΪԱȵĻ׼.
+     * xmlserializer.h Ҫ Xerces, ֻÿֶϵҪ:
+     * ֶַıת.
+     */
+    class xml_text_writer : public serialize_writer
+    {
+    public:
+        xml_text_writer(IOutBuffer& out)
+                : out_(out)
+        {
+        }
+
+        virtual bool open(serialize_context& context, const tchar* className, const tchar* field)
+        {
+            tstring name(className);
+            context.push(name, (null_ptr == field) ? tstring() : tstring(field));
+            return element(name, _T(""), false);
+        }
+
+        virtual bool close(serialize_context& context)
+        {
+            tstring text = concat<tstring>(_T("</"), context.currentClass(), _T(">"));
+            context.pop();
+            out_.writeBlob(text.c_str(), text.size() * sizeof(tchar));
+            return true;
+        }
+
+        virtual bool write(serialize_context& context, bool t, const tchar* field_name)
+        {
+            return element(field_name, t ? _T("true") : _T("false"), true);
+        }
+
+        virtual bool write(serialize_context& context, int8_t t, const tchar* field_name)
+        {
+            return element(field_name, ::toString((int)t), true);
+        }
+
+        virtual bool write(serialize_context& context, int16_t t, const tchar* field_name)
+        {
+            return element(field_name, ::toString((int)t), true);
+        }
+
+        virtual bool write(serialize_context& context, int32_t t, const tchar* field_name)
+        {
+            return element(field_name, ::toString(t), true);
+        }
+
+        virtual bool write(serialize_context& context, int64_t t, const tchar* field_name)
+        {
+            return element(field_name, ::toString(t), true);
+        }
+
+        virtual bool write(serialize_context& context, const void* blob, size_t len, const tchar* field_name = _T("blob"))
+        {
+            return element(field_name, tstring((const tchar*)blob, len / sizeof(tchar)), true);
+        }
+
+        virtual bool is_good() const
+        {
+            return true;
+        }
+
+        virtual const tstring& last_error() const
+        {
+            return last_error_;
+        }
+
+        virtual void last_error(const tstring& err)
+        {
+            last_error_ = err;
+        }
+
+    private:
+        NOCOPY(xml_text_writer);
+
+        bool element(const tstring& name, const tstring& value, bool end)
+        {
+            tstring text = end ? concat<tstring>(_T("<"), name, _T(">"), value, _T("</"), name, _T(">"))
+                           : concat<tstring>(_T("<"), name, _T(">"));
+            out_.writeBlob(text.c_str(), text.size() * sizeof(tchar));
+            return true;
+        }
+
+        IOutBuffer& out_;
+        tstring last_error_;
+    };
+
+    /**
+     * ¼ֶ serialize_context, ıʽҪɽ
+     */
+    class name_context : public serialize_context
+    {
+    public:
+        name_context()
+                : type_(serialize_context::USER)
+        {
+        }
+
+        virtual void push(const tstring& className, const tstring& fieldName)
+        {
+            classes_.push_back(className);
+            fields_.push_back(fieldName);
+        }
+
+        virtual void pop()
+        {
+            classes_.pop_back();
+            fields_.pop_back();
+        }
+
+        virtual const tstring& currentClass() const
+        {
+            return classes_.back();
+        }
+
+        virtual const tstring& currentField() const
+        {
+            return fields_.back();
+        }
+
+        virtual serialize_context::Type currentType() const
+        {
+            return type_;
+        }
+
+        virtual void currentType(serialize_context::Type type)
+        {
+            type_ = type;
+        }
+
+        virtual size_t depth() const
+        {
+            return classes_.size();
+        }
+
+        virtual const tstring& getClass(int level) const
+        {
+            return classes_[level];
+        }
+
+        virtual const tstring& getField(int level) const
+        {
+            return fields_[level];
+        }
+
+        virtual const tstring& operator[](const tstring& key) const
+        {
+            ThrowException1(NotFindException, key);
+        }
+
+    private:
+        serialize_context::Type type_;
+        std::vector<tstring> classes_;
+        std::vector<tstring> fields_;
+    };
+
+    void toMemBuf(const OutBuffer& out, std::vector<io_mem_buf>& memory)
+    {
+        const std::vector<buffer_chain_t*>& chains = out.rawBuffer();
+        for (size_t i = 0; i < chains.size(); ++ i)
+        {
+            databuffer_t* data = (databuffer_t*)chains[i];
+            io_mem_buf buf;
+            buf.buf = data->start;
+            buf.len = (u_long)(data->end - data->start);
+            memory.push_back(buf);
+        }
+    }
+
+    /**
+     * Էĳ value ʵʵݿ blob һַ
+     */
+    template<typename S>
+    bool readString(int32_t value, const char* blob, size_t len, S& result
+                    , size_t maxBlob = serialize_reader::DEFAULT_MAX_BLOB)
+    {
+        OutBuffer out(null_ptr);
+        binary_context context;
+        binary_writer writer(out);
+        writer.write(context, value, _T("length"));
+        writer.write(context, blob, len, _T("blob"));
+
+        std::vector<io_mem_buf> memory;
+        toMemBuf(out, memory);
+        InBuffer in(&memory, out.size());
+        binary_reader reader(in, maxBlob);
+        return deserialize(reader, context, result, _T("string"));
+    }
+
+    void makeOrder(Order& order, int i)
+    {
+        order.id = 100000 + i;
+        order.count = (short)(i % 1000);
+        order.amount = -((__int64)(i + 1) << 40) - 12345;
+        order.paid = (0 == i % 2);
+        order.symbol = "IBM.NYSE";
+    }
+}
+
+TEST(serialize, binary)
+{
+    OutBuffer out(null_ptr);
+    binary_context context;
+    binary_writer writer(out);
+
+    Order orders[3];
+    for (int i = 0; i < 3; ++ i)
+    {
+        makeOrder(orders[i], i);
+        ASSERT_TRUE(serialize(writer, context, orders[i], _T("order")));
+    }
+
+    std::vector<io_mem_buf> memory;
+    toMemBuf(out, memory);
+    InBuffer in(&memory, out.size());
+    binary_reader reader(in);
+
+    for (int i = 0; i < 3; ++ i)
+    {
+        Order order;
+        ASSERT_TRUE(deserialize(reader, context, order, _T("order")));
+        ASSERT_TRUE(orders[i].id == order.id);
+        ASSERT_TRUE(orders[i].count == order.count);
+        ASSERT_TRUE(orders[i].amount == order.amount);
+        ASSERT_TRUE(orders[i].paid == order.paid);
+        ASSERT_TRUE(orders[i].symbol == order.symbol);
+    }
+    ASSERT_TRUE(0 == in.size());
+
+    // ݲʱʧ
+    Order order;
+    ASSERT_FALSE(deserialize(reader, context, order, _T("order")));
+    ASSERT_FALSE(reader.is_good());
+}
+
+TEST(serialize, hostileString)
+{
+    std::string text;
+    ASSERT_TRUE(readString(4, "abc", 4, text));
+    ASSERT_TRUE("abc" == text);
+
+    // , 0 ͳʣݵĳڷڴǰʧ
+    ASSERT_FALSE(readString(-1, "abc", 4, text));
+    ASSERT_FALSE(readString(0, "", 0, text));
+    ASSERT_FALSE(readString(0x7FFFFFFF, "abc", 4, text));
+
+    // ָ
+    ASSERT_FALSE(readString(4, "abc", 4, text, 3));
+
+    // ݿȸĳȶ, һβ 0
+    ASSERT_FALSE(readString(4, "abc", 0, text));
+
+    // ַС
+    std::wstring wide;
+    ASSERT_FALSE(readString((int32_t)sizeof(wchar_t) + 1, "abcdefgh", sizeof(wchar_t) + 1, wide));
+    ASSERT_FALSE(readString((int32_t)sizeof(wchar_t) * 2, "abcdefgh", sizeof(wchar_t) + 1, wide));
+}
+
+TEST(serialize, codec)
+{
+    OutBuffer expected(null_ptr);
+    OutBuffer out(null_ptr);
+    binary_context context;
+    binary_writer writer(expected);
+
+    Order orders[3];
+    for (int i = 0; i < 3; ++ i)
+    {
+        makeOrder(orders[i], i);
+        ASSERT_TRUE(serialize(writer, context, orders[i], _T("order")));
+        binary_encode(out, orders[i]);
+    }
+
+    //  binary_writer ĸʽͬ
+    ASSERT_TRUE(expected.size() == out.size());
+
+    std::vector<io_mem_buf> memory;
+    toMemBuf(out, memory);
+    InBuffer in(&memory, out.size());
+    binary_reader reader(in);
+    Order first;
+    ASSERT_TRUE(deserialize(reader, context, first, _T("order")));
+    ASSERT_TRUE(orders[0].amount == first.amount);
+
+    for (int i = 1; i < 3; ++ i)
+    {
+        Order order;
+        ASSERT_TRUE(binary_decode(in, order));
+        ASSERT_TRUE(orders[i].id == order.id);
+        ASSERT_TRUE(orders[i].count == order.count);
+        ASSERT_TRUE(orders[i].amount == order.amount);
+        ASSERT_TRUE(orders[i].paid == order.paid);
+        ASSERT_TRUE(orders[i].symbol == order.symbol);
+    }
+    ASSERT_TRUE(0 == in.size());
+
+    // ݲʱʧ, λò
+    Order order;
+    ASSERT_FALSE(binary_decode(in, order));
+
+    // 䳤һֽڳ˷Χ
+    const char overflow[] = "\xff\xff\xff\xff\x10";
+    const char* ptr = overflow;
+    int32_t value = 0;
+    ASSERT_FALSE(binary_format::get(ptr, overflow + 5, value));
+    const char last[] = "\xff\xff\xff\xff\x0f";
+    ptr = last;
+    ASSERT_TRUE(binary_format::get(ptr, last + 5, value));
+    ASSERT_TRUE(-2147483648LL == value);
+}
+
+TEST(serialize, codecSegments)
+{
+    OutBuffer out(null_ptr);
+    Order order;
+    makeOrder(order, 7);
+    for (int i = 0; i < 1000; ++ i)
+        binary_encode(out, order);
+
+    std::string data;
+    std::vector<io_mem_buf> chains;
+    toMemBuf(out, chains);
+    for (size_t i = 0; i < chains.size(); ++ i)
+        data.append(chains[i].buf, chains[i].len);
+
+    // г 7 ֽڵڴ, ÿϢڴı߽
+    std::vector<io_mem_buf> memory;
+    for (size_t offset = 0; offset < data.size(); offset += 7)
+    {
+        io_mem_buf buf;
+        buf.buf = &data[offset];
+        buf.len = (u_long)((data.size() - offset < 7) ? (data.size() - offset) : 7);
+        memory.push_back(buf);
+    }
+
+    InBuffer in(&memory, data.size());
+    bool same = true;
+    size_t count = 0;
+    Order result;
+    while (binary_decode(in, result))
+    {
+        ++ count;
+        if (order.id != result.id || order.amount != result.amount || order.symbol != result.symbol)
+            same = false;
+    }
+    ASSERT_TRUE(same);
+    ASSERT_TRUE(1000 == count);
+    ASSERT_TRUE(0 == in.size());
+}
+
+# ifndef _GOOGLETEST_
+
+BENCHMARK(serialize_binary_write)
+{
+    binary_context context;
+    Order order;
+    makeOrder(order, 1);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        OutBuffer out(null_ptr);
+        binary_writer writer(out);
+        for (int j = 0; j < 100; ++ j)
+            serialize(writer, context, order, _T("order"));
+        DO_NOT_OPTIMIZE(out.size());
+    }
+}
+
+BENCHMARK(serialize_xml_text_write)
+{
+    name_context context;
+    Order order;
+    makeOrder(order, 1);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        OutBuffer out(null_ptr);
+        xml_text_writer writer(out);
+        for (int j = 0; j < 100; ++ j)
+            serialize(writer, context, order, _T("order"));
+        DO_NOT_OPTIMIZE(out.size());
+    }
+}
+
+BENCHMARK(serialize_binary_read)
+{
+    binary_context context;
+    OutBuffer out(null_ptr);
+    binary_writer writer(out);
+    Order order;
+    makeOrder(order, 1);
+    for (int j = 0; j < 100; ++ j)
+        serialize(writer, context, order, _T("order"));
+
+    std::vector<io_mem_buf> memory;
+    toMemBuf(out, memory);
+    state.setBytesProcessed(out.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        InBuffer in(&memory, out.size());
+        binary_reader reader(in);
+        for (int j = 0; j < 100; ++ j)
+            deserialize(reader, context, order, _T("order"));
+        DO_NOT_OPTIMIZE(order.id);
+    }
+}
+
+BENCHMARK(serialize_codec_encode)
+{
+    Order order;
+    makeOrder(order, 1);
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        OutBuffer out(null_ptr);
+        for (int j = 0; j < 100; ++ j)
+            binary_encode(out, order);
+        DO_NOT_OPTIMIZE(out.size());
+    }
+}
+
+BENCHMARK(serialize_codec_decode)
+{
+    OutBuffer out(null_ptr);
+    Order order;
+    makeOrder(order, 1);
+    for (int j = 0; j < 100; ++ j)
+        binary_encode(out, order);
+
+    std::vector<io_mem_buf> memory;
+    toMemBuf(out, memory);
+    state.setBytesProcessed(out.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        InBuffer in(&memory, out.size());
+        for (int j = 0; j < 100; ++ j)
+            binary_decode(in, order);
+        DO_NOT_OPTIMIZE(order.id);
+    }
+}
+
+#endif // _GOOGLETEST_
+
+_jingxian_end
@@ -9,7 +9,7 @@
 #endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
 
 // Include files
-#include "jomoo/exception.hpp"
+#include "jingxian/exception.h"
 
 _jingxian_begin
 
@@ -26,80 +26,54 @@ public:
         , DICTIONARY
     };
 
-    class string_guard
+    /**
+     * ڽǰֶεΪ type, ˳ʱָԭ
+     */
+    class type_guard
     {
     public:
-        string_guard(serialize_context& context)
-                : _context(0)
-                , _isSequence(false)
+        type_guard(serialize_context& context, serialize_context::Type type)
+                : _context(&context)
+                , _type(context.currentType())
         {
-            _isSequence = context.isSequenue();
-            context.isString(true);
-            _context = &context;
+            context.currentType(type);
         }
 
-        ~string_guard()
+        ~type_guard()
         {
-            if (0 != _context)
-            {
-                _context -> isString(false);
-                _context -> isSequenue(_isSequence);
-                _context = 0;
-            }
+            _context -> currentType(_type);
         }
 
     private:
         serialize_context* _context;
-        bool _isSequence;
+        serialize_context::Type _type;
     };
 
-    class dictinary_guard
+    class string_guard : public type_guard
     {
     public:
-        dictinary_guard(serialize_context& context)
-                : _context(0)
-                , _isSequence(false)
+        string_guard(serialize_context& context)
+                : type_guard(context, STRING)
         {
-            _isSequence = context.isSequenue();
-            context.isDictinary(true);
-            _context = &context;
         }
+    };
 
-        ~dictinary_guard()
+    class dictinary_guard : public type_guard
+    {
+    public:
+        dictinary_guard(serialize_context& context)
+                : type_guard(context, DICTIONARY)
         {
-            if (0 != _context)
-            {
-                _context -> isDictinary(false);
-                _context -> isSequenue(_isSequence);
-                _context = 0;
-            }
         }
-
-    private:
-        serialize_context* _context;
-        bool _isSequence;
     };
 
-    class sequenue_guard
+    class sequenue_guard : public type_guard
     {
     public:
         sequenue_guard(serialize_context& context)
-                : _context(0)
+                : type_guard(context, SEQUENUE)
         {
-            _context = &context;
         }
-
-        ~sequenue_guard()
-        {
-            if (0 != _context)
-            {
-                _context -> isSequenue(false);
-                _context = 0;
-            }
-        }
-
-    private:
-        serialize_context* _context;
     };
 
     virtual ~serialize_context() {};
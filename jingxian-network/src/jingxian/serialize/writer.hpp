@@ -9,6 +9,7 @@
 #endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
 
 // Include files
+#include "serialize_context.h"
 
 _jingxian_begin
 
@@ -0,0 +1,264 @@
+
+#ifndef _ascii_functions_hpp_
+#define _ascii_functions_hpp_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include "jingxian/string/ctype_traits.h"
+
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  ifndef JINGXIAN_HAS_SSE2
+#   define JINGXIAN_HAS_SSE2 1
+#  endif
+#  include <emmintrin.h>
+# endif
+
+# if defined(__AVX2__)
+#  ifndef JINGXIAN_HAS_AVX2
+#   define JINGXIAN_HAS_AVX2 1
+#  endif
+#  include <immintrin.h>
+# endif
+
+# if !defined(__GNUG__) && defined(JINGXIAN_HAS_SSE2)
+#  include <intrin.h>
+#  pragma intrinsic(_BitScanReverse)
+# endif
+
+_jingxian_begin
+
+/**
+ * char ַ ASCII ·,  case_functions.h, with_functions.h 
+ * trim_functions.h еģ char ʱʹ.
+ *
+ * ÿδ 16( SSE2 ) 32( AVX2 )ֽ, ȫ ASCII ַʱֱλ
+ * , з ASCII ֽ(  GBK ĺ )ʱÿ˻ص ctype_traits 
+ * ַ, Խԭʵͬ.
+ */
+namespace ascii
+{
+    inline bool is_space(char ch, bool nul)
+    {
+        return ' ' == ch || '\n' == ch || '\r' == ch
+               || '\t' == ch || '\v' == ch || (nul && '\0' == ch);
+    }
+
+    inline char to_lower(char ch)
+    {
+        if ((unsigned char)(ch - 'A') < 26)
+            return (char)(ch | 0x20);
+        if (0 == (ch & 0x80))
+            return ch;
+        return ctype_traits<char>::to_lower(ch);
+    }
+
+    inline char to_upper(char ch)
+    {
+        if ((unsigned char)(ch - 'a') < 26)
+            return (char)(ch & ~0x20);
+        if (0 == (ch & 0x80))
+            return ch;
+        return ctype_traits<char>::to_upper(ch);
+    }
+
+#ifdef JINGXIAN_HAS_SSE2
+
+    /**
+     *  mask ߵһλλ, mask Ϊ 0
+     */
+    inline unsigned int highestBit(unsigned int mask)
+    {
+#ifdef __GNUG__
+        return 31 - __builtin_clz(mask);
+#else
+        unsigned long index;
+        _BitScanReverse(&index, mask);
+        return index;
+#endif
+    }
+
+    /**
+     *  [first, first + 26) Χڵĸϻȥ 0x20
+     */
+    inline __m128i fold16(__m128i v, char first, bool lower)
+    {
+        __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(128 - first)));
+        __m128i inRange = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + 26)));
+        __m128i bit = _mm_and_si128(inRange, _mm_set1_epi8(0x20));
+        return lower ? _mm_or_si128(v, bit) : _mm_xor_si128(v, bit);
+    }
+
+    inline __m128i spaces16(__m128i v, bool nul)
+    {
+        __m128i r = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' '))
+                                 , _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+        r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+        r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+        r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8('\v')));
+        if (nul)
+            r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        return r;
+    }
+
+#endif // JINGXIAN_HAS_SSE2
+
+#ifdef JINGXIAN_HAS_AVX2
+
+    inline __m256i fold32(__m256i v, char first, bool lower)
+    {
+        __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char)(128 - first)));
+        __m256i inRange = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)), shifted);
+        __m256i bit = _mm256_and_si256(inRange, _mm256_set1_epi8(0x20));
+        return lower ? _mm256_or_si256(v, bit) : _mm256_xor_si256(v, bit);
+    }
+
+#endif // JINGXIAN_HAS_AVX2
+
+    /**
+     * תСд, lower Ϊ true ʱתСд
+     */
+    inline void transform(char* s, size_t len, bool lower)
+    {
+        const char first = lower ? 'A' : 'a';
+        size_t i = 0;
+
+#ifdef JINGXIAN_HAS_AVX2
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+            if (0 != _mm256_movemask_epi8(v))
+                break;
+            _mm256_storeu_si256((__m256i*)(s + i), fold32(v, first, lower));
+        }
+#endif
+
+#ifdef JINGXIAN_HAS_SSE2
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+            if (0 != _mm_movemask_epi8(v))
+            {
+                // з ASCII ֽ, ַ
+                for (size_t j = i; j < i + 16; ++ j)
+                    s[j] = lower ? to_lower(s[j]) : to_upper(s[j]);
+                continue;
+            }
+            _mm_storeu_si128((__m128i*)(s + i), fold16(v, first, lower));
+        }
+#endif
+
+        for (; i < len; ++ i)
+            s[i] = lower ? to_lower(s[i]) : to_upper(s[i]);
+    }
+
+    inline void to_lower(char* s, size_t len)
+    {
+        transform(s, len, true);
+    }
+
+    inline void to_upper(char* s, size_t len)
+    {
+        transform(s, len, false);
+    }
+
+    /**
+     * ִСдرȽȳַǷͬ
+     */
+    inline bool equal_nocase(const char* a, const char* b, size_t len)
+    {
+        size_t i = 0;
+
+#ifdef JINGXIAN_HAS_AVX2
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+            if (0 != _mm256_movemask_epi8(_mm256_or_si256(va, vb)))
+                break;
+            __m256i eq = _mm256_cmpeq_epi8(fold32(va, 'A', true), fold32(vb, 'A', true));
+            if (-1 != _mm256_movemask_epi8(eq))
+                return false;
+        }
+#endif
+
+#ifdef JINGXIAN_HAS_SSE2
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+            if (0 != _mm_movemask_epi8(_mm_or_si128(va, vb)))
+            {
+                for (size_t j = i; j < i + 16; ++ j)
+                {
+                    if (to_lower(a[j]) != to_lower(b[j]))
+                        return false;
+                }
+                continue;
+            }
+            __m128i eq = _mm_cmpeq_epi8(fold16(va, 'A', true), fold16(vb, 'A', true));
+            if (0xFFFF != _mm_movemask_epi8(eq))
+                return false;
+        }
+#endif
+
+        for (; i < len; ++ i)
+        {
+            if (to_lower(a[i]) != to_lower(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * ؿͷĿհַ, nul Ϊ true ʱ '\0' Ҳհ
+     */
+    inline size_t span_space(const char* s, size_t len, bool nul)
+    {
+        size_t i = 0;
+
+#ifdef JINGXIAN_HAS_SSE2
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+            unsigned int mask = 0xFFFF & ~_mm_movemask_epi8(spaces16(v, nul));
+            if (0 != mask)
+                return i + highestBit(mask & (0 - mask));
+        }
+#endif
+
+        for (; i < len && is_space(s[i], nul); ++ i)
+            ;
+        return i;
+    }
+
+    /**
+     * ؽβĿհַ, nul Ϊ true ʱ '\0' Ҳհ
+     */
+    inline size_t rspan_space(const char* s, size_t len, bool nul)
+    {
+        size_t end = len;
+
+#ifdef JINGXIAN_HAS_SSE2
+        for (; end >= 16; end -= 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(s + end - 16));
+            unsigned int mask = 0xFFFF & ~_mm_movemask_epi8(spaces16(v, nul));
+            if (0 != mask)
+                return len - (end - 16 + highestBit(mask) + 1);
+        }
+#endif
+
+        for (; end > 0 && is_space(s[end - 1], nul); -- end)
+            ;
+        return len - end;
+    }
+}
+
+_jingxian_end
+
+#endif // _ascii_functions_hpp_
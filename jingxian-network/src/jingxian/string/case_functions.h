@@ -11,6 +11,8 @@
 // Include files
 # include <algorithm>
 # include "jingxian/string/ctype_traits.h"
+# include "jingxian/string/string_traits.h"
+# include "jingxian/string/ascii_functions.h"
 
 _jingxian_begin
 
@@ -23,18 +25,92 @@ inline S &transform_impl(S &s, F f)
     return s;
 }
 
+namespace detail
+{
+    template <typename C>
+    struct case_transform
+    {
+        template <typename S>
+        static S &upper(S &s)
+        {
+            return transform_impl(s, &ctype_traits<C>::to_upper);
+        }
+
+        template <typename S>
+        static S &lower(S &s)
+        {
+            return transform_impl(s, &ctype_traits<C>::to_lower);
+        }
+
+        static bool equal_nocase(const C* a, const C* b, size_t len)
+        {
+            for (size_t i = 0; i < len; ++ i)
+            {
+                if (ctype_traits<C>::to_lower(a[i]) != ctype_traits<C>::to_lower(b[i]))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    /// char ʱ ASCII ·
+    template <>
+    struct case_transform<char>
+    {
+        template <typename S>
+        static S &upper(S &s)
+        {
+            if (!s.empty())
+                ascii::to_upper(&s[0], s.size());
+            return s;
+        }
+
+        template <typename S>
+        static S &lower(S &s)
+        {
+            if (!s.empty())
+                ascii::to_lower(&s[0], s.size());
+            return s;
+        }
+
+        static bool equal_nocase(const char* a, const char* b, size_t len)
+        {
+            return ascii::equal_nocase(a, b, len);
+        }
+    };
+}
+
 template <typename S>
 inline S &transform_upper(S &s)
 {
-    typedef ctype_traits< typename S::value_type >   ctype_traits_t;
-    return transform_impl(s, &ctype_traits_t::to_upper);
+    return detail::case_transform< typename S::value_type >::upper(s);
 }
 
 template <typename S>
 inline S &transform_lower(S &s)
 {
-    typedef ctype_traits<typename S::value_type>   ctype_traits_t;
-    return transform_impl(s, &ctype_traits_t::to_lower);
+    return detail::case_transform< typename S::value_type >::lower(s);
+}
+
+/**
+ * ִСдرȽַǷͬ
+ */
+template <typename char_type>
+inline bool equal_nocase(const char_type* a, size_t alen, const char_type* b, size_t blen)
+{
+    return alen == blen && detail::case_transform<char_type>::equal_nocase(a, b, alen);
+}
+
+template <typename stringT>
+inline bool equal_nocase(const stringT& a, const stringT& b)
+{
+    return equal_nocase(a.c_str(), a.size(), b.c_str(), b.size());
+}
+
+template <typename stringT>
+inline bool equal_nocase(const stringT& a, typename stringT::value_type const * b)
+{
+    return equal_nocase(a.c_str(), a.size(), b, string_traits< typename stringT::value_type >::strlen(b));
 }
 
 template <typename S>
@@ -12,6 +12,7 @@
 #include <string.h>
 #include <string>
 #include <sstream>
+#include "jingxian/string/utf_functions.h"
 typedef char char_t;
 
 #ifdef  _UNICODE
@@ -109,19 +110,27 @@ inline std::wstring::const_pointer c_str_ptr(const std::wstring* t)
     return t->c_str();
 }
 
+/**
+ * 窄字符串是本地代码页( CP_ACP )的编码, 开头的 ASCII 部分在任何代码页中都
+ * 相同, 直接展开, 剩下的部分只调用一次 MultiByteToWideChar. UTF-8 的转换见
+ * utf_functions.h
+ */
 #pragma warning(disable: 4267)
 inline std::wstring toWideString(const char* pStr , size_t len = -1)
 {
-    int nChars = MultiByteToWideChar(CP_ACP , 0 , pStr , len , NULL , 0) ;
     if ((size_t) - 1 == len)
-        -- nChars;
-    if (nChars == 0)
+        len = ::strlen(pStr);
+    if (0 == len)
         return L"";
 
+    // 每个宽字符至少对应一个字节
     std::wstring buf;
-    buf.resize(nChars) ;
-    MultiByteToWideChar(CP_ACP , 0 , pStr , len ,
-                        const_cast<wchar_t*>(buf.c_str()) , nChars) ;
+    buf.resize(len);
+    size_t nChars = utf::widen_ascii(pStr, len, &buf[0]);
+    if (nChars < len)
+        nChars += MultiByteToWideChar(CP_ACP , 0 , pStr + nChars , len - nChars ,
+                                      &buf[nChars] , len - nChars);
+    buf.resize(nChars);
     return buf ;
 }
 #pragma warning(default: 4267)
@@ -144,18 +153,19 @@ inline const std::wstring& toWideString(const std::wstring& str)
 #pragma warning(disable: 4267)
 inline std::string toNarrowString(const wchar_t* pStr , size_t len = -1)
 {
-    int nChars = WideCharToMultiByte(CP_ACP , 0 ,
-                                     pStr , len , NULL , 0 , NULL , NULL) ;
     if ((size_t) - 1 == len)
-        -- nChars ;
-
-    if (nChars == 0)
-        return "" ;
+        len = ::wcslen(pStr);
+    if (0 == len)
+        return "";
 
+    // 一个 UTF-16 单元最多对应 3 个字节( 代码页为 UTF-8 时 )
     std::string buf;
-    buf.resize(nChars) ;
-    WideCharToMultiByte(CP_ACP , 0 , pStr , len ,
-                        const_cast<char*>(buf.c_str()) , nChars , NULL , NULL) ;
+    buf.resize(len * 3);
+    size_t nChars = utf::narrow_ascii(pStr, len, &buf[0]);
+    if (nChars < len)
+        nChars += WideCharToMultiByte(CP_ACP , 0 , pStr + nChars , len - nChars ,
+                                      &buf[nChars] , buf.size() - nChars , NULL , NULL);
+    buf.resize(nChars);
     return buf ;
 }
 #pragma warning(default: 4267)
@@ -0,0 +1,360 @@
+
+#include "pro_config.h"
+#include "jingxian/string/string.h"
+#include "jingxian/string/utf_functions.h"
+
+# ifndef _GOOGLETEST_
+#include "jingxian/utilities/unittest.h"
+
+_jingxian_begin
+
+BENCHMARK(string_split_with_string)
+{
+    const tchar* endPoint = _T("tcp://192.168.100.100:6544");
+    state.setBytesProcessed(string_traits<tchar>::strlen(endPoint) * sizeof(tchar));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        StringArray<tchar> sa = split_with_string(endPoint, _T("://"));
+        DO_NOT_OPTIMIZE(sa.size());
+    }
+}
+
+BENCHMARK(string_concat)
+{
+    tstring scheme(_T("tcp"));
+    tstring host(_T("192.168.100.100"));
+    tstring port(_T("6544"));
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        tstring s = concat<tstring>(scheme, _T("://"), host, _T(":"), port);
+        DO_NOT_OPTIMIZE(s);
+    }
+}
+
+BENCHMARK(string_toString_int)
+{
+    int value = 1234567;
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        tstring s = ::toString(value + (int)(i & 0xff));
+        DO_NOT_OPTIMIZE(s);
+    }
+}
+
+BENCHMARK(string_transform_lower)
+{
+    std::string src("Content-Type: TEXT/HTML; Charset=UTF-8");
+    state.setBytesProcessed(src.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        std::string str(src);
+        DO_NOT_OPTIMIZE(transform_lower(str));
+    }
+}
+
+namespace
+{
+    /**
+     * ԭʵ, ַ ctype_traits, ΪԱȵĻ׼
+     */
+    std::string& scalar_lower(std::string& s)
+    {
+        return transform_impl(s, &ctype_traits<char>::to_lower);
+    }
+
+    bool scalar_equal_nocase(const std::string& a, const std::string& b)
+    {
+        return a.size() == b.size() && 0 == string_traits<char>::strnicmp(a.c_str(), b.c_str(), a.size());
+    }
+
+    std::string& scalar_trim_all(std::string& s)
+    {
+        return trim_all_impl(s, " \n\r\t\v", 6);
+    }
+
+    const std::string& shortText()
+    {
+        static std::string text("Content-Type: TEXT/HTML");
+        return text;
+    }
+
+    const std::string& longText()
+    {
+        static std::string text;
+        if (text.empty())
+        {
+            for (int i = 0; i < 64; ++ i)
+                text += "Accept-Encoding: GZIP, Deflate; ";
+        }
+        return text;
+    }
+}
+
+BENCHMARK(string_lower_short)
+{
+    const std::string& src = shortText();
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(transform_lower(str));
+    }
+}
+
+BENCHMARK(string_lower_short_scalar)
+{
+    const std::string& src = shortText();
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(scalar_lower(str));
+    }
+}
+
+BENCHMARK(string_lower_long)
+{
+    const std::string& src = longText();
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(transform_lower(str));
+    }
+}
+
+BENCHMARK(string_lower_long_scalar)
+{
+    const std::string& src = longText();
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(scalar_lower(str));
+    }
+}
+
+BENCHMARK(string_equal_nocase_short)
+{
+    std::string a(shortText());
+    std::string b(to_lower<std::string>(a));
+    state.setBytesProcessed(a.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(equal_nocase(a, b));
+}
+
+BENCHMARK(string_equal_nocase_short_scalar)
+{
+    std::string a(shortText());
+    std::string b(to_lower<std::string>(a));
+    state.setBytesProcessed(a.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(scalar_equal_nocase(a, b));
+}
+
+BENCHMARK(string_equal_nocase_long)
+{
+    std::string a(longText());
+    std::string b(to_lower<std::string>(a));
+    state.setBytesProcessed(a.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(equal_nocase(a, b));
+}
+
+BENCHMARK(string_equal_nocase_long_scalar)
+{
+    std::string a(longText());
+    std::string b(to_lower<std::string>(a));
+    state.setBytesProcessed(a.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(scalar_equal_nocase(a, b));
+}
+
+BENCHMARK(string_trim_all_short)
+{
+    std::string src("   \t keep-alive \r\n");
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(trim_all(str));
+    }
+}
+
+BENCHMARK(string_trim_all_short_scalar)
+{
+    std::string src("   \t keep-alive \r\n");
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(scalar_trim_all(str));
+    }
+}
+
+BENCHMARK(string_trim_all_long)
+{
+    std::string src = std::string(256, ' ') + longText() + std::string(256, '\t');
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(trim_all(str));
+    }
+}
+
+BENCHMARK(string_trim_all_long_scalar)
+{
+    std::string src = std::string(256, ' ') + longText() + std::string(256, '\t');
+    state.setBytesProcessed(src.size());
+    std::string str;
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+    {
+        str.assign(src);
+        DO_NOT_OPTIMIZE(scalar_trim_all(str));
+    }
+}
+
+namespace
+{
+    const std::string& utf8Text(bool ascii)
+    {
+        static std::string asciiText;
+        static std::string cjkText;
+        if (asciiText.empty())
+        {
+            for (int i = 0; i < 64; ++ i)
+            {
+                asciiText += "Accept-Encoding: GZIP, Deflate; ";
+                cjkText += "Subject: \xE4\xBD\xA0\xE5\xA5\xBD\xEF\xBC\x8C\xE4\xB8\x96\xE7\x95\x8C; ";
+            }
+        }
+        return ascii ? asciiText : cjkText;
+    }
+
+    /**
+     * ԭ,  MultiByteToWideChar, һֻ㳤
+     */
+    void win32_utf8_to_wide(const std::string& src, std::wstring& target)
+    {
+        int len = MultiByteToWideChar(CP_UTF8, 0, src.c_str(), (int)src.size(), NULL, 0);
+        target.resize(len);
+        MultiByteToWideChar(CP_UTF8, 0, src.c_str(), (int)src.size(), &target[0], len);
+    }
+
+    void win32_wide_to_utf8(const std::wstring& src, std::string& target)
+    {
+        int len = WideCharToMultiByte(CP_UTF8, 0, src.c_str(), (int)src.size(), NULL, 0, NULL, NULL);
+        target.resize(len);
+        WideCharToMultiByte(CP_UTF8, 0, src.c_str(), (int)src.size(), &target[0], len, NULL, NULL);
+    }
+
+    void utf8ToWide(BenchmarkState& state, bool ascii, bool win32)
+    {
+        const std::string& src = utf8Text(ascii);
+        state.setBytesProcessed(src.size());
+        std::wstring target;
+
+        for (size_t i = 0; i < state.iterations(); ++ i)
+        {
+            target.clear();
+            if (win32)
+                win32_utf8_to_wide(src, target);
+            else
+                utf::from_utf8(src.c_str(), src.size(), target);
+            DO_NOT_OPTIMIZE(target.size());
+        }
+    }
+
+    void wideToUtf8(BenchmarkState& state, bool ascii, bool win32)
+    {
+        std::wstring src = utf::to_wstring(utf8Text(ascii));
+        state.setBytesProcessed(src.size() * sizeof(wchar_t));
+        std::string target;
+
+        for (size_t i = 0; i < state.iterations(); ++ i)
+        {
+            target.clear();
+            if (win32)
+                win32_wide_to_utf8(src, target);
+            else
+                utf::to_utf8(src.c_str(), src.size(), target);
+            DO_NOT_OPTIMIZE(target.size());
+        }
+    }
+}
+
+BENCHMARK(string_utf8_to_wide_ascii)
+{
+    utf8ToWide(state, true, false);
+}
+
+BENCHMARK(string_utf8_to_wide_ascii_win32)
+{
+    utf8ToWide(state, true, true);
+}
+
+BENCHMARK(string_utf8_to_wide_cjk)
+{
+    utf8ToWide(state, false, false);
+}
+
+BENCHMARK(string_utf8_to_wide_cjk_win32)
+{
+    utf8ToWide(state, false, true);
+}
+
+BENCHMARK(string_wide_to_utf8_ascii)
+{
+    wideToUtf8(state, true, false);
+}
+
+BENCHMARK(string_wide_to_utf8_ascii_win32)
+{
+    wideToUtf8(state, true, true);
+}
+
+BENCHMARK(string_wide_to_utf8_cjk)
+{
+    wideToUtf8(state, false, false);
+}
+
+BENCHMARK(string_wide_to_utf8_cjk_win32)
+{
+    wideToUtf8(state, false, true);
+}
+
+BENCHMARK(string_toWideString_ascii)
+{
+    const std::string& src = utf8Text(true);
+    state.setBytesProcessed(src.size());
+
+    for (size_t i = 0; i < state.iterations(); ++ i)
+        DO_NOT_OPTIMIZE(toWideString(src).size());
+}
+
+_jingxian_end
+
+#endif // _GOOGLETEST_
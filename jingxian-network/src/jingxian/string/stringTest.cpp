@@ -4,6 +4,7 @@
 #include <iostream>
 #include "jingxian/exception.h"
 #include "jingxian/string/string.h"
+#include "jingxian/string/utf_functions.h"
 //#include "jingxian/directory.h"
 
 
@@ -197,4 +198,83 @@ TEST(string, stringOP)
     }
 }
 
+TEST(string, asciiFastPath)
+{
+    //  16/32 ֽڵı߽, м GBK ֽ
+    std::string mixed("Content-Type: TEXT/HTML; Charset=\xC4\xE3\xBA\xC3-UTF-8 ABCDEFGHIJKLMNOPQRSTUVWXYZ @[`{");
+    std::string expected(mixed);
+    for (size_t i = 0; i < expected.size(); ++ i)
+        expected[i] = ctype_traits<char>::to_lower(expected[i]);
+    std::string lower(mixed);
+    ASSERT_TRUE(expected == transform_lower(lower));
+
+    for (size_t i = 0; i < expected.size(); ++ i)
+        expected[i] = ctype_traits<char>::to_upper(mixed[i]);
+    std::string upper(mixed);
+    ASSERT_TRUE(expected == transform_upper(upper));
+
+    ASSERT_TRUE(equal_nocase(lower, upper));
+    ASSERT_TRUE(equal_nocase(mixed, lower));
+    ASSERT_FALSE(equal_nocase(std::string("abc@"), std::string("ABC`")));
+    ASSERT_FALSE(equal_nocase(std::string("abc"), std::string("abcd")));
+    ASSERT_TRUE(begin_with_nocase(mixed, "content-TYPE"));
+    ASSERT_FALSE(begin_with_nocase(std::string("con"), "content"));
+    ASSERT_TRUE(end_with_nocase(mixed, "uvwxyz @[`{"));
+    ASSERT_FALSE(end_with_nocase(mixed, "uvwxyz @[`["));
+    ASSERT_TRUE(equal_nocase(std::wstring(L"Keep-Alive"), L"keep-alive"));
+
+    std::string spaces("  \t\r\n\v  \t\r\n\v  \t\r\n\v  ");
+    std::string str = spaces + "a b" + spaces;
+    ASSERT_TRUE("a b" + spaces == trim_left(std::string(str)));
+    ASSERT_TRUE(spaces + "a b" == trim_right(std::string(str)));
+    ASSERT_TRUE("a b" == trim_all(std::string(str)));
+    ASSERT_TRUE(trim_all(std::string(spaces)).empty());
+    ASSERT_TRUE("a" == trim_all(std::string("\0 a\0 ", 5)));
+    ASSERT_TRUE(std::string("\0 a", 3) == trim_right(std::string("\0 a  ", 5)));
+}
+
+TEST(string, utf)
+{
+    //  16 ֽڵı߽, м 2, 3, 4 ֽڵַ
+    std::string utf8("Content-Type: text/html; \xC2\xA9 \xE4\xBD\xA0\xE5\xA5\xBD \xF0\x9F\x98\x80 charset=utf-8");
+    std::basic_string<uint16_t> utf16;
+    std::basic_string<uint32_t> utf32;
+    ASSERT_TRUE(utf::from_utf8(utf8.c_str(), utf8.size(), utf16));
+    ASSERT_TRUE(utf::from_utf8(utf8.c_str(), utf8.size(), utf32));
+    ASSERT_TRUE(utf16.size() == utf32.size() + 1);
+    ASSERT_TRUE(0xA9 == utf32[25] && 0x4F60 == utf32[27] && 0x1F600 == utf32[30]);
+    ASSERT_TRUE(0xD83D == utf16[30] && 0xDE00 == utf16[31]);
+
+    std::string str;
+    ASSERT_TRUE(utf::to_utf8(utf16.c_str(), utf16.size(), str));
+    ASSERT_TRUE(utf8 == str);
+    str.clear();
+    ASSERT_TRUE(utf::to_utf8(utf32.c_str(), utf32.size(), str));
+    ASSERT_TRUE(utf8 == str);
+    ASSERT_TRUE(utf8 == utf::to_string(utf::to_wstring(utf8)));
+
+    // Ƿ
+    uint32_t buf[8];
+    ASSERT_TRUE(utf::invalid == utf::from_utf8("\xC0\xAF", 2, buf, 8).code);
+    ASSERT_TRUE(utf::invalid == utf::from_utf8("\xED\xA0\x80", 3, buf, 8).code);
+    ASSERT_TRUE(utf::invalid == utf::from_utf8("\xF4\x90\x80\x80", 4, buf, 8).code);
+    ASSERT_TRUE(utf::invalid == utf::from_utf8("a\x80", 2, buf, 8).code);
+    uint16_t lone[] = { 'a', 0xDC00 };
+    str.clear();
+    ASSERT_FALSE(utf::to_utf8(lone, 2, str));
+    ASSERT_TRUE(str.empty());
+
+    // ͲĻԴ read 
+    utf::result r = utf::from_utf8("ab\xE4\xBD", 4, buf, 8);
+    ASSERT_TRUE(utf::truncated == r.code && 2 == r.read && 2 == r.written);
+    r = utf::from_utf8(utf8.c_str(), utf8.size(), buf, 8);
+    ASSERT_TRUE(utf::no_space == r.code && 8 == r.read && 8 == r.written);
+    char out[4];
+    r = utf::to_utf8(utf32.c_str() + 27, 2, out, 4);
+    ASSERT_TRUE(utf::no_space == r.code && 1 == r.read && 3 == r.written);
+
+    ASSERT_TRUE(L"Content-Type" == toWideString("Content-Type"));
+    ASSERT_TRUE("Content-Type" == toNarrowString(L"Content-Type"));
+}
+
 _jingxian_end
\ No newline at end of file
@@ -11,9 +11,85 @@
 // Include files
 # include <functional>
 # include "jingxian/string/string_traits.h"
+# include "jingxian/string/ascii_functions.h"
 
 _jingxian_begin
 
+namespace detail
+{
+    /**
+     * ȥĬϵĿհַ( ' ', '\n', '\r', '\t', '\v', nul Ϊ true ʱ '\0' ),
+     * char ʱ ASCII ·
+     */
+    template<typename C>
+    struct trim_space
+    {
+        template<typename S>
+        static S& left(S& str, bool nul)
+        {
+            typename S::value_type  s_trimChars[] =
+            {
+                _T(' ')
+                ,   _T('\n')
+                ,   _T('\r')
+                ,   _T('\t')
+                ,   _T('\v')
+                ,   _T('\0')
+            };
+
+            typename S::size_type p = str.find_first_not_of(s_trimChars, 0, nul ? 6 : 5);
+            if (S::npos == p)
+                str.clear();
+            else
+                str.erase(0, p);
+            return str;
+        }
+
+        template<typename S>
+        static S& right(S& str, bool nul)
+        {
+            typename S::value_type  s_trimChars[] =
+            {
+                _T(' ')
+                ,   _T('\n')
+                ,   _T('\r')
+                ,   _T('\t')
+                ,   _T('\v')
+                ,   _T('\0')
+            };
+
+            typename S::size_type i = str.find_last_not_of(s_trimChars, S::npos, nul ? 6 : 5);
+            if (S::npos == i)
+                str.clear();
+            else
+                str.erase(i + 1);
+            return str;
+        }
+    };
+
+    template<>
+    struct trim_space<char>
+    {
+        template<typename S>
+        static S& left(S& str, bool nul)
+        {
+            size_t n = ascii::span_space(str.c_str(), str.size(), nul);
+            if (0 != n)
+                str.erase(0, n);
+            return str;
+        }
+
+        template<typename S>
+        static S& right(S& str, bool nul)
+        {
+            size_t n = ascii::rspan_space(str.c_str(), str.size(), nul);
+            if (0 != n)
+                str.erase(str.size() - n);
+            return str;
+        }
+    };
+}
+
 template<typename S>
 inline S& trim_left_impl(S &str
 						 , typename S::value_type const *trimChars
@@ -89,17 +165,7 @@ inline S& trim_left_impl(S &str
 template<typename S>
 inline S& trim_left(S &str)
 {
-    typename S::value_type  s_trimChars[] =
-    {
-        _T(' ')
-        ,   _T('\n')
-        ,   _T('\r')
-        ,   _T('\t')
-        ,   _T('\v')
-        ,   _T('\0')
-    };
-
-    return trim_left_impl(str, s_trimChars, 5);
+    return detail::trim_space<typename S::value_type>::left(str, false);
 }
 
 template<typename S>
@@ -214,17 +280,7 @@ inline S& trim_right_impl(S &str
 template<typename S>
 inline S& trim_right(S &str)
 {
-    typename S::value_type  s_trimChars[] =
-    {
-        _T(' ')
-        ,   _T('\n')
-        ,   _T('\r')
-        ,   _T('\t')
-        ,   _T('\v')
-        ,   _T('\0')
-    };
-
-    return trim_right_impl(str, s_trimChars, 5);
+    return detail::trim_space<typename S::value_type>::right(str, false);
 }
 
 template<typename S>
@@ -277,18 +333,8 @@ inline S& trim_all_impl(S &str
 template<typename S>
 inline S& trim_all(S &str)
 {
-    typename S::value_type  s_trimChars[] =
-    {
-        _T(' ')
-        ,   _T('\n')
-        ,   _T('\r')
-        ,   _T('\t')
-        ,   _T('\v')
-        ,   _T('\0')
-    };
-
-    return trim_all_impl(str, s_trimChars
-		, sizeof(s_trimChars)/sizeof(tchar));
+    return detail::trim_space<typename S::value_type>::left(
+               detail::trim_space<typename S::value_type>::right(str, true), true);
 }
 
 template<typename S>
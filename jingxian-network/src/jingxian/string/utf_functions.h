@@ -0,0 +1,377 @@
+
+#ifndef _utf_functions_hpp_
+#define _utf_functions_hpp_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <string>
+
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  ifndef JINGXIAN_HAS_SSE2
+#   define JINGXIAN_HAS_SSE2 1
+#  endif
+#  include <emmintrin.h>
+# endif
+
+_jingxian_begin
+
+/**
+ * UTF-8  UTF-16/UTF-32 ֮ת
+ *
+ * ַͿ wchar_t( Windows Ϊ UTF-16, ϵͳΪ UTF-32 ),
+ * uint16_t  uint32_t,  sizeof  UTF-16  UTF-32. ᰴ
+ * Unicode Ĺ涨ϸУ( ı, ,  0x10FFFF 
+ * ͲɶԵĴǷǷ ). ֻɨһ, ֱдṩĻ
+ * ׷ӵַĩβ.  ASCII ַ SSE2 ÿδ 16 ֽ.
+ */
+namespace utf
+{
+    enum status
+    {
+        ok = 0,
+        // зǷı
+        invalid,
+        // һַм, Եȴݺ read 
+        truncated,
+        // , Իһ read 
+        no_space
+    };
+
+    struct result
+    {
+        status code;
+        // Ѿת뵥Ԫ( һַı߽ )
+        size_t read;
+        // ѾдԪ
+        size_t written;
+    };
+
+    namespace detail
+    {
+        template<size_t N>
+        struct unit_traits;
+
+        template<>
+        struct unit_traits<2>
+        {
+            typedef uint16_t type;
+        };
+
+        template<>
+        struct unit_traits<4>
+        {
+            typedef uint32_t type;
+        };
+
+        template<typename C>
+        inline uint32_t code(C ch)
+        {
+            return (typename unit_traits<sizeof(C)>::type)ch;
+        }
+
+        inline result make_result(status code, size_t read, size_t written)
+        {
+            result r;
+            r.code = code;
+            r.read = read;
+            r.written = written;
+            return r;
+        }
+
+        inline size_t smaller(size_t a, size_t b)
+        {
+            return (a < b) ? a : b;
+        }
+    }
+
+    /**
+     * ͷ ASCII ַչɿַ
+     * @return Ƶַ, һ ASCII ֽʱֹͣ
+     */
+    template<typename C>
+    inline size_t widen_ascii(const char* src, size_t len, C* dst)
+    {
+        size_t i = 0;
+
+#ifdef JINGXIAN_HAS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+            if (0 != _mm_movemask_epi8(v))
+                break;
+
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            if (2 == sizeof(C))
+            {
+                _mm_storeu_si128((__m128i*)(dst + i), lo);
+                _mm_storeu_si128((__m128i*)(dst + i + 8), hi);
+            }
+            else
+            {
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+            }
+        }
+#endif
+
+        for (; i < len && 0 == (src[i] & 0x80); ++ i)
+            dst[i] = (C)src[i];
+        return i;
+    }
+
+    /**
+     * ͷ ASCII ַѹɵֽ
+     * @return Ƶַ, һ ASCII ַʱֹͣ
+     */
+    template<typename C>
+    inline size_t narrow_ascii(const C* src, size_t len, char* dst)
+    {
+        size_t i = 0;
+
+#ifdef JINGXIAN_HAS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= len; i += 8)
+        {
+            __m128i v;
+            if (2 == sizeof(C))
+            {
+                v = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i high = _mm_and_si128(v, _mm_set1_epi16((short)0xFF80));
+                if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)))
+                    break;
+            }
+            else
+            {
+                __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+                __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi32((int)0xFFFFFF80));
+                if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)))
+                    break;
+                v = _mm_packs_epi32(a, b);
+            }
+            _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(v, v));
+        }
+#endif
+
+        for (; i < len && detail::code(src[i]) < 0x80; ++ i)
+            dst[i] = (char)src[i];
+        return i;
+    }
+
+    /**
+     *  UTF-8 ת UTF-16  UTF-32(  C ĴС )
+     */
+    template<typename C>
+    inline result from_utf8(const char* src, size_t len, C* dst, size_t dstLen)
+    {
+        const unsigned char* s = (const unsigned char*)src;
+        size_t i = 0;
+        size_t o = 0;
+
+        while (i < len)
+        {
+            uint32_t ch = s[i];
+            if (ch < 0x80)
+            {
+                size_t n = widen_ascii(src + i, detail::smaller(len - i, dstLen - o), dst + o);
+                if (0 == n)
+                    return detail::make_result(no_space, i, o);
+                i += n;
+                o += n;
+                continue;
+            }
+
+            // ڶֽڵķΧų˹ı, ʹ 0x10FFFF 
+            size_t count;
+            unsigned char lower = 0x80;
+            unsigned char upper = 0xBF;
+            if (ch < 0xC2)
+                return detail::make_result(invalid, i, o);
+            else if (ch < 0xE0)
+            {
+                count = 2;
+                ch &= 0x1F;
+            }
+            else if (ch < 0xF0)
+            {
+                count = 3;
+                if (0xE0 == ch)
+                    lower = 0xA0;
+                else if (0xED == ch)
+                    upper = 0x9F;
+                ch &= 0x0F;
+            }
+            else if (ch < 0xF5)
+            {
+                count = 4;
+                if (0xF0 == ch)
+                    lower = 0x90;
+                else if (0xF4 == ch)
+                    upper = 0x8F;
+                ch &= 0x07;
+            }
+            else
+                return detail::make_result(invalid, i, o);
+
+            for (size_t k = 1; k < count; ++ k)
+            {
+                if (i + k >= len)
+                    return detail::make_result(truncated, i, o);
+
+                unsigned char next = s[i + k];
+                if (next < lower || next > upper)
+                    return detail::make_result(invalid, i, o);
+                ch = (ch << 6) | (next & 0x3F);
+                lower = 0x80;
+                upper = 0xBF;
+            }
+
+            if (2 == sizeof(C) && ch >= 0x10000)
+            {
+                if (o + 2 > dstLen)
+                    return detail::make_result(no_space, i, o);
+                ch -= 0x10000;
+                dst[o ++] = (C)(0xD800 + (ch >> 10));
+                dst[o ++] = (C)(0xDC00 + (ch & 0x3FF));
+            }
+            else
+            {
+                if (o >= dstLen)
+                    return detail::make_result(no_space, i, o);
+                dst[o ++] = (C)ch;
+            }
+            i += count;
+        }
+        return detail::make_result(ok, i, o);
+    }
+
+    /**
+     *  UTF-16  UTF-32(  C ĴС )ת UTF-8
+     */
+    template<typename C>
+    inline result to_utf8(const C* src, size_t len, char* dst, size_t dstLen)
+    {
+        size_t i = 0;
+        size_t o = 0;
+
+        while (i < len)
+        {
+            uint32_t ch = detail::code(src[i]);
+            if (ch < 0x80)
+            {
+                size_t n = narrow_ascii(src + i, detail::smaller(len - i, dstLen - o), dst + o);
+                if (0 == n)
+                    return detail::make_result(no_space, i, o);
+                i += n;
+                o += n;
+                continue;
+            }
+
+            size_t used = 1;
+            if (ch >= 0xD800 && ch <= 0xDFFF)
+            {
+                if (4 == sizeof(C) || ch >= 0xDC00)
+                    return detail::make_result(invalid, i, o);
+                if (i + 1 >= len)
+                    return detail::make_result(truncated, i, o);
+
+                uint32_t low = detail::code(src[i + 1]);
+                if (low < 0xDC00 || low > 0xDFFF)
+                    return detail::make_result(invalid, i, o);
+                ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                used = 2;
+            }
+            else if (ch > 0x10FFFF)
+                return detail::make_result(invalid, i, o);
+
+            size_t count = (ch < 0x800) ? 2 : ((ch < 0x10000) ? 3 : 4);
+            if (o + count > dstLen)
+                return detail::make_result(no_space, i, o);
+
+            switch (count)
+            {
+            case 4:
+                dst[o + 3] = (char)(0x80 | (ch & 0x3F));
+                ch >>= 6;
+            case 3:
+                dst[o + 2] = (char)(0x80 | (ch & 0x3F));
+                ch >>= 6;
+            case 2:
+                dst[o + 1] = (char)(0x80 | (ch & 0x3F));
+                ch >>= 6;
+            }
+            dst[o] = (char)((0xF00 >> count) | ch);
+            o += count;
+            i += used;
+        }
+        return detail::make_result(ok, i, o);
+    }
+
+    /**
+     *  UTF-8 ת׷ӵ target ĩβ, ߿ clear() ظʹ
+     * target Ѿڴ
+     * @return 벻ǺϷ UTF-8 ʱ false, ʱ target 
+     */
+    template<typename C>
+    inline bool from_utf8(const char* src, size_t len, std::basic_string<C>& target)
+    {
+        if (0 == len)
+            return true;
+
+        // ÿԪٶӦһֽ
+        size_t old = target.size();
+        target.resize(old + len);
+        result r = from_utf8(src, len, &target[old], len);
+        target.resize((ok == r.code) ? old + r.written : old);
+        return ok == r.code;
+    }
+
+    /**
+     *  UTF-16  UTF-32 ת׷ӵ target ĩβ
+     * @return 벻Ϸʱ false, ʱ target 
+     */
+    template<typename C>
+    inline bool to_utf8(const C* src, size_t len, std::string& target)
+    {
+        if (0 == len)
+            return true;
+
+        // UTF-16 һԪӦ 3 ֽ( ԪӦ 4 ֽ )
+        size_t old = target.size();
+        size_t capacity = len * ((2 == sizeof(C)) ? 3 : 4);
+        target.resize(old + capacity);
+        result r = to_utf8(src, len, &target[old], capacity);
+        target.resize((ok == r.code) ? old + r.written : old);
+        return ok == r.code;
+    }
+
+    /**
+     * UTF-8  std::wstring ֮ת, 벻Ϸʱؿַ
+     */
+    inline std::wstring to_wstring(const std::string& str)
+    {
+        std::wstring result;
+        from_utf8(str.c_str(), str.size(), result);
+        return result;
+    }
+
+    inline std::string to_string(const std::wstring& str)
+    {
+        std::string result;
+        to_utf8(str.c_str(), str.size(), result);
+        return result;
+    }
+}
+
+_jingxian_end
+
+#endif // _utf_functions_hpp_
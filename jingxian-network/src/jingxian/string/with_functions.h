@@ -11,6 +11,7 @@
 // Include files
 # include <functional>
 # include "jingxian/string/string_traits.h"
+# include "jingxian/string/case_functions.h"
 
 
 _jingxian_begin
@@ -161,6 +162,52 @@ inline bool end_with(const stringT& str, const stringT& prefix)
     return end_with(c_str_ptr(str), str.size(), c_str_ptr(prefix), prefix.size());
 }
 
+/**
+ * ִСд begin_with, char ʱ ASCII ·
+ */
+template<typename char_type>
+inline bool begin_with_nocase(const char_type* str, size_t length, const char_type * prefix, size_t count)
+{
+    if (count > length)
+        return false;
+    return detail::case_transform<char_type>::equal_nocase(str, prefix, count);
+}
+
+template<typename stringT>
+inline bool begin_with_nocase(const stringT& str, typename stringT::value_type const * prefix)
+{
+    return begin_with_nocase(c_str_ptr(str), str.size(), prefix, string_traits< typename stringT::value_type >::strlen(prefix));
+}
+
+template<typename stringT>
+inline bool begin_with_nocase(const stringT& str, const stringT& prefix)
+{
+    return begin_with_nocase(c_str_ptr(str), str.size(), c_str_ptr(prefix), prefix.size());
+}
+
+/**
+ * ִСд end_with, char ʱ ASCII ·
+ */
+template<typename char_type>
+inline bool end_with_nocase(const char_type* str, size_t length, const char_type * suffix, size_t count)
+{
+    if (count > length)
+        return false;
+    return detail::case_transform<char_type>::equal_nocase(str + (length - count), suffix, count);
+}
+
+template<typename stringT>
+inline bool end_with_nocase(const stringT& str, typename stringT::value_type const * suffix)
+{
+    return end_with_nocase(c_str_ptr(str), str.size(), suffix, string_traits< typename stringT::value_type >::strlen(suffix));
+}
+
+template<typename stringT>
+inline bool end_with_nocase(const stringT& str, const stringT& suffix)
+{
+    return end_with_nocase(c_str_ptr(str), str.size(), c_str_ptr(suffix), suffix.size());
+}
+
 _jingxian_end
 
 #endif // _with_functions_hpp_
\ No newline at end of file
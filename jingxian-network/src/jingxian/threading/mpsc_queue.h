@@ -0,0 +1,103 @@
+
+#ifndef _MPSC_QUEUE_H_
+#define _MPSC_QUEUE_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+
+_jingxian_begin
+
+/**
+ * mpsc_queue еĽڵ, еĶ̳
+ */
+class mpsc_node
+{
+public:
+    mpsc_node()
+            : mpsc_next_(null_ptr)
+    {
+    }
+
+    /// ڶʱָһڵ, ֻ mpsc_queue ʹ
+    mpsc_node* volatile mpsc_next_;
+};
+
+/**
+ * , һߵ
+ *
+ * ڵ㱾ָ, ӲҪڴ.  CAS ڵѹͷ
+ * , һԭӽȡ, ٷתύʱ˳. Ϊ߲
+ * ᵥصڵ, û ABA .
+ */
+template<typename T>
+class mpsc_queue
+{
+public:
+    mpsc_queue()
+            : head_(null_ptr)
+    {
+    }
+
+    /**
+     * һڵ, ߳е
+     * @return ԭΪʱ true, ʱҪ
+     */
+    bool push(T* node)
+    {
+        mpsc_node* item = node;
+        mpsc_node* old;
+        do
+        {
+            old = head_;
+            item->mpsc_next_ = old;
+        }
+        while (old != ::InterlockedCompareExchangePointer((PVOID volatile*)&head_, item, old));
+        return is_null(old);
+    }
+
+    /**
+     * ȡеĽڵ, ֻ߳е
+     * @return ˳Ľڵ,  next() , Ϊʱ null_ptr
+     */
+    T* pop_all()
+    {
+        mpsc_node* item = (mpsc_node*)::InterlockedExchangePointer((PVOID volatile*)&head_, null_ptr);
+
+        mpsc_node* result = null_ptr;
+        while (!is_null(item))
+        {
+            mpsc_node* next = item->mpsc_next_;
+            item->mpsc_next_ = result;
+            result = item;
+            item = next;
+        }
+        return static_cast<T*>(result);
+    }
+
+    /**
+     * ȡ pop_all() صеһڵ
+     */
+    static T* next(T* node)
+    {
+        return static_cast<T*>(node->mpsc_next_);
+    }
+
+    bool empty() const
+    {
+        return is_null(head_);
+    }
+
+private:
+    NOCOPY(mpsc_queue);
+
+    mpsc_node* volatile head_;
+};
+
+_jingxian_end
+
+#endif // _MPSC_QUEUE_H_
@@ -54,7 +54,7 @@ static DWORD WINAPI serviceCtrlHandler(DWORD dwControl,
         serviceInstance->interrupt();
         break;
     default:
-        serviceInstance->onControl(dwEventType, lpEventData);
+        serviceInstance->onControl(dwControl, dwEventType, lpEventData);
         break;
     }
     return NO_ERROR;
@@ -31,11 +31,13 @@ public:
 
     /**
      * յһû֪ͨ
+     * @param dwControl , ûĿ 128  255 ֮
      * @param dwEventType û¼
      * @param lpEventData û¼
      * @remarks ע⣬Է쳣
      */
-    virtual void onControl(DWORD dwEventType
+    virtual void onControl(DWORD dwControl
+                           , DWORD dwEventType
                            , LPVOID lpEventData) = 0;
 
 
@@ -0,0 +1,271 @@
+
+# include "pro_config.h"
+# include <fstream>
+# include "jingxian/lastError.h"
+# include "jingxian/utilities/SamplingProfiler.h"
+# include "jingxian/threading/thread.h"
+
+_jingxian_begin
+
+namespace
+{
+    tstring toggleName(DWORD pid)
+    {
+        return concat<tstring>(_T("jingxian.profiler."), ::toString((int)pid), _T(".toggle"));
+    }
+}
+
+SamplingProfiler::SamplingProfiler()
+        : batchSize_(0)
+        , total_(0)
+        , interval_(10)
+        , toggleEvent_(NULL)
+        , stopping_(0)
+        , sampling_(0)
+        , logger_(_T("jingxian.profiler"))
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+
+    for (std::vector<Thread>::iterator it = threads_.begin(); it != threads_.end(); ++ it)
+        ::CloseHandle(it->handle);
+    threads_.clear();
+}
+
+bool SamplingProfiler::start(DWORD interval, const tstring& path)
+{
+    if (NULL != toggleEvent_)
+    {
+        LOG_WARN(logger_ , _T("!"));
+        return false;
+    }
+
+    interval_ = (0 == interval) ? 1 : interval;
+    path_ = path;
+    stopping_ = 0;
+    sampling_ = 0;
+
+    toggleEvent_ = ::CreateEvent(NULL, FALSE, FALSE, toggleName(::GetCurrentProcessId()).c_str());
+    if (NULL == toggleEvent_)
+    {
+        LOG_ERROR(logger_ , _T("л¼ʧ - ") << lastError(::GetLastError()));
+        return false;
+    }
+
+    exited_.reset(new semaphore(0, 1));
+    try
+    {
+        create_thread(&SamplingProfiler::samplerMain, this, _T("profiler"));
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR(logger_ , _T("߳ʧ - ") << e.what());
+        ::CloseHandle(toggleEvent_);
+        toggleEvent_ = NULL;
+        return false;
+    }
+
+    LOG_INFO(logger_ , _T("߳,  ") << interval_ << _T(" ,  '") << path_ << _T("'"));
+    return true;
+}
+
+void SamplingProfiler::stop()
+{
+    if (NULL == toggleEvent_)
+        return;
+
+    ::InterlockedExchange(&stopping_, 1);
+    ::SetEvent(toggleEvent_);
+    exited_->acquire();
+
+    ::CloseHandle(toggleEvent_);
+    toggleEvent_ = NULL;
+}
+
+bool SamplingProfiler::addCurrentThread()
+{
+    Thread thread;
+    thread.id = ::GetCurrentThreadId();
+    if (!::DuplicateHandle(::GetCurrentProcess()
+                           , ::GetCurrentThread()
+                           , ::GetCurrentProcess()
+                           , &thread.handle
+                           , THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION
+                           , FALSE
+                           , 0))
+    {
+        LOG_ERROR(logger_ , _T("Ǽ߳ ") << thread.id << _T(" ʧ - ") << lastError(::GetLastError()));
+        return false;
+    }
+
+    mutex::spcode_lock lock(lock_);
+    threads_.push_back(thread);
+    return true;
+}
+
+void SamplingProfiler::toggle()
+{
+    if (NULL != toggleEvent_)
+        ::SetEvent(toggleEvent_);
+}
+
+bool SamplingProfiler::toggle(DWORD pid)
+{
+    HANDLE event = ::OpenEvent(EVENT_MODIFY_STATE, FALSE, toggleName(pid).c_str());
+    if (NULL == event)
+        return false;
+
+    BOOL result = ::SetEvent(event);
+    ::CloseHandle(event);
+    return FALSE != result;
+}
+
+bool SamplingProfiler::isSampling() const
+{
+    return 0 != sampling_;
+}
+
+void SamplingProfiler::samplerMain(SamplingProfiler* profiler)
+{
+    profiler->run();
+    profiler->exited_->release();
+}
+
+void SamplingProfiler::run()
+{
+    // ֻڲ߳ʹ, dbghelp ̰߳ȫ
+    std::auto_ptr<StackTracer> tracer;
+
+    while (0 == stopping_)
+    {
+        DWORD result = ::WaitForSingleObject(toggleEvent_, (0 == sampling_) ? INFINITE : interval_);
+        if (0 != stopping_)
+            break;
+
+        if (WAIT_TIMEOUT == result)
+        {
+            sample(*tracer);
+            continue;
+        }
+
+        if (WAIT_OBJECT_0 != result)
+        {
+            LOG_ERROR(logger_ , _T("ȴл¼ʧ - ") << lastError(::GetLastError()));
+            break;
+        }
+
+        if (0 == sampling_)
+        {
+            // ģķűȽ, ڿʼ֮ǰ
+            tracer.reset(new StackTracer(StackTracer::SymBuildPath));
+            tracer->LoadModules();
+            batch_.resize(BATCH_SIZE);
+            ::InterlockedExchange(&sampling_, 1);
+            LOG_INFO(logger_ , _T("ʼ"));
+        }
+        else
+        {
+            ::InterlockedExchange(&sampling_, 0);
+            fold();
+            write(*tracer);
+        }
+    }
+
+    if (0 != sampling_)
+    {
+        ::InterlockedExchange(&sampling_, 0);
+        fold();
+        write(*tracer);
+    }
+}
+
+void SamplingProfiler::sample(StackTracer& tracer)
+{
+    mutex::spcode_lock lock(lock_);
+    for (std::vector<Thread>::iterator it = threads_.begin(); it != threads_.end(); ++ it)
+    {
+        // Լ
+        if (::GetCurrentThreadId() == it->id)
+            continue;
+
+        Sample& sample = batch_[batchSize_];
+        sample.frames = tracer.CaptureCallstack(it->handle, sample.addresses, MAX_FRAMES);
+        if (0 == sample.frames)
+            continue;
+
+        if (BATCH_SIZE == ++ batchSize_)
+            fold();
+    }
+}
+
+void SamplingProfiler::fold(const Sample* samples, size_t count, FoldedStacks& stacks)
+{
+    for (size_t i = 0; i < count; ++ i)
+        ++ stacks[std::vector<DWORD64>(samples[i].addresses, samples[i].addresses + samples[i].frames)];
+}
+
+void SamplingProfiler::write(std::ostream& out, const FoldedStacks& stacks, const SymbolTable& symbols)
+{
+    for (FoldedStacks::const_iterator it = stacks.begin(); it != stacks.end(); ++ it)
+    {
+        // ۵ջʽջ׿ʼ
+        for (std::vector<DWORD64>::const_reverse_iterator frame = it->first.rbegin()
+                ; frame != it->first.rend(); ++ frame)
+        {
+            if (frame != it->first.rbegin())
+                out << ';';
+
+            SymbolTable::const_iterator symbol = symbols.find(*frame);
+            if (symbols.end() != symbol)
+                out << symbol->second;
+            else
+                out << "0x" << std::hex << *frame << std::dec;
+        }
+        out << ' ' << it->second << '\n';
+    }
+}
+
+void SamplingProfiler::fold()
+{
+    if (0 == batchSize_)
+        return;
+
+    fold(&batch_[0], batchSize_, stacks_);
+    total_ += batchSize_;
+    batchSize_ = 0;
+}
+
+void SamplingProfiler::write(StackTracer& tracer)
+{
+    std::ofstream out(toNarrowString(path_).c_str(), std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+        LOG_ERROR(logger_ , _T("ļ '") << path_ << _T("' ʧ,  ") << total_ << _T(" "));
+    }
+    else
+    {
+        // ͬһַڲͬջлֺܶ, ֻһ
+        SymbolTable symbols;
+        for (FoldedStacks::const_iterator it = stacks_.begin(); it != stacks_.end(); ++ it)
+        {
+            for (std::vector<DWORD64>::const_iterator frame = it->first.begin(); frame != it->first.end(); ++ frame)
+            {
+                if (symbols.end() == symbols.find(*frame))
+                    symbols.insert(std::make_pair(*frame, tracer.GetSymbolName(*frame)));
+            }
+        }
+
+        write(out, stacks_, symbols);
+
+        LOG_INFO(logger_ , _T(", ") << total_ << _T(" , ")
+                 << stacks_.size() << _T(" ͬĵջ, д '") << path_ << _T("'"));
+    }
+
+    stacks_.clear();
+    total_ = 0;
+}
+
+_jingxian_end
@@ -0,0 +1,140 @@
+
+#ifndef _SamplingProfiler_H_
+#define _SamplingProfiler_H_
+
+#include "jingxian/config.h"
+
+#if !defined (JINGXIAN_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* JINGXIAN_LACKS_PRAGMA_ONCE */
+
+// Include files
+# include <map>
+# include <vector>
+# include <ostream>
+# include "jingxian/string/string.h"
+# include "jingxian/logging/logging.h"
+# include "jingxian/threading/mutex.h"
+# include "jingxian/threading/semaphore.h"
+# include "jingxian/utilities/StackTracer.h"
+
+_jingxian_begin
+
+/// лķ,  "sc control jingxian 128"
+const DWORD PROFILER_TOGGLE_CONTROL = 128;
+
+/**
+ * ڵĲ
+ *
+ * һ̶̰߳ļǼǹ߳, ֻĺջϻָ,
+ * ڸϻݳջĵַ. ̹߳ڼ䲻ڴ, Ҳ dbghelp( 
+ * жѻ ),  StackTracer::CaptureCallstack(). ַȷԤ
+ * Ļ, ˻ʱŰջ, ʱŲҷŲ
+ * д flamegraph.pl Դ۵ջʽ( "main;run;handle_events 42" ).
+ *
+ * һ̺¼л, Կд̴򿪻ر,
+ *  toggle(DWORD pid).
+ */
+class SamplingProfiler
+{
+public:
+    SamplingProfiler();
+
+    ~SamplingProfiler();
+
+    /**
+     * ߳, 󲢲,  toggle() ſʼ
+     * @param[ in ] interval (  ), ʵʵľϵͳʱӵ
+     * @param[ in ] path ÿνʱдļ
+     */
+    bool start(DWORD interval, const tstring& path);
+
+    /**
+     * ֹͣ߳, ڲʱд
+     */
+    void stop();
+
+    /**
+     * Ǽǵǰ߳, Ժ
+     */
+    bool addCurrentThread();
+
+    /**
+     * ʼ( ߳е )
+     */
+    void toggle();
+
+    /**
+     * ʼһеĲ
+     * @param[ in ] pid Ŀ̺
+     */
+    static bool toggle(DWORD pid);
+
+    /**
+     * ǲڲ
+     */
+    bool isSampling() const;
+
+    enum { MAX_FRAMES = 64 };
+
+    /// һ, ַջʼ
+    struct Sample
+    {
+        int frames;
+        DWORD64 addresses[MAX_FRAMES];
+    };
+
+    /// ַܵĵջ, ַջʼ
+    typedef std::map<std::vector<DWORD64>, size_t> FoldedStacks;
+
+    /// ַӦķ
+    typedef std::map<DWORD64, std::string> SymbolTable;
+
+    /**
+     * ջܵ stacks 
+     */
+    static void fold(const Sample* samples, size_t count, FoldedStacks& stacks);
+
+    /**
+     * ۵ջʽд, ÿջһ, ջ׿ʼ, 
+     * @param[ in ] symbols ַķ, ûеĵַдʮ
+     */
+    static void write(std::ostream& out, const FoldedStacks& stacks, const SymbolTable& symbols);
+
+private:
+    NOCOPY(SamplingProfiler);
+
+    enum { BATCH_SIZE = 1024 };
+
+    struct Thread
+    {
+        HANDLE handle;
+        DWORD id;
+    };
+
+    static void samplerMain(SamplingProfiler* profiler);
+
+    void run();
+    void sample(StackTracer& tracer);
+    void fold();
+    void write(StackTracer& tracer);
+
+    mutex lock_;
+    std::vector<Thread> threads_;
+    std::vector<Sample> batch_;
+    size_t batchSize_;
+    FoldedStacks stacks_;
+    size_t total_;
+
+    DWORD interval_;
+    tstring path_;
+    HANDLE toggleEvent_;
+    volatile LONG stopping_;
+    volatile LONG sampling_;
+    std::auto_ptr<semaphore> exited_;
+    logging::logger logger_;
+};
+
+_jingxian_end
+
+#endif //_SamplingProfiler_H_
@@ -0,0 +1,87 @@
+
+# include "pro_config.h"
+# include <sstream>
+# include "jingxian/utilities/SamplingProfiler.h"
+# ifdef _GOOGLETEST_
+# include <gtest/gtest.h>
+# else
+# include "jingxian/utilities/unittest.h"
+# endif
+
+_jingxian_begin
+
+namespace
+{
+    /// frames еĵַջʼ,  0 
+    SamplingProfiler::Sample makeSample(const DWORD64* frames)
+    {
+        SamplingProfiler::Sample sample;
+        sample.frames = 0;
+        while (0 != frames[sample.frames])
+        {
+            sample.addresses[sample.frames] = frames[sample.frames];
+            ++ sample.frames;
+        }
+        return sample;
+    }
+}
+
+TEST(profiler, fold)
+{
+    const DWORD64 handle[] = { 0x30, 0x20, 0x10, 0 };
+    const DWORD64 read[] = { 0x40, 0x20, 0x10, 0 };
+    const DWORD64 idle[] = { 0x10, 0 };
+
+    std::vector<SamplingProfiler::Sample> samples;
+    samples.push_back(makeSample(handle));
+    samples.push_back(makeSample(read));
+    samples.push_back(makeSample(handle));
+    samples.push_back(makeSample(idle));
+    samples.push_back(makeSample(handle));
+
+    SamplingProfiler::FoldedStacks stacks;
+    SamplingProfiler::fold(&samples[0], 3, stacks);
+    ASSERT_TRUE(2 == stacks.size());
+
+    // ٴλʱۼӵеĵջ
+    SamplingProfiler::fold(&samples[3], 2, stacks);
+    ASSERT_TRUE(3 == stacks.size());
+    ASSERT_TRUE(3 == stacks[std::vector<DWORD64>(handle, handle + 3)]);
+    ASSERT_TRUE(1 == stacks[std::vector<DWORD64>(read, read + 3)]);
+    ASSERT_TRUE(1 == stacks[std::vector<DWORD64>(idle, idle + 1)]);
+}
+
+TEST(profiler, write)
+{
+    const DWORD64 handle[] = { 0x30, 0x20, 0x10, 0 };
+    const DWORD64 read[] = { 0x40, 0x20, 0x10, 0 };
+    const DWORD64 idle[] = { 0x10, 0 };
+
+    std::vector<SamplingProfiler::Sample> samples;
+    for (int i = 0; i < 42; ++ i)
+        samples.push_back(makeSample(handle));
+    for (int i = 0; i < 7; ++ i)
+        samples.push_back(makeSample(read));
+    samples.push_back(makeSample(idle));
+
+    SamplingProfiler::FoldedStacks stacks;
+    SamplingProfiler::fold(&samples[0], samples.size(), stacks);
+
+    SamplingProfiler::SymbolTable symbols;
+    symbols[0x10] = "main";
+    symbols[0x20] = "run";
+    symbols[0x30] = "handle_events";
+
+    // ջַ, Ҳŵĵַдʮ
+    std::ostringstream out;
+    SamplingProfiler::write(out, stacks, symbols);
+    ASSERT_TRUE("main 1\n"
+                "main;run;handle_events 42\n"
+                "main;run;0x40 7\n" == out.str());
+
+    std::ostringstream empty;
+    SamplingProfiler::write(empty, SamplingProfiler::FoldedStacks(), symbols);
+    ASSERT_TRUE(empty.str().empty());
+}
+
+_jingxian_end
@@ -783,6 +783,9 @@ StackTracer::StackTracer(DWORD dwProcessId, HANDLE hProcess)
     this->m_sw = new StackWalkerInternal(this, this->m_hProcess);
     this->m_dwProcessId = dwProcessId;
     this->m_szSymPath = NULL;
+    this->m_stackCopy = NULL;
+    this->m_stackCopyBase = 0;
+    this->m_stackCopySize = 0;
 }
 StackTracer::StackTracer(int options, LPCSTR szSymPath, DWORD dwProcessId, HANDLE hProcess)
 {
@@ -798,6 +801,9 @@ StackTracer::StackTracer(int options, LPCSTR szSymPath, DWORD dwProcessId, HANDL
     }
     else
         this->m_szSymPath = NULL;
+    this->m_stackCopy = NULL;
+    this->m_stackCopyBase = 0;
+    this->m_stackCopySize = 0;
 }
 
 StackTracer::~StackTracer()
@@ -808,6 +814,9 @@ StackTracer::~StackTracer()
     if (this->m_sw != NULL)
         delete this->m_sw;
     this->m_sw = NULL;
+    if (m_stackCopy != NULL)
+        free(m_stackCopy);
+    m_stackCopy = NULL;
 }
 
 BOOL StackTracer::LoadModules()
@@ -933,6 +942,46 @@ BOOL StackTracer::LoadModules()
 static StackTracer::PReadProcessMemoryRoutine s_readMemoryFunction = NULL;
 static LPVOID s_readMemoryFunction_UserData = NULL;
 
+/**
+ * ߳ĳʼ StackWalk64 ĵһ֡, ضӦĻ
+ */
+static DWORD initStackFrame(const CONTEXT& c, STACKFRAME64& s)
+{
+    memset(&s, 0, sizeof(s));
+    DWORD imageType;
+#ifdef _M_IX86
+    // normally, call ImageNtHeader() and use machine info from PE header
+    imageType = IMAGE_FILE_MACHINE_I386;
+    s.AddrPC.Offset = c.Eip;
+    s.AddrPC.Mode = AddrModeFlat;
+    s.AddrFrame.Offset = c.Ebp;
+    s.AddrFrame.Mode = AddrModeFlat;
+    s.AddrStack.Offset = c.Esp;
+    s.AddrStack.Mode = AddrModeFlat;
+#elif _M_X64
+    imageType = IMAGE_FILE_MACHINE_AMD64;
+    s.AddrPC.Offset = c.Rip;
+    s.AddrPC.Mode = AddrModeFlat;
+    s.AddrFrame.Offset = c.Rsp;
+    s.AddrFrame.Mode = AddrModeFlat;
+    s.AddrStack.Offset = c.Rsp;
+    s.AddrStack.Mode = AddrModeFlat;
+#elif _M_IA64
+    imageType = IMAGE_FILE_MACHINE_IA64;
+    s.AddrPC.Offset = c.StIIP;
+    s.AddrPC.Mode = AddrModeFlat;
+    s.AddrFrame.Offset = c.IntSp;
+    s.AddrFrame.Mode = AddrModeFlat;
+    s.AddrBStore.Offset = c.RsBSP;
+    s.AddrBStore.Mode = AddrModeFlat;
+    s.AddrStack.Offset = c.IntSp;
+    s.AddrStack.Mode = AddrModeFlat;
+#else
+#error "Platform not supported!"
+#endif
+    return imageType;
+}
+
 BOOL StackTracer::ShowCallstack(int skipFramesCount, HANDLE hThread, const CONTEXT *context, PReadProcessMemoryRoutine readMemoryFunction, LPVOID pUserData)
 {
     CONTEXT c;;
@@ -978,38 +1027,7 @@ BOOL StackTracer::ShowCallstack(int skipFramesCount, HANDLE hThread, const CONTE
 
     // init STACKFRAME for first call
     STACKFRAME64 s; // in/out stackframe
-    memset(&s, 0, sizeof(s));
-    DWORD imageType;
-#ifdef _M_IX86
-    // normally, call ImageNtHeader() and use machine info from PE header
-    imageType = IMAGE_FILE_MACHINE_I386;
-    s.AddrPC.Offset = c.Eip;
-    s.AddrPC.Mode = AddrModeFlat;
-    s.AddrFrame.Offset = c.Ebp;
-    s.AddrFrame.Mode = AddrModeFlat;
-    s.AddrStack.Offset = c.Esp;
-    s.AddrStack.Mode = AddrModeFlat;
-#elif _M_X64
-    imageType = IMAGE_FILE_MACHINE_AMD64;
-    s.AddrPC.Offset = c.Rip;
-    s.AddrPC.Mode = AddrModeFlat;
-    s.AddrFrame.Offset = c.Rsp;
-    s.AddrFrame.Mode = AddrModeFlat;
-    s.AddrStack.Offset = c.Rsp;
-    s.AddrStack.Mode = AddrModeFlat;
-#elif _M_IA64
-    imageType = IMAGE_FILE_MACHINE_IA64;
-    s.AddrPC.Offset = c.StIIP;
-    s.AddrPC.Mode = AddrModeFlat;
-    s.AddrFrame.Offset = c.IntSp;
-    s.AddrFrame.Mode = AddrModeFlat;
-    s.AddrBStore.Offset = c.RsBSP;
-    s.AddrBStore.Mode = AddrModeFlat;
-    s.AddrStack.Offset = c.IntSp;
-    s.AddrStack.Mode = AddrModeFlat;
-#else
-#error "Platform not supported!"
-#endif
+    DWORD imageType = initStackFrame(c, s);
 
     pSym = (IMAGEHLP_SYMBOL64 *) malloc(sizeof(IMAGEHLP_SYMBOL64) + STACKWALK_MAX_NAMELEN);
     if (!pSym) goto cleanup;  // not enough memory...
@@ -1165,6 +1183,141 @@ cleanup:
     return TRUE;
 }
 
+// ʱƵջֽ
+static const SIZE_T STACK_COPY_SIZE = 64 * 1024;
+
+int StackTracer::CaptureCallstack(HANDLE hThread, DWORD64* frames, int maxFrames)
+{
+    if (m_modulesLoaded == FALSE)
+        this->LoadModules();  // ignore the result...
+
+    if (this->m_sw->m_hDbhHelp == NULL)
+    {
+        SetLastError(ERROR_DLL_INIT_FAILED);
+        return 0;
+    }
+
+    if (m_stackCopy == NULL)
+    {
+        m_stackCopy = (char*) malloc(STACK_COPY_SIZE);
+        if (m_stackCopy == NULL)
+            return 0;
+    }
+
+    // Ŀ̹߳ڼ䲻ܷڴ, Ҳܵ dbghelp, жѻ
+    // . ֻȡĺ͸ջ, ָкٻ
+    if ((DWORD)-1 == SuspendThread(hThread))
+        return 0;
+
+    CONTEXT c;
+    memset(&c, 0, sizeof(CONTEXT));
+    c.ContextFlags = USED_CONTEXT_FLAGS;
+    if (GetThreadContext(hThread, &c) == FALSE)
+    {
+        ResumeThread(hThread);
+        return 0;
+    }
+
+    STACKFRAME64 s;
+    DWORD imageType = initStackFrame(c, s);
+
+    // ջڵύһֱ쵽ջ
+    m_stackCopyBase = s.AddrStack.Offset;
+    m_stackCopySize = 0;
+    MEMORY_BASIC_INFORMATION mbi;
+    if (0 != VirtualQuery((LPCVOID) m_stackCopyBase, &mbi, sizeof(mbi)) && MEM_COMMIT == mbi.State)
+    {
+        DWORD64 regionEnd = (DWORD64) mbi.BaseAddress + mbi.RegionSize;
+        m_stackCopySize = (SIZE_T) (regionEnd - m_stackCopyBase);
+        if (m_stackCopySize > STACK_COPY_SIZE)
+            m_stackCopySize = STACK_COPY_SIZE;
+        memcpy(m_stackCopy, (const void*) m_stackCopyBase, m_stackCopySize);
+    }
+
+    ResumeThread(hThread);
+
+    s_readMemoryFunction = readStackCopy;
+    s_readMemoryFunction_UserData = this;
+
+    int count = 0;
+    while (count < maxFrames)
+    {
+        if (! this->m_sw->pSW(imageType, this->m_hProcess, hThread, &s, &c, myReadProcMem, this->m_sw->pSFTA, this->m_sw->pSGMB, NULL))
+            break;
+        if (s.AddrPC.Offset == 0 || s.AddrPC.Offset == s.AddrReturn.Offset)
+            break;
+
+        frames[count++] = s.AddrPC.Offset;
+        if (s.AddrReturn.Offset == 0)
+            break;
+    }
+
+    s_readMemoryFunction = NULL;
+    s_readMemoryFunction_UserData = NULL;
+    return count;
+}
+
+BOOL __stdcall StackTracer::readStackCopy(
+    HANDLE      hProcess,
+    DWORD64     qwBaseAddress,
+    PVOID       lpBuffer,
+    DWORD       nSize,
+    LPDWORD     lpNumberOfBytesRead,
+    LPVOID      pUserData
+)
+{
+    const StackTracer* tracer = (const StackTracer*) pUserData;
+    if (qwBaseAddress >= tracer->m_stackCopyBase
+            && qwBaseAddress + nSize <= tracer->m_stackCopyBase + tracer->m_stackCopySize)
+    {
+        memcpy(lpBuffer, tracer->m_stackCopy + (qwBaseAddress - tracer->m_stackCopyBase), nSize);
+        *lpNumberOfBytesRead = nSize;
+        return TRUE;
+    }
+
+    // ͸ջ
+    SIZE_T st;
+    BOOL bRet = ReadProcessMemory(hProcess, (LPVOID) qwBaseAddress, lpBuffer, nSize, &st);
+    *lpNumberOfBytesRead = (DWORD) st;
+    return bRet;
+}
+
+std::string StackTracer::GetSymbolName(DWORD64 address)
+{
+    if (m_modulesLoaded == FALSE)
+        this->LoadModules();  // ignore the result...
+
+    CHAR buffer[STACKWALK_MAX_NAMELEN];
+    if (this->m_sw->m_hDbhHelp != NULL)
+    {
+        char symbol[sizeof(IMAGEHLP_SYMBOL64) + STACKWALK_MAX_NAMELEN];
+        IMAGEHLP_SYMBOL64* pSym = (IMAGEHLP_SYMBOL64*)symbol;
+        memset(pSym, 0, sizeof(symbol));
+        pSym->SizeOfStruct = sizeof(IMAGEHLP_SYMBOL64);
+        pSym->MaxNameLength = STACKWALK_MAX_NAMELEN;
+
+        DWORD64 offsetFromSymbol = 0;
+        if (this->m_sw->pSGSFA(this->m_hProcess, address, &offsetFromSymbol, pSym) != FALSE)
+        {
+            if (0 != this->m_sw->pUDSN(pSym->Name, buffer, STACKWALK_MAX_NAMELEN, UNDNAME_NAME_ONLY))
+                return buffer;
+            return pSym->Name;
+        }
+
+        StackWalkerInternal::IMAGEHLP_MODULE64_V2 Module;
+        memset(&Module, 0, sizeof(Module));
+        Module.SizeOfStruct = sizeof(Module);
+        if (this->m_sw->GetModuleInfo(this->m_hProcess, address, &Module) != FALSE)
+        {
+            _snprintf_s(buffer, STACKWALK_MAX_NAMELEN, "%s!%p", Module.ModuleName, (LPVOID) address);
+            return buffer;
+        }
+    }
+
+    _snprintf_s(buffer, STACKWALK_MAX_NAMELEN, "%p", (LPVOID) address);
+    return buffer;
+}
+
 BOOL __stdcall StackTracer::myReadProcMem(
     HANDLE      hProcess,
     DWORD64     qwBaseAddress,
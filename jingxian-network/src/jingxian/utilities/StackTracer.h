@@ -132,6 +132,24 @@ public:
         return m_buffer.str();
     }
 
+    /**
+     * ֻȡõջϵĵַ, ҷ, ʹ
+     *
+     * Ŀ̹߳ڼֻȡ߳ĺ͸ջһڴ(  dbghelp,
+     * Ҳڴ ), ָкڸϻ, Ŀ̳߳жѻ
+     * ʱ. ջֱ֡Ӷȡ̵߳ǰջ, Ѿ仯.
+     * @param[ in ] hThread Ŀ߳, ǵǰ߳, ȡջʱὫ
+     * @param[ out ] frames ջʼĵַ
+     * @param[ in ] maxFrames frames ĴС
+     * @return ȡõ֡, ʧʱ 0
+     */
+    int CaptureCallstack(HANDLE hThread, DWORD64* frames, int maxFrames);
+
+    /**
+     * ȡõַڵĺ, Ҳʱ "ģ!ַ" ַ
+     */
+    std::string GetSymbolName(DWORD64 address);
+
 #if _MSC_VER >= 1300
 // due to some reasons, the "STACKWALK_MAX_NAMELEN" must be declared as "public"
 // in older compilers in order to use it... starting with VC7 we can declare it as "protected"
@@ -165,6 +183,13 @@ protected:
 
     static BOOL __stdcall myReadProcMem(HANDLE hProcess, DWORD64 qwBaseAddress, PVOID lpBuffer, DWORD nSize, LPDWORD lpNumberOfBytesRead);
 
+    // CaptureCallstack() Ŀ̹߳ʱƵջ, ڹǰ
+    char* m_stackCopy;
+    DWORD64 m_stackCopyBase;
+    SIZE_T m_stackCopySize;
+
+    static BOOL __stdcall readStackCopy(HANDLE hProcess, DWORD64 qwBaseAddress, PVOID lpBuffer, DWORD nSize, LPDWORD lpNumberOfBytesRead, LPVOID pUserData);
+
     friend StackWalkerInternal;
 };
 
@@ -2,6 +2,7 @@
 
 # include "pro_config.h"
 #include <vector>
+#include <algorithm>
 #include "jingxian/utilities/unittest.h"
 
 RawFD RawOpenForWriting(const char* filename) {
@@ -51,4 +52,129 @@ int RUN_ALL_TESTS()
 		g_unittestlist = NULL;
 	}
   return 0;
-}
\ No newline at end of file
+}
+
+const void* volatile g_benchmark_sink = NULL;
+
+struct benchmark_entry
+{
+  const char* name;
+  void (*func)(BenchmarkState&);
+};
+
+std::vector<benchmark_entry>* g_benchmarklist = NULL;
+
+void ADD_RUN_BENCHMARK(const char* name, void (*func)(BenchmarkState&))
+{
+  if(NULL == g_benchmarklist)
+    g_benchmarklist = new std::vector<benchmark_entry>();
+
+  benchmark_entry entry;
+  entry.name = name;
+  entry.func = func;
+  g_benchmarklist->push_back(entry);
+}
+
+static int64_t benchmark_now()
+{
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return counter.QuadPart;
+}
+
+static double benchmark_frequency()
+{
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  return (double)frequency.QuadPart;
+}
+
+void BenchmarkState::pauseTiming()
+{
+  if (0 == paused_)
+    paused_ = benchmark_now();
+}
+
+void BenchmarkState::resumeTiming()
+{
+  if (0 == paused_)
+    return;
+
+  pausedTotal_ += benchmark_now() - paused_;
+  paused_ = 0;
+}
+
+// һ, زͣʱĺʱ(  )
+static double run_benchmark_once(const benchmark_entry& entry
+                                 , size_t iterations
+                                 , size_t& bytesProcessed)
+{
+  BenchmarkState state(iterations);
+
+  int64_t start = benchmark_now();
+  entry.func(state);
+  int64_t stop = benchmark_now();
+
+  state.resumeTiming();
+  bytesProcessed = state.bytesProcessed();
+  return (double)(stop - start - state.pausedTicks()) * 1e9 / benchmark_frequency();
+}
+
+int RUN_ALL_BENCHMARKS(const char* filter)
+{
+  if (NULL == g_benchmarklist)
+    return 0;
+
+  const double minTime = BENCHMARK_MIN_TIME_MS * 1e6;
+
+  fprintf(stdout, "%-40s %14s %14s %12s %12s\n"
+          , "Benchmark", "min ns/op", "median ns/op", "MB/s", "iterations");
+
+  for (std::vector<benchmark_entry>::const_iterator it = g_benchmarklist->begin();
+      it != g_benchmarklist->end(); ++it)
+  {
+    if (NULL != filter && NULL == strstr(it->name, filter))
+      continue;
+
+    size_t bytesProcessed = 0;
+
+    // Ԥ, ôݽ뻺
+    run_benchmark_once(*it, 1, bytesProcessed);
+
+    // , ֱһֵʱﵽ minTime
+    size_t iterations = 1;
+    for (;;)
+    {
+      double elapsed = run_benchmark_once(*it, iterations, bytesProcessed);
+      if (elapsed >= minTime || iterations >= 1000000000)
+        break;
+
+      double multiplier = (elapsed <= 0) ? 10 : (minTime * 1.4 / elapsed);
+      if (multiplier > 10)
+        multiplier = 10;
+      else if (multiplier < 2)
+        multiplier = 2;
+      iterations = (size_t)(iterations * multiplier);
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < BENCHMARK_REPETITIONS; ++ i)
+      samples.push_back(run_benchmark_once(*it, iterations, bytesProcessed) / iterations);
+
+    std::sort(samples.begin(), samples.end());
+    double minNs = samples[0];
+    double medianNs = (0 == (samples.size() % 2)) ?
+                      (samples[samples.size()/2 - 1] + samples[samples.size()/2]) / 2
+                      : samples[samples.size()/2];
+
+    if (0 == bytesProcessed || 0 >= minNs)
+      fprintf(stdout, "%-40s %14.1f %14.1f %12s %12u\n"
+              , it->name, minNs, medianNs, "-", (unsigned int)iterations);
+    else
+      fprintf(stdout, "%-40s %14.1f %14.1f %12.1f %12u\n"
+              , it->name, minNs, medianNs
+              , (bytesProcessed * 1e9 / minNs) / (1024.0 * 1024.0)
+              , (unsigned int)iterations);
+  }
+  return 0;
+}
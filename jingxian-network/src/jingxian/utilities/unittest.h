@@ -167,4 +167,135 @@ void RawClose(RawFD fd);
 void ADD_RUN_TEST(void (*func)());
 int RUN_ALL_TESTS();
 
+
+// ΢׼
+//
+//  BENCHMARK(InBuffer_search)
+//  {
+//      ... ׼( ʱ ) ...
+//      state.setBytesProcessed(data.size());
+//      for (size_t i = 0; i < state.iterations(); ++ i)
+//          DO_NOT_OPTIMIZE(buf.search("\r\n", 2));
+//  }
+//
+// ʱԤһ, ȻԶʹÿʱ䲻
+// BENCHMARK_MIN_TIME_MS , ظ BENCHMARK_REPETITIONS , 
+// ÿεСλʱ( ns/op ), ˴ֽʱͬʱ MB/s.
+
+#ifndef BENCHMARK_MIN_TIME_MS
+#define BENCHMARK_MIN_TIME_MS 50
+#endif
+
+#ifndef BENCHMARK_REPETITIONS
+#define BENCHMARK_REPETITIONS 5
+#endif
+
+class BenchmarkState
+{
+public:
+  BenchmarkState(size_t iterations)
+    : iterations_(iterations)
+    , bytesProcessed_(0)
+    , paused_(0)
+    , pausedTotal_(0)
+  {
+  }
+
+  /**
+   * Ҫִеĵ
+   */
+  size_t iterations() const
+  {
+    return iterations_;
+  }
+
+  /**
+   * ÿεֽ, ڼ
+   */
+  void setBytesProcessed(size_t bytes)
+  {
+    bytesProcessed_ = bytes;
+  }
+
+  size_t bytesProcessed() const
+  {
+    return bytesProcessed_;
+  }
+
+  /**
+   * ͣʱ, ѭҪ׼
+   */
+  void pauseTiming();
+
+  /**
+   * ָʱ
+   */
+  void resumeTiming();
+
+  /**
+   * ͣʱ(  tick  )
+   */
+  int64_t pausedTicks() const
+  {
+    return pausedTotal_;
+  }
+
+private:
+  BenchmarkState(const BenchmarkState&);
+  BenchmarkState& operator=(const BenchmarkState&);
+
+  size_t iterations_;
+  size_t bytesProcessed_;
+  int64_t paused_;
+  int64_t pausedTotal_;
+};
+
+#ifndef __GNUG__
+#include <intrin.h>
+#pragma intrinsic(_ReadWriteBarrier)
+#endif
+
+extern const void* volatile g_benchmark_sink;
+
+/**
+ * ֹѱļ㵱ôŻ
+ */
+template<typename T>
+inline void DO_NOT_OPTIMIZE(const T& value)
+{
+#ifdef __GNUG__
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  g_benchmark_sink = &value;
+  _ReadWriteBarrier();
+#endif
+}
+
+/**
+ * ǿƱΪڴ涼ܱ޸
+ */
+inline void CLOBBER_MEMORY()
+{
+#ifdef __GNUG__
+  asm volatile("" : : : "memory");
+#else
+  _ReadWriteBarrier();
+#endif
+}
+
+#define BENCHMARK(name)                                 \
+  struct Benchmark_##name {                             \
+    Benchmark_##name() { ADD_RUN_BENCHMARK(#name, &Run); } \
+    static void Run(BenchmarkState& state);             \
+  };                                                    \
+  static Benchmark_##name g_benchmark_##name;           \
+  void Benchmark_##name::Run(BenchmarkState& state)
+
+void ADD_RUN_BENCHMARK(const char* name, void (*func)(BenchmarkState&));
+
+/**
+ * а filter Ļ׼, filter Ϊ NULL ʱȫ
+ */
+int RUN_ALL_BENCHMARKS(const char* filter = NULL);
+
 #endif // _UnitTestting_H_
\ No newline at end of file